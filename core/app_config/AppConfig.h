@@ -546,6 +546,7 @@ public:
     friend class BatcherUnittest;
     friend class EnterpriseSLSClientManagerUnittest;
     friend class FlusherRunnerUnittest;
+    friend class DiskBufferWriterUnittest;
     friend class PipelineUpdateUnittest;
     friend class ProcessorTagNativeUnittest;
     friend class EnterpriseConfigProviderUnittest;
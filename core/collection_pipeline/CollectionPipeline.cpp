@@ -375,6 +375,7 @@ bool CollectionPipeline::Init(CollectionConfig&& config) {
     mProcessorsInSizeBytes = mMetricsRecordRef.CreateCounter(METRIC_PIPELINE_PROCESSORS_IN_SIZE_BYTES);
     mProcessorsTotalProcessTimeMs
         = mMetricsRecordRef.CreateTimeCounter(METRIC_PIPELINE_PROCESSORS_TOTAL_PROCESS_TIME_MS);
+    mProcessorsProcessTimeMs = mMetricsRecordRef.CreateHistogram(METRIC_PIPELINE_PROCESSORS_PROCESS_TIME_MS);
     mFlushersInGroupsTotal = mMetricsRecordRef.CreateCounter(METRIC_PIPELINE_FLUSHERS_IN_EVENT_GROUPS_TOTAL);
     mFlushersInEventsTotal = mMetricsRecordRef.CreateCounter(METRIC_PIPELINE_FLUSHERS_IN_EVENTS_TOTAL);
     mFlushersInSizeBytes = mMetricsRecordRef.CreateCounter(METRIC_PIPELINE_FLUSHERS_IN_SIZE_BYTES);
@@ -441,7 +442,9 @@ void CollectionPipeline::Process(vector<PipelineEventGroup>& logGroupList, size_
     for (auto& p : mProcessorLine) {
         p->Process(logGroupList);
     }
-    ADD_COUNTER(mProcessorsTotalProcessTimeMs, chrono::system_clock::now() - before);
+    auto cost = chrono::system_clock::now() - before;
+    ADD_COUNTER(mProcessorsTotalProcessTimeMs, cost);
+    OBSERVE_HISTOGRAM(mProcessorsProcessTimeMs, cost);
 }
 
 bool CollectionPipeline::Send(vector<PipelineEventGroup>&& groupList) {
@@ -51,7 +51,7 @@ public:
     bool FlushBatch();
     void RemoveProcessQueue() const;
     // Should add before or when item pop from ProcessorQueue, must be called in the lock of ProcessorQueue
-    void AddInProcessCnt() { mInProcessCnt.fetch_add(1); }
+    void AddInProcessCnt(uint32_t cnt = 1) { mInProcessCnt.fetch_add(cnt); }
     // Should sub when or after item push to SenderQueue
     void SubInProcessCnt() {
         if (mInProcessCnt.load() == 0) {
@@ -118,6 +118,7 @@ private:
     CounterPtr mProcessorsInGroupsTotal;
     CounterPtr mProcessorsInSizeBytes;
     TimeCounterPtr mProcessorsTotalProcessTimeMs;
+    HistogramPtr mProcessorsProcessTimeMs;
     CounterPtr mFlushersInGroupsTotal;
     CounterPtr mFlushersInEventsTotal;
     CounterPtr mFlushersInSizeBytes;
@@ -122,6 +122,7 @@ public:
         mBufferedEventsTotal = mMetricsRecordRef.CreateIntGauge(METRIC_COMPONENT_BATCHER_BUFFERED_EVENTS_TOTAL);
         mBufferedDataSizeByte = mMetricsRecordRef.CreateIntGauge(METRIC_COMPONENT_BATCHER_BUFFERED_SIZE_BYTES);
         mTotalAddTimeMs = mMetricsRecordRef.CreateTimeCounter(METRIC_COMPONENT_BATCHER_TOTAL_ADD_TIME_MS);
+        mAddTimeMs = mMetricsRecordRef.CreateHistogram(METRIC_COMPONENT_BATCHER_ADD_TIME_MS);
         WriteMetrics::GetInstance()->CommitMetricsRecordRef(mMetricsRecordRef);
 
         return true;
@@ -224,7 +225,9 @@ public:
                 }
             }
         }
-        ADD_COUNTER(mTotalAddTimeMs, std::chrono::system_clock::now() - before);
+        auto cost = std::chrono::system_clock::now() - before;
+        ADD_COUNTER(mTotalAddTimeMs, cost);
+        OBSERVE_HISTOGRAM(mAddTimeMs, cost);
     }
 
     // key != 0: event level queue
@@ -349,6 +352,7 @@ private:
     IntGaugePtr mBufferedEventsTotal;
     IntGaugePtr mBufferedDataSizeByte;
     TimeCounterPtr mTotalAddTimeMs;
+    HistogramPtr mAddTimeMs;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class BatcherUnittest;
@@ -50,7 +50,7 @@ bool BoundedProcessQueue::Push(unique_ptr<ProcessQueueItem>&& item) {
     return true;
 }
 
-bool BoundedProcessQueue::Pop(unique_ptr<ProcessQueueItem>& item) {
+bool BoundedProcessQueue::DoPop(unique_ptr<ProcessQueueItem>& item) {
     ADD_COUNTER(mFetchTimesCnt, 1);
     if (Empty()) {
         return false;
@@ -61,14 +61,15 @@ bool BoundedProcessQueue::Pop(unique_ptr<ProcessQueueItem>& item) {
     }
     item = std::move(mQueue.front());
     mQueue.pop_front();
-    item->AddPipelineInProcessCnt(GetConfigName());
     SubSize(item.get());
     if (ChangeStateIfNeededAfterPop()) {
         GiveFeedback();
     }
 
     ADD_COUNTER(mOutItemsTotal, 1);
-    ADD_COUNTER(mTotalDelayMs, chrono::system_clock::now() - item->mEnqueTime);
+    auto delay = chrono::system_clock::now() - item->mEnqueTime;
+    ADD_COUNTER(mTotalDelayMs, delay);
+    OBSERVE_HISTOGRAM(mDelayMs, delay);
     SET_GAUGE(mQueueSizeTotal, mQueue.size());
     SUB_GAUGE(mQueueDataSizeByte, item->mEventGroup.DataSize());
     SET_GAUGE(mValidToPushFlag, IsValidToPush());
@@ -36,11 +36,12 @@ public:
         size_t cap, size_t low, size_t high, int64_t key, uint32_t priority, const CollectionPipelineContext& ctx);
 
     bool Push(std::unique_ptr<ProcessQueueItem>&& item) override;
-    bool Pop(std::unique_ptr<ProcessQueueItem>& item) override;
 
     void SetUpStreamFeedbacks(std::vector<FeedbackInterface*>&& feedbacks);
 
 protected:
+    bool DoPop(std::unique_ptr<ProcessQueueItem>& item) override;
+
     std::deque<std::unique_ptr<ProcessQueueItem>> mQueue;
     std::vector<FeedbackInterface*> mUpStreamFeedbacks;
 
@@ -58,7 +58,7 @@ bool CircularProcessQueue::Push(unique_ptr<ProcessQueueItem>&& item) {
     return true;
 }
 
-bool CircularProcessQueue::Pop(unique_ptr<ProcessQueueItem>& item) {
+bool CircularProcessQueue::DoPop(unique_ptr<ProcessQueueItem>& item) {
     ADD_COUNTER(mFetchTimesCnt, 1);
     if (Empty()) {
         return false;
@@ -68,12 +68,13 @@ bool CircularProcessQueue::Pop(unique_ptr<ProcessQueueItem>& item) {
         return false;
     }
     item = std::move(mQueue.front());
-    item->AddPipelineInProcessCnt(GetConfigName());
     mQueue.pop_front();
     mEventCnt -= item->mEventGroup.GetEvents().size();
 
     ADD_COUNTER(mOutItemsTotal, 1);
-    ADD_COUNTER(mTotalDelayMs, std::chrono::system_clock::now() - item->mEnqueTime);
+    auto delay = std::chrono::system_clock::now() - item->mEnqueTime;
+    ADD_COUNTER(mTotalDelayMs, delay);
+    OBSERVE_HISTOGRAM(mDelayMs, delay);
     SET_GAUGE(mQueueSizeTotal, Size());
     SUB_GAUGE(mQueueDataSizeByte, item->mEventGroup.DataSize());
     return true;
@@ -33,10 +33,12 @@ public:
     CircularProcessQueue(size_t cap, int64_t key, uint32_t priority, const CollectionPipelineContext& ctx);
 
     bool Push(std::unique_ptr<ProcessQueueItem>&& item) override;
-    bool Pop(std::unique_ptr<ProcessQueueItem>& item) override;
 
     void Reset(size_t cap);
 
+protected:
+    bool DoPop(std::unique_ptr<ProcessQueueItem>& item) override;
+
 private:
     size_t Size() const override { return mEventCnt; }
 
@@ -14,6 +14,7 @@
 
 #include "collection_pipeline/queue/ProcessQueueInterface.h"
 
+#include "collection_pipeline/CollectionPipelineManager.h"
 #include "collection_pipeline/queue/BoundedSenderQueueInterface.h"
 
 using namespace std;
@@ -41,6 +42,31 @@ void ProcessQueueInterface::SetDownStreamQueues(vector<BoundedSenderQueueInterfa
     }
 }
 
+bool ProcessQueueInterface::Pop(unique_ptr<ProcessQueueItem>& item) {
+    if (!DoPop(item)) {
+        return false;
+    }
+    AddPipelineInProcessCnt(1);
+    return true;
+}
+
+bool ProcessQueueInterface::PopBatch(vector<unique_ptr<ProcessQueueItem>>& items, size_t maxCnt, size_t maxBytes) {
+    size_t cnt = 0;
+    size_t bytes = 0;
+    unique_ptr<ProcessQueueItem> item;
+    // check emptiness first so that fetch times metrics are not polluted by the trailing failed pop
+    while (cnt < maxCnt && bytes < maxBytes && (cnt == 0 || !Empty()) && DoPop(item)) {
+        bytes += item->mEventGroup.DataSize();
+        items.emplace_back(std::move(item));
+        ++cnt;
+    }
+    if (cnt == 0) {
+        return false;
+    }
+    AddPipelineInProcessCnt(cnt);
+    return true;
+}
+
 bool ProcessQueueInterface::IsValidToPop() const {
     return mValidToPop && IsDownStreamQueuesValidToPush();
 }
@@ -55,4 +81,11 @@ bool ProcessQueueInterface::IsDownStreamQueuesValidToPush() const {
     return true;
 }
 
+void ProcessQueueInterface::AddPipelineInProcessCnt(uint32_t cnt) const {
+    const auto& p = CollectionPipelineManager::GetInstance()->FindConfigByName(mConfigName);
+    if (p) {
+        p->AddInProcessCnt(cnt);
+    }
+}
+
 } // namespace logtail
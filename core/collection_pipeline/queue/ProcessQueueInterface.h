@@ -19,6 +19,7 @@
 #include <cstdint>
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -29,7 +30,8 @@ namespace logtail {
 
 class BoundedSenderQueueInterface;
 
-// not thread-safe, should be protected explicitly by queue manager
+// not thread-safe, should be protected explicitly by queue manager, either by the global lock of the manager or by the
+// claim mutex of the queue
 class ProcessQueueInterface : virtual public QueueInterface<std::unique_ptr<ProcessQueueItem>> {
 public:
     ProcessQueueInterface(int64_t key, size_t cap, uint32_t priority, const CollectionPipelineContext& ctx);
@@ -48,14 +50,25 @@ public:
 
     void Reset() { mDownStreamQueues.clear(); }
 
+    bool Pop(std::unique_ptr<ProcessQueueItem>& item) override;
+    // Pop at most maxCnt items, and no more once the data size of the popped items reaches maxBytes. The pipeline is
+    // looked up only once for the whole batch. Return false if nothing is popped.
+    bool PopBatch(std::vector<std::unique_ptr<ProcessQueueItem>>& items, size_t maxCnt, size_t maxBytes);
+
+    // held by whoever is pushing to or popping from the queue when the manager is not exclusively locked
+    std::mutex& GetClaimMux() const { return mClaimMux; }
+
 protected:
     bool IsValidToPop() const;
+    // pop one item without counting it as being processed by the pipeline
+    virtual bool DoPop(std::unique_ptr<ProcessQueueItem>& item) = 0;
 
     CounterPtr mFetchTimesCnt;
     CounterPtr mValidFetchTimesCnt;
 
 private:
     bool IsDownStreamQueuesValidToPush() const;
+    void AddPipelineInProcessCnt(uint32_t cnt) const;
 
     uint32_t mPriority;
     std::string mConfigName;
@@ -63,6 +76,8 @@ private:
     std::vector<BoundedSenderQueueInterface*> mDownStreamQueues;
     bool mValidToPop = false;
 
+    mutable std::mutex mClaimMux;
+
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class BoundedProcessQueueUnittest;
     friend class CircularProcessQueueUnittest;
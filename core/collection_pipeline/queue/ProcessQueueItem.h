@@ -32,13 +32,6 @@ struct ProcessQueueItem {
     std::chrono::system_clock::time_point mEnqueTime;
 
     ProcessQueueItem(PipelineEventGroup&& group, size_t index) : mEventGroup(std::move(group)), mInputIndex(index) {}
-
-    void AddPipelineInProcessCnt(const std::string& configName) {
-        const auto& p = CollectionPipelineManager::GetInstance()->FindConfigByName(configName);
-        if (p) {
-            p->AddInProcessCnt();
-        }
-    }
 };
 
 } // namespace logtail
@@ -25,6 +25,9 @@
 // For one queue, only one of the following two flags will be used.
 DEFINE_FLAG_INT32(count_bounded_process_queue_capacity, "", 5);
 DEFINE_FLAG_INT32(bytes_bounded_process_queue_capacity, "", 10 * 1024 * 1024);
+// each processor thread owns a subset of the queues and steals from others when idle, instead of all threads walking the
+// queues in round robin under one global lock
+DEFINE_FLAG_BOOL(enable_process_queue_work_stealing, "", false);
 
 DECLARE_FLAG_INT32(process_thread_count);
 
@@ -41,7 +44,7 @@ ProcessQueueManager::ProcessQueueManager()
 bool ProcessQueueManager::CreateOrUpdateCountBoundedQueue(QueueKey key,
                                                           uint32_t priority,
                                                           const CollectionPipelineContext& ctx) {
-    lock_guard<mutex> lock(mQueueMux);
+    lock_guard<shared_mutex> lock(mQueueMux);
     auto iter = mQueues.find(key);
     if (iter != mQueues.end()) {
         if (iter->second.second != QueueType::COUNT_BOUNDED) {
@@ -68,7 +71,7 @@ bool ProcessQueueManager::CreateOrUpdateCircularQueue(QueueKey key,
                                                       uint32_t priority,
                                                       size_t capacity,
                                                       const CollectionPipelineContext& ctx) {
-    lock_guard<mutex> lock(mQueueMux);
+    lock_guard<shared_mutex> lock(mQueueMux);
     auto iter = mQueues.find(key);
     if (iter != mQueues.end()) {
         if (iter->second.second != QueueType::CIRCULAR) {
@@ -95,7 +98,7 @@ bool ProcessQueueManager::CreateOrUpdateCircularQueue(QueueKey key,
 bool ProcessQueueManager::CreateOrUpdateBytesBoundedQueue(QueueKey key,
                                                           uint32_t priority,
                                                           const CollectionPipelineContext& ctx) {
-    lock_guard<mutex> lock(mQueueMux);
+    lock_guard<shared_mutex> lock(mQueueMux);
     auto iter = mQueues.find(key);
     if (iter != mQueues.end()) {
         if (iter->second.second != QueueType::BYTES_BOUNDED) {
@@ -119,7 +122,7 @@ bool ProcessQueueManager::CreateOrUpdateBytesBoundedQueue(QueueKey key,
 }
 
 bool ProcessQueueManager::DeleteQueue(QueueKey key) {
-    lock_guard<mutex> lock(mQueueMux);
+    lock_guard<shared_mutex> lock(mQueueMux);
     auto iter = mQueues.find(key);
     if (iter == mQueues.end()) {
         return false;
@@ -131,9 +134,10 @@ bool ProcessQueueManager::DeleteQueue(QueueKey key) {
 }
 
 bool ProcessQueueManager::IsValidToPush(QueueKey key) const {
-    lock_guard<mutex> lock(mQueueMux);
+    shared_lock<shared_mutex> lock(mQueueMux);
     auto iter = mQueues.find(key);
     if (iter != mQueues.end()) {
+        lock_guard<mutex> claim((*iter->second.first)->GetClaimMux());
         if (iter->second.second == QueueType::COUNT_BOUNDED) {
             return static_cast<CountBoundedProcessQueue*>(iter->second.first->get())->IsValidToPush();
         }
@@ -147,9 +151,10 @@ bool ProcessQueueManager::IsValidToPush(QueueKey key) const {
 
 QueueStatus ProcessQueueManager::PushQueue(QueueKey key, unique_ptr<ProcessQueueItem>&& item) {
     {
-        lock_guard<mutex> lock(mQueueMux);
+        shared_lock<shared_mutex> lock(mQueueMux);
         auto iter = mQueues.find(key);
         if (iter != mQueues.end()) {
+            lock_guard<mutex> claim((*iter->second.first)->GetClaimMux());
             if (!(*iter->second.first)->Push(std::move(item))) {
                 return QueueStatus::QUEUE_FULL;
             }
@@ -165,13 +170,38 @@ QueueStatus ProcessQueueManager::PushQueue(QueueKey key, unique_ptr<ProcessQueue
 }
 
 bool ProcessQueueManager::PopItem(int64_t threadNo, unique_ptr<ProcessQueueItem>& item, string& configName) {
+    vector<unique_ptr<ProcessQueueItem>> items;
+    if (!PopItems(threadNo, items, configName, 1)) {
+        return false;
+    }
+    item = std::move(items[0]);
+    return true;
+}
+
+bool ProcessQueueManager::PopItems(int64_t threadNo,
+                                   vector<unique_ptr<ProcessQueueItem>>& items,
+                                   string& configName,
+                                   size_t maxCnt,
+                                   size_t maxBytes) {
+    items.clear();
     configName.clear();
-    lock_guard<mutex> lock(mQueueMux);
+    maxCnt = max(maxCnt, static_cast<size_t>(1));
+    return BOOL_FLAG(enable_process_queue_work_stealing)
+        ? PopItemsWithWorkStealing(threadNo, items, configName, maxCnt, maxBytes)
+        : PopItemsRoundRobin(threadNo, items, configName, maxCnt, maxBytes);
+}
+
+bool ProcessQueueManager::PopItemsRoundRobin(int64_t threadNo,
+                                             vector<unique_ptr<ProcessQueueItem>>& items,
+                                             string& configName,
+                                             size_t maxCnt,
+                                             size_t maxBytes) {
+    lock_guard<shared_mutex> lock(mQueueMux);
     for (size_t i = 0; i <= sMaxPriority; ++i) {
         ProcessQueueIterator iter;
         if (mCurrentQueueIndex.first == i) {
             for (iter = mCurrentQueueIndex.second; iter != mPriorityQueue[i].end(); ++iter) {
-                if (!(*iter)->Pop(item)) {
+                if (!(*iter)->PopBatch(items, maxCnt, maxBytes)) {
                     continue;
                 }
                 configName = (*iter)->GetConfigName();
@@ -179,7 +209,7 @@ bool ProcessQueueManager::PopItem(int64_t threadNo, unique_ptr<ProcessQueueItem>
             }
             if (configName.empty()) {
                 for (iter = mPriorityQueue[i].begin(); iter != mCurrentQueueIndex.second; ++iter) {
-                    if (!(*iter)->Pop(item)) {
+                    if (!(*iter)->PopBatch(items, maxCnt, maxBytes)) {
                         continue;
                     }
                     configName = (*iter)->GetConfigName();
@@ -188,7 +218,7 @@ bool ProcessQueueManager::PopItem(int64_t threadNo, unique_ptr<ProcessQueueItem>
             }
         } else {
             for (iter = mPriorityQueue[i].begin(); iter != mPriorityQueue[i].end(); ++iter) {
-                if (!(*iter)->Pop(item)) {
+                if (!(*iter)->PopBatch(items, maxCnt, maxBytes)) {
                     continue;
                 }
                 configName = (*iter)->GetConfigName();
@@ -204,36 +234,102 @@ bool ProcessQueueManager::PopItem(int64_t threadNo, unique_ptr<ProcessQueueItem>
             return true;
         }
         // find exactly once queues next
-        {
-            lock_guard<mutex> lock(ExactlyOnceQueueManager::GetInstance()->mProcessQueueMux);
-            for (auto iter = ExactlyOnceQueueManager::GetInstance()->mProcessPriorityQueue[i].begin();
-                 iter != ExactlyOnceQueueManager::GetInstance()->mProcessPriorityQueue[i].end();
-                 ++iter) {
-                // process queue for exactly once can only be assgined to one specific thread
-                if (iter->GetKey() % INT32_FLAG(process_thread_count) != threadNo) {
+        if (PopExactlyOnceItem(i, threadNo, items, configName)) {
+            ResetCurrentQueueIndex();
+            return true;
+        }
+    }
+    ResetCurrentQueueIndex();
+    {
+        // pushing is excluded by the queue lock, so no item can be pushed after the scan before the flag is cleared
+        lock_guard<mutex> stateLock(mStateMux);
+        mValidToPop = false;
+    }
+    return false;
+}
+
+bool ProcessQueueManager::PopItemsWithWorkStealing(int64_t threadNo,
+                                                   vector<unique_ptr<ProcessQueueItem>>& items,
+                                                   string& configName,
+                                                   size_t maxCnt,
+                                                   size_t maxBytes) {
+    // where each thread stopped last time for each priority, so that queues of the same priority are served fairly
+    static thread_local size_t sNextIndex[sMaxPriority + 1] = {};
+
+    size_t threadCnt = static_cast<size_t>(max(INT32_FLAG(process_thread_count), 1));
+    shared_lock<shared_mutex> lock(mQueueMux);
+    uint64_t triggerCnt = 0;
+    {
+        lock_guard<mutex> stateLock(mStateMux);
+        triggerCnt = mTriggerCnt;
+    }
+    for (uint32_t i = 0; i <= sMaxPriority; ++i) {
+        const auto& queues = mPriorityQueueSnapshot[i];
+        size_t size = queues.size();
+        // the thread first serves the queues it owns, i.e. index % threadCnt == threadNo, then steals from the queues
+        // owned by other threads. An owned queue is waited for if being pushed, while a queue of another thread is
+        // skipped when claimed, since it is being served anyway. Items of one queue are always popped under its
+        // claim, so the order within a config holds.
+        for (bool owned : {true, false}) {
+            for (size_t j = 0; j < size; ++j) {
+                size_t idx = (sNextIndex[i] + j) % size;
+                if ((idx % threadCnt == static_cast<size_t>(threadNo)) != owned) {
                     continue;
                 }
-                if (!iter->Pop(item)) {
+                auto* que = queues[idx];
+                unique_lock<mutex> claim = owned ? unique_lock<mutex>(que->GetClaimMux())
+                                                 : unique_lock<mutex>(que->GetClaimMux(), try_to_lock);
+                if (!claim.owns_lock() || !que->PopBatch(items, maxCnt, maxBytes)) {
                     continue;
                 }
-                configName = iter->GetConfigName();
-                ResetCurrentQueueIndex();
+                configName = que->GetConfigName();
+                sNextIndex[i] = idx + 1;
                 return true;
             }
         }
+        if (PopExactlyOnceItem(i, threadNo, items, configName)) {
+            return true;
+        }
     }
-    ResetCurrentQueueIndex();
     {
-        unique_lock<mutex> lock(mStateMux);
-        mValidToPop = false;
+        // items can be pushed concurrently under the shared lock, so the flag is kept if triggered during the scan
+        lock_guard<mutex> stateLock(mStateMux);
+        if (mTriggerCnt == triggerCnt) {
+            mValidToPop = false;
+        }
+    }
+    return false;
+}
+
+bool ProcessQueueManager::PopExactlyOnceItem(uint32_t priority,
+                                             int64_t threadNo,
+                                             vector<unique_ptr<ProcessQueueItem>>& items,
+                                             string& configName) {
+    lock_guard<mutex> lock(ExactlyOnceQueueManager::GetInstance()->mProcessQueueMux);
+    for (auto iter = ExactlyOnceQueueManager::GetInstance()->mProcessPriorityQueue[priority].begin();
+         iter != ExactlyOnceQueueManager::GetInstance()->mProcessPriorityQueue[priority].end();
+         ++iter) {
+        // process queue for exactly once can only be assgined to one specific thread
+        if (iter->GetKey() % INT32_FLAG(process_thread_count) != threadNo) {
+            continue;
+        }
+        // items of exactly once queues are never batched, since each of them is bound to its own checkpoint
+        unique_ptr<ProcessQueueItem> item;
+        if (!iter->Pop(item)) {
+            continue;
+        }
+        items.emplace_back(std::move(item));
+        configName = iter->GetConfigName();
+        return true;
     }
     return false;
 }
 
 bool ProcessQueueManager::IsAllQueueEmpty() const {
     {
-        lock_guard<mutex> lock(mQueueMux);
+        shared_lock<shared_mutex> lock(mQueueMux);
         for (const auto& q : mQueues) {
+            lock_guard<mutex> claim((*q.second.first)->GetClaimMux());
             if (!(*q.second.first)->Empty()) {
                 return false;
             }
@@ -243,7 +339,7 @@ bool ProcessQueueManager::IsAllQueueEmpty() const {
 }
 
 bool ProcessQueueManager::SetDownStreamQueues(QueueKey key, vector<BoundedSenderQueueInterface*>&& ques) {
-    lock_guard<mutex> lock(mQueueMux);
+    lock_guard<shared_mutex> lock(mQueueMux);
     auto iter = mQueues.find(key);
     if (iter == mQueues.end()) {
         return false;
@@ -253,7 +349,7 @@ bool ProcessQueueManager::SetDownStreamQueues(QueueKey key, vector<BoundedSender
 }
 
 bool ProcessQueueManager::SetFeedbackInterface(QueueKey key, vector<FeedbackInterface*>&& feedback) {
-    lock_guard<mutex> lock(mQueueMux);
+    lock_guard<shared_mutex> lock(mQueueMux);
     auto iter = mQueues.find(key);
     if (iter == mQueues.end()) {
         return false;
@@ -272,7 +368,7 @@ bool ProcessQueueManager::SetFeedbackInterface(QueueKey key, vector<FeedbackInte
 void ProcessQueueManager::DisablePop(const string& configName, bool isPipelineRemoving) {
     if (QueueKeyManager::GetInstance()->HasKey(configName)) {
         auto key = QueueKeyManager::GetInstance()->GetKey(configName);
-        lock_guard<mutex> lock(mQueueMux);
+        lock_guard<shared_mutex> lock(mQueueMux);
         auto iter = mQueues.find(key);
         if (iter != mQueues.end()) {
             (*iter->second.first)->DisablePop();
@@ -285,7 +381,7 @@ void ProcessQueueManager::DisablePop(const string& configName, bool isPipelineRe
 void ProcessQueueManager::EnablePop(const string& configName) {
     if (QueueKeyManager::GetInstance()->HasKey(configName)) {
         auto key = QueueKeyManager::GetInstance()->GetKey(configName);
-        lock_guard<mutex> lock(mQueueMux);
+        lock_guard<shared_mutex> lock(mQueueMux);
         auto iter = mQueues.find(key);
         if (iter != mQueues.end()) {
             (*iter->second.first)->EnablePop();
@@ -310,6 +406,7 @@ void ProcessQueueManager::Trigger() {
     {
         lock_guard<mutex> lock(mStateMux);
         mValidToPop = true;
+        ++mTriggerCnt;
     }
     mCond.notify_one();
 }
@@ -325,6 +422,7 @@ void ProcessQueueManager::CreateCountBoundedQueue(QueueKey key,
                                               priority,
                                               ctx));
     mQueues[key] = make_pair(prev(mPriorityQueue[priority].end()), QueueType::COUNT_BOUNDED);
+    RebuildQueueSnapshot(priority);
 }
 
 void ProcessQueueManager::CreateCircularQueue(QueueKey key,
@@ -333,6 +431,7 @@ void ProcessQueueManager::CreateCircularQueue(QueueKey key,
                                               const CollectionPipelineContext& ctx) {
     mPriorityQueue[priority].emplace_back(make_unique<CircularProcessQueue>(capacity, key, priority, ctx));
     mQueues[key] = make_pair(prev(mPriorityQueue[priority].end()), QueueType::CIRCULAR);
+    RebuildQueueSnapshot(priority);
 }
 
 void ProcessQueueManager::CreateBytesBoundedQueue(QueueKey key,
@@ -346,6 +445,7 @@ void ProcessQueueManager::CreateBytesBoundedQueue(QueueKey key,
                                               priority,
                                               ctx));
     mQueues[key] = make_pair(prev(mPriorityQueue[priority].end()), QueueType::BYTES_BOUNDED);
+    RebuildQueueSnapshot(priority);
 }
 
 void ProcessQueueManager::AdjustQueuePriority(const ProcessQueueIterator& iter, uint32_t priority) {
@@ -353,6 +453,8 @@ void ProcessQueueManager::AdjustQueuePriority(const ProcessQueueIterator& iter,
     auto nextQueIter = next(iter);
     mPriorityQueue[priority].splice(mPriorityQueue[priority].end(), mPriorityQueue[oldPriority], iter);
     (*iter)->SetPriority(priority);
+    RebuildQueueSnapshot(oldPriority);
+    RebuildQueueSnapshot(priority);
     if (mCurrentQueueIndex.first == oldPriority && mCurrentQueueIndex.second == iter) {
         if (nextQueIter == mPriorityQueue[oldPriority].end()) {
             mCurrentQueueIndex.second = mPriorityQueue[oldPriority].begin();
@@ -365,6 +467,7 @@ void ProcessQueueManager::AdjustQueuePriority(const ProcessQueueIterator& iter,
 void ProcessQueueManager::DeleteQueueEntity(const ProcessQueueIterator& iter) {
     uint32_t priority = (*iter)->GetPriority();
     auto nextQueIter = mPriorityQueue[priority].erase(iter);
+    RebuildQueueSnapshot(priority);
     if (mCurrentQueueIndex.first == priority && mCurrentQueueIndex.second == iter) {
         if (nextQueIter == mPriorityQueue[priority].end()) {
             mCurrentQueueIndex.second = mPriorityQueue[priority].begin();
@@ -379,12 +482,22 @@ void ProcessQueueManager::ResetCurrentQueueIndex() {
     mCurrentQueueIndex.second = mPriorityQueue[0].begin();
 }
 
+void ProcessQueueManager::RebuildQueueSnapshot(uint32_t priority) {
+    auto& snapshot = mPriorityQueueSnapshot[priority];
+    snapshot.clear();
+    snapshot.reserve(mPriorityQueue[priority].size());
+    for (const auto& q : mPriorityQueue[priority]) {
+        snapshot.push_back(q.get());
+    }
+}
+
 #ifdef APSARA_UNIT_TEST_MAIN
 void ProcessQueueManager::Clear() {
-    lock_guard<mutex> lock(mQueueMux);
+    lock_guard<shared_mutex> lock(mQueueMux);
     mQueues.clear();
     for (size_t i = 0; i <= sMaxPriority; ++i) {
         mPriorityQueue[i].clear();
+        mPriorityQueueSnapshot[i].clear();
     }
     ResetCurrentQueueIndex();
 }
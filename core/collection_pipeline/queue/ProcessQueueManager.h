@@ -19,9 +19,11 @@
 #include <cstdint>
 
 #include <condition_variable>
+#include <limits>
 #include <list>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -63,6 +65,13 @@ public:
     // 0: success, 1: queue is full, 2: queue not found
     QueueStatus PushQueue(QueueKey key, std::unique_ptr<ProcessQueueItem>&& item);
     bool PopItem(int64_t threadNo, std::unique_ptr<ProcessQueueItem>& item, std::string& configName);
+    // pop up to maxCnt items from one queue at a time, so that the caller can process them as a batch. No more item is
+    // popped once the data size of the batch reaches maxBytes.
+    bool PopItems(int64_t threadNo,
+                  std::vector<std::unique_ptr<ProcessQueueItem>>& items,
+                  std::string& configName,
+                  size_t maxCnt,
+                  size_t maxBytes = std::numeric_limits<size_t>::max());
     bool IsAllQueueEmpty() const;
     bool SetDownStreamQueues(QueueKey key, std::vector<BoundedSenderQueueInterface*>&& ques);
     bool SetFeedbackInterface(QueueKey key, std::vector<FeedbackInterface*>&& feedback);
@@ -82,18 +91,40 @@ private:
     void AdjustQueuePriority(const ProcessQueueIterator& iter, uint32_t priority);
     void DeleteQueueEntity(const ProcessQueueIterator& iter);
     void ResetCurrentQueueIndex();
+    void RebuildQueueSnapshot(uint32_t priority);
+
+    bool PopItemsRoundRobin(int64_t threadNo,
+                            std::vector<std::unique_ptr<ProcessQueueItem>>& items,
+                            std::string& configName,
+                            size_t maxCnt,
+                            size_t maxBytes);
+    bool PopItemsWithWorkStealing(int64_t threadNo,
+                                  std::vector<std::unique_ptr<ProcessQueueItem>>& items,
+                                  std::string& configName,
+                                  size_t maxCnt,
+                                  size_t maxBytes);
+    bool PopExactlyOnceItem(uint32_t priority,
+                            int64_t threadNo,
+                            std::vector<std::unique_ptr<ProcessQueueItem>>& items,
+                            std::string& configName);
 
     BoundedQueueParam mCountBoundedQueueParam;
     BoundedQueueParam mBytesBoundedQueueParam;
 
-    mutable std::mutex mQueueMux;
+    // exclusively locked when queues are created, updated or deleted, or when popping in round robin mode.
+    // pushing and popping in work stealing mode only take the shared lock plus the claim mutex of the queue.
+    mutable std::shared_mutex mQueueMux;
     std::unordered_map<QueueKey, std::pair<ProcessQueueIterator, QueueType>> mQueues;
     std::list<std::unique_ptr<ProcessQueueInterface>> mPriorityQueue[sMaxPriority + 1];
     std::pair<uint32_t, ProcessQueueIterator> mCurrentQueueIndex;
+    // random access view of mPriorityQueue, so that queues can be assigned to processor threads by index
+    std::vector<ProcessQueueInterface*> mPriorityQueueSnapshot[sMaxPriority + 1];
 
     mutable std::mutex mStateMux;
     mutable std::condition_variable mCond;
     bool mValidToPop = false;
+    // number of triggers so far, so that popping in work stealing mode can tell whether it has missed any item
+    uint64_t mTriggerCnt = 0;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     void Clear();
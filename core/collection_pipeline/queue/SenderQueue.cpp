@@ -103,7 +103,9 @@ bool SenderQueue::Remove(SenderQueueItem* item) {
     --mSize;
 
     ADD_COUNTER(mOutItemsTotal, 1);
-    ADD_COUNTER(mTotalDelayMs, chrono::system_clock::now() - enQueuTime);
+    auto delay = chrono::system_clock::now() - enQueuTime;
+    ADD_COUNTER(mTotalDelayMs, delay);
+    OBSERVE_HISTOGRAM(mDelayMs, delay);
     SUB_GAUGE(mQueueDataSizeByte, size);
 
     if (!mExtraBuffer.empty()) {
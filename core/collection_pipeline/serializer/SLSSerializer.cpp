@@ -38,6 +38,8 @@ namespace logtail {
 
 // Maximum size threshold for thread_local buffer before reallocation
 constexpr size_t kMaxThreadLocalBufferSize = 1024 * 1024;
+// serialized data is compressed in chunks of this size, which is the block size of zstd
+constexpr size_t kCompressChunkSize = 128 * 1024;
 
 void SerializeSpanLinksToString(const SpanEvent& event, std::string& result) {
     if (event.GetLinks().empty()) {
@@ -160,6 +162,56 @@ void SerializeSpanAttributesToString(const SpanEvent& event, std::string& result
 }
 
 bool SLSEventGroupSerializer::Serialize(BatchedEvents&& group, string& res, string& errorMsg) {
+    thread_local LogGroupSerializer serializer;
+    size_t logGroupSZ = 0;
+    if (!SerializeTo(group, serializer, nullptr, logGroupSZ, errorMsg)) {
+        return false;
+    }
+    res = std::move(serializer.GetResult());
+    return true;
+}
+
+bool SLSEventGroupSerializer::SerializeAndCompress(BatchedEvents&& group,
+                                                   Compressor& compressor,
+                                                   string& output,
+                                                   size_t& rawSize,
+                                                   string& errorMsg,
+                                                   bool& compressFailed) {
+    // unlike Serialize, the result is never moved out, so the buffer is reused by the next group in this thread
+    thread_local LogGroupSerializer serializer;
+    if (compressor.IsStreamingSupported()) {
+        bool streamFailed = false;
+        if (SerializeTo(group, serializer, &compressor, rawSize, errorMsg, &streamFailed)) {
+            if (compressor.EndStream(output, errorMsg)) {
+                return true;
+            }
+            streamFailed = true;
+        }
+        if (!streamFailed) {
+            return false;
+        }
+        // e.g. the stream fails if the size of data differs from the size it is begun with, and the group is still
+        // intact, so that it can be compressed as a whole instead of being discarded
+        LOG_WARNING(sLogger,
+                    ("failed to compress event group in stream", errorMsg)("action", "compress as a whole")(
+                        "config", mFlusher->GetContext().GetConfigName()));
+    }
+    if (!SerializeTo(group, serializer, nullptr, rawSize, errorMsg)) {
+        return false;
+    }
+    compressFailed = !compressor.DoCompress(serializer.GetResult(), output, errorMsg);
+    if (serializer.GetResult().capacity() > kMaxThreadLocalBufferSize) {
+        string().swap(serializer.GetResult()); // reallocate to avoid holding too much memory
+    }
+    return !compressFailed;
+}
+
+bool SLSEventGroupSerializer::SerializeTo(BatchedEvents& group,
+                                          LogGroupSerializer& serializer,
+                                          Compressor* compressor,
+                                          size_t& logGroupSZ,
+                                          string& errorMsg,
+                                          bool* streamFailed) {
     if (group.mEvents.empty()) {
         errorMsg = "empty event group";
         return false;
@@ -178,7 +230,7 @@ bool SLSEventGroupSerializer::Serialize(BatchedEvents&& group, string& res, stri
     vector<size_t> logSZ(group.mEvents.size());
     vector<MetricEventContentCacheItem> metricEventContentCache(group.mEvents.size());
     vector<array<string, 6>> spanEventContentCache(group.mEvents.size());
-    size_t logGroupSZ = 0;
+    logGroupSZ = 0;
     switch (eventType) {
         case PipelineEvent::Type::LOG: {
             CalculateLogEventSize(group, logGroupSZ, logSZ, enableNs);
@@ -218,7 +270,17 @@ bool SLSEventGroupSerializer::Serialize(BatchedEvents&& group, string& res, stri
         return false;
     }
 
-    thread_local LogGroupSerializer serializer;
+    if (compressor != nullptr) {
+        if (!compressor->BeginStream(logGroupSZ, errorMsg)) {
+            if (streamFailed != nullptr) {
+                *streamFailed = true;
+            }
+            return false;
+        }
+        serializer.SetChunkSink(
+            [compressor, &errorMsg](StringView chunk) { return compressor->AppendToStream(chunk, errorMsg); },
+            kCompressChunkSize);
+    }
     serializer.Prepare(logGroupSZ);
     switch (eventType) {
         case PipelineEvent::Type::LOG:
@@ -247,7 +309,14 @@ bool SLSEventGroupSerializer::Serialize(BatchedEvents&& group, string& res, stri
             serializer.AddLogTag(tag.first, tag.second);
         }
     }
-    res = std::move(serializer.GetResult());
+    if (compressor != nullptr) {
+        bool res = serializer.Flush();
+        serializer.SetChunkSink(nullptr, 0);
+        if (!res && streamFailed != nullptr) {
+            *streamFailed = true;
+        }
+        return res;
+    }
     return true;
 }
 
@@ -35,6 +35,21 @@ public:
 
 private:
     bool Serialize(BatchedEvents&& p, std::string& res, std::string& errorMsg) override;
+    bool SerializeAndCompress(BatchedEvents&& p,
+                              Compressor& compressor,
+                              std::string& output,
+                              size_t& rawSize,
+                              std::string& errorMsg,
+                              bool& compressFailed) override;
+
+    // if compressor is given, a stream is begun with it and serialized data is appended to the stream in chunks, and
+    // streamFailed is set if it is the stream that fails
+    bool SerializeTo(BatchedEvents& group,
+                     LogGroupSerializer& serializer,
+                     Compressor* compressor,
+                     size_t& logGroupSZ,
+                     std::string& errorMsg,
+                     bool* streamFailed = nullptr);
 
     void CalculateLogEventSize(const BatchedEvents& group,
                                size_t& logGroupSZ,
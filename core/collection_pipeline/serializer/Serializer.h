@@ -21,6 +21,7 @@
 
 #include "collection_pipeline/batch/BatchedEvents.h"
 #include "collection_pipeline/plugin/interface/Flusher.h"
+#include "common/compression/Compressor.h"
 #include "models/PipelineEventPtr.h"
 #include "monitor/metric_constants/MetricConstants.h"
 
@@ -84,6 +85,35 @@ public:
         return res;
     }
 
+    // Serializes p and compresses the serialized data with compressor, and rawSize is set to the size of the serialized
+    // data. Serializers producing data in chunks may compress each chunk once it is ready, so that the whole serialized
+    // data is never held in memory. Time spent on compression is counted by both the serializer and the compressor.
+    // On failure, compressFailed tells whether it is the compression that failed.
+    bool DoSerializeAndCompress(T&& p,
+                                Compressor& compressor,
+                                std::string& output,
+                                size_t& rawSize,
+                                std::string& errorMsg,
+                                bool& compressFailed) {
+        auto inputSize = GetInputSize(p);
+        ADD_COUNTER(mInItemsTotal, 1);
+        ADD_COUNTER(mInItemSizeBytes, inputSize);
+
+        compressFailed = false;
+        auto before = std::chrono::system_clock::now();
+        auto res = SerializeAndCompress(std::move(p), compressor, output, rawSize, errorMsg, compressFailed);
+        ADD_COUNTER(mTotalProcessMs, std::chrono::system_clock::now() - before);
+
+        if (res) {
+            ADD_COUNTER(mOutItemsTotal, 1);
+            ADD_COUNTER(mOutItemSizeBytes, rawSize);
+        } else {
+            ADD_COUNTER(mDiscardedItemsTotal, 1);
+            ADD_COUNTER(mDiscardedItemSizeBytes, inputSize);
+        }
+        return res;
+    }
+
 protected:
     // if serialized output contains output related info, it can be obtained via this member
     const Flusher* mFlusher = nullptr;
@@ -99,6 +129,20 @@ protected:
 
 private:
     virtual bool Serialize(T&& p, std::string& res, std::string& errorMsg) = 0;
+    virtual bool SerializeAndCompress(T&& p,
+                                      Compressor& compressor,
+                                      std::string& output,
+                                      size_t& rawSize,
+                                      std::string& errorMsg,
+                                      bool& compressFailed) {
+        std::string serializedData;
+        if (!Serialize(std::move(p), serializedData, errorMsg)) {
+            return false;
+        }
+        rawSize = serializedData.size();
+        compressFailed = !compressor.DoCompress(serializedData, output, errorMsg);
+        return !compressFailed;
+    }
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class SerializerUnittest;
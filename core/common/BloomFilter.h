@@ -0,0 +1,88 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "common/StringView.h"
+
+namespace logtail {
+
+// A bloom filter for strings, which can be read and added to concurrently without any lock.
+// MayContain never returns false for a string added since the last Clear, and returns true for other strings with a
+// probability of about 0.1% while no more than expectedCnt strings are added.
+class BloomFilter {
+public:
+    explicit BloomFilter(size_t expectedCnt) {
+        // 16 bits per string, rounded up to a power of 2 for masking
+        size_t bitCnt = 64;
+        while (bitCnt < expectedCnt * 16) {
+            bitCnt <<= 1;
+        }
+        mWordCnt = bitCnt / 64;
+        mBits = std::make_unique<std::atomic<uint64_t>[]>(mWordCnt);
+        Clear();
+    }
+
+    void Add(StringView str) {
+        uint64_t h1 = 0, h2 = 0;
+        Hash(str, h1, h2);
+        for (size_t i = 0; i < kHashCnt; ++i) {
+            uint64_t bit = (h1 + i * h2) & (mWordCnt * 64 - 1);
+            mBits[bit / 64].fetch_or(1ULL << (bit % 64), std::memory_order_relaxed);
+        }
+    }
+
+    bool MayContain(StringView str) const {
+        uint64_t h1 = 0, h2 = 0;
+        Hash(str, h1, h2);
+        for (size_t i = 0; i < kHashCnt; ++i) {
+            uint64_t bit = (h1 + i * h2) & (mWordCnt * 64 - 1);
+            if ((mBits[bit / 64].load(std::memory_order_relaxed) & (1ULL << (bit % 64))) == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // not atomic as a whole, strings being added concurrently may or may not be kept
+    void Clear() {
+        for (size_t i = 0; i < mWordCnt; ++i) {
+            mBits[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    static constexpr size_t kHashCnt = 6;
+
+    // double hashing, with h2 odd so that all probes differ
+    static void Hash(StringView str, uint64_t& h1, uint64_t& h2) {
+        uint64_t h = StringViewHash()(str);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h1 = h;
+        h2 = (h >> 32) | (h << 32) | 1;
+    }
+
+    size_t mWordCnt = 0;
+    std::unique_ptr<std::atomic<uint64_t>[]> mBits;
+};
+
+} // namespace logtail
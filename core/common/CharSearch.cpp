@@ -0,0 +1,330 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/CharSearch.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define LOGTAIL_CHAR_SEARCH_X86 1
+#include <immintrin.h>
+#endif
+
+namespace logtail {
+
+namespace {
+
+size_t FindFirstCharScalar(const char* data, size_t size, char c) {
+    const void* pos = memchr(data, c, size);
+    return pos == nullptr ? size : static_cast<const char*>(pos) - data;
+}
+
+size_t FindLastCharScalar(const char* data, size_t size, char c) {
+#if defined(__GLIBC__)
+    const void* pos = memrchr(data, c, size);
+    return pos == nullptr ? size : static_cast<const char*>(pos) - data;
+#else
+    // scans 8 bytes at a time, a word containing @c has a zero byte after being xor-ed with the pattern
+    constexpr uint64_t kLowBits = 0x0101010101010101ULL;
+    constexpr uint64_t kHighBits = 0x8080808080808080ULL;
+    const uint64_t pattern = kLowBits * static_cast<unsigned char>(c);
+    size_t end = size;
+    for (; end >= sizeof(uint64_t); end -= sizeof(uint64_t)) {
+        uint64_t word = 0;
+        memcpy(&word, data + end - sizeof(uint64_t), sizeof(uint64_t));
+        word ^= pattern;
+        if (((word - kLowBits) & ~word & kHighBits) != 0) {
+            break;
+        }
+    }
+    for (; end > 0; --end) {
+        if (data[end - 1] == c) {
+            return end - 1;
+        }
+    }
+    return size;
+#endif
+}
+
+size_t FindSubstringScalar(const char* data, size_t size, const char* needle, size_t needleSize) {
+    size_t pos = 0;
+    while (pos + needleSize <= size) {
+        size_t offset = FindFirstCharScalar(data + pos, size - pos - needleSize + 1, needle[0]);
+        if (offset == size - pos - needleSize + 1) {
+            return size;
+        }
+        pos += offset;
+        if (memcmp(data + pos + 1, needle + 1, needleSize - 1) == 0) {
+            return pos;
+        }
+        ++pos;
+    }
+    return size;
+}
+
+#ifdef LOGTAIL_CHAR_SEARCH_X86
+__attribute__((target("sse2"))) size_t FindFirstCharSSE2(const char* data, size_t size, char c) {
+    const __m128i needle = _mm_set1_epi8(c);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    for (; i < size; ++i) {
+        if (data[i] == c) {
+            return i;
+        }
+    }
+    return size;
+}
+
+__attribute__((target("sse2"))) size_t FindLastCharSSE2(const char* data, size_t size, char c) {
+    const __m128i needle = _mm_set1_epi8(c);
+    size_t end = size;
+    for (; end >= 16; end -= 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + end - 16));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+        if (mask != 0) {
+            return end - 16 + (31 - __builtin_clz(mask));
+        }
+    }
+    for (; end > 0; --end) {
+        if (data[end - 1] == c) {
+            return end - 1;
+        }
+    }
+    return size;
+}
+
+// Candidates are positions where both the first and the last byte of the needle match, which are rare enough on real
+// text that verifying each of them with memcmp is cheap. Needle size should be at least 2.
+__attribute__((target("sse2"))) size_t
+FindSubstringSSE2(const char* data, size_t size, const char* needle, size_t needleSize) {
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[needleSize - 1]);
+    size_t i = 0;
+    for (; i + needleSize - 1 + 16 <= size; i += 16) {
+        __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + needleSize - 1));
+        uint32_t mask = static_cast<uint32_t>(
+            _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last))));
+        while (mask != 0) {
+            size_t pos = i + __builtin_ctz(mask);
+            if (memcmp(data + pos + 1, needle + 1, needleSize - 2) == 0) {
+                return pos;
+            }
+            mask &= mask - 1;
+        }
+    }
+    size_t res = FindSubstringScalar(data + i, size - i, needle, needleSize);
+    return res == size - i ? size : i + res;
+}
+
+__attribute__((target("avx2"))) size_t FindFirstCharAVX2(const char* data, size_t size, char c) {
+    const __m256i needle = _mm256_set1_epi8(c);
+    size_t i = 0;
+    // 64 bytes per iteration to hide the latency of the compare-movemask chain on long lines.
+    for (; i + 64 <= size; i += 64) {
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32));
+        __m256i eqLo = _mm256_cmpeq_epi8(lo, needle);
+        __m256i eqHi = _mm256_cmpeq_epi8(hi, needle);
+        if (!_mm256_testz_si256(_mm256_or_si256(eqLo, eqHi), _mm256_or_si256(eqLo, eqHi))) {
+            uint32_t maskLo = static_cast<uint32_t>(_mm256_movemask_epi8(eqLo));
+            if (maskLo != 0) {
+                return i + __builtin_ctz(maskLo);
+            }
+            uint32_t maskHi = static_cast<uint32_t>(_mm256_movemask_epi8(eqHi));
+            return i + 32 + __builtin_ctz(maskHi);
+        }
+    }
+    for (; i + 32 <= size; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    for (; i < size; ++i) {
+        if (data[i] == c) {
+            return i;
+        }
+    }
+    return size;
+}
+
+__attribute__((target("avx2"))) size_t FindLastCharAVX2(const char* data, size_t size, char c) {
+    const __m256i needle = _mm256_set1_epi8(c);
+    size_t end = size;
+    for (; end >= 32; end -= 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + end - 32));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+        if (mask != 0) {
+            return end - 32 + (31 - __builtin_clz(mask));
+        }
+    }
+    for (; end > 0; --end) {
+        if (data[end - 1] == c) {
+            return end - 1;
+        }
+    }
+    return size;
+}
+
+__attribute__((target("avx2"))) size_t
+FindSubstringAVX2(const char* data, size_t size, const char* needle, size_t needleSize) {
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[needleSize - 1]);
+    size_t i = 0;
+    for (; i + needleSize - 1 + 32 <= size; i += 32) {
+        __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + needleSize - 1));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first), _mm256_cmpeq_epi8(blockLast, last))));
+        while (mask != 0) {
+            size_t pos = i + __builtin_ctz(mask);
+            if (memcmp(data + pos + 1, needle + 1, needleSize - 2) == 0) {
+                return pos;
+            }
+            mask &= mask - 1;
+        }
+    }
+    size_t res = FindSubstringScalar(data + i, size - i, needle, needleSize);
+    return res == size - i ? size : i + res;
+}
+#endif
+
+using FindCharFunc = size_t (*)(const char*, size_t, char);
+using FindSubstringFunc = size_t (*)(const char*, size_t, const char*, size_t);
+
+struct CharSearchDispatcher {
+    CharSearchDispatcher() { Select(DetectImpl()); }
+
+    static CharSearchImpl DetectImpl() {
+#ifdef LOGTAIL_CHAR_SEARCH_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return CharSearchImpl::AVX2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return CharSearchImpl::SSE2;
+        }
+#endif
+        return CharSearchImpl::SCALAR;
+    }
+
+    static bool IsSupported(CharSearchImpl impl) {
+#ifdef LOGTAIL_CHAR_SEARCH_X86
+        __builtin_cpu_init();
+        switch (impl) {
+            case CharSearchImpl::AVX2:
+                return __builtin_cpu_supports("avx2");
+            case CharSearchImpl::SSE2:
+                return __builtin_cpu_supports("sse2");
+            default:
+                return true;
+        }
+#else
+        return impl == CharSearchImpl::SCALAR;
+#endif
+    }
+
+    void Select(CharSearchImpl impl) {
+        mImpl = impl;
+        switch (impl) {
+#ifdef LOGTAIL_CHAR_SEARCH_X86
+            case CharSearchImpl::AVX2:
+                mFindFirst = FindFirstCharAVX2;
+                mFindLast = FindLastCharAVX2;
+                mFindSubstring = FindSubstringAVX2;
+                break;
+            case CharSearchImpl::SSE2:
+                mFindFirst = FindFirstCharSSE2;
+                mFindLast = FindLastCharSSE2;
+                mFindSubstring = FindSubstringSSE2;
+                break;
+#endif
+            default:
+                mImpl = CharSearchImpl::SCALAR;
+                mFindFirst = FindFirstCharScalar;
+                mFindLast = FindLastCharScalar;
+                mFindSubstring = FindSubstringScalar;
+                break;
+        }
+    }
+
+    CharSearchImpl mImpl = CharSearchImpl::SCALAR;
+    FindCharFunc mFindFirst = FindFirstCharScalar;
+    FindCharFunc mFindLast = FindLastCharScalar;
+    FindSubstringFunc mFindSubstring = FindSubstringScalar;
+};
+
+CharSearchDispatcher& GetDispatcher() {
+    static CharSearchDispatcher sDispatcher;
+    return sDispatcher;
+}
+
+} // namespace
+
+size_t FindFirstChar(const char* data, size_t size, char c) {
+    return GetDispatcher().mFindFirst(data, size, c);
+}
+
+size_t FindLastChar(const char* data, size_t size, char c) {
+    return GetDispatcher().mFindLast(data, size, c);
+}
+
+size_t FindSubstring(const char* data, size_t size, const char* needle, size_t needleSize) {
+    if (needleSize == 0) {
+        return 0;
+    }
+    if (needleSize > size) {
+        return size;
+    }
+    if (needleSize == 1) {
+        return GetDispatcher().mFindFirst(data, size, needle[0]);
+    }
+    return GetDispatcher().mFindSubstring(data, size, needle, needleSize);
+}
+
+CharSearchImpl GetCharSearchImpl() {
+    return GetDispatcher().mImpl;
+}
+
+const char* GetCharSearchImplName() {
+    switch (GetDispatcher().mImpl) {
+        case CharSearchImpl::AVX2:
+            return "avx2";
+        case CharSearchImpl::SSE2:
+            return "sse2";
+        default:
+            return "scalar";
+    }
+}
+
+#ifdef APSARA_UNIT_TEST_MAIN
+bool SetCharSearchImpl(CharSearchImpl impl) {
+    if (!CharSearchDispatcher::IsSupported(impl)) {
+        return false;
+    }
+    GetDispatcher().Select(impl);
+    return true;
+}
+#endif
+
+} // namespace logtail
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace logtail {
+
+// Single byte and substring search over raw buffers, used to split read buffers into lines and to pre-filter values
+// before running regexes.
+// The implementation is selected once at runtime: AVX2 on x86-64 when supported by the CPU, SSE2 on other x86-64
+// CPUs, otherwise a scalar fallback.
+enum class CharSearchImpl { SCALAR, SSE2, AVX2 };
+
+// Returns the offset of the first @c in [data, data + size), or size if not found.
+size_t FindFirstChar(const char* data, size_t size, char c);
+
+// Returns the offset of the last @c in [data, data + size), or size if not found.
+size_t FindLastChar(const char* data, size_t size, char c);
+
+// Returns the offset of the first occurrence of [needle, needle + needleSize) in [data, data + size), or size if not
+// found. An empty needle is found at offset 0.
+size_t FindSubstring(const char* data, size_t size, const char* needle, size_t needleSize);
+
+CharSearchImpl GetCharSearchImpl();
+const char* GetCharSearchImplName();
+
+#ifdef APSARA_UNIT_TEST_MAIN
+// Force a specific implementation, used to compare implementations in unit tests and benchmarks.
+// Returns false if the implementation is not supported by current CPU.
+bool SetCharSearchImpl(CharSearchImpl impl);
+#endif
+
+} // namespace logtail
@@ -25,32 +25,47 @@
 namespace logtail {
 
 #if defined(__linux__)
-static iconv_t mGbk2Utf8Cd = (iconv_t)-1;
+// iconv descriptors keep the conversion state, so each thread reading files holds its own one
+class Gbk2Utf8Descriptor {
+public:
+    Gbk2Utf8Descriptor() : mCd(iconv_open("UTF-8", "GBK")) {
+        if (mCd == (iconv_t)(-1))
+            LOG_ERROR(sLogger, ("create Gbk2Utf8 iconv descriptor fail, errno", strerror(errno)));
+        else
+            iconv(mCd, NULL, NULL, NULL, NULL);
+    }
+    ~Gbk2Utf8Descriptor() {
+        if (mCd != (iconv_t)(-1))
+            iconv_close(mCd);
+    }
+    Gbk2Utf8Descriptor(const Gbk2Utf8Descriptor&) = delete;
+    Gbk2Utf8Descriptor& operator=(const Gbk2Utf8Descriptor&) = delete;
+
+    iconv_t Get() const { return mCd; }
+
+private:
+    iconv_t mCd;
+};
+
+static iconv_t GetGbk2Utf8Cd() {
+    thread_local Gbk2Utf8Descriptor sDescriptor;
+    return sDescriptor.Get();
+}
 #endif
 
 EncodingConverter::EncodingConverter() {
-#if defined(__linux__)
-    mGbk2Utf8Cd = iconv_open("UTF-8", "GBK");
-    if (mGbk2Utf8Cd == (iconv_t)(-1))
-        LOG_ERROR(sLogger, ("create Gbk2Utf8 iconv descriptor fail, errno", strerror(errno)));
-    else
-        iconv(mGbk2Utf8Cd, NULL, NULL, NULL, NULL);
-#endif
 }
 
 EncodingConverter::~EncodingConverter() {
-#if defined(__linux__)
-    if (mGbk2Utf8Cd != (iconv_t)(-1))
-        iconv_close(mGbk2Utf8Cd);
-#endif
 }
 
 // TODO: Refactor it, do not use the output params to do calculations, set them before return.
 size_t EncodingConverter::ConvertGbk2Utf8(
     const char* src, size_t* srcLength, char* desOut, size_t desLength, const std::vector<long>& linePosVec) const {
 #if defined(__linux__)
-    if (src == NULL || *srcLength == 0 || mGbk2Utf8Cd == (iconv_t)(-1)) {
-        LOG_ERROR(sLogger, ("invalid iconv descriptor fail or invalid buffer pointer, cd", mGbk2Utf8Cd));
+    iconv_t gbk2Utf8Cd = GetGbk2Utf8Cd();
+    if (src == NULL || *srcLength == 0 || gbk2Utf8Cd == (iconv_t)(-1)) {
+        LOG_ERROR(sLogger, ("invalid iconv descriptor fail or invalid buffer pointer, cd", gbk2Utf8Cd));
         return 0;
     }
     size_t maxRequire = *srcLength * 2;
@@ -75,10 +90,10 @@ size_t EncodingConverter::ConvertGbk2Utf8(
         // include '\n'
         *srcLength = endIndex - beginIndex + 1;
         desLength = maxDestSize - destIndex;
-        size_t ret = iconv(mGbk2Utf8Cd, const_cast<char**>(&src), srcLength, &des, &desLength);
+        size_t ret = iconv(gbk2Utf8Cd, const_cast<char**>(&src), srcLength, &des, &desLength);
         if (ret == (size_t)(-1)) {
             LOG_ERROR(sLogger, ("convert GBK to UTF8 fail, errno", strerror(errno)));
-            iconv(mGbk2Utf8Cd, NULL, NULL, NULL, NULL); // Clear status.
+            iconv(gbk2Utf8Cd, NULL, NULL, NULL, NULL); // Clear status.
             AlarmManager::GetInstance()->SendAlarmWarning(ENCODING_CONVERT_ALARM, "convert GBK to UTF8 fail");
             // use memcpy
             memcpy(originDes + destIndex, originSrc + beginIndex, endIndex - beginIndex + 1);
@@ -0,0 +1,173 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/StringView.h"
+
+namespace logtail {
+
+// A thread-safe cache with string keys for read-mostly workloads, as a drop-in replacement of
+// lru11::Cache<std::string, Value, std::mutex>.
+// Keys are distributed to shards, each guarded by its own reader-writer lock, and lookups only take the reader lock,
+// so concurrent readers never block each other. Lookups accept StringView, and no string is allocated for them.
+// Recency is tracked by ticks: an insertion advances the tick of its shard, and a lookup stamps the entry with the
+// current tick, so entries are ordered by their last access except for lookups between two insertions. When a shard
+// grows beyond its share of (maxSize + elasticity), the entries accessed least recently are evicted until the shard is
+// back to its share of maxSize. Shares are a quarter larger than maxSize / shardCnt, as keys are not distributed
+// evenly, so the cache may hold up to 1.25 * maxSize entries.
+template <class Value>
+class ShardedLRUCache {
+public:
+    explicit ShardedLRUCache(size_t maxSize = 64, size_t elasticity = 10, size_t shardCnt = 16) {
+        shardCnt = std::max<size_t>(shardCnt, 1);
+        mShardMaxSize = (maxSize + shardCnt - 1) / shardCnt;
+        mShardMaxSize = std::max<size_t>(shardCnt == 1 ? mShardMaxSize : mShardMaxSize + mShardMaxSize / 4, 1);
+        mShardElasticity = std::max<size_t>((elasticity + shardCnt - 1) / shardCnt, 1);
+        for (size_t i = 0; i < shardCnt; ++i) {
+            mShards.emplace_back(std::make_unique<Shard>());
+        }
+    }
+
+    size_t size() const {
+        size_t res = 0;
+        for (const auto& shard : mShards) {
+            std::shared_lock<std::shared_mutex> lock(shard->mMux);
+            res += shard->mMap.size();
+        }
+        return res;
+    }
+
+    void clear() {
+        for (auto& shard : mShards) {
+            std::unique_lock<std::shared_mutex> lock(shard->mMux);
+            shard->mMap.clear();
+        }
+    }
+
+    void insert(StringView key, const Value& value) {
+        auto& shard = GetShard(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mMux);
+        // inserted entries take odd ticks, and entries looked up before the next insertion take the even one after
+        shard.mTick += 2;
+        auto tick = shard.mTick - 1;
+        auto it = shard.mMap.find(key);
+        if (it != shard.mMap.end()) {
+            it->second->mValue = value;
+            it->second->mTick.store(tick, std::memory_order_relaxed);
+            return;
+        }
+        auto node = std::make_unique<Node>(std::string(key.data(), key.size()), value, tick);
+        StringView nodeKey(node->mKey);
+        shard.mMap.emplace(nodeKey, std::move(node));
+        if (shard.mMap.size() > mShardMaxSize + mShardElasticity) {
+            shard.Prune(mShardMaxSize);
+        }
+    }
+
+    bool tryGetCopy(StringView key, Value& value) const {
+        auto& shard = GetShard(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mMux);
+        auto it = shard.mMap.find(key);
+        if (it == shard.mMap.end()) {
+            return false;
+        }
+        // readers may stamp the same entry concurrently, and any of the stamps will do
+        it->second->mTick.store(shard.mTick, std::memory_order_relaxed);
+        value = it->second->mValue;
+        return true;
+    }
+
+    bool contains(StringView key) const {
+        auto& shard = GetShard(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mMux);
+        return shard.mMap.find(key) != shard.mMap.end();
+    }
+
+    bool remove(StringView key) {
+        auto& shard = GetShard(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mMux);
+        return shard.mMap.erase(key) > 0;
+    }
+
+    // call f with each key, shard by shard, while the shard being visited is locked for reading
+    template <typename F>
+    void forEachKey(F&& f) const {
+        for (const auto& shard : mShards) {
+            std::shared_lock<std::shared_mutex> lock(shard->mMux);
+            for (const auto& item : shard->mMap) {
+                f(item.first);
+            }
+        }
+    }
+
+private:
+    struct Node {
+        Node(std::string&& key, const Value& value, uint64_t tick) : mKey(std::move(key)), mValue(value), mTick(tick) {}
+
+        std::string mKey;
+        Value mValue;
+        std::atomic<uint64_t> mTick;
+    };
+
+    // aligned to avoid false sharing between the locks of adjacent shards
+    struct alignas(64) Shard {
+        void Prune(size_t maxSize) {
+            std::vector<std::pair<uint64_t, StringView>> ticks;
+            ticks.reserve(mMap.size());
+            for (const auto& item : mMap) {
+                ticks.emplace_back(item.second->mTick.load(std::memory_order_relaxed), item.first);
+            }
+            std::nth_element(ticks.begin(), ticks.begin() + maxSize, ticks.end(), [](const auto& l, const auto& r) {
+                return l.first > r.first;
+            });
+            for (auto it = ticks.begin() + maxSize; it != ticks.end(); ++it) {
+                mMap.erase(it->second);
+            }
+        }
+
+        mutable std::shared_mutex mMux;
+        // keys point to the strings owned by the nodes
+        std::unordered_map<StringView, std::unique_ptr<Node>, StringViewHash, StringViewEqual> mMap;
+        // only advanced with the writer lock held
+        uint64_t mTick = 0;
+    };
+
+    Shard& GetShard(StringView key) const {
+        if (mShards.size() == 1) {
+            return *mShards[0];
+        }
+        // the low bits are used by the map inside the shard
+        return *mShards[(static_cast<uint64_t>(StringViewHash()(key)) >> 32) % mShards.size()];
+    }
+
+    size_t mShardMaxSize = 0;
+    size_t mShardElasticity = 0;
+    std::vector<std::unique_ptr<Shard>> mShards;
+};
+
+} // namespace logtail
@@ -298,6 +298,102 @@ bool BoostRegexSearch(const char* buffer, const boost::regex& reg, string& excep
     }
 }
 
+bool TranslateToRE2(const string& exp, string& res, bool forSearch) {
+    bool inClass = false;
+    bool hasNonAscii = false;
+    res.clear();
+    res.reserve(exp.size());
+    for (size_t i = 0; i < exp.size(); ++i) {
+        char c = exp[i];
+        if (static_cast<unsigned char>(c) >= 0x80) {
+            hasNonAscii = true;
+        }
+        if (c == '\\') {
+            if (i + 1 == exp.size()) {
+                return false;
+            }
+            char next = exp[i + 1];
+            ++i;
+            // \s in boost also matches \v
+            if (next == 's') {
+                res += inClass ? "\\t\\n\\v\\f\\r " : "[\\t\\n\\v\\f\\r ]";
+                continue;
+            }
+            if (next == 'S') {
+                if (inClass) {
+                    return false;
+                }
+                res += "[^\\t\\n\\v\\f\\r ]";
+                continue;
+            }
+            if (next == 'Q') {
+                return false;
+            }
+            res += c;
+            res += next;
+            continue;
+        }
+        if (inClass) {
+            if (c == ']') {
+                inClass = false;
+            } else if (c == '[' && i + 1 < exp.size() && exp[i + 1] == ':') {
+                auto end = exp.find(":]", i + 2);
+                if (end == string::npos) {
+                    return false;
+                }
+                res.append(exp, i, end + 2 - i);
+                i = end + 1;
+                continue;
+            }
+            res += c;
+            continue;
+        }
+        switch (c) {
+            case '[':
+                inClass = true;
+                res += c;
+                // a leading ^ negates the class, and a leading ] is a literal
+                if (i + 1 < exp.size() && exp[i + 1] == '^') {
+                    res += '^';
+                    ++i;
+                }
+                if (i + 1 < exp.size() && exp[i + 1] == ']') {
+                    res += ']';
+                    ++i;
+                }
+                continue;
+            case '^':
+                // Boost matches ^ and $ at line boundaries as well, which only makes no difference at both ends of a
+                // full match. A search may start or end at any line boundary of the text.
+                if (i != 0 || forSearch) {
+                    return false;
+                }
+                break;
+            case '$':
+                if (i + 1 != exp.size() || forSearch) {
+                    return false;
+                }
+                break;
+            case '{':
+                if (i + 1 < exp.size() && exp[i + 1] == ',') {
+                    return false;
+                }
+                break;
+            default:
+                break;
+        }
+        res += c;
+    }
+    if (inClass) {
+        return false;
+    }
+    // case folding of latin-1 letters in RE2 is not done by boost
+    if (hasNonAscii && exp.find("(?i") != string::npos) {
+        return false;
+    }
+    return true;
+}
+
 uint32_t GetLittelEndianValue32(const uint8_t* buffer) {
     return buffer[3] << 24 | buffer[2] << 16 | buffer[1] << 8 | buffer[0];
 }
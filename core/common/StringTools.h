@@ -140,6 +140,9 @@ bool BoostRegexMatch(const char* buffer, size_t size, const boost::regex& reg, s
 bool BoostRegexMatch(const char* buffer, const boost::regex& reg, std::string& exception);
 bool BoostRegexSearch(const char* buffer, size_t size, const boost::regex& reg, std::string& exception);
 bool BoostRegexSearch(const char* buffer, const boost::regex& reg, std::string& exception);
+// Rewrites @exp for RE2 so that it matches exactly what boost::regex with default perl syntax matches, or returns false
+// if that cannot be guaranteed. The result is for full match only, unless @forSearch is true.
+bool TranslateToRE2(const std::string& exp, std::string& res, bool forSearch = false);
 
 // GetLittelEndianValue32 converts @buffer in little endian to uint32_t.
 uint32_t GetLittelEndianValue32(const uint8_t* buffer);
@@ -22,6 +22,9 @@ using namespace std;
 
 namespace logtail {
 
+// input size of the stream being compressed in this thread, for metrics on failure
+static thread_local size_t sStreamInputSize = 0;
+
 void Compressor::SetMetricRecordRef(MetricLabels&& labels, DynamicMetricLabels&& dynamicLabels) {
     WriteMetrics::GetInstance()->CreateMetricsRecordRef(
         mMetricsRecordRef, MetricCategory::METRIC_CATEGORY_COMPONENT, std::move(labels), std::move(dynamicLabels));
@@ -57,4 +60,46 @@ bool Compressor::DoCompress(const string& input, string& output, string& errorMs
     return res;
 }
 
+bool Compressor::BeginStream(size_t inputSize, string& errorMsg) {
+    if (mMetricsRecordRef != nullptr) {
+        ADD_COUNTER(mInItemsTotal, 1);
+        ADD_COUNTER(mInItemSizeBytes, inputSize);
+    }
+    sStreamInputSize = inputSize;
+
+    auto before = chrono::system_clock::now();
+    auto res = StartStream(inputSize, errorMsg);
+    OnStreamStepDone(before, res);
+    return res;
+}
+
+bool Compressor::AppendToStream(StringView chunk, string& errorMsg) {
+    auto before = chrono::system_clock::now();
+    auto res = CompressChunk(chunk, errorMsg);
+    OnStreamStepDone(before, res);
+    return res;
+}
+
+bool Compressor::EndStream(string& output, string& errorMsg) {
+    auto before = chrono::system_clock::now();
+    auto res = FinishStream(output, errorMsg);
+    OnStreamStepDone(before, res);
+    if (res && mMetricsRecordRef != nullptr) {
+        ADD_COUNTER(mOutItemsTotal, 1);
+        ADD_COUNTER(mOutItemSizeBytes, output.size());
+    }
+    return res;
+}
+
+void Compressor::OnStreamStepDone(chrono::system_clock::time_point before, bool res) {
+    if (mMetricsRecordRef == nullptr) {
+        return;
+    }
+    ADD_COUNTER(mTotalProcessMs, chrono::system_clock::now() - before);
+    if (!res) {
+        ADD_COUNTER(mDiscardedItemsTotal, 1);
+        ADD_COUNTER(mDiscardedItemSizeBytes, sStreamInputSize);
+    }
+}
+
 } // namespace logtail
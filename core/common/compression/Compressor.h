@@ -16,8 +16,10 @@
 
 #pragma once
 
+#include <chrono>
 #include <string>
 
+#include "common/StringView.h"
 #include "common/compression/CompressType.h"
 #include "monitor/MetricManager.h"
 
@@ -30,6 +32,14 @@ public:
 
     bool DoCompress(const std::string& input, std::string& output, std::string& errorMsg);
 
+    // Streaming compression, for input produced in chunks, whose output is the same format as DoCompress on the whole
+    // input. The state of a stream is kept per thread, so a thread can only have one stream at a time, which must be
+    // begun with the total size of the input. Once any step fails, the stream is abandoned.
+    virtual bool IsStreamingSupported() const { return false; }
+    bool BeginStream(size_t inputSize, std::string& errorMsg);
+    bool AppendToStream(StringView chunk, std::string& errorMsg);
+    bool EndStream(std::string& output, std::string& errorMsg);
+
 #ifdef APSARA_UNIT_TEST_MAIN
     // buffer shoudl be reserved for output before calling this function
     virtual bool UnCompress(const std::string& input, std::string& output, std::string& errorMsg) = 0;
@@ -50,6 +60,14 @@ protected:
 
 private:
     virtual bool Compress(const std::string& input, std::string& output, std::string& errorMsg) = 0;
+    virtual bool StartStream(size_t inputSize, std::string& errorMsg) {
+        errorMsg = "streaming compression not supported";
+        return false;
+    }
+    virtual bool CompressChunk(StringView chunk, std::string& errorMsg) { return false; }
+    virtual bool FinishStream(std::string& output, std::string& errorMsg) { return false; }
+
+    void OnStreamStepDone(std::chrono::system_clock::time_point before, bool res);
 
     CompressType mType = CompressType::NONE;
 
@@ -22,25 +22,34 @@ using namespace std;
 
 namespace logtail {
 
+// buffers larger than this are released after use, so that a rare large input does not pin memory in every thread
+static constexpr size_t kMaxThreadLocalBufferSize = 4 * 1024 * 1024;
+
 bool LZ4Compressor::Compress(const string& input, string& output, string& errorMsg) {
     int encodingSize = LZ4_compressBound(input.size());
     if (encodingSize <= 0) {
         errorMsg = "input size is incorrect";
         return false;
     }
-    output.resize(static_cast<size_t>(encodingSize));
+    // compressed into a buffer reused by the thread and copied out, so that the output holds no more memory than the
+    // compressed data, instead of the compress bound
+    static thread_local string sBuffer;
+    sBuffer.resize(static_cast<size_t>(encodingSize));
     try {
-        encodingSize = static_cast<size_t>(
-            LZ4_compress_default(input.c_str(), const_cast<char*>(output.c_str()), input.size(), encodingSize));
+        encodingSize
+            = LZ4_compress_default(input.c_str(), const_cast<char*>(sBuffer.data()), input.size(), encodingSize);
         if (encodingSize <= 0) {
             errorMsg = "error code: " + ToString(encodingSize);
-            return false;
+        } else {
+            output.assign(sBuffer.data(), static_cast<size_t>(encodingSize));
         }
-        output.resize(static_cast<size_t>(encodingSize));
-        return true;
     } catch (...) {
+        encodingSize = 0;
     }
-    return false;
+    if (sBuffer.capacity() > kMaxThreadLocalBufferSize) {
+        string().swap(sBuffer);
+    }
+    return encodingSize > 0;
 }
 
 #ifdef APSARA_UNIT_TEST_MAIN
@@ -14,29 +14,136 @@
 
 #include "common/compression/ZstdCompressor.h"
 
+#include <algorithm>
+
 #include "zstd/zstd.h"
 
 using namespace std;
 
 namespace logtail {
 
+// buffers larger than this are released after use, so that a rare large input does not pin memory in every thread
+static constexpr size_t kMaxThreadLocalBufferSize = 4 * 1024 * 1024;
+// the output buffer of a stream starts at this size and doubles when full, instead of taking the compress bound at once
+static constexpr size_t kStreamBufferInitSize = 128 * 1024;
+
+// The context and the output buffer are reused by all compressions in the same thread, which saves allocating a
+// context of several hundred KB and a buffer as large as the input for each compression. The result is copied out of
+// the buffer at the end, so that the output holds no more memory than the compressed data.
+struct ZstdThreadState {
+    ZstdThreadState() : mCtx(ZSTD_createCCtx()) {}
+    ~ZstdThreadState() { ZSTD_freeCCtx(mCtx); }
+
+    void ReleaseBufferIfTooLarge() {
+        if (mBuffer.capacity() > kMaxThreadLocalBufferSize) {
+            string().swap(mBuffer);
+        }
+    }
+
+    ZSTD_CCtx* mCtx = nullptr;
+    string mBuffer;
+    // size of the output of the current stream in the buffer
+    size_t mBufferPos = 0;
+};
+
+static ZstdThreadState& GetThreadState() {
+    static thread_local ZstdThreadState sState;
+    return sState;
+}
+
+static bool CompressStream(ZstdThreadState& state, StringView input, ZSTD_EndDirective mode, string& errorMsg) {
+    ZSTD_inBuffer in = {input.data(), input.size(), 0};
+    ZSTD_outBuffer out = {const_cast<char*>(state.mBuffer.data()), state.mBuffer.size(), state.mBufferPos};
+    while (true) {
+        size_t remaining = ZSTD_compressStream2(state.mCtx, &out, &in, mode);
+        if (ZSTD_isError(remaining)) {
+            errorMsg = ZSTD_getErrorName(remaining);
+            return false;
+        }
+        if (mode == ZSTD_e_end ? remaining == 0 : in.pos == in.size) {
+            break;
+        }
+        if (out.pos == out.size) {
+            state.mBuffer.resize(state.mBuffer.size() * 2);
+            out.dst = const_cast<char*>(state.mBuffer.data());
+            out.size = state.mBuffer.size();
+        }
+    }
+    state.mBufferPos = out.pos;
+    return true;
+}
+
 bool ZstdCompressor::Compress(const string& input, string& output, string& errorMsg) {
+    auto& state = GetThreadState();
+    if (state.mCtx == nullptr) {
+        errorMsg = "failed to create zstd context";
+        return false;
+    }
     size_t encodingSize = ZSTD_compressBound(input.size());
-    output.resize(encodingSize);
+    state.mBuffer.resize(encodingSize);
     try {
-        encodingSize = ZSTD_compress(
-            const_cast<char*>(output.c_str()), encodingSize, input.c_str(), input.size(), mCompressionLevel);
+        encodingSize = ZSTD_compressCCtx(state.mCtx,
+                                         const_cast<char*>(state.mBuffer.data()),
+                                         encodingSize,
+                                         input.c_str(),
+                                         input.size(),
+                                         mCompressionLevel);
         if (ZSTD_isError(encodingSize)) {
             errorMsg = ZSTD_getErrorName(encodingSize);
+            state.ReleaseBufferIfTooLarge();
             return false;
         }
-        output.resize(encodingSize);
+        output.assign(state.mBuffer.data(), encodingSize);
+        state.ReleaseBufferIfTooLarge();
         return true;
     } catch (...) {
     }
     return false;
 }
 
+bool ZstdCompressor::StartStream(size_t inputSize, string& errorMsg) {
+    auto& state = GetThreadState();
+    if (state.mCtx == nullptr) {
+        errorMsg = "failed to create zstd context";
+        return false;
+    }
+    // any stream abandoned before in this thread is dropped as well
+    ZSTD_CCtx_reset(state.mCtx, ZSTD_reset_session_and_parameters);
+    size_t res = ZSTD_CCtx_setParameter(state.mCtx, ZSTD_c_compressionLevel, mCompressionLevel);
+    if (!ZSTD_isError(res)) {
+        // the frame header then records the content size, as ZSTD_compress does
+        res = ZSTD_CCtx_setPledgedSrcSize(state.mCtx, inputSize);
+    }
+    if (ZSTD_isError(res)) {
+        errorMsg = ZSTD_getErrorName(res);
+        return false;
+    }
+    // the capacity left by former compressions in this thread is used without allocating
+    state.mBuffer.resize(min(ZSTD_compressBound(inputSize), max(state.mBuffer.capacity(), kStreamBufferInitSize)));
+    state.mBufferPos = 0;
+    return true;
+}
+
+bool ZstdCompressor::CompressChunk(StringView chunk, string& errorMsg) {
+    auto& state = GetThreadState();
+    if (!CompressStream(state, chunk, ZSTD_e_continue, errorMsg)) {
+        state.ReleaseBufferIfTooLarge();
+        return false;
+    }
+    return true;
+}
+
+bool ZstdCompressor::FinishStream(string& output, string& errorMsg) {
+    auto& state = GetThreadState();
+    // fails if the size of all chunks differs from the size the stream was begun with
+    bool res = CompressStream(state, StringView(), ZSTD_e_end, errorMsg);
+    if (res) {
+        output.assign(state.mBuffer.data(), state.mBufferPos);
+    }
+    state.ReleaseBufferIfTooLarge();
+    return res;
+}
+
 #ifdef APSARA_UNIT_TEST_MAIN
 bool ZstdCompressor::UnCompress(const string& input, string& output, string& errorMsg) {
     try {
@@ -24,12 +24,17 @@ class ZstdCompressor : public Compressor {
 public:
     explicit ZstdCompressor(CompressType type, int32_t level = 1) : Compressor(type), mCompressionLevel(level) {}
 
+    bool IsStreamingSupported() const override { return true; }
+
 #ifdef APSARA_UNIT_TEST_MAIN
     bool UnCompress(const std::string& input, std::string& output, std::string& errorMsg) override;
 #endif
 
 private:
     bool Compress(const std::string& input, std::string& output, std::string& errorMsg) override;
+    bool StartStream(size_t inputSize, std::string& errorMsg) override;
+    bool CompressChunk(StringView chunk, std::string& errorMsg) override;
+    bool FinishStream(std::string& output, std::string& errorMsg) override;
 
     int32_t mCompressionLevel = 1;
 };
@@ -0,0 +1,170 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/memory/ChunkPool.h"
+
+#include "common/Flags.h"
+#include "monitor/MetricManager.h"
+#include "monitor/metric_constants/MetricConstants.h"
+
+DEFINE_FLAG_BOOL(enable_source_buffer_chunk_pool, "recycle source buffer chunks in per thread pools", true);
+DEFINE_FLAG_INT64(source_buffer_chunk_pool_max_bytes_per_thread,
+                  "max bytes of free chunks retained by each thread",
+                  1024 * 1024);
+DEFINE_FLAG_INT64(source_buffer_chunk_pool_max_bytes,
+                  "max bytes of free chunks retained by all threads",
+                  16 * 1024 * 1024);
+
+using namespace std;
+
+namespace logtail {
+
+namespace {
+
+struct ChunkPoolMetrics {
+    ChunkPoolMetrics() {
+        WriteMetrics::GetInstance()->CreateMetricsRecordRef(
+            mMetricsRecordRef,
+            MetricCategory::METRIC_CATEGORY_RUNNER,
+            {{METRIC_LABEL_KEY_RUNNER_NAME, METRIC_LABEL_VALUE_RUNNER_NAME_CHUNK_POOL}});
+        mHitTotal = mMetricsRecordRef.CreateCounter(METRIC_RUNNER_CHUNK_POOL_HIT_TOTAL);
+        mMissTotal = mMetricsRecordRef.CreateCounter(METRIC_RUNNER_CHUNK_POOL_MISS_TOTAL);
+        mRetainedSizeBytes = mMetricsRecordRef.CreateIntGauge(METRIC_RUNNER_CHUNK_POOL_RETAINED_SIZE_BYTES);
+        WriteMetrics::GetInstance()->CommitMetricsRecordRef(mMetricsRecordRef);
+    }
+
+    MetricsRecordRef mMetricsRecordRef;
+    CounterPtr mHitTotal;
+    CounterPtr mMissTotal;
+    IntGaugePtr mRetainedSizeBytes;
+};
+
+ChunkPoolMetrics& GetChunkPoolMetrics() {
+    static ChunkPoolMetrics sMetrics;
+    return sMetrics;
+}
+
+// free chunks retained by all pools, which may be more than the limit by a few chunks when threads race
+atomic_size_t sTotalRetainedBytes{0};
+
+} // namespace
+
+ChunkPool::ChunkPool() {
+    auto& metrics = GetChunkPoolMetrics();
+    mHitTotal = metrics.mHitTotal;
+    mMissTotal = metrics.mMissTotal;
+    mRetainedSizeBytes = metrics.mRetainedSizeBytes;
+}
+
+ChunkPool::~ChunkPool() {
+    DestroyAllChunks();
+}
+
+const shared_ptr<ChunkPool>& ChunkPool::GetThreadPool() {
+    static const shared_ptr<ChunkPool> sDisabled;
+    if (!BOOL_FLAG(enable_source_buffer_chunk_pool)) {
+        return sDisabled;
+    }
+    // allocators hold the pool, so it outlives the thread if any chunk is still in use elsewhere
+    static thread_local shared_ptr<ChunkPool> sPool = make_shared<ChunkPool>();
+    return sPool;
+}
+
+uint8_t* ChunkPool::Acquire(uint32_t size) {
+    size_t idx = GetSizeClass(size);
+    {
+        lock_guard<mutex> lock(mPoolMux);
+        auto& pool = mPool[idx];
+        if (pool.empty()) {
+            lock_guard<mutex> lk(mPoolBakMux);
+            pool.swap(mPoolBak[idx]);
+        }
+        if (!pool.empty()) {
+            uint8_t* chunk = pool.back();
+            pool.pop_back();
+            mRetainedBytes.fetch_sub(size, memory_order_relaxed);
+            sTotalRetainedBytes.fetch_sub(size, memory_order_relaxed);
+            SUB_GAUGE(mRetainedSizeBytes, size);
+            ADD_COUNTER(mHitTotal, 1);
+            return chunk;
+        }
+    }
+    ADD_COUNTER(mMissTotal, 1);
+    return new uint8_t[size];
+}
+
+void ChunkPool::Release(uint8_t* chunk, uint32_t size) {
+    if (mRetainedBytes.load(memory_order_relaxed) + size
+            > static_cast<size_t>(INT64_FLAG(source_buffer_chunk_pool_max_bytes_per_thread))
+        || sTotalRetainedBytes.load(memory_order_relaxed) + size
+            > static_cast<size_t>(INT64_FLAG(source_buffer_chunk_pool_max_bytes))) {
+        delete[] chunk;
+        return;
+    }
+    {
+        lock_guard<mutex> lock(mPoolBakMux);
+        mPoolBak[GetSizeClass(size)].push_back(chunk);
+    }
+    mRetainedBytes.fetch_add(size, memory_order_relaxed);
+    sTotalRetainedBytes.fetch_add(size, memory_order_relaxed);
+    ADD_GAUGE(mRetainedSizeBytes, size);
+}
+
+size_t ChunkPool::GetSizeClass(uint32_t size) {
+    // size is a power of 2 in [kMinChunkSize, kMaxChunkSize]
+    size_t idx = 0;
+    for (uint32_t s = kMinChunkSize; s < size; s <<= 1) {
+        ++idx;
+    }
+    return idx;
+}
+
+void ChunkPool::DestroyAllChunks() {
+    size_t bytes = 0;
+    {
+        lock_guard<mutex> lock(mPoolMux);
+        for (size_t i = 0; i < kSizeClassCnt; ++i) {
+            for (auto& chunk : mPool[i]) {
+                delete[] chunk;
+                bytes += kMinChunkSize << i;
+            }
+            mPool[i].clear();
+        }
+    }
+    {
+        lock_guard<mutex> lock(mPoolBakMux);
+        for (size_t i = 0; i < kSizeClassCnt; ++i) {
+            for (auto& chunk : mPoolBak[i]) {
+                delete[] chunk;
+                bytes += kMinChunkSize << i;
+            }
+            mPoolBak[i].clear();
+        }
+    }
+    mRetainedBytes.fetch_sub(bytes, memory_order_relaxed);
+    sTotalRetainedBytes.fetch_sub(bytes, memory_order_relaxed);
+    SUB_GAUGE(mRetainedSizeBytes, bytes);
+}
+
+size_t ChunkPool::GetTotalRetainedBytes() {
+    return sTotalRetainedBytes.load(memory_order_relaxed);
+}
+
+#ifdef APSARA_UNIT_TEST_MAIN
+void ChunkPool::Clear() {
+    DestroyAllChunks();
+}
+#endif
+
+} // namespace logtail
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "monitor/metric_models/MetricTypes.h"
+
+namespace logtail {
+
+// Recycles the memory chunks of BufferAllocator, so that creating and destroying event groups at high rate does not
+// hit malloc and free each time. Chunks are pooled by size class, i.e. powers of 2 from kMinChunkSize to
+// kMaxChunkSize. Each thread has its own pool, and a chunk always goes back to the pool of the thread that created the
+// allocator, even if the allocator is destroyed in another thread, e.g. after the event group has been flushed.
+// Free chunks retained are bounded both per thread and over all threads, and are reported by the retained_size_bytes
+// gauge of the source_buffer_chunk_pool runner, so that the extra memory stays small with many threads.
+class ChunkPool {
+public:
+    static constexpr uint32_t kMinChunkSize = 4096;
+    static constexpr uint32_t kMaxChunkSize = 1024 * 128;
+    static constexpr size_t kSizeClassCnt = 6;
+
+    ChunkPool();
+    ~ChunkPool();
+    ChunkPool(const ChunkPool&) = delete;
+    ChunkPool& operator=(const ChunkPool&) = delete;
+
+    // returns nullptr if chunk pool is disabled
+    static const std::shared_ptr<ChunkPool>& GetThreadPool();
+    static bool IsPooledSize(uint32_t size) {
+        return size >= kMinChunkSize && size <= kMaxChunkSize && (size & (size - 1)) == 0;
+    }
+
+    // size must be a pooled size
+    uint8_t* Acquire(uint32_t size);
+    // can be called from any thread
+    void Release(uint8_t* chunk, uint32_t size);
+
+    size_t GetRetainedBytes() const { return mRetainedBytes.load(std::memory_order_relaxed); }
+    // of all pools
+    static size_t GetTotalRetainedBytes();
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    void Clear();
+#endif
+
+private:
+    static size_t GetSizeClass(uint32_t size);
+
+    void DestroyAllChunks();
+
+    std::mutex mPoolMux;
+    std::vector<uint8_t*> mPool[kSizeClassCnt];
+
+    // chunks released, transferred to mPool when it is empty
+    std::mutex mPoolBakMux;
+    std::vector<uint8_t*> mPoolBak[kSizeClassCnt];
+
+    std::atomic_size_t mRetainedBytes = 0;
+
+    // shared by all pools, held here so that chunks released during static destruction are still safe to count
+    CounterPtr mHitTotal;
+    CounterPtr mMissTotal;
+    IntGaugePtr mRetainedSizeBytes;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class SourceBufferUnittest;
+#endif
+};
+
+} // namespace logtail
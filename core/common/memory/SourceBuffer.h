@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "common/StringView.h"
+#include "common/memory/ChunkPool.h"
 
 namespace logtail {
 
@@ -49,9 +50,11 @@ private:
 
 public:
     explicit BufferAllocator(uint32_t firstChunkSize = 4096, uint32_t chunkSizeLimit = 1024 * 128)
-        : mFirstChunkSize(firstChunkSize), mChunkSizeLimit(chunkSizeLimit), mChunkSize(firstChunkSize) {
-        mAllocPtr = new uint8_t[mChunkSize];
-        mAllocatedChunks.push_back(mAllocPtr);
+        : mFirstChunkSize(firstChunkSize),
+          mChunkSizeLimit(chunkSizeLimit),
+          mChunkSize(firstChunkSize),
+          mChunkPool(ChunkPool::GetThreadPool()) {
+        mAllocPtr = NewChunk(mChunkSize);
         mFreeBytesInChunk = mChunkSize;
         mAllocated = mChunkSize;
     }
@@ -64,15 +67,16 @@ public:
 
     ~BufferAllocator() {
         for (size_t i = 0; i < mAllocatedChunks.size(); i++) {
-            delete[] mAllocatedChunks[i];
+            FreeChunk(i);
         }
     }
 
     void Reset(void) {
         for (size_t i = 1; i < mAllocatedChunks.size(); i++) {
-            delete[] mAllocatedChunks[i];
+            FreeChunk(i);
         }
         mAllocatedChunks.resize(1);
+        mAllocatedChunkSizes.resize(1);
         mAllocPtr = mAllocatedChunks[0];
         mChunkSize = mFirstChunkSize;
         mFreeBytesInChunk = mChunkSize;
@@ -109,8 +113,7 @@ private:
              * will not be so large. Thus, it is wise to allocate it directly
              * from heap in order to avoid polluting chunk size.
              */
-            mem = new uint8_t[bytes];
-            mAllocatedChunks.push_back(mem);
+            mem = NewChunk(bytes);
             mAllocated += bytes;
         } else {
             /*
@@ -119,8 +122,7 @@ private:
             if (mChunkSize < mChunkSizeLimit) {
                 mChunkSize *= 2;
             }
-            mem = new uint8_t[mChunkSize];
-            mAllocatedChunks.push_back(mem);
+            mem = NewChunk(mChunkSize);
             mAllocPtr = mem + bytes;
             mFreeBytesInChunk = mChunkSize - bytes;
             mAllocated += mChunkSize;
@@ -130,12 +132,33 @@ private:
         return mem;
     }
 
+    uint8_t* NewChunk(uint32_t size) {
+        uint8_t* mem = nullptr;
+        if (mChunkPool && ChunkPool::IsPooledSize(size)) {
+            mem = mChunkPool->Acquire(size);
+        } else {
+            mem = new uint8_t[size];
+        }
+        mAllocatedChunks.push_back(mem);
+        mAllocatedChunkSizes.push_back(size);
+        return mem;
+    }
+
+    void FreeChunk(size_t idx) {
+        if (mChunkPool && ChunkPool::IsPooledSize(mAllocatedChunkSizes[idx])) {
+            mChunkPool->Release(mAllocatedChunks[idx], mAllocatedChunkSizes[idx]);
+        } else {
+            delete[] mAllocatedChunks[idx];
+        }
+    }
+
 private:
     uint32_t mFirstChunkSize = 4096;
     uint32_t mChunkSizeLimit = 1024 * 128;
 
     // The allocated memory chunks
     std::vector<uint8_t*> mAllocatedChunks;
+    std::vector<uint32_t> mAllocatedChunkSizes;
     // Statistics data
     uint64_t mAllocated = 0;
     uint64_t mUsed = 0;
@@ -146,6 +169,8 @@ private:
     uint32_t mFreeBytesInChunk = 0;
     // Current chunk size
     uint32_t mChunkSize = 0;
+    // The pool of the thread creating the allocator, where chunks come from and go back to. Null if disabled.
+    std::shared_ptr<ChunkPool> mChunkPool;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class SourceBufferUnittest;
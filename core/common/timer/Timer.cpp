@@ -18,14 +18,27 @@
 
 #include "MetricTypes.h"
 #include "application/Application.h"
+#include "common/Flags.h"
 #include "logger/Logger.h"
 #include "monitor/MetricManager.h"
 #include "monitor/metric_constants/MetricConstants.h"
 
+// hierarchical timing wheel makes pushing an event O(1) and expires due events in batches, which matters when there
+// are tens of thousands of periodic events, e.g. prometheus scrape targets
+DEFINE_FLAG_BOOL(enable_timer_wheel, "", false);
+DEFINE_FLAG_INT32(timer_wheel_tick_ms, "", 1);
+// only takes effect in wheel mode, events must be safe to be executed concurrently if more than 1
+DEFINE_FLAG_INT32(timer_dispatch_thread_count, "", 1);
+
 using namespace std;
 
 namespace logtail {
 
+Timer::Timer()
+    : mUseWheel(BOOL_FLAG(enable_timer_wheel)),
+      mWheel(chrono::steady_clock::now(), chrono::milliseconds(INT32_FLAG(timer_wheel_tick_ms))) {
+}
+
 Timer::~Timer() {
     Stop();
 }
@@ -37,7 +50,17 @@ void Timer::Init() {
         }
     }
     InitMetrics();
-    mThreadRes = async(launch::async, &Timer::Run, this);
+    if (mUseWheel) {
+        // dispatch threads must be ready before the ticker starts handing out events
+        if (INT32_FLAG(timer_dispatch_thread_count) > 1) {
+            for (int32_t i = 0; i < INT32_FLAG(timer_dispatch_thread_count); ++i) {
+                mDispatchThreadRes.emplace_back(async(launch::async, &Timer::RunDispatch, this));
+            }
+        }
+        mThreadRes = async(launch::async, &Timer::RunWheel, this);
+    } else {
+        mThreadRes = async(launch::async, &Timer::Run, this);
+    }
 }
 
 void Timer::Stop() {
@@ -47,6 +70,12 @@ void Timer::Stop() {
         }
     }
     mCV.notify_one();
+    for (auto& res : mDispatchThreadRes) {
+        if (res.valid() && res.wait_for(chrono::seconds(1)) != future_status::ready) {
+            LOG_WARNING(sLogger, ("timer dispatch thread", "forced to stopped"));
+        }
+    }
+    mDispatchThreadRes.clear();
     if (!mThreadRes.valid()) {
         return;
     }
@@ -60,6 +89,17 @@ void Timer::Stop() {
 
 void Timer::PushEvent(unique_ptr<TimerEvent>&& e) {
     lock_guard<mutex> lock(mQueueMux);
+    if (mUseWheel) {
+        auto nextExpireTime = mWheel.NextExpireTime();
+        bool earliest = !nextExpireTime.has_value() || e->GetExecTime() < *nextExpireTime;
+        mWheel.Add(std::move(e));
+        if (earliest) {
+            mCV.notify_one();
+        }
+        ADD_COUNTER(mInItemsTotal, 1);
+        SET_GAUGE(mQueueItemsTotal, mWheel.Size());
+        return;
+    }
     if (mQueue.empty() || e->GetExecTime() < mQueue.top()->GetExecTime()) {
         mQueue.push(std::move(e));
         mCV.notify_one();
@@ -108,6 +148,65 @@ void Timer::Run() {
     }
 }
 
+void Timer::RunWheel() {
+    LOG_INFO(sLogger, ("timer", "started")("mode", "timing wheel"));
+    vector<unique_ptr<TimerEvent>> expired;
+    while (mIsThreadRunning.load()) {
+        {
+            unique_lock<mutex> queueLock(mQueueMux);
+            auto nextExpireTime = mWheel.NextExpireTime();
+            if (!nextExpireTime.has_value()) {
+                mCV.wait(queueLock, [this]() { return !mIsThreadRunning.load() || !mWheel.Empty(); });
+            } else if (chrono::steady_clock::now() < *nextExpireTime) {
+                mCV.wait_until(queueLock, *nextExpireTime);
+            }
+            mWheel.Advance(chrono::steady_clock::now(), expired);
+            SET_GAUGE(mQueueItemsTotal, mWheel.Size());
+        }
+        if (!expired.empty()) {
+            DispatchEvents(expired);
+            expired.clear();
+        }
+    }
+}
+
+void Timer::RunDispatch() {
+    while (mIsThreadRunning.load()) {
+        unique_ptr<TimerEvent> e;
+        if (mDispatchQueue.WaitAndPop(e, 100)) {
+            ExecuteEvent(std::move(e));
+        }
+    }
+}
+
+void Timer::DispatchEvents(vector<unique_ptr<TimerEvent>>& events) {
+    auto now = chrono::steady_clock::now();
+    chrono::steady_clock::duration maxLag(0);
+    for (const auto& e : events) {
+        auto lag = now - e->GetExecTime();
+        ADD_COUNTER(mLatencyTimeMs, chrono::duration_cast<chrono::nanoseconds>(lag));
+        maxLag = max(maxLag, lag);
+    }
+    SET_GAUGE(mDispatchLagMs, chrono::duration_cast<chrono::milliseconds>(maxLag).count());
+
+    for (auto& e : events) {
+        if (mDispatchThreadRes.empty()) {
+            ExecuteEvent(std::move(e));
+        } else {
+            mDispatchQueue.Push(std::move(e));
+        }
+    }
+}
+
+void Timer::ExecuteEvent(unique_ptr<TimerEvent>&& e) {
+    if (!e->IsValid()) {
+        LOG_INFO(sLogger, ("invalid timer event", "task is cancelled"));
+        return;
+    }
+    e->Execute();
+    ADD_COUNTER(mOutItemsTotal, 1);
+}
+
 void Timer::InitMetrics() {
     MetricLabels labels;
     labels.emplace_back(METRIC_LABEL_KEY_RUNNER_NAME, "timer");
@@ -118,6 +217,7 @@ void Timer::InitMetrics() {
     mOutItemsTotal = mMetricsRecordRef.CreateCounter(METRIC_RUNNER_TIMER_OUT_ITEMS_TOTAL);
     mQueueItemsTotal = mMetricsRecordRef.CreateIntGauge(METRIC_RUNNER_TIMER_QUEUE_ITEMS_TOTAL);
     mLatencyTimeMs = mMetricsRecordRef.CreateTimeCounter(METRIC_RUNNER_TIMER_LATENCY_TIME_MS);
+    mDispatchLagMs = mMetricsRecordRef.CreateIntGauge(METRIC_RUNNER_TIMER_DISPATCH_LAG_MS);
 
     WriteMetrics::GetInstance()->CommitMetricsRecordRef(mMetricsRecordRef);
 }
@@ -128,6 +228,8 @@ void Timer::Clear() {
     while (!mQueue.empty()) {
         mQueue.pop();
     }
+    mWheel.Clear();
+    mDispatchQueue.Clear();
 }
 #endif
 
@@ -22,8 +22,11 @@
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <vector>
 
+#include "common/SafeQueue.h"
 #include "common/timer/TimerEvent.h"
+#include "common/timer/TimerWheel.h"
 #include "monitor/metric_models/MetricRecord.h"
 
 namespace logtail {
@@ -54,26 +57,40 @@ public:
 #endif
 
 private:
-    Timer() = default;
+    Timer();
     void Run();
+    void RunWheel();
+    void RunDispatch();
+    void DispatchEvents(std::vector<std::unique_ptr<TimerEvent>>& events);
+    void ExecuteEvent(std::unique_ptr<TimerEvent>&& e);
+
+    // chosen on construction, since events already pushed cannot be moved between the two
+    const bool mUseWheel;
 
     mutable std::mutex mQueueMux;
     std::priority_queue<std::unique_ptr<TimerEvent>, std::vector<std::unique_ptr<TimerEvent>>, TimerEventCompare>
         mQueue;
+    TimerWheel mWheel;
 
     std::future<void> mThreadRes;
     std::atomic_bool mIsThreadRunning = false;
     mutable std::condition_variable mCV;
 
+    // expired events are executed by these threads when there are more than one dispatch threads in wheel mode
+    SafeQueue<std::unique_ptr<TimerEvent>> mDispatchQueue;
+    std::vector<std::future<void>> mDispatchThreadRes;
+
     // Metrics
     MetricsRecordRef mMetricsRecordRef;
     CounterPtr mInItemsTotal;
     CounterPtr mOutItemsTotal;
     IntGaugePtr mQueueItemsTotal;
     TimeCounterPtr mLatencyTimeMs;
+    IntGaugePtr mDispatchLagMs;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class TimerUnittest;
+    friend class TimerBenchmark;
     friend class ScrapeSchedulerUnittest;
     friend class HostMonitorInputRunnerUnittest;
 #endif
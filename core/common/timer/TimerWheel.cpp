@@ -0,0 +1,159 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/timer/TimerWheel.h"
+
+using namespace std;
+
+namespace logtail {
+
+TimerWheel::TimerWheel(chrono::steady_clock::time_point startTime, chrono::steady_clock::duration tick)
+    : mStartTime(startTime), mTick(tick.count() > 0 ? tick : chrono::milliseconds(1)) {
+}
+
+void TimerWheel::Add(unique_ptr<TimerEvent>&& e) {
+    Place(std::move(e));
+    ++mSize;
+}
+
+void TimerWheel::Advance(chrono::steady_clock::time_point now, vector<unique_ptr<TimerEvent>>& expired) {
+    if (now < mStartTime) {
+        return;
+    }
+    uint64_t nowTick = (now - mStartTime) / mTick;
+    while (mCurrentTick < nowTick) {
+        // nothing can expire before the next cascade of the lowest non-empty level, so jump to the tick just before it
+        uint32_t lowest = 0;
+        while (lowest <= kLevelCnt && mLevelSizes[lowest] == 0) {
+            ++lowest;
+        }
+        if (lowest > kLevelCnt) {
+            mCurrentTick = nowTick;
+            break;
+        }
+        if (lowest > 0) {
+            uint32_t shift = kSlotBits * lowest;
+            uint64_t nextCascadeTick = ((mCurrentTick >> shift) + 1) << shift;
+            if (nextCascadeTick > nowTick) {
+                mCurrentTick = nowTick;
+                break;
+            }
+            mCurrentTick = nextCascadeTick - 1;
+        }
+
+        ++mCurrentTick;
+        // cascade from the top level, so that events moved down can be cascaded further in the same tick
+        if ((mCurrentTick & ((uint64_t(1) << (kSlotBits * kLevelCnt)) - 1)) == 0) {
+            Cascade(kLevelCnt, mOverflow);
+        }
+        for (uint32_t level = kLevelCnt - 1; level > 0; --level) {
+            if ((mCurrentTick & ((uint64_t(1) << (kSlotBits * level)) - 1)) == 0) {
+                Cascade(level, mLevels[level][(mCurrentTick >> (kSlotBits * level)) & (kSlotCnt - 1)]);
+            }
+        }
+        auto& slot = mLevels[0][mCurrentTick & (kSlotCnt - 1)];
+        for (auto& e : slot) {
+            expired.emplace_back(std::move(e));
+        }
+        mLevelSizes[0] -= slot.size();
+        mSize -= slot.size();
+        slot.clear();
+    }
+    for (auto& e : mReady) {
+        expired.emplace_back(std::move(e));
+    }
+    mSize -= mReady.size();
+    mReady.clear();
+}
+
+optional<chrono::steady_clock::time_point> TimerWheel::NextExpireTime() const {
+    if (mSize == 0) {
+        return nullopt;
+    }
+    if (!mReady.empty()) {
+        return GetTickTime(mCurrentTick);
+    }
+    // events at a lower level always expire before those at a higher level, and the slots at or before the current
+    // index of each level are always empty
+    for (uint32_t level = 0; level < kLevelCnt; ++level) {
+        uint32_t shift = kSlotBits * level;
+        uint64_t base = (mCurrentTick >> (shift + kSlotBits)) << (shift + kSlotBits);
+        for (uint64_t idx = ((mCurrentTick >> shift) & (kSlotCnt - 1)) + 1; idx < kSlotCnt; ++idx) {
+            if (!mLevels[level][idx].empty()) {
+                // for higher levels, this is when the slot is cascaded rather than when its events expire
+                return GetTickTime(base | (idx << shift));
+            }
+        }
+    }
+    uint32_t shift = kSlotBits * kLevelCnt;
+    return GetTickTime(((mCurrentTick >> shift) + 1) << shift);
+}
+
+void TimerWheel::Clear() {
+    for (auto& level : mLevels) {
+        for (auto& slot : level) {
+            slot.clear();
+        }
+    }
+    mOverflow.clear();
+    mReady.clear();
+    mLevelSizes.fill(0);
+    mSize = 0;
+}
+
+uint64_t TimerWheel::GetExpireTick(chrono::steady_clock::time_point execTime) const {
+    if (execTime <= mStartTime) {
+        return 0;
+    }
+    // round up, so that an event is never expired before its exec time
+    auto elapsed = execTime - mStartTime;
+    return (elapsed + mTick - chrono::steady_clock::duration(1)) / mTick;
+}
+
+chrono::steady_clock::time_point TimerWheel::GetTickTime(uint64_t tick) const {
+    return mStartTime + mTick * tick;
+}
+
+void TimerWheel::Place(unique_ptr<TimerEvent>&& e) {
+    uint64_t expireTick = GetExpireTick(e->GetExecTime());
+    if (expireTick <= mCurrentTick) {
+        mReady.emplace_back(std::move(e));
+        return;
+    }
+    // the level is the lowest one whose slot span covers both the current tick and the expire tick
+    for (uint32_t level = 0; level < kLevelCnt; ++level) {
+        uint32_t shift = kSlotBits * (level + 1);
+        if ((expireTick >> shift) == (mCurrentTick >> shift)) {
+            mLevels[level][(expireTick >> (kSlotBits * level)) & (kSlotCnt - 1)].emplace_back(std::move(e));
+            ++mLevelSizes[level];
+            return;
+        }
+    }
+    mOverflow.emplace_back(std::move(e));
+    ++mLevelSizes[kLevelCnt];
+}
+
+void TimerWheel::Cascade(uint32_t level, Slot& slot) {
+    if (slot.empty()) {
+        return;
+    }
+    mLevelSizes[level] -= slot.size();
+    Slot events;
+    events.swap(slot);
+    for (auto& e : events) {
+        Place(std::move(e));
+    }
+}
+
+} // namespace logtail
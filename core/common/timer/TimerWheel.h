@@ -0,0 +1,82 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "common/timer/TimerEvent.h"
+
+namespace logtail {
+
+// Hierarchical timing wheel. Adding an event is O(1), and expired events are collected in batches by Advance.
+// Each level has 64 slots, and one slot of a level spans all slots of the level below it, so with 1ms tick the levels
+// cover 64ms, 4s, 4min and 4.6h respectively. Events further away are kept in an overflow list and re-placed once the
+// top level wraps around. Events are expired at tick granularity, i.e. no earlier than their exec time and no later
+// than one tick after it.
+// Not thread-safe, should be protected by the owner.
+class TimerWheel {
+public:
+    static constexpr uint32_t kSlotBits = 6;
+    static constexpr uint32_t kSlotCnt = 1 << kSlotBits;
+    static constexpr uint32_t kLevelCnt = 4;
+
+    TimerWheel(std::chrono::steady_clock::time_point startTime, std::chrono::steady_clock::duration tick);
+
+    void Add(std::unique_ptr<TimerEvent>&& e);
+    // move all events whose exec time is no later than @now to @expired
+    void Advance(std::chrono::steady_clock::time_point now, std::vector<std::unique_ptr<TimerEvent>>& expired);
+    // the earliest time at which Advance may return any event, or nullopt if the wheel is empty
+    std::optional<std::chrono::steady_clock::time_point> NextExpireTime() const;
+
+    size_t Size() const { return mSize; }
+    bool Empty() const { return mSize == 0; }
+    void Clear();
+
+private:
+    using Slot = std::vector<std::unique_ptr<TimerEvent>>;
+
+    uint64_t GetExpireTick(std::chrono::steady_clock::time_point execTime) const;
+    std::chrono::steady_clock::time_point GetTickTime(uint64_t tick) const;
+    void Place(std::unique_ptr<TimerEvent>&& e);
+    // level kLevelCnt stands for the overflow list
+    void Cascade(uint32_t level, Slot& slot);
+
+    std::chrono::steady_clock::time_point mStartTime;
+    std::chrono::steady_clock::duration mTick;
+    // all events expiring at or before this tick have been handed out
+    uint64_t mCurrentTick = 0;
+    size_t mSize = 0;
+
+    std::array<std::array<Slot, kSlotCnt>, kLevelCnt> mLevels;
+    Slot mOverflow;
+    // number of events in each level and in the overflow list, used to skip ticks with nothing to do
+    std::array<size_t, kLevelCnt + 1> mLevelSizes{};
+    // events already due when added
+    Slot mReady;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class TimerWheelUnittest;
+#endif
+};
+
+} // namespace logtail
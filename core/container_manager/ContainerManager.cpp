@@ -273,9 +273,10 @@ void ContainerManager::sendMatchedContainerInfo(std::vector<std::shared_ptr<Matc
 
 bool ContainerManager::checkContainerDiffForOneConfig(FileDiscoveryOptions* options,
                                                       const CollectionPipelineContext* ctx) {
-    // If this config's container update time is newer than or equal to global update time,
-    // return the cached result if it exists
-    if (options->GetLastContainerUpdateTime() > mLastUpdateTime) {
+    std::lock_guard<std::mutex> lock(mContainerMapMutex);
+    uint64_t configVersion = options->GetContainerVersion();
+    // no container has changed since the last check of this config
+    if (configVersion == mContainerVersion) {
         return false;
     }
 
@@ -286,25 +287,43 @@ bool ContainerManager::checkContainerDiffForOneConfig(FileDiscoveryOptions* opti
             containerInfoMap[info.mRawContainerInfo->mID] = info.mRawContainerInfo;
         }
     }
-    std::vector<std::string> removedList;
-    std::vector<std::string> matchAddedList;
+    const auto& discoveryOptions = options->GetContainerDiscoveryOptions();
     ContainerDiff diff;
-    computeMatchedContainersDiff(*(options->GetFullContainerList()),
-                                 containerInfoMap,
-                                 options->GetContainerDiscoveryOptions().mContainerFilters,
-                                 options->GetContainerDiscoveryOptions().mIsStdio,
-                                 diff);
-
-    LOG_DEBUG(
-        sLogger,
-        ("diff", diff.ToString())("configName", ctx->GetConfigName())(
-            "containerFilters", options->GetContainerDiscoveryOptions().mContainerFilters.ToString())(
-            "fullContainerList", options->GetFullContainerList()->size())("containerInfos", containerInfos->size())(
-            "lastConfigContainerUpdateTime", options->GetLastContainerUpdateTime())("mLastUpdateTime",
-                                                                                    mLastUpdateTime));
-
-    // Update the config's container update time when there are changes
+    bool isIncremental = configVersion != 0 && configVersion >= mContainerChangeBaseVersion;
+    std::set<std::string> changedContainerIDs;
+    if (isIncremental) {
+        auto it = std::upper_bound(
+            mContainerChanges.begin(),
+            mContainerChanges.end(),
+            configVersion,
+            [](uint64_t version, const std::pair<uint64_t, std::string>& change) { return version < change.first; });
+        for (; it != mContainerChanges.end(); ++it) {
+            changedContainerIDs.insert(it->second);
+        }
+        computeChangedContainersDiff(*(options->GetFullContainerList()),
+                                     containerInfoMap,
+                                     discoveryOptions.mContainerFilters,
+                                     discoveryOptions.mIsStdio,
+                                     changedContainerIDs,
+                                     diff);
+    } else {
+        computeMatchedContainersDiff(*(options->GetFullContainerList()),
+                                     containerInfoMap,
+                                     discoveryOptions.mContainerFilters,
+                                     discoveryOptions.mIsStdio,
+                                     diff);
+    }
+
+    LOG_DEBUG(sLogger,
+              ("diff", diff.ToString())("configName", ctx->GetConfigName())(
+                  "containerFilters", discoveryOptions.mContainerFilters.ToString())(
+                  "fullContainerList", options->GetFullContainerList()->size())(
+                  "containerInfos", containerInfos->size())("incremental", isIncremental)(
+                  "changedContainers", changedContainerIDs.size())("configContainerVersion", configVersion)(
+                  "containerVersion", mContainerVersion));
+
     options->SetLastContainerUpdateTime(time(nullptr));
+    options->SetContainerVersion(mContainerVersion);
 
     if (diff.IsEmpty()) {
         return false;
@@ -331,7 +350,6 @@ void ContainerManager::incrementallyUpdateContainersSnapshot() {
     Json::Value deleteContainers = jsonParams["Delete"];
     Json::Value stopContainers = jsonParams["Stop"];
 
-    bool hasChanges = false;
     std::vector<std::string> updatedContainerIDs;
 
     for (const auto& container : updateContainers) {
@@ -340,9 +358,9 @@ void ContainerManager::incrementallyUpdateContainersSnapshot() {
             {
                 std::lock_guard<std::mutex> lock(mContainerMapMutex);
                 mContainerMap[containerInfo->mID] = containerInfo;
+                recordContainerChange(containerInfo->mID);
             }
             updatedContainerIDs.push_back(containerInfo->mID);
-            hasChanges = true;
         }
     }
 
@@ -351,7 +369,7 @@ void ContainerManager::incrementallyUpdateContainersSnapshot() {
         {
             std::lock_guard<std::mutex> lock(mContainerMapMutex);
             if (mContainerMap.erase(containerId) > 0) {
-                hasChanges = true;
+                recordContainerChange(containerId);
             }
         }
     }
@@ -361,14 +379,22 @@ void ContainerManager::incrementallyUpdateContainersSnapshot() {
             std::lock_guard<std::mutex> lock(mStoppedContainerIDsMutex);
             mStoppedContainerIDs.push_back(containerId);
         }
-        hasChanges = true;
     }
+}
 
-    if (hasChanges) {
-        mLastUpdateTime = time(nullptr);
+void ContainerManager::recordContainerChange(const std::string& containerID) {
+    mContainerChanges.emplace_back(++mContainerVersion, containerID);
+    if (mContainerChanges.size() > kMaxContainerChangeCnt) {
+        mContainerChangeBaseVersion = mContainerChanges.front().first;
+        mContainerChanges.pop_front();
     }
 }
 
+void ContainerManager::resetContainerChanges() {
+    mContainerChangeBaseVersion = ++mContainerVersion;
+    mContainerChanges.clear();
+}
+
 void ContainerManager::refreshAllContainersSnapshot() {
     std::string allContainersMeta = LogtailPlugin::GetInstance()->GetAllContainersMeta();
     // 如果 allContainersMeta 为空，则返回
@@ -398,8 +424,9 @@ void ContainerManager::refreshAllContainersSnapshot() {
     {
         std::lock_guard<std::mutex> lock(mContainerMapMutex);
         mContainerMap.swap(tmpContainerMap);
+        // all configs are checked against all containers hourly, as a safety net of the incremental check
+        resetContainerChanges();
     }
-    mLastUpdateTime = time(nullptr);
 
     // Update container info pointers in all configs to point to the new RawContainerInfo objects
     updateContainerInfoPointersInAllConfigs();
@@ -580,6 +607,37 @@ bool IsK8sFilterMatch(const K8sFilter& filter, const K8sInfo& k8sInfo) {
 }
 
 
+// Include fields are matched only if the container has any of their keys, so containers without such keys can be
+// rejected by a few lookups before any regex runs, which is the case for most containers on a node shared by many
+// configs.
+static bool HasAnyIncludeKey(const FieldFilter& includeFields,
+                             const std::unordered_map<std::string, std::string>& fields) {
+    if (includeFields.IsEmpty()) {
+        return true;
+    }
+    for (const auto& pair : includeFields.mFieldsMap) {
+        if (fields.find(pair.first) != fields.end()) {
+            return true;
+        }
+    }
+    for (const auto& pair : includeFields.mFieldsRegMap) {
+        if (fields.find(pair.first) != fields.end()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool IsContainerFiltersMatch(const ContainerFilters& filters, const RawContainerInfo& info) {
+    if (!HasAnyIncludeKey(filters.mContainerLabelFilter.mIncludeFields, info.mContainerLabels)
+        || !HasAnyIncludeKey(filters.mEnvFilter.mIncludeFields, info.mEnv)
+        || !HasAnyIncludeKey(filters.mK8SFilter.mK8sLabelFilter.mIncludeFields, info.mK8sInfo.mLabels)) {
+        return false;
+    }
+    return IsMapLabelsMatch(filters.mContainerLabelFilter, info.mContainerLabels)
+        && IsMapLabelsMatch(filters.mEnvFilter, info.mEnv) && IsK8sFilterMatch(filters.mK8SFilter, info.mK8sInfo);
+}
+
 void ContainerManager::computeMatchedContainersDiff(
     std::set<std::string>& fullContainerIDList,
     const std::unordered_map<std::string, std::shared_ptr<RawContainerInfo>>& matchList,
@@ -619,21 +677,43 @@ void ContainerManager::computeMatchedContainersDiff(
 
             fullContainerIDList.insert(pair.first); // 加入到 fullContainerIDList
 
-            bool isContainerLabelMatch = IsMapLabelsMatch(filters.mContainerLabelFilter, pair.second->mContainerLabels);
-            if (!isContainerLabelMatch) {
-                continue;
+            // 检查标签和环境匹配
+            if (IsContainerFiltersMatch(filters, *pair.second)) {
+                diff.mAdded.push_back(pair.second); // 添加到变换列表
             }
-            bool isEnvMatch = IsMapLabelsMatch(filters.mEnvFilter, pair.second->mEnv);
-            if (!isEnvMatch) {
-                continue;
+        }
+    }
+}
+
+void ContainerManager::computeChangedContainersDiff(
+    std::set<std::string>& fullContainerIDList,
+    const std::unordered_map<std::string, std::shared_ptr<RawContainerInfo>>& matchList,
+    const ContainerFilters& filters,
+    bool isStdio,
+    const std::set<std::string>& changedContainerIDs,
+    ContainerDiff& diff) {
+    // unchanged containers make no difference to the result of computeMatchedContainersDiff, so they are skipped
+    for (const auto& id : changedContainerIDs) {
+        auto it = mContainerMap.find(id);
+        if (it == mContainerMap.end()) {
+            // 移除已删除的容器
+            if (fullContainerIDList.erase(id) > 0 && matchList.find(id) != matchList.end()) {
+                diff.mRemoved.push_back(id);
             }
-            bool isK8sMatch = IsK8sFilterMatch(filters.mK8SFilter, pair.second->mK8sInfo);
-            if (!isK8sMatch) {
+            continue;
+        }
+        // 更新匹配的容器状态
+        if (auto matched = matchList.find(id); matched != matchList.end() && *matched->second != *it->second) {
+            diff.mModified.push_back(it->second);
+        }
+        // 添加新容器
+        if (fullContainerIDList.find(id) == fullContainerIDList.end()) {
+            if (!isStdio && it->second->mStatus != "running") {
                 continue;
             }
-            // 检查标签和环境匹配
-            if (isContainerLabelMatch && isEnvMatch && isK8sMatch) {
-                diff.mAdded.push_back(pair.second); // 添加到变换列表
+            fullContainerIDList.insert(id);
+            if (IsContainerFiltersMatch(filters, *it->second)) {
+                diff.mAdded.push_back(it->second);
             }
         }
     }
@@ -979,6 +1059,7 @@ void ContainerManager::loadContainerInfoFromDetailFormat(const Json::Value& root
         {
             std::lock_guard<std::mutex> lock(mContainerMapMutex);
             mContainerMap.swap(tmpContainerMap);
+            resetContainerChanges();
         }
 
         // Update config container diffs for each config
@@ -1020,6 +1101,7 @@ void ContainerManager::loadContainerInfoFromContainersFormat(const Json::Value&
         {
             std::lock_guard<std::mutex> lock(mContainerMapMutex);
             mContainerMap.swap(tmp);
+            resetContainerChanges();
         }
         // Apply containers to all existing configs
         auto nameConfigMap = FileServer::GetInstance()->GetAllFileDiscoveryConfigs();
@@ -16,7 +16,9 @@
 
 #pragma once
 
+#include <deque>
 #include <future>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -75,6 +77,17 @@ private:
                                  const ContainerFilters& filters,
                                  bool isStdio,
                                  ContainerDiff& diff);
+    // same as computeMatchedContainersDiff, but only containers in changedContainerIDs are checked
+    void
+    computeChangedContainersDiff(std::set<std::string>& fullContainerIDList,
+                                 const std::unordered_map<std::string, std::shared_ptr<RawContainerInfo>>& matchList,
+                                 const ContainerFilters& filters,
+                                 bool isStdio,
+                                 const std::set<std::string>& changedContainerIDs,
+                                 ContainerDiff& diff);
+    // the following should be called with mContainerMapMutex held
+    void recordContainerChange(const std::string& containerID);
+    void resetContainerChanges();
 
     void loadContainerInfoFromDetailFormat(const Json::Value& root, const std::string& configPath);
     void loadContainerInfoFromContainersFormat(const Json::Value& root, const std::string& configPath);
@@ -92,7 +105,14 @@ private:
     std::vector<std::string> mStoppedContainerIDs;
     std::mutex mStoppedContainerIDsMutex;
 
-    uint32_t mLastUpdateTime = 0;
+    // Every change of mContainerMap is logged with an increasing version, so that a config only needs to check the
+    // containers changed since its last check instead of all containers. Version 0 is left for configs never checked.
+    uint64_t mContainerVersion = 1;
+    // changes up to this version are not kept, and configs checked before it have to check all containers
+    uint64_t mContainerChangeBaseVersion = 1;
+    std::deque<std::pair<uint64_t, std::string>> mContainerChanges;
+    // older changes are dropped beyond this
+    static constexpr size_t kMaxContainerChangeCnt = 100000;
     std::future<void> mThreadRes;
 
     std::atomic<bool> mIsRunning{false};
@@ -164,7 +164,9 @@ NetworkObserverManager::NetworkObserverManager(const std::shared_ptr<ProcessCach
                                                moodycamel::BlockingConcurrentQueue<std::shared_ptr<CommonEvent>>& queue,
                                                EventPool* pool)
     : AbstractManager(processCacheManager, eBPFAdapter, queue, pool),
+      // records are aggregated by the single handler thread of EBPFServer for now, so one shard is enough
       mAppAggregator(
+          1,
           10240,
           [](std::unique_ptr<AppMetricData>& base, L7Record* other) {
               if (base == nullptr) {
@@ -28,6 +28,7 @@
 #include "ebpf/util/AggregateTree.h"
 #include "ebpf/util/Converger.h"
 #include "ebpf/util/FrequencyManager.h"
+#include "ebpf/util/ShardedAggregateTree.h"
 #include "ebpf/util/sampler/Sampler.h"
 
 namespace logtail::ebpf {
@@ -201,7 +202,8 @@ private:
     int mCidOffset = -1;
 
     // handler thread ...
-    SIZETAggTreeWithSourceBuffer<AppMetricData, L7Record*> mAppAggregator;
+    // every l7 record goes through it, so a flat table is used
+    SIZETShardedAggTreeWithSourceBuffer<AppMetricData, L7Record*> mAppAggregator;
     SIZETAggTreeWithSourceBuffer<NetMetricData, ConnStatsRecord*> mNetAggregator;
     SIZETAggTree<AppSpanGroup, std::shared_ptr<CommonEvent>> mSpanAggregator;
     SIZETAggTree<AppLogGroup, std::shared_ptr<CommonEvent>> mLogAggregator;
@@ -126,6 +126,26 @@ public:
         return true;
     }
 
+    // attach data aggregated elsewhere to the path of aggKeys, used to assemble the shards of ShardedAggTree
+    // the level1 node takes sourceBuffer when created, and no limit is applied since the shards have done it
+    template <class ContainerType>
+    void Insert(const ContainerType& aggKeys,
+                std::unique_ptr<Data>&& data,
+                const std::shared_ptr<SourceBuffer>& sourceBuffer,
+                size_t eventCount) {
+        auto p = mRootNode.get();
+        for (auto& val : aggKeys) {
+            auto& child = p->mChild[val];
+            if (!child) {
+                child = std::make_unique<AggNode<Data, KeyType>>(p->mSourceBuffer ? p->mSourceBuffer : sourceBuffer);
+                mNodeCount++;
+            }
+            p = child.get();
+        }
+        p->mData = std::move(data);
+        mEventCount += eventCount;
+    }
+
     std::vector<AggNode<Data, KeyType>*> GetNodesWithAggDepth(size_t i) {
         std::vector<AggNode<Data, KeyType>*> ans;
         GetNodes(1, mRootNode, i, ans);
@@ -0,0 +1,299 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common/Lock.h"
+#include "common/memory/SourceBuffer.h"
+#include "ebpf/util/AggregateTree.h"
+#include "logger/Logger.h"
+
+namespace logtail {
+
+// A variant of AggTree for hot paths and concurrent producers.
+// Data is kept in flat open addressing tables keyed by the whole key path, so aggregating a record costs one probe
+// instead of one hash map lookup per level, and no rehash happens after the first report since tables keep their
+// size. Records are distributed to shards by their first agg key, each guarded by its own spin lock, so several
+// threads can aggregate at the same time. As a level1 subtree always lives in one shard, GetAndReset assembles all
+// shards into an ordinary AggTree without merging any data, and consumers of AggTree need no change.
+// The node limit counts the nodes of that tree, i.e. every distinct prefix of the key paths, as AggTree does. Note
+// that the tree is built anew on each report, which costs about as much as aggregating into AggTree did, so the
+// gain is limited to records aggregated into existing paths between two reports.
+template <class Data, class Value, class KeyType, bool NeedSourceBuffer>
+class ShardedAggTree {
+public:
+    using TreeType = AggTree<Data, Value, KeyType, NeedSourceBuffer>;
+
+    ShardedAggTree(size_t shardCnt,
+                   size_t maxNodes,
+                   const std::function<void(std::unique_ptr<Data>&, const Value&)>& aggregateFunc,
+                   const std::function<std::unique_ptr<Data>(const Value& n,
+                                                             std::shared_ptr<SourceBuffer>& sourceBuffer)>& buildFunc)
+        : mMaxNodes(maxNodes), mAggregateFunc(aggregateFunc), mBuildFunc(buildFunc) {
+        shardCnt = std::max<size_t>(shardCnt, 1);
+        for (size_t i = 0; i < shardCnt; ++i) {
+            mShards.emplace_back(std::make_unique<Shard>());
+        }
+    }
+
+    // thread-safe, aggregateFunc and buildFunc may be called concurrently for data in different shards
+    template <class ContainerType>
+    bool Aggregate(const Value& d, const ContainerType& aggKeys) {
+        uint64_t hash = 0;
+        for (auto& val : aggKeys) {
+            hash = HashCombine(hash, val);
+        }
+        auto& shard = *mShards[GetShardIdx(aggKeys)];
+        ScopedSpinLock lock(shard.mLock);
+        auto entry = shard.Find(hash, aggKeys);
+        if (entry == nullptr) {
+            // a new path adds a tree node for each of its prefixes not seen before
+            size_t newNodeCnt = 0;
+            uint64_t prefixHash = 0;
+            for (auto& val : aggKeys) {
+                prefixHash = HashCombine(prefixHash, val);
+                if (shard.mNodeHashes.find(prefixHash) == shard.mNodeHashes.end()) {
+                    ++newNodeCnt;
+                }
+            }
+            if (mNodeCount.load(std::memory_order_relaxed) + newNodeCnt > mMaxNodes) {
+                // when we exceed the maximum limit, we will drop new metrics
+                LOG_ERROR(sLogger, ("maximum limit exceeded", mMaxNodes));
+                return false;
+            }
+            prefixHash = 0;
+            for (auto& val : aggKeys) {
+                prefixHash = HashCombine(prefixHash, val);
+                shard.mNodeHashes.insert(prefixHash);
+            }
+            entry = shard.Add(hash, aggKeys);
+            mNodeCount.fetch_add(newNodeCnt, std::memory_order_relaxed);
+            if (NeedSourceBuffer && aggKeys.begin() != aggKeys.end()) {
+                // all data under the same level1 key share the same sourcebuffer, as in AggTree
+                auto& sourceBuffer = shard.mSourceBuffers[*aggKeys.begin()];
+                if (!sourceBuffer) {
+                    sourceBuffer = std::make_shared<SourceBuffer>(kDefaultNodeSourceBufferSize);
+                }
+                entry->mSourceBuffer = sourceBuffer;
+            }
+        }
+        if (!entry->mData) {
+            // generate new node ...
+            entry->mData = mBuildFunc(d, entry->mSourceBuffer);
+        }
+        mAggregateFunc(entry->mData, d);
+        ++entry->mEventCount;
+        ++shard.mEventCount;
+        return true;
+    }
+
+    // take all data aggregated so far as one tree, while the shards are left empty for further aggregation
+    TreeType GetAndReset() {
+        TreeType res(mMaxNodes, mAggregateFunc, mBuildFunc);
+        std::vector<KeyType> keys;
+        for (auto& shard : mShards) {
+            std::vector<Entry> entries;
+            {
+                ScopedSpinLock lock(shard->mLock);
+                entries.swap(shard->mEntries);
+                shard->mEntries.reserve(entries.size());
+                std::fill(shard->mSlots.begin(), shard->mSlots.end(), Slot());
+                shard->mSourceBuffers.clear();
+                shard->mEventCount = 0;
+                mNodeCount.fetch_sub(shard->mNodeHashes.size(), std::memory_order_relaxed);
+                shard->mNodeHashes.clear();
+            }
+            for (auto& entry : entries) {
+                keys.assign(entry.KeysBegin(), entry.KeysEnd());
+                res.Insert(keys, std::move(entry.mData), entry.mSourceBuffer, entry.mEventCount);
+            }
+        }
+        return res;
+    }
+
+    void Reset() {
+        for (auto& shard : mShards) {
+            ScopedSpinLock lock(shard->mLock);
+            mNodeCount.fetch_sub(shard->mNodeHashes.size(), std::memory_order_relaxed);
+            shard->mNodeHashes.clear();
+            shard->mEntries.clear();
+            shard->mSlots.clear();
+            shard->mSourceBuffers.clear();
+            shard->mEventCount = 0;
+        }
+    }
+
+    [[nodiscard]] size_t NodeCount() const { return mNodeCount.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] size_t EventCount() const {
+        size_t cnt = 0;
+        for (auto& shard : mShards) {
+            ScopedSpinLock lock(shard->mLock);
+            cnt += shard->mEventCount;
+        }
+        return cnt;
+    }
+
+    [[nodiscard]] size_t ShardCount() const { return mShards.size(); }
+
+private:
+    // paths of most agg trees are short, and keeping them inline saves a cache miss per lookup
+    static constexpr size_t kInlineKeyCnt = 4;
+
+    struct Entry {
+        uint64_t mHash = 0;
+        size_t mKeyCnt = 0;
+        std::array<KeyType, kInlineKeyCnt> mInlineKeys{};
+        // only for paths longer than kInlineKeyCnt, holding the whole path
+        std::vector<KeyType> mKeys;
+        std::shared_ptr<SourceBuffer> mSourceBuffer;
+        std::unique_ptr<Data> mData;
+        size_t mEventCount = 0;
+
+        template <class ContainerType>
+        void SetKeys(const ContainerType& aggKeys) {
+            mKeyCnt = std::distance(aggKeys.begin(), aggKeys.end());
+            if (mKeyCnt <= kInlineKeyCnt) {
+                std::copy(aggKeys.begin(), aggKeys.end(), mInlineKeys.begin());
+            } else {
+                mKeys.assign(aggKeys.begin(), aggKeys.end());
+            }
+        }
+
+        const KeyType* KeysBegin() const { return mKeyCnt <= kInlineKeyCnt ? mInlineKeys.data() : mKeys.data(); }
+        const KeyType* KeysEnd() const { return KeysBegin() + mKeyCnt; }
+    };
+
+    struct Slot {
+        // high bits of the hash, so that most mismatches are found without visiting the entry
+        uint32_t mTag = 0;
+        // index of the entry plus 1, or 0 if empty
+        uint32_t mEntryIdx = 0;
+    };
+
+    // aligned to avoid false sharing between the locks of adjacent shards
+    struct alignas(64) Shard {
+        template <class ContainerType>
+        Entry* Find(uint64_t hash, const ContainerType& aggKeys) {
+            if (mSlots.empty()) {
+                return nullptr;
+            }
+            size_t keyCnt = std::distance(aggKeys.begin(), aggKeys.end());
+            auto tag = static_cast<uint32_t>(hash >> 32);
+            size_t mask = mSlots.size() - 1;
+            for (size_t i = hash & mask; mSlots[i].mEntryIdx != 0; i = (i + 1) & mask) {
+                if (mSlots[i].mTag != tag) {
+                    continue;
+                }
+                auto& entry = mEntries[mSlots[i].mEntryIdx - 1];
+                if (entry.mHash == hash && entry.mKeyCnt == keyCnt
+                    && std::equal(entry.KeysBegin(), entry.KeysEnd(), aggKeys.begin())) {
+                    return &entry;
+                }
+            }
+            return nullptr;
+        }
+
+        template <class ContainerType>
+        Entry* Add(uint64_t hash, const ContainerType& aggKeys) {
+            // keep load factor no more than 0.75, so that probe sequences stay short
+            if ((mEntries.size() + 1) * 4 > mSlots.size() * 3) {
+                Grow();
+            }
+            mEntries.emplace_back();
+            auto& entry = mEntries.back();
+            entry.mHash = hash;
+            entry.SetKeys(aggKeys);
+            Place(hash, static_cast<uint32_t>(mEntries.size()));
+            return &entry;
+        }
+
+        void Grow() {
+            mSlots.assign(std::max<size_t>(mSlots.size() * 2, kMinSlotCnt), Slot());
+            for (size_t i = 0; i < mEntries.size(); ++i) {
+                Place(mEntries[i].mHash, static_cast<uint32_t>(i + 1));
+            }
+        }
+
+        void Place(uint64_t hash, uint32_t entryIdx) {
+            size_t mask = mSlots.size() - 1;
+            size_t i = hash & mask;
+            while (mSlots[i].mEntryIdx != 0) {
+                i = (i + 1) & mask;
+            }
+            mSlots[i].mTag = static_cast<uint32_t>(hash >> 32);
+            mSlots[i].mEntryIdx = entryIdx;
+        }
+
+        // critical sections are short, and are rarely contended with enough shards
+        mutable SpinLock mLock;
+        // entries are stored densely, so that assembling the tree at report time is a linear scan
+        std::vector<Entry> mEntries;
+        // open addressing with linear probing, and the size is always a power of 2
+        std::vector<Slot> mSlots;
+        std::unordered_map<KeyType, std::shared_ptr<SourceBuffer>> mSourceBuffers;
+        // hashes of all prefixes of the paths, one for each node of the tree to be built, only touched for new paths
+        std::unordered_set<uint64_t> mNodeHashes;
+        size_t mEventCount = 0;
+    };
+
+    static constexpr size_t kMinSlotCnt = 64;
+
+    // agg keys are usually hash values already, but may not be well distributed in low bits
+    static uint64_t Mix(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    // the hash of a path is folded from its first key, so that hashes of all its prefixes come along the way
+    static uint64_t HashCombine(uint64_t hash, const KeyType& val) {
+        return hash ^ (Mix(std::hash<KeyType>{}(val)) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2));
+    }
+
+    template <class ContainerType>
+    size_t GetShardIdx(const ContainerType& aggKeys) const {
+        if (mShards.size() == 1 || aggKeys.begin() == aggKeys.end()) {
+            return 0;
+        }
+        return (Mix(std::hash<KeyType>{}(*aggKeys.begin())) >> 32) % mShards.size();
+    }
+
+    size_t mMaxNodes = 0UL;
+    std::atomic<size_t> mNodeCount = 0UL;
+    std::vector<std::unique_ptr<Shard>> mShards;
+
+    std::function<void(std::unique_ptr<Data>& base, const Value& n)> mAggregateFunc;
+    std::function<std::unique_ptr<Data>(const Value& n, std::shared_ptr<SourceBuffer>& sourceBuffer)> mBuildFunc;
+};
+
+template <typename T, typename U>
+using SIZETShardedAggTree = ShardedAggTree<T, U, size_t, false>;
+
+template <typename T, typename U>
+using SIZETShardedAggTreeWithSourceBuffer = ShardedAggTree<T, U, size_t, true>;
+
+} // namespace logtail
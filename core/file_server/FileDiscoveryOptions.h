@@ -110,6 +110,8 @@ public:
 
     uint32_t GetLastContainerUpdateTime() const { return mLastContainerUpdateTime; }
     void SetLastContainerUpdateTime(uint32_t time) { mLastContainerUpdateTime = time; }
+    uint64_t GetContainerVersion() const { return mContainerVersion; }
+    void SetContainerVersion(uint64_t version) { mContainerVersion = version; }
 
 
     std::vector<std::string> mFilePaths;
@@ -166,6 +168,8 @@ private:
     bool mTailingAllMatchedFiles = false;
 
     uint32_t mLastContainerUpdateTime = 0;
+    // version of container changes in ContainerManager this config has been checked against, 0 if never checked
+    uint64_t mContainerVersion = 0;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class FileDiscoveryOptionsUnittest;
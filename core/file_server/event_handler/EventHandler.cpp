@@ -28,6 +28,7 @@
 #include "file_server/EventDispatcher.h"
 #include "file_server/FileServer.h"
 #include "file_server/event/BlockEventManager.h"
+#include "file_server/event_handler/FileReadWorkerPool.h"
 #include "file_server/event_handler/LogInput.h"
 #include "logger/Logger.h"
 #include "monitor/AlarmManager.h"
@@ -298,6 +299,7 @@ ModifyHandler::ModifyHandler(const std::string& configName, const FileDiscoveryC
 }
 
 ModifyHandler::~ModifyHandler() {
+    FileReadWorkerPool::GetInstance()->Wait(this);
 }
 
 void ModifyHandler::MakeSpaceForNewReader() {
@@ -492,6 +494,9 @@ LogFileReaderPtr ModifyHandler::CreateLogFileReaderPtr(const string& path,
 
 
 void ModifyHandler::Handle(const Event& event) {
+    // the previous read must be done before the readers are touched again
+    FileReadWorkerPool::GetInstance()->Wait(this);
+
     const string& path = event.GetSource();
     const string& name = event.GetEventObject();
 
@@ -653,7 +658,6 @@ void ModifyHandler::Handle(const Event& event) {
                 }
             }
         }
-        uint64_t beginTime = GetCurrentTimeInMicroSeconds();
         LogFileReaderPtrArray* readerArrayPtr = NULL;
         if (!devInode.IsValid()) {
             // call stat failed, but we should try to find reader because the log file may be moved to another name
@@ -807,145 +811,20 @@ void ModifyHandler::Handle(const Event& event) {
             }
         }
 
-        bool hasMoreData;
-        do {
-            if (!ProcessQueueManager::GetInstance()->IsValidToPush(reader->GetQueueKey())) {
-                static int32_t s_lastOutPutTime = 0;
-                int32_t curTime = time(NULL);
-                if (curTime - s_lastOutPutTime > 600) {
-                    s_lastOutPutTime = curTime;
-                    LOG_WARNING(sLogger,
-                                ("logprocess queue is full, put modify event to event queue again",
-                                 reader->GetHostLogPath())(reader->GetProject(), reader->GetLogstore()));
-
-                    AlarmManager::GetInstance()->SendAlarmWarning(
-                        PROCESS_QUEUE_BUSY_ALARM,
-                        string("logprocess queue is full, put modify event to event queue again, file:")
-                            + reader->GetHostLogPath(),
-                        reader->GetRegion(),
-                        reader->GetProject(),
-                        reader->GetConfigName(),
-                        reader->GetLogstore());
-                }
-
-                BlockedEventManager::GetInstance()->UpdateBlockEvent(
-                    reader->GetQueueKey(), mConfigName, event, reader->GetDevInode(), curTime);
-                return;
-            }
-            auto logBuffer = make_unique<LogBuffer>();
-            hasMoreData = reader->ReadLog(*logBuffer, &event);
-            int32_t pushRetry = PushLogToProcessor(reader, logBuffer.get());
-            if (!hasMoreData) {
-                if (reader->IsFileDeleted()) {
-                    LOG_INFO(sLogger,
-                             ("close the file", "current file has been read, and is marked deleted")(
-                                 "project", reader->GetProject())("logstore", reader->GetLogstore())(
-                                 "config", mConfigName)("log reader queue name", reader->GetHostLogPath())(
-                                 "file device", reader->GetDevInode().dev)("file inode", reader->GetDevInode().inode)(
-                                 "file size", reader->GetFileSize()));
-                    bool isDeleted = false;
-                    reader->CloseFilePtr(isDeleted);
-                    if (isDeleted) {
-                        readerArrayPtr->pop_front();
-                        mDevInodeReaderMap.erase(reader->GetDevInode());
-                    }
-                } else if (reader->IsContainerStopped()) {
-                    // update container info one more time, ensure file is hold by same cotnainer
-                    if (reader->UpdateContainerInfo() && !reader->IsContainerStopped()) {
-                        LOG_INFO(sLogger,
-                                 ("file is reused by a new container", reader->GetContainerID())(
-                                     "project", reader->GetProject())("logstore", reader->GetLogstore())(
-                                     "config", mConfigName)("log reader queue name", reader->GetHostLogPath())(
-                                     "file device", reader->GetDevInode().dev)(
-                                     "file inode", reader->GetDevInode().inode)("file size", reader->GetFileSize()));
-                    } else {
-                        // release fd as quick as possible
-                        LOG_INFO(sLogger,
-                                 ("close the file",
-                                  "current file has been read, and the relative container has been stopped")(
-                                     "project", reader->GetProject())("logstore", reader->GetLogstore())(
-                                     "config", mConfigName)("log reader queue name", reader->GetHostLogPath())(
-                                     "file device", reader->GetDevInode().dev)(
-                                     "file inode", reader->GetDevInode().inode)("file size", reader->GetFileSize()));
-                        ForceReadLogAndPush(reader);
-                        bool isDeleted = false;
-                        reader->CloseFilePtr(isDeleted);
-                        if (isDeleted) {
-                            readerArrayPtr->pop_front();
-                            mDevInodeReaderMap.erase(reader->GetDevInode());
-                        }
-                    }
-                }
-                break;
-            }
-            if (pushRetry >= 5 || GetCurrentTimeInMicroSeconds() - beginTime > mReadFileTimeSlice) {
-                LOG_DEBUG(
-                    sLogger,
-                    ("read log breakout", "file io cost 1 time slice (50ms) or push blocked")("pushRetry", pushRetry)(
-                        "begin time", beginTime)("path", event.GetSource())("file", event.GetEventObject()));
-                Event* ev = new Event(event);
-                ev->SetConfigName(mConfigName);
-                LogInput::GetInstance()->PushEventQueue(ev);
-                break;
-            }
-
-            // When loginput thread hold on, we should repush this event back.
-            // If we don't repush and this file has no modify event, this reader will never been read.
-            if (LogInput::GetInstance()->IsInterupt()) {
-                if (hasMoreData) {
-                    LOG_INFO(sLogger,
-                             ("read log interupt but has more data, reason",
-                              "log input thread hold on")("action", "repush modify event to event queue")(
-                                 "begin time", beginTime)("path", event.GetSource())("file", event.GetEventObject())(
-                                 "inode", reader->GetDevInode().inode)("offset", reader->GetLastFilePos())(
-                                 "size", reader->GetFileSize()));
-                } else {
-                    LOG_DEBUG(sLogger,
-                              ("read log breakout, reason",
-                               "log input thread hold on")("action", "repush modify event to event queue")(
-                                  "begin time", beginTime)("path", event.GetSource())("file", event.GetEventObject())(
-                                  "inode", reader->GetDevInode().inode)("offset", reader->GetLastFilePos())(
-                                  "size", reader->GetFileSize()));
-                }
-                Event* ev = new Event(event);
-                ev->SetConfigName(mConfigName);
-                LogInput::GetInstance()->PushEventQueue(ev);
-                break;
-            }
-        } while (true);
-
-        if (!hasMoreData && readerArrayPtr->size() > (size_t)1) {
-            // when a rotated reader finish its reading, it's unlikely that there will be data again
-            // so release file fd as quick as possible (open again if new data coming)
-            LOG_INFO(sLogger,
-                     ("close the file and move the corresponding reader to the rotator reader pool",
-                      "current file has been read and more files are waiting in the log reader queue")(
-                         "project", reader->GetProject())("logstore", reader->GetLogstore())("config", mConfigName)(
-                         "log reader queue name", reader->GetHostLogPath())("log reader queue size",
-                                                                            readerArrayPtr->size() - 1)(
-                         "file device", reader->GetDevInode().dev)("file inode", reader->GetDevInode().inode)(
-                         "file size", reader->GetFileSize())("rotator reader pool size", mRotatorReaderMap.size() + 1));
-            ForceReadLogAndPush(reader);
-            readerArrayPtr->pop_front();
-            mDevInodeReaderMap.erase(reader->GetDevInode());
-            // only move reader to rotator reader map when file is not deleted
-            bool isDeleted = false;
-            reader->CloseFilePtr(isDeleted);
-            if (!isDeleted) {
-                mRotatorReaderMap[reader->GetDevInode()] = reader;
-                // need to push modify event again, but without dev inode
-                // use head dev + inode
-                Event* ev = new Event(event.GetSource(),
-                                      event.GetEventObject(),
-                                      event.GetType(),
-                                      event.GetWd(),
-                                      event.GetCookie(),
-                                      (*readerArrayPtr)[0]->GetDevInode().dev,
-                                      (*readerArrayPtr)[0]->GetDevInode().inode);
-                ev->SetConfigName(mConfigName);
-                LogInput::GetInstance()->PushEventQueue(ev);
-            }
+        auto* readWorkerPool = FileReadWorkerPool::GetInstance();
+        // flow control sleeps in the reading thread, so files are still read one by one in that case
+        if (readWorkerPool->IsRunning() && !AppConfig::GetInstance()->IsInputFlowControl()) {
+            auto ev = make_shared<Event>(event);
+            auto res = make_shared<ReadLogResult>();
+            readWorkerPool->Submit(
+                this,
+                [this, reader, ev, res]() { ReadLogAndPush(reader, *ev, true, *res); },
+                [this, reader, readerArrayPtr, ev, res]() { OnReadLogDone(reader, readerArrayPtr, *ev, *res); });
+            return;
         }
+        ReadLogResult res;
+        ReadLogAndPush(reader, event, false, res);
+        OnReadLogDone(reader, readerArrayPtr, event, res);
     }
     // if a file is created, and dev inode cannot found(this means it's a new file), create reader for this file, then
     // insert reader into mDevInodeReaderMap
@@ -971,7 +850,157 @@ void ModifyHandler::Handle(const Event& event) {
     }
 }
 
+void ModifyHandler::ReadLogAndPush(const LogFileReaderPtr& reader,
+                                   const Event& event,
+                                   bool onWorker,
+                                   ReadLogResult& res) {
+    uint64_t beginTime = GetCurrentTimeInMicroSeconds();
+    do {
+        if (!ProcessQueueManager::GetInstance()->IsValidToPush(reader->GetQueueKey())) {
+            res.mBlocked = true;
+            res.mBlockedTime = time(NULL);
+            return;
+        }
+        auto logBuffer = make_unique<LogBuffer>();
+        res.mHasMoreData = reader->ReadLog(*logBuffer, &event);
+        int32_t pushRetry = PushLogToProcessor(reader, logBuffer.get(), !onWorker);
+        if (!res.mHasMoreData) {
+            return;
+        }
+        if (pushRetry >= 5 || GetCurrentTimeInMicroSeconds() - beginTime > mReadFileTimeSlice) {
+            LOG_DEBUG(
+                sLogger,
+                ("read log breakout", "file io cost 1 time slice (50ms) or push blocked")("pushRetry", pushRetry)(
+                    "begin time", beginTime)("path", event.GetSource())("file", event.GetEventObject()));
+            res.mRepush = true;
+            return;
+        }
+
+        // When loginput thread hold on, we should repush this event back.
+        // If we don't repush and this file has no modify event, this reader will never been read.
+        if (LogInput::GetInstance()->IsInterupt()) {
+            LOG_INFO(sLogger,
+                     ("read log interupt but has more data, reason",
+                      "log input thread hold on")("action", "repush modify event to event queue")(
+                         "begin time", beginTime)("path", event.GetSource())("file", event.GetEventObject())(
+                         "inode", reader->GetDevInode().inode)("offset", reader->GetLastFilePos())(
+                         "size", reader->GetFileSize()));
+            res.mRepush = true;
+            return;
+        }
+    } while (true);
+}
+
+void ModifyHandler::OnReadLogDone(const LogFileReaderPtr& reader,
+                                  LogFileReaderPtrArray* readerArrayPtr,
+                                  const Event& event,
+                                  const ReadLogResult& res) {
+    if (res.mBlocked) {
+        static int32_t s_lastOutPutTime = 0;
+        int32_t curTime = res.mBlockedTime;
+        if (curTime - s_lastOutPutTime > 600) {
+            s_lastOutPutTime = curTime;
+            LOG_WARNING(sLogger,
+                        ("logprocess queue is full, put modify event to event queue again",
+                         reader->GetHostLogPath())(reader->GetProject(), reader->GetLogstore()));
+
+            AlarmManager::GetInstance()->SendAlarmWarning(
+                PROCESS_QUEUE_BUSY_ALARM,
+                string("logprocess queue is full, put modify event to event queue again, file:")
+                    + reader->GetHostLogPath(),
+                reader->GetRegion(),
+                reader->GetProject(),
+                reader->GetConfigName(),
+                reader->GetLogstore());
+        }
+
+        BlockedEventManager::GetInstance()->UpdateBlockEvent(
+            reader->GetQueueKey(), mConfigName, event, reader->GetDevInode(), curTime);
+        return;
+    }
+    if (res.mRepush) {
+        Event* ev = new Event(event);
+        ev->SetConfigName(mConfigName);
+        LogInput::GetInstance()->PushEventQueue(ev);
+        return;
+    }
+    if (res.mHasMoreData) {
+        return;
+    }
+
+    if (reader->IsFileDeleted()) {
+        LOG_INFO(sLogger,
+                 ("close the file", "current file has been read, and is marked deleted")(
+                     "project", reader->GetProject())("logstore", reader->GetLogstore())("config", mConfigName)(
+                     "log reader queue name", reader->GetHostLogPath())("file device", reader->GetDevInode().dev)(
+                     "file inode", reader->GetDevInode().inode)("file size", reader->GetFileSize()));
+        bool isDeleted = false;
+        reader->CloseFilePtr(isDeleted);
+        if (isDeleted) {
+            readerArrayPtr->pop_front();
+            mDevInodeReaderMap.erase(reader->GetDevInode());
+        }
+    } else if (reader->IsContainerStopped()) {
+        // update container info one more time, ensure file is hold by same cotnainer
+        if (reader->UpdateContainerInfo() && !reader->IsContainerStopped()) {
+            LOG_INFO(sLogger,
+                     ("file is reused by a new container", reader->GetContainerID())(
+                         "project", reader->GetProject())("logstore", reader->GetLogstore())("config", mConfigName)(
+                         "log reader queue name", reader->GetHostLogPath())("file device", reader->GetDevInode().dev)(
+                         "file inode", reader->GetDevInode().inode)("file size", reader->GetFileSize()));
+        } else {
+            // release fd as quick as possible
+            LOG_INFO(sLogger,
+                     ("close the file", "current file has been read, and the relative container has been stopped")(
+                         "project", reader->GetProject())("logstore", reader->GetLogstore())("config", mConfigName)(
+                         "log reader queue name", reader->GetHostLogPath())("file device", reader->GetDevInode().dev)(
+                         "file inode", reader->GetDevInode().inode)("file size", reader->GetFileSize()));
+            ForceReadLogAndPush(reader);
+            bool isDeleted = false;
+            reader->CloseFilePtr(isDeleted);
+            if (isDeleted) {
+                readerArrayPtr->pop_front();
+                mDevInodeReaderMap.erase(reader->GetDevInode());
+            }
+        }
+    }
+
+    if (readerArrayPtr->size() > (size_t)1) {
+        // when a rotated reader finish its reading, it's unlikely that there will be data again
+        // so release file fd as quick as possible (open again if new data coming)
+        LOG_INFO(sLogger,
+                 ("close the file and move the corresponding reader to the rotator reader pool",
+                  "current file has been read and more files are waiting in the log reader queue")(
+                     "project", reader->GetProject())("logstore", reader->GetLogstore())("config", mConfigName)(
+                     "log reader queue name", reader->GetHostLogPath())("log reader queue size",
+                                                                        readerArrayPtr->size() - 1)(
+                     "file device", reader->GetDevInode().dev)("file inode", reader->GetDevInode().inode)(
+                     "file size", reader->GetFileSize())("rotator reader pool size", mRotatorReaderMap.size() + 1));
+        ForceReadLogAndPush(reader);
+        readerArrayPtr->pop_front();
+        mDevInodeReaderMap.erase(reader->GetDevInode());
+        // only move reader to rotator reader map when file is not deleted
+        bool isDeleted = false;
+        reader->CloseFilePtr(isDeleted);
+        if (!isDeleted) {
+            mRotatorReaderMap[reader->GetDevInode()] = reader;
+            // need to push modify event again, but without dev inode
+            // use head dev + inode
+            Event* ev = new Event(event.GetSource(),
+                                  event.GetEventObject(),
+                                  event.GetType(),
+                                  event.GetWd(),
+                                  event.GetCookie(),
+                                  (*readerArrayPtr)[0]->GetDevInode().dev,
+                                  (*readerArrayPtr)[0]->GetDevInode().inode);
+            ev->SetConfigName(mConfigName);
+            LogInput::GetInstance()->PushEventQueue(ev);
+        }
+    }
+}
+
 void ModifyHandler::HandleTimeOut() {
+    FileReadWorkerPool::GetInstance()->Wait(this);
     MakeSpaceForNewReader();
     DeleteTimeoutReader();
     DeleteRollbackReader();
@@ -1156,7 +1185,7 @@ void ModifyHandler::ForceReadLogAndPush(LogFileReaderPtr reader) {
     PushLogToProcessor(reader, logBuffer.get());
 }
 
-int32_t ModifyHandler::PushLogToProcessor(LogFileReaderPtr reader, LogBuffer* logBuffer) {
+int32_t ModifyHandler::PushLogToProcessor(LogFileReaderPtr reader, LogBuffer* logBuffer, bool tryReadEvents) {
     int32_t pushRetry = 0;
     if (!logBuffer->rawBuffer.empty()) {
         reader->ReportMetrics(logBuffer->readLength);
@@ -1165,7 +1194,7 @@ int32_t ModifyHandler::PushLogToProcessor(LogFileReaderPtr reader, LogBuffer* lo
         while (!ProcessorRunner::GetInstance()->PushQueue(reader->GetQueueKey(), 0, std::move(group))) // 10ms
         {
             ++pushRetry;
-            if (pushRetry % 10 == 0)
+            if (tryReadEvents && pushRetry % 10 == 0)
                 LogInput::GetInstance()->TryReadEvents(false);
         }
     }
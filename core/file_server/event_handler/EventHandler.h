@@ -98,7 +98,25 @@ private:
                                             uint32_t exactlyonceConcurrency = 0,
                                             bool forceBeginingFlag = false);
 
-    int32_t PushLogToProcessor(LogFileReaderPtr reader, LogBuffer* logBuffer);
+    // events are not read while the push is blocked if called off the LogInput thread
+    int32_t PushLogToProcessor(LogFileReaderPtr reader, LogBuffer* logBuffer, bool tryReadEvents = true);
+
+    // outcome of reading a file on modify event, which may be read by read workers
+    struct ReadLogResult {
+        bool mBlocked = false;
+        int32_t mBlockedTime = 0;
+        bool mHasMoreData = false;
+        // the event should be handled again for more data
+        bool mRepush = false;
+    };
+
+    // safe to be called by read workers, since only the reader and the process queue are accessed
+    void ReadLogAndPush(const LogFileReaderPtr& reader, const Event& event, bool onWorker, ReadLogResult& res);
+    // must be called by the LogInput thread, since the reader maps are updated
+    void OnReadLogDone(const LogFileReaderPtr& reader,
+                       LogFileReaderPtrArray* readerArrayPtr,
+                       const Event& event,
+                       const ReadLogResult& res);
 
     void ForceReadLogAndPush(LogFileReaderPtr reader);
 
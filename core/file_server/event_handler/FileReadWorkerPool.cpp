@@ -0,0 +1,133 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "file_server/event_handler/FileReadWorkerPool.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "logger/Logger.h"
+
+using namespace std;
+
+namespace logtail {
+
+void FileReadWorkerPool::Start(size_t threadCnt, function<void()>&& onWait) {
+    if (IsRunning() || threadCnt == 0) {
+        return;
+    }
+    mOnWait = std::move(onWait);
+    {
+        lock_guard<mutex> lock(mMux);
+        mStopFlag = false;
+    }
+    for (size_t i = 0; i < threadCnt; ++i) {
+        mThreadRes.emplace_back(async(launch::async, &FileReadWorkerPool::Run, this));
+    }
+    LOG_INFO(sLogger, ("file read worker pool", "started")("thread count", threadCnt));
+}
+
+void FileReadWorkerPool::Stop() {
+    if (!IsRunning()) {
+        return;
+    }
+    WaitAll();
+    {
+        lock_guard<mutex> lock(mMux);
+        mStopFlag = true;
+    }
+    mTaskCV.notify_all();
+    for (auto& res : mThreadRes) {
+        res.wait();
+    }
+    mThreadRes.clear();
+    mOnWait = nullptr;
+    LOG_INFO(sLogger, ("file read worker pool", "stopped"));
+}
+
+void FileReadWorkerPool::Submit(const void* owner, function<void()>&& read, function<void()>&& done) {
+    if (!IsRunning()) {
+        read();
+        done();
+        return;
+    }
+    auto task = make_shared<Task>();
+    task->mOwner = owner;
+    task->mRead = std::move(read);
+    task->mDone = std::move(done);
+    mPendingTasks.emplace_back(task);
+    {
+        lock_guard<mutex> lock(mMux);
+        mTaskQueue.emplace_back(std::move(task));
+    }
+    mTaskCV.notify_one();
+}
+
+void FileReadWorkerPool::Wait(const void* owner) {
+    auto iter = find_if(mPendingTasks.begin(), mPendingTasks.end(), [owner](const shared_ptr<Task>& task) {
+        return task->mOwner == owner;
+    });
+    if (iter == mPendingTasks.end()) {
+        return;
+    }
+    auto task = *iter;
+    mPendingTasks.erase(iter);
+    Complete(task);
+}
+
+void FileReadWorkerPool::WaitAll() {
+    // completions may submit new reads, which are waited for as well
+    while (!mPendingTasks.empty()) {
+        auto task = std::move(mPendingTasks.front());
+        mPendingTasks.pop_front();
+        Complete(task);
+    }
+}
+
+void FileReadWorkerPool::Complete(const shared_ptr<Task>& task) {
+    {
+        unique_lock<mutex> lock(mMux);
+        while (!mFinishCV.wait_for(lock, chrono::milliseconds(10), [&task]() { return task->mFinished; })) {
+            if (mOnWait) {
+                lock.unlock();
+                mOnWait();
+                lock.lock();
+            }
+        }
+    }
+    task->mDone();
+}
+
+void FileReadWorkerPool::Run() {
+    while (true) {
+        shared_ptr<Task> task;
+        {
+            unique_lock<mutex> lock(mMux);
+            mTaskCV.wait(lock, [this]() { return mStopFlag || !mTaskQueue.empty(); });
+            if (mStopFlag) {
+                return;
+            }
+            task = std::move(mTaskQueue.front());
+            mTaskQueue.pop_front();
+        }
+        task->mRead();
+        {
+            lock_guard<mutex> lock(mMux);
+            task->mFinished = true;
+        }
+        mFinishCV.notify_all();
+    }
+}
+
+} // namespace logtail
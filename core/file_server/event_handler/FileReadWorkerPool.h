@@ -0,0 +1,89 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace logtail {
+
+// Reads log files on worker threads on behalf of the LogInput thread.
+// Each read is submitted by its owner, i.e. the handler of the file, together with a completion, which updates the
+// owner and is always run on the LogInput thread after the read finishes. An owner has at most one read in flight, and
+// waits for it before handling another event, so that events of the same file are still handled in order, while files
+// of different owners are read concurrently.
+// Except for Start and Stop, all methods must be called by the LogInput thread.
+class FileReadWorkerPool {
+public:
+    FileReadWorkerPool(const FileReadWorkerPool&) = delete;
+    FileReadWorkerPool& operator=(const FileReadWorkerPool&) = delete;
+
+    static FileReadWorkerPool* GetInstance() {
+        static FileReadWorkerPool instance;
+        return &instance;
+    }
+
+    // onWait is called periodically while waiting for reads, so that events are still read in the meantime
+    void Start(size_t threadCnt, std::function<void()>&& onWait);
+    void Stop();
+    bool IsRunning() const { return !mThreadRes.empty(); }
+
+    // read is run inline together with done if the pool is not running
+    void Submit(const void* owner, std::function<void()>&& read, std::function<void()>&& done);
+    // wait for the read of the owner, if any, and run its completion
+    void Wait(const void* owner);
+    // wait for all reads, and run their completions in the order of submission
+    void WaitAll();
+    size_t GetPendingCnt() const { return mPendingTasks.size(); }
+
+private:
+    struct Task {
+        const void* mOwner = nullptr;
+        std::function<void()> mRead;
+        std::function<void()> mDone;
+        bool mFinished = false;
+    };
+
+    FileReadWorkerPool() = default;
+    ~FileReadWorkerPool() = default;
+
+    void Run();
+    void Complete(const std::shared_ptr<Task>& task);
+
+    std::vector<std::future<void>> mThreadRes;
+    std::function<void()> mOnWait;
+
+    std::mutex mMux;
+    std::condition_variable mTaskCV;
+    std::condition_variable mFinishCV;
+    std::deque<std::shared_ptr<Task>> mTaskQueue;
+    bool mStopFlag = false;
+
+    // submitted but not completed, in the order of submission, only accessed by the LogInput thread
+    std::deque<std::shared_ptr<Task>> mPendingTasks;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class FileReadWorkerPoolUnittest;
+#endif
+};
+
+} // namespace logtail
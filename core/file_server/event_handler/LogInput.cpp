@@ -30,6 +30,7 @@
 #include "file_server/checkpoint/CheckPointManager.h"
 #include "file_server/event/BlockEventManager.h"
 #include "file_server/event_handler/EventHandler.h"
+#include "file_server/event_handler/FileReadWorkerPool.h"
 #include "file_server/event_handler/HistoryFileImporter.h"
 #include "file_server/polling/PollingCache.h"
 #include "file_server/polling/PollingDirFile.h"
@@ -53,6 +54,12 @@ DEFINE_FLAG_INT32(dump_inotify_watcher_interval, "seconds", 180);
 DEFINE_FLAG_INT32(clear_config_match_interval, "seconds", 600);
 DEFINE_FLAG_INT32(check_block_event_interval, "seconds", 1);
 DEFINE_FLAG_INT32(read_local_event_interval, "seconds", 60);
+DEFINE_FLAG_INT32(file_read_worker_thread_count,
+                  "number of threads reading files for LogInput, files are read by LogInput thread if 0",
+                  4);
+DEFINE_FLAG_INT32(file_read_worker_round_size,
+                  "max number of events handled by LogInput before waiting for all reads of them",
+                  64);
 DEFINE_FLAG_BOOL(force_close_file_on_container_stopped,
                  "whether close file handler immediately when associate container stopped",
                  false);
@@ -308,22 +315,29 @@ void LogInput::ProcessEvent(EventDispatcher* dispatcher, Event* ev) {
     LOG_DEBUG(sLogger,
               ("process event, type", ev->GetTypeString())("dir", ev->GetSource())("filename", ev->GetEventObject())(
                   "config", ev->GetConfigName()));
-    if (ev->IsTimeout())
+    if (ev->IsTimeout()) {
+        FileReadWorkerPool::GetInstance()->WaitAll();
         dispatcher->UnregisterAllDir(source);
-    else {
+    } else {
         if (ev->IsDir()
             && (ev->IsMoveFrom() || (ev->IsContainerStopped() && BOOL_FLAG(force_close_file_on_container_stopped)))) {
+            FileReadWorkerPool::GetInstance()->WaitAll();
             string path = source;
             if (object.size() > 0)
                 path += PATH_SEPARATOR + object;
             dispatcher->UnregisterAllDir(path);
         } else if (ev->IsDir() && ev->IsContainerStopped()) {
+            FileReadWorkerPool::GetInstance()->WaitAll();
             string path = source;
             if (object.size() > 0)
                 path += PATH_SEPARATOR + object;
             dispatcher->StopAllDir(path, ev->GetContainerID());
         } else {
             EventHandler* handler = dispatcher->GetHandler(source.c_str());
+            // only reads on modify events are run concurrently, and other events may touch readers of all handlers
+            if (!handler || !ev->IsModify()) {
+                FileReadWorkerPool::GetInstance()->WaitAll();
+            }
             if (handler) {
                 handler->Handle(*ev);
                 dispatcher->PropagateTimeout(source.c_str());
@@ -374,17 +388,29 @@ void LogInput::ProcessLoop() {
     int32_t lastReadLocalEventTime = prevTime;
     mEventProcessCount = 0;
     BlockedEventManager* pBlockedEventManager = BlockedEventManager::GetInstance();
+    FileReadWorkerPool* readWorkerPool = FileReadWorkerPool::GetInstance();
+    readWorkerPool->Start(max(INT32_FLAG(file_read_worker_thread_count), 0), [this]() { TryReadEvents(false); });
     string path;
     while (true) {
         ReadLock lock(mAccessMainThreadRWL);
         TryReadEvents(false);
         Event* ev = PopEventQueue();
         if (ev != NULL) {
-            ++mEventProcessCount;
-            if (mIdleFlag) {
-                delete ev;
-            } else
-                ProcessEvent(dispatcher, ev);
+            // files of a round of events are read concurrently, and all reads are done before the round ends, so that
+            // readers are never accessed by other threads while LogInput is held on
+            int32_t roundSize = readWorkerPool->IsRunning() ? INT32_FLAG(file_read_worker_round_size) : 1;
+            for (int32_t i = 0; ev != NULL;) {
+                ++mEventProcessCount;
+                if (mIdleFlag) {
+                    delete ev;
+                } else
+                    ProcessEvent(dispatcher, ev);
+                if (++i >= roundSize) {
+                    break;
+                }
+                ev = PopEventQueue();
+            }
+            readWorkerPool->WaitAll();
         } else {
             unique_lock<mutex> lock(mFeedbackMux);
             mFeedbackCV.wait_for(lock, chrono::microseconds(INT32_FLAG(log_input_thread_wait_interval)));
@@ -461,6 +487,7 @@ void LogInput::ProcessLoop() {
         }
     }
 
+    readWorkerPool->Stop();
     mInteruptFlag = true;
 }
 
@@ -40,6 +40,7 @@
 #include "collection_pipeline/queue/ExactlyOnceQueueManager.h"
 #include "collection_pipeline/queue/ProcessQueueManager.h"
 #include "collection_pipeline/queue/QueueKeyManager.h"
+#include "common/CharSearch.h"
 #include "common/ErrorUtil.h"
 #include "common/FileSystemUtil.h"
 #include "common/Flags.h"
@@ -2170,10 +2171,10 @@ LineInfo RawTextParser::GetLastLine(StringView buffer,
         return LineInfo(StringView(), 0, 0, 0, false, 0);
     }
 
-    for (int32_t begin = end; begin > 0; --begin) {
-        if (buffer[begin - 1] == '\n') {
-            return LineInfo(StringView(buffer.data() + begin, end - begin), begin, end, 1, true, 0);
-        }
+    size_t pos = FindLastChar(buffer.data(), end, '\n');
+    if (pos != static_cast<size_t>(end)) {
+        int32_t begin = static_cast<int32_t>(pos) + 1;
+        return LineInfo(StringView(buffer.data() + begin, end - begin), begin, end, 1, true, 0);
     }
     return LineInfo(StringView(buffer.data(), end), 0, end, 1, true, 0);
 }
@@ -21,14 +21,18 @@
 #include <chrono>
 #include <mutex>
 #include <string>
+#include <thread>
 
 using namespace std;
 using namespace std::chrono;
 
+#include <dirent.h>
+#include <fcntl.h>
 #include <grp.h>
 #include <mntent.h>
 #include <pwd.h>
 #include <sys/statvfs.h>
+#include <sys/syscall.h>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/split.hpp>
@@ -37,14 +41,78 @@ using namespace std::chrono;
 #include <iostream>
 
 #include "common/FileSystemUtil.h"
+#include "common/Flags.h"
 #include "common/StringTools.h"
 #include "host_monitor/Constants.h"
 #include "host_monitor/SystemInformationTools.h"
 #include "host_monitor/common/FastFieldParser.h"
 #include "logger/Logger.h"
 
+DECLARE_FLAG_INT32(process_collect_silent_count);
+
 namespace logtail {
 
+namespace {
+
+// reads the whole file at @path relative to @dirFd into @content, whose capacity is reused across calls
+bool ReadFileAt(int dirFd, const char* path, string& content) {
+    int fd = openat(dirFd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    content.clear();
+    char buf[4096];
+    bool ok = true;
+    while (true) {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n > 0) {
+            content.append(buf, n);
+        } else if (n == 0) {
+            break;
+        } else if (errno != EINTR) {
+            ok = false;
+            break;
+        }
+    }
+    close(fd);
+    return ok;
+}
+
+// lists numeric entries of @dirFd with raw getdents64, which saves a stat per entry and all the path objects created
+// by std::filesystem::directory_iterator
+bool ListPids(int dirFd, vector<pid_t>& pids) {
+    alignas(struct dirent64) char buf[32 * 1024];
+    while (true) {
+        long n = syscall(SYS_getdents64, dirFd, buf, sizeof(buf));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (n == 0) {
+            return true;
+        }
+        for (long pos = 0; pos < n;) {
+            auto* entry = reinterpret_cast<struct dirent64*>(buf + pos);
+            pos += entry->d_reclen;
+            if (entry->d_type != DT_DIR && entry->d_type != DT_UNKNOWN) {
+                continue;
+            }
+            pid_t pid = 0;
+            const char* c = entry->d_name;
+            for (; *c >= '0' && *c <= '9'; ++c) {
+                pid = pid * 10 + (*c - '0');
+            }
+            if (*c == '\0' && c != entry->d_name) {
+                pids.push_back(pid);
+            }
+        }
+    }
+}
+
+} // namespace
+
 bool LinuxSystemInterface::GetHostSystemStat(vector<string>& lines, string& errorMessage) {
     errorMessage.clear();
     if (!CheckExistance(PROCESS_DIR / PROCESS_STAT)) {
@@ -598,6 +666,45 @@ bool LinuxSystemInterface::GetProcessInformationOnce(pid_t pid, ProcessInformati
     return true;
 }
 
+bool LinuxSystemInterface::GetProcessSnapshotOnce(ProcessSnapshot& snapshot) {
+    int procFd = open(PROCESS_DIR.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (procFd < 0) {
+        LOG_ERROR(sLogger, ("process root path is not a directory or not exist", PROCESS_DIR));
+        return false;
+    }
+    deferred(close(procFd));
+
+    vector<pid_t> pids;
+    pids.reserve(1024);
+    if (!ListPids(procFd, pids)) {
+        LOG_WARNING(sLogger, ("failed to iterate process directory", PROCESS_DIR)("errno", errno));
+        return false;
+    }
+    sort(pids.begin(), pids.end());
+
+    snapshot.processes.clear();
+    snapshot.processes.reserve(pids.size());
+    string content;
+    char path[32];
+    int readCount = 0;
+    for (auto pid : pids) {
+        if (++readCount > INT32_FLAG(process_collect_silent_count)) {
+            readCount = 0;
+            this_thread::sleep_for(milliseconds{100});
+        }
+        snprintf(path, sizeof(path), "%d/stat", pid);
+        if (!ReadFileAt(procFd, path, content)) {
+            // the process may have exited
+            continue;
+        }
+        snapshot.processes.emplace_back();
+        auto& process = snapshot.processes.back();
+        // parsed the same way as GetProcessInformationOnce, so that both give the same result
+        mProcParser.ParseProcessStat(pid, content, process.stat);
+    }
+    return true;
+}
+
 bool LinuxSystemInterface::GetSystemLoadInformationOnce(SystemLoadInformation& systemLoadInfo) {
     std::vector<std::string> loadLines;
     std::string errorMessage;
@@ -41,6 +41,7 @@ private:
     bool GetCPUInformationOnce(CPUInformation& cpuInfo) override;
     bool GetProcessListInformationOnce(ProcessListInformation& processListInfo) override;
     bool GetProcessInformationOnce(pid_t pid, ProcessInformation& processInfo) override;
+    bool GetProcessSnapshotOnce(ProcessSnapshot& snapshot) override;
     bool GetHostMemInformationStatOnce(MemoryInformation& meminfoStr) override;
     bool GetTCPStatInformationOnce(TCPStatInformation& tcpStatInfo) override;
     bool GetNetInterfaceInformationOnce(NetInterfaceInformation& netInterfaceInfo) override;
@@ -18,12 +18,14 @@
 
 #include <ctime>
 
+#include <algorithm>
 #include <boost/asio.hpp>
 #include <boost/asio/ip/address_v4.hpp>
 #include <boost/asio/ip/address_v6.hpp>
 #include <chrono>
 #include <iostream>
 #include <mutex>
+#include <thread>
 #include <tuple>
 #include <utility>
 
@@ -44,6 +46,7 @@ DEFINE_FLAG_INT32(system_interface_cache_queue_size, "system interface default c
 DEFINE_FLAG_INT32(system_interface_cache_entry_expire_seconds, "cache entry expire time in seconds", 60);
 DEFINE_FLAG_INT32(system_interface_cache_cleanup_interval_seconds, "cache cleanup interval in seconds", 300);
 DEFINE_FLAG_INT32(system_interface_cache_max_cleanup_batch_size, "max entries to cleanup in one batch", 50);
+DEFINE_FLAG_INT32(process_collect_silent_count, "number of process scanned between a sleep", 1000);
 
 namespace logtail {
 
@@ -104,6 +107,75 @@ bool SystemInterface::GetProcessInformation(time_t now, pid_t pid, ProcessInform
         pid);
 }
 
+const ProcessSnapshot::Process* ProcessSnapshot::Find(pid_t pid) const {
+    auto it = std::lower_bound(
+        processes.begin(), processes.end(), pid, [](const Process& p, pid_t target) { return p.stat.pid < target; });
+    if (it == processes.end() || it->stat.pid != pid) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+bool SystemInterface::GetProcessSnapshot(time_t now, std::shared_ptr<const ProcessSnapshot>& snapshot) {
+    // collectors of the same tick wait for the one building the snapshot instead of scanning /proc again
+    std::unique_lock<std::mutex> lock(mProcessSnapshotMutex);
+    mProcessSnapshotCV.wait(lock, [this]() { return !mIsBuildingProcessSnapshot; });
+    if (mProcessSnapshot && mProcessSnapshot->collectTime >= now) {
+        snapshot = mProcessSnapshot;
+        ADD_COUNTER(mCacheHitTotal, 1);
+        return true;
+    }
+    mIsBuildingProcessSnapshot = true;
+    lock.unlock();
+
+    auto newSnapshot = std::make_shared<ProcessSnapshot>();
+    bool status = GetProcessSnapshotOnce(*newSnapshot);
+    // We should use real time here, because input time may be delayed
+    newSnapshot->collectTime = time(nullptr);
+    UpdateSystemOpMetrics(status);
+
+    lock.lock();
+    mIsBuildingProcessSnapshot = false;
+    if (status) {
+        mProcessSnapshot = newSnapshot;
+    }
+    lock.unlock();
+    mProcessSnapshotCV.notify_all();
+    if (!status) {
+        LOG_ERROR(sLogger, ("failed to get system information", "process snapshot"));
+        return false;
+    }
+    snapshot = std::move(newSnapshot);
+    return true;
+}
+
+// fallback for platforms without a dedicated scanner, built from the per process interfaces
+bool SystemInterface::GetProcessSnapshotOnce(ProcessSnapshot& snapshot) {
+    ProcessListInformation processListInfo;
+    if (!GetProcessListInformationOnce(processListInfo)) {
+        return false;
+    }
+    std::sort(processListInfo.pids.begin(), processListInfo.pids.end());
+    snapshot.processes.reserve(processListInfo.pids.size());
+    int readCount = 0;
+    for (auto pid : processListInfo.pids) {
+        if (++readCount > INT32_FLAG(process_collect_silent_count)) {
+            readCount = 0;
+            std::this_thread::sleep_for(std::chrono::milliseconds{100});
+        }
+        ProcessInformation processInfo;
+        if (!GetProcessInformationOnce(pid, processInfo)) {
+            // the process may have exited
+            continue;
+        }
+        snapshot.processes.emplace_back();
+        auto& process = snapshot.processes.back();
+        process.stat = std::move(processInfo.stat);
+        process.stat.pid = pid;
+    }
+    return true;
+}
+
 bool SystemInterface::GetSystemLoadInformation(time_t now, SystemLoadInformation& systemLoadInfo) {
     const std::string errorType = "system load";
     return MemoizedCall(
@@ -28,6 +28,7 @@
 #include <chrono>
 #include <condition_variable>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <shared_mutex>
@@ -241,6 +242,19 @@ struct ProcessInformation : public BaseInformation {
     ProcessStat stat; // shared data structrue with eBPF process
 };
 
+// stat of all processes, taken in one scan of /proc and shared by all collectors of the same tick. Other files of a
+// process, e.g. statm, are only read for the processes reported.
+struct ProcessSnapshot : public BaseInformation {
+    struct Process {
+        ProcessStat stat;
+    };
+
+    // returns nullptr if the process did not exist at the time of the snapshot
+    const Process* Find(pid_t pid) const;
+
+    std::vector<Process> processes; // sorted by pid
+};
+
 // /proc/loadavg
 struct SystemStat {
     double load1 = 0.0;
@@ -717,6 +731,8 @@ public:
     bool GetCPUInformation(time_t now, CPUInformation& cpuInfo);
     bool GetProcessListInformation(time_t now, ProcessListInformation& processListInfo);
     bool GetProcessInformation(time_t now, pid_t pid, ProcessInformation& processInfo);
+    // the snapshot is immutable once returned, and is rebuilt only if the latest one was taken before @now
+    bool GetProcessSnapshot(time_t now, std::shared_ptr<const ProcessSnapshot>& snapshot);
     bool GetSystemLoadInformation(time_t now, SystemLoadInformation& systemLoadInfo);
     bool GetCPUCoreNumInformation(CpuCoreNumInformation& cpuCoreNumInfo);
     bool GetHostMemInformationStat(time_t now, MemoryInformation& meminfo);
@@ -777,6 +793,7 @@ private:
     virtual bool GetCPUInformationOnce(CPUInformation& cpuInfo) = 0;
     virtual bool GetProcessListInformationOnce(ProcessListInformation& processListInfo) = 0;
     virtual bool GetProcessInformationOnce(pid_t pid, ProcessInformation& processInfo) = 0;
+    virtual bool GetProcessSnapshotOnce(ProcessSnapshot& snapshot);
     virtual bool GetSystemLoadInformationOnce(SystemLoadInformation& systemLoadInfo) = 0;
     virtual bool GetCPUCoreNumInformationOnce(CpuCoreNumInformation& cpuCoreNumInfo) = 0;
     virtual bool GetHostMemInformationStatOnce(MemoryInformation& meminfoStr) = 0;
@@ -815,6 +832,13 @@ private:
     SystemInformationCache<TCPStatInformation> mTCPStatInformationCache;
     SystemInformationCache<NetInterfaceInformation> mNetInterfaceInformationCache;
     SystemInformationCache<GPUInformation> mGPUInformationCache;
+    // only the latest snapshot is kept, since it is much larger than other information
+    std::mutex mProcessSnapshotMutex;
+    // the scan sleeps between batches of processes, so it runs without holding the mutex, and other callers of the
+    // same tick wait for it on the condition variable
+    std::condition_variable mProcessSnapshotCV;
+    bool mIsBuildingProcessSnapshot = false;
+    std::shared_ptr<const ProcessSnapshot> mProcessSnapshot;
 
     // Metrics
     MetricsRecordRef mMetricsRecordRef;
@@ -98,13 +98,18 @@ bool ProcessCollector::Init(HostMonitorContext& collectContext) {
 }
 
 bool ProcessCollector::Collect(HostMonitorContext& collectContext, PipelineEventGroup* groupPtr) {
-    ProcessListInformation processListInfo;
-
-    if (!SystemInterface::GetInstance()->GetProcessListInformation(collectContext.GetMetricTime(), processListInfo)) {
+    if (!SystemInterface::GetInstance()->GetProcessSnapshot(collectContext.GetMetricTime(), mProcessSnapshot)) {
         return false;
     }
+    // stat of all processes is served by the snapshot during this collection
+    deferred(mProcessSnapshot.reset());
+    time_t snapshotTime = mProcessSnapshot->collectTime;
 
-    pids = processListInfo.pids;
+    pids.clear();
+    pids.reserve(mProcessSnapshot->processes.size());
+    for (const auto& process : mProcessSnapshot->processes) {
+        pids.push_back(process.stat.pid);
+    }
     std::vector<ProcessAllStat> allPidStats;
     std::vector<std::pair<pid_t, ProcessCpuInformation>> cpuInfos;
 
@@ -185,7 +190,7 @@ bool ProcessCollector::Collect(HostMonitorContext& collectContext, PipelineEvent
     if (!metricEvent) {
         return false;
     }
-    metricEvent->SetTimestamp(processListInfo.collectTime, 0);
+    metricEvent->SetTimestamp(snapshotTime, 0);
     metricEvent->SetValue<UntypedMultiDoubleValues>(metricEvent);
     auto* multiDoubleValues = metricEvent->MutableValue<UntypedMultiDoubleValues>();
     struct MetricDef {
@@ -206,7 +211,7 @@ bool ProcessCollector::Collect(HostMonitorContext& collectContext, PipelineEvent
     // 每个pid一条记录上报
     for (size_t i = 0; i < mTopN && i < pushMerticList.size(); i++) {
         MetricEvent* metricEventEachPid = groupPtr->AddMetricEvent(true);
-        metricEventEachPid->SetTimestamp(processListInfo.collectTime, 0);
+        metricEventEachPid->SetTimestamp(snapshotTime, 0);
         metricEventEachPid->SetValue<UntypedMultiDoubleValues>(metricEventEachPid);
         auto* multiDoubleValuesEachPid = metricEventEachPid->MutableValue<UntypedMultiDoubleValues>();
         // 上传每一个pid对应的值
@@ -507,6 +512,14 @@ bool ProcessCollector::GetProcessTime(time_t now, pid_t pid, ProcessTime& output
 // 3 0 0 0 0 0 6336016 6337300 21442560 140727020027760 140727020027777
 // 140727020027777 140727020027887 0
 bool ProcessCollector::ReadProcessStat(time_t now, pid_t pid, ProcessInformation& processInfo) {
+    if (mProcessSnapshot) {
+        auto process = mProcessSnapshot->Find(pid);
+        if (process != nullptr) {
+            processInfo.stat = process->stat;
+            processInfo.collectTime = mProcessSnapshot->collectTime;
+            return true;
+        }
+    }
     if (!SystemInterface::GetInstance()->GetProcessInformation(now, pid, processInfo)) {
         return false;
     }
@@ -91,6 +91,8 @@ private:
     std::unordered_map<pid_t, double> mMinProcessNumThreads;
     std::unordered_map<pid_t, double> mMaxProcessNumThreads;
     std::unordered_map<pid_t, std::string> pidNameMap;
+    // only valid during Collect
+    std::shared_ptr<const ProcessSnapshot> mProcessSnapshot;
 };
 
 } // namespace logtail
@@ -41,16 +41,13 @@
 #include "logger/Logger.h"
 #include "models/PipelineEventGroup.h"
 
-DEFINE_FLAG_INT32(process_collect_silent_count, "number of process scanned between a sleep", 1000);
-
 namespace logtail {
 
 const size_t ProcessTopN = 20;
 
 const std::string ProcessEntityCollector::sName = "process_entity";
 
-ProcessEntityCollector::ProcessEntityCollector()
-    : mProcParser(""), mProcessSilentCount(INT32_FLAG(process_collect_silent_count)) {
+ProcessEntityCollector::ProcessEntityCollector() : mProcParser("") {
 }
 
 system_clock::time_point ProcessEntityCollector::TicksToUnixTime(int64_t startTicks) {
@@ -142,26 +139,22 @@ time_t ProcessEntityCollector::GetSortedProcess(std::vector<ExtendedProcessStatP
                         decltype(compare)>
         queue(compare);
 
-    int readCount = 0;
     std::unordered_map<pid_t, ExtendedProcessStatPtr> newProcessStat;
-    ProcessListInformation processListInfo;
-    if (!SystemInterface::GetInstance()->GetProcessListInformation(collectTime.mMetricTime, processListInfo)) {
-        LOG_ERROR(sLogger, ("failed to get process list information", "skip collect"));
+    std::shared_ptr<const ProcessSnapshot> snapshot;
+    if (!SystemInterface::GetInstance()->GetProcessSnapshot(collectTime.mMetricTime, snapshot)) {
+        LOG_ERROR(sLogger, ("failed to get process snapshot", "skip collect"));
         return 0;
     }
-    CollectTime shiftCollectTime{collectTime.GetShiftSteadyTime(processListInfo.collectTime),
-                                 processListInfo.collectTime};
+    CollectTime shiftCollectTime{collectTime.GetShiftSteadyTime(snapshot->collectTime), snapshot->collectTime};
 
-    for (const auto& pid : processListInfo.pids) {
+    // no file is read in the loop, since stats of all processes have been taken by the snapshot
+    for (const auto& process : snapshot->processes) {
+        pid_t pid = process.stat.pid;
         if (pid == 0) {
             continue;
         }
-        if (++readCount > mProcessSilentCount) {
-            readCount = 0;
-            std::this_thread::sleep_for(milliseconds{100});
-        }
         bool isFirstCollect = false;
-        auto ptr = GetProcessStat(pid, isFirstCollect, shiftCollectTime);
+        auto ptr = GetProcessStat(pid, isFirstCollect, shiftCollectTime, &process.stat);
         if (ptr == nullptr) {
             continue;
         }
@@ -188,12 +181,14 @@ time_t ProcessEntityCollector::GetSortedProcess(std::vector<ExtendedProcessStatP
     LOG_DEBUG(sLogger, ("collect Process Cpu info, top", processStats.size()));
 
     mPrevProcessStat = std::move(newProcessStat);
-    mProcessSortTime = collectTime.GetShiftSteadyTime(processListInfo.collectTime);
-    return processListInfo.collectTime;
+    mProcessSortTime = collectTime.GetShiftSteadyTime(snapshot->collectTime);
+    return snapshot->collectTime;
 }
 
-ExtendedProcessStatPtr
-ProcessEntityCollector::GetProcessStat(pid_t pid, bool& isFirstCollect, const CollectTime& collectTime) {
+ExtendedProcessStatPtr ProcessEntityCollector::GetProcessStat(pid_t pid,
+                                                              bool& isFirstCollect,
+                                                              const CollectTime& collectTime,
+                                                              const ProcessStat* stat) {
     // TODO: more accurate cache
     auto prev = mPrevProcessStat.find(pid);
     if (prev == mPrevProcessStat.end() || prev->second == nullptr
@@ -209,7 +204,9 @@ ProcessEntityCollector::GetProcessStat(pid_t pid, bool& isFirstCollect, const Co
     }
     auto ptr = std::make_shared<ExtendedProcessStat>();
     ProcessInformation processInfo;
-    if (SystemInterface::GetInstance()->GetProcessInformation(collectTime.mMetricTime, pid, processInfo)) {
+    if (stat != nullptr) {
+        ptr->stat = *stat;
+    } else if (SystemInterface::GetInstance()->GetProcessInformation(collectTime.mMetricTime, pid, processInfo)) {
         ptr->stat = processInfo.stat;
     } else {
         LOG_ERROR(sLogger, ("failed to get process information", pid));
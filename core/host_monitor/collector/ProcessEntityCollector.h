@@ -69,7 +69,11 @@ private:
     system_clock::time_point TicksToUnixTime(int64_t startTicks);
     time_t
     GetSortedProcess(std::vector<ExtendedProcessStatPtr>& processStats, size_t topN, const CollectTime& collectTime);
-    ExtendedProcessStatPtr GetProcessStat(pid_t pid, bool& isFirstCollect, const CollectTime& collectTime);
+    // @stat is read from /proc if not given
+    ExtendedProcessStatPtr GetProcessStat(pid_t pid,
+                                          bool& isFirstCollect,
+                                          const CollectTime& collectTime,
+                                          const ProcessStat* stat = nullptr);
 
     std::string GetProcessEntityID(StringView pid, StringView createTime, StringView hostEntityID);
     void FetchDomainInfo(std::string& domain,
@@ -81,8 +85,6 @@ private:
     std::unordered_map<pid_t, ExtendedProcessStatPtr> mPrevProcessStat;
     ProcParser mProcParser;
 
-    const int mProcessSilentCount;
-
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class ProcessEntityCollectorUnittest;
 #endif
@@ -86,7 +86,13 @@ K8sMetadata::~K8sMetadata() {
 }
 
 K8sMetadata::K8sMetadata(size_t ipCacheSize, size_t cidCacheSize, size_t externalIpCacheSize)
-    : mIpCache(ipCacheSize, 20), mContainerCache(cidCacheSize, 20), mExternalIpCache(externalIpCacheSize, 20) {
+    : mIpCache(ipCacheSize, 20),
+      mContainerCache(cidCacheSize, 20),
+      mExternalIpCache(externalIpCacheSize, 20),
+      mExternalIpFilter(externalIpCacheSize),
+      mStandbyExternalIpFilter(externalIpCacheSize),
+      mActiveExternalIpFilter(&mExternalIpFilter),
+      mExternalIpCacheMaxSize(externalIpCacheSize) {
     mServiceHost = STRING_FLAG(k8s_metadata_server_name);
     mServicePort = INT32_FLAG(k8s_metadata_server_port);
     const char* value = getenv("_node_ip_");
@@ -410,7 +416,26 @@ void K8sMetadata::SetIpCache(const std::string& key, const std::shared_ptr<K8sPo
 
 void K8sMetadata::SetExternalIpCache(const std::string& ip) {
     LOG_DEBUG(sLogger, (ip, "is external, inset into cache ..."));
+    // the cache goes first, so that a concurrent rebuild of the standby filter either sees the ip or is followed by the
+    // addition below
     mExternalIpCache.insert(ip, uint8_t(0));
+    mExternalIpFilter.Add(ip);
+    mStandbyExternalIpFilter.Add(ip);
+    ++mExternalIpFilterAddCnt;
+}
+
+void K8sMetadata::RebuildExternalIpFilter() {
+    // ips evicted from the cache are still in the filters, and make it less effective, so the filters are rebuilt
+    // once as many ips as the cache can hold have been added
+    if (mExternalIpFilterAddCnt.load(std::memory_order_relaxed) < mExternalIpCacheMaxSize) {
+        return;
+    }
+    mExternalIpFilterAddCnt = 0;
+    auto* active = mActiveExternalIpFilter.load();
+    auto* standby = active == &mExternalIpFilter ? &mStandbyExternalIpFilter : &mExternalIpFilter;
+    standby->Clear();
+    mExternalIpCache.forEachKey([standby](StringView ip) { standby->Add(ip); });
+    mActiveExternalIpFilter = standby;
 }
 
 void K8sMetadata::UpdateExternalIpCache(const std::vector<std::string>& queryIps,
@@ -441,9 +466,8 @@ std::shared_ptr<K8sPodInfo> K8sMetadata::GetInfoByContainerIdFromCache(const Str
     if (containerId.empty()) {
         return nullptr;
     }
-    auto cid = std::string(containerId);
     std::shared_ptr<K8sPodInfo> info;
-    bool isValid = mContainerCache.tryGetCopy(cid, info);
+    bool isValid = mContainerCache.tryGetCopy(containerId, info);
     if (isValid) {
         return info;
     }
@@ -454,9 +478,8 @@ std::shared_ptr<K8sPodInfo> K8sMetadata::GetInfoByIpFromCache(const StringView&
     if (ipv.empty()) {
         return nullptr;
     }
-    auto ip = std::string(ipv);
     std::shared_ptr<K8sPodInfo> info;
-    bool isValid = mIpCache.tryGetCopy(ip, info);
+    bool isValid = mIpCache.tryGetCopy(ipv, info);
     if (isValid) {
         return info;
     }
@@ -464,7 +487,10 @@ std::shared_ptr<K8sPodInfo> K8sMetadata::GetInfoByIpFromCache(const StringView&
 }
 
 bool K8sMetadata::IsExternalIp(const StringView& ip) const {
-    return mExternalIpCache.contains(std::string(ip));
+    if (!mActiveExternalIpFilter.load(std::memory_order_acquire)->MayContain(ip)) {
+        return false;
+    }
+    return mExternalIpCache.contains(ip);
 }
 
 bool K8sMetadata::IsClusterIpForIPv4(uint32_t ip) const {
@@ -488,12 +514,13 @@ void K8sMetadata::AsyncQueryMetadata(PodInfoType type, const StringView& str) {
         LOG_DEBUG(sLogger, ("empty key", ""));
         return;
     }
-    std::string key = std::string(str);
     std::unique_lock<std::mutex> lock(mStateMux);
-    if (mPendingKeys.find(key) != mPendingKeys.end()) {
+    // keys missed in cache are queried again and again until the response arrives, and are only copied for the first
+    if (mPendingKeys.find(std::string_view(str.data(), str.size())) != mPendingKeys.end()) {
         // already in query queue ...
         return;
     }
+    std::string key = std::string(str);
     mPendingKeys.insert(key);
     if (type == PodInfoType::IpInfo) {
         mBatchKeys.push_back(key);
@@ -523,6 +550,7 @@ void K8sMetadata::DetectNetwork() {
         SET_GAUGE(mCidCacheSize, mContainerCache.size());
         SET_GAUGE(mIpCacheSize, mIpCache.size());
         SET_GAUGE(mExternalIpCacheSize, mExternalIpCache.size());
+        RebuildExternalIpFilter();
         if (mIsValid) {
             continue;
         }
@@ -536,7 +564,7 @@ void K8sMetadata::ProcessBatch() {
     auto batchProcessor = [this](auto&& processFunc,
                                  std::vector<std::string>& srcItems,
                                  std::vector<std::string>& pendingItems,
-                                 std::unordered_set<std::string>& pendingSet) {
+                                 std::set<std::string, std::less<>>& pendingSet) {
         if (!srcItems.empty()) {
             bool status = false;
             if (mIsValid) {
@@ -22,14 +22,16 @@
 #include <condition_variable>
 #include <iostream>
 #include <mutex>
+#include <set>
 #include <string>
 #include <unordered_set>
 
 #include "json/value.h"
 
+#include "common/BloomFilter.h"
 #include "common/Flags.h"
-#include "common/LRUCache.h"
 #include "common/NetworkUtil.h"
+#include "common/ShardedLRUCache.h"
 #include "common/StringView.h"
 #include "common/http/HttpRequest.h"
 #include "metadata/ContainerInfo.h"
@@ -57,9 +59,17 @@ struct K8sMetadataHttpRequest;
 
 class K8sMetadata {
 private:
-    lru11::Cache<std::string, std::shared_ptr<K8sPodInfo>, std::mutex> mIpCache;
-    lru11::Cache<std::string, std::shared_ptr<K8sPodInfo>, std::mutex> mContainerCache;
-    lru11::Cache<std::string, uint8_t, std::mutex> mExternalIpCache;
+    // looked up for every connection and span by ebpf threads, and updated only by responses of the metadata server
+    ShardedLRUCache<std::shared_ptr<K8sPodInfo>> mIpCache;
+    ShardedLRUCache<std::shared_ptr<K8sPodInfo>> mContainerCache;
+    ShardedLRUCache<uint8_t> mExternalIpCache;
+    // Most ips looked up are not external, which can be told by the filter without any lock. IPs are added to both
+    // filters, while the standby one is rebuilt from mExternalIpCache from time to time to forget evicted ips.
+    BloomFilter mExternalIpFilter;
+    BloomFilter mStandbyExternalIpFilter;
+    std::atomic<BloomFilter*> mActiveExternalIpFilter;
+    std::atomic_size_t mExternalIpFilterAddCnt = 0;
+    size_t mExternalIpCacheMaxSize = 0;
 
     std::string mServiceHost;
     int32_t mServicePort;
@@ -75,7 +85,8 @@ private:
     void ProcessBatch();
 
     mutable std::mutex mStateMux;
-    std::unordered_set<std::string> mPendingKeys; // 增加上限
+    // std::less<> allows lookup by string view, so that keys already pending are not copied
+    std::set<std::string, std::less<>> mPendingKeys; // 增加上限
 
     mutable std::condition_variable mCv;
     std::vector<std::string> mBatchKeys; // 增加上限
@@ -105,6 +116,7 @@ private:
     void SetIpCache(const std::string& key, const std::shared_ptr<K8sPodInfo>& info);
     void SetContainerCache(const std::string& key, const std::shared_ptr<K8sPodInfo>& info);
     void SetExternalIpCache(const std::string&);
+    void RebuildExternalIpFilter();
     void UpdateExternalIpCache(const std::vector<std::string>& queryIps, const std::vector<std::string>& retIps);
     bool FromInfoJson(const Json::Value& json, K8sPodInfo& info);
     bool FromContainerJson(const Json::Value& json, std::shared_ptr<ContainerData> data, PodInfoType infoType);
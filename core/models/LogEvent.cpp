@@ -16,9 +16,14 @@
 
 #include "models/LogEvent.h"
 
+#include <string_view>
+
 #include "common/Flags.h"
 
 DEFINE_FLAG_INT32(default_log_event_capacity, "", 16);
+DEFINE_FLAG_INT32(log_event_content_index_threshold,
+                  "build hash index for log contents when the number of contents reaches this value, 0 to disable",
+                  16);
 
 using namespace std;
 
@@ -41,6 +46,13 @@ void LogEvent::Reset() {
     } else {
         mContents.clear();
     }
+    if (mContentIndex.capacity() > static_cast<size_t>(4 * INT32_FLAG(default_log_event_capacity))) {
+        decltype(mContentIndex)().swap(mContentIndex);
+    } else {
+        mContentIndex.clear();
+    }
+    mContentIndexSize = 0;
+    mHasAppendedContent = false;
     mContentCnt = 0;
     mAllocatedContentSize = 0;
     mFileOffset = 0;
@@ -48,20 +60,15 @@ void LogEvent::Reset() {
 }
 
 StringView LogEvent::GetContent(StringView key) const {
-    auto it = std::find_if(mContents.crbegin(), mContents.crend(), [&key](const auto& item) {
-        return item.first.first == key && item.second;
-    });
-    if (it == mContents.crend()) {
+    size_t pos = FindContentPos(key, HashContentKey(key));
+    if (pos == mContents.size()) {
         return gEmptyStringView;
     }
-    return it->first.second;
+    return mContents[pos].first.second;
 }
 
 bool LogEvent::HasContent(StringView key) const {
-    auto it = std::find_if(mContents.crbegin(), mContents.crend(), [&key](const auto& item) {
-        return item.first.first == key && item.second;
-    });
-    return it != mContents.crend();
+    return FindContentPos(key, HashContentKey(key)) != mContents.size();
 }
 
 void LogEvent::SetContent(StringView key, StringView val) {
@@ -81,27 +88,46 @@ void LogEvent::SetContentNoCopy(const StringBuffer& key, const StringBuffer& val
 }
 
 void LogEvent::SetContentNoCopy(StringView key, StringView val) {
-    auto it = std::find_if(mContents.rbegin(), mContents.rend(), [&key](const auto& item) {
-        return item.first.first == key && item.second;
-    });
-    if (it != mContents.rend()) {
-        mAllocatedContentSize += key.size() + val.size() - it->first.first.size() - it->first.second.size();
-        it->first = make_pair(key, val);
+    uint32_t hash = HashContentKey(key);
+    size_t pos = FindContentPos(key, hash);
+    if (pos != mContents.size()) {
+        auto& content = mContents[pos].first;
+        mAllocatedContentSize += key.size() + val.size() - content.first.size() - content.second.size();
+        content = make_pair(key, val);
     } else {
         ++mContentCnt;
         mAllocatedContentSize += key.size() + val.size();
         mContents.emplace_back(make_pair(key, val), true);
+        if (!mContentIndex.empty()) {
+            InsertContentIndex(hash, pos);
+        } else if (INT32_FLAG(log_event_content_index_threshold) > 0
+                   && mContents.size() >= static_cast<size_t>(INT32_FLAG(log_event_content_index_threshold))) {
+            BuildContentIndex();
+        }
     }
 }
 
 void LogEvent::DelContent(StringView key) {
-    auto it = std::find_if(mContents.rbegin(), mContents.rend(), [&key](const auto& item) {
-        return item.first.first == key && item.second;
-    });
-    if (it != mContents.rend()) {
-        it->second = false;
+    uint32_t hash = HashContentKey(key);
+    size_t pos = mContents.size();
+    if (mContentIndex.empty()) {
+        pos = FindContentPos(key, hash);
+    } else {
+        size_t slot = FindContentIndexSlot(key, hash);
+        if (slot != mContentIndex.size()) {
+            pos = mContentIndex[slot].second - 1;
+            EraseContentIndex(slot);
+        }
+    }
+    if (pos != mContents.size()) {
+        auto& content = mContents[pos];
+        content.second = false;
         --mContentCnt;
-        mAllocatedContentSize -= it->first.first.size() + it->first.second.size();
+        mAllocatedContentSize -= content.first.first.size() + content.first.second.size();
+        if (mHasAppendedContent && !mContentIndex.empty()) {
+            // an earlier content with the same key may become visible again
+            BuildContentIndex();
+        }
     }
 }
 
@@ -111,23 +137,13 @@ void LogEvent::SetLevel(const std::string& level) {
 }
 
 LogEvent::ContentIterator LogEvent::FindContent(StringView key) {
-    auto it = std::find_if(mContents.rbegin(), mContents.rend(), [&key](const auto& item) {
-        return item.first.first == key && item.second;
-    });
-    if (it != mContents.rend()) {
-        return ContentIterator(it.base() - 1, mContents);
-    }
-    return ContentIterator(mContents.end(), mContents);
+    size_t pos = FindContentPos(key, HashContentKey(key));
+    return ContentIterator(mContents.begin() + pos, mContents);
 }
 
 LogEvent::ConstContentIterator LogEvent::FindContent(StringView key) const {
-    auto it = std::find_if(mContents.crbegin(), mContents.crend(), [&key](const auto& item) {
-        return item.first.first == key && item.second;
-    });
-    if (it != mContents.crend()) {
-        return ConstContentIterator(it.base() - 1, mContents);
-    }
-    return ConstContentIterator(mContents.end(), mContents);
+    size_t pos = FindContentPos(key, HashContentKey(key));
+    return ConstContentIterator(mContents.cbegin() + pos, mContents);
 }
 
 LogEvent::ContentIterator LogEvent::begin() {
@@ -160,6 +176,94 @@ void LogEvent::AppendContentNoCopy(StringView key, StringView val) {
     ++mContentCnt;
     mAllocatedContentSize += key.size() + val.size();
     mContents.emplace_back(make_pair(key, val), true);
+    mHasAppendedContent = true;
+    if (!mContentIndex.empty()) {
+        InsertContentIndex(HashContentKey(key), mContents.size() - 1);
+    } else if (INT32_FLAG(log_event_content_index_threshold) > 0
+               && mContents.size() >= static_cast<size_t>(INT32_FLAG(log_event_content_index_threshold))) {
+        BuildContentIndex();
+    }
+}
+
+uint32_t LogEvent::HashContentKey(StringView key) {
+    return static_cast<uint32_t>(hash<string_view>()(string_view(key.data(), key.size())));
+}
+
+// returns mContents.size() if not found
+size_t LogEvent::FindContentPos(StringView key, uint32_t hash) const {
+    if (mContentIndex.empty()) {
+        for (size_t i = mContents.size(); i > 0; --i) {
+            const auto& item = mContents[i - 1];
+            if (item.second && item.first.first == key) {
+                return i - 1;
+            }
+        }
+        return mContents.size();
+    }
+    size_t slot = FindContentIndexSlot(key, hash);
+    return slot == mContentIndex.size() ? mContents.size() : mContentIndex[slot].second - 1;
+}
+
+// returns mContentIndex.size() if not found
+size_t LogEvent::FindContentIndexSlot(StringView key, uint32_t hash) const {
+    size_t mask = mContentIndex.size() - 1;
+    for (size_t slot = hash & mask; mContentIndex[slot].second != 0; slot = (slot + 1) & mask) {
+        if (mContentIndex[slot].first == hash && mContents[mContentIndex[slot].second - 1].first.first == key) {
+            return slot;
+        }
+    }
+    return mContentIndex.size();
+}
+
+void LogEvent::BuildContentIndex() {
+    // keep load factor below 0.5 so that probe sequences stay short
+    size_t cap = 32;
+    while (cap < mContents.size() * 4) {
+        cap <<= 1;
+    }
+    mContentIndex.assign(cap, {0, 0});
+    mContentIndexSize = 0;
+    for (size_t i = 0; i < mContents.size(); ++i) {
+        if (mContents[i].second) {
+            InsertContentIndex(HashContentKey(mContents[i].first.first), i);
+        }
+    }
+}
+
+void LogEvent::InsertContentIndex(uint32_t hash, size_t pos) {
+    if ((mContentIndexSize + 1) * 2 > mContentIndex.size()) {
+        // pos has already been added to mContents, so rebuilding covers it
+        BuildContentIndex();
+        return;
+    }
+    size_t mask = mContentIndex.size() - 1;
+    size_t slot = hash & mask;
+    for (; mContentIndex[slot].second != 0; slot = (slot + 1) & mask) {
+        if (mContentIndex[slot].first == hash
+            && mContents[mContentIndex[slot].second - 1].first.first == mContents[pos].first.first) {
+            // only happens for appended contents with duplicate keys, where the latest one wins
+            mContentIndex[slot].second = static_cast<uint32_t>(pos + 1);
+            return;
+        }
+    }
+    mContentIndex[slot] = {hash, static_cast<uint32_t>(pos + 1)};
+    ++mContentIndexSize;
+}
+
+void LogEvent::EraseContentIndex(size_t slot) {
+    // backward shift deletion, so that no tombstone is needed in the index
+    size_t mask = mContentIndex.size() - 1;
+    size_t hole = slot;
+    for (size_t next = (hole + 1) & mask; mContentIndex[next].second != 0; next = (next + 1) & mask) {
+        size_t home = mContentIndex[next].first & mask;
+        bool movable = next > hole ? (home <= hole || home > next) : (home <= hole && home > next);
+        if (movable) {
+            mContentIndex[hole] = mContentIndex[next];
+            hole = next;
+        }
+    }
+    mContentIndex[hole] = {0, 0};
+    --mContentIndexSize;
 }
 
 size_t LogEvent::DataSize() const {
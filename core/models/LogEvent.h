@@ -117,9 +117,22 @@ private:
     friend class ProcessorParseApsaraNative;
     void AppendContentNoCopy(StringView key, StringView val);
 
+    static uint32_t HashContentKey(StringView key);
+    size_t FindContentPos(StringView key, uint32_t hash) const;
+    size_t FindContentIndexSlot(StringView key, uint32_t hash) const;
+    void BuildContentIndex();
+    void InsertContentIndex(uint32_t hash, size_t pos);
+    void EraseContentIndex(size_t slot);
+
     // since log reduce in SLS server requires the original order of log contents, we have to maintain this sequential
     // information for backward compatability.
     ContentsContainer mContents;
+    // hash index from key to the position of the latest valid content in mContents, so that wide events do not need
+    // linear scans on each access. It is built once the number of contents reaches log_event_content_index_threshold,
+    // and is empty otherwise. Each slot holds the key hash and the position plus 1, or 0 if the slot is free.
+    std::vector<std::pair<uint32_t, uint32_t>> mContentIndex;
+    size_t mContentIndexSize = 0;
+    bool mHasAppendedContent = false;
     size_t mAllocatedContentSize = 0;
     size_t mContentCnt = 0;
     uint64_t mFileOffset = 0;
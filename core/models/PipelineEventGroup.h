@@ -61,6 +61,7 @@ enum class EventGroupMetaKey {
     PROMETHEUS_UP_STATE,
     PROMETHEUS_STREAM_ID,
     PROMETHEUS_STREAM_TOTAL,
+    PROMETHEUS_METRIC_RELABELED,
 
     INTERNAL_DATA_TARGET_REGION,
     INTERNAL_DATA_TYPE,
@@ -23,6 +23,7 @@ const string METRIC_RUNNER_TIMER_OUT_ITEMS_TOTAL = "out_items_total";
 const string METRIC_RUNNER_TIMER_IN_ITEMS_TOTAL = "in_items_total";
 const string METRIC_RUNNER_TIMER_LATENCY_TIME_MS = "latency_time_ms";
 const string METRIC_RUNNER_TIMER_QUEUE_ITEMS_TOTAL = "queue_items_total";
+const string METRIC_RUNNER_TIMER_DISPATCH_LAG_MS = "dispatch_lag_ms";
 
 // Host monitor runner metrics
 const string METRIC_RUNNER_HOST_MONITOR_OUT_ITEMS_TOTAL = "out_items_total";
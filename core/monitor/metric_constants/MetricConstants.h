@@ -61,6 +61,7 @@ extern const std::string METRIC_PIPELINE_PROCESSORS_IN_EVENTS_TOTAL;
 extern const std::string METRIC_PIPELINE_PROCESSORS_IN_EVENT_GROUPS_TOTAL;
 extern const std::string METRIC_PIPELINE_PROCESSORS_IN_SIZE_BYTES;
 extern const std::string METRIC_PIPELINE_PROCESSORS_TOTAL_PROCESS_TIME_MS;
+extern const std::string METRIC_PIPELINE_PROCESSORS_PROCESS_TIME_MS;
 extern const std::string METRIC_PIPELINE_FLUSHERS_IN_EVENTS_TOTAL;
 extern const std::string METRIC_PIPELINE_FLUSHERS_IN_EVENT_GROUPS_TOTAL;
 extern const std::string METRIC_PIPELINE_FLUSHERS_IN_SIZE_BYTES;
@@ -250,6 +251,7 @@ extern const std::string& METRIC_COMPONENT_OUT_EVENTS_TOTAL;
 extern const std::string& METRIC_COMPONENT_OUT_ITEMS_TOTAL;
 extern const std::string& METRIC_COMPONENT_OUT_SIZE_BYTES;
 extern const std::string& METRIC_COMPONENT_TOTAL_DELAY_MS;
+extern const std::string METRIC_COMPONENT_DELAY_MS;
 extern const std::string& METRIC_COMPONENT_TOTAL_PROCESS_TIME_MS;
 extern const std::string& METRIC_COMPONENT_DISCARDED_ITEMS_TOTAL;
 extern const std::string& METRIC_COMPONENT_DISCARDED_SIZE_BYTES;
@@ -262,6 +264,7 @@ extern const std::string METRIC_COMPONENT_BATCHER_BUFFERED_GROUPS_TOTAL;
 extern const std::string METRIC_COMPONENT_BATCHER_BUFFERED_EVENTS_TOTAL;
 extern const std::string METRIC_COMPONENT_BATCHER_BUFFERED_SIZE_BYTES;
 extern const std::string METRIC_COMPONENT_BATCHER_TOTAL_ADD_TIME_MS;
+extern const std::string METRIC_COMPONENT_BATCHER_ADD_TIME_MS;
 
 /**********************************************************
  *   queue
@@ -293,11 +296,13 @@ extern const std::string METRIC_LABEL_KEY_THREAD_NO;
 extern const std::string METRIC_LABEL_VALUE_RUNNER_NAME_FILE_SERVER;
 extern const std::string METRIC_LABEL_VALUE_RUNNER_NAME_FLUSHER;
 extern const std::string METRIC_LABEL_VALUE_RUNNER_NAME_HTTP_SINK;
+extern const std::string METRIC_LABEL_VALUE_RUNNER_NAME_HTTP_SINK_WORKER;
 extern const std::string METRIC_LABEL_VALUE_RUNNER_NAME_PROCESSOR;
 extern const std::string METRIC_LABEL_VALUE_RUNNER_NAME_PROMETHEUS;
 extern const std::string METRIC_LABEL_VALUE_RUNNER_NAME_EBPF_SERVER;
 extern const std::string METRIC_LABEL_VALUE_RUNNER_NAME_K8S_METADATA;
 extern const std::string METRIC_LABEL_VALUE_RUNNER_NAME_STATIC_FILE_SERVER;
+extern const std::string METRIC_LABEL_VALUE_RUNNER_NAME_CHUNK_POOL;
 
 // metric keys
 extern const std::string& METRIC_RUNNER_IN_EVENTS_TOTAL;
@@ -319,15 +324,25 @@ extern const std::string METRIC_RUNNER_SINK_OUT_SUCCESSFUL_ITEMS_TOTAL;
 extern const std::string METRIC_RUNNER_SINK_OUT_FAILED_ITEMS_TOTAL;
 extern const std::string METRIC_RUNNER_SINK_SUCCESSFUL_ITEM_TOTAL_RESPONSE_TIME_MS;
 extern const std::string METRIC_RUNNER_SINK_FAILED_ITEM_TOTAL_RESPONSE_TIME_MS;
+extern const std::string METRIC_RUNNER_SINK_RESPONSE_TIME_MS;
 extern const std::string METRIC_RUNNER_SINK_SENDING_ITEMS_TOTAL;
 extern const std::string METRIC_RUNNER_SINK_SEND_CONCURRENCY;
 
+/**********************************************************
+ *   processor runner
+ **********************************************************/
+extern const std::string METRIC_RUNNER_PROCESSOR_POP_BATCHES_TOTAL;
+extern const std::string METRIC_RUNNER_PROCESSOR_POPPED_ITEMS_TOTAL;
+extern const std::string METRIC_RUNNER_PROCESSOR_PROCESS_TIME_MS;
+
 /**********************************************************
  *   flusher runner
  **********************************************************/
 extern const std::string METRIC_RUNNER_FLUSHER_IN_RAW_SIZE_BYTES;
 extern const std::string METRIC_RUNNER_FLUSHER_OUT_RAW_SIZE_BYTES;
 extern const std::string METRIC_RUNNER_FLUSHER_WAITING_ITEMS_TOTAL;
+extern const std::string METRIC_RUNNER_FLUSHER_SENDING_SLOT_WAIT_MS;
+extern const std::string METRIC_RUNNER_FLUSHER_DISPATCH_DELAY_MS;
 
 /**********************************************************
  *   file server
@@ -358,6 +373,13 @@ extern const std::string METRIC_RUNNER_EBPF_LOST_KERNEL_EVENTS_TOTAL;
 extern const std::string METRIC_RUNNER_EBPF_CONNECTION_CACHE_SIZE;
 extern const std::string METRIC_RUNNER_EBPF_LOST_LOG_EVENTS_TOTAL;
 
+/**********************************************************
+ *   source buffer chunk pool
+ **********************************************************/
+extern const std::string METRIC_RUNNER_CHUNK_POOL_HIT_TOTAL;
+extern const std::string METRIC_RUNNER_CHUNK_POOL_MISS_TOTAL;
+extern const std::string METRIC_RUNNER_CHUNK_POOL_RETAINED_SIZE_BYTES;
+
 /**********************************************************
  *   k8s metadata
  **********************************************************/
@@ -374,6 +396,7 @@ extern const std::string METRIC_RUNNER_TIMER_OUT_ITEMS_TOTAL;
 extern const std::string METRIC_RUNNER_TIMER_IN_ITEMS_TOTAL;
 extern const std::string METRIC_RUNNER_TIMER_LATENCY_TIME_MS;
 extern const std::string METRIC_RUNNER_TIMER_QUEUE_ITEMS_TOTAL;
+extern const std::string METRIC_RUNNER_TIMER_DISPATCH_LAG_MS;
 
 /**********************************************************
  *   host monitor runner
@@ -27,11 +27,13 @@ const string METRIC_LABEL_KEY_THREAD_NO = "thread_no";
 const string METRIC_LABEL_VALUE_RUNNER_NAME_FILE_SERVER = "file_server";
 const string METRIC_LABEL_VALUE_RUNNER_NAME_FLUSHER = "flusher_runner";
 const string METRIC_LABEL_VALUE_RUNNER_NAME_HTTP_SINK = "http_sink";
+const string METRIC_LABEL_VALUE_RUNNER_NAME_HTTP_SINK_WORKER = "http_sink_worker";
 const string METRIC_LABEL_VALUE_RUNNER_NAME_PROCESSOR = "processor_runner";
 const string METRIC_LABEL_VALUE_RUNNER_NAME_PROMETHEUS = "prometheus_runner";
 const string METRIC_LABEL_VALUE_RUNNER_NAME_EBPF_SERVER = "ebpf_runner";
 const string METRIC_LABEL_VALUE_RUNNER_NAME_K8S_METADATA = "k8s_metadata_runner";
 const string METRIC_LABEL_VALUE_RUNNER_NAME_STATIC_FILE_SERVER = "static_file_server";
+const string METRIC_LABEL_VALUE_RUNNER_NAME_CHUNK_POOL = "source_buffer_chunk_pool";
 
 // metric keys
 const string& METRIC_RUNNER_IN_EVENTS_TOTAL = METRIC_IN_EVENTS_TOTAL;
@@ -53,15 +55,25 @@ const string METRIC_RUNNER_SINK_OUT_SUCCESSFUL_ITEMS_TOTAL = "out_successful_ite
 const string METRIC_RUNNER_SINK_OUT_FAILED_ITEMS_TOTAL = "out_failed_items_total";
 const string METRIC_RUNNER_SINK_SUCCESSFUL_ITEM_TOTAL_RESPONSE_TIME_MS = "successful_response_time_ms";
 const string METRIC_RUNNER_SINK_FAILED_ITEM_TOTAL_RESPONSE_TIME_MS = "failed_response_time_ms";
+const string METRIC_RUNNER_SINK_RESPONSE_TIME_MS = "response_time_ms";
 const string METRIC_RUNNER_SINK_SENDING_ITEMS_TOTAL = "sending_items_total";
 const string METRIC_RUNNER_SINK_SEND_CONCURRENCY = "send_concurrency";
 
+/**********************************************************
+ *   processor runner
+ **********************************************************/
+const string METRIC_RUNNER_PROCESSOR_POP_BATCHES_TOTAL = "pop_batches_total";
+const string METRIC_RUNNER_PROCESSOR_POPPED_ITEMS_TOTAL = "popped_items_total";
+const string METRIC_RUNNER_PROCESSOR_PROCESS_TIME_MS = "process_time_ms";
+
 /**********************************************************
  *   flusher runner
  **********************************************************/
 const string METRIC_RUNNER_FLUSHER_IN_RAW_SIZE_BYTES = "in_raw_size_bytes";
 const string METRIC_RUNNER_FLUSHER_OUT_RAW_SIZE_BYTES = "out_raw_size_bytes";
 const string METRIC_RUNNER_FLUSHER_WAITING_ITEMS_TOTAL = "waiting_items_total";
+const string METRIC_RUNNER_FLUSHER_SENDING_SLOT_WAIT_MS = "sending_slot_wait_ms";
+const string METRIC_RUNNER_FLUSHER_DISPATCH_DELAY_MS = "dispatch_delay_ms";
 
 /**********************************************************
  *   file server
@@ -92,6 +104,13 @@ const string METRIC_RUNNER_EBPF_LOST_KERNEL_EVENTS_TOTAL = "lost_kernel_event_to
 const string METRIC_RUNNER_EBPF_CONNECTION_CACHE_SIZE = "connection_cache_size";
 const string METRIC_RUNNER_EBPF_LOST_LOG_EVENTS_TOTAL = "lost_log_event_total";
 
+/**********************************************************
+ *   source buffer chunk pool
+ **********************************************************/
+const string METRIC_RUNNER_CHUNK_POOL_HIT_TOTAL = "hit_total";
+const string METRIC_RUNNER_CHUNK_POOL_MISS_TOTAL = "miss_total";
+const string METRIC_RUNNER_CHUNK_POOL_RETAINED_SIZE_BYTES = "retained_size_bytes";
+
 /**********************************************************
  *   k8s metadata
  **********************************************************/
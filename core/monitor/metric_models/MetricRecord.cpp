@@ -72,6 +72,15 @@ DoubleGaugePtr MetricsRecord::CreateDoubleGauge(const std::string& name) {
     return gaugePtr;
 }
 
+HistogramPtr MetricsRecord::CreateHistogram(const std::string& name) {
+    if (mCommitted) {
+        return nullptr;
+    }
+    HistogramPtr histogramPtr = std::make_shared<Histogram>(name);
+    mHistograms.emplace_back(histogramPtr);
+    return histogramPtr;
+}
+
 void MetricsRecord::AddLabels(MetricLabels&& labels) {
     if (mCommitted) {
         return;
@@ -123,6 +132,10 @@ const std::vector<DoubleGaugePtr>& MetricsRecord::GetDoubleGauges() const {
     return mDoubleGauges;
 }
 
+const std::vector<HistogramPtr>& MetricsRecord::GetHistograms() const {
+    return mHistograms;
+}
+
 MetricsRecord* MetricsRecord::Collect() {
     auto* metrics = new MetricsRecord(mCategory, mLabels, mDynamicLabels);
     for (auto& item : mCounters) {
@@ -141,6 +154,10 @@ MetricsRecord* MetricsRecord::Collect() {
         DoubleGaugePtr newPtr(item->Collect());
         metrics->mDoubleGauges.emplace_back(newPtr);
     }
+    for (auto& item : mHistograms) {
+        HistogramPtr newPtr(item->Collect());
+        metrics->mHistograms.emplace_back(newPtr);
+    }
     return metrics;
 }
 
@@ -196,6 +213,10 @@ DoubleGaugePtr MetricsRecordRef::CreateDoubleGauge(const std::string& name) {
     return mMetrics->CreateDoubleGauge(name);
 }
 
+HistogramPtr MetricsRecordRef::CreateHistogram(const std::string& name) {
+    return mMetrics->CreateHistogram(name);
+}
+
 void MetricsRecordRef::AddLabels(MetricLabels&& labels) {
     mMetrics->AddLabels(std::move(labels));
 }
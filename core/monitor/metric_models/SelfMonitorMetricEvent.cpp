@@ -29,6 +29,11 @@ const string METRIC_GO_KEY_LABELS = "labels";
 const string METRIC_GO_KEY_COUNTERS = "counters";
 const string METRIC_GO_KEY_GAUGES = "gauges";
 
+const string METRIC_HISTOGRAM_SUFFIX_COUNT = "_count";
+const string METRIC_HISTOGRAM_SUFFIX_SUM = "_sum";
+const string METRIC_HISTOGRAM_SUFFIX_MAX = "_max";
+const vector<pair<string, double>> METRIC_HISTOGRAM_QUANTILES = {{"_p50", 0.5}, {"_p90", 0.9}, {"_p99", 0.99}};
+
 SelfMonitorMetricEvent::SelfMonitorMetricEvent(MetricsRecord* metricRecord) : mCategory(metricRecord->GetCategory()) {
     // labels
     for (auto item = metricRecord->GetLabels()->begin(); item != metricRecord->GetLabels()->end(); ++item) {
@@ -55,6 +60,12 @@ SelfMonitorMetricEvent::SelfMonitorMetricEvent(MetricsRecord* metricRecord) : mC
     for (const auto& item : metricRecord->GetDoubleGauges()) {
         mGauges[item->GetName()] = item->GetValue();
     }
+    // histograms
+    for (const auto& item : metricRecord->GetHistograms()) {
+        mHistograms[item->GetName()] = item->GetBuckets();
+        mHistogramSums[item->GetName()] = item->GetSum();
+        mHistogramMaxes[item->GetName()] = item->GetMax();
+    }
     CreateKey();
 }
 
@@ -147,6 +158,20 @@ void SelfMonitorMetricEvent::Merge(const SelfMonitorMetricEvent& event) {
     for (auto gauge = event.mGauges.begin(); gauge != event.mGauges.end(); gauge++) {
         mGauges[gauge->first] = gauge->second;
     }
+    for (const auto& histogram : event.mHistograms) {
+        auto& buckets = mHistograms[histogram.first];
+        buckets.resize(max(buckets.size(), histogram.second.size()));
+        for (size_t i = 0; i < histogram.second.size(); ++i) {
+            buckets[i] += histogram.second[i];
+        }
+    }
+    for (const auto& histogramSum : event.mHistogramSums) {
+        mHistogramSums[histogramSum.first] += histogramSum.second;
+    }
+    for (const auto& histogramMax : event.mHistogramMaxes) {
+        auto& max = mHistogramMaxes[histogramMax.first];
+        max = std::max(max, histogramMax.second);
+    }
     mUpdatedFlag = true;
 }
 
@@ -179,6 +204,34 @@ void SelfMonitorMetricEvent::ReadAsMetricEvent(MetricEvent* metricEventPtr) {
         metricEventPtr->MutableValue<UntypedMultiDoubleValues>()->SetValue(
             gauge->first, {UntypedValueMetricType::MetricTypeGauge, gauge->second});
     }
+    // histograms are exported as the count, sum, quantiles and max of the values observed since last read
+    for (auto& histogram : mHistograms) {
+        uint64_t cnt = 0;
+        for (auto bucket : histogram.second) {
+            cnt += bucket;
+        }
+        metricEventPtr->MutableValue<UntypedMultiDoubleValues>()->SetValue(
+            histogram.first + METRIC_HISTOGRAM_SUFFIX_COUNT,
+            {UntypedValueMetricType::MetricTypeCounter, static_cast<double>(cnt)});
+        for (const auto& quantile : METRIC_HISTOGRAM_QUANTILES) {
+            metricEventPtr->MutableValue<UntypedMultiDoubleValues>()->SetValue(
+                histogram.first + quantile.first,
+                {UntypedValueMetricType::MetricTypeGauge, Histogram::GetQuantile(histogram.second, quantile.second)});
+        }
+        fill(histogram.second.begin(), histogram.second.end(), 0);
+    }
+    for (auto& histogramSum : mHistogramSums) {
+        metricEventPtr->MutableValue<UntypedMultiDoubleValues>()->SetValue(
+            histogramSum.first + METRIC_HISTOGRAM_SUFFIX_SUM,
+            {UntypedValueMetricType::MetricTypeCounter, histogramSum.second / 1000.0});
+        histogramSum.second = 0;
+    }
+    for (auto& histogramMax : mHistogramMaxes) {
+        metricEventPtr->MutableValue<UntypedMultiDoubleValues>()->SetValue(
+            histogramMax.first + METRIC_HISTOGRAM_SUFFIX_MAX,
+            {UntypedValueMetricType::MetricTypeGauge, histogramMax.second / 1000.0});
+        histogramMax.second = 0;
+    }
     // set flags
     mIntervalsSinceLastSend = 0;
     mUpdatedFlag = false;
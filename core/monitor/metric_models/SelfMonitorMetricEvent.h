@@ -65,6 +65,12 @@ private:
     std::unordered_map<std::string, std::string> mLabels;
     std::unordered_map<std::string, uint64_t> mCounters;
     std::unordered_map<std::string, double> mGauges;
+    // bucket counts of histograms, exported as quantiles
+    std::unordered_map<std::string, std::vector<uint64_t>> mHistograms;
+    // sums of histograms in microseconds
+    std::unordered_map<std::string, uint64_t> mHistogramSums;
+    // max values of histograms in microseconds
+    std::unordered_map<std::string, uint64_t> mHistogramMaxes;
     int32_t mSendInterval = 0;
     int32_t mIntervalsSinceLastSend = 0;
     bool mUpdatedFlag = false;
@@ -18,7 +18,9 @@
 
 #include <cstring>
 
+#include <map>
 #include <sstream>
+#include <vector>
 
 #include "collection_pipeline/CollectionPipeline.h"
 #include "collection_pipeline/batch/BatchedEvents.h"
@@ -103,6 +105,31 @@ bool FlusherKafka::Init(const Json::Value& config, Json::Value& optionalGoPipeli
                            mContext->GetRegion());
     }
 
+    // Batch
+    const char* key = "Batch";
+    const Json::Value* itr = config.find(key, key + strlen(key));
+    if (itr) {
+        if (!itr->isObject()) {
+            PARAM_WARNING_IGNORE(mContext->GetLogger(),
+                                 mContext->GetAlarm(),
+                                 "param Batch is not of type object",
+                                 sName,
+                                 mContext->GetConfigName(),
+                                 mContext->GetProjectName(),
+                                 mContext->GetLogstoreName(),
+                                 mContext->GetRegion());
+        } else {
+            DefaultFlushStrategyOptions strategy{KAFKA_BATCH_MAX_SIZE_BYTES,
+                                                 KAFKA_BATCH_MIN_SIZE_BYTES,
+                                                 mKafkaConfig.BulkMaxSize,
+                                                 KAFKA_BATCH_TIMEOUT_SECS};
+            if (!mBatcher.Init(*itr, this, strategy)) {
+                return false;
+            }
+            mBatchEnabled = true;
+        }
+    }
+
     if (!mProducer->Init(mKafkaConfig)) {
         LOG_ERROR(mContext->GetLogger(), ("failed to init kafka producer", ""));
         return false;
@@ -142,10 +169,28 @@ bool FlusherKafka::Stop(bool isPipelineRemoving) {
 }
 
 bool FlusherKafka::Send(PipelineEventGroup&& g) {
-    return SerializeAndSend(std::move(g));
+    if (mBatchEnabled) {
+        vector<BatchedEventsList> res;
+        mBatcher.Add(std::move(g), res);
+        return SerializeAndSend(std::move(res));
+    }
+    BatchedEvents batch(std::move(g.MutableEvents()),
+                        std::move(g.GetSizedTags()),
+                        std::move(g.GetSourceBuffer()),
+                        g.GetMetadata(EventGroupMetaKey::SOURCE_ID),
+                        std::move(g.GetExactlyOnceCheckpoint()));
+    for (const auto& extraSourceBuffer : g.GetExtraSourceBuffers()) {
+        batch.mSourceBuffers.emplace_back(extraSourceBuffer);
+    }
+    return SerializeAndSend(std::move(batch));
 }
 
 bool FlusherKafka::Flush(size_t key) {
+    if (mBatchEnabled) {
+        BatchedEventsList res;
+        mBatcher.FlushQueue(key, res);
+        return SerializeAndSend(std::move(res));
+    }
     if (mProducer) {
         return mProducer->Flush(KAFKA_FLUSH_TIMEOUT_MS);
     }
@@ -153,53 +198,64 @@ bool FlusherKafka::Flush(size_t key) {
 }
 
 bool FlusherKafka::FlushAll() {
-    return Flush(0);
+    bool res = true;
+    if (mBatchEnabled) {
+        vector<BatchedEventsList> groupLists;
+        mBatcher.FlushAll(groupLists);
+        res = SerializeAndSend(std::move(groupLists));
+    }
+    if (mProducer) {
+        res = mProducer->Flush(KAFKA_FLUSH_TIMEOUT_MS) && res;
+    }
+    return res;
 }
 
-bool FlusherKafka::SerializeAndSend(PipelineEventGroup&& group) {
+bool FlusherKafka::SerializeAndSend(BatchedEvents&& batch) {
     if (!mProducer) {
         LOG_ERROR(mContext->GetLogger(), ("kafka producer not initialized", ""));
         return false;
     }
 
-    auto events = std::move(group.MutableEvents());
-
     const bool isDynamicTopic = mTopicFormatter.IsDynamic();
-    const auto& sizedTags = group.GetSizedTags();
-    auto& sourceBuffer = group.GetSourceBuffer();
-    auto& checkpoint = group.GetExactlyOnceCheckpoint();
+    const bool isHashPartitioner = mKafkaConfig.PartitionerType == PARTITIONER_HASH;
 
-    bool allSuccess = true;
-    std::string serializedData;
-    std::string errorMsg;
+    map<string, vector<KafkaProducer::Message>> messagesByTopic;
+    vector<KafkaProducer::Message>* messages = nullptr;
+    if (!isDynamicTopic) {
+        messages = &messagesByTopic[mExpandedTopic];
+        messages->reserve(batch.mEvents.size());
+    }
 
-    for (auto& event : events) {
-        errorMsg.clear();
-        serializedData.clear();
+    // events are serialized one at a time through a single-event batch, which shares the tags of the whole batch
+    BatchedEvents single;
+    single.mTags = batch.mTags;
+    single.mEvents.reserve(1);
 
-        std::string topic = mExpandedTopic;
+    bool allSuccess = true;
+    string errorMsg;
+    for (auto& event : batch.mEvents) {
         if (isDynamicTopic) {
-            if (!mTopicFormatter.Format(event, group.GetTags(), topic)) {
+            string topic = mExpandedTopic;
+            if (!mTopicFormatter.Format(event, batch.mTags.mInner, topic)) {
                 topic = mExpandedTopic;
                 LOG_ERROR(mContext->GetLogger(), ("Failed to format dynamic topic from template", mExpandedTopic));
             }
+            messages = &messagesByTopic[topic];
         }
 
-        std::string partitionKey;
-        if (mKafkaConfig.PartitionerType == PARTITIONER_HASH) {
-            partitionKey = GeneratePartitionKey(event);
+        KafkaProducer::Message message;
+        if (isHashPartitioner) {
+            message.key = GeneratePartitionKey(event);
         }
 
-        BatchedEvents batchedEvents;
-        batchedEvents.mEvents.reserve(1);
-        batchedEvents.mEvents.emplace_back(std::move(event));
-        batchedEvents.mTags = sizedTags;
-        batchedEvents.mSourceBuffers.emplace_back(sourceBuffer);
-        batchedEvents.mExactlyOnceCheckpoint = checkpoint;
-
-        if (!mSerializer->DoSerialize(std::move(batchedEvents), serializedData, errorMsg)) {
-            LOG_ERROR(mContext->GetLogger(),
-                      ("failed to serialize events", errorMsg)("topic", topic)("action", "discard data"));
+        errorMsg.clear();
+        single.mEvents.emplace_back(std::move(event));
+        bool res = mSerializer->DoSerialize(std::move(single), message.value, errorMsg);
+        // serializers only read the events, so the event is taken back to be released along with the batch
+        event = std::move(single.mEvents.back());
+        single.mEvents.clear();
+        if (!res) {
+            LOG_ERROR(mContext->GetLogger(), ("failed to serialize events", errorMsg)("action", "discard data"));
             mContext->GetAlarm().SendAlarmCritical(SERIALIZE_FAIL_ALARM,
                                                    "failed to serialize events: " + errorMsg + "\taction: discard data",
                                                    mContext->GetRegion(),
@@ -210,63 +266,83 @@ bool FlusherKafka::SerializeAndSend(PipelineEventGroup&& group) {
             allSuccess = false;
             continue;
         }
+        messages->emplace_back(std::move(message));
+    }
 
-        mSendCnt->Add(1);
+    for (auto& item : messagesByTopic) {
+        if (item.second.empty()) {
+            continue;
+        }
+        mSendCnt->Add(item.second.size());
+        const string& topic = item.first;
+        mProducer->ProduceBatchAsync(topic,
+                                     std::move(item.second),
+                                     [this, topic](const KafkaProducer::BatchResult& result) {
+                                         HandleDeliveryResult(result, topic);
+                                     });
+    }
+    return allSuccess;
+}
 
-        size_t bytes = serializedData.size();
-        mProducer->ProduceAsync(
-            topic,
-            std::move(serializedData),
-            [this, bytes](bool success, const KafkaProducer::ErrorInfo& errorInfo) {
-                if (success) {
-                    LOG_DEBUG(mContext->GetLogger(), ("kafka message queued", bytes));
-                }
-                HandleDeliveryResult(success, errorInfo);
-            },
-            partitionKey);
+bool FlusherKafka::SerializeAndSend(BatchedEventsList&& groupList) {
+    bool allSuccess = true;
+    for (auto& batch : groupList) {
+        allSuccess = SerializeAndSend(std::move(batch)) && allSuccess;
     }
     return allSuccess;
 }
 
-void FlusherKafka::HandleDeliveryResult(bool success, const KafkaProducer::ErrorInfo& errorInfo) {
-    mSendDoneCnt->Add(1);
+bool FlusherKafka::SerializeAndSend(vector<BatchedEventsList>&& groupLists) {
+    bool allSuccess = true;
+    for (auto& groupList : groupLists) {
+        allSuccess = SerializeAndSend(std::move(groupList)) && allSuccess;
+    }
+    return allSuccess;
+}
 
-    if (success) {
-        mSuccessCnt->Add(1);
-    } else {
-        LOG_ERROR(mContext->GetLogger(),
-                  ("kafka message delivery failed", errorInfo.message)("topic", mKafkaConfig.Topic)("error_code",
-                                                                                                    errorInfo.code));
+void FlusherKafka::HandleDeliveryResult(const KafkaProducer::BatchResult& result, const std::string& topic) {
+    size_t failCnt = result.FailCnt();
+    mSendDoneCnt->Add(result.successCnt + failCnt);
+    mSuccessCnt->Add(result.successCnt);
+    if (failCnt == 0) {
+        return;
+    }
 
-        switch (errorInfo.type) {
+    LOG_ERROR(mContext->GetLogger(),
+              ("kafka message delivery failed", result.firstError.message)("topic", topic)(
+                  "error_code", result.firstError.code)("failed messages", failCnt)("succeeded messages",
+                                                                                   result.successCnt));
+    for (const auto& item : result.failCnts) {
+        switch (item.first) {
             case KafkaProducer::ErrorType::AUTH_ERROR:
-                mUnauthErrorCnt->Add(1);
+                mUnauthErrorCnt->Add(item.second);
                 break;
             case KafkaProducer::ErrorType::NETWORK_ERROR:
-                mNetworkErrorCnt->Add(1);
+                mNetworkErrorCnt->Add(item.second);
                 break;
             case KafkaProducer::ErrorType::SERVER_ERROR:
-                mServerErrorCnt->Add(1);
+                mServerErrorCnt->Add(item.second);
                 break;
             case KafkaProducer::ErrorType::PARAMS_ERROR:
-                mParamsErrorCnt->Add(1);
+                mParamsErrorCnt->Add(item.second);
                 break;
             case KafkaProducer::ErrorType::QUEUE_FULL:
-                mDiscardCnt->Add(1);
+                mDiscardCnt->Add(item.second);
                 break;
             case KafkaProducer::ErrorType::OTHER_ERROR:
             default:
-                mOtherErrorCnt->Add(1);
+                mOtherErrorCnt->Add(item.second);
                 break;
         }
-
-        mContext->GetAlarm().SendAlarmCritical(SEND_DATA_FAIL_ALARM,
-                                               "Kafka delivery error: " + errorInfo.message,
-                                               mContext->GetRegion(),
-                                               mContext->GetProjectName(),
-                                               mContext->GetConfigName(),
-                                               mKafkaConfig.Topic);
     }
+
+    mContext->GetAlarm().SendAlarmCritical(SEND_DATA_FAIL_ALARM,
+                                           "Kafka delivery error: " + result.firstError.message
+                                               + "\tfailed messages: " + to_string(failCnt),
+                                           mContext->GetRegion(),
+                                           mContext->GetProjectName(),
+                                           mContext->GetConfigName(),
+                                           mKafkaConfig.Topic);
 }
 
 std::string FlusherKafka::GeneratePartitionKey(const PipelineEventPtr& event) const {
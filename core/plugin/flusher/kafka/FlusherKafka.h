@@ -22,6 +22,8 @@
 #include <string>
 #include <thread>
 
+#include "collection_pipeline/batch/BatchedEvents.h"
+#include "collection_pipeline/batch/Batcher.h"
 #include "collection_pipeline/plugin/interface/Flusher.h"
 #include "collection_pipeline/serializer/JsonSerializer.h"
 #include "common/FormattedString.h"
@@ -55,8 +57,11 @@ public:
 #endif
 
 private:
-    bool SerializeAndSend(PipelineEventGroup&& group);
-    void HandleDeliveryResult(bool success, const KafkaProducer::ErrorInfo& errorInfo);
+    // each event is sent as a message, and messages of the same topic are produced in one batch
+    bool SerializeAndSend(BatchedEvents&& batch);
+    bool SerializeAndSend(BatchedEventsList&& groupList);
+    bool SerializeAndSend(std::vector<BatchedEventsList>&& groupLists);
+    void HandleDeliveryResult(const KafkaProducer::BatchResult& result, const std::string& topic);
     std::string GeneratePartitionKey(const PipelineEventPtr& event) const;
 
     KafkaConfig mKafkaConfig;
@@ -66,6 +71,10 @@ private:
     FormattedString mTopicFormatter;
     std::string mExpandedTopic;
 
+    // only enabled when param Batch is given, otherwise each group is sent once received
+    bool mBatchEnabled = false;
+    Batcher<> mBatcher;
+
     CounterPtr mSendCnt;
     CounterPtr mSuccessCnt;
     CounterPtr mSendDoneCnt;
@@ -42,6 +42,10 @@ const std::string KAFKA_CONFIG_API_VERSION_FALLBACK_MS = "api.version.fallback.m
 const int KAFKA_POLL_INTERVAL_MS = 100;
 const int KAFKA_FLUSH_TIMEOUT_MS = 5000;
 
+const uint32_t KAFKA_BATCH_MAX_SIZE_BYTES = 5 * 1024 * 1024;
+const uint32_t KAFKA_BATCH_MIN_SIZE_BYTES = 256 * 1024;
+const uint32_t KAFKA_BATCH_TIMEOUT_SECS = 1;
+
 const std::string PARTITIONER_RANDOM = "random";
 const std::string PARTITIONER_HASH = "hash";
 const std::string PARTITIONER_PREFIX = "content.";
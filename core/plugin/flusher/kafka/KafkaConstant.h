@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 namespace logtail {
@@ -42,6 +43,10 @@ extern const std::string KAFKA_CONFIG_API_VERSION_FALLBACK_MS;
 extern const int KAFKA_POLL_INTERVAL_MS;
 extern const int KAFKA_FLUSH_TIMEOUT_MS;
 
+extern const uint32_t KAFKA_BATCH_MAX_SIZE_BYTES;
+extern const uint32_t KAFKA_BATCH_MIN_SIZE_BYTES;
+extern const uint32_t KAFKA_BATCH_TIMEOUT_SECS;
+
 extern const std::string PARTITIONER_RANDOM;
 extern const std::string PARTITIONER_HASH;
 extern const std::string PARTITIONER_PREFIX;
@@ -19,6 +19,7 @@
 #include <atomic>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "common/StringTools.h"
@@ -31,11 +32,46 @@ namespace logtail {
 
 namespace {
 
+struct BatchState {
+    BatchState(KafkaProducer::BatchCallback&& cb, size_t cnt) : callback(std::move(cb)), remainingCnt(cnt) {}
+
+    KafkaProducer::BatchCallback callback;
+    KafkaProducer::BatchResult result;
+    size_t remainingCnt;
+    std::mutex mux;
+};
+
 struct ProducerContext {
     KafkaProducer::Callback callback;
     KafkaProducer::ErrorInfo errorInfo;
+    // set for messages produced in a batch, in which case callback is not used
+    BatchState* batch = nullptr;
 };
 
+KafkaProducer::ErrorInfo MakeErrorInfo(rd_kafka_resp_err_t err) {
+    return {KafkaProducer::MapKafkaError(err), rd_kafka_err2str(err), static_cast<int>(err)};
+}
+
+// the batch is destroyed once all of its messages are done
+void OnBatchMessageDone(BatchState* batch, rd_kafka_resp_err_t err) {
+    bool finished = false;
+    {
+        std::lock_guard<std::mutex> lock(batch->mux);
+        if (err == RD_KAFKA_RESP_ERR_NO_ERROR) {
+            ++batch->result.successCnt;
+        } else {
+            batch->result.AddFailure(MakeErrorInfo(err));
+        }
+        finished = --batch->remainingCnt == 0;
+    }
+    if (finished) {
+        if (batch->callback) {
+            batch->callback(batch->result);
+        }
+        delete batch;
+    }
+}
+
 } // namespace
 
 KafkaProducer::ErrorType KafkaProducer::MapKafkaError(rd_kafka_resp_err_t err) {
@@ -97,6 +133,7 @@ public:
     void ReleaseContext(ProducerContext* ctx) {
         ctx->callback = nullptr;
         ctx->errorInfo = {KafkaProducer::ErrorType::SUCCESS, "", 0};
+        ctx->batch = nullptr;
         std::lock_guard<std::mutex> lock(mContextPoolMutex);
         if (mContextPool.size() < kMaxContextCache) {
             mContextPool.push_back(ctx);
@@ -165,23 +202,8 @@ public:
                       std::string&& value,
                       KafkaProducer::Callback callback,
                       const std::string& key) {
-        rd_kafka_headers_t* headers = nullptr;
-        if (mHeadersTemplate) {
-            headers = rd_kafka_headers_copy(mHeadersTemplate);
-            if (!headers) {
-                LOG_ERROR(sLogger, ("failed to copy kafka headers template", ""));
-            }
-        }
-
-        rd_kafka_t* producer = nullptr;
-        {
-            std::lock_guard<std::mutex> lock(mProducerMutex);
-            producer = mProducer;
-        }
+        rd_kafka_t* producer = GetProducer();
         if (!producer) {
-            if (headers) {
-                rd_kafka_headers_destroy(headers);
-            }
             KafkaProducer::ErrorInfo errorInfo;
             errorInfo.type = KafkaProducer::ErrorType::OTHER_ERROR;
             errorInfo.message = "producer not initialized";
@@ -193,6 +215,170 @@ public:
         auto* context = GetContext();
         context->callback = std::move(callback);
 
+        rd_kafka_resp_err_t err = ProduceMessage(producer, topic, value, key, context);
+        if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+            if (context->callback) {
+                context->callback(false, MakeErrorInfo(err));
+            }
+            ReleaseContext(context);
+        }
+    }
+
+    void ProduceBatchAsync(const std::string& topic,
+                           std::vector<KafkaProducer::Message>&& messages,
+                           KafkaProducer::BatchCallback callback) {
+        if (messages.empty()) {
+            if (callback) {
+                callback(KafkaProducer::BatchResult());
+            }
+            return;
+        }
+
+        rd_kafka_t* producer = GetProducer();
+        if (!producer) {
+            KafkaProducer::BatchResult result;
+            result.AddFailure({KafkaProducer::ErrorType::OTHER_ERROR, "producer not initialized", 0}, messages.size());
+            if (callback) {
+                callback(result);
+            }
+            return;
+        }
+
+        auto* batch = new BatchState(std::move(callback), messages.size());
+        rd_kafka_topic_t* rkt = nullptr;
+        // rd_kafka_produce_batch does not support headers, so messages with headers are produced one by one
+        if (!mHeadersTemplate) {
+            rkt = GetTopic(producer, topic);
+        }
+        if (!rkt) {
+            for (auto& message : messages) {
+                auto* context = GetContext();
+                context->batch = batch;
+                rd_kafka_resp_err_t err = ProduceMessage(producer, topic, message.value, message.key, context);
+                if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+                    ReleaseContext(context);
+                    OnBatchMessageDone(batch, err);
+                }
+            }
+            return;
+        }
+
+        std::vector<rd_kafka_message_t> rkmessages(messages.size());
+        for (size_t i = 0; i < messages.size(); ++i) {
+            auto& rkmessage = rkmessages[i];
+            rkmessage.payload = messages[i].value.data();
+            rkmessage.len = messages[i].value.size();
+            if (!messages[i].key.empty()) {
+                rkmessage.key = messages[i].key.data();
+                rkmessage.key_len = messages[i].key.size();
+            }
+            auto* context = GetContext();
+            context->batch = batch;
+            rkmessage._private = context;
+        }
+        // with RD_KAFKA_PARTITION_UA, the partitioner is run for each message, so that messages with the same key
+        // always go to the same partition
+        int producedCnt = rd_kafka_produce_batch(rkt,
+                                                 RD_KAFKA_PARTITION_UA,
+                                                 RD_KAFKA_MSG_F_COPY,
+                                                 rkmessages.data(),
+                                                 static_cast<int>(rkmessages.size()));
+        if (producedCnt == static_cast<int>(rkmessages.size())) {
+            return;
+        }
+        LOG_ERROR(sLogger,
+                  ("rd_kafka_produce_batch error", "some messages are not enqueued")("topic", topic)(
+                      "total", rkmessages.size())("enqueued", producedCnt));
+        // delivery reports are only triggered for enqueued messages
+        for (auto& rkmessage : rkmessages) {
+            if (rkmessage.err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+                ReleaseContext(static_cast<ProducerContext*>(rkmessage._private));
+                OnBatchMessageDone(batch, rkmessage.err);
+            }
+        }
+    }
+
+    bool Flush(int timeoutMs) {
+        if (!mProducer) {
+            return false;
+        }
+
+        rd_kafka_resp_err_t result = rd_kafka_flush(mProducer, timeoutMs);
+        return result == RD_KAFKA_RESP_ERR_NO_ERROR;
+    }
+
+    void Close() {
+        if (mIsClosed) {
+            return;
+        }
+
+        mIsRunning = false;
+        if (mPollThread.joinable()) {
+            mPollThread.join();
+        }
+
+        std::lock_guard<std::mutex> lock(mProducerMutex);
+        if (mProducer) {
+            rd_kafka_flush(mProducer, 3000);
+            {
+                std::lock_guard<std::mutex> topicLock(mTopicsMutex);
+                for (auto& item : mTopics) {
+                    rd_kafka_topic_destroy(item.second);
+                }
+                mTopics.clear();
+            }
+            rd_kafka_destroy(mProducer);
+            mProducer = nullptr;
+        }
+
+        if (mConf) {
+            rd_kafka_conf_destroy(mConf);
+            mConf = nullptr;
+        }
+
+        ResetHeadersTemplate();
+
+        mIsClosed = true;
+    }
+
+private:
+    rd_kafka_t* GetProducer() {
+        std::lock_guard<std::mutex> lock(mProducerMutex);
+        return mProducer;
+    }
+
+    // topic handles are kept until the producer is closed, so that batches to the same topic need no lookup in
+    // librdkafka
+    rd_kafka_topic_t* GetTopic(rd_kafka_t* producer, const std::string& topic) {
+        std::lock_guard<std::mutex> lock(mTopicsMutex);
+        auto it = mTopics.find(topic);
+        if (it != mTopics.end()) {
+            return it->second;
+        }
+        // the default topic config is used when conf is null
+        rd_kafka_topic_t* rkt = rd_kafka_topic_new(producer, topic.c_str(), nullptr);
+        if (!rkt) {
+            LOG_ERROR(sLogger,
+                      ("failed to create kafka topic handle", rd_kafka_err2str(rd_kafka_last_error()))("topic", topic));
+            return nullptr;
+        }
+        mTopics.emplace(topic, rkt);
+        return rkt;
+    }
+
+    rd_kafka_resp_err_t ProduceMessage(rd_kafka_t* producer,
+                                       const std::string& topic,
+                                       std::string& value,
+                                       const std::string& key,
+                                       ProducerContext* context) {
+        rd_kafka_headers_t* headers = nullptr;
+        if (mHeadersTemplate) {
+            headers = rd_kafka_headers_copy(mHeadersTemplate);
+            if (!headers) {
+                LOG_ERROR(sLogger, ("failed to copy kafka headers template", ""));
+            }
+        }
+
         rd_kafka_resp_err_t err;
         if (headers && !key.empty()) {
             err = rd_kafka_producev(producer,
@@ -239,54 +425,10 @@ public:
             if (headers) {
                 rd_kafka_headers_destroy(headers);
             }
-            KafkaProducer::ErrorInfo errorInfo;
-            errorInfo.type = KafkaProducer::MapKafkaError(err);
-            errorInfo.message = rd_kafka_err2str(err);
-            errorInfo.code = static_cast<int>(err);
-            if (context->callback) {
-                context->callback(false, errorInfo);
-            }
-            ReleaseContext(context);
         }
+        return err;
     }
 
-    bool Flush(int timeoutMs) {
-        if (!mProducer) {
-            return false;
-        }
-
-        rd_kafka_resp_err_t result = rd_kafka_flush(mProducer, timeoutMs);
-        return result == RD_KAFKA_RESP_ERR_NO_ERROR;
-    }
-
-    void Close() {
-        if (mIsClosed) {
-            return;
-        }
-
-        mIsRunning = false;
-        if (mPollThread.joinable()) {
-            mPollThread.join();
-        }
-
-        std::lock_guard<std::mutex> lock(mProducerMutex);
-        if (mProducer) {
-            rd_kafka_flush(mProducer, 3000);
-            rd_kafka_destroy(mProducer);
-            mProducer = nullptr;
-        }
-
-        if (mConf) {
-            rd_kafka_conf_destroy(mConf);
-            mConf = nullptr;
-        }
-
-        ResetHeadersTemplate();
-
-        mIsClosed = true;
-    }
-
-private:
     bool SetConfig(const std::string& key, const std::string& value) {
         char errstr[512];
         if (rd_kafka_conf_set(mConf, key.c_str(), value.c_str(), errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) {
@@ -629,6 +771,9 @@ private:
     std::mutex mProducerMutex;
     bool mIsClosed;
 
+    std::unordered_map<std::string, rd_kafka_topic_t*> mTopics;
+    std::mutex mTopicsMutex;
+
     std::vector<ProducerContext*> mContextPool;
     std::mutex mContextPoolMutex;
     static constexpr size_t kMaxContextCache = 65536;
@@ -640,7 +785,9 @@ void KafkaProducer::DeliveryReportCallback(rd_kafka_t* rk, const rd_kafka_messag
         return;
     }
 
-    if (rkmessage->err == RD_KAFKA_RESP_ERR_NO_ERROR) {
+    if (context->batch) {
+        OnBatchMessageDone(context->batch, rkmessage->err);
+    } else if (rkmessage->err == RD_KAFKA_RESP_ERR_NO_ERROR) {
         context->callback(true, {KafkaProducer::ErrorType::SUCCESS, "", 0});
     } else {
         KafkaProducer::ErrorInfo errorInfo;
@@ -674,6 +821,12 @@ void KafkaProducer::ProduceAsync(const std::string& topic,
     mImpl->ProduceAsync(topic, std::move(value), std::move(callback), key);
 }
 
+void KafkaProducer::ProduceBatchAsync(const std::string& topic,
+                                      std::vector<Message>&& messages,
+                                      BatchCallback callback) {
+    mImpl->ProduceBatchAsync(topic, std::move(messages), std::move(callback));
+}
+
 bool KafkaProducer::Flush(int timeoutMs) {
     return mImpl->Flush(timeoutMs);
 }
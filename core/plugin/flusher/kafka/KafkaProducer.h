@@ -18,8 +18,10 @@
 #include <librdkafka/rdkafka.h>
 
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "plugin/flusher/kafka/KafkaConstant.h"
 
@@ -39,6 +41,35 @@ public:
 
     using Callback = std::function<void(bool success, const ErrorInfo& errorInfo)>;
 
+    struct Message {
+        std::string value;
+        std::string key;
+    };
+
+    // delivery results of all messages in a batch
+    struct BatchResult {
+        size_t successCnt = 0;
+        std::map<ErrorType, size_t> failCnts;
+        // the first error met, for logging
+        ErrorInfo firstError{ErrorType::SUCCESS, "", 0};
+
+        size_t FailCnt() const {
+            size_t cnt = 0;
+            for (const auto& item : failCnts) {
+                cnt += item.second;
+            }
+            return cnt;
+        }
+        void AddFailure(const ErrorInfo& errorInfo, size_t cnt = 1) {
+            if (failCnts.empty()) {
+                firstError = errorInfo;
+            }
+            failCnts[errorInfo.type] += cnt;
+        }
+    };
+
+    using BatchCallback = std::function<void(const BatchResult& result)>;
+
     KafkaProducer();
     virtual ~KafkaProducer();
 
@@ -48,6 +79,9 @@ public:
                               std::string&& value,
                               Callback callback,
                               const std::string& key = std::string());
+    // Produces all messages to the topic at once, and callback is called only once after all of them are delivered or
+    // failed. Messages with keys are assigned to partitions by the configured partitioner.
+    virtual void ProduceBatchAsync(const std::string& topic, std::vector<Message>&& messages, BatchCallback callback);
     virtual bool Flush(int timeoutMs);
     virtual void Close();
 
@@ -0,0 +1,477 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "plugin/flusher/sls/DiskBufferSegment.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include "xxhash/xxhash.h"
+
+#include "logger/Logger.h"
+
+using namespace std;
+
+namespace logtail {
+
+struct DiskBufferSegmentReader::IndexEntry {
+    uint64_t mOffset;
+    uint32_t mLength;
+    uint32_t mChecksum;
+    uint32_t mState;
+    uint32_t mReserved;
+};
+
+namespace {
+
+constexpr uint64_t kSegmentMagic = 0x314745535446554CULL; // "LUFTSEG1"
+constexpr uint32_t kSegmentVersion = 1;
+constexpr uint32_t kRecordMagic = 0x4452434CU; // "LCRD"
+constexpr uint32_t kRecordFlagPadding = 1;
+constexpr uint32_t kEntryStateHandled = 1;
+// also the size of the header block, so that records start aligned for direct I/O
+constexpr size_t kAlignment = 4096;
+// the data file is preallocated in steps as records arrive, so that small spills do not take the whole capacity
+constexpr uint64_t kPreallocStep = 1024 * 1024;
+constexpr size_t kRecordAlignment = 8;
+
+using IndexEntry = DiskBufferSegmentReader::IndexEntry;
+
+struct SegmentHeader {
+    uint64_t mMagic;
+    uint32_t mVersion;
+    int32_t mKeyVersion;
+    int64_t mCreateTime;
+};
+
+struct RecordHeader {
+    uint32_t mMagic;
+    uint32_t mLength;
+    uint32_t mChecksum;
+    uint32_t mFlags;
+};
+
+inline uint64_t AlignUp(uint64_t size, uint64_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+inline uint64_t RecordEnd(uint64_t offset, uint32_t length) {
+    return offset + sizeof(RecordHeader) + AlignUp(length, kRecordAlignment);
+}
+
+inline uint32_t Checksum(const char* data, size_t size) {
+    return XXH32(data, size, 0);
+}
+
+#if defined(__linux__)
+bool PwriteAll(int fd, const char* data, size_t size, uint64_t offset) {
+    while (size > 0) {
+        ssize_t n = pwrite(fd, data, size, offset);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= n;
+        offset += n;
+    }
+    return true;
+}
+
+bool PreadAll(int fd, char* data, size_t size, uint64_t offset) {
+    while (size > 0) {
+        ssize_t n = pread(fd, data, size, offset);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (n == 0) {
+            return false;
+        }
+        data += n;
+        size -= n;
+        offset += n;
+    }
+    return true;
+}
+#endif
+
+} // namespace
+
+DiskBufferSegmentWriter::~DiskBufferSegmentWriter() {
+    Close();
+}
+
+#if defined(__linux__)
+bool DiskBufferSegmentWriter::Open(const string& path, uint64_t capacity, int32_t keyVersion, bool directIO) {
+    Close();
+    int flags = O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC;
+    mDataFd = directIO ? open(path.c_str(), flags | O_DIRECT, 0644) : -1;
+    if (mDataFd >= 0) {
+        mDirectIO = true;
+    } else {
+        if (directIO && errno != EINVAL) {
+            return false;
+        }
+        // EINVAL means O_DIRECT is not supported by the file system
+        mDirectIO = false;
+        mDataFd = open(path.c_str(), flags, 0644);
+        if (mDataFd < 0) {
+            return false;
+        }
+    }
+    mPath = path;
+    mCapacity = capacity;
+    mAllocated = 0;
+
+    if (!ReserveBuffer(kAlignment)) {
+        Close();
+        return false;
+    }
+    memset(mBuffer.get(), 0, kAlignment);
+    SegmentHeader header{kSegmentMagic, kSegmentVersion, keyVersion, static_cast<int64_t>(time(nullptr))};
+    memcpy(mBuffer.get(), &header, sizeof(header));
+    if (!PwriteAll(mDataFd, mBuffer.get(), kAlignment, 0)) {
+        int err = errno;
+        Close();
+        unlink(path.c_str());
+        errno = err;
+        return false;
+    }
+
+    string indexPath = DiskBufferSegmentReader::GetIndexPath(path);
+    mIndexFd = open(indexPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (mIndexFd < 0) {
+        // the index is rebuilt from the data file by the reader
+        LOG_WARNING(sLogger, ("failed to create disk buffer segment index", path)("errno", errno));
+    }
+    mOffset = kAlignment;
+    mRecordCnt = 0;
+    return true;
+}
+
+bool DiskBufferSegmentWriter::Append(const vector<string>& records) {
+    if (mDataFd < 0) {
+        return false;
+    }
+    if (records.empty()) {
+        return true;
+    }
+    size_t size = 0;
+    for (const auto& record : records) {
+        size += RecordEnd(0, record.size());
+    }
+    // room for the padding record
+    size_t bufferSize = mDirectIO ? AlignUp(size + sizeof(RecordHeader), kAlignment) : size;
+    if (!ReserveBuffer(bufferSize)) {
+        return false;
+    }
+
+    vector<IndexEntry> entries;
+    entries.reserve(records.size());
+    char* buffer = mBuffer.get();
+    size_t pos = 0;
+    for (const auto& record : records) {
+        RecordHeader header{
+            kRecordMagic, static_cast<uint32_t>(record.size()), Checksum(record.data(), record.size()), 0};
+        memcpy(buffer + pos, &header, sizeof(header));
+        memcpy(buffer + pos + sizeof(header), record.data(), record.size());
+        size_t end = RecordEnd(pos, header.mLength);
+        memset(buffer + pos + sizeof(header) + record.size(), 0, end - pos - sizeof(header) - record.size());
+        entries.push_back({mOffset + pos, header.mLength, header.mChecksum, 0, 0});
+        pos = end;
+    }
+    if (mDirectIO && pos % kAlignment != 0) {
+        size_t end = AlignUp(pos, kAlignment);
+        if (end - pos < sizeof(RecordHeader)) {
+            end += kAlignment;
+        }
+        RecordHeader header{
+            kRecordMagic, static_cast<uint32_t>(end - pos - sizeof(RecordHeader)), 0, kRecordFlagPadding};
+        memcpy(buffer + pos, &header, sizeof(header));
+        memset(buffer + pos + sizeof(header), 0, header.mLength);
+        pos = end;
+    }
+
+    Preallocate(mOffset + pos);
+    if (!PwriteAll(mDataFd, buffer, pos, mOffset)) {
+        return false;
+    }
+    if (mIndexFd >= 0
+        && !PwriteAll(mIndexFd,
+                      reinterpret_cast<const char*>(entries.data()),
+                      entries.size() * sizeof(IndexEntry),
+                      mRecordCnt * sizeof(IndexEntry))) {
+        // the index is rebuilt from the data file by the reader
+        LOG_WARNING(sLogger, ("failed to write disk buffer segment index", mPath)("errno", errno));
+    }
+    mOffset += pos;
+    mRecordCnt += entries.size();
+    return true;
+}
+
+void DiskBufferSegmentWriter::Close() {
+    if (mDataFd >= 0) {
+        close(mDataFd);
+        mDataFd = -1;
+    }
+    if (mIndexFd >= 0) {
+        close(mIndexFd);
+        mIndexFd = -1;
+    }
+}
+
+void DiskBufferSegmentWriter::Preallocate(uint64_t size) {
+    if (size <= mAllocated || mAllocated >= mCapacity) {
+        return;
+    }
+    uint64_t target = min(AlignUp(size, kPreallocStep), mCapacity);
+    // only to avoid fragmentation, and the file grows on write if not supported
+    int err = posix_fallocate(mDataFd, mAllocated, target - mAllocated);
+    if (err != 0) {
+        LOG_DEBUG(sLogger, ("failed to preallocate disk buffer segment", mPath)("errno", err));
+        // do not retry on each batch
+        mAllocated = mCapacity;
+        return;
+    }
+    mAllocated = target;
+}
+
+bool DiskBufferSegmentWriter::ReserveBuffer(size_t size) {
+    if (size <= mBufferSize) {
+        return true;
+    }
+    size = AlignUp(size, kAlignment);
+    void* buffer = nullptr;
+    if (posix_memalign(&buffer, kAlignment, size) != 0) {
+        return false;
+    }
+    mBuffer = unique_ptr<char, void (*)(void*)>(static_cast<char*>(buffer), free);
+    mBufferSize = size;
+    return true;
+}
+
+DiskBufferSegmentReader::~DiskBufferSegmentReader() {
+    Close();
+}
+
+bool DiskBufferSegmentReader::Open(const string& path) {
+    Close();
+    mPath = path;
+    mDataFd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (mDataFd < 0) {
+        return false;
+    }
+    struct stat st;
+    SegmentHeader header;
+    if (fstat(mDataFd, &st) != 0 || !PreadAll(mDataFd, reinterpret_cast<char*>(&header), sizeof(header), 0)
+        || header.mMagic != kSegmentMagic || header.mVersion != kSegmentVersion) {
+        Close();
+        return false;
+    }
+    mDataSize = st.st_size;
+    mKeyVersion = header.mKeyVersion;
+    mCreateTime = header.mCreateTime;
+
+    mIndexFd = open(GetIndexPath(path).c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (mIndexFd < 0 || fstat(mIndexFd, &st) != 0) {
+        Close();
+        return false;
+    }
+    vector<IndexEntry> entries(st.st_size / sizeof(IndexEntry));
+    if (!entries.empty()
+        && !PreadAll(mIndexFd, reinterpret_cast<char*>(entries.data()), entries.size() * sizeof(IndexEntry), 0)) {
+        Close();
+        return false;
+    }
+    if (!RecoverIndex(entries)) {
+        Close();
+        return false;
+    }
+    mRecordCnt = entries.size();
+    if (mRecordCnt == 0) {
+        return true;
+    }
+    void* addr = mmap(nullptr, mRecordCnt * sizeof(IndexEntry), PROT_READ | PROT_WRITE, MAP_SHARED, mIndexFd, 0);
+    if (addr == MAP_FAILED) {
+        Close();
+        return false;
+    }
+    mEntries = static_cast<IndexEntry*>(addr);
+    return true;
+}
+
+bool DiskBufferSegmentReader::RecoverIndex(vector<IndexEntry>& entries) {
+    // entries not matching the data file are dropped, as well as all entries after them
+    size_t validCnt = 0;
+    uint64_t end = kAlignment;
+    for (; validCnt < entries.size(); ++validCnt) {
+        const auto& entry = entries[validCnt];
+        if (entry.mOffset < end || entry.mOffset % kRecordAlignment != 0
+            || RecordEnd(entry.mOffset, entry.mLength) > mDataSize) {
+            break;
+        }
+        end = RecordEnd(entry.mOffset, entry.mLength);
+    }
+    bool modified = validCnt != entries.size();
+    entries.resize(validCnt);
+
+    // scan records after the last indexed one, until the preallocated space or a torn record
+    string payload;
+    while (end + sizeof(RecordHeader) <= mDataSize) {
+        RecordHeader header;
+        if (!PreadAll(mDataFd, reinterpret_cast<char*>(&header), sizeof(header), end) || header.mMagic != kRecordMagic
+            || RecordEnd(end, header.mLength) > mDataSize) {
+            break;
+        }
+        if (header.mFlags & kRecordFlagPadding) {
+            end = RecordEnd(end, header.mLength);
+            continue;
+        }
+        payload.resize(header.mLength);
+        if (!PreadAll(mDataFd, &payload[0], header.mLength, end + sizeof(header))
+            || Checksum(payload.data(), payload.size()) != header.mChecksum) {
+            break;
+        }
+        entries.push_back({end, header.mLength, header.mChecksum, 0, 0});
+        ++mRecoveredCnt;
+        modified = true;
+        end = RecordEnd(end, header.mLength);
+    }
+
+    if (!modified) {
+        return true;
+    }
+    if (ftruncate(mIndexFd, 0) != 0
+        || !PwriteAll(
+            mIndexFd, reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(IndexEntry), 0)) {
+        return false;
+    }
+    LOG_INFO(sLogger,
+             ("disk buffer segment index recovered", mPath)("valid entries", validCnt)("recovered entries",
+                                                                                        mRecoveredCnt));
+    return true;
+}
+
+bool DiskBufferSegmentReader::Read(size_t idx, string& record) const {
+    if (idx >= mRecordCnt) {
+        return false;
+    }
+    const auto& entry = mEntries[idx];
+    record.resize(entry.mLength);
+    if (entry.mLength > 0 && !PreadAll(mDataFd, &record[0], entry.mLength, entry.mOffset + sizeof(RecordHeader))) {
+        return false;
+    }
+    return Checksum(record.data(), record.size()) == entry.mChecksum;
+}
+
+void DiskBufferSegmentReader::Close() {
+    if (mEntries != nullptr) {
+        munmap(mEntries, mRecordCnt * sizeof(IndexEntry));
+        mEntries = nullptr;
+    }
+    if (mDataFd >= 0) {
+        close(mDataFd);
+        mDataFd = -1;
+    }
+    if (mIndexFd >= 0) {
+        close(mIndexFd);
+        mIndexFd = -1;
+    }
+    mRecordCnt = 0;
+    mRecoveredCnt = 0;
+}
+
+void DiskBufferSegmentReader::Remove(const string& path) {
+    unlink(path.c_str());
+    unlink(GetIndexPath(path).c_str());
+}
+#else
+bool DiskBufferSegmentWriter::Open(const string& path, uint64_t capacity, int32_t keyVersion, bool directIO) {
+    return false;
+}
+
+bool DiskBufferSegmentWriter::Append(const vector<string>& records) {
+    return false;
+}
+
+void DiskBufferSegmentWriter::Close() {
+}
+
+void DiskBufferSegmentWriter::Preallocate(uint64_t size) {
+}
+
+bool DiskBufferSegmentWriter::ReserveBuffer(size_t size) {
+    return false;
+}
+
+DiskBufferSegmentReader::~DiskBufferSegmentReader() {
+    Close();
+}
+
+bool DiskBufferSegmentReader::Open(const string& path) {
+    return false;
+}
+
+bool DiskBufferSegmentReader::RecoverIndex(vector<IndexEntry>& entries) {
+    return false;
+}
+
+bool DiskBufferSegmentReader::Read(size_t idx, string& record) const {
+    return false;
+}
+
+void DiskBufferSegmentReader::Close() {
+}
+
+void DiskBufferSegmentReader::Remove(const string& path) {
+    remove(path.c_str());
+    remove(GetIndexPath(path).c_str());
+}
+#endif
+
+bool DiskBufferSegmentReader::IsHandled(size_t idx) const {
+    return idx < mRecordCnt && mEntries[idx].mState == kEntryStateHandled;
+}
+
+void DiskBufferSegmentReader::MarkHandled(size_t idx) {
+    if (idx < mRecordCnt) {
+        mEntries[idx].mState = kEntryStateHandled;
+    }
+}
+
+bool DiskBufferSegmentReader::AllHandled() const {
+    for (size_t i = 0; i < mRecordCnt; ++i) {
+        if (mEntries[i].mState != kEntryStateHandled) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace logtail
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace logtail {
+
+// A segment of the disk buffer consists of a data file and an index file named with an additional ".idx" suffix.
+// The data file starts with a header block, followed by records which are appended in batches, one write per batch.
+// Each record is prefixed with its length and checksum. The index file holds a fixed-size entry per record with its
+// offset, length and state, so that the reader can locate records and mark them as handled in place without scanning
+// the data file.
+// The data file is the source of truth. Since index entries are written after their records, the index may fall behind
+// on crash, in which case the reader rebuilds the missing entries by scanning the records after the last indexed one,
+// until a record fails the check.
+// Only available on Linux, Open always fails on other platforms.
+class DiskBufferSegmentWriter {
+public:
+    DiskBufferSegmentWriter() = default;
+    ~DiskBufferSegmentWriter();
+    DiskBufferSegmentWriter(const DiskBufferSegmentWriter&) = delete;
+    DiskBufferSegmentWriter& operator=(const DiskBufferSegmentWriter&) = delete;
+
+    // The data file is created exclusively and preallocated in steps as records arrive, up to capacity. With directIO,
+    // the data file is written with O_DIRECT and each batch is padded to the alignment, falling back to buffered writes
+    // if not supported.
+    bool Open(const std::string& path, uint64_t capacity, int32_t keyVersion, bool directIO);
+    // all records are written with one write to the data file
+    bool Append(const std::vector<std::string>& records);
+    void Close();
+
+    bool IsOpen() const { return mDataFd >= 0; }
+    bool IsDirectIO() const { return mDirectIO; }
+    const std::string& GetPath() const { return mPath; }
+    // bytes used in the data file, including the header block
+    uint64_t GetSize() const { return mOffset; }
+    uint64_t GetCapacity() const { return mCapacity; }
+    size_t GetRecordCnt() const { return mRecordCnt; }
+
+private:
+    void Preallocate(uint64_t size);
+    bool ReserveBuffer(size_t size);
+
+    std::string mPath;
+    int mDataFd = -1;
+    int mIndexFd = -1;
+    bool mDirectIO = false;
+    uint64_t mCapacity = 0;
+    uint64_t mAllocated = 0;
+    uint64_t mOffset = 0;
+    size_t mRecordCnt = 0;
+
+    // aligned for direct I/O, and reused across batches
+    std::unique_ptr<char, void (*)(void*)> mBuffer{nullptr, nullptr};
+    size_t mBufferSize = 0;
+};
+
+class DiskBufferSegmentReader {
+public:
+    DiskBufferSegmentReader() = default;
+    ~DiskBufferSegmentReader();
+    DiskBufferSegmentReader(const DiskBufferSegmentReader&) = delete;
+    DiskBufferSegmentReader& operator=(const DiskBufferSegmentReader&) = delete;
+
+    // layout of the index file, shared with the writer
+    struct IndexEntry;
+
+    // the segment must not be written any more, and the index is recovered from the data file if necessary
+    bool Open(const std::string& path);
+    void Close();
+
+    int32_t GetKeyVersion() const { return mKeyVersion; }
+    int64_t GetCreateTime() const { return mCreateTime; }
+    size_t GetRecordCnt() const { return mRecordCnt; }
+    // number of index entries rebuilt from the data file on Open
+    size_t GetRecoveredCnt() const { return mRecoveredCnt; }
+
+    bool IsHandled(size_t idx) const;
+    // returns false if the record cannot be read or fails the checksum
+    bool Read(size_t idx, std::string& record) const;
+    // persisted through the mmap'd index, without any write to the data file
+    void MarkHandled(size_t idx);
+    bool AllHandled() const;
+
+    static std::string GetIndexPath(const std::string& path) { return path + ".idx"; }
+    // remove both the data file and the index file
+    static void Remove(const std::string& path);
+
+private:
+    bool RecoverIndex(std::vector<IndexEntry>& entries);
+
+    std::string mPath;
+    int mDataFd = -1;
+    int mIndexFd = -1;
+    uint64_t mDataSize = 0;
+    int32_t mKeyVersion = 0;
+    int64_t mCreateTime = 0;
+
+    IndexEntry* mEntries = nullptr;
+    size_t mRecordCnt = 0;
+    size_t mRecoveredCnt = 0;
+};
+
+} // namespace logtail
@@ -16,6 +16,8 @@
 
 #include <cstddef>
 
+#include <algorithm>
+
 #include "Flags.h"
 #include "app_config/AppConfig.h"
 #include "application/Application.h"
@@ -50,6 +52,10 @@ DEFINE_FLAG_INT32(send_retry_sleep_interval, "sleep microseconds when sync send
 DEFINE_FLAG_INT32(buffer_check_period, "check logtail local storage buffer period", 60);
 DEFINE_FLAG_INT32(unauthorized_wait_interval, "", 1);
 DEFINE_FLAG_INT32(send_retrytimes, "how many times should retry if PostLogStoreLogs operation fail", 3);
+// segments are always read, but older versions cannot read them after a downgrade, so writing them is opt-in for now
+DEFINE_FLAG_BOOL(enable_disk_buffer_segment, "write disk buffer to indexed segments instead of buffer files", false);
+DEFINE_FLAG_BOOL(disk_buffer_segment_direct_io, "write disk buffer segments with direct I/O", false);
+DEFINE_FLAG_INT32(disk_buffer_segment_send_thread_count, "number of threads sending disk buffer segments", 4);
 
 DECLARE_FLAG_INT32(discard_send_fail_interval);
 
@@ -86,6 +92,42 @@ static const string kAKErrorMsg = "can not get valid access key";
 
 static const string kNoHostErrorMsg = "can not get available host";
 
+// segments are named as <prefix>segment_<time>_<seq>, with an index file named <segment>.idx
+static const string kSegmentNameInfix = "segment_";
+static const string kSegmentIndexSuffix = ".idx";
+
+static int32_t GetBufferFileTime(const string& filename, bool isSegment) {
+    size_t begin = GetSendBufferFileNamePrefix().size() + (isSegment ? kSegmentNameInfix.size() : 0);
+    size_t end = isSegment ? filename.find('_', begin) : filename.size();
+    int32_t filetime = 0;
+    StringTo(filename.substr(begin, end - begin), filetime);
+    return filetime;
+}
+
+// Buffer files and segments count against the same limit, and the oldest of both beyond the limit are moved out of
+// the sorted lists.
+static void SplitExceededBufferFiles(vector<string>& files,
+                                     vector<string>& segments,
+                                     int32_t limit,
+                                     vector<string>& exceededFiles,
+                                     vector<string>& exceededSegments) {
+    size_t fileCnt = 0;
+    size_t segmentCnt = 0;
+    for (int64_t i = static_cast<int64_t>(files.size() + segments.size()) - limit; i > 0; --i) {
+        if (segmentCnt == segments.size()
+            || (fileCnt < files.size()
+                && GetBufferFileTime(files[fileCnt], false) <= GetBufferFileTime(segments[segmentCnt], true))) {
+            ++fileCnt;
+        } else {
+            ++segmentCnt;
+        }
+    }
+    exceededFiles.assign(files.begin(), files.begin() + fileCnt);
+    files.erase(files.begin(), files.begin() + fileCnt);
+    exceededSegments.assign(segments.begin(), segments.begin() + segmentCnt);
+    segments.erase(segments.begin(), segments.begin() + segmentCnt);
+}
+
 static const string& GetSLSCompressTypeString(sls_logs::SlsCompressType compressType) {
     switch (compressType) {
         case sls_logs::SLS_CMP_NONE: {
@@ -190,8 +232,17 @@ void DiskBufferWriter::BufferWriterThread() {
         }
 
         if (!res.empty()) {
+#if defined(__linux__)
+            if (BOOL_FLAG(enable_disk_buffer_segment)) {
+                SendToBufferSegment(res);
+            } else
+#endif
+            {
+                for (auto itr = res.begin(); itr != res.end(); ++itr) {
+                    SendToBufferFile(*itr);
+                }
+            }
             for (auto itr = res.begin(); itr != res.end(); ++itr) {
-                SendToBufferFile(*itr);
                 delete *itr;
             }
             res.clear();
@@ -203,8 +254,8 @@ void DiskBufferWriter::BufferSenderThread() {
     LOG_INFO(sLogger, ("disk buffer sender", "started"));
     unique_lock<mutex> lock(mBufferSenderThreadRunningMux);
     while (mIsSendBufferThreadRunning) {
-        vector<string> filesToSend;
-        if (!LoadFileToSend(mBufferDivideTime, filesToSend)) {
+        vector<string> filesToSend, segmentsToSend;
+        if (!LoadFileToSend(mBufferDivideTime, filesToSend, segmentsToSend)) {
             if (mStopCV.wait_for(
                     lock, chrono::seconds(mCheckPeriod), [this]() { return !mIsSendBufferThreadRunning; })) {
                 break;
@@ -213,11 +264,14 @@ void DiskBufferWriter::BufferSenderThread() {
         }
         lock.unlock();
         // mIsSendingBuffer = true;
+        vector<string> exceededFiles, exceededSegments;
+        SplitExceededBufferFiles(filesToSend,
+                                 segmentsToSend,
+                                 AppConfig::GetInstance()->GetNumOfBufferFile(),
+                                 exceededFiles,
+                                 exceededSegments);
         int32_t fileToSendCount = int32_t(filesToSend.size());
-        int32_t bufferFileNumValue = AppConfig::GetInstance()->GetNumOfBufferFile();
-        for (int32_t i = (fileToSendCount > bufferFileNumValue ? fileToSendCount - bufferFileNumValue : 0);
-             i < fileToSendCount && mIsSendBufferThreadRunning;
-             ++i) {
+        for (int32_t i = 0; i < fileToSendCount && mIsSendBufferThreadRunning; ++i) {
             string fileName = GetBufferFilePath() + filesToSend[i];
             unordered_map<string, string> kvMap;
             if (FileEncryption::CheckHeader(fileName, kvMap)) {
@@ -247,8 +301,14 @@ void DiskBufferWriter::BufferSenderThread() {
                     DISCARD_SECONDARY_ALARM, "check header of buffer file failed, delete file: " + fileName);
             }
         }
+        if (!segmentsToSend.empty() && mIsSendBufferThreadRunning) {
+            SendBufferSegments(segmentsToSend);
+        }
 #ifdef __ENTERPRISE__
-        mCandidateHostsInfos.clear();
+        {
+            lock_guard<mutex> lock(mCandidateHostsInfosMux);
+            mCandidateHostsInfos.clear();
+        }
 #endif
         // mIsSendingBuffer = false;
         lock.lock();
@@ -285,7 +345,9 @@ std::string DiskBufferWriter::GetBufferFileName() {
     return mBufferFileName;
 }
 
-bool DiskBufferWriter::LoadFileToSend(time_t timeLine, std::vector<std::string>& filesToSend) {
+bool DiskBufferWriter::LoadFileToSend(time_t timeLine,
+                                      std::vector<std::string>& filesToSend,
+                                      std::vector<std::string>& segmentsToSend) {
     string bufferFilePath = GetBufferFilePath();
     if (!CheckExistance(bufferFilePath)) {
         if (GetBufferFileDir().find(bufferFilePath) != 0) {
@@ -313,10 +375,25 @@ bool DiskBufferWriter::LoadFileToSend(time_t timeLine, std::vector<std::string>&
             SECONDARY_READ_WRITE_ALARM, string("open dir error,dir:") + bufferFilePath + ",error:" + errorStr);
         return false;
     }
+    const string segmentPrefix = GetSendBufferFileNamePrefix() + kSegmentNameInfix;
     fsutil::Entry ent;
     while ((ent = dir.ReadNext())) {
         string filename = ent.Name();
-        if (filename.find(GetSendBufferFileNamePrefix()) == 0) {
+        if (filename.find(segmentPrefix) == 0) {
+            if (EndWith(filename, kSegmentIndexSuffix)) {
+                continue;
+            }
+            int32_t filetime{};
+            auto timeEnd = filename.find('_', segmentPrefix.size());
+            if (timeEnd == string::npos
+                || !StringTo(filename.substr(segmentPrefix.size(), timeEnd - segmentPrefix.size()), filetime)) {
+                LOG_INFO(sLogger, ("can not get file time from segment name", filename));
+                continue;
+            }
+            if (filetime < timeLine) {
+                segmentsToSend.push_back(filename);
+            }
+        } else if (filename.find(GetSendBufferFileNamePrefix()) == 0) {
             int32_t filetime{};
             if (!StringTo(filename.substr(GetSendBufferFileNamePrefix().size()), filetime)) {
                 LOG_INFO(sLogger, ("can not get file time from file name", filename));
@@ -328,6 +405,7 @@ bool DiskBufferWriter::LoadFileToSend(time_t timeLine, std::vector<std::string>&
         }
     }
     sort(filesToSend.begin(), filesToSend.end());
+    sort(segmentsToSend.begin(), segmentsToSend.end());
     return true;
 }
 
@@ -424,35 +502,11 @@ bool DiskBufferWriter::ReadNextEncryption(int32_t& pos,
         delete[] buffer;
         return true;
     }
-    string encodedInfo = string(buffer, encodedInfoSize);
+    bool parseResult = ParseBufferMeta(filename, buffer, encodedInfoSize, pbMeta, bufferMeta);
     delete[] buffer;
-    if (pbMeta) {
-        if (!bufferMeta.ParseFromString(encodedInfo)) {
-            fclose(fin);
-            AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
-                                                           string("parse buffer meta from file error:") + filename);
-            LOG_ERROR(sLogger, ("parse buffer meta from file error", filename)("buffer meta", encodedInfo));
-            bufferMeta.Clear();
-            return true;
-        }
-    } else {
-        bufferMeta.set_project(encodedInfo);
-        bufferMeta.set_region(FlusherSLS::GetDefaultRegion()); // new mode
-        bufferMeta.set_aliuid("");
-    }
-    if (!bufferMeta.has_compresstype()) {
-        bufferMeta.set_compresstype(sls_logs::SlsCompressType::SLS_CMP_LZ4);
-    }
-    if (!bufferMeta.has_telemetrytype()) {
-        bufferMeta.set_telemetrytype(sls_logs::SLS_TELEMETRY_TYPE_LOGS);
-    }
-#ifdef __ENTERPRISE__
-    if (!bufferMeta.has_endpointmode()) {
-        bufferMeta.set_endpointmode(sls_logs::EndpointMode::DEFAULT);
-    }
-#endif
-    if (!bufferMeta.has_endpoint()) {
-        bufferMeta.set_endpoint("");
+    if (!parseResult) {
+        fclose(fin);
+        return true;
     }
 
     buffer = new char[meta.mEncryptionSize + 1];
@@ -481,9 +535,45 @@ bool DiskBufferWriter::ReadNextEncryption(int32_t& pos,
     return true;
 }
 
+bool DiskBufferWriter::ParseBufferMeta(const std::string& filename,
+                                       const char* encodedInfo,
+                                       int32_t encodedInfoSize,
+                                       bool pbMeta,
+                                       sls_logs::LogtailBufferMeta& bufferMeta) {
+    if (pbMeta) {
+        if (!bufferMeta.ParseFromArray(encodedInfo, encodedInfoSize)) {
+            AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
+                                                           string("parse buffer meta from file error:") + filename);
+            LOG_ERROR(sLogger,
+                      ("parse buffer meta from file error", filename)("buffer meta",
+                                                                      string(encodedInfo, encodedInfoSize)));
+            bufferMeta.Clear();
+            return false;
+        }
+    } else {
+        bufferMeta.set_project(string(encodedInfo, encodedInfoSize));
+        bufferMeta.set_region(FlusherSLS::GetDefaultRegion()); // new mode
+        bufferMeta.set_aliuid("");
+    }
+    if (!bufferMeta.has_compresstype()) {
+        bufferMeta.set_compresstype(sls_logs::SlsCompressType::SLS_CMP_LZ4);
+    }
+    if (!bufferMeta.has_telemetrytype()) {
+        bufferMeta.set_telemetrytype(sls_logs::SLS_TELEMETRY_TYPE_LOGS);
+    }
+#ifdef __ENTERPRISE__
+    if (!bufferMeta.has_endpointmode()) {
+        bufferMeta.set_endpointmode(sls_logs::EndpointMode::DEFAULT);
+    }
+#endif
+    if (!bufferMeta.has_endpoint()) {
+        bufferMeta.set_endpoint("");
+    }
+    return true;
+}
+
 void DiskBufferWriter::SendEncryptionBuffer(const std::string& filename, int32_t keyVersion) {
     string encryption;
-    string logData;
     EncryptionStateMeta meta;
     bool readResult;
     bool writeBack = false;
@@ -491,7 +581,6 @@ void DiskBufferWriter::SendEncryptionBuffer(const std::string& filename, int32_t
     sls_logs::LogtailBufferMeta bufferMeta;
     int32_t discardCount = 0;
     while (ReadNextEncryption(pos, filename, encryption, meta, readResult, bufferMeta)) {
-        logData.clear();
         bool sendResult = false;
         if (!readResult || !CheckBufferMetaValidation(filename, bufferMeta)) {
             if (meta.mHandled == 1)
@@ -500,141 +589,7 @@ void DiskBufferWriter::SendEncryptionBuffer(const std::string& filename, int32_t
             discardCount++;
         }
         if (!sendResult) {
-            char* des = new char[meta.mLogDataSize];
-            if (!FileEncryption::GetInstance()->Decrypt(
-                    encryption.c_str(), meta.mEncryptionSize, des, meta.mLogDataSize, keyVersion)) {
-                sendResult = true;
-                discardCount++;
-                LOG_ERROR(sLogger,
-                          ("decrypt error, project_name",
-                           bufferMeta.project())("key_version", keyVersion)("meta.mLogDataSize", meta.mLogDataSize));
-                AlarmManager::GetInstance()->SendAlarmCritical(
-                    ENCRYPT_DECRYPT_FAIL_ALARM,
-                    string("decrypt error, project_name:" + bufferMeta.project() + ", key_version:"
-                           + ToString(keyVersion) + ", meta.mLogDataSize:" + ToString(meta.mLogDataSize)),
-                    bufferMeta.region(),
-                    bufferMeta.project(),
-                    "",
-                    bufferMeta.logstore());
-            } else {
-                if (bufferMeta.has_logstore())
-                    logData = string(des, meta.mLogDataSize);
-                else {
-                    // compatible to old buffer file (logGroup string), convert to LZ4 compressed
-                    string logGroupStr = string(des, meta.mLogDataSize);
-                    sls_logs::LogGroup logGroup;
-                    if (!logGroup.ParseFromString(logGroupStr)) {
-                        sendResult = true;
-                        LOG_ERROR(sLogger,
-                                  ("parse error from string to loggroup, projectName is", bufferMeta.project()));
-                        discardCount++;
-                        AlarmManager::GetInstance()->SendAlarmCritical(
-                            LOG_GROUP_PARSE_FAIL_ALARM,
-                            string("projectName is:" + bufferMeta.project() + ", fileName is:" + filename),
-                            bufferMeta.region(),
-                            bufferMeta.project(),
-                            "",
-                            bufferMeta.logstore());
-                    } else if (!CompressLz4(logGroupStr, logData)) {
-                        sendResult = true;
-                        LOG_ERROR(sLogger, ("LZ4 compress loggroup fail, projectName is", bufferMeta.project()));
-                        discardCount++;
-                        AlarmManager::GetInstance()->SendAlarmCritical(
-                            SEND_COMPRESS_FAIL_ALARM,
-                            string("projectName is:" + bufferMeta.project() + ", fileName is:" + filename),
-                            bufferMeta.region(),
-                            bufferMeta.project(),
-                            "",
-                            bufferMeta.logstore());
-                    } else {
-                        bufferMeta.set_logstore(logGroup.category());
-                        bufferMeta.set_datatype(int(RawDataType::EVENT_GROUP));
-                        bufferMeta.set_rawsize(meta.mLogDataSize);
-                        bufferMeta.set_compresstype(sls_logs::SLS_CMP_LZ4);
-                        bufferMeta.set_telemetrytype(sls_logs::SLS_TELEMETRY_TYPE_LOGS);
-                    }
-                }
-                if (!sendResult) {
-                    time_t beginTime = time(nullptr);
-                    while (true) {
-                        string domain;
-                        string ip;
-                        bool useIPFlag = false;
-                        auto response = SendBufferFileData(bufferMeta, logData, domain, ip, useIPFlag);
-                        SendResult sendRes = SEND_OK;
-                        if (response.mStatusCode != 200) {
-                            sendRes = ConvertErrorCode(response.mErrorCode);
-                        }
-                        switch (sendRes) {
-                            case SEND_OK:
-                                sendResult = true;
-                                break;
-                            case SEND_NETWORK_ERROR:
-                            case SEND_SERVER_ERROR:
-                                if (response.mErrorMsg != kNoHostErrorMsg) {
-                                    LOG_WARNING(
-                                        sLogger,
-                                        ("send data to SLS fail", "retry later")("request id", response.mRequestId)(
-                                            "error_code", response.mErrorCode)("error_message", response.mErrorMsg)(
-                                            "domain", domain)("ip", ip)("useIPFlag", useIPFlag)("projectName",
-                                                                                                bufferMeta.project())(
-                                            "logstore", bufferMeta.logstore())("rawsize", bufferMeta.rawsize()));
-                                }
-                                usleep(INT32_FLAG(send_retry_sleep_interval));
-                                break;
-                            case SEND_QUOTA_EXCEED:
-                                AlarmManager::GetInstance()->SendAlarmError(
-                                    SEND_QUOTA_EXCEED_ALARM,
-                                    "error_code: " + response.mErrorCode + ", error_message: " + response.mErrorMsg,
-                                    bufferMeta.region(),
-                                    bufferMeta.project(),
-                                    "",
-                                    bufferMeta.logstore());
-                                // no region
-                                if (!GetProfileSender()->IsProfileData("", bufferMeta.project(), bufferMeta.logstore()))
-                                    LOG_WARNING(
-                                        sLogger,
-                                        ("send data to SLS fail", "retry later")("request id", response.mRequestId)(
-                                            "error_code", response.mErrorCode)("error_message", response.mErrorMsg)(
-                                            "domain", domain)("ip", ip)("useIPFlag", useIPFlag)("projectName",
-                                                                                                bufferMeta.project())(
-                                            "logstore", bufferMeta.logstore())("rawsize", bufferMeta.rawsize()));
-                                usleep(INT32_FLAG(quota_exceed_wait_interval));
-                                break;
-                            case SEND_UNAUTHORIZED:
-                                usleep(INT32_FLAG(unauthorized_wait_interval));
-                                break;
-                            default:
-                                sendResult = true;
-                                discardCount++;
-                                break;
-                        }
-#ifdef __ENTERPRISE__
-                        if (sendRes != SEND_NETWORK_ERROR && sendRes != SEND_SERVER_ERROR) {
-                            bool hasAuthError = sendRes == SEND_UNAUTHORIZED && response.mErrorMsg != kAKErrorMsg;
-                            EnterpriseSLSClientManager::GetInstance()->UpdateAccessKeyStatus(bufferMeta.aliuid(),
-                                                                                             !hasAuthError);
-                            EnterpriseSLSClientManager::GetInstance()->UpdateProjectAnonymousWriteStatus(
-                                bufferMeta.project(), !hasAuthError);
-                        }
-#endif
-                        if (time(nullptr) - beginTime >= INT32_FLAG(discard_send_fail_interval)) {
-                            sendResult = true;
-                            discardCount++;
-                        }
-                        if (sendResult) {
-                            break;
-                        }
-                        {
-                            lock_guard<mutex> lock(mBufferSenderThreadRunningMux);
-                            if (!mIsSendBufferThreadRunning) {
-                                break;
-                            }
-                        }
-                    }
-                }
-            }
-            delete[] des;
+            sendResult = SendEncryptedData(filename, encryption.c_str(), meta, keyVersion, bufferMeta, discardCount);
         }
         if (sendResult)
             meta.mHandled = 1;
@@ -669,15 +624,289 @@ void DiskBufferWriter::SendEncryptionBuffer(const std::string& filename, int32_t
     }
 }
 
+bool DiskBufferWriter::SendEncryptedData(const std::string& filename,
+                                         const char* encryption,
+                                         const EncryptionStateMeta& meta,
+                                         int32_t keyVersion,
+                                         sls_logs::LogtailBufferMeta& bufferMeta,
+                                         int32_t& discardCount) {
+    string logData;
+    bool sendResult = false;
+    char* des = new char[meta.mLogDataSize];
+    if (!FileEncryption::GetInstance()->Decrypt(encryption, meta.mEncryptionSize, des, meta.mLogDataSize, keyVersion)) {
+        sendResult = true;
+        discardCount++;
+        LOG_ERROR(sLogger,
+                  ("decrypt error, project_name",
+                   bufferMeta.project())("key_version", keyVersion)("meta.mLogDataSize", meta.mLogDataSize));
+        AlarmManager::GetInstance()->SendAlarmCritical(
+            ENCRYPT_DECRYPT_FAIL_ALARM,
+            string("decrypt error, project_name:" + bufferMeta.project() + ", key_version:" + ToString(keyVersion)
+                   + ", meta.mLogDataSize:" + ToString(meta.mLogDataSize)),
+            bufferMeta.region(),
+            bufferMeta.project(),
+            "",
+            bufferMeta.logstore());
+    } else {
+        if (bufferMeta.has_logstore())
+            logData = string(des, meta.mLogDataSize);
+        else {
+            // compatible to old buffer file (logGroup string), convert to LZ4 compressed
+            string logGroupStr = string(des, meta.mLogDataSize);
+            sls_logs::LogGroup logGroup;
+            if (!logGroup.ParseFromString(logGroupStr)) {
+                sendResult = true;
+                LOG_ERROR(sLogger, ("parse error from string to loggroup, projectName is", bufferMeta.project()));
+                discardCount++;
+                AlarmManager::GetInstance()->SendAlarmCritical(
+                    LOG_GROUP_PARSE_FAIL_ALARM,
+                    string("projectName is:" + bufferMeta.project() + ", fileName is:" + filename),
+                    bufferMeta.region(),
+                    bufferMeta.project(),
+                    "",
+                    bufferMeta.logstore());
+            } else if (!CompressLz4(logGroupStr, logData)) {
+                sendResult = true;
+                LOG_ERROR(sLogger, ("LZ4 compress loggroup fail, projectName is", bufferMeta.project()));
+                discardCount++;
+                AlarmManager::GetInstance()->SendAlarmCritical(
+                    SEND_COMPRESS_FAIL_ALARM,
+                    string("projectName is:" + bufferMeta.project() + ", fileName is:" + filename),
+                    bufferMeta.region(),
+                    bufferMeta.project(),
+                    "",
+                    bufferMeta.logstore());
+            } else {
+                bufferMeta.set_logstore(logGroup.category());
+                bufferMeta.set_datatype(int(RawDataType::EVENT_GROUP));
+                bufferMeta.set_rawsize(meta.mLogDataSize);
+                bufferMeta.set_compresstype(sls_logs::SLS_CMP_LZ4);
+                bufferMeta.set_telemetrytype(sls_logs::SLS_TELEMETRY_TYPE_LOGS);
+            }
+        }
+        if (!sendResult) {
+            time_t beginTime = time(nullptr);
+            while (true) {
+                string domain;
+                string ip;
+                bool useIPFlag = false;
+                auto response = SendBufferFileData(bufferMeta, logData, domain, ip, useIPFlag);
+                SendResult sendRes = SEND_OK;
+                if (response.mStatusCode != 200) {
+                    sendRes = ConvertErrorCode(response.mErrorCode);
+                }
+                switch (sendRes) {
+                    case SEND_OK:
+                        sendResult = true;
+                        break;
+                    case SEND_NETWORK_ERROR:
+                    case SEND_SERVER_ERROR:
+                        if (response.mErrorMsg != kNoHostErrorMsg) {
+                            LOG_WARNING(
+                                sLogger,
+                                ("send data to SLS fail", "retry later")("request id", response.mRequestId)(
+                                    "error_code", response.mErrorCode)("error_message", response.mErrorMsg)(
+                                    "domain", domain)("ip", ip)("useIPFlag", useIPFlag)("projectName",
+                                                                                        bufferMeta.project())(
+                                    "logstore", bufferMeta.logstore())("rawsize", bufferMeta.rawsize()));
+                        }
+                        usleep(INT32_FLAG(send_retry_sleep_interval));
+                        break;
+                    case SEND_QUOTA_EXCEED:
+                        AlarmManager::GetInstance()->SendAlarmError(
+                            SEND_QUOTA_EXCEED_ALARM,
+                            "error_code: " + response.mErrorCode + ", error_message: " + response.mErrorMsg,
+                            bufferMeta.region(),
+                            bufferMeta.project(),
+                            "",
+                            bufferMeta.logstore());
+                        // no region
+                        if (!GetProfileSender()->IsProfileData("", bufferMeta.project(), bufferMeta.logstore()))
+                            LOG_WARNING(
+                                sLogger,
+                                ("send data to SLS fail", "retry later")("request id", response.mRequestId)(
+                                    "error_code", response.mErrorCode)("error_message", response.mErrorMsg)(
+                                    "domain", domain)("ip", ip)("useIPFlag", useIPFlag)("projectName",
+                                                                                        bufferMeta.project())(
+                                    "logstore", bufferMeta.logstore())("rawsize", bufferMeta.rawsize()));
+                        usleep(INT32_FLAG(quota_exceed_wait_interval));
+                        break;
+                    case SEND_UNAUTHORIZED:
+                        usleep(INT32_FLAG(unauthorized_wait_interval));
+                        break;
+                    default:
+                        sendResult = true;
+                        discardCount++;
+                        break;
+                }
+#ifdef __ENTERPRISE__
+                if (sendRes != SEND_NETWORK_ERROR && sendRes != SEND_SERVER_ERROR) {
+                    bool hasAuthError = sendRes == SEND_UNAUTHORIZED && response.mErrorMsg != kAKErrorMsg;
+                    EnterpriseSLSClientManager::GetInstance()->UpdateAccessKeyStatus(bufferMeta.aliuid(),
+                                                                                     !hasAuthError);
+                    EnterpriseSLSClientManager::GetInstance()->UpdateProjectAnonymousWriteStatus(
+                        bufferMeta.project(), !hasAuthError);
+                }
+#endif
+                if (time(nullptr) - beginTime >= INT32_FLAG(discard_send_fail_interval)) {
+                    sendResult = true;
+                    discardCount++;
+                }
+                if (sendResult || !IsSendBufferThreadRunning()) {
+                    break;
+                }
+            }
+        }
+    }
+    delete[] des;
+    return sendResult;
+}
+
+void DiskBufferWriter::SendBufferSegments(const std::vector<std::string>& segmentsToSend) {
+    size_t threadCnt = min(segmentsToSend.size(),
+                           static_cast<size_t>(max(INT32_FLAG(disk_buffer_segment_send_thread_count), 1)));
+    atomic_size_t nextIdx = 0;
+    auto sendSegments = [&]() {
+        size_t idx = 0;
+        while ((idx = nextIdx.fetch_add(1)) < segmentsToSend.size() && IsSendBufferThreadRunning()) {
+            SendBufferSegment(GetBufferFilePath() + segmentsToSend[idx]);
+        }
+    };
+    vector<future<void>> futures;
+    for (size_t i = 1; i < threadCnt; ++i) {
+        futures.emplace_back(async(launch::async, sendSegments));
+    }
+    sendSegments();
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
+void DiskBufferWriter::SendBufferSegment(const std::string& segmentName) {
+    DiskBufferSegmentReader reader;
+    if (!reader.Open(segmentName)) {
+        string errorStr = ErrnoToString(GetErrno());
+        DiskBufferSegmentReader::Remove(segmentName);
+        LOG_WARNING(sLogger, ("open buffer segment failed, delete segment", segmentName)("error", errorStr));
+        AlarmManager::GetInstance()->SendAlarmCritical(DISCARD_SECONDARY_ALARM,
+                                                       "open buffer segment failed, delete segment: " + segmentName
+                                                           + ", error:" + errorStr);
+        return;
+    }
+    int32_t keyVersion = reader.GetKeyVersion();
+    if (keyVersion < 1 || keyVersion > FileEncryption::GetInstance()->GetDefaultKeyVersion()) {
+        reader.Close();
+        DiskBufferSegmentReader::Remove(segmentName);
+        LOG_ERROR(sLogger, ("invalid key_version in segment header", keyVersion)("delete segment", segmentName));
+        AlarmManager::GetInstance()->SendAlarmCritical(
+            DISCARD_SECONDARY_ALARM, "key version in buffer segment invalid, delete segment: " + segmentName);
+        return;
+    }
+    LOG_INFO(sLogger,
+             ("check local buffer segment", segmentName)("key_version", keyVersion)(
+                 "records", reader.GetRecordCnt())("recovered records", reader.GetRecoveredCnt()));
+
+    string record;
+    EncryptionStateMeta meta;
+    sls_logs::LogtailBufferMeta bufferMeta;
+    const char* encryption = nullptr;
+    int32_t discardCount = 0;
+    bool allHandled = true;
+    for (size_t i = 0; i < reader.GetRecordCnt(); ++i) {
+        if (reader.IsHandled(i)) {
+            continue;
+        }
+        bool sendResult = true;
+        if (!reader.Read(i, record) || !ParseBufferRecord(segmentName, record, meta, bufferMeta, encryption)) {
+            discardCount++;
+        } else if ((time(NULL) - meta.mTimeStamp) > INT32_FLAG(log_expire_time)) {
+            LOG_WARNING(sLogger, ("timeout buffer segment, meta.mTimeStamp", meta.mTimeStamp));
+            AlarmManager::GetInstance()->SendAlarmCritical(DISCARD_SECONDARY_ALARM,
+                                                           "buffer segment timeout (1day), segment: " + segmentName);
+        } else if (!CheckBufferMetaValidation(segmentName, bufferMeta)) {
+            discardCount++;
+        } else {
+            sendResult = SendEncryptedData(segmentName, encryption, meta, keyVersion, bufferMeta, discardCount);
+        }
+        LOG_DEBUG(sLogger,
+                  ("send LogGroup from local buffer segment", segmentName)("rawsize", bufferMeta.rawsize())(
+                      "sendResult", sendResult));
+        if (sendResult) {
+            reader.MarkHandled(i);
+        } else {
+            allHandled = false;
+        }
+        if (!IsSendBufferThreadRunning()) {
+            return;
+        }
+    }
+    reader.Close();
+    if (allHandled) {
+        DiskBufferSegmentReader::Remove(segmentName);
+        if (discardCount > 0) {
+            LOG_ERROR(sLogger,
+                      ("send buffer segment, discard LogGroup count", discardCount)("delete segment", segmentName));
+            AlarmManager::GetInstance()->SendAlarmCritical(DISCARD_SECONDARY_ALARM,
+                                                           "delete buffer segment: " + segmentName + ", discard "
+                                                               + ToString(discardCount) + " logGroups");
+        } else {
+            LOG_INFO(sLogger, ("send buffer segment success, delete buffer segment", segmentName));
+        }
+    }
+}
+
+bool DiskBufferWriter::ParseBufferRecord(const std::string& filename,
+                                         const std::string& record,
+                                         EncryptionStateMeta& meta,
+                                         sls_logs::LogtailBufferMeta& bufferMeta,
+                                         const char*& encryption) {
+    bufferMeta.Clear();
+    if (record.size() < sizeof(meta)) {
+        LOG_ERROR(sLogger, ("record of buffer segment too short", filename)("size", record.size()));
+        return false;
+    }
+    memcpy(&meta, record.data(), sizeof(meta));
+    // records in segments always carry pb meta
+    int32_t encodedInfoSize = meta.mEncodedInfoSize - BUFFER_META_BASE_SIZE;
+    if (meta.mEncryptionSize < 0 || meta.mLogDataSize < 0 || encodedInfoSize < 0
+        || sizeof(meta) + encodedInfoSize + meta.mEncryptionSize != record.size()) {
+        AlarmManager::GetInstance()->SendAlarmCritical(
+            SECONDARY_READ_WRITE_ALARM,
+            string("meta of buffer segment record invalid:" + filename + ", meta.mEncryptionSize:"
+                   + ToString(meta.mEncryptionSize) + ", meta.mEncodedInfoSize:" + ToString(meta.mEncodedInfoSize)));
+        LOG_ERROR(sLogger,
+                  ("meta of buffer segment record invalid", filename)("meta.mEncryptionSize", meta.mEncryptionSize)(
+                      "meta.mEncodedInfoSize", meta.mEncodedInfoSize)("record size", record.size()));
+        return false;
+    }
+    if (!ParseBufferMeta(filename, record.data() + sizeof(meta), encodedInfoSize, true, bufferMeta)) {
+        return false;
+    }
+    encryption = record.data() + sizeof(meta) + encodedInfoSize;
+    return true;
+}
+
+bool DiskBufferWriter::IsSendBufferThreadRunning() const {
+    lock_guard<mutex> lock(mBufferSenderThreadRunningMux);
+    return mIsSendBufferThreadRunning;
+}
+
 // file is not really created when call CreateNewFile(), file created happened when SendToBufferFile() first called
 bool DiskBufferWriter::CreateNewFile() {
-    vector<string> filesToSend;
+    // the current segment must be closed before it can be sent, which happens once mBufferDivideTime is updated
+    mSegmentWriter.Close();
+    vector<string> filesToSend, segmentsToSend;
     int64_t currentTime = time(NULL);
-    if (!LoadFileToSend(currentTime, filesToSend))
+    if (!LoadFileToSend(currentTime, filesToSend, segmentsToSend))
         return false;
-    int32_t bufferFileNumValue = AppConfig::GetInstance()->GetNumOfBufferFile();
-    for (int32_t i = 0; i < (int32_t)filesToSend.size() - bufferFileNumValue; ++i) {
-        string fileName = GetBufferFilePath() + filesToSend[i];
+    vector<string> exceededFiles, exceededSegments;
+    SplitExceededBufferFiles(filesToSend,
+                             segmentsToSend,
+                             AppConfig::GetInstance()->GetNumOfBufferFile(),
+                             exceededFiles,
+                             exceededSegments);
+    for (const auto& file : exceededFiles) {
+        string fileName = GetBufferFilePath() + file;
         if (CheckExistance(fileName)) {
             remove(fileName.c_str());
             LOG_ERROR(sLogger,
@@ -688,6 +917,15 @@ bool DiskBufferWriter::CreateNewFile() {
                                                            "buffer file count exceed, delete file: " + fileName);
         }
     }
+    for (const auto& segment : exceededSegments) {
+        string segmentName = GetBufferFilePath() + segment;
+        DiskBufferSegmentReader::Remove(segmentName);
+        LOG_ERROR(sLogger,
+                  ("buffer segment count exceed limit", "segment created earlier will be cleaned")("delete segment",
+                                                                                                   segmentName));
+        AlarmManager::GetInstance()->SendAlarmCritical(DISCARD_SECONDARY_ALARM,
+                                                       "buffer segment count exceed, delete segment: " + segmentName);
+    }
     mBufferDivideTime = currentTime;
     SetBufferFileName(GetBufferFilePath() + GetSendBufferFileNamePrefix() + ToString(currentTime));
     return true;
@@ -750,6 +988,14 @@ string DiskBufferWriter::GetBufferFileHeader() {
 }
 
 bool DiskBufferWriter::SendToBufferFile(SenderQueueItem* dataPtr) {
+    string record;
+    if (!SerializeToBufferRecord(dataPtr, record)) {
+        return false;
+    }
+    return WriteToBufferFile(dataPtr, record);
+}
+
+bool DiskBufferWriter::WriteToBufferFile(SenderQueueItem* dataPtr, const std::string& record) {
     auto data = static_cast<SLSSenderQueueItem*>(dataPtr);
     auto flusher = static_cast<const FlusherSLS*>(data->mFlusher);
     string bufferFileName = GetBufferFileName();
@@ -790,10 +1036,105 @@ bool DiskBufferWriter::SendToBufferFile(SenderQueueItem* dataPtr) {
         }
     }
 
+    auto nbytes = fwrite(record.data(), 1, record.size(), fout);
+    if (nbytes != record.size()) {
+        string errorStr = ErrnoToString(GetErrno());
+        AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
+                                                       string("write file error:") + bufferFileName
+                                                           + ", error:" + errorStr + ", nbytes:" + ToString(nbytes),
+                                                       flusher->mRegion,
+                                                       flusher->mProject,
+                                                       "",
+                                                       data->mLogstore);
+        LOG_ERROR(
+            sLogger,
+            ("write meta of buffer file", "fail")("filename", bufferFileName)("errorStr", errorStr)("nbytes", nbytes));
+        fclose(fout);
+        return false;
+    }
+    if (ftell(fout) > AppConfig::GetInstance()->GetLocalFileSize())
+        CreateNewFile();
+    fclose(fout);
+    LOG_DEBUG(sLogger, ("write buffer file", bufferFileName));
+    return true;
+}
+
+bool DiskBufferWriter::SendToBufferSegment(const std::vector<SenderQueueItem*>& items) {
+    vector<SenderQueueItem*> itemsToWrite;
+    vector<string> records;
+    itemsToWrite.reserve(items.size());
+    records.reserve(items.size());
+    for (auto item : items) {
+        string record;
+        if (SerializeToBufferRecord(item, record)) {
+            itemsToWrite.push_back(item);
+            records.emplace_back(std::move(record));
+        }
+    }
+    if (records.empty()) {
+        return false;
+    }
+
+    if (!mSegmentWriter.IsOpen()) {
+        if (GetBufferFileName().empty()) {
+            CreateNewFile();
+        }
+        // segments created in the same second are told apart by the sequence number, also across restarts
+        string segmentPrefix = GetBufferFilePath() + GetSendBufferFileNamePrefix() + kSegmentNameInfix
+            + ToString(mBufferDivideTime) + "_";
+        bool opened = false;
+        for (int i = 0; i < 10 && !opened; ++i) {
+            opened = mSegmentWriter.Open(segmentPrefix + ToString(mSegmentSeq++),
+                                         AppConfig::GetInstance()->GetLocalFileSize(),
+                                         FileEncryption::GetInstance()->GetDefaultKeyVersion(),
+                                         BOOL_FLAG(disk_buffer_segment_direct_io));
+            if (!opened && errno != EEXIST) {
+                break;
+            }
+        }
+        if (!opened) {
+            string errorStr = ErrnoToString(GetErrno());
+            LOG_WARNING(sLogger,
+                        ("failed to create buffer segment", "write to buffer file instead")("segment prefix",
+                                                                                           segmentPrefix)("error",
+                                                                                                          errorStr));
+            AlarmManager::GetInstance()->SendAlarmWarning(SECONDARY_READ_WRITE_ALARM,
+                                                          "failed to create buffer segment: " + segmentPrefix
+                                                              + ", error:" + errorStr);
+            bool res = true;
+            for (size_t i = 0; i < records.size(); ++i) {
+                res = WriteToBufferFile(itemsToWrite[i], records[i]) && res;
+            }
+            return res;
+        }
+    }
+
+    if (!mSegmentWriter.Append(records)) {
+        string errorStr = ErrnoToString(GetErrno());
+        AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
+                                                       string("write segment error:") + mSegmentWriter.GetPath()
+                                                           + ", error:" + errorStr
+                                                           + ", records:" + ToString(records.size()));
+        LOG_ERROR(sLogger,
+                  ("write buffer segment", "fail")("segment", mSegmentWriter.GetPath())("errorStr", errorStr)(
+                      "records", records.size()));
+        // the segment may be torn, and records written so far are still readable
+        CreateNewFile();
+        return false;
+    }
+    LOG_DEBUG(sLogger, ("write buffer segment", mSegmentWriter.GetPath())("records", records.size()));
+    if (mSegmentWriter.GetSize() > static_cast<uint64_t>(AppConfig::GetInstance()->GetLocalFileSize())) {
+        CreateNewFile();
+    }
+    return true;
+}
+
+bool DiskBufferWriter::SerializeToBufferRecord(SenderQueueItem* dataPtr, std::string& record) {
+    auto data = static_cast<SLSSenderQueueItem*>(dataPtr);
+    auto flusher = static_cast<const FlusherSLS*>(data->mFlusher);
     char* des;
     int32_t desLength;
     if (!FileEncryption::GetInstance()->Encrypt(data->mData.c_str(), data->mData.size(), des, desLength)) {
-        fclose(fout);
         LOG_ERROR(sLogger, ("encrypt error, project_name", flusher->mProject));
         AlarmManager::GetInstance()->SendAlarmCritical(ENCRYPT_DECRYPT_FAIL_ALARM,
                                                        string("encrypt error, project_name:" + flusher->mProject),
@@ -831,34 +1172,11 @@ bool DiskBufferWriter::SendToBufferFile(SenderQueueItem* dataPtr) {
     meta.mHandled = 0;
     meta.mRetryTime = 0;
     meta.mEncryptionSize = desLength;
-    char* buffer = new char[sizeof(meta) + encodedInfoSize + meta.mEncryptionSize];
-    memcpy(buffer, (char*)&meta, sizeof(meta));
-    memcpy(buffer + sizeof(meta), encodedInfo.c_str(), encodedInfoSize);
-    memcpy(buffer + sizeof(meta) + encodedInfoSize, des, desLength);
+    record.reserve(sizeof(meta) + encodedInfoSize + meta.mEncryptionSize);
+    record.assign(reinterpret_cast<const char*>(&meta), sizeof(meta));
+    record.append(encodedInfo);
+    record.append(des, desLength);
     delete[] des;
-    const auto bytesToWrite = sizeof(meta) + encodedInfoSize + meta.mEncryptionSize;
-    auto nbytes = fwrite(buffer, 1, bytesToWrite, fout);
-    if (nbytes != bytesToWrite) {
-        string errorStr = ErrnoToString(GetErrno());
-        AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
-                                                       string("write file error:") + bufferFileName
-                                                           + ", error:" + errorStr + ", nbytes:" + ToString(nbytes),
-                                                       flusher->mRegion,
-                                                       flusher->mProject,
-                                                       "",
-                                                       data->mLogstore);
-        LOG_ERROR(
-            sLogger,
-            ("write meta of buffer file", "fail")("filename", bufferFileName)("errorStr", errorStr)("nbytes", nbytes));
-        delete[] buffer;
-        fclose(fout);
-        return false;
-    }
-    delete[] buffer;
-    if (ftell(fout) > AppConfig::GetInstance()->GetLocalFileSize())
-        CreateNewFile();
-    fclose(fout);
-    LOG_DEBUG(sLogger, ("write buffer file", bufferFileName));
     return true;
 }
 
@@ -867,7 +1185,16 @@ SLSResponse DiskBufferWriter::SendBufferFileData(const sls_logs::LogtailBufferMe
                                                  std::string& domain,
                                                  std::string& ip,
                                                  bool useIPFlag) {
-    RateLimiter::FlowControl(bufferMeta.rawsize(), mSendLastTime, mSendLastByte, false);
+#ifdef APSARA_UNIT_TEST_MAIN
+    if (mSendBufferFileDataHook) {
+        return mSendBufferFileDataHook(bufferMeta, logData);
+    }
+#endif
+    {
+        // shared by all threads sending segments
+        lock_guard<mutex> lock(mSendFlowControlMux);
+        RateLimiter::FlowControl(bufferMeta.rawsize(), mSendLastTime, mSendLastByte, false);
+    }
     string region = bufferMeta.region();
 #ifdef __ENTERPRISE__
     // old buffer file which record the endpoint
@@ -904,7 +1231,10 @@ SLSResponse DiskBufferWriter::SendBufferFileData(const sls_logs::LogtailBufferMe
     }
     auto info = EnterpriseSLSClientManager::GetInstance()->GetCandidateHostsInfo(
         region, bufferMeta.project(), GetEndpointMode(bufferMeta.endpointmode()));
-    mCandidateHostsInfos.insert(info);
+    {
+        lock_guard<mutex> lock(mCandidateHostsInfosMux);
+        mCandidateHostsInfos.insert(info);
+    }
 
     domain = info->GetCurrentHost();
     if (domain.empty()) {
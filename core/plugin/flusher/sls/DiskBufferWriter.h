@@ -21,6 +21,7 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <functional>
 #include <future>
 #include <memory>
 #include <mutex>
@@ -29,6 +30,7 @@
 
 #include "collection_pipeline/queue/SenderQueueItem.h"
 #include "common/SafeQueue.h"
+#include "plugin/flusher/sls/DiskBufferSegment.h"
 #include "plugin/flusher/sls/SLSClientManager.h"
 #include "plugin/flusher/sls/SLSResponse.h"
 #include "protobuf/sls/logtail_buffer_meta.pb.h"
@@ -80,7 +82,13 @@ private:
                                    std::string& ip,
                                    bool useIPFlag);
     bool SendToBufferFile(SenderQueueItem* dataPtr);
-    bool LoadFileToSend(time_t timeLine, std::vector<std::string>& filesToSend);
+    bool WriteToBufferFile(SenderQueueItem* dataPtr, const std::string& record);
+    // write all items with one write to the current segment, rolling over to a new one when it is full
+    bool SendToBufferSegment(const std::vector<SenderQueueItem*>& items);
+    bool SerializeToBufferRecord(SenderQueueItem* dataPtr, std::string& record);
+    bool LoadFileToSend(time_t timeLine,
+                        std::vector<std::string>& filesToSend,
+                        std::vector<std::string>& segmentsToSend);
     bool CreateNewFile();
     bool WriteBackMeta(const int32_t pos, const void* buf, int32_t length, const std::string& filename);
     bool ReadNextEncryption(int32_t& pos,
@@ -90,6 +98,27 @@ private:
                             bool& readResult,
                             sls_logs::LogtailBufferMeta& bufferMeta);
     void SendEncryptionBuffer(const std::string& filename, int32_t keyVersion);
+    // segments are sent in parallel, each by one thread
+    void SendBufferSegments(const std::vector<std::string>& segmentsToSend);
+    void SendBufferSegment(const std::string& segmentName);
+    bool ParseBufferRecord(const std::string& filename,
+                           const std::string& record,
+                           EncryptionStateMeta& meta,
+                           sls_logs::LogtailBufferMeta& bufferMeta,
+                           const char*& encryption);
+    bool ParseBufferMeta(const std::string& filename,
+                         const char* encodedInfo,
+                         int32_t encodedInfoSize,
+                         bool pbMeta,
+                         sls_logs::LogtailBufferMeta& bufferMeta);
+    // returns true if the data is either sent or discarded
+    bool SendEncryptedData(const std::string& filename,
+                           const char* encryption,
+                           const EncryptionStateMeta& meta,
+                           int32_t keyVersion,
+                           sls_logs::LogtailBufferMeta& bufferMeta,
+                           int32_t& discardCount);
+    bool IsSendBufferThreadRunning() const;
     void SetBufferFilePath(const std::string& bufferfilepath);
     std::string GetBufferFilePath();
     std::string GetBufferFileName();
@@ -121,6 +150,7 @@ private:
         }
     };
 
+    std::mutex mCandidateHostsInfosMux;
     std::unordered_set<std::shared_ptr<CandidateHostsInfo>, PointerHash, PointerEqual> mCandidateHostsInfos;
 #endif
 
@@ -131,8 +161,20 @@ private:
     volatile time_t mBufferDivideTime = 0;
     int64_t mCheckPeriod = 0;
 
+    // only accessed by the buffer writer thread
+    DiskBufferSegmentWriter mSegmentWriter;
+    uint32_t mSegmentSeq = 0;
+
+    std::mutex mSendFlowControlMux;
     int64_t mSendLastTime = 0;
     int32_t mSendLastByte = 0;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    // sends buffered data instead of SLS if set
+    std::function<SLSResponse(const sls_logs::LogtailBufferMeta&, const std::string&)> mSendBufferFileDataHook;
+
+    friend class DiskBufferWriterUnittest;
+#endif
 };
 
 } // namespace logtail
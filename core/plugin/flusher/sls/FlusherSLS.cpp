@@ -1021,7 +1021,8 @@ void FlusherSLS::GenerateGoPlugin(const Json::Value& config, Json::Value& res) c
 }
 
 bool FlusherSLS::SerializeAndPush(PipelineEventGroup&& group) {
-    string serializedData, compressedData;
+    string compressedData;
+    size_t rawSize = 0;
     BatchedEvents g(std::move(group.MutableEvents()),
                     std::move(group.GetSizedTags()),
                     std::move(group.GetSourceBuffer()),
@@ -1031,44 +1032,14 @@ bool FlusherSLS::SerializeAndPush(PipelineEventGroup&& group) {
         g.mSourceBuffers.emplace_back(extraSourceBuffer);
     }
     AddPackId(g);
-    string errorMsg;
-    if (!mGroupSerializer->DoSerialize(std::move(g), serializedData, errorMsg)) {
-        LOG_WARNING(mContext->GetLogger(),
-                    ("failed to serialize event group",
-                     errorMsg)("action", "discard data")("plugin", sName)("config", mContext->GetConfigName()));
-        mContext->GetAlarm().SendAlarmWarning(SERIALIZE_FAIL_ALARM,
-                                              "failed to serialize event group: " + errorMsg
-                                                  + "\taction: discard data\tplugin: " + sName
-                                                  + "\tconfig: " + mContext->GetConfigName(),
-                                              mContext->GetRegion(),
-                                              mContext->GetProjectName(),
-                                              mContext->GetConfigName(),
-                                              mContext->GetLogstoreName());
+    if (!SerializeAndCompress(std::move(g), compressedData, rawSize)) {
         return false;
     }
-    if (mCompressor) {
-        if (!mCompressor->DoCompress(serializedData, compressedData, errorMsg)) {
-            LOG_WARNING(mContext->GetLogger(),
-                        ("failed to compress event group",
-                         errorMsg)("action", "discard data")("plugin", sName)("config", mContext->GetConfigName()));
-            mContext->GetAlarm().SendAlarmWarning(COMPRESS_FAIL_ALARM,
-                                                  "failed to compress event group: " + errorMsg
-                                                      + "\taction: discard data\tplugin: " + sName
-                                                      + "\tconfig: " + mContext->GetConfigName(),
-                                                  mContext->GetRegion(),
-                                                  mContext->GetProjectName(),
-                                                  mContext->GetConfigName(),
-                                                  mContext->GetLogstoreName());
-            return false;
-        }
-    } else {
-        compressedData = serializedData;
-    }
     // must create a tmp, because eoo checkpoint is moved in second param
     auto fbKey = g.mExactlyOnceCheckpoint->fbKey;
     return PushToQueue(fbKey,
                        make_unique<SLSSenderQueueItem>(std::move(compressedData),
-                                                       serializedData.size(),
+                                                       rawSize,
                                                        this,
                                                        fbKey,
                                                        mLogstore,
@@ -1083,7 +1054,7 @@ bool FlusherSLS::SerializeAndPush(BatchedEventsList&& groupList) {
         return true;
     }
     vector<CompressedLogGroup> compressedLogGroups;
-    string shardHashKey, serializedData, compressedData;
+    string shardHashKey, compressedData;
     size_t packageSize = 0;
     bool enablePackageList = groupList.size() > 1;
 
@@ -1093,44 +1064,14 @@ bool FlusherSLS::SerializeAndPush(BatchedEventsList&& groupList) {
             shardHashKey = GetShardHashKey(group);
         }
         AddPackId(group);
-        string errorMsg;
-        if (!mGroupSerializer->DoSerialize(std::move(group), serializedData, errorMsg)) {
-            LOG_WARNING(mContext->GetLogger(),
-                        ("failed to serialize event group",
-                         errorMsg)("action", "discard data")("plugin", sName)("config", mContext->GetConfigName()));
-            mContext->GetAlarm().SendAlarmWarning(SERIALIZE_FAIL_ALARM,
-                                                  "failed to serialize event group: " + errorMsg
-                                                      + "\taction: discard data\tplugin: " + sName
-                                                      + "\tconfig: " + mContext->GetConfigName(),
-                                                  mContext->GetRegion(),
-                                                  mContext->GetProjectName(),
-                                                  mContext->GetConfigName(),
-                                                  mContext->GetLogstoreName());
+        size_t rawSize = 0;
+        if (!SerializeAndCompress(std::move(group), compressedData, rawSize)) {
             allSucceeded = false;
             continue;
         }
-        if (mCompressor) {
-            if (!mCompressor->DoCompress(serializedData, compressedData, errorMsg)) {
-                LOG_WARNING(mContext->GetLogger(),
-                            ("failed to compress event group",
-                             errorMsg)("action", "discard data")("plugin", sName)("config", mContext->GetConfigName()));
-                mContext->GetAlarm().SendAlarmWarning(COMPRESS_FAIL_ALARM,
-                                                      "failed to compress event group: " + errorMsg
-                                                          + "\taction: discard data\tplugin: " + sName
-                                                          + "\tconfig: " + mContext->GetConfigName(),
-                                                      mContext->GetRegion(),
-                                                      mContext->GetProjectName(),
-                                                      mContext->GetConfigName(),
-                                                      mContext->GetLogstoreName());
-                allSucceeded = false;
-                continue;
-            }
-        } else {
-            compressedData = serializedData;
-        }
         if (enablePackageList) {
-            packageSize += serializedData.size();
-            compressedLogGroups.emplace_back(std::move(compressedData), serializedData.size());
+            packageSize += rawSize;
+            compressedLogGroups.emplace_back(std::move(compressedData), rawSize);
         } else {
             if (group.mExactlyOnceCheckpoint) {
                 // must create a tmp, because eoo checkpoint is moved in second param
@@ -1138,7 +1079,7 @@ bool FlusherSLS::SerializeAndPush(BatchedEventsList&& groupList) {
                 allSucceeded
                     = PushToQueue(fbKey,
                                   make_unique<SLSSenderQueueItem>(std::move(compressedData),
-                                                                  serializedData.size(),
+                                                                  rawSize,
                                                                   this,
                                                                   fbKey,
                                                                   mLogstore,
@@ -1149,7 +1090,7 @@ bool FlusherSLS::SerializeAndPush(BatchedEventsList&& groupList) {
                     && allSucceeded;
             } else {
                 allSucceeded = Flusher::PushToQueue(make_unique<SLSSenderQueueItem>(std::move(compressedData),
-                                                                                    serializedData.size(),
+                                                                                    rawSize,
                                                                                     this,
                                                                                     mQueueKey,
                                                                                     mLogstore,
@@ -1160,7 +1101,7 @@ bool FlusherSLS::SerializeAndPush(BatchedEventsList&& groupList) {
         }
     }
     if (enablePackageList) {
-        string errorMsg;
+        string serializedData, errorMsg;
         mGroupListSerializer->DoSerialize(std::move(compressedLogGroups), serializedData, errorMsg);
         allSucceeded
             = Flusher::PushToQueue(make_unique<SLSSenderQueueItem>(
@@ -1170,6 +1111,47 @@ bool FlusherSLS::SerializeAndPush(BatchedEventsList&& groupList) {
     return allSucceeded;
 }
 
+bool FlusherSLS::SerializeAndCompress(BatchedEvents&& g, string& compressedData, size_t& rawSize) {
+    string errorMsg;
+    if (!mCompressor) {
+        if (!mGroupSerializer->DoSerialize(std::move(g), compressedData, errorMsg)) {
+            LOG_WARNING(mContext->GetLogger(),
+                        ("failed to serialize event group",
+                         errorMsg)("action", "discard data")("plugin", sName)("config", mContext->GetConfigName()));
+            mContext->GetAlarm().SendAlarmWarning(SERIALIZE_FAIL_ALARM,
+                                                  "failed to serialize event group: " + errorMsg
+                                                      + "\taction: discard data\tplugin: " + sName
+                                                      + "\tconfig: " + mContext->GetConfigName(),
+                                                  mContext->GetRegion(),
+                                                  mContext->GetProjectName(),
+                                                  mContext->GetConfigName(),
+                                                  mContext->GetLogstoreName());
+            return false;
+        }
+        rawSize = compressedData.size();
+        return true;
+    }
+    // serialized data is compressed chunk by chunk when the compressor supports streaming, and is never held as a whole
+    bool compressFailed = false;
+    if (!mGroupSerializer->DoSerializeAndCompress(
+            std::move(g), *mCompressor, compressedData, rawSize, errorMsg, compressFailed)) {
+        string step = compressFailed ? "compress" : "serialize";
+        LOG_WARNING(mContext->GetLogger(),
+                    ("failed to " + step + " event group",
+                     errorMsg)("action", "discard data")("plugin", sName)("config", mContext->GetConfigName()));
+        mContext->GetAlarm().SendAlarmWarning(compressFailed ? COMPRESS_FAIL_ALARM : SERIALIZE_FAIL_ALARM,
+                                              "failed to " + step + " event group: " + errorMsg
+                                                  + "\taction: discard data\tplugin: " + sName
+                                                  + "\tconfig: " + mContext->GetConfigName(),
+                                              mContext->GetRegion(),
+                                              mContext->GetProjectName(),
+                                              mContext->GetConfigName(),
+                                              mContext->GetLogstoreName());
+        return false;
+    }
+    return true;
+}
+
 bool FlusherSLS::SerializeAndPush(vector<BatchedEventsList>&& groupLists) {
     bool allSucceeded = true;
     for (auto& groupList : groupLists) {
@@ -0,0 +1,277 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "plugin/processor/CompiledFilter.h"
+
+#include <cstring>
+
+#include <algorithm>
+
+#include "common/StringTools.h"
+
+using namespace std;
+
+namespace logtail {
+
+namespace {
+
+enum MatchState : uint8_t { UNKNOWN = 0, UNMATCHED, MATCHED };
+enum KeyState : uint8_t { KEY_UNKNOWN = 0, KEY_ABSENT, KEY_PRESENT };
+
+// large enough for a set of dozens of patterns, otherwise the DFA may run out of memory and report no match
+const int64_t kRE2MaxMem = 64 * 1024 * 1024;
+
+struct MatchContext {
+    vector<uint8_t> mPatternStates;
+    vector<uint8_t> mKeyStates;
+    vector<StringView> mValues;
+    vector<int> mSetMatches;
+};
+
+MatchContext& GetMatchContext() {
+    static thread_local MatchContext sContext;
+    return sContext;
+}
+
+// Returns the literal every full match of @exp must start with, which may be empty.
+string GetLiteralPrefix(const string& exp) {
+    // alternation may make any prefix optional
+    if (exp.find('|') != string::npos) {
+        return "";
+    }
+    string prefix;
+    for (size_t i = (!exp.empty() && exp[0] == '^') ? 1 : 0; i < exp.size(); ++i) {
+        char c = exp[i];
+        if (c == '\0' || strchr(".[]()*+?{}|^$\\", c) != nullptr) {
+            // the last literal is optional
+            if ((c == '*' || c == '?' || c == '{') && !prefix.empty()) {
+                prefix.pop_back();
+            }
+            break;
+        }
+        prefix += c;
+    }
+    return prefix;
+}
+
+bool HasPrefix(StringView value, const string& prefix) {
+    return value.size() >= prefix.size() && memcmp(value.data(), prefix.data(), prefix.size()) == 0;
+}
+
+} // namespace
+
+uint32_t CompiledFilter::AddPattern(const string& key, const string& exp) {
+    uint32_t keyIdx = 0;
+    for (; keyIdx < mKeys.size(); ++keyIdx) {
+        if (mKeys[keyIdx].mName == key) {
+            break;
+        }
+    }
+    if (keyIdx == mKeys.size()) {
+        mKeys.emplace_back();
+        mKeys.back().mName = key;
+    }
+    // the same condition may appear in several branches of the expression
+    for (uint32_t i = 0; i < mPatterns.size(); ++i) {
+        if (mPatterns[i].mKeyIdx == keyIdx && mPatterns[i].mExp == exp) {
+            return i;
+        }
+    }
+    mPatterns.emplace_back();
+    mPatterns.back().mKeyIdx = keyIdx;
+    mPatterns.back().mExp = exp;
+    mPatterns.back().mLiteralPrefix = GetLiteralPrefix(exp);
+    return mPatterns.size() - 1;
+}
+
+void CompiledFilter::EmitTest(uint32_t patternId) {
+    mProgram.push_back({OpCode::TEST, patternId});
+}
+
+void CompiledFilter::EmitNot() {
+    mProgram.push_back({OpCode::NOT, 0});
+}
+
+size_t CompiledFilter::EmitJump(OpCode op) {
+    mProgram.push_back({op, 0});
+    return mProgram.size() - 1;
+}
+
+void CompiledFilter::PatchJump(size_t pos) {
+    mProgram[pos].mArg = mProgram.size();
+}
+
+bool CompiledFilter::Build(string& errorMsg) {
+    RE2::Options options;
+    // boost::regex works on bytes
+    options.set_encoding(RE2::Options::EncodingLatin1);
+    options.set_dot_nl(true);
+    options.set_log_errors(false);
+    options.set_max_mem(kRE2MaxMem);
+
+    vector<string> translatedExps(mPatterns.size());
+    for (uint32_t i = 0; i < mPatterns.size(); ++i) {
+        auto& pattern = mPatterns[i];
+        if (TranslateToRE2(pattern.mExp, translatedExps[i]) && RE2(translatedExps[i], options).ok()) {
+            mKeys[pattern.mKeyIdx].mRE2Patterns.push_back(i);
+        }
+    }
+    for (auto& key : mKeys) {
+        for (auto id : key.mRE2Patterns) {
+            key.mRegexes.emplace_back(make_unique<RE2>(translatedExps[id], options));
+        }
+        if (key.mRE2Patterns.size() > 1) {
+            key.mSet = make_unique<RE2::Set>(options, RE2::ANCHOR_BOTH);
+            bool ok = true;
+            for (auto id : key.mRE2Patterns) {
+                string error;
+                if (key.mSet->Add(translatedExps[id], &error) < 0) {
+                    ok = false;
+                    break;
+                }
+            }
+            if (!ok || !key.mSet->Compile()) {
+                // leave all patterns on this key to boost
+                key.mSet.reset();
+                key.mRE2Patterns.clear();
+                key.mRegexes.clear();
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < mPatterns.size(); ++i) {
+        auto& pattern = mPatterns[i];
+        const auto& re2Patterns = mKeys[pattern.mKeyIdx].mRE2Patterns;
+        if (find(re2Patterns.begin(), re2Patterns.end(), i) != re2Patterns.end()) {
+            continue;
+        }
+        try {
+            pattern.mBoostReg = make_unique<boost::regex>(pattern.mExp);
+        } catch (const exception& e) {
+            errorMsg = "invalid regex " + pattern.mExp + ": " + e.what();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CompiledFilter::Match(const LogEvent& event, string& exception) const {
+    auto& context = GetMatchContext();
+    context.mPatternStates.assign(mPatterns.size(), UNKNOWN);
+    context.mKeyStates.assign(mKeys.size(), KEY_UNKNOWN);
+    context.mValues.resize(mKeys.size());
+
+    bool res = true;
+    size_t pc = 0;
+    while (pc < mProgram.size()) {
+        const auto& ins = mProgram[pc];
+        switch (ins.mOp) {
+            case OpCode::TEST: {
+                auto& state = context.mPatternStates[ins.mArg];
+                if (state == UNKNOWN) {
+                    const auto& pattern = mPatterns[ins.mArg];
+                    auto& keyState = context.mKeyStates[pattern.mKeyIdx];
+                    auto& value = context.mValues[pattern.mKeyIdx];
+                    if (keyState == KEY_UNKNOWN) {
+                        auto content = event.FindContent(mKeys[pattern.mKeyIdx].mName);
+                        if (content == event.end()) {
+                            keyState = KEY_ABSENT;
+                        } else {
+                            keyState = KEY_PRESENT;
+                            value = content->second;
+                        }
+                    }
+                    if (keyState == KEY_ABSENT || !HasPrefix(value, pattern.mLiteralPrefix)) {
+                        state = UNMATCHED;
+                    } else if (pattern.mBoostReg) {
+                        state = BoostRegexMatch(value.data(), value.size(), *pattern.mBoostReg, exception) ? MATCHED
+                                                                                                          : UNMATCHED;
+                    } else {
+                        MatchKeyWithRE2(mKeys[pattern.mKeyIdx], value, context.mPatternStates);
+                    }
+                }
+                res = state == MATCHED;
+                ++pc;
+                break;
+            }
+            case OpCode::NOT:
+                res = !res;
+                ++pc;
+                break;
+            case OpCode::JUMP_IF_FALSE:
+                pc = res ? pc + 1 : ins.mArg;
+                break;
+            case OpCode::JUMP_IF_TRUE:
+                pc = res ? ins.mArg : pc + 1;
+                break;
+        }
+    }
+    return res;
+}
+
+size_t CompiledFilter::GetRE2PatternCnt() const {
+    size_t cnt = 0;
+    for (const auto& key : mKeys) {
+        cnt += key.mRE2Patterns.size();
+    }
+    return cnt;
+}
+
+void CompiledFilter::MatchKeyWithRE2(const Key& key, StringView value, vector<uint8_t>& states) const {
+    re2::StringPiece text(value.data(), value.size());
+    bool matchOneByOne = !key.mSet;
+    if (key.mSet) {
+        // the set is only worth running if any pattern passes its prefix check
+        bool hasCandidate = false;
+        for (auto id : key.mRE2Patterns) {
+            if (HasPrefix(value, mPatterns[id].mLiteralPrefix)) {
+                hasCandidate = true;
+                break;
+            }
+        }
+        if (hasCandidate) {
+            auto& matches = GetMatchContext().mSetMatches;
+            RE2::Set::ErrorInfo errorInfo{RE2::Set::kNoError};
+            bool setMatched = key.mSet->Match(text, &matches, &errorInfo);
+#ifdef APSARA_UNIT_TEST_MAIN
+            if (mSetMatchErrorForTest) {
+                setMatched = false;
+                errorInfo.kind = RE2::Set::kOutOfMemory;
+            }
+#endif
+            if (setMatched) {
+                for (auto idx : matches) {
+                    states[key.mRE2Patterns[idx]] = MATCHED;
+                }
+            } else if (errorInfo.kind != RE2::Set::kNoError) {
+                // e.g. the DFA runs out of memory, in which case nothing can be told from the set
+                matchOneByOne = true;
+            }
+        }
+    }
+    if (matchOneByOne) {
+        for (size_t i = 0; i < key.mRE2Patterns.size(); ++i) {
+            if (RE2::FullMatch(text, *key.mRegexes[i])) {
+                states[key.mRE2Patterns[i]] = MATCHED;
+            }
+        }
+    }
+    for (auto id : key.mRE2Patterns) {
+        if (states[id] == UNKNOWN) {
+            states[id] = UNMATCHED;
+        }
+    }
+}
+
+} // namespace logtail
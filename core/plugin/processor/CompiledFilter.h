@@ -0,0 +1,100 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "boost/regex.hpp"
+#include "re2/re2.h"
+#include "re2/set.h"
+
+#include "models/LogEvent.h"
+
+namespace logtail {
+
+// Filter conditions of ProcessorFilterNative compiled into a linear program.
+// All patterns on the same key are merged into one RE2::Set, so that a value is scanned once no matter how many
+// patterns refer to it, and the boolean tree is flattened into instructions with short-circuit jumps, so no virtual
+// call is needed per node. Patterns with a literal prefix are rejected without running any regex if the value does not
+// start with the prefix. Patterns RE2 cannot handle the same way as boost::regex (e.g. backreferences, lookarounds, ^
+// or $ in the middle) are still matched by boost::regex.
+// Immutable after Build, and thus can be shared by all processing threads.
+class CompiledFilter {
+public:
+    enum class OpCode : uint8_t { TEST, NOT, JUMP_IF_FALSE, JUMP_IF_TRUE };
+
+    struct Instruction {
+        OpCode mOp;
+        // pattern id for TEST, target position for jumps
+        uint32_t mArg = 0;
+    };
+
+    // returns the pattern id, which should be used by EmitTest
+    uint32_t AddPattern(const std::string& key, const std::string& exp);
+    void EmitTest(uint32_t patternId);
+    void EmitNot();
+    // returns the position of the jump, whose target is set by PatchJump once known
+    size_t EmitJump(OpCode op);
+    // let the jump at @pos go to the next instruction to be emitted
+    void PatchJump(size_t pos);
+    bool Build(std::string& errorMsg);
+
+    // regex exceptions, if any, are appended to @exception, and the pattern is taken as unmatched
+    bool Match(const LogEvent& event, std::string& exception) const;
+
+    size_t GetPatternCnt() const { return mPatterns.size(); }
+    size_t GetRE2PatternCnt() const;
+    size_t GetKeyCnt() const { return mKeys.size(); }
+
+private:
+    struct Pattern {
+        uint32_t mKeyIdx = 0;
+        std::string mExp;
+        std::string mLiteralPrefix;
+        // only for patterns not handled by RE2
+        std::unique_ptr<boost::regex> mBoostReg;
+    };
+
+    struct Key {
+        std::string mName;
+        // patterns handled by RE2, ordered by their index in mSet
+        std::vector<uint32_t> mRE2Patterns;
+        // used when more than one pattern is handled by RE2
+        std::unique_ptr<RE2::Set> mSet;
+        // one for each pattern in mRE2Patterns, used when there is no set or the set fails to match
+        std::vector<std::unique_ptr<RE2>> mRegexes;
+    };
+
+    void MatchKeyWithRE2(const Key& key, StringView value, std::vector<uint8_t>& states) const;
+
+    std::vector<Pattern> mPatterns;
+    std::vector<Key> mKeys;
+    std::vector<Instruction> mProgram;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    // makes matching the sets fail as when the DFA runs out of memory, which cannot be triggered reliably
+    bool mSetMatchErrorForTest = false;
+
+    friend class ProcessorFilterNativeUnittest;
+#endif
+};
+
+} // namespace logtail
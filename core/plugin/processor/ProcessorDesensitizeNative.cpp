@@ -15,14 +15,149 @@
  */
 #include "plugin/processor/ProcessorDesensitizeNative.h"
 
+#include <cctype>
+#include <cstring>
+
+#include <algorithm>
+
 #include "collection_pipeline/plugin/instance/ProcessorInstance.h"
+#include "common/CharSearch.h"
 #include "common/HashUtil.h"
 #include "common/ParamExtractor.h"
+#include "common/StringTools.h"
 #include "models/LogEvent.h"
 #include "monitor/metric_constants/MetricConstants.h"
 
 namespace logtail {
 
+namespace {
+
+// large enough for a set of dozens of rules, otherwise the DFA may run out of memory and report no match
+const int64_t kRuleSetMaxMem = 64 * 1024 * 1024;
+
+void PopLastChar(std::string& str) {
+    // patterns are in utf-8
+    while (!str.empty() && (static_cast<unsigned char>(str.back()) & 0xc0) == 0x80) {
+        str.pop_back();
+    }
+    if (!str.empty()) {
+        str.pop_back();
+    }
+}
+
+bool IsCaseInsensitive(const std::string& pattern) {
+    for (size_t pos = pattern.find("(?"); pos != std::string::npos; pos = pattern.find("(?", pos + 2)) {
+        for (size_t i = pos + 2; i < pattern.size() && pattern[i] != ')' && pattern[i] != ':'; ++i) {
+            if (pattern[i] == 'i') {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Returns the longest literal that every match of @pattern must contain, or empty if none is found. Only literals at
+// the top level of the pattern are considered.
+std::string GetRequiredLiteral(const std::string& pattern) {
+    if (IsCaseInsensitive(pattern)) {
+        return "";
+    }
+    std::string best, run;
+    auto finishRun = [&]() {
+        if (run.size() > best.size()) {
+            best = run;
+        }
+        run.clear();
+    };
+    int depth = 0;
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        char c = pattern[i];
+        switch (c) {
+            case '\\': {
+                if (i + 1 == pattern.size()) {
+                    return "";
+                }
+                char next = pattern[++i];
+                if (depth == 0 && ispunct(static_cast<unsigned char>(next))) {
+                    run += next;
+                    break;
+                }
+                finishRun();
+                // skip the arguments of escapes like \x41, \x{41}, \pL, \p{Greek} and \012
+                if (next == 'x' || next == 'p' || next == 'P') {
+                    if (i + 1 < pattern.size() && pattern[i + 1] == '{') {
+                        i = std::min(pattern.find('}', i), pattern.size() - 1);
+                    } else {
+                        i = std::min(i + (next == 'x' ? 2 : 1), pattern.size() - 1);
+                    }
+                } else if (isdigit(static_cast<unsigned char>(next))) {
+                    while (i + 1 < pattern.size() && isdigit(static_cast<unsigned char>(pattern[i + 1]))) {
+                        ++i;
+                    }
+                }
+                break;
+            }
+            case '[':
+                finishRun();
+                // skip the class, where a leading ] is a literal
+                ++i;
+                if (i < pattern.size() && pattern[i] == '^') {
+                    ++i;
+                }
+                if (i < pattern.size() && pattern[i] == ']') {
+                    ++i;
+                }
+                for (; i < pattern.size() && pattern[i] != ']'; ++i) {
+                    if (pattern[i] == '\\') {
+                        ++i;
+                    } else if (pattern[i] == '[' && i + 1 < pattern.size() && pattern[i + 1] == ':') {
+                        i = std::min(pattern.find(":]", i), pattern.size() - 1) + 1;
+                    }
+                }
+                break;
+            case '(':
+                finishRun();
+                ++depth;
+                break;
+            case ')':
+                --depth;
+                break;
+            case '|':
+                if (depth == 0) {
+                    return "";
+                }
+                break;
+            case '*':
+            case '?':
+            case '{':
+                // the last char is optional
+                if (depth == 0) {
+                    PopLastChar(run);
+                }
+                finishRun();
+                if (c == '{') {
+                    i = std::min(pattern.find('}', i), pattern.size() - 1);
+                }
+                break;
+            case '+':
+            case '.':
+            case '^':
+            case '$':
+                finishRun();
+                break;
+            default:
+                if (depth == 0) {
+                    run += c;
+                }
+                break;
+        }
+    }
+    finishRun();
+    return best;
+}
+
+} // namespace
+
 const std::string ProcessorDesensitizeNative::sName = "processor_desensitize_native";
 
 bool ProcessorDesensitizeNative::Init(const Json::Value& config) {
@@ -107,10 +242,7 @@ bool ProcessorDesensitizeNative::Init(const Json::Value& config) {
                            mContext->GetRegion());
     }
 
-    std::string regexStr = std::string("(") + mContentPatternBeforeReplacedString + ")" + mReplacedContentPattern;
-    mRegex.reset(new re2::RE2(regexStr));
-    if (!mRegex->ok()) {
-        errorMsg = mRegex->error();
+    if (!AddRule(mContentPatternBeforeReplacedString, mReplacedContentPattern, mReplacingString, errorMsg)) {
         PARAM_ERROR_RETURN(mContext->GetLogger(),
                            mContext->GetAlarm(),
                            "param ContentPatternBeforeReplacedString or ReplacedContentPattern is not a valid regex: "
@@ -122,6 +254,71 @@ bool ProcessorDesensitizeNative::Init(const Json::Value& config) {
                            mContext->GetRegion());
     }
 
+    // Rules
+    const char* key = "Rules";
+    const Json::Value* itr = config.find(key, key + strlen(key));
+    if (itr) {
+        if (!itr->isArray()) {
+            PARAM_ERROR_RETURN(mContext->GetLogger(),
+                               mContext->GetAlarm(),
+                               "param Rules is not of type array",
+                               sName,
+                               mContext->GetConfigName(),
+                               mContext->GetProjectName(),
+                               mContext->GetLogstoreName(),
+                               mContext->GetRegion());
+        }
+        for (Json::Value::ArrayIndex i = 0; i < itr->size(); ++i) {
+            const Json::Value& ruleConfig = (*itr)[i];
+            std::string prefix = "Rules[" + ToString(i) + "].";
+            std::string before, replaced, replacing;
+            if (!ruleConfig.isObject()) {
+                errorMsg = "param " + prefix.substr(0, prefix.size() - 1) + " is not of type object";
+            } else if (GetMandatoryStringParam(
+                           ruleConfig, prefix + "ContentPatternBeforeReplacedString", before, errorMsg)
+                       && GetMandatoryStringParam(ruleConfig, prefix + "ReplacedContentPattern", replaced, errorMsg)
+                       && GetOptionalStringParam(ruleConfig, prefix + "ReplacingString", replacing, errorMsg)) {
+                // ReplacingString defaults to the one of the processor
+                replacing = replacing.empty() ? mReplacingString : std::string("\\1") + replacing;
+                if (!AddRule(before, replaced, replacing, errorMsg)) {
+                    errorMsg = "param " + prefix + "ContentPatternBeforeReplacedString or " + prefix
+                        + "ReplacedContentPattern is not a valid regex: " + errorMsg;
+                }
+            }
+            if (!errorMsg.empty()) {
+                PARAM_ERROR_RETURN(mContext->GetLogger(),
+                                   mContext->GetAlarm(),
+                                   errorMsg,
+                                   sName,
+                                   mContext->GetConfigName(),
+                                   mContext->GetProjectName(),
+                                   mContext->GetLogstoreName(),
+                                   mContext->GetRegion());
+            }
+        }
+    }
+    if (mRules.size() > 1) {
+        RE2::Options options;
+        options.set_max_mem(kRuleSetMaxMem);
+        mRuleSet.reset(new re2::RE2::Set(options, RE2::UNANCHORED));
+        for (const auto& rule : mRules) {
+            if (mRuleSet->Add(rule.mRegex->pattern(), &errorMsg) < 0) {
+                mRuleSet.reset();
+                break;
+            }
+        }
+        if (mRuleSet && !mRuleSet->Compile()) {
+            mRuleSet.reset();
+        }
+        if (!mRuleSet) {
+            // rules are still checked one by one
+            LOG_WARNING(mContext->GetLogger(),
+                        ("failed to compile desensitize rules into one set", errorMsg)("config",
+                                                                                       mContext->GetConfigName()));
+        }
+        errorMsg.clear();
+    }
+
     // ReplacingAll
     if (!GetOptionalBoolParam(config, "ReplacingAll", mReplacingAll, errorMsg)) {
         PARAM_WARNING_DEFAULT(mContext->GetLogger(),
@@ -178,11 +375,13 @@ void ProcessorDesensitizeNative::ProcessEvent(PipelineEventPtr& e) {
         if (item.second.empty()) {
             continue;
         }
-        std::string value = item.second.to_string();
-        CastOneSensitiveWord(&value);
+        processed = true;
+        std::string value;
+        if (!CastSensitiveWords(item.second, value)) {
+            continue;
+        }
         StringBuffer valueBuffer = sourceEvent.GetSourceBuffer()->CopyString(value);
         sourceEvent.SetContentNoCopy(item.first, StringView(valueBuffer.data, valueBuffer.size));
-        processed = true;
     }
     if (processed) {
         ADD_COUNTER(mOutSuccessfulEventsTotal, 1);
@@ -195,15 +394,85 @@ void ProcessorDesensitizeNative::ProcessEvent(PipelineEventPtr& e) {
     }
 }
 
-void ProcessorDesensitizeNative::CastOneSensitiveWord(std::string* value) {
+bool ProcessorDesensitizeNative::AddRule(const std::string& contentPatternBeforeReplacedString,
+                                         const std::string& replacedContentPattern,
+                                         const std::string& replacingString,
+                                         std::string& errorMsg) {
+    DesensitizeRule rule;
+    std::string regexStr = std::string("(") + contentPatternBeforeReplacedString + ")" + replacedContentPattern;
+    rule.mRegex.reset(new re2::RE2(regexStr));
+    if (!rule.mRegex->ok()) {
+        errorMsg = rule.mRegex->error();
+        return false;
+    }
+    rule.mReplacingString = replacingString;
+    // a leading quantifier would apply to the whole group, which cannot be seen once the group is removed
+    if (replacedContentPattern.empty() || strchr("*?+{", replacedContentPattern[0]) == nullptr) {
+        rule.mRequiredLiteral = GetRequiredLiteral(contentPatternBeforeReplacedString + replacedContentPattern);
+    }
+    mRules.emplace_back(std::move(rule));
+    return true;
+}
+
+bool ProcessorDesensitizeNative::CastSensitiveWords(StringView value, std::string& res) {
+    // most values match none of the rules, so rules are first checked by their required literals, and then by the
+    // rule set, before any replacement is done
+    std::vector<bool> candidates(mRules.size());
+    size_t candidateCnt = 0;
+    for (size_t i = 0; i < mRules.size(); ++i) {
+        const auto& literal = mRules[i].mRequiredLiteral;
+        candidates[i] = literal.empty()
+            || FindSubstring(value.data(), value.size(), literal.data(), literal.size()) != value.size();
+        candidateCnt += candidates[i];
+    }
+    if (candidateCnt == 0) {
+        return false;
+    }
+    if (mRuleSet && candidateCnt > 1) {
+        std::vector<int> matches;
+        RE2::Set::ErrorInfo errorInfo{RE2::Set::kNoError};
+        bool setMatched = mRuleSet->Match(re2::StringPiece(value.data(), value.size()), &matches, &errorInfo);
+#ifdef APSARA_UNIT_TEST_MAIN
+        if (mRuleSetMatchErrorForTest) {
+            setMatched = false;
+            errorInfo.kind = RE2::Set::kOutOfMemory;
+        }
+#endif
+        if (setMatched) {
+            std::vector<bool> matched(mRules.size());
+            for (auto idx : matches) {
+                matched[idx] = true;
+            }
+            for (size_t i = 0; i < mRules.size(); ++i) {
+                candidates[i] = candidates[i] && matched[i];
+            }
+        } else if (errorInfo.kind == RE2::Set::kNoError) {
+            return false;
+        }
+        // otherwise, e.g. the DFA runs out of memory, the candidate rules are applied one by one
+    }
+
+    res = value.to_string();
+    bool changed = false;
+    for (size_t i = 0; i < mRules.size(); ++i) {
+        // once the value is changed, the checks above no longer hold for the rest rules
+        if (!changed && !candidates[i]) {
+            continue;
+        }
+        changed |= CastOneSensitiveWord(mRules[i], &res);
+    }
+    return changed;
+}
+
+bool ProcessorDesensitizeNative::CastOneSensitiveWord(const DesensitizeRule& rule, std::string* value) {
     std::string* pVal = value;
     bool rst = false;
 
     if (mMethod == DesensitizeMethod::CONST_OPTION) {
         if (mReplacingAll) {
-            rst = RE2::GlobalReplace(pVal, *mRegex, mReplacingString);
+            rst = RE2::GlobalReplace(pVal, *rule.mRegex, rule.mReplacingString);
         } else {
-            rst = RE2::Replace(pVal, *mRegex, mReplacingString);
+            rst = RE2::Replace(pVal, *rule.mRegex, rule.mReplacingString);
         }
     } else {
         re2::StringPiece srcStr(*pVal);
@@ -213,7 +482,7 @@ void ProcessorDesensitizeNative::CastOneSensitiveWord(std::string* value) {
         std::string destStr;
         do {
             re2::StringPiece findRst;
-            if (!re2::RE2::FindAndConsume(&srcStr, *mRegex, &findRst)) {
+            if (!re2::RE2::FindAndConsume(&srcStr, *rule.mRegex, &findRst)) {
                 if (beginPos == (size_t)0) {
                     rst = false;
                 }
@@ -246,6 +515,7 @@ void ProcessorDesensitizeNative::CastOneSensitiveWord(std::string* value) {
             pVal = value;
         }
     }
+    return rst;
 }
 
 bool ProcessorDesensitizeNative::IsSupportedEvent(const PipelineEventPtr& e) const {
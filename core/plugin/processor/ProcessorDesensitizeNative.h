@@ -17,6 +17,7 @@
 #pragma once
 
 #include "re2/re2.h"
+#include "re2/set.h"
 
 #include "collection_pipeline/plugin/interface/Processor.h"
 
@@ -47,14 +48,31 @@ public:
     // Whether to replace all matching sensitive content.
     bool mReplacingAll = true;
 
+
 protected:
     bool IsSupportedEvent(const PipelineEventPtr& e) const override;
 
 private:
+    struct DesensitizeRule {
+        std::shared_ptr<re2::RE2> mRegex;
+        std::string mReplacingString;
+        // every match of mRegex contains this literal, empty if no such literal is found
+        std::string mRequiredLiteral;
+    };
+
+    bool AddRule(const std::string& contentPatternBeforeReplacedString,
+                 const std::string& replacedContentPattern,
+                 const std::string& replacingString,
+                 std::string& errorMsg);
     void ProcessEvent(PipelineEventPtr& e);
-    void CastOneSensitiveWord(std::string* value);
+    // returns false if nothing in @value needs to be replaced, otherwise the result is stored in @res
+    bool CastSensitiveWords(StringView value, std::string& res);
+    bool CastOneSensitiveWord(const DesensitizeRule& rule, std::string* value);
 
-    std::shared_ptr<re2::RE2> mRegex;
+    // the rule given by ContentPatternBeforeReplacedString and ReplacedContentPattern, followed by those in Rules
+    std::vector<DesensitizeRule> mRules;
+    // used to find the rules matching a value in one pass when there are more than one rule
+    std::unique_ptr<re2::RE2::Set> mRuleSet;
 
     CounterPtr mDiscardedEventsTotal;
     CounterPtr mOutFailedEventsTotal;
@@ -62,7 +80,12 @@ private:
     CounterPtr mOutSuccessfulEventsTotal;
 
 #ifdef APSARA_UNIT_TEST_MAIN
+    // makes matching the rule set fail as when the DFA runs out of memory, which cannot be triggered reliably
+    bool mRuleSetMatchErrorForTest = false;
+
     friend class ProcessorParseApsaraNativeUnittest;
+    friend class ProcessorDesensitizeNativeUnittest;
+    friend class ProcessorDesensitizeNativeBenchmark;
 #endif
 };
 
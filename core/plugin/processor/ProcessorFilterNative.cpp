@@ -18,11 +18,16 @@
 
 #include <vector>
 
+#include "common/Flags.h"
 #include "common/ParamExtractor.h"
 #include "logger/Logger.h"
 #include "models/LogEvent.h"
 #include "monitor/metric_constants/MetricConstants.h"
 
+DEFINE_FLAG_BOOL(enable_compiled_filter,
+                 "match ConditionExp and FilterRegex of processor_filter_regex_native with the compiled filter",
+                 true);
+
 namespace logtail {
 
 const std::string ProcessorFilterNative::sName = "processor_filter_regex_native";
@@ -140,6 +145,10 @@ bool ProcessorFilterNative::Init(const Json::Value& config) {
         }
     }
 
+    if (BOOL_FLAG(enable_compiled_filter)) {
+        InitCompiledFilter();
+    }
+
     // DiscardingNonUTF8
     if (!GetOptionalBoolParam(config, "DiscardingNonUTF8", mDiscardingNonUTF8, errorMsg)) {
         PARAM_WARNING_DEFAULT(mContext->GetLogger(),
@@ -183,7 +192,9 @@ bool ProcessorFilterNative::ProcessEvent(PipelineEventPtr& e) {
     auto& sourceEvent = e.Cast<LogEvent>();
     bool res = true;
 
-    if (mFilterMode == Mode::EXPRESSION_MODE) {
+    if (mCompiledFilter) {
+        res = FilterCompiled(sourceEvent);
+    } else if (mFilterMode == Mode::EXPRESSION_MODE) {
         res = FilterExpressionRoot(sourceEvent, mConditionExp);
     } else if (mFilterMode == Mode::RULE_MODE) {
         res = FilterFilterRule(sourceEvent, mFilterRule.get());
@@ -282,6 +293,62 @@ bool ProcessorFilterNative::IsMatched(const LogEvent& contents, const LogFilterR
     return true;
 }
 
+bool ProcessorFilterNative::FilterCompiled(LogEvent& sourceEvent) {
+    if (sourceEvent.Empty()) {
+        return false;
+    }
+
+    std::string exception;
+    bool res = mCompiledFilter->Match(sourceEvent, exception);
+    if (!exception.empty() && AppConfig::GetInstance()->IsLogParseAlarmValid()) {
+        LOG_ERROR(GetContext().GetLogger(), ("regex_match in Filter fail", exception));
+        if (GetContext().GetAlarm().IsLowLevelAlarmValid()) {
+            GetContext().GetAlarm().SendAlarmWarning(REGEX_MATCH_ALARM,
+                                                     "regex_match in Filter fail:" + exception,
+                                                     GetContext().GetRegion(),
+                                                     GetContext().GetProjectName(),
+                                                     GetContext().GetConfigName(),
+                                                     GetContext().GetLogstoreName());
+        }
+    }
+    return res;
+}
+
+void ProcessorFilterNative::InitCompiledFilter() {
+    auto filter = std::make_unique<CompiledFilter>();
+    if (mFilterMode == Mode::EXPRESSION_MODE) {
+        if (!CompileExpression(mConditionExp, *filter)) {
+            return;
+        }
+    } else if (mFilterMode == Mode::RULE_MODE) {
+        // all rules must be matched
+        std::vector<size_t> jumps;
+        for (size_t i = 0; i < mFilterRule->FilterKeys.size(); ++i) {
+            if (i > 0) {
+                jumps.push_back(filter->EmitJump(CompiledFilter::OpCode::JUMP_IF_FALSE));
+            }
+            filter->EmitTest(filter->AddPattern(mFilterRule->FilterKeys[i], mFilterRule->FilterRegs[i].str()));
+        }
+        for (auto pos : jumps) {
+            filter->PatchJump(pos);
+        }
+    } else {
+        return;
+    }
+
+    std::string errorMsg;
+    if (!filter->Build(errorMsg)) {
+        // fall back to the uncompiled filter
+        LOG_WARNING(mContext->GetLogger(),
+                    ("failed to compile filter", errorMsg)("config", mContext->GetConfigName()));
+        return;
+    }
+    LOG_INFO(mContext->GetLogger(),
+             ("filter compiled, patterns", filter->GetPatternCnt())("matched by re2", filter->GetRE2PatternCnt())(
+                 "keys", filter->GetKeyCnt())("config", mContext->GetConfigName()));
+    mCompiledFilter = std::move(filter);
+}
+
 static const char UTF8_BYTE_PREFIX = 0x80;
 static const char UTF8_BYTE_MASK = 0xc0;
 
@@ -421,6 +488,44 @@ BaseFilterNodePtr ParseExpressionFromJSON(const Json::Value& value) {
     return node;
 }
 
+bool CompileExpression(const BaseFilterNodePtr& node, CompiledFilter& filter) {
+    if (!node) {
+        // null node, all logs are passed
+        return true;
+    }
+    if (node->GetNodeType() == VALUE_NODE) {
+        const auto* valueNode = dynamic_cast<const RegexFilterValueNode*>(node.get());
+        if (valueNode == nullptr) {
+            return false;
+        }
+        filter.EmitTest(filter.AddPattern(valueNode->GetKey(), valueNode->GetExp()));
+        return true;
+    }
+    if (const auto* unaryNode = dynamic_cast<const UnaryFilterOperatorNode*>(node.get())) {
+        if (!unaryNode->GetChild() || !CompileExpression(unaryNode->GetChild(), filter)) {
+            return false;
+        }
+        filter.EmitNot();
+        return true;
+    }
+    const auto* binaryNode = dynamic_cast<const BinaryFilterOperatorNode*>(node.get());
+    if (binaryNode == nullptr || !binaryNode->GetLeft() || !binaryNode->GetRight()
+        || (binaryNode->GetOperator() != AND_OPERATOR && binaryNode->GetOperator() != OR_OPERATOR)) {
+        return false;
+    }
+    if (!CompileExpression(binaryNode->GetLeft(), filter)) {
+        return false;
+    }
+    // the right operand is skipped once the result is decided by the left one
+    size_t jump = filter.EmitJump(binaryNode->GetOperator() == AND_OPERATOR ? CompiledFilter::OpCode::JUMP_IF_FALSE
+                                                                             : CompiledFilter::OpCode::JUMP_IF_TRUE);
+    if (!CompileExpression(binaryNode->GetRight(), filter)) {
+        return false;
+    }
+    filter.PatchJump(jump);
+    return true;
+}
+
 bool GetOperatorType(const std::string& type, FilterOperator& op) {
     if (type == "not") {
         op = NOT_OPERATOR;
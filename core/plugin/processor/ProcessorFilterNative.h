@@ -21,6 +21,7 @@
 #include "app_config/AppConfig.h"
 #include "collection_pipeline/plugin/interface/Processor.h"
 #include "models/LogEvent.h"
+#include "plugin/processor/CompiledFilter.h"
 
 namespace logtail {
 
@@ -58,6 +59,10 @@ public:
 public:
     virtual bool Match(const LogEvent& contents, const CollectionPipelineContext& mContext);
 
+    FilterOperator GetOperator() const { return op; }
+    const BaseFilterNodePtr& GetLeft() const { return left; }
+    const BaseFilterNodePtr& GetRight() const { return right; }
+
 private:
     FilterOperator op;
     BaseFilterNodePtr left;
@@ -75,6 +80,9 @@ public:
 public:
     virtual bool Match(const LogEvent& contents, const CollectionPipelineContext& mContext);
 
+    const std::string& GetKey() const { return key; }
+    std::string GetExp() const { return reg.str(); }
+
 private:
     std::string key;
     boost::regex reg;
@@ -90,11 +98,14 @@ public:
 public:
     virtual bool Match(const LogEvent& contents, const CollectionPipelineContext& mContext);
 
+    const BaseFilterNodePtr& GetChild() const { return child; }
+
 private:
     BaseFilterNodePtr child;
 };
 
 BaseFilterNodePtr ParseExpressionFromJSON(const Json::Value& value);
+bool CompileExpression(const BaseFilterNodePtr& node, CompiledFilter& filter);
 bool GetOperatorType(const std::string& type, FilterOperator& op);
 bool GetNodeFuncType(const std::string& type, FilterNodeFunctionType& func);
 
@@ -132,6 +143,10 @@ private:
     bool FilterFilterRule(LogEvent& sourceEvent, const LogFilterRule* filterRule);
     bool IsMatched(const LogEvent& contents, const LogFilterRule& rule);
 
+    // Filter logs through the compiled form of ConditionExp or FilterRule
+    bool FilterCompiled(LogEvent& sourceEvent);
+    void InitCompiledFilter();
+
     bool noneUtf8(StringView& strSrc, bool modify);
     bool CheckNoneUtf8(const StringView& strSrc);
     void FilterNoneUtf8(std::string& strSrc);
@@ -139,9 +154,11 @@ private:
     Mode mFilterMode = Mode::BYPASS_MODE;
 
     std::shared_ptr<LogFilterRule> mFilterRule;
+    std::unique_ptr<CompiledFilter> mCompiledFilter;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class ProcessorFilterNativeUnittest;
+    friend class ProcessorFilterNativeBenchmark;
 #endif
 };
 
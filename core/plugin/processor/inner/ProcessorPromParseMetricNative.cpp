@@ -53,6 +53,11 @@ bool ProcessorPromParseMetricNative::ProcessEvent(PipelineEventPtr& e,
                                                   EventsContainer& newEvents,
                                                   PipelineEventGroup& eGroup,
                                                   TextParser& parser) {
+    if (e.Is<MetricEvent>()) {
+        // already parsed by the scraper
+        newEvents.emplace_back(std::move(e));
+        return true;
+    }
     if (!IsSupportedEvent(e)) {
         return false;
     }
@@ -54,17 +54,20 @@ void ProcessorPromRelabelMetricNative::Process(PipelineEventGroup& metricGroup)
     // if mMetricRelabelConfigs is empty and honor_labels is true, skip it
     auto targetTags = metricGroup.GetTags();
 
-    EventsContainer& events = metricGroup.MutableEvents();
-    size_t wIdx = 0;
-    for (size_t rIdx = 0; rIdx < events.size(); ++rIdx) {
-        if (ProcessEvent(events[rIdx], targetTags)) {
-            if (wIdx != rIdx) {
-                events[wIdx] = std::move(events[rIdx]);
+    // events of the group may have been relabeled by the stream scraper along with the series cache
+    if (!metricGroup.HasMetadata(EventGroupMetaKey::PROMETHEUS_METRIC_RELABELED)) {
+        EventsContainer& events = metricGroup.MutableEvents();
+        size_t wIdx = 0;
+        for (size_t rIdx = 0; rIdx < events.size(); ++rIdx) {
+            if (ProcessEvent(events[rIdx], targetTags)) {
+                if (wIdx != rIdx) {
+                    events[wIdx] = std::move(events[rIdx]);
+                }
+                ++wIdx;
             }
-            ++wIdx;
         }
+        events.resize(wIdx);
     }
-    events.resize(wIdx);
 
     if (metricGroup.HasMetadata(EventGroupMetaKey::PROMETHEUS_STREAM_TOTAL)) {
         auto autoMetric = prom::AutoMetric();
@@ -86,8 +89,12 @@ bool ProcessorPromRelabelMetricNative::ProcessEvent(PipelineEventPtr& e, const G
     if (!IsSupportedEvent(e)) {
         return false;
     }
-    auto& sourceEvent = e.Cast<MetricEvent>();
+    return RelabelMetricEvent(e.Cast<MetricEvent>(), targetTags, *mScrapeConfigPtr);
+}
 
+bool ProcessorPromRelabelMetricNative::RelabelMetricEvent(MetricEvent& sourceEvent,
+                                                          const GroupTags& targetTags,
+                                                          const ScrapeConfig& scrapeConfig) {
     auto& eventTags = sourceEvent.mTags;
     auto appendLabels = [&eventTags, &sourceEvent](StringView k, StringView v, bool honorLabels) {
         auto it = std::find_if(
@@ -110,11 +117,10 @@ bool ProcessorPromRelabelMetricNative::ProcessEvent(PipelineEventPtr& e, const G
     };
 
     for (const auto& [k, v] : targetTags) {
-        appendLabels(k, v, mScrapeConfigPtr->mHonorLabels);
+        appendLabels(k, v, scrapeConfig.mHonorLabels);
     }
 
-    if (!mScrapeConfigPtr->mMetricRelabelConfigs.Empty()
-        && !mScrapeConfigPtr->mMetricRelabelConfigs.Process(sourceEvent)) {
+    if (!scrapeConfig.mMetricRelabelConfigs.Empty() && !scrapeConfig.mMetricRelabelConfigs.Process(sourceEvent)) {
         return false;
     }
 
@@ -133,9 +139,9 @@ bool ProcessorPromRelabelMetricNative::ProcessEvent(PipelineEventPtr& e, const G
               });
     }
 
-    for (const auto& [k, v] : mScrapeConfigPtr->mExternalLabels) {
+    for (const auto& [k, v] : scrapeConfig.mExternalLabels) {
         if (!v.empty()) {
-            appendLabels(k, v, mScrapeConfigPtr->mHonorLabels);
+            appendLabels(k, v, scrapeConfig.mHonorLabels);
         }
     }
 
@@ -46,6 +46,12 @@ public:
     bool Init(const Json::Value& config) override;
     void Process(PipelineEventGroup& metricGroup) override;
 
+    // append target labels, apply metric relabeling and external labels to the event, and return false if it is
+    // dropped
+    static bool RelabelMetricEvent(MetricEvent& sourceEvent,
+                                   const GroupTags& targetTags,
+                                   const ScrapeConfig& scrapeConfig);
+
 protected:
     bool IsSupportedEvent(const PipelineEventPtr& e) const override;
 
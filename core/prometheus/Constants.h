@@ -50,6 +50,7 @@ const char* const METRICS_PATH = "metrics_path";
 const char* const SCRAPE_INTERVAL = "scrape_interval";
 const char* const SCRAPE_TIMEOUT = "scrape_timeout";
 const char* const SCRAPE_PROTOCOLS = "scrape_protocols";
+const char* const SCRAPE_NATIVE_HISTOGRAMS = "scrape_native_histograms";
 const char* const HEADERS = "headers";
 const char* const PARAMS = "params";
 const char* const QUERY_STRING = "query_string";
@@ -92,6 +93,10 @@ const char* const PrometheusProto = "PrometheusProto";
 const char* const PrometheusText0_0_4 = "PrometheusText0.0.4";
 const char* const OpenMetricsText0_0_1 = "OpenMetricsText0.0.1";
 const char* const OpenMetricsText1_0_0 = "OpenMetricsText1.0.0";
+// the protobuf exposition, i.e. length delimited io.prometheus.client.MetricFamily messages
+const char* const PROTOBUF_MEDIA_TYPE = "application/vnd.google.protobuf";
+const char* const PROTOBUF_PROTO = "io.prometheus.client.MetricFamily";
+const char* const PROTOBUF_ENCODING = "delimited";
 
 // metric labels
 const char* const JOB = "job";
@@ -0,0 +1,123 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "prometheus/component/SeriesCache.h"
+
+#include <xxhash/xxhash.h>
+
+#include <algorithm>
+
+#include "common/Flags.h"
+
+DEFINE_FLAG_BOOL(enable_prom_series_cache, "cache parsed and relabeled series across scrapes of a target", true);
+DEFINE_FLAG_INT32(prom_series_cache_max_series, "max series cached for each target", 200000);
+DEFINE_FLAG_INT32(prom_series_cache_stale_scrapes, "scrapes a series can be absent from before evicted", 2);
+
+using namespace std;
+
+namespace logtail::prom {
+
+SeriesCache::SeriesCache(size_t maxSeriesCnt, uint64_t staleScrapeCnt)
+    : mSourceBuffer(make_shared<SourceBuffer>()),
+      mMaxSeriesCnt(maxSeriesCnt),
+      mStaleScrapeCnt(max<uint64_t>(staleScrapeCnt, 1)) {
+}
+
+const SeriesCache::Series* SeriesCache::Get(StringView text) {
+    auto iter = mSeries.find(Hash(text));
+    if (iter == mSeries.end() || iter->second.mText != text) {
+        return nullptr;
+    }
+    iter->second.mLastScrapeIdx = mScrapeIdx;
+    return &iter->second;
+}
+
+void SeriesCache::Add(StringView text, const MetricEvent* relabeled) {
+    auto hash = Hash(text);
+    auto iter = mSeries.find(hash);
+    if (iter == mSeries.end()) {
+        if (mSeries.size() >= mMaxSeriesCnt) {
+            return;
+        }
+        iter = mSeries.try_emplace(hash).first;
+    } else {
+        // hash collision, the latest series wins
+        iter->second = Series();
+    }
+    auto& series = iter->second;
+    auto sb = mSourceBuffer->CopyString(text);
+    series.mText = StringView(sb.data, sb.size);
+    series.mLastScrapeIdx = mScrapeIdx;
+    if (relabeled == nullptr) {
+        series.mDropped = true;
+        return;
+    }
+    series.mName = Intern(relabeled->GetName());
+    series.mTags.reserve(relabeled->TagsSize());
+    for (auto tag = relabeled->TagsBegin(); tag != relabeled->TagsEnd(); ++tag) {
+        series.mTags.emplace_back(Intern(tag->first), Intern(tag->second));
+    }
+}
+
+void SeriesCache::OnScrapeDone() {
+    ++mScrapeIdx;
+    for (auto iter = mSeries.begin(); iter != mSeries.end();) {
+        if (mScrapeIdx - iter->second.mLastScrapeIdx > mStaleScrapeCnt) {
+            iter = mSeries.erase(iter);
+            ++mEvictedCnt;
+        } else {
+            ++iter;
+        }
+    }
+    if (mEvictedCnt > mSeries.size()) {
+        Compact();
+    }
+}
+
+uint64_t SeriesCache::Hash(StringView text) {
+    return XXH64(text.data(), text.size(), 0);
+}
+
+StringView SeriesCache::Intern(StringView str) {
+    auto iter = mInternedStrings.find(str);
+    if (iter != mInternedStrings.end()) {
+        return *iter;
+    }
+    auto sb = mSourceBuffer->CopyString(str);
+    StringView res(sb.data, sb.size);
+    mInternedStrings.insert(res);
+    return res;
+}
+
+void SeriesCache::Compact() {
+    // event groups still referencing the old buffer keep it alive afterwards
+    auto oldSourceBuffer = std::move(mSourceBuffer);
+    mSourceBuffer = make_shared<SourceBuffer>();
+    mInternedStrings.clear();
+    for (auto& [hash, series] : mSeries) {
+        auto sb = mSourceBuffer->CopyString(series.mText);
+        series.mText = StringView(sb.data, sb.size);
+        if (series.mDropped) {
+            continue;
+        }
+        series.mName = Intern(series.mName);
+        for (auto& [k, v] : series.mTags) {
+            k = Intern(k);
+            v = Intern(v);
+        }
+    }
+    mEvictedCnt = 0;
+}
+
+} // namespace logtail::prom
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "common/StringView.h"
+#include "common/memory/SourceBuffer.h"
+#include "models/MetricEvent.h"
+
+namespace logtail::prom {
+
+// Series of a target seen in the recent scrapes, keyed by the hash of the raw series text, i.e. the metric name
+// together with the label block. Each series keeps its name and labels after relabeling, or whether it is dropped, so
+// that only the value and the timestamp of a series unchanged since the last scrape have to be parsed.
+// Strings are interned in a source buffer owned by the cache, which is added to each event group referencing it. A
+// series absent from the last stale scrape count scrapes is evicted, and the buffer is rebuilt once most of the series
+// it holds are evicted, while the old one is kept alive by the event groups still in flight.
+// The cache is owned by the scrape scheduler of the target, and is not thread-safe, since scrapes of a target never
+// overlap.
+class SeriesCache {
+public:
+    struct Series {
+        StringView mText;
+        bool mDropped = false;
+        StringView mName;
+        std::vector<std::pair<StringView, StringView>> mTags;
+        uint64_t mLastScrapeIdx = 0;
+    };
+
+    SeriesCache(size_t maxSeriesCnt, uint64_t staleScrapeCnt);
+
+    // returns nullptr if the series is not cached
+    const Series* Get(StringView text);
+    // relabeled is the event after relabeling, or nullptr if the series is dropped
+    void Add(StringView text, const MetricEvent* relabeled);
+    void OnScrapeDone();
+
+    const std::shared_ptr<SourceBuffer>& GetSourceBuffer() const { return mSourceBuffer; }
+    size_t Size() const { return mSeries.size(); }
+
+private:
+    static uint64_t Hash(StringView text);
+
+    StringView Intern(StringView str);
+    void Compact();
+
+    std::unordered_map<uint64_t, Series> mSeries;
+    std::shared_ptr<SourceBuffer> mSourceBuffer;
+    std::unordered_set<StringView, StringViewHash, StringViewEqual> mInternedStrings;
+
+    size_t mMaxSeriesCnt = 0;
+    uint64_t mStaleScrapeCnt = 0;
+    uint64_t mScrapeIdx = 0;
+    // series evicted since the source buffer was last rebuilt
+    size_t mEvictedCnt = 0;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class SeriesCacheUnittest;
+#endif
+};
+
+} // namespace logtail::prom
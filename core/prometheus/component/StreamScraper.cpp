@@ -11,19 +11,53 @@
 #include "collection_pipeline/queue/ProcessQueueItem.h"
 #include "collection_pipeline/queue/ProcessQueueManager.h"
 #include "common/StringTools.h"
+#include "common/http/Constant.h"
 #include "logger/Logger.h"
 #include "models/PipelineEventGroup.h"
+#include "plugin/processor/inner/ProcessorPromRelabelMetricNative.h"
+#include "prometheus/Constants.h"
 #include "prometheus/Utils.h"
 #include "runner/ProcessorRunner.h"
 
 DEFINE_FLAG_INT64(prom_stream_bytes_size, "stream bytes size", 1024 * 1024);
 DEFINE_FLAG_INT64(prom_max_sample_length, "max sample length", 8 * 1024);
+DEFINE_FLAG_INT64(prom_max_protobuf_message_size, "max metric family message size in protobuf", 16 * 1024 * 1024);
 
 DEFINE_FLAG_BOOL(enable_prom_stream_scrape, "enable prom stream scrape", true);
+DEFINE_FLAG_BOOL(enable_prom_stream_parse, "parse prom samples while scraping", true);
 
 using namespace std;
 
 namespace logtail::prom {
+
+namespace {
+
+// e.g. application/vnd.google.protobuf; proto=io.prometheus.client.MetricFamily; encoding=delimited
+bool IsProtobufContentType(const string& contentType) {
+    auto parts = SplitString(contentType, ";");
+    if (parts.empty() || ToLowerCaseString(TrimSpace(parts[0])) != prometheus::PROTOBUF_MEDIA_TYPE) {
+        return false;
+    }
+    bool isMetricFamily = false;
+    bool isDelimited = false;
+    for (size_t i = 1; i < parts.size(); ++i) {
+        auto pos = parts[i].find('=');
+        if (pos == string::npos) {
+            continue;
+        }
+        auto key = ToLowerCaseString(TrimSpace(parts[i].substr(0, pos)));
+        auto value = TrimSpace(parts[i].substr(pos + 1));
+        if (key == "proto") {
+            isMetricFamily = value == prometheus::PROTOBUF_PROTO;
+        } else if (key == "encoding") {
+            isDelimited = ToLowerCaseString(value) == prometheus::PROTOBUF_ENCODING;
+        }
+    }
+    return isMetricFamily && isDelimited;
+}
+
+} // namespace
+
 size_t StreamScraper::mMaxSampleLength = 8 * 1024;
 StreamScraper::StreamScraper(Labels labels,
                              QueueKey queueKey,
@@ -53,27 +87,34 @@ size_t StreamScraper::MetricWriteCallback(char* buffer, size_t size, size_t nmem
     }
 
     auto* body = static_cast<StreamScraper*>(data);
+    if (body->mBodyFormat == BodyFormat::UNKNOWN) {
+        body->DetectBodyFormat();
+    }
 
-    size_t begin = 0;
-    for (size_t end = begin; end < sizes; ++end) {
-        if (buffer[end] == '\n') {
-            if (begin == 0 && !body->mCache.empty()) {
-                body->mCache.append(buffer, end);
-                body->AddEvent(body->mCache.data(), body->mCache.size());
-                body->mCache.clear();
-            } else if (begin != end) {
-                body->AddEvent(buffer + begin, end - begin);
+    if (body->mBodyFormat == BodyFormat::PROTOBUF) {
+        body->AddProtobufData(StringView(buffer, sizes));
+    } else {
+        size_t begin = 0;
+        for (size_t end = begin; end < sizes; ++end) {
+            if (buffer[end] == '\n') {
+                if (begin == 0 && !body->mCache.empty()) {
+                    body->mCache.append(buffer, end);
+                    body->AddEvent(body->mCache.data(), body->mCache.size());
+                    body->mCache.clear();
+                } else if (begin != end) {
+                    body->AddEvent(buffer + begin, end - begin);
+                }
+                begin = end + 1;
             }
-            begin = end + 1;
         }
-    }
 
-    if (begin < sizes) {
-        body->mCache.append(buffer + begin, sizes - begin);
-        // limit the last line cache size to prom_max_sample_length bytes
-        if (body->mCache.size() > mMaxSampleLength) {
-            LOG_WARNING(sLogger, ("stream scraper", "cache is too large, drop it."));
-            body->mCache.clear();
+        if (begin < sizes) {
+            body->mCache.append(buffer + begin, sizes - begin);
+            // limit the last line cache size to prom_max_sample_length bytes
+            if (body->mCache.size() > mMaxSampleLength) {
+                LOG_WARNING(sLogger, ("stream scraper", "cache is too large, drop it."));
+                body->mCache.clear();
+            }
         }
     }
     body->mRawSize += sizes;
@@ -87,16 +128,186 @@ size_t StreamScraper::MetricWriteCallback(char* buffer, size_t size, size_t nmem
     return sizes;
 }
 
+void StreamScraper::EnableStreamParse(bool honorTimestamps) {
+    mHonorTimestamps = honorTimestamps;
+    // the line is gone after the callback returns, so tokens must be copied
+    mParser = make_unique<TextParser>(honorTimestamps, true);
+    mParser->SetDefaultTimestamp(mScrapeTimestampMilliSec / 1000, mScrapeTimestampMilliSec % 1000 * 1000000);
+}
+
+void StreamScraper::EnableSeriesCache(shared_ptr<SeriesCache> seriesCache, shared_ptr<ScrapeConfig> scrapeConfig) {
+    if (!mParser) {
+        return;
+    }
+    mSeriesCache = std::move(seriesCache);
+    mScrapeConfig = std::move(scrapeConfig);
+    mTargetLabels.Range([this](const string& k, const string& v) { mTargetTags[StringView(k)] = StringView(v); });
+}
+
+void StreamScraper::SetResponseHeader(const HttpResponse& response) {
+    mResponse = &response;
+}
+
+void StreamScraper::DetectBodyFormat() {
+    mBodyFormat = BodyFormat::TEXT;
+    if (mResponse == nullptr) {
+        return;
+    }
+    const auto& header = mResponse->GetHeader();
+    auto it = header.find(CONTENT_TYPE);
+    if (it == header.end() || !IsProtobufContentType(it->second)) {
+        return;
+    }
+    mBodyFormat = BodyFormat::PROTOBUF;
+    if (!mProtobufParser) {
+        mProtobufParser = make_unique<ProtobufParser>(mHonorTimestamps);
+        mProtobufParser->SetDefaultTimestamp(mScrapeTimestampMilliSec / 1000,
+                                             mScrapeTimestampMilliSec % 1000 * 1000000);
+    }
+}
+
+void StreamScraper::AddProtobufData(StringView data) {
+    if (mProtobufBodyDropped) {
+        return;
+    }
+    size_t prefixSize = 0;
+    uint64_t messageSize = 0;
+    // complete the message left over by the last chunk, copying no more of this chunk than it needs
+    while (!mCache.empty() && !data.empty()) {
+        if (!ProtobufParser::ReadLengthPrefix(mCache, prefixSize, messageSize)) {
+            mCache.push_back(data[0]);
+            data.remove_prefix(1);
+            continue;
+        }
+        if (!CheckProtobufMessageSize(messageSize)) {
+            return;
+        }
+        auto len = min(prefixSize + messageSize - mCache.size(), data.size());
+        mCache.append(data.data(), len);
+        data.remove_prefix(len);
+        if (mCache.size() == prefixSize + messageSize) {
+            AddProtobufMessage(StringView(mCache).substr(prefixSize));
+            mCache.clear();
+        }
+    }
+    // messages wholly within this chunk are parsed without being buffered
+    while (!data.empty()) {
+        if (!ProtobufParser::ReadLengthPrefix(data, prefixSize, messageSize)) {
+            mCache.assign(data.data(), data.size());
+            return;
+        }
+        if (!CheckProtobufMessageSize(messageSize)) {
+            return;
+        }
+        if (messageSize > data.size() - prefixSize) {
+            mCache.assign(data.data(), data.size());
+            return;
+        }
+        AddProtobufMessage(data.substr(prefixSize, messageSize));
+        data.remove_prefix(prefixSize + messageSize);
+    }
+}
+
+bool StreamScraper::CheckProtobufMessageSize(uint64_t messageSize) {
+    if (messageSize <= static_cast<uint64_t>(INT64_FLAG(prom_max_protobuf_message_size))) {
+        return true;
+    }
+    LOG_WARNING(sLogger,
+                ("stream scraper", "protobuf message is too large or malformed, drop the rest of the body")(
+                    "message size", messageSize)("target", mHash));
+    mProtobufBodyDropped = true;
+    mCache.clear();
+    return false;
+}
+
+void StreamScraper::AddProtobufMessage(StringView message) {
+    // the only copy of the message, which the events parsed refer to
+    auto sb = mEventGroup.GetSourceBuffer()->CopyString(message);
+    auto& events = mEventGroup.MutableEvents();
+    size_t begin = events.size();
+    mProtobufParser->ParseMetricFamily(StringView(sb.data, sb.size), mEventGroup, mEventPool);
+    size_t end = begin;
+    for (size_t i = begin; i < events.size(); ++i) {
+        auto& e = events[i].Cast<MetricEvent>();
+        e.SetTagNoCopy(StringView(prometheus::NAME), e.GetName());
+        mScrapeSamplesScraped++;
+        if (mScrapeConfig && !ProcessorPromRelabelMetricNative::RelabelMetricEvent(e, mTargetTags, *mScrapeConfig)) {
+            continue;
+        }
+        if (i != end) {
+            events[end] = std::move(events[i]);
+        }
+        ++end;
+    }
+    events.erase(events.begin() + end, events.end());
+}
+
 void StreamScraper::AddEvent(const char* line, size_t len) {
-    if (IsValidMetric(StringView(line, len))) {
-        auto* e = mEventGroup.AddRawEvent(true, mEventPool);
-        auto sb = mEventGroup.GetSourceBuffer()->CopyString(line, len);
-        e->SetContentNoCopy(sb);
+    if (!IsValidMetric(StringView(line, len))) {
+        return;
+    }
+    if (mSeriesCache) {
+        AddEventWithSeriesCache(StringView(line, len));
         mScrapeSamplesScraped++;
+        return;
+    }
+    if (mParser) {
+        auto* e = mEventGroup.AddMetricEvent(true, mEventPool);
+        if (mParser->ParseLine(StringView(line, len), *e)) {
+            e->SetTagNoCopy(StringView(prometheus::NAME), e->GetName());
+        } else {
+            mEventGroup.MutableEvents().pop_back();
+        }
+        mScrapeSamplesScraped++;
+        return;
+    }
+    auto* e = mEventGroup.AddRawEvent(true, mEventPool);
+    auto sb = mEventGroup.GetSourceBuffer()->CopyString(line, len);
+    e->SetContentNoCopy(sb);
+    mScrapeSamplesScraped++;
+}
+
+void StreamScraper::AddEventWithSeriesCache(StringView line) {
+    auto series = mParser->GetSeries(line);
+    const auto* cached = series.empty() ? nullptr : mSeriesCache->Get(series);
+    if (cached != nullptr) {
+        if (cached->mDropped) {
+            return;
+        }
+        auto* e = mEventGroup.AddMetricEvent(true, mEventPool);
+        e->SetNameNoCopy(cached->mName);
+        for (const auto& [k, v] : cached->mTags) {
+            e->SetTagNoCopy(k, v);
+        }
+        if (!mParser->ParseSample(line, series.data() + series.size() - line.data(), *e)) {
+            mEventGroup.MutableEvents().pop_back();
+        }
+        return;
+    }
+
+    auto* e = mEventGroup.AddMetricEvent(true, mEventPool);
+    if (!mParser->ParseLine(line, *e)) {
+        mEventGroup.MutableEvents().pop_back();
+        return;
+    }
+    e->SetTagNoCopy(StringView(prometheus::NAME), e->GetName());
+    bool kept = ProcessorPromRelabelMetricNative::RelabelMetricEvent(*e, mTargetTags, *mScrapeConfig);
+    if (!series.empty()) {
+        mSeriesCache->Add(series, kept ? e : nullptr);
+    }
+    if (!kept) {
+        mEventGroup.MutableEvents().pop_back();
     }
 }
 
 void StreamScraper::FlushCache() {
+    if (mBodyFormat == BodyFormat::PROTOBUF) {
+        if (!mCache.empty()) {
+            LOG_WARNING(sLogger, ("stream scraper", "protobuf body is truncated, drop the incomplete message"));
+            mCache.clear();
+        }
+        return;
+    }
     if (!mCache.empty()) {
         AddEvent(mCache.data(), mCache.size());
         mCache.clear();
@@ -130,6 +341,11 @@ void StreamScraper::SendMetrics() {
     mEventGroup.SetMetadata(EventGroupMetaKey::PROMETHEUS_SCRAPE_TIMESTAMP_MILLISEC,
                             ToString(mScrapeTimestampMilliSec));
     mEventGroup.SetMetadata(EventGroupMetaKey::PROMETHEUS_STREAM_ID, GetId());
+    if (mSeriesCache) {
+        // events may point to the strings of the cache
+        mEventGroup.AddSourceBuffer(mSeriesCache->GetSourceBuffer());
+        mEventGroup.SetMetadata(EventGroupMetaKey::PROMETHEUS_METRIC_RELABELED, ToString(true));
+    }
 
     SetTargetLabels(mEventGroup);
     PushEventGroup(std::move(mEventGroup));
@@ -144,6 +360,8 @@ void StreamScraper::Reset() {
     mCache.clear();
     mStreamIndex = 0;
     mScrapeSamplesScraped = 0;
+    mBodyFormat = BodyFormat::UNKNOWN;
+    mProtobufBodyDropped = false;
 }
 
 void StreamScraper::SetAutoMetricMeta(double scrapeDurationSeconds, bool upState, const string& scrapeState) {
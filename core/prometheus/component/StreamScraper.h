@@ -6,7 +6,12 @@
 
 #include "Labels.h"
 #include "collection_pipeline/queue/QueueKey.h"
+#include "common/http/HttpResponse.h"
 #include "models/PipelineEventGroup.h"
+#include "prometheus/component/SeriesCache.h"
+#include "prometheus/labels/ProtobufParser.h"
+#include "prometheus/labels/TextParser.h"
+#include "prometheus/schedulers/ScrapeConfig.h"
 
 #ifdef APSARA_UNIT_TEST_MAIN
 #include <vector>
@@ -24,6 +29,18 @@ public:
                   EventPool* eventPool,
                   std::chrono::system_clock::time_point scrapeTime);
     static size_t MetricWriteCallback(char* buffer, size_t size, size_t nmemb, void* data);
+    // applies to both the stream parser and the protobuf parser, the latter of which is used regardless of stream parse
+    void SetHonorTimestamps(bool honorTimestamps) { mHonorTimestamps = honorTimestamps; }
+    // samples are parsed into metric events as soon as their lines are received, instead of being kept as raw events
+    // for the parse processor, so that the response is neither copied nor traversed again
+    void EnableStreamParse(bool honorTimestamps);
+    // Series are looked up in the cache of the target before parsed, and relabeled here instead of in the relabel
+    // processor, so that series unchanged since the last scrapes are neither parsed nor relabeled again. Stream parse
+    // must be enabled beforehand.
+    void EnableSeriesCache(std::shared_ptr<SeriesCache> seriesCache, std::shared_ptr<ScrapeConfig> scrapeConfig);
+    // The headers of the response, which are received before the body, tell whether the body is in the protobuf
+    // exposition. Protobuf bodies are always parsed here, as the parse processor handles text lines only.
+    void SetResponseHeader(const HttpResponse& response);
     void FlushCache();
     void SendMetrics();
     void Reset();
@@ -34,7 +51,14 @@ public:
     uint64_t mStreamIndex = 0;
 
 private:
+    enum class BodyFormat { UNKNOWN, TEXT, PROTOBUF };
+
     void AddEvent(const char* line, size_t len);
+    void DetectBodyFormat();
+    void AddProtobufData(StringView data);
+    bool CheckProtobufMessageSize(uint64_t messageSize);
+    void AddProtobufMessage(StringView message);
+    void AddEventWithSeriesCache(StringView line);
     void PushEventGroup(PipelineEventGroup&&) const;
     void SetTargetLabels(PipelineEventGroup& eGroup) const;
     std::string GetId();
@@ -42,6 +66,17 @@ private:
     size_t mCurrStreamSize = 0;
     std::string mCache;
     PipelineEventGroup mEventGroup;
+    std::unique_ptr<TextParser> mParser;
+    bool mHonorTimestamps = true;
+    const HttpResponse* mResponse = nullptr;
+    BodyFormat mBodyFormat = BodyFormat::UNKNOWN;
+    std::unique_ptr<ProtobufParser> mProtobufParser;
+    // set once a malformed or oversized message is met, after which the rest of the body cannot be framed
+    bool mProtobufBodyDropped = false;
+    std::shared_ptr<SeriesCache> mSeriesCache;
+    std::shared_ptr<ScrapeConfig> mScrapeConfig;
+    // views of mTargetLabels
+    GroupTags mTargetTags;
 
     std::string mHash;
     uint64_t mScrapeSamplesScraped = 0;
@@ -58,6 +93,7 @@ private:
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class ProcessorParsePrometheusMetricUnittest;
     friend class ScrapeSchedulerUnittest;
+    friend class SeriesCacheBenchmark;
     friend class StreamScraperUnittest;
     mutable std::vector<std::shared_ptr<ProcessQueueItem>> mItem;
 #endif
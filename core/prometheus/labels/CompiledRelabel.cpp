@@ -0,0 +1,418 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "prometheus/labels/CompiledRelabel.h"
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+
+#include <boost/regex.hpp>
+
+#include "common/StringTools.h"
+#include "logger/Logger.h"
+#include "prometheus/Constants.h"
+
+using namespace std;
+
+namespace logtail {
+
+namespace {
+
+// Splits a pattern like "a|b\.c|d.*" into literals and literal prefixes, or returns false if the pattern contains any
+// other regex syntax.
+bool ParseLiterals(const string& exp, unordered_set<string>& literals, vector<string>& prefixes) {
+    string literal;
+    for (size_t i = 0; i <= exp.size(); ++i) {
+        if (i == exp.size() || exp[i] == '|') {
+            literals.insert(literal);
+            literal.clear();
+            continue;
+        }
+        char c = exp[i];
+        if (c == '\\') {
+            // only escaped metacharacters are literals, e.g. neither \d nor \< is
+            if (i + 1 == exp.size() || strchr(".[]{}()*+?^$|\\/-", exp[i + 1]) == nullptr) {
+                return false;
+            }
+            literal += exp[++i];
+        } else if (c == '.' && i + 1 < exp.size() && exp[i + 1] == '*'
+                   && (i + 2 == exp.size() || exp[i + 2] == '|')) {
+            prefixes.push_back(literal);
+            literal.clear();
+            i += 2;
+        } else if (strchr(".[]{}()*+?^$", c) != nullptr) {
+            return false;
+        } else {
+            literal += c;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+void CompiledRelabelConfigList::Compile(const vector<RelabelConfig>& configs) {
+    mSteps.clear();
+    mSteps.reserve(configs.size());
+    for (const auto& config : configs) {
+        CompileStep(mSteps.emplace_back(config));
+    }
+}
+
+bool CompiledRelabelConfigList::Process(MetricEvent& event) const {
+    // the same as Labels::Reset
+    event.SetTagNoCopy(StringView(prometheus::NAME), event.GetName());
+    for (const auto& step : mSteps) {
+        if (!RunStep(step, event)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CompiledRelabelConfigList::CompileStep(Step& step) {
+    const auto& config = step.mConfig;
+    bool fullMatch = false;
+    switch (config.mAction) {
+        case Action::KEEP:
+        case Action::DROP:
+        case Action::LABELDROP:
+        case Action::LABELKEEP:
+            fullMatch = true;
+            break;
+        case Action::REPLACE:
+            step.mFormatCompiled = CompileFormat(config.mTargetLabel, false, step.mTargetLabelFormat)
+                && CompileFormat(config.mReplacement, false, step.mReplacementFormat);
+            break;
+        case Action::LABELMAP:
+            step.mFormatCompiled = CompileFormat(config.mReplacement, true, step.mReplacementFormat);
+            break;
+        default:
+            // the regex is not used
+            return;
+    }
+    if (!fullMatch && !step.mFormatCompiled) {
+        return;
+    }
+    const string exp = config.mRegex.str();
+    if (fullMatch && ParseLiterals(exp, step.mLiterals, step.mLiteralPrefixes)) {
+        step.mMatchKind = MatchKind::LITERAL;
+        return;
+    }
+    step.mLiterals.clear();
+    step.mLiteralPrefixes.clear();
+
+    string translated;
+    // replace searches for the leftmost match, where ^ and $ may match at any line boundary
+    if (!TranslateToRE2(exp, translated, config.mAction == Action::REPLACE)) {
+        return;
+    }
+    RE2::Options options;
+    options.set_encoding(RE2::Options::EncodingLatin1);
+    options.set_dot_nl(true);
+    options.set_log_errors(false);
+    options.set_max_mem(64 << 20);
+    auto regex = make_unique<RE2>(translated, options);
+    if (!regex->ok()) {
+        return;
+    }
+    step.mGroupCnt = regex->NumberOfCapturingGroups() + 1;
+    step.mRegex = std::move(regex);
+    step.mMatchKind = MatchKind::RE2;
+}
+
+// Compiles a replacement in the format syntax of boost::regex_replace, or returns false if it uses anything other than
+// $n, ${n}, $& and $$. All syntax is additionally recognized in the format_all mode, where (?, :, ( and ) are special.
+bool CompiledRelabelConfigList::CompileFormat(const string& fmt, bool allSyntax, vector<FormatPart>& parts) {
+    auto appendLiteral = [&parts](char c) {
+        if (parts.empty() || parts.back().mGroup >= 0) {
+            parts.emplace_back();
+        }
+        parts.back().mLiteral += c;
+    };
+    auto appendGroup = [&parts](int group) {
+        parts.emplace_back();
+        parts.back().mGroup = group;
+    };
+    for (size_t i = 0; i < fmt.size(); ++i) {
+        char c = fmt[i];
+        if (c == '\\' || (allSyntax && strchr("()?:", c) != nullptr)) {
+            return false;
+        }
+        if (c != '$') {
+            appendLiteral(c);
+            continue;
+        }
+        if (i + 1 == fmt.size()) {
+            return false;
+        }
+        char next = fmt[i + 1];
+        if (next == '$') {
+            appendLiteral('$');
+            ++i;
+        } else if (next == '&') {
+            appendGroup(0);
+            ++i;
+        } else if (isdigit(static_cast<unsigned char>(next)) || next == '{') {
+            size_t start = next == '{' ? i + 2 : i + 1;
+            size_t end = start;
+            while (end < fmt.size() && isdigit(static_cast<unsigned char>(fmt[end])) && end - start < 9) {
+                ++end;
+            }
+            if (end == start || (end < fmt.size() && isdigit(static_cast<unsigned char>(fmt[end])))) {
+                return false;
+            }
+            if (next == '{') {
+                if (end == fmt.size() || fmt[end] != '}') {
+                    return false;
+                }
+                i = end;
+            } else {
+                i = end - 1;
+            }
+            appendGroup(stoi(fmt.substr(start, end - start)));
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CompiledRelabelConfigList::Format(const vector<FormatPart>& parts,
+                                       const re2::StringPiece* groups,
+                                       int groupCnt,
+                                       StringView prefix,
+                                       StringView suffix,
+                                       string& res) {
+    res.assign(prefix.data(), prefix.size());
+    for (const auto& part : parts) {
+        if (part.mGroup < 0) {
+            res += part.mLiteral;
+        } else if (part.mGroup < groupCnt) {
+            // a group not participating in the match is empty
+            res.append(groups[part.mGroup].data(), groups[part.mGroup].size());
+        }
+    }
+    res.append(suffix.data(), suffix.size());
+}
+
+bool CompiledRelabelConfigList::RunStep(const Step& step, MetricEvent& event) {
+    const auto& config = step.mConfig;
+    switch (config.mAction) {
+        case Action::LABELMAP:
+            MapLabels(step, event);
+            return true;
+        case Action::LABELDROP:
+            FilterLabels(step, event, false);
+            return true;
+        case Action::LABELKEEP:
+            FilterLabels(step, event, true);
+            return true;
+        default:
+            break;
+    }
+
+    static thread_local string sBuffer;
+    StringView val = GetSourceValue(step, event, sBuffer);
+    switch (config.mAction) {
+        case Action::DROP:
+            return !FullMatch(step, val);
+        case Action::KEEP:
+            return FullMatch(step, val);
+        case Action::DROPEQUAL:
+            return event.GetTag(config.mTargetLabel) != val;
+        case Action::KEEPEQUAL:
+            return event.GetTag(config.mTargetLabel) == val;
+        case Action::REPLACE:
+            Replace(step, val, config.mSourceLabels.size() == 1, event);
+            return true;
+        case Action::LOWERCASE:
+        case Action::UPPERCASE: {
+            static thread_local string sRes;
+            sRes.assign(val.data(), val.size());
+            for (auto& c : sRes) {
+                c = config.mAction == Action::LOWERCASE ? tolower(static_cast<unsigned char>(c))
+                                                        : toupper(static_cast<unsigned char>(c));
+            }
+            SetLabel(event, config.mTargetLabel, sRes, true);
+            return true;
+        }
+        case Action::HASHMOD:
+            SetLabel(event, config.mTargetLabel, ToString(config.HashMod(val)), true);
+            return true;
+        case Action::DROPMETRIC: {
+            static thread_local string sName;
+            sName.assign(val.data(), val.size());
+            return config.mMatchList.find(sName) == config.mMatchList.end();
+        }
+        default:
+            LOG_ERROR(sLogger, ("relabel: unknown relabel action type", ActionToString(config.mAction)));
+            return true;
+    }
+}
+
+StringView CompiledRelabelConfigList::GetSourceValue(const Step& step, const MetricEvent& event, string& buffer) {
+    const auto& sources = step.mConfig.mSourceLabels;
+    if (sources.size() == 1) {
+        return event.GetTag(sources[0]);
+    }
+    // values of all the source labels are collected in a single pass over the tags
+    static thread_local vector<StringView> sValues;
+    sValues.assign(sources.size(), StringView());
+    for (auto tag = event.TagsBegin(); tag != event.TagsEnd(); ++tag) {
+        for (size_t i = 0; i < sources.size(); ++i) {
+            if (tag->first == sources[i]) {
+                sValues[i] = tag->second;
+            }
+        }
+    }
+    buffer.clear();
+    for (size_t i = 0; i < sValues.size(); ++i) {
+        if (i != 0) {
+            buffer += step.mConfig.mSeparator;
+        }
+        buffer.append(sValues[i].data(), sValues[i].size());
+    }
+    return StringView(buffer);
+}
+
+bool CompiledRelabelConfigList::FullMatch(const Step& step, StringView str) {
+    switch (step.mMatchKind) {
+        case MatchKind::LITERAL: {
+            for (const auto& prefix : step.mLiteralPrefixes) {
+                if (str.starts_with(prefix)) {
+                    return true;
+                }
+            }
+            static thread_local string sStr;
+            sStr.assign(str.data(), str.size());
+            return step.mLiterals.find(sStr) != step.mLiterals.end();
+        }
+        case MatchKind::RE2:
+            return RE2::FullMatch(re2::StringPiece(str.data(), str.size()), *step.mRegex);
+        default:
+            return boost::regex_match(str.begin(), str.end(), step.mConfig.mRegex);
+    }
+}
+
+void CompiledRelabelConfigList::Replace(const Step& step, StringView val, bool valIsTag, MetricEvent& event) {
+    const auto& config = step.mConfig;
+    static thread_local string sTarget;
+    static thread_local string sRes;
+    if (step.mMatchKind == MatchKind::RE2) {
+        static thread_local vector<re2::StringPiece> sGroups;
+        sGroups.resize(step.mGroupCnt);
+        re2::StringPiece text(val.data(), val.size());
+        // the leftmost match as boost::regex_search finds
+        if (!step.mRegex->Match(text, 0, text.size(), RE2::UNANCHORED, sGroups.data(), step.mGroupCnt)) {
+            return;
+        }
+        StringView prefix(val.data(), sGroups[0].data() - val.data());
+        StringView suffix(sGroups[0].data() + sGroups[0].size(), val.size() - prefix.size() - sGroups[0].size());
+        Format(step.mTargetLabelFormat, sGroups.data(), step.mGroupCnt, prefix, suffix, sTarget);
+        const auto& parts = step.mReplacementFormat;
+        if (valIsTag && prefix.empty() && suffix.empty() && parts.size() == 1 && parts[0].mGroup >= 0) {
+            // the value is a part of the source label, e.g. with the default replacement $1, which needs no copy
+            re2::StringPiece group;
+            if (parts[0].mGroup < step.mGroupCnt) {
+                group = sGroups[parts[0].mGroup];
+            }
+            if (group.empty()) {
+                event.DelTag(sTarget);
+            } else {
+                SetLabel(event, sTarget, StringView(group.data(), group.size()), false);
+            }
+            return;
+        }
+        Format(parts, sGroups.data(), step.mGroupCnt, prefix, suffix, sRes);
+    } else {
+        string str(val.data(), val.size());
+        if (!boost::regex_search(str, config.mRegex)) {
+            return;
+        }
+        sTarget = boost::regex_replace(str, config.mRegex, config.mTargetLabel, boost::format_first_only);
+        sRes = boost::regex_replace(str, config.mRegex, config.mReplacement, boost::format_first_only);
+    }
+    if (sRes.empty()) {
+        event.DelTag(sTarget);
+    } else {
+        SetLabel(event, sTarget, sRes, true);
+    }
+}
+
+bool CompiledRelabelConfigList::MapLabel(const Step& step, StringView key, string& res) {
+    const auto& config = step.mConfig;
+    if (step.mMatchKind == MatchKind::RE2) {
+        static thread_local vector<re2::StringPiece> sGroups;
+        sGroups.resize(step.mGroupCnt);
+        re2::StringPiece text(key.data(), key.size());
+        if (!step.mRegex->Match(text, 0, text.size(), RE2::ANCHOR_START, sGroups.data(), step.mGroupCnt)) {
+            return false;
+        }
+        // boost::regex_replace replaces all matches found by searching, which are the same as the full match only if
+        // the leftmost match covers the whole key, and the regex cannot match the empty string at the end of it
+        if (sGroups[0].size() == text.size()
+            && !step.mRegex->Match(text, text.size(), text.size(), RE2::UNANCHORED, nullptr, 0)) {
+            Format(step.mReplacementFormat, sGroups.data(), step.mGroupCnt, StringView(), StringView(), res);
+            return true;
+        }
+    }
+    if (!boost::regex_match(key.begin(), key.end(), config.mRegex)) {
+        return false;
+    }
+    res = boost::regex_replace(
+        string(key.data(), key.size()), config.mRegex, config.mReplacement, boost::match_default | boost::format_all);
+    return true;
+}
+
+void CompiledRelabelConfigList::MapLabels(const Step& step, MetricEvent& event) {
+    static thread_local string sRes;
+    // only the labels before mapping are matched
+    size_t cnt = event.TagsSize();
+    for (size_t i = 0; i < cnt; ++i) {
+        auto tag = *(event.TagsBegin() + i);
+        if (MapLabel(step, tag.first, sRes)) {
+            SetLabel(event, sRes, tag.second, false);
+        }
+    }
+}
+
+void CompiledRelabelConfigList::FilterLabels(const Step& step, MetricEvent& event, bool keep) {
+    static thread_local vector<StringView> sToDel;
+    sToDel.clear();
+    for (auto tag = event.TagsBegin(); tag != event.TagsEnd(); ++tag) {
+        if (FullMatch(step, tag->first) != keep) {
+            sToDel.push_back(tag->first);
+        }
+    }
+    for (const auto& key : sToDel) {
+        event.DelTag(key);
+    }
+}
+
+void CompiledRelabelConfigList::SetLabel(MetricEvent& event, StringView key, StringView val, bool copyVal) {
+    auto& sourceBuffer = event.GetSourceBuffer();
+    if (copyVal) {
+        auto sb = sourceBuffer->CopyString(val);
+        val = StringView(sb.data, sb.size);
+    }
+    if (!event.HasTag(key)) {
+        auto sb = sourceBuffer->CopyString(key);
+        key = StringView(sb.data, sb.size);
+    }
+    event.SetTagNoCopy(key, val);
+}
+
+} // namespace logtail
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "re2/re2.h"
+
+#include "common/StringView.h"
+#include "models/MetricEvent.h"
+#include "prometheus/labels/Relabel.h"
+
+namespace logtail {
+
+// Relabel configs compiled into a flat plan of steps working on the tags of a metric event in place, rather than on a
+// copy of them as strings for each config like Labels does.
+// Full matches against patterns made of literals only, e.g. "a|b|c" or "go_.*", need no regex at all. Other patterns
+// are run by RE2, unless RE2 cannot be guaranteed to match the same as boost::regex does, in which case the
+// boost::regex of the config is used for the step, as it is when the replacement uses format syntax other than $n,
+// ${n}, $& and $$.
+// The plan is immutable once compiled, and thus can be shared by all processing threads.
+class CompiledRelabelConfigList {
+public:
+    void Compile(const std::vector<RelabelConfig>& configs);
+    // returns false if the event is dropped
+    bool Process(MetricEvent& event) const;
+
+    size_t GetStepCnt() const { return mSteps.size(); }
+
+private:
+    enum class MatchKind { LITERAL, RE2, BOOST };
+
+    // a piece of a compiled replacement, either a literal or a capture group
+    struct FormatPart {
+        std::string mLiteral;
+        int mGroup = -1;
+    };
+
+    struct Step {
+        explicit Step(const RelabelConfig& config) : mConfig(config) {}
+
+        RelabelConfig mConfig;
+        MatchKind mMatchKind = MatchKind::BOOST;
+        std::unordered_set<std::string> mLiterals;
+        std::vector<std::string> mLiteralPrefixes;
+        std::unique_ptr<RE2> mRegex;
+        // capture groups of mRegex, including the whole match
+        int mGroupCnt = 0;
+        // false if the replacements must be formatted by boost
+        bool mFormatCompiled = false;
+        std::vector<FormatPart> mTargetLabelFormat;
+        std::vector<FormatPart> mReplacementFormat;
+    };
+
+    static bool CompileFormat(const std::string& fmt, bool allSyntax, std::vector<FormatPart>& parts);
+    static void Format(const std::vector<FormatPart>& parts,
+                       const re2::StringPiece* groups,
+                       int groupCnt,
+                       StringView prefix,
+                       StringView suffix,
+                       std::string& res);
+
+    static void CompileStep(Step& step);
+    static bool RunStep(const Step& step, MetricEvent& event);
+
+    static StringView GetSourceValue(const Step& step, const MetricEvent& event, std::string& buffer);
+    static bool FullMatch(const Step& step, StringView str);
+    static void Replace(const Step& step, StringView val, bool valIsTag, MetricEvent& event);
+    static bool MapLabel(const Step& step, StringView key, std::string& res);
+    static void MapLabels(const Step& step, MetricEvent& event);
+    static void FilterLabels(const Step& step, MetricEvent& event, bool keep);
+    static void SetLabel(MetricEvent& event, StringView key, StringView val, bool copyVal);
+
+    std::vector<Step> mSteps;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class RelabelConfigUnittest;
+#endif
+};
+
+} // namespace logtail
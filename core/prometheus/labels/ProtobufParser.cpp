@@ -0,0 +1,772 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "prometheus/labels/ProtobufParser.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <limits>
+#include <string>
+
+#include "logger/Logger.h"
+#include "models/MetricValue.h"
+
+using namespace std;
+
+namespace logtail {
+
+namespace {
+
+// Protobuf wire types
+enum WireType { kVarint = 0, kFixed64 = 1, kLengthDelimited = 2, kStartGroup = 3, kEndGroup = 4, kFixed32 = 5 };
+
+// field numbers, from io/prometheus/client/metrics.proto
+enum MetricFamilyField { kFamilyNameField = 1, kFamilyTypeField = 3, kFamilyMetricField = 4 };
+enum MetricField {
+    kMetricLabelField = 1,
+    kMetricGaugeField = 2,
+    kMetricCounterField = 3,
+    kMetricSummaryField = 4,
+    kMetricUntypedField = 5,
+    kMetricTimestampField = 6,
+    kMetricHistogramField = 7
+};
+enum LabelPairField { kLabelNameField = 1, kLabelValueField = 2 };
+// the value of Gauge, Counter and Untyped
+enum SingleValueField { kSingleValueField = 1 };
+enum SummaryField { kSummaryCountField = 1, kSummarySumField = 2, kSummaryQuantileField = 3 };
+enum QuantileField { kQuantileField = 1, kQuantileValueField = 2 };
+enum HistogramField {
+    kHistogramCountField = 1,
+    kHistogramSumField = 2,
+    kHistogramBucketField = 3,
+    kHistogramCountFloatField = 4,
+    kHistogramSchemaField = 5,
+    kHistogramZeroThresholdField = 6,
+    kHistogramZeroCountField = 7,
+    kHistogramZeroCountFloatField = 8,
+    kHistogramNegativeSpanField = 9,
+    kHistogramNegativeDeltaField = 10,
+    kHistogramNegativeCountField = 11,
+    kHistogramPositiveSpanField = 12,
+    kHistogramPositiveDeltaField = 13,
+    kHistogramPositiveCountField = 14
+};
+enum BucketField { kBucketCountField = 1, kBucketUpperBoundField = 2, kBucketCountFloatField = 4 };
+enum BucketSpanField { kSpanOffsetField = 1, kSpanLengthField = 2 };
+
+enum MetricType { kCounter = 0, kGauge = 1, kSummary = 2, kUntyped = 3, kHistogram = 4, kGaugeHistogram = 5 };
+
+// schemas of native histograms with exponential buckets
+constexpr int32_t kMinSchema = -4;
+constexpr int32_t kMaxSchema = 8;
+
+class WireReader {
+public:
+    explicit WireReader(StringView data)
+        : mPos(reinterpret_cast<const uint8_t*>(data.data())), mEnd(mPos + data.size()) {}
+
+    bool HasMoreData() const { return mPos < mEnd; }
+
+    bool ReadTag(uint32_t& fieldNumber, uint32_t& wireType) {
+        uint64_t tag = 0;
+        if (!ReadVarint(tag)) {
+            return false;
+        }
+        fieldNumber = static_cast<uint32_t>(tag >> 3);
+        wireType = static_cast<uint32_t>(tag & 0x7);
+        return true;
+    }
+
+    bool ReadVarint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && mPos < mEnd; shift += 7) {
+            uint8_t byte = *mPos++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ReadDouble(uint32_t wireType, double& value) {
+        if (wireType != kFixed64 || mEnd - mPos < 8) {
+            return false;
+        }
+        // the wire format is little endian, as is every platform supported
+        memcpy(&value, mPos, sizeof(value));
+        mPos += 8;
+        return true;
+    }
+
+    bool ReadLengthDelimited(uint32_t wireType, StringView& value) {
+        uint64_t length = 0;
+        if (wireType != kLengthDelimited || !ReadVarint(length) || length > static_cast<uint64_t>(mEnd - mPos)) {
+            return false;
+        }
+        value = StringView(reinterpret_cast<const char*>(mPos), length);
+        mPos += length;
+        return true;
+    }
+
+    bool SkipField(uint32_t wireType) {
+        switch (wireType) {
+            case kVarint: {
+                uint64_t value = 0;
+                return ReadVarint(value);
+            }
+            case kFixed64:
+                return Skip(8);
+            case kLengthDelimited: {
+                StringView value;
+                return ReadLengthDelimited(wireType, value);
+            }
+            case kFixed32:
+                return Skip(4);
+            default:
+                // groups are not used by metrics.proto
+                return false;
+        }
+    }
+
+private:
+    bool Skip(size_t size) {
+        if (static_cast<size_t>(mEnd - mPos) < size) {
+            return false;
+        }
+        mPos += size;
+        return true;
+    }
+
+    const uint8_t* mPos;
+    const uint8_t* mEnd;
+};
+
+int64_t DecodeZigZag(uint64_t value) {
+    return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+// Reads a repeated sint64 field, which may be packed or not.
+bool ReadSInt64s(WireReader& reader, uint32_t wireType, vector<int64_t>& values) {
+    uint64_t value = 0;
+    if (wireType == kVarint) {
+        if (!reader.ReadVarint(value)) {
+            return false;
+        }
+        values.push_back(DecodeZigZag(value));
+        return true;
+    }
+    StringView packed;
+    if (!reader.ReadLengthDelimited(wireType, packed)) {
+        return false;
+    }
+    WireReader packedReader(packed);
+    while (packedReader.HasMoreData()) {
+        if (!packedReader.ReadVarint(value)) {
+            return false;
+        }
+        values.push_back(DecodeZigZag(value));
+    }
+    return true;
+}
+
+// Reads a repeated double field, which may be packed or not.
+bool ReadDoubles(WireReader& reader, uint32_t wireType, vector<double>& values) {
+    double value = 0;
+    if (wireType == kFixed64) {
+        if (!reader.ReadDouble(wireType, value)) {
+            return false;
+        }
+        values.push_back(value);
+        return true;
+    }
+    StringView packed;
+    if (!reader.ReadLengthDelimited(wireType, packed)) {
+        return false;
+    }
+    WireReader packedReader(packed);
+    while (packedReader.HasMoreData()) {
+        if (!packedReader.ReadDouble(kFixed64, value)) {
+            return false;
+        }
+        values.push_back(value);
+    }
+    return true;
+}
+
+bool ReadSpan(WireReader& reader, uint32_t wireType, vector<pair<int32_t, uint32_t>>& spans) {
+    StringView message;
+    if (!reader.ReadLengthDelimited(wireType, message)) {
+        return false;
+    }
+    WireReader spanReader(message);
+    auto& span = spans.emplace_back(0, 0);
+    while (spanReader.HasMoreData()) {
+        uint32_t fieldNumber = 0;
+        uint64_t value = 0;
+        if (!spanReader.ReadTag(fieldNumber, wireType)) {
+            return false;
+        }
+        if (fieldNumber == kSpanOffsetField && wireType == kVarint) {
+            if (!spanReader.ReadVarint(value)) {
+                return false;
+            }
+            span.first = static_cast<int32_t>(DecodeZigZag(value));
+        } else if (fieldNumber == kSpanLengthField && wireType == kVarint) {
+            if (!spanReader.ReadVarint(value)) {
+                return false;
+            }
+            span.second = static_cast<uint32_t>(value);
+        } else if (!spanReader.SkipField(wireType)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Reads the single double field of a Gauge, Counter or Untyped message.
+bool ReadSingleValue(StringView message, double& value) {
+    WireReader reader(message);
+    value = 0;
+    while (reader.HasMoreData()) {
+        uint32_t fieldNumber = 0;
+        uint32_t wireType = 0;
+        if (!reader.ReadTag(fieldNumber, wireType)) {
+            return false;
+        }
+        if (fieldNumber == kSingleValueField) {
+            if (!reader.ReadDouble(wireType, value)) {
+                return false;
+            }
+        } else if (!reader.SkipField(wireType)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The upper bound of the bucket at index of a native histogram, i.e. 2^(index * 2^-schema).
+double GetNativeBucketBound(int32_t index, int32_t schema) {
+    if (schema <= 0) {
+        return ldexp(1.0, index * (1 << -schema));
+    }
+    int32_t mask = (1 << schema) - 1;
+    return ldexp(exp2(static_cast<double>(index & mask) / (1 << schema)), index >> schema);
+}
+
+// Formats the value the same as the Go clients format le and quantile labels in the text exposition.
+size_t FormatFloat(double value, char* buf, size_t size) {
+    if (isnan(value)) {
+        memcpy(buf, "NaN", 3);
+        return 3;
+    }
+    if (isinf(value)) {
+        memcpy(buf, value > 0 ? "+Inf" : "-Inf", 4);
+        return 4;
+    }
+    // the shortest representation that parses back to the same value, which takes at most 17 significant digits
+    int precision = 1;
+    int len = 0;
+    for (; precision <= 17; ++precision) {
+        len = snprintf(buf, size, "%.*e", precision - 1, value);
+        if (strtod(buf, nullptr) == value) {
+            break;
+        }
+    }
+    precision = min(precision, 17);
+    // in the exponent format if the exponent is less than -4 or no less than 6
+    int exp = atoi(static_cast<const char*>(memchr(buf, 'e', len)) + 1);
+    if (exp < -4 || exp >= 6) {
+        return len;
+    }
+    return snprintf(buf, size, "%.*f", max(precision - 1 - exp, 0), value);
+}
+
+} // namespace
+
+ProtobufParser::ProtobufParser(bool honorTimestamps) : mHonorTimestamps(honorTimestamps) {
+}
+
+void ProtobufParser::SetDefaultTimestamp(uint64_t defaultTimestamp, uint32_t defaultNanoSec) {
+    mDefaultTimestamp = defaultTimestamp;
+    mDefaultNanoTimestamp = defaultNanoSec;
+}
+
+PipelineEventGroup ProtobufParser::Parse(const string& content, uint64_t defaultTimestamp, uint32_t defaultNanoSec) {
+    SetDefaultTimestamp(defaultTimestamp, defaultNanoSec);
+    auto eGroup = PipelineEventGroup(make_shared<SourceBuffer>());
+    // the only copy of the content, which the events refer to
+    auto sb = eGroup.GetSourceBuffer()->CopyString(content);
+    StringView data(sb.data, sb.size);
+    while (!data.empty()) {
+        size_t prefixSize = 0;
+        uint64_t messageSize = 0;
+        if (!ReadLengthPrefix(data, prefixSize, messageSize) || messageSize > data.size() - prefixSize) {
+            HandleError("incomplete message");
+            break;
+        }
+        if (!ParseMetricFamily(data.substr(prefixSize, messageSize), eGroup)) {
+            break;
+        }
+        data.remove_prefix(prefixSize + messageSize);
+    }
+    return eGroup;
+}
+
+bool ProtobufParser::ReadLengthPrefix(StringView data, size_t& prefixSize, uint64_t& messageSize) {
+    WireReader reader(data);
+    if (!reader.ReadVarint(messageSize)) {
+        if (data.size() < 10) {
+            return false;
+        }
+        // malformed, which no message can be long enough for
+        messageSize = numeric_limits<uint64_t>::max();
+        prefixSize = 10;
+        return true;
+    }
+    for (prefixSize = 1; static_cast<uint8_t>(data[prefixSize - 1]) & 0x80; ++prefixSize) {
+    }
+    return true;
+}
+
+bool ProtobufParser::ParseMetricFamily(StringView message, PipelineEventGroup& eGroup, EventPool* eventPool) {
+    uint32_t fieldNumber = 0;
+    uint32_t wireType = 0;
+    uint64_t type = kCounter;
+    mFamilyName = StringView();
+    // name and type are needed before the metrics, while the order of fields is not guaranteed
+    WireReader reader(message);
+    while (reader.HasMoreData()) {
+        if (!reader.ReadTag(fieldNumber, wireType)) {
+            HandleError("invalid metric family");
+            return false;
+        }
+        bool ok = true;
+        if (fieldNumber == kFamilyNameField) {
+            ok = reader.ReadLengthDelimited(wireType, mFamilyName);
+        } else if (fieldNumber == kFamilyTypeField && wireType == kVarint) {
+            ok = reader.ReadVarint(type);
+        } else {
+            ok = reader.SkipField(wireType);
+        }
+        if (!ok) {
+            HandleError("invalid metric family");
+            return false;
+        }
+    }
+    if (mFamilyName.empty()) {
+        HandleError("metric family without name");
+        return false;
+    }
+    mBucketName = StringView();
+    mSumName = StringView();
+    mCountName = StringView();
+    mFormattedBounds.clear();
+
+    reader = WireReader(message);
+    while (reader.HasMoreData()) {
+        StringView metric;
+        if (!reader.ReadTag(fieldNumber, wireType)) {
+            HandleError("invalid metric family");
+            return false;
+        }
+        if (fieldNumber != kFamilyMetricField) {
+            if (!reader.SkipField(wireType)) {
+                HandleError("invalid metric family");
+                return false;
+            }
+            continue;
+        }
+        if (!reader.ReadLengthDelimited(wireType, metric) || !ParseMetric(metric, eGroup, eventPool)) {
+            HandleError("invalid metric");
+            return false;
+        }
+        StringView value;
+        bool ok = true;
+        switch (type) {
+            case kCounter:
+            case kGauge:
+            case kUntyped: {
+                double sample = 0;
+                // the value of the type of the family, or 0 if missing
+                auto valueField = type == kCounter ? kMetricCounterField
+                                                   : (type == kGauge ? kMetricGaugeField : kMetricUntypedField);
+                WireReader metricReader(metric);
+                while (ok && metricReader.HasMoreData()) {
+                    ok = metricReader.ReadTag(fieldNumber, wireType);
+                    if (ok && fieldNumber == static_cast<uint32_t>(valueField)) {
+                        ok = metricReader.ReadLengthDelimited(wireType, value) && ReadSingleValue(value, sample);
+                    } else if (ok) {
+                        ok = metricReader.SkipField(wireType);
+                    }
+                }
+                if (ok) {
+                    AddSample(eGroup, eventPool, mFamilyName, StringView(), 0, sample);
+                }
+                break;
+            }
+            case kSummary:
+            case kHistogram:
+            case kGaugeHistogram: {
+                auto valueField = type == kSummary ? kMetricSummaryField : kMetricHistogramField;
+                WireReader metricReader(metric);
+                while (ok && metricReader.HasMoreData()) {
+                    ok = metricReader.ReadTag(fieldNumber, wireType);
+                    if (ok && fieldNumber == static_cast<uint32_t>(valueField)) {
+                        ok = metricReader.ReadLengthDelimited(wireType, value);
+                        if (ok) {
+                            ok = type == kSummary ? ParseSummary(value, eGroup, eventPool)
+                                                  : ParseHistogram(value, eGroup, eventPool);
+                        }
+                    } else if (ok) {
+                        ok = metricReader.SkipField(wireType);
+                    }
+                }
+                break;
+            }
+            default:
+                HandleError("unknown metric type " + to_string(type));
+                return false;
+        }
+        if (!ok) {
+            HandleError("invalid metric value");
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ProtobufParser::ParseMetric(StringView message, PipelineEventGroup& eGroup, EventPool* eventPool) {
+    mLabels.clear();
+    mTimestampMilliSec = 0;
+    WireReader reader(message);
+    while (reader.HasMoreData()) {
+        uint32_t fieldNumber = 0;
+        uint32_t wireType = 0;
+        if (!reader.ReadTag(fieldNumber, wireType)) {
+            return false;
+        }
+        if (fieldNumber == kMetricLabelField) {
+            StringView label;
+            if (!reader.ReadLengthDelimited(wireType, label)) {
+                return false;
+            }
+            auto& [name, value] = mLabels.emplace_back();
+            WireReader labelReader(label);
+            while (labelReader.HasMoreData()) {
+                bool ok = labelReader.ReadTag(fieldNumber, wireType);
+                if (ok && fieldNumber == kLabelNameField) {
+                    ok = labelReader.ReadLengthDelimited(wireType, name);
+                } else if (ok && fieldNumber == kLabelValueField) {
+                    ok = labelReader.ReadLengthDelimited(wireType, value);
+                } else if (ok) {
+                    ok = labelReader.SkipField(wireType);
+                }
+                if (!ok) {
+                    return false;
+                }
+            }
+        } else if (fieldNumber == kMetricTimestampField && wireType == kVarint) {
+            uint64_t timestamp = 0;
+            if (!reader.ReadVarint(timestamp)) {
+                return false;
+            }
+            mTimestampMilliSec = static_cast<int64_t>(timestamp);
+        } else if (!reader.SkipField(wireType)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ProtobufParser::ParseSummary(StringView message, PipelineEventGroup& eGroup, EventPool* eventPool) {
+    uint64_t count = 0;
+    double sum = 0;
+    WireReader reader(message);
+    while (reader.HasMoreData()) {
+        uint32_t fieldNumber = 0;
+        uint32_t wireType = 0;
+        bool ok = reader.ReadTag(fieldNumber, wireType);
+        if (ok && fieldNumber == kSummaryCountField && wireType == kVarint) {
+            ok = reader.ReadVarint(count);
+        } else if (ok && fieldNumber == kSummarySumField) {
+            ok = reader.ReadDouble(wireType, sum);
+        } else if (ok && fieldNumber == kSummaryQuantileField) {
+            StringView quantileMessage;
+            ok = reader.ReadLengthDelimited(wireType, quantileMessage);
+            double quantile = 0;
+            double value = 0;
+            WireReader quantileReader(quantileMessage);
+            while (ok && quantileReader.HasMoreData()) {
+                ok = quantileReader.ReadTag(fieldNumber, wireType);
+                if (ok && fieldNumber == kQuantileField) {
+                    ok = quantileReader.ReadDouble(wireType, quantile);
+                } else if (ok && fieldNumber == kQuantileValueField) {
+                    ok = quantileReader.ReadDouble(wireType, value);
+                } else if (ok) {
+                    ok = quantileReader.SkipField(wireType);
+                }
+            }
+            if (ok) {
+                AddSample(eGroup, eventPool, mFamilyName, "quantile", quantile, value);
+            }
+        } else if (ok) {
+            ok = reader.SkipField(wireType);
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    AddSample(eGroup, eventPool, GetSuffixedName(eGroup, "_sum", mSumName), StringView(), 0, sum);
+    AddSample(eGroup, eventPool, GetSuffixedName(eGroup, "_count", mCountName), StringView(), 0, count);
+    return true;
+}
+
+bool ProtobufParser::ParseHistogram(StringView message, PipelineEventGroup& eGroup, EventPool* eventPool) {
+    uint64_t count = 0;
+    double countFloat = 0;
+    double sum = 0;
+    int64_t schema = 0;
+    double zeroThreshold = 0;
+    uint64_t zeroCount = 0;
+    double zeroCountFloat = 0;
+    mBuckets.clear();
+    mPositiveSpans.clear();
+    mNegativeSpans.clear();
+    mPositiveDeltas.clear();
+    mNegativeDeltas.clear();
+    mPositiveCounts.clear();
+    mNegativeCounts.clear();
+
+    WireReader reader(message);
+    while (reader.HasMoreData()) {
+        uint32_t fieldNumber = 0;
+        uint32_t wireType = 0;
+        uint64_t value = 0;
+        if (!reader.ReadTag(fieldNumber, wireType)) {
+            return false;
+        }
+        bool ok = true;
+        switch (fieldNumber) {
+            case kHistogramCountField:
+                ok = wireType == kVarint && reader.ReadVarint(count);
+                break;
+            case kHistogramCountFloatField:
+                ok = reader.ReadDouble(wireType, countFloat);
+                break;
+            case kHistogramSumField:
+                ok = reader.ReadDouble(wireType, sum);
+                break;
+            case kHistogramBucketField: {
+                StringView bucketMessage;
+                ok = reader.ReadLengthDelimited(wireType, bucketMessage);
+                auto& bucket = mBuckets.emplace_back();
+                WireReader bucketReader(bucketMessage);
+                while (ok && bucketReader.HasMoreData()) {
+                    ok = bucketReader.ReadTag(fieldNumber, wireType);
+                    if (ok && fieldNumber == kBucketCountField && wireType == kVarint) {
+                        ok = bucketReader.ReadVarint(value);
+                        bucket.mCount = static_cast<double>(value);
+                    } else if (ok && fieldNumber == kBucketCountFloatField) {
+                        double countFloat = 0;
+                        ok = bucketReader.ReadDouble(wireType, countFloat);
+                        if (countFloat > 0) {
+                            bucket.mCount = countFloat;
+                        }
+                    } else if (ok && fieldNumber == kBucketUpperBoundField) {
+                        ok = bucketReader.ReadDouble(wireType, bucket.mUpperBound);
+                    } else if (ok) {
+                        ok = bucketReader.SkipField(wireType);
+                    }
+                }
+                break;
+            }
+            case kHistogramSchemaField:
+                ok = wireType == kVarint && reader.ReadVarint(value);
+                schema = DecodeZigZag(value);
+                break;
+            case kHistogramZeroThresholdField:
+                ok = reader.ReadDouble(wireType, zeroThreshold);
+                break;
+            case kHistogramZeroCountField:
+                ok = wireType == kVarint && reader.ReadVarint(zeroCount);
+                break;
+            case kHistogramZeroCountFloatField:
+                ok = reader.ReadDouble(wireType, zeroCountFloat);
+                break;
+            case kHistogramNegativeSpanField:
+                ok = ReadSpan(reader, wireType, mNegativeSpans);
+                break;
+            case kHistogramNegativeDeltaField:
+                ok = ReadSInt64s(reader, wireType, mNegativeDeltas);
+                break;
+            case kHistogramNegativeCountField:
+                ok = ReadDoubles(reader, wireType, mNegativeCounts);
+                break;
+            case kHistogramPositiveSpanField:
+                ok = ReadSpan(reader, wireType, mPositiveSpans);
+                break;
+            case kHistogramPositiveDeltaField:
+                ok = ReadSInt64s(reader, wireType, mPositiveDeltas);
+                break;
+            case kHistogramPositiveCountField:
+                ok = ReadDoubles(reader, wireType, mPositiveCounts);
+                break;
+            default:
+                ok = reader.SkipField(wireType);
+                break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+
+    // a float histogram has its counts in the float fields
+    double totalCount = countFloat > 0 ? countFloat : static_cast<double>(count);
+    bool hasZeroBucket = zeroThreshold > 0 || zeroCount > 0 || zeroCountFloat > 0;
+    if (mBuckets.empty() && (!mPositiveSpans.empty() || !mNegativeSpans.empty() || hasZeroBucket)) {
+        if (schema < kMinSchema || schema > kMaxSchema) {
+            HandleError("unsupported native histogram schema " + to_string(schema));
+        } else if (!FlattenNativeBuckets(static_cast<int32_t>(schema),
+                                         zeroThreshold,
+                                         zeroCountFloat > 0 ? zeroCountFloat : static_cast<double>(zeroCount),
+                                         hasZeroBucket)) {
+            return false;
+        }
+    }
+    auto bucketName = GetSuffixedName(eGroup, "_bucket", mBucketName);
+    for (const auto& bucket : mBuckets) {
+        AddSample(eGroup, eventPool, bucketName, "le", bucket.mUpperBound, bucket.mCount);
+    }
+    // the +Inf bucket is implicit in the protobuf exposition
+    if (mBuckets.empty() || !isinf(mBuckets.back().mUpperBound)) {
+        AddSample(eGroup, eventPool, bucketName, "le", numeric_limits<double>::infinity(), totalCount);
+    }
+    AddSample(eGroup, eventPool, GetSuffixedName(eGroup, "_sum", mSumName), StringView(), 0, sum);
+    AddSample(eGroup, eventPool, GetSuffixedName(eGroup, "_count", mCountName), StringView(), 0, totalCount);
+    return true;
+}
+
+bool ProtobufParser::FlattenNativeBuckets(int32_t schema, double zeroThreshold, double zeroCount, bool hasZeroBucket) {
+    // the absolute count of each bucket, which is delta encoded unless it is a float histogram
+    auto expand = [](const vector<pair<int32_t, uint32_t>>& spans,
+                     const vector<int64_t>& deltas,
+                     const vector<double>& counts,
+                     vector<pair<int32_t, double>>& res) {
+        bool isFloat = !counts.empty();
+        size_t total = isFloat ? counts.size() : deltas.size();
+        int32_t index = 0;
+        int64_t count = 0;
+        for (const auto& [offset, length] : spans) {
+            index += offset;
+            for (uint32_t i = 0; i < length; ++i, ++index) {
+                if (res.size() == total) {
+                    return false;
+                }
+                if (isFloat) {
+                    res.emplace_back(index, counts[res.size()]);
+                } else {
+                    count += deltas[res.size()];
+                    res.emplace_back(index, static_cast<double>(count));
+                }
+            }
+        }
+        return true;
+    };
+    static thread_local vector<pair<int32_t, double>> sNegatives;
+    static thread_local vector<pair<int32_t, double>> sPositives;
+    sNegatives.clear();
+    sPositives.clear();
+    if (!expand(mNegativeSpans, mNegativeDeltas, mNegativeCounts, sNegatives)
+        || !expand(mPositiveSpans, mPositiveDeltas, mPositiveCounts, sPositives)) {
+        HandleError("native histogram spans do not match buckets");
+        return false;
+    }
+
+    // cumulated in the order of upper bounds, from the most negative bucket, i.e. the one with the largest index
+    double cumulative = 0;
+    for (auto it = sNegatives.rbegin(); it != sNegatives.rend(); ++it) {
+        cumulative += it->second;
+        mBuckets.push_back({-GetNativeBucketBound(it->first - 1, schema), cumulative});
+    }
+    if (hasZeroBucket) {
+        cumulative += zeroCount;
+        mBuckets.push_back({zeroThreshold, cumulative});
+    }
+    for (const auto& [index, count] : sPositives) {
+        cumulative += count;
+        mBuckets.push_back({GetNativeBucketBound(index, schema), cumulative});
+    }
+    return true;
+}
+
+void ProtobufParser::AddSample(PipelineEventGroup& eGroup,
+                               EventPool* eventPool,
+                               StringView name,
+                               StringView extraLabel,
+                               double extraLabelValue,
+                               double value) {
+    auto* e = eGroup.AddMetricEvent(true, eventPool);
+    e->SetNameNoCopy(name);
+    for (const auto& [k, v] : mLabels) {
+        e->SetTagNoCopy(k, v);
+    }
+    if (!extraLabel.empty()) {
+        e->SetTagNoCopy(extraLabel, FormatBound(eGroup, extraLabelValue));
+    }
+    e->SetValue<UntypedSingleValue>(value);
+    if (mHonorTimestamps && mTimestampMilliSec > 0) {
+        e->SetTimestamp(mTimestampMilliSec / 1000, mTimestampMilliSec % 1000 * 1000000);
+    } else {
+        e->SetTimestamp(mDefaultTimestamp, mDefaultNanoTimestamp);
+    }
+}
+
+StringView ProtobufParser::FormatBound(PipelineEventGroup& eGroup, double value) {
+    for (const auto& [bound, formatted] : mFormattedBounds) {
+        // NaN never equals, but is not a valid bound anyway
+        if (bound == value && signbit(bound) == signbit(value)) {
+            return formatted;
+        }
+    }
+    char buf[32];
+    auto size = FormatFloat(value, buf, sizeof(buf));
+    auto sb = eGroup.GetSourceBuffer()->CopyString(buf, size);
+    StringView res(sb.data, sb.size);
+    mFormattedBounds.emplace_back(value, res);
+    return res;
+}
+
+StringView ProtobufParser::GetSuffixedName(PipelineEventGroup& eGroup, const char* suffix, StringView& cached) {
+    if (cached.empty()) {
+        size_t suffixSize = strlen(suffix);
+        auto sb = eGroup.GetSourceBuffer()->AllocateStringBuffer(mFamilyName.size() + suffixSize);
+        memcpy(sb.data, mFamilyName.data(), mFamilyName.size());
+        memcpy(sb.data + mFamilyName.size(), suffix, suffixSize);
+        sb.size = mFamilyName.size() + suffixSize;
+        cached = StringView(sb.data, sb.size);
+    }
+    return cached;
+}
+
+void ProtobufParser::HandleError(const string& errMsg) {
+    LOG_WARNING(sLogger, ("protobuf parser error parsing metric family", mFamilyName.to_string())("error", errMsg));
+}
+
+} // namespace logtail
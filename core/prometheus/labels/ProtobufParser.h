@@ -0,0 +1,101 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/StringView.h"
+#include "models/EventPool.h"
+#include "models/MetricEvent.h"
+#include "models/PipelineEventGroup.h"
+
+namespace logtail {
+
+// Parses the protobuf exposition format, i.e. io.prometheus.client.MetricFamily messages each prefixed by its varint
+// length, into the same metric events TextParser parses from the equivalent text exposition: one event per sample,
+// with a _bucket event per bucket plus _sum and _count events for each histogram and summary.
+// The wire format is read by hand, and names and label values refer to the message parsed instead of being copied, so
+// the message must outlive the events, e.g. by being held in the source buffer of their group.
+// Native histograms carrying no classic buckets are flattened into cumulative le buckets at the boundaries of their
+// exponential buckets, since a metric event holds a single value only.
+class ProtobufParser {
+public:
+    ProtobufParser() = default;
+    explicit ProtobufParser(bool honorTimestamps);
+
+    void SetDefaultTimestamp(uint64_t defaultTimestamp, uint32_t defaultNanoSec);
+
+    PipelineEventGroup Parse(const std::string& content, uint64_t defaultTimestamp, uint32_t defaultNanoSec);
+
+    // Reads the length prefix of the message at the beginning of data, returning false if the prefix is incomplete.
+    static bool ReadLengthPrefix(StringView data, size_t& prefixSize, uint64_t& messageSize);
+    // Parses a MetricFamily message without its length prefix. Returns false if the message is malformed, in which
+    // case the events parsed before the error are kept.
+    bool ParseMetricFamily(StringView message, PipelineEventGroup& eGroup, EventPool* eventPool = nullptr);
+
+private:
+    struct Bucket {
+        double mUpperBound = 0;
+        double mCount = 0;
+    };
+
+    bool ParseMetric(StringView message, PipelineEventGroup& eGroup, EventPool* eventPool);
+    bool ParseSummary(StringView message, PipelineEventGroup& eGroup, EventPool* eventPool);
+    bool ParseHistogram(StringView message, PipelineEventGroup& eGroup, EventPool* eventPool);
+    bool FlattenNativeBuckets(int32_t schema, double zeroThreshold, double zeroCount, bool hasZeroBucket);
+
+    void AddSample(PipelineEventGroup& eGroup,
+                   EventPool* eventPool,
+                   StringView name,
+                   StringView extraLabel,
+                   double extraLabelValue,
+                   double value);
+    StringView FormatBound(PipelineEventGroup& eGroup, double value);
+    StringView GetSuffixedName(PipelineEventGroup& eGroup, const char* suffix, StringView& cached);
+    void HandleError(const std::string& errMsg);
+
+    bool mHonorTimestamps = true;
+    time_t mDefaultTimestamp = 0;
+    uint32_t mDefaultNanoTimestamp = 0;
+
+    // state of the family and the metric being parsed
+    StringView mFamilyName;
+    StringView mBucketName;
+    StringView mSumName;
+    StringView mCountName;
+    std::vector<std::pair<StringView, StringView>> mLabels;
+    int64_t mTimestampMilliSec = 0;
+    // bounds formatted for the family, which are mostly the same for each metric of a histogram or a summary
+    std::vector<std::pair<double, StringView>> mFormattedBounds;
+    std::vector<Bucket> mBuckets;
+    std::vector<std::pair<int32_t, uint32_t>> mPositiveSpans;
+    std::vector<std::pair<int32_t, uint32_t>> mNegativeSpans;
+    std::vector<int64_t> mPositiveDeltas;
+    std::vector<int64_t> mNegativeDeltas;
+    std::vector<double> mPositiveCounts;
+    std::vector<double> mNegativeCounts;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class ProtobufParserUnittest;
+#endif
+};
+
+} // namespace logtail
@@ -24,13 +24,17 @@
 #include <string>
 #include <vector>
 
+#include "common/Flags.h"
 #include "common/ParamExtractor.h"
 #include "common/StringTools.h"
 #include "logger/Logger.h"
 #include "prometheus/Constants.h"
+#include "prometheus/labels/CompiledRelabel.h"
 
 using namespace std;
 
+DEFINE_FLAG_BOOL(enable_prom_compiled_relabel, "relabel metric events with the compiled relabel configs", true);
+
 #define ENUM_TO_STRING_CASE(EnumValue) {Action::EnumValue, ToLowerCaseString(#EnumValue)}
 
 #define STRING_TO_ENUM_CASE(EnumValue) {ToLowerCaseString(#EnumValue), Action::EnumValue}
@@ -193,15 +197,7 @@ bool RelabelConfig::Process(Labels& l) const {
             break;
         }
         case Action::HASHMOD: {
-            uint8_t digest[MD5_DIGEST_LENGTH];
-            MD5((uint8_t*)val.c_str(), val.length(), (uint8_t*)&digest);
-            // Use only the last 8 bytes of the hash to give the same result as earlier versions of this code.
-            uint64_t hashVal = 0;
-            for (int i = 8; i < MD5_DIGEST_LENGTH; ++i) {
-                hashVal = (hashVal << 8) | digest[i];
-            }
-            uint64_t mod = hashVal % mModulus;
-            l.Set(mTargetLabel, to_string(mod));
+            l.Set(mTargetLabel, to_string(HashMod(val)));
             break;
         }
         case Action::LABELMAP: {
@@ -252,6 +248,17 @@ bool RelabelConfig::Process(Labels& l) const {
     return true;
 }
 
+uint64_t RelabelConfig::HashMod(StringView val) const {
+    uint8_t digest[MD5_DIGEST_LENGTH];
+    MD5((const uint8_t*)val.data(), val.size(), (uint8_t*)&digest);
+    // Use only the last 8 bytes of the hash to give the same result as earlier versions of this code.
+    uint64_t hashVal = 0;
+    for (int i = 8; i < MD5_DIGEST_LENGTH; ++i) {
+        hashVal = (hashVal << 8) | digest[i];
+    }
+    return hashVal % mModulus;
+}
+
 bool RelabelConfigList::Init(const Json::Value& relabelConfigs) {
     if (!relabelConfigs.isArray()) {
         return false;
@@ -264,6 +271,11 @@ bool RelabelConfigList::Init(const Json::Value& relabelConfigs) {
             return false;
         }
     }
+    if (BOOL_FLAG(enable_prom_compiled_relabel)) {
+        auto compiled = make_shared<CompiledRelabelConfigList>();
+        compiled->Compile(mRelabelConfigs);
+        mCompiledRelabelConfigs = std::move(compiled);
+    }
     return true;
 }
 
@@ -277,6 +289,9 @@ bool RelabelConfigList::Process(Labels& l) const {
 }
 
 bool RelabelConfigList::Process(MetricEvent& event) const {
+    if (mCompiledRelabelConfigs) {
+        return mCompiledRelabelConfigs->Process(event);
+    }
     Labels labels;
     labels.Reset(&event);
     return Process(labels);
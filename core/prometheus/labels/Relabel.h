@@ -18,8 +18,10 @@
 #include <json/json.h>
 
 #include <boost/regex.hpp>
+#include <memory>
 #include <string>
 
+#include "common/StringView.h"
 #include "prometheus/labels/Labels.h"
 
 namespace logtail {
@@ -48,6 +50,8 @@ public:
     RelabelConfig();
     bool Init(const Json::Value&);
     bool Process(Labels&) const;
+    // MD5 of the value modulo the modulus, for the hashmod action.
+    uint64_t HashMod(StringView val) const;
 
     // A list of labels from which values are taken and concatenated
     // with the configured separator in order.
@@ -71,6 +75,8 @@ public:
 private:
 };
 
+class CompiledRelabelConfigList;
+
 class RelabelConfigList {
 public:
     bool Init(const Json::Value& relabelConfigs);
@@ -81,6 +87,8 @@ public:
 
 private:
     std::vector<RelabelConfig> mRelabelConfigs;
+    // used to process metric events, shared by the copies of the list
+    std::shared_ptr<const CompiledRelabelConfigList> mCompiledRelabelConfigs;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class RelabelConfigUnittest;
@@ -38,7 +38,8 @@ bool IsValidNumberChar(char c) {
     return sValidChars.count(c);
 };
 
-TextParser::TextParser(bool honorTimestamps) : mHonorTimestamps(honorTimestamps) {
+TextParser::TextParser(bool honorTimestamps, bool copyTokens)
+    : mHonorTimestamps(honorTimestamps), mCopyTokens(copyTokens) {
 }
 
 void TextParser::SetDefaultTimestamp(uint64_t defaultTimestamp, uint32_t defaultNanoSec) {
@@ -82,6 +83,61 @@ bool TextParser::ParseLine(StringView line, MetricEvent& metricEvent) {
     return false;
 }
 
+// get:test_metric{k1="v1", k2="v2" }
+StringView TextParser::GetSeries(StringView line) const {
+    size_t pos = 0;
+    while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t')) {
+        ++pos;
+    }
+    auto begin = pos;
+    while (pos < line.size()
+           && (std::isalnum(static_cast<unsigned char>(line[pos])) || line[pos] == '_' || line[pos] == ':')) {
+        ++pos;
+    }
+    if (pos == begin) {
+        return StringView();
+    }
+    auto end = pos;
+    while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t')) {
+        ++pos;
+    }
+    if (pos < line.size() && line[pos] == '{') {
+        // braces and escaped quotes in label values do not count
+        bool quoted = false;
+        for (++pos; pos < line.size(); ++pos) {
+            if (quoted) {
+                if (line[pos] == '\\') {
+                    ++pos;
+                } else if (line[pos] == '"') {
+                    quoted = false;
+                }
+            } else if (line[pos] == '"') {
+                quoted = true;
+            } else if (line[pos] == '}') {
+                break;
+            }
+        }
+        if (pos >= line.size()) {
+            return StringView();
+        }
+        end = pos + 1;
+    }
+    return line.substr(begin, end - begin);
+}
+
+// parse: 9.9410452992e+10 1715829785083 # exemplarsxxx
+bool TextParser::ParseSample(StringView line, std::size_t pos, MetricEvent& metricEvent) {
+    mLine = line;
+    mPos = pos;
+    mState = TextState::Start;
+    mTokenLength = 0;
+
+    SkipLeadingWhitespace();
+    HandleSampleValue(metricEvent);
+
+    return mState == TextState::Done;
+}
+
 // start to parse metric sample:test_metric{k1="v1", k2="v2" } 9.9410452992e+10 1715829785083 # exemplarsxxx
 void TextParser::HandleStart(MetricEvent& metricEvent) {
     SkipLeadingWhitespace();
@@ -101,7 +157,7 @@ void TextParser::HandleMetricName(MetricEvent& metricEvent) {
         ++mPos;
         c = (mPos < mLine.size()) ? mLine[mPos] : '\0';
     }
-    metricEvent.SetNameNoCopy(mLine.substr(mPos - mTokenLength, mTokenLength));
+    metricEvent.SetNameNoCopy(CopyToken(metricEvent, mLine.substr(mPos - mTokenLength, mTokenLength)));
     mTokenLength = 0;
     SkipLeadingWhitespace();
     if (mPos < mLine.size()) {
@@ -205,7 +261,8 @@ void TextParser::HandleLabelValue(MetricEvent& metricEvent) {
     }
 
     if (!escaped) {
-        metricEvent.SetTagNoCopy(mLabelName, mLine.substr(mPos - mTokenLength, mTokenLength));
+        metricEvent.SetTagNoCopy(CopyToken(metricEvent, mLabelName),
+                                 CopyToken(metricEvent, mLine.substr(mPos - mTokenLength, mTokenLength)));
     } else {
         metricEvent.SetTag(mLabelName.to_string(), mEscapedLabelValue);
         mEscapedLabelValue.clear();
@@ -328,6 +385,14 @@ void TextParser::HandleError(const string& errMsg) {
     mState = TextState::Error;
 }
 
+inline StringView TextParser::CopyToken(MetricEvent& metricEvent, StringView token) const {
+    if (!mCopyTokens) {
+        return token;
+    }
+    auto sb = metricEvent.GetSourceBuffer()->CopyString(token);
+    return StringView(sb.data, sb.size);
+}
+
 inline void TextParser::SkipLeadingWhitespace() {
     while (mPos < mLine.length() && (mLine[mPos] == ' ' || mLine[mPos] == '\t')) {
         mPos++;
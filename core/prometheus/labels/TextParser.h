@@ -28,7 +28,9 @@ enum class TextState { Start, Done, Error };
 class TextParser {
 public:
     TextParser() = default;
-    explicit TextParser(bool honorTimestamps);
+    // With copyTokens, the name and labels are copied into the source buffer of the event, so that the line need not
+    // outlive the event, e.g. when parsing directly from the buffer of the scrape response.
+    explicit TextParser(bool honorTimestamps, bool copyTokens = false);
 
     void SetDefaultTimestamp(uint64_t defaultTimestamp, uint32_t defaultNanoSec);
 
@@ -36,6 +38,12 @@ public:
 
     bool ParseLine(StringView line, MetricEvent& metricEvent);
 
+    // Returns the series of the line, i.e. the metric name together with the label block, or an empty view if it is
+    // malformed. The rest of the line can then be parsed by ParseSample from the end of the series.
+    StringView GetSeries(StringView line) const;
+    // parse the sample value and the timestamp only, which start from pos of the line
+    bool ParseSample(StringView line, std::size_t pos, MetricEvent& metricEvent);
+
 private:
     void HandleError(const std::string& errMsg);
 
@@ -51,6 +59,7 @@ private:
     void HandleSpace(MetricEvent& metricEvent);
 
     inline void SkipLeadingWhitespace();
+    inline StringView CopyToken(MetricEvent& metricEvent, StringView token) const;
 
     TextState mState{TextState::Start};
     StringView mLine;
@@ -63,6 +72,7 @@ private:
     std::string mDoubleStr;
 
     bool mHonorTimestamps{true};
+    bool mCopyTokens{false};
     time_t mDefaultTimestamp{0};
     uint32_t mDefaultNanoTimestamp{0};
 
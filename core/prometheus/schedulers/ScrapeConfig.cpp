@@ -23,6 +23,7 @@ ScrapeConfig::ScrapeConfig()
       mMetricsPath("/metrics"),
       mHonorLabels(false),
       mHonorTimestamps(true),
+      mScrapeNativeHistograms(false),
       mScheme("http"),
       mHostOnlyMode(false),
       mFollowRedirects(true),
@@ -152,6 +153,11 @@ bool ScrapeConfig::InitStaticConfig(const Json::Value& scrapeConfig) {
         mHonorTimestamps = scrapeConfig[prometheus::HONOR_TIMESTAMPS].asBool();
     }
 
+    if (scrapeConfig.isMember(prometheus::SCRAPE_NATIVE_HISTOGRAMS)
+        && scrapeConfig[prometheus::SCRAPE_NATIVE_HISTOGRAMS].isBool()) {
+        mScrapeNativeHistograms = scrapeConfig[prometheus::SCRAPE_NATIVE_HISTOGRAMS].asBool();
+    }
+
     if (scrapeConfig.isMember(prometheus::SCHEME) && scrapeConfig[prometheus::SCHEME].isString()) {
         mScheme = scrapeConfig[prometheus::SCHEME].asString();
     }
@@ -350,6 +356,9 @@ bool ScrapeConfig::UpdateAuthorization() {
 
 bool ScrapeConfig::InitScrapeProtocols(const Json::Value& scrapeProtocols) {
     static auto sScrapeProtocolsHeaders = std::map<string, string>{
+        {prometheus::PrometheusProto,
+         string(prometheus::PROTOBUF_MEDIA_TYPE) + ";proto=" + prometheus::PROTOBUF_PROTO
+             + ";encoding=" + prometheus::PROTOBUF_ENCODING},
         {prometheus::PrometheusText0_0_4, "text/plain;version=0.0.4"},
         {prometheus::OpenMetricsText0_0_1, "application/openmetrics-text;version=0.0.1"},
         {prometheus::OpenMetricsText1_0_0, "application/openmetrics-text;version=1.0.0"},
@@ -359,6 +368,13 @@ bool ScrapeConfig::InitScrapeProtocols(const Json::Value& scrapeProtocols) {
         prometheus::OpenMetricsText0_0_1,
         prometheus::OpenMetricsText1_0_0,
     };
+    // native histograms are exposed in the protobuf format only
+    static auto sNativeHistogramScrapeProtocols = vector<string>{
+        prometheus::PrometheusProto,
+        prometheus::PrometheusText0_0_4,
+        prometheus::OpenMetricsText0_0_1,
+        prometheus::OpenMetricsText1_0_0,
+    };
 
     auto join = [](const vector<string>& strs, const string& sep) {
         string result;
@@ -390,7 +406,8 @@ bool ScrapeConfig::InitScrapeProtocols(const Json::Value& scrapeProtocols) {
             if (!sScrapeProtocolsHeaders.count(scrapeProtocol)) {
                 LOG_WARNING(sLogger,
                             ("unknown scrape protocol prometheusproto", scrapeProtocol)(
-                                "supported", "[OpenMetricsText0.0.1 OpenMetricsText1.0.0 PrometheusText0.0.4]"));
+                                "supported",
+                                "[OpenMetricsText0.0.1 OpenMetricsText1.0.0 PrometheusProto PrometheusText0.0.4]"));
                 continue;
             }
             if (dups.count(scrapeProtocol)) {
@@ -413,7 +430,7 @@ bool ScrapeConfig::InitScrapeProtocols(const Json::Value& scrapeProtocols) {
     tmpScrapeProtocols = validateScrapeProtocols(tmpScrapeProtocols);
     // if scrape_protocols is empty, use default protocols
     if (tmpScrapeProtocols.empty()) {
-        tmpScrapeProtocols = sDefaultScrapeProtocols;
+        tmpScrapeProtocols = mScrapeNativeHistograms ? sNativeHistogramScrapeProtocols : sDefaultScrapeProtocols;
     }
 
     auto weight = tmpScrapeProtocols.size() + 1;
@@ -31,6 +31,8 @@ public:
     std::string mMetricsPath;
     bool mHonorLabels;
     bool mHonorTimestamps;
+    // prefers the protobuf exposition if no scrape protocols are configured
+    bool mScrapeNativeHistograms;
     std::string mScheme;
 
     bool mHostOnlyMode;
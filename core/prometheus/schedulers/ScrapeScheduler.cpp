@@ -25,6 +25,7 @@
 
 #include "collection_pipeline/queue/ProcessQueueManager.h"
 #include "collection_pipeline/queue/QueueKey.h"
+#include "common/Flags.h"
 #include "common/StringTools.h"
 #include "common/TimeUtil.h"
 #include "common/http/Constant.h"
@@ -36,6 +37,11 @@
 #include "prometheus/async/PromHttpRequest.h"
 #include "prometheus/component/StreamScraper.h"
 
+DECLARE_FLAG_BOOL(enable_prom_stream_parse);
+DECLARE_FLAG_BOOL(enable_prom_series_cache);
+DECLARE_FLAG_INT32(prom_series_cache_max_series);
+DECLARE_FLAG_INT32(prom_series_cache_stale_scrapes);
+
 using namespace std;
 
 namespace logtail {
@@ -61,6 +67,10 @@ ScrapeScheduler::ScrapeScheduler(std::shared_ptr<ScrapeConfig> scrapeConfigPtr,
       mInputIndex(inputIndex),
       mScrapeResponseSizeBytes(-1) {
     mInterval = scrapeIntervalSeconds;
+    if (BOOL_FLAG(enable_prom_stream_parse) && BOOL_FLAG(enable_prom_series_cache)) {
+        mSeriesCache = std::make_shared<prom::SeriesCache>(INT32_FLAG(prom_series_cache_max_series),
+                                                           INT32_FLAG(prom_series_cache_stale_scrapes));
+    }
 }
 
 void ScrapeScheduler::OnMetricResult(HttpResponse& response, uint64_t) {
@@ -106,6 +116,9 @@ void ScrapeScheduler::OnMetricResult(HttpResponse& response, uint64_t) {
     streamScraper->SendMetrics();
     mScrapeResponseSizeBytes = streamScraper->mRawSize;
     streamScraper->Reset();
+    if (mSeriesCache) {
+        mSeriesCache->OnScrapeDone();
+    }
 
     ADD_COUNTER(mPluginTotalDelayMs, scrapeDurationMilliSeconds);
 }
@@ -183,6 +196,15 @@ std::unique_ptr<TimerEvent> ScrapeScheduler::BuildScrapeTimerEvent(std::chrono::
         retry -= 1;
     }
 
+    auto* streamScraper = new prom::StreamScraper(
+        mTargetInfo.mLabels, mQueueKey, mInputIndex, mTargetInfo.mHash, mEventPool, mLatestScrapeTime);
+    streamScraper->SetHonorTimestamps(mScrapeConfigPtr->mHonorTimestamps);
+    if (BOOL_FLAG(enable_prom_stream_parse)) {
+        streamScraper->EnableStreamParse(mScrapeConfigPtr->mHonorTimestamps);
+        if (mSeriesCache) {
+            streamScraper->EnableSeriesCache(mSeriesCache, mScrapeConfigPtr);
+        }
+    }
     auto request = std::make_unique<PromHttpRequest>(
         HTTP_GET,
         mScheme == prometheus::HTTPS,
@@ -193,8 +215,7 @@ std::unique_ptr<TimerEvent> ScrapeScheduler::BuildScrapeTimerEvent(std::chrono::
         mScrapeConfigPtr->mRequestHeaders,
         "",
         HttpResponse(
-            new prom::StreamScraper(
-                mTargetInfo.mLabels, mQueueKey, mInputIndex, mTargetInfo.mHash, mEventPool, mLatestScrapeTime),
+            streamScraper,
             [](void* p) { delete static_cast<prom::StreamScraper*>(p); },
             prom::StreamScraper::MetricWriteCallback),
         mScrapeTimeoutSeconds,
@@ -203,6 +224,8 @@ std::unique_ptr<TimerEvent> ScrapeScheduler::BuildScrapeTimerEvent(std::chrono::
         this->mIsContextValidFuture,
         mScrapeConfigPtr->mFollowRedirects,
         mScrapeConfigPtr->mEnableTLS ? std::optional<CurlTLS>(mScrapeConfigPtr->mTLS) : std::nullopt);
+    // the response lives as long as the request, which is not moved once built
+    streamScraper->SetResponseHeader(request->mResponse);
 
     auto timerEvent = std::make_unique<HttpRequestTimerEvent>(execTime, std::move(request));
     return timerEvent;
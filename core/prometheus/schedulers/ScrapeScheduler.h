@@ -24,6 +24,7 @@
 #include "common/http/HttpResponse.h"
 #include "monitor/metric_models/MetricTypes.h"
 #include "prometheus/PromSelfMonitor.h"
+#include "prometheus/component/SeriesCache.h"
 #include "prometheus/schedulers/ScrapeConfig.h"
 
 #ifdef APSARA_UNIT_TEST_MAIN
@@ -89,6 +90,9 @@ private:
     // auto metrics
     std::atomic_int mScrapeResponseSizeBytes;
 
+    // series seen in the recent scrapes, shared with the stream scraper of each scrape
+    std::shared_ptr<prom::SeriesCache> mSeriesCache;
+
     // self monitor
     std::shared_ptr<PromSelfMonitorUnsafe> mSelfMonitor;
     MetricsRecordRef mMetricsRecordRef;
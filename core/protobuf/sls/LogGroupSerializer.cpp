@@ -14,6 +14,8 @@
 
 #include "protobuf/sls/LogGroupSerializer.h"
 
+#include <algorithm>
+
 #include "common/TimeUtil.h"
 
 using namespace std;
@@ -99,10 +101,31 @@ static inline void fixed32_pack(uint32_t value, string& output) {
 
 void LogGroupSerializer::Prepare(size_t size) {
     mRes.clear();
-    mRes.reserve(size);
+    mSinkFailed = false;
+    // with a sink, the result only holds a chunk and the log following it
+    mRes.reserve(mSink ? min(size, mChunkSize * 2) : size);
+}
+
+void LogGroupSerializer::SetChunkSink(function<bool(StringView)>&& sink, size_t chunkSize) {
+    mSink = std::move(sink);
+    mChunkSize = chunkSize;
+}
+
+bool LogGroupSerializer::Flush() {
+    if (!mSink) {
+        return true;
+    }
+    if (!mSinkFailed && !mRes.empty() && !mSink(StringView(mRes.data(), mRes.size()))) {
+        mSinkFailed = true;
+    }
+    mRes.clear();
+    return !mSinkFailed;
 }
 
 void LogGroupSerializer::StartToAddLog(size_t size) {
+    if (mSink && mRes.size() >= mChunkSize) {
+        Flush();
+    }
     // field = 1, wire_type = 2
     mRes.push_back(0x0A);
     uint32_pack(size, mRes);
@@ -142,6 +165,12 @@ void LogGroupSerializer::AddLogTimeNs(uint32_t logTimeNs) {
     fixed32_pack(logTimeNs, mRes);
 }
 
+void LogGroupSerializer::AddCategory(StringView category) {
+    // field = 2, wire_type = 2
+    mRes.push_back(0x12);
+    AddString(category);
+}
+
 void LogGroupSerializer::AddTopic(StringView topic) {
     // field = 3, wire_type = 2
     mRes.push_back(0x1A);
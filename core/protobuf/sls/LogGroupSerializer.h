@@ -18,6 +18,7 @@
 
 #include <cstdint>
 
+#include <functional>
 #include <string>
 
 #include "common/StringView.h"
@@ -41,12 +42,19 @@ public:
     void AddLogTime(uint32_t logTime);
     void AddLogContent(StringView key, StringView value);
     void AddLogTimeNs(uint32_t logTimeNs);
+    void AddCategory(StringView category);
     void AddTopic(StringView topic);
     void AddSource(StringView source);
     void AddMachineUUID(StringView machineUUID);
     void AddLogTag(StringView key, StringView value);
     std::string& GetResult() { return mRes; }
 
+    // When a sink is set, serialized data is handed over to it in chunks of at least chunkSize bytes, each ending at a
+    // log boundary, and the result only keeps data not handed over yet. Flush hands over the rest, and returns false
+    // if the sink has ever returned false, after which nothing is handed over until the next Prepare.
+    void SetChunkSink(std::function<bool(StringView)>&& sink, size_t chunkSize);
+    bool Flush();
+
     void AddLogContentMetricLabel(const MetricEvent& e, size_t valueSZ);
     void AddLogContentMetricTimeNano(const MetricEvent& e);
 
@@ -54,6 +62,9 @@ private:
     void AddString(StringView value);
 
     std::string mRes;
+    std::function<bool(StringView)> mSink;
+    size_t mChunkSize = 0;
+    bool mSinkFailed = false;
 };
 
 size_t GetLogContentSize(size_t keySZ, size_t valueSZ);
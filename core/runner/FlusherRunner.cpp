@@ -31,6 +31,9 @@
 #include "runner/sink/http/HttpSink.h"
 
 DEFINE_FLAG_INT32(flusher_runner_exit_timeout_sec, "", 60);
+// waiters for a free sending slot are woken up as soon as http sink finishes a request, the timeout only guarantees
+// that exiting and changes of the global concurrency are noticed
+DEFINE_FLAG_INT32(flusher_runner_sending_slot_wait_timeout_ms, "", 100);
 
 DECLARE_FLAG_INT32(discard_send_fail_interval);
 
@@ -56,6 +59,8 @@ bool FlusherRunner::Init() {
     mTotalDelayMs = mMetricsRecordRef.CreateTimeCounter(METRIC_RUNNER_TOTAL_DELAY_MS);
     mLastRunTime = mMetricsRecordRef.CreateIntGauge(METRIC_RUNNER_LAST_RUN_TIME);
     mWaitingItemsTotal = mMetricsRecordRef.CreateIntGauge(METRIC_RUNNER_FLUSHER_WAITING_ITEMS_TOTAL);
+    mSendingSlotWaitMs = mMetricsRecordRef.CreateTimeCounter(METRIC_RUNNER_FLUSHER_SENDING_SLOT_WAIT_MS);
+    mDispatchDelayMs = mMetricsRecordRef.CreateHistogram(METRIC_RUNNER_FLUSHER_DISPATCH_DELAY_MS);
     WriteMetrics::GetInstance()->CommitMetricsRecordRef(mMetricsRecordRef);
 
     mThreadRes = async(launch::async, &FlusherRunner::Run, this);
@@ -98,6 +103,7 @@ void FlusherRunner::UpdateSendFlowControl() {
 void FlusherRunner::Stop() {
     mIsFlush = true;
     SenderQueueManager::GetInstance()->Trigger();
+    mSendingCond.notify_all();
     if (!mThreadRes.valid()) {
         return;
     }
@@ -110,15 +116,31 @@ void FlusherRunner::Stop() {
 }
 
 void FlusherRunner::DecreaseHttpSendingCnt() {
-    --mHttpSendingCnt;
+    {
+        lock_guard<mutex> lock(mSendingMux);
+        --mHttpSendingCnt;
+    }
+    mSendingCond.notify_one();
     SenderQueueManager::GetInstance()->Trigger();
 }
 
-bool FlusherRunner::PushToHttpSink(SenderQueueItem* item, bool withLimit) {
-    // TODO: use semaphore instead
-    while (withLimit && !Application::GetInstance()->IsExiting()
+void FlusherRunner::WaitForSendingSlot() {
+    if (Application::GetInstance()->IsExiting()
+        || GetSendingBufferCount() < AppConfig::GetInstance()->GetSendRequestGlobalConcurrency()) {
+        return;
+    }
+    auto before = chrono::system_clock::now();
+    unique_lock<mutex> lock(mSendingMux);
+    while (!Application::GetInstance()->IsExiting()
            && GetSendingBufferCount() >= AppConfig::GetInstance()->GetSendRequestGlobalConcurrency()) {
-        this_thread::sleep_for(chrono::milliseconds(10));
+        mSendingCond.wait_for(lock, chrono::milliseconds(INT32_FLAG(flusher_runner_sending_slot_wait_timeout_ms)));
+    }
+    ADD_COUNTER(mSendingSlotWaitMs, chrono::system_clock::now() - before);
+}
+
+bool FlusherRunner::PushToHttpSink(SenderQueueItem* item, bool withLimit) {
+    if (withLimit) {
+        WaitForSendingSlot();
     }
 
     unique_ptr<HttpSinkRequest> req;
@@ -156,6 +178,10 @@ bool FlusherRunner::PushToHttpSink(SenderQueueItem* item, bool withLimit) {
     }
 
     req->mEnqueTime = item->mLastSendTime = chrono::system_clock::now();
+    // retried items are excluded, otherwise the delay would be dominated by the retry interval
+    if (item->mTryCnt == 1) {
+        OBSERVE_HISTOGRAM(mDispatchDelayMs, item->mLastSendTime - item->mFirstEnqueTime);
+    }
     LOG_TRACE(sLogger,
               ("send item to http sink, item address", item)("config-flusher-dst",
                                                              QueueKeyManager::GetInstance()->GetName(item->mQueueKey))(
@@ -19,7 +19,9 @@
 #include <cstdint>
 
 #include <atomic>
+#include <condition_variable>
 #include <future>
+#include <mutex>
 
 #include "collection_pipeline/plugin/interface/Flusher.h"
 #include "collection_pipeline/queue/SenderQueueItem.h"
@@ -54,6 +56,7 @@ private:
 
     void Run();
     bool Dispatch(SenderQueueItem* item);
+    void WaitForSendingSlot();
     bool LoadModuleConfig(bool isInit);
     void UpdateSendFlowControl();
 
@@ -63,6 +66,10 @@ private:
     std::atomic_bool mIsFlush = false;
 
     std::atomic_int32_t mHttpSendingCnt{0};
+    // decrements of mHttpSendingCnt are made under this lock, so that a waiter for a free sending slot never misses the
+    // wake up from http sink
+    std::mutex mSendingMux;
+    std::condition_variable mSendingCond;
 
     // TODO: temporarily here
     int32_t mLastCheckSendClientTime = 0;
@@ -81,6 +88,9 @@ private:
     TimeCounterPtr mTotalDelayMs;
     IntGaugePtr mWaitingItemsTotal;
     IntGaugePtr mLastRunTime;
+    TimeCounterPtr mSendingSlotWaitMs;
+    // delay from an item being enqueued to it being dispatched to http sink
+    HistogramPtr mDispatchDelayMs;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class PluginRegistryUnittest;
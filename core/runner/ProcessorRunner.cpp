@@ -22,11 +22,16 @@
 #include "models/EventPool.h"
 #include "monitor/AlarmManager.h"
 #include "monitor/metric_constants/MetricConstants.h"
+#include "protobuf/sls/LogGroupSerializer.h"
 #include "queue/ProcessQueueManager.h"
 #include "queue/QueueKeyManager.h"
 
 DEFINE_FLAG_INT32(default_flush_merged_buffer_interval, "default flush merged buffer, seconds", 1);
 DEFINE_FLAG_INT32(processor_runner_exit_timeout_sec, "", 60);
+DEFINE_FLAG_INT32(processor_runner_pop_batch_size, "max number of items popped from one process queue at a time", 16);
+DEFINE_FLAG_INT32(processor_runner_pop_batch_bytes,
+                  "no more item is popped from the process queue once the popped items reach this size, bytes",
+                  256 * 1024);
 
 DECLARE_FLAG_INT32(max_send_log_group_size);
 
@@ -34,12 +39,19 @@ using namespace std;
 
 namespace logtail {
 
+static bool IsLogEventGroup(const PipelineEventGroup& group) {
+    return !group.GetEvents().empty() && group.GetEvents()[0].Is<LogEvent>();
+}
+
 thread_local uint32_t ProcessorRunner::sThreadNo;
 thread_local MetricsRecordRef ProcessorRunner::sMetricsRecordRef;
 thread_local CounterPtr ProcessorRunner::sInGroupsCnt;
 thread_local CounterPtr ProcessorRunner::sInEventsCnt;
 thread_local CounterPtr ProcessorRunner::sInGroupDataSizeBytes;
 thread_local IntGaugePtr ProcessorRunner::sLastRunTime;
+thread_local CounterPtr ProcessorRunner::sPopBatchesCnt;
+thread_local CounterPtr ProcessorRunner::sPoppedItemsCnt;
+thread_local HistogramPtr ProcessorRunner::sProcessTimeMs;
 
 ProcessorRunner::ProcessorRunner()
     : mThreadCount(AppConfig::GetInstance()->GetProcessThreadCount()), mThreadRes(mThreadCount) {
@@ -100,6 +112,9 @@ void ProcessorRunner::Run(uint32_t threadNo) {
     sInEventsCnt = sMetricsRecordRef.CreateCounter(METRIC_RUNNER_IN_EVENTS_TOTAL);
     sInGroupDataSizeBytes = sMetricsRecordRef.CreateCounter(METRIC_RUNNER_IN_SIZE_BYTES);
     sLastRunTime = sMetricsRecordRef.CreateIntGauge(METRIC_RUNNER_LAST_RUN_TIME);
+    sPopBatchesCnt = sMetricsRecordRef.CreateCounter(METRIC_RUNNER_PROCESSOR_POP_BATCHES_TOTAL);
+    sPoppedItemsCnt = sMetricsRecordRef.CreateCounter(METRIC_RUNNER_PROCESSOR_POPPED_ITEMS_TOTAL);
+    sProcessTimeMs = sMetricsRecordRef.CreateHistogram(METRIC_RUNNER_PROCESSOR_PROCESS_TIME_MS);
     WriteMetrics::GetInstance()->CommitMetricsRecordRef(sMetricsRecordRef);
 
     static int32_t lastFlushBatchTime = 0;
@@ -111,9 +126,15 @@ void ProcessorRunner::Run(uint32_t threadNo) {
         }
 
         SET_GAUGE(sLastRunTime, curTime);
-        unique_ptr<ProcessQueueItem> item;
+        vector<unique_ptr<ProcessQueueItem>> items;
         string configName;
-        if (!ProcessQueueManager::GetInstance()->PopItem(threadNo, item, configName)) {
+        // the batch is bounded by size as well, so that a pipeline with large groups does not keep a thread for long
+        if (!ProcessQueueManager::GetInstance()->PopItems(
+                threadNo,
+                items,
+                configName,
+                static_cast<size_t>(max(INT32_FLAG(processor_runner_pop_batch_size), 1)),
+                static_cast<size_t>(max(INT32_FLAG(processor_runner_pop_batch_bytes), 1)))) {
             if (mIsFlush && ProcessQueueManager::GetInstance()->IsAllQueueEmpty()) {
                 break;
             }
@@ -121,9 +142,13 @@ void ProcessorRunner::Run(uint32_t threadNo) {
             continue;
         }
 
-        ADD_COUNTER(sInEventsCnt, item->mEventGroup.GetEvents().size());
-        ADD_COUNTER(sInGroupsCnt, 1);
-        ADD_COUNTER(sInGroupDataSizeBytes, item->mEventGroup.DataSize());
+        ADD_COUNTER(sPopBatchesCnt, 1);
+        ADD_COUNTER(sPoppedItemsCnt, items.size());
+        for (const auto& item : items) {
+            ADD_COUNTER(sInEventsCnt, item->mEventGroup.GetEvents().size());
+            ADD_COUNTER(sInGroupsCnt, 1);
+            ADD_COUNTER(sInGroupDataSizeBytes, item->mEventGroup.DataSize());
+        }
 
         const shared_ptr<CollectionPipeline>& pipeline
             = CollectionPipelineManager::GetInstance()->FindConfigByName(configName);
@@ -134,92 +159,130 @@ void ProcessorRunner::Run(uint32_t threadNo) {
             continue;
         }
 
-        bool isLog = !item->mEventGroup.GetEvents().empty() && item->mEventGroup.GetEvents()[0].Is<LogEvent>();
-
-        vector<PipelineEventGroup> eventGroupList;
-        eventGroupList.emplace_back(std::move(item->mEventGroup));
-        // TODO: use old pipeline input index to find inner processor in new pipeline, maybe cause some issues when
-        // there are multiple inputs
-        pipeline->Process(eventGroupList, item->mInputIndex);
-
-        if (pipeline->IsFlushingThroughGoPipeline()) {
-            // TODO:
-            // 1. allow all event types to be sent to Go pipelines
-            // 2. use event group protobuf instead
-            if (isLog) {
-                for (auto& group : eventGroupList) {
-                    string res, errorMsg;
-                    if (!Serialize(group,
-                                   pipeline->GetContext().GetGlobalConfig().mEnableTimestampNanosecond,
-                                   pipeline->GetContext().GetLogstoreName(),
-                                   res,
-                                   errorMsg)) {
-                        LOG_WARNING(pipeline->GetContext().GetLogger(),
-                                    ("failed to serialize event group",
-                                     errorMsg)("action", "discard data")("config", configName));
-                        pipeline->GetContext().GetAlarm().SendAlarmWarning(
-                            SERIALIZE_FAIL_ALARM,
-                            "failed to serialize event group: " + errorMsg
-                                + "\taction: discard data\tconfig: " + configName,
-                            pipeline->GetContext().GetRegion(),
-                            pipeline->GetContext().GetProjectName(),
-                            configName,
-                            pipeline->GetContext().GetLogstoreName());
-                        continue;
-                    }
-                    LogtailPlugin::GetInstance()->ProcessLogGroup(
-                        pipeline->GetContext().GetConfigName(),
-                        res,
-                        group.GetMetadata(EventGroupMetaKey::SOURCE_ID).to_string());
+        // all items come from the same queue, but they may still belong to different inputs, so they are processed in
+        // runs of consecutive items sharing the same input index, which keeps the order within the queue
+        for (size_t begin = 0; begin < items.size();) {
+            size_t inputIndex = items[begin]->mInputIndex;
+            bool isLog = IsLogEventGroup(items[begin]->mEventGroup);
+            vector<PipelineEventGroup> eventGroupList;
+            size_t end = begin;
+            for (; end < items.size(); ++end) {
+                if (items[end]->mInputIndex != inputIndex || IsLogEventGroup(items[end]->mEventGroup) != isLog) {
+                    break;
                 }
+                eventGroupList.emplace_back(std::move(items[end]->mEventGroup));
+            }
+            // TODO: use old pipeline input index to find inner processor in new pipeline, maybe cause some issues when
+            // there are multiple inputs
+            auto before = chrono::system_clock::now();
+            ProcessEventGroups(pipeline, std::move(eventGroupList), inputIndex, isLog);
+            OBSERVE_HISTOGRAM(sProcessTimeMs, chrono::system_clock::now() - before);
+            for (; begin < end; ++begin) {
+                pipeline->SubInProcessCnt();
             }
-        } else {
-            pipeline->Send(std::move(eventGroupList));
         }
-        pipeline->SubInProcessCnt();
 
         gThreadedEventPool.CheckGC();
     }
 }
 
+void ProcessorRunner::ProcessEventGroups(const shared_ptr<CollectionPipeline>& pipeline,
+                                         vector<PipelineEventGroup>&& eventGroupList,
+                                         size_t inputIndex,
+                                         bool isLog) {
+    pipeline->Process(eventGroupList, inputIndex);
+
+    if (pipeline->IsFlushingThroughGoPipeline()) {
+        // TODO:
+        // 1. allow all event types to be sent to Go pipelines
+        // 2. use event group protobuf instead
+        if (isLog) {
+            const string& configName = pipeline->GetContext().GetConfigName();
+            for (auto& group : eventGroupList) {
+                string res, errorMsg;
+                if (!Serialize(group,
+                               pipeline->GetContext().GetGlobalConfig().mEnableTimestampNanosecond,
+                               pipeline->GetContext().GetLogstoreName(),
+                               res,
+                               errorMsg)) {
+                    LOG_WARNING(pipeline->GetContext().GetLogger(),
+                                ("failed to serialize event group",
+                                 errorMsg)("action", "discard data")("config", configName));
+                    pipeline->GetContext().GetAlarm().SendAlarmWarning(
+                        SERIALIZE_FAIL_ALARM,
+                        "failed to serialize event group: " + errorMsg
+                            + "\taction: discard data\tconfig: " + configName,
+                        pipeline->GetContext().GetRegion(),
+                        pipeline->GetContext().GetProjectName(),
+                        configName,
+                        pipeline->GetContext().GetLogstoreName());
+                    continue;
+                }
+                LogtailPlugin::GetInstance()->ProcessLogGroup(
+                    configName, res, group.GetMetadata(EventGroupMetaKey::SOURCE_ID).to_string());
+            }
+        }
+    } else {
+        pipeline->Send(std::move(eventGroupList));
+    }
+}
+
 bool ProcessorRunner::Serialize(
     const PipelineEventGroup& group, bool enableNanosecond, const string& logstore, string& res, string& errorMsg) {
-    sls_logs::LogGroup logGroup;
-    for (const auto& e : group.GetEvents()) {
-        if (e.Is<LogEvent>()) {
-            const auto& logEvent = e.Cast<LogEvent>();
-            auto log = logGroup.add_logs();
-            for (const auto& kv : logEvent) {
-                auto contPtr = log->add_contents();
-                contPtr->set_key(kv.first.to_string());
-                contPtr->set_value(kv.second.to_string());
-            }
-            log->set_time(logEvent.GetTimestamp());
-            if (enableNanosecond && logEvent.GetTimestampNanosecond()) {
-                log->set_time_ns(logEvent.GetTimestampNanosecond().value());
-            }
-        } else {
+    // calculate serialized logGroup size first, so that the wire format can be written directly without building
+    // intermediate protobuf objects
+    thread_local vector<size_t> logSZ;
+    logSZ.resize(group.GetEvents().size());
+    size_t logGroupSZ = 0;
+    for (size_t i = 0; i < group.GetEvents().size(); ++i) {
+        const auto& e = group.GetEvents()[i];
+        if (!e.Is<LogEvent>()) {
             errorMsg = "unsupported event type in event group";
             return false;
         }
+        const auto& logEvent = e.Cast<LogEvent>();
+        size_t contentSZ = 0;
+        for (const auto& kv : logEvent) {
+            contentSZ += GetLogContentSize(kv.first.size(), kv.second.size());
+        }
+        logGroupSZ += GetLogSize(contentSZ, enableNanosecond && logEvent.GetTimestampNanosecond(), logSZ[i]);
     }
     for (const auto& tag : group.GetTags()) {
         if (tag.first == LOG_RESERVED_KEY_TOPIC) {
-            logGroup.set_topic(tag.second.to_string());
+            logGroupSZ += GetStringSize(tag.second.size());
         } else {
-            auto logTag = logGroup.add_logtags();
-            logTag->set_key(tag.first.to_string());
-            logTag->set_value(tag.second.to_string());
+            logGroupSZ += GetLogTagSize(tag.first.size(), tag.second.size());
         }
     }
-    logGroup.set_category(logstore);
-    size_t size = logGroup.ByteSizeLong();
-    if (static_cast<int32_t>(size) > INT32_FLAG(max_send_log_group_size)) {
-        errorMsg = "log group exceeds size limit\tgroup size: " + ToString(size)
+    logGroupSZ += GetStringSize(logstore.size());
+    if (static_cast<int32_t>(logGroupSZ) > INT32_FLAG(max_send_log_group_size)) {
+        errorMsg = "log group exceeds size limit\tgroup size: " + ToString(logGroupSZ)
             + "\tsize limit: " + ToString(INT32_FLAG(max_send_log_group_size));
         return false;
     }
-    res = logGroup.SerializeAsString();
+
+    thread_local LogGroupSerializer serializer;
+    serializer.Prepare(logGroupSZ);
+    for (size_t i = 0; i < group.GetEvents().size(); ++i) {
+        const auto& logEvent = group.GetEvents()[i].Cast<LogEvent>();
+        serializer.StartToAddLog(logSZ[i]);
+        serializer.AddLogTime(logEvent.GetTimestamp());
+        for (const auto& kv : logEvent) {
+            serializer.AddLogContent(kv.first, kv.second);
+        }
+        if (enableNanosecond && logEvent.GetTimestampNanosecond()) {
+            serializer.AddLogTimeNs(logEvent.GetTimestampNanosecond().value());
+        }
+    }
+    serializer.AddCategory(logstore);
+    for (const auto& tag : group.GetTags()) {
+        if (tag.first == LOG_RESERVED_KEY_TOPIC) {
+            serializer.AddTopic(tag.second);
+        } else {
+            serializer.AddLogTag(tag.first, tag.second);
+        }
+    }
+    res = std::move(serializer.GetResult());
     return true;
 }
 
@@ -20,6 +20,7 @@
 
 #include <atomic>
 #include <future>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -29,6 +30,8 @@
 
 namespace logtail {
 
+class CollectionPipeline;
+
 class ProcessorRunner {
 public:
     ProcessorRunner(const ProcessorRunner&) = delete;
@@ -50,6 +53,10 @@ private:
     ~ProcessorRunner() = default;
 
     void Run(uint32_t threadNo);
+    void ProcessEventGroups(const std::shared_ptr<CollectionPipeline>& pipeline,
+                            std::vector<PipelineEventGroup>&& eventGroupList,
+                            size_t inputIndex,
+                            bool isLog);
 
     bool Serialize(const PipelineEventGroup& group,
                    bool enableNanosecond,
@@ -68,6 +75,9 @@ private:
     thread_local static CounterPtr sInEventsCnt;
     thread_local static CounterPtr sInGroupDataSizeBytes;
     thread_local static IntGaugePtr sLastRunTime;
+    thread_local static CounterPtr sPopBatchesCnt;
+    thread_local static CounterPtr sPoppedItemsCnt;
+    thread_local static HistogramPtr sProcessTimeMs;
 };
 
 } // namespace logtail
@@ -25,10 +25,12 @@ namespace logtail {
 template <class T>
 class Sink {
 public:
+    virtual ~Sink() = default;
+
     virtual bool Init() = 0;
     virtual void Stop() = 0;
 
-    bool AddRequest(std::unique_ptr<T>&& request) {
+    virtual bool AddRequest(std::unique_ptr<T>&& request) {
         mQueue.Push(std::move(request));
         return true;
     }
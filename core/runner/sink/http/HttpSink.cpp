@@ -14,6 +14,7 @@
 
 #include "runner/sink/http/HttpSink.h"
 
+#include <functional>
 #include <optional>
 
 #include "app_config/AppConfig.h"
@@ -31,6 +32,7 @@
 #endif
 
 DEFINE_FLAG_INT32(http_sink_exit_timeout_sec, "", 5);
+DEFINE_FLAG_INT32(http_sink_thread_count, "number of http sink workers, each driving its own curl multi handle", 1);
 
 using namespace std;
 
@@ -46,12 +48,6 @@ HttpSink* HttpSink::GetInstance() {
 }
 
 bool HttpSink::Init() {
-    mClient = curl_multi_init();
-    if (mClient == nullptr) {
-        LOG_ERROR(sLogger, ("failed to init http sink", "failed to init curl multi client"));
-        return false;
-    }
-
     WriteMetrics::GetInstance()->CreateMetricsRecordRef(
         mMetricsRecordRef,
         MetricCategory::METRIC_CATEGORY_RUNNER,
@@ -64,6 +60,7 @@ bool HttpSink::Init() {
         = mMetricsRecordRef.CreateTimeCounter(METRIC_RUNNER_SINK_SUCCESSFUL_ITEM_TOTAL_RESPONSE_TIME_MS);
     mFailedItemTotalResponseTimeMs
         = mMetricsRecordRef.CreateTimeCounter(METRIC_RUNNER_SINK_FAILED_ITEM_TOTAL_RESPONSE_TIME_MS);
+    mResponseTimeMs = mMetricsRecordRef.CreateHistogram(METRIC_RUNNER_SINK_RESPONSE_TIME_MS);
     mSendingItemsTotal = mMetricsRecordRef.CreateIntGauge(METRIC_RUNNER_SINK_SENDING_ITEMS_TOTAL);
     mSendConcurrency = mMetricsRecordRef.CreateIntGauge(METRIC_RUNNER_SINK_SEND_CONCURRENCY);
     WriteMetrics::GetInstance()->CommitMetricsRecordRef(mMetricsRecordRef);
@@ -71,31 +68,88 @@ bool HttpSink::Init() {
     // TODO: should be dynamic
     SET_GAUGE(mSendConcurrency, AppConfig::GetInstance()->GetSendRequestGlobalConcurrency());
 
-    mThreadRes = async(launch::async, &HttpSink::Run, this);
+    size_t workerCnt = static_cast<size_t>(max(INT32_FLAG(http_sink_thread_count), 1));
+    for (size_t i = 0; i < workerCnt; ++i) {
+        auto worker = make_unique<Worker>(i);
+        worker->mClient = curl_multi_init();
+        if (worker->mClient == nullptr) {
+            LOG_ERROR(sLogger, ("failed to init http sink", "failed to init curl multi client")("worker", i));
+            break;
+        }
+        WriteMetrics::GetInstance()->CreateMetricsRecordRef(
+            worker->mMetricsRecordRef,
+            MetricCategory::METRIC_CATEGORY_RUNNER,
+            {{METRIC_LABEL_KEY_RUNNER_NAME, METRIC_LABEL_VALUE_RUNNER_NAME_HTTP_SINK_WORKER},
+             {METRIC_LABEL_KEY_THREAD_NO, ToString(i)}});
+        worker->mInItemsTotal = worker->mMetricsRecordRef.CreateCounter(METRIC_RUNNER_IN_ITEMS_TOTAL);
+        worker->mOutSuccessfulItemsTotal
+            = worker->mMetricsRecordRef.CreateCounter(METRIC_RUNNER_SINK_OUT_SUCCESSFUL_ITEMS_TOTAL);
+        worker->mOutFailedItemsTotal
+            = worker->mMetricsRecordRef.CreateCounter(METRIC_RUNNER_SINK_OUT_FAILED_ITEMS_TOTAL);
+        worker->mOutSizeBytes = worker->mMetricsRecordRef.CreateCounter(METRIC_RUNNER_OUT_SIZE_BYTES);
+        worker->mSuccessfulItemTotalResponseTimeMs
+            = worker->mMetricsRecordRef.CreateTimeCounter(METRIC_RUNNER_SINK_SUCCESSFUL_ITEM_TOTAL_RESPONSE_TIME_MS);
+        worker->mFailedItemTotalResponseTimeMs
+            = worker->mMetricsRecordRef.CreateTimeCounter(METRIC_RUNNER_SINK_FAILED_ITEM_TOTAL_RESPONSE_TIME_MS);
+        worker->mResponseTimeMs = worker->mMetricsRecordRef.CreateHistogram(METRIC_RUNNER_SINK_RESPONSE_TIME_MS);
+        worker->mSendingItemsTotal = worker->mMetricsRecordRef.CreateIntGauge(METRIC_RUNNER_SINK_SENDING_ITEMS_TOTAL);
+        WriteMetrics::GetInstance()->CommitMetricsRecordRef(worker->mMetricsRecordRef);
+        mWorkers.emplace_back(std::move(worker));
+    }
+    if (mWorkers.empty()) {
+        return false;
+    }
+    unique_ptr<HttpSinkRequest> request;
+    while (mQueue.TryPop(request)) {
+        mWorkers[GetWorkerIndex(request->mHost)]->mQueue.Push(std::move(request));
+    }
+    // workers are started only after all of them are created, since requests are sharded by the number of workers
+    for (auto& worker : mWorkers) {
+        worker->mThreadRes = async(launch::async, &HttpSink::Run, this, ref(*worker));
+    }
     return true;
 }
 
 void HttpSink::Stop() {
     mIsFlush = true;
-    if (!mThreadRes.valid()) {
-        return;
+    auto deadline = chrono::system_clock::now() + chrono::seconds(INT32_FLAG(http_sink_exit_timeout_sec));
+    for (auto& worker : mWorkers) {
+        if (!worker->mThreadRes.valid()) {
+            continue;
+        }
+        future_status s = worker->mThreadRes.wait_until(deadline);
+        if (s == future_status::ready) {
+            LOG_INFO(sLogger, ("http sink", "stopped successfully")("worker", worker->mId));
+        } else {
+            LOG_WARNING(sLogger, ("http sink", "forced to stopped")("worker", worker->mId));
+        }
+    }
+}
+
+bool HttpSink::AddRequest(unique_ptr<HttpSinkRequest>&& request) {
+    if (mWorkers.empty()) {
+        return Sink::AddRequest(std::move(request));
     }
-    future_status s = mThreadRes.wait_for(chrono::seconds(INT32_FLAG(http_sink_exit_timeout_sec)));
-    if (s == future_status::ready) {
-        LOG_INFO(sLogger, ("http sink", "stopped successfully"));
-    } else {
-        LOG_WARNING(sLogger, ("http sink", "forced to stopped"));
+    mWorkers[GetWorkerIndex(request->mHost)]->mQueue.Push(std::move(request));
+    return true;
+}
+
+size_t HttpSink::GetWorkerIndex(const string& host) const {
+    if (mWorkers.size() <= 1) {
+        return 0;
     }
+    return hash<string>{}(host) % mWorkers.size();
 }
 
-void HttpSink::Run() {
-    LOG_INFO(sLogger, ("http sink", "started"));
+void HttpSink::Run(Worker& worker) {
+    LOG_INFO(sLogger, ("http sink", "started")("worker", worker.mId));
     while (true) {
         SET_GAUGE(mLastRunTime,
                   chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count());
         unique_ptr<HttpSinkRequest> request;
-        if (mQueue.WaitAndPop(request, 500)) {
+        if (worker.mQueue.WaitAndPop(request, 500)) {
             ADD_COUNTER(mInItemsTotal, 1);
+            ADD_COUNTER(worker.mInItemsTotal, 1);
             LOG_TRACE(sLogger,
                       ("got item from flusher runner, item address", request->mItem)(
                           "config-flusher-dst", QueueKeyManager::GetInstance()->GetName(request->mItem->mQueueKey))(
@@ -103,25 +157,26 @@ void HttpSink::Run() {
                           ToString(chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now()
                                                                                - request->mEnqueTime)
                                        .count())
-                              + "ms")("try cnt", ToString(request->mTryCnt)));
-            if (!AddRequestToClient(std::move(request))) {
+                              + "ms")("try cnt", ToString(request->mTryCnt))("worker", worker.mId));
+            if (!AddRequestToClient(worker, std::move(request))) {
                 continue;
             }
             ADD_GAUGE(mSendingItemsTotal, 1);
-        } else if (mIsFlush && mQueue.Empty()) {
+            ADD_GAUGE(worker.mSendingItemsTotal, 1);
+        } else if (mIsFlush && worker.mQueue.Empty()) {
             break;
         } else {
             continue;
         }
-        DoRun();
+        DoRun(worker);
     }
-    auto mc = curl_multi_cleanup(mClient);
+    auto mc = curl_multi_cleanup(worker.mClient);
     if (mc != CURLM_OK) {
         LOG_ERROR(sLogger, ("failed to cleanup curl multi handle", "exit anyway")("errMsg", curl_multi_strerror(mc)));
     }
 }
 
-bool HttpSink::AddRequestToClient(unique_ptr<HttpSinkRequest>&& request) {
+bool HttpSink::AddRequestToClient(Worker& worker, unique_ptr<HttpSinkRequest>&& request) {
     curl_slist* headers = nullptr;
     CURL* curl = CreateCurlHandler(request->mMethod,
                                    request->mHTTPSFlag,
@@ -143,6 +198,7 @@ bool HttpSink::AddRequestToClient(unique_ptr<HttpSinkRequest>&& request) {
         request->mResponse.SetNetworkStatus(NetworkCode::Other, "failed to init curl handler");
         FlusherRunner::GetInstance()->DecreaseHttpSendingCnt();
         ADD_COUNTER(mOutFailedItemsTotal, 1);
+        ADD_COUNTER(worker.mOutFailedItemsTotal, 1);
         LOG_ERROR(sLogger,
                   ("failed to send request", "failed to init curl handler")(
                       "action", "put sender queue item back to sender queue")("item address", request->mItem)(
@@ -155,13 +211,14 @@ bool HttpSink::AddRequestToClient(unique_ptr<HttpSinkRequest>&& request) {
     curl_easy_setopt(curl, CURLOPT_PRIVATE, request.get());
     request->mLastSendTime = chrono::system_clock::now();
 
-    auto res = curl_multi_add_handle(mClient, curl);
+    auto res = curl_multi_add_handle(worker.mClient, curl);
     if (res != CURLM_OK) {
         request->mItem->mStatus = SendingStatus::IDLE;
         request->mResponse.SetNetworkStatus(NetworkCode::Other, "failed to add the easy curl handle to multi_handle");
         FlusherRunner::GetInstance()->DecreaseHttpSendingCnt();
         curl_easy_cleanup(curl);
         ADD_COUNTER(mOutFailedItemsTotal, 1);
+        ADD_COUNTER(worker.mOutFailedItemsTotal, 1);
         LOG_ERROR(sLogger,
                   ("failed to send request",
                    "failed to add the easy curl handle to multi_handle")("errMsg", curl_multi_strerror(res))(
@@ -170,30 +227,32 @@ bool HttpSink::AddRequestToClient(unique_ptr<HttpSinkRequest>&& request) {
                       "sending cnt", ToString(FlusherRunner::GetInstance()->GetSendingBufferCount())));
         return false;
     }
+    ADD_COUNTER(worker.mOutSizeBytes, request->mBody.size());
     // let sink destruct the request
     request.release();
     return true;
 }
 
-void HttpSink::DoRun() {
+void HttpSink::DoRun(Worker& worker) {
     CURLMcode mc;
     int runningHandlers = 1;
     while (runningHandlers) {
         auto curTime = chrono::system_clock::now();
         SET_GAUGE(mLastRunTime, chrono::duration_cast<chrono::seconds>(curTime.time_since_epoch()).count());
-        if ((mc = curl_multi_perform(mClient, &runningHandlers)) != CURLM_OK) {
+        if ((mc = curl_multi_perform(worker.mClient, &runningHandlers)) != CURLM_OK) {
             LOG_ERROR(
                 sLogger,
                 ("failed to call curl_multi_perform", "sleep 100ms and retry")("errMsg", curl_multi_strerror(mc)));
             this_thread::sleep_for(chrono::milliseconds(100));
             continue;
         }
-        HandleCompletedRequests(runningHandlers);
+        HandleCompletedRequests(worker, runningHandlers);
 
         unique_ptr<HttpSinkRequest> request;
         bool hasRequest = false;
-        while (mQueue.TryPop(request)) {
+        while (worker.mQueue.TryPop(request)) {
             ADD_COUNTER(mInItemsTotal, 1);
+            ADD_COUNTER(worker.mInItemsTotal, 1);
             LOG_TRACE(sLogger,
                       ("got item from flusher runner, item address", request->mItem)(
                           "config-flusher-dst", QueueKeyManager::GetInstance()->GetName(request->mItem->mQueueKey))(
@@ -201,10 +260,11 @@ void HttpSink::DoRun() {
                           ToString(chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now()
                                                                                - request->mEnqueTime)
                                        .count())
-                              + "ms")("try cnt", ToString(request->mTryCnt)));
-            if (AddRequestToClient(std::move(request))) {
+                              + "ms")("try cnt", ToString(request->mTryCnt))("worker", worker.mId));
+            if (AddRequestToClient(worker, std::move(request))) {
                 ++runningHandlers;
                 ADD_GAUGE(mSendingItemsTotal, 1);
+                ADD_GAUGE(worker.mSendingItemsTotal, 1);
                 hasRequest = true;
             }
         }
@@ -219,7 +279,7 @@ void HttpSink::DoRun() {
             1, 0
         };
         long curlTimeout = -1;
-        if ((mc = curl_multi_timeout(mClient, &curlTimeout)) != CURLM_OK) {
+        if ((mc = curl_multi_timeout(worker.mClient, &curlTimeout)) != CURLM_OK) {
             LOG_WARNING(
                 sLogger,
                 ("failed to call curl_multi_timeout", "use default timeout 1s")("errMsg", curl_multi_strerror(mc)));
@@ -240,7 +300,7 @@ void HttpSink::DoRun() {
         FD_ZERO(&fdread);
         FD_ZERO(&fdwrite);
         FD_ZERO(&fdexcep);
-        if ((mc = curl_multi_fdset(mClient, &fdread, &fdwrite, &fdexcep, &maxfd)) != CURLM_OK) {
+        if ((mc = curl_multi_fdset(worker.mClient, &fdread, &fdwrite, &fdexcep, &maxfd)) != CURLM_OK) {
             LOG_ERROR(sLogger, ("failed to call curl_multi_fdset", "sleep 100ms")("errMsg", curl_multi_strerror(mc)));
         }
         if (maxfd == -1) {
@@ -253,9 +313,9 @@ void HttpSink::DoRun() {
     }
 }
 
-void HttpSink::HandleCompletedRequests(int& runningHandlers) {
+void HttpSink::HandleCompletedRequests(Worker& worker, int& runningHandlers) {
     int msgsLeft = 0;
-    CURLMsg* msg = curl_multi_info_read(mClient, &msgsLeft);
+    CURLMsg* msg = curl_multi_info_read(worker.mClient, &msgsLeft);
     while (msg) {
         if (msg->msg == CURLMSG_DONE) {
             bool requestReused = false;
@@ -265,6 +325,8 @@ void HttpSink::HandleCompletedRequests(int& runningHandlers) {
             auto pipelinePlaceHolder = request->mItem->mPipeline; // keep pipeline alive
             auto responseTime = chrono::system_clock::now() - request->mLastSendTime;
             auto responseTimeMs = chrono::duration_cast<chrono::milliseconds>(responseTime);
+            OBSERVE_HISTOGRAM(mResponseTimeMs, responseTime);
+            OBSERVE_HISTOGRAM(worker.mResponseTimeMs, responseTime);
             switch (msg->data.result) {
                 case CURLE_OK: {
                     long statusCode = 0;
@@ -284,6 +346,9 @@ void HttpSink::HandleCompletedRequests(int& runningHandlers) {
                     ADD_COUNTER(mOutSuccessfulItemsTotal, 1);
                     ADD_COUNTER(mSuccessfulItemTotalResponseTimeMs, responseTime);
                     SUB_GAUGE(mSendingItemsTotal, 1);
+                    ADD_COUNTER(worker.mOutSuccessfulItemsTotal, 1);
+                    ADD_COUNTER(worker.mSuccessfulItemTotalResponseTimeMs, responseTime);
+                    SUB_GAUGE(worker.mSendingItemsTotal, 1);
                     break;
                 }
                 default:
@@ -300,9 +365,10 @@ void HttpSink::HandleCompletedRequests(int& runningHandlers) {
                             request->mPrivateData = nullptr;
                         }
                         ++request->mTryCnt;
-                        AddRequestToClient(unique_ptr<HttpSinkRequest>(request));
+                        AddRequestToClient(worker, unique_ptr<HttpSinkRequest>(request));
                         ++runningHandlers;
                         ADD_GAUGE(mSendingItemsTotal, 1);
+                        ADD_GAUGE(worker.mSendingItemsTotal, 1);
                         requestReused = true;
                     } else {
                         auto errMsg = curl_easy_strerror(msg->data.result);
@@ -321,9 +387,12 @@ void HttpSink::HandleCompletedRequests(int& runningHandlers) {
                     ADD_COUNTER(mOutFailedItemsTotal, 1);
                     ADD_COUNTER(mFailedItemTotalResponseTimeMs, responseTime);
                     SUB_GAUGE(mSendingItemsTotal, 1);
+                    ADD_COUNTER(worker.mOutFailedItemsTotal, 1);
+                    ADD_COUNTER(worker.mFailedItemTotalResponseTimeMs, responseTime);
+                    SUB_GAUGE(worker.mSendingItemsTotal, 1);
                     break;
             }
-            curl_multi_remove_handle(mClient, handler);
+            curl_multi_remove_handle(worker.mClient, handler);
             curl_easy_cleanup(handler);
             if (!requestReused) {
                 if (request->mPrivateData) {
@@ -332,7 +401,7 @@ void HttpSink::HandleCompletedRequests(int& runningHandlers) {
                 delete request;
             }
         }
-        msg = curl_multi_info_read(mClient, &msgsLeft);
+        msg = curl_multi_info_read(worker.mClient, &msgsLeft);
     }
 }
 
@@ -19,7 +19,10 @@
 #include <atomic>
 #include <condition_variable>
 #include <future>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <vector>
 
 #include "curl/multi.h"
 
@@ -39,18 +42,44 @@ public:
     bool Init() override;
     void Stop() override;
 
+    // requests are sharded to workers by destination host, so that connections to the same host are reused by one
+    // multi handle
+    bool AddRequest(std::unique_ptr<HttpSinkRequest>&& request) override;
+
 private:
+    // each worker owns a thread driving its own curl multi handle
+    struct Worker {
+        explicit Worker(size_t id) : mId(id) {}
+
+        size_t mId = 0;
+        CURLM* mClient = nullptr;
+        SafeQueue<std::unique_ptr<HttpSinkRequest>> mQueue;
+        std::future<void> mThreadRes;
+
+        MetricsRecordRef mMetricsRecordRef;
+        CounterPtr mInItemsTotal;
+        CounterPtr mOutSuccessfulItemsTotal;
+        CounterPtr mOutFailedItemsTotal;
+        CounterPtr mOutSizeBytes;
+        TimeCounterPtr mSuccessfulItemTotalResponseTimeMs;
+        TimeCounterPtr mFailedItemTotalResponseTimeMs;
+        HistogramPtr mResponseTimeMs;
+        IntGaugePtr mSendingItemsTotal;
+    };
+
     HttpSink() = default;
     ~HttpSink() = default;
 
-    void Run();
-    bool AddRequestToClient(std::unique_ptr<HttpSinkRequest>&& request);
-    void DoRun();
-    void HandleCompletedRequests(int& runningHandlers);
+    size_t GetWorkerIndex(const std::string& host) const;
+    void Run(Worker& worker);
+    bool AddRequestToClient(Worker& worker, std::unique_ptr<HttpSinkRequest>&& request);
+    void DoRun(Worker& worker);
+    void HandleCompletedRequests(Worker& worker, int& runningHandlers);
 
-    CURLM* mClient = nullptr;
+    // empty before Init, in which case requests stay in the queue of the base class until Init hands them over to
+    // workers. Init must not run concurrently with AddRequest, which holds since flusher runner is started after it.
+    std::vector<std::unique_ptr<Worker>> mWorkers;
 
-    std::future<void> mThreadRes;
     std::atomic_bool mIsFlush = false;
 
     mutable MetricsRecordRef mMetricsRecordRef;
@@ -59,6 +88,7 @@ private:
     CounterPtr mOutFailedItemsTotal;
     TimeCounterPtr mSuccessfulItemTotalResponseTimeMs;
     TimeCounterPtr mFailedItemTotalResponseTimeMs;
+    HistogramPtr mResponseTimeMs;
     IntGaugePtr mSendingItemsTotal;
     IntGaugePtr mSendConcurrency;
     IntGaugePtr mLastRunTime;
@@ -66,6 +96,8 @@ private:
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class FlusherRunnerUnittest;
     friend class HttpSinkMock;
+    friend class HttpSinkBenchmark;
+    friend class HttpSinkUnittest;
 #endif
 };
 
@@ -0,0 +1,128 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include "common/CharSearch.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class CharSearchUnittest : public ::testing::Test {
+public:
+    void TestFindFirstChar();
+    void TestFindLastChar();
+    void TestFindSubstring();
+
+protected:
+    void TearDown() override { SetCharSearchImpl(mDefaultImpl); }
+
+    vector<CharSearchImpl> supportedImpls() {
+        vector<CharSearchImpl> res;
+        for (auto impl : {CharSearchImpl::SCALAR, CharSearchImpl::SSE2, CharSearchImpl::AVX2}) {
+            if (SetCharSearchImpl(impl)) {
+                res.push_back(impl);
+            }
+        }
+        return res;
+    }
+
+private:
+    CharSearchImpl mDefaultImpl = GetCharSearchImpl();
+};
+
+void CharSearchUnittest::TestFindFirstChar() {
+    for (auto impl : supportedImpls()) {
+        SetCharSearchImpl(impl);
+        SCOPED_TRACE(GetCharSearchImplName());
+        APSARA_TEST_EQUAL(0U, FindFirstChar("", 0, '\n'));
+        // cover tail, single block and multiple blocks
+        for (size_t size : {1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 200}) {
+            string s(size, 'a');
+            APSARA_TEST_EQUAL(size, FindFirstChar(s.data(), s.size(), '\n'));
+            for (size_t pos = 0; pos < size; ++pos) {
+                string t = s;
+                t[pos] = '\n';
+                if (pos + 1 < size) {
+                    t[size - 1] = '\n';
+                }
+                APSARA_TEST_EQUAL(pos, FindFirstChar(t.data(), t.size(), '\n'));
+            }
+        }
+        // never read beyond size
+        string s = "abc\n";
+        APSARA_TEST_EQUAL(3U, FindFirstChar(s.data(), 3, '\n'));
+    }
+}
+
+void CharSearchUnittest::TestFindLastChar() {
+    for (auto impl : supportedImpls()) {
+        SetCharSearchImpl(impl);
+        SCOPED_TRACE(GetCharSearchImplName());
+        APSARA_TEST_EQUAL(0U, FindLastChar("", 0, '\n'));
+        for (size_t size : {1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 200}) {
+            string s(size, 'a');
+            APSARA_TEST_EQUAL(size, FindLastChar(s.data(), s.size(), '\n'));
+            for (size_t pos = 0; pos < size; ++pos) {
+                string t = s;
+                t[pos] = '\n';
+                t[0] = '\n';
+                APSARA_TEST_EQUAL(pos, FindLastChar(t.data(), t.size(), '\n'));
+            }
+        }
+        // never read before data
+        string s = "\nabc";
+        APSARA_TEST_EQUAL(3U, FindLastChar(s.data() + 1, 3, '\n'));
+    }
+}
+
+void CharSearchUnittest::TestFindSubstring() {
+    for (auto impl : supportedImpls()) {
+        SetCharSearchImpl(impl);
+        SCOPED_TRACE(GetCharSearchImplName());
+        APSARA_TEST_EQUAL(0U, FindSubstring("", 0, "", 0));
+        APSARA_TEST_EQUAL(0U, FindSubstring("", 0, "ab", 2));
+        APSARA_TEST_EQUAL(1U, FindSubstring("a", 1, "ab", 2));
+        for (string needle : {"p", "pw", "pwd", "pwd=", "password="}) {
+            for (size_t size : {1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 200}) {
+                // partial matches of the needle everywhere
+                string s;
+                while (s.size() < size) {
+                    s += needle.substr(0, needle.size() - 1) + "x";
+                }
+                s.resize(size);
+                APSARA_TEST_EQUAL(size, FindSubstring(s.data(), s.size(), needle.data(), needle.size()));
+                for (size_t pos = 0; pos + needle.size() <= size; ++pos) {
+                    string t = s;
+                    t.replace(pos, needle.size(), needle);
+                    APSARA_TEST_EQUAL(t.find(needle), FindSubstring(t.data(), t.size(), needle.data(), needle.size()));
+                }
+            }
+        }
+        // never read beyond size
+        string s = "abcpwd";
+        APSARA_TEST_EQUAL(5U, FindSubstring(s.data(), 5, "pwd", 3));
+    }
+}
+
+UNIT_TEST_CASE(CharSearchUnittest, TestFindFirstChar);
+UNIT_TEST_CASE(CharSearchUnittest, TestFindLastChar);
+UNIT_TEST_CASE(CharSearchUnittest, TestFindSubstring);
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
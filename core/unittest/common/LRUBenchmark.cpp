@@ -14,12 +14,16 @@
  * limitations under the License.
  */
 
+#include <memory>
+#include <mutex>
 #include <random>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
 #include "common/LRUCache.h"
+#include "common/ShardedLRUCache.h"
 #include "unittest/Unittest.h"
 
 using namespace std;
@@ -30,6 +34,7 @@ class LRUBenchmark : public testing::Test {
 public:
     void TestReadWrite_1_1();
     void TestReadWrite_10_1();
+    void TestConcurrentRead();
 
 protected:
     void SetUp() override {
@@ -44,6 +49,8 @@ protected:
 
 private:
     void TestReadWrite(int readIterations);
+    template <typename Cache>
+    double ConcurrentRead(Cache& cache, const vector<string>& keys, int threadCnt, int readCnt);
     vector<pair<string, string>> mKVs;
     random_device mRd;
 };
@@ -93,8 +100,64 @@ void LRUBenchmark::TestReadWrite_10_1() {
     // elapsed: 4960MB in release mode
 }
 
+// as K8sMetadata is looked up by ebpf threads, where most keys are hit and are looked up as views into records
+template <typename Cache>
+double LRUBenchmark::ConcurrentRead(Cache& cache, const vector<string>& keys, int threadCnt, int readCnt) {
+    auto start = std::chrono::high_resolution_clock::now();
+    vector<thread> threads;
+    for (int t = 0; t < threadCnt; ++t) {
+        threads.emplace_back([&cache, &keys, t, readCnt]() {
+            size_t hit = 0;
+            for (int i = 0; i < readCnt; ++i) {
+                const auto& key = keys[(i * 31 + t) % keys.size()];
+                shared_ptr<string> value;
+                hit += cache.tryGetCopy(StringView(key), value);
+            }
+            APSARA_TEST_EQUAL(static_cast<size_t>(readCnt), hit);
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void LRUBenchmark::TestConcurrentRead() {
+    const int threadCnt = 8;
+    const int readCnt = 1000000;
+    vector<string> keys;
+    for (int i = 0; i < 512; ++i) {
+        keys.push_back("10.0." + to_string(i / 256) + "." + to_string(i % 256));
+    }
+    {
+        lru11::Cache<string, shared_ptr<string>, std::mutex> cache(1024, 20);
+        for (const auto& key : keys) {
+            cache.insert(key, make_shared<string>(key));
+        }
+        // lru11 only accepts string keys, so each lookup copies the key as K8sMetadata did
+        struct Adapter {
+            bool tryGetCopy(StringView key, shared_ptr<string>& value) {
+                return mCache.tryGetCopy(string(key.data(), key.size()), value);
+            }
+            lru11::Cache<string, shared_ptr<string>, std::mutex>& mCache;
+        } adapter{cache};
+        cout << "LRU with mutex, " << threadCnt
+             << " threads elapsed: " << ConcurrentRead(adapter, keys, threadCnt, readCnt) << " seconds" << endl;
+    }
+    {
+        ShardedLRUCache<shared_ptr<string>> cache(1024, 20);
+        for (const auto& key : keys) {
+            cache.insert(key, make_shared<string>(key));
+        }
+        cout << "sharded LRU, " << threadCnt
+             << " threads elapsed: " << ConcurrentRead(cache, keys, threadCnt, readCnt) << " seconds" << endl;
+    }
+}
+
 UNIT_TEST_CASE(LRUBenchmark, TestReadWrite_1_1)
 UNIT_TEST_CASE(LRUBenchmark, TestReadWrite_10_1)
+UNIT_TEST_CASE(LRUBenchmark, TestConcurrentRead)
 
 } // namespace logtail
 
@@ -0,0 +1,151 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/BloomFilter.h"
+#include "common/ShardedLRUCache.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class ShardedLRUCacheUnittest : public ::testing::Test {
+public:
+    void TestInsertAndGet();
+    void TestEviction();
+    void TestConcurrentAccess();
+    void TestBloomFilter();
+};
+
+void ShardedLRUCacheUnittest::TestInsertAndGet() {
+    ShardedLRUCache<int> cache(100, 10, 4);
+    cache.insert("a", 1);
+    cache.insert(string("b"), 2);
+    int value = 0;
+    // looked up by a view into a larger buffer
+    string buffer = "abc";
+    APSARA_TEST_TRUE(cache.tryGetCopy(StringView(buffer.data(), 1), value));
+    APSARA_TEST_EQUAL(1, value);
+    APSARA_TEST_TRUE(cache.tryGetCopy(StringView(buffer.data() + 1, 1), value));
+    APSARA_TEST_EQUAL(2, value);
+    APSARA_TEST_FALSE(cache.tryGetCopy(StringView(buffer.data(), 2), value));
+    APSARA_TEST_FALSE(cache.contains("c"));
+
+    cache.insert("a", 3);
+    APSARA_TEST_TRUE(cache.tryGetCopy("a", value));
+    APSARA_TEST_EQUAL(3, value);
+    APSARA_TEST_EQUAL(2U, cache.size());
+
+    APSARA_TEST_TRUE(cache.remove("a"));
+    APSARA_TEST_FALSE(cache.remove("a"));
+    APSARA_TEST_FALSE(cache.contains("a"));
+    APSARA_TEST_EQUAL(1U, cache.size());
+
+    cache.clear();
+    APSARA_TEST_EQUAL(0U, cache.size());
+}
+
+void ShardedLRUCacheUnittest::TestEviction() {
+    // one shard, so that eviction is exact
+    ShardedLRUCache<int> cache(10, 5, 1);
+    for (int i = 0; i < 10; ++i) {
+        cache.insert(to_string(i), i);
+    }
+    // keys looked up recently are kept
+    int value = 0;
+    for (int i = 0; i < 4; ++i) {
+        APSARA_TEST_TRUE(cache.tryGetCopy(to_string(i), value));
+    }
+    for (int i = 10; i < 15; ++i) {
+        cache.insert(to_string(i), i);
+    }
+    APSARA_TEST_EQUAL(15U, cache.size());
+    cache.insert("15", 15);
+    APSARA_TEST_EQUAL(10U, cache.size());
+    for (int i = 0; i < 4; ++i) {
+        APSARA_TEST_TRUE(cache.contains(to_string(i)));
+    }
+    for (int i = 4; i < 10; ++i) {
+        APSARA_TEST_FALSE(cache.contains(to_string(i)));
+    }
+    for (int i = 10; i < 16; ++i) {
+        APSARA_TEST_TRUE(cache.contains(to_string(i)));
+    }
+
+    // size is bounded with many shards as well
+    ShardedLRUCache<int> shardedCache(1024, 20, 16);
+    for (int i = 0; i < 10000; ++i) {
+        shardedCache.insert(to_string(i), i);
+    }
+    APSARA_TEST_TRUE(shardedCache.size() <= 1024 + 1024 / 4 + 16 * 2);
+    size_t cnt = 0;
+    shardedCache.forEachKey([&cnt](StringView) { ++cnt; });
+    APSARA_TEST_EQUAL(shardedCache.size(), cnt);
+}
+
+void ShardedLRUCacheUnittest::TestConcurrentAccess() {
+    ShardedLRUCache<shared_ptr<string>> cache(256, 20, 16);
+    vector<thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&cache, t]() {
+            for (int i = 0; i < 20000; ++i) {
+                auto key = to_string((i * 7 + t) % 512);
+                shared_ptr<string> value;
+                if (cache.tryGetCopy(key, value)) {
+                    APSARA_TEST_EQUAL(key, *value);
+                } else {
+                    cache.insert(key, make_shared<string>(key));
+                }
+                if (i % 100 == 0) {
+                    cache.remove(key);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    APSARA_TEST_TRUE(cache.size() <= 256 + 256 / 4 + 16 * 2);
+}
+
+void ShardedLRUCacheUnittest::TestBloomFilter() {
+    BloomFilter filter(1000);
+    for (int i = 0; i < 1000; ++i) {
+        filter.Add("10.0.0." + to_string(i));
+    }
+    for (int i = 0; i < 1000; ++i) {
+        APSARA_TEST_TRUE(filter.MayContain("10.0.0." + to_string(i)));
+    }
+    size_t falsePositiveCnt = 0;
+    for (int i = 0; i < 100000; ++i) {
+        falsePositiveCnt += filter.MayContain("192.168." + to_string(i / 256) + "." + to_string(i % 256));
+    }
+    APSARA_TEST_TRUE(falsePositiveCnt < 1000);
+
+    filter.Clear();
+    APSARA_TEST_FALSE(filter.MayContain("10.0.0.1"));
+}
+
+UNIT_TEST_CASE(ShardedLRUCacheUnittest, TestInsertAndGet)
+UNIT_TEST_CASE(ShardedLRUCacheUnittest, TestEviction)
+UNIT_TEST_CASE(ShardedLRUCacheUnittest, TestConcurrentAccess)
+UNIT_TEST_CASE(ShardedLRUCacheUnittest, TestBloomFilter)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
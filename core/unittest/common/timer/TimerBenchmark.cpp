@@ -0,0 +1,99 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <iostream>
+
+#include "common/timer/Timer.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_BOOL(enable_timer_wheel);
+
+using namespace std;
+
+namespace logtail {
+
+// reschedules itself with the same interval, like scrape events of prometheus targets
+struct PeriodicTimerEventMock : public TimerEvent {
+    PeriodicTimerEventMock(Timer& timer,
+                           const chrono::steady_clock::time_point& execTime,
+                           chrono::milliseconds interval,
+                           atomic_int64_t& execCnt,
+                           atomic_int64_t& totalLagUs)
+        : TimerEvent(execTime), mTimer(timer), mInterval(interval), mExecCnt(execCnt), mTotalLagUs(totalLagUs) {}
+
+    bool IsValid() const override { return true; }
+    bool Execute() override {
+        auto now = chrono::steady_clock::now();
+        mTotalLagUs += chrono::duration_cast<chrono::microseconds>(now - GetExecTime()).count();
+        ++mExecCnt;
+        mTimer.PushEvent(make_unique<PeriodicTimerEventMock>(
+            mTimer, GetExecTime() + mInterval, mInterval, mExecCnt, mTotalLagUs));
+        return true;
+    }
+
+    Timer& mTimer;
+    chrono::milliseconds mInterval;
+    atomic_int64_t& mExecCnt;
+    atomic_int64_t& mTotalLagUs;
+};
+
+class TimerBenchmark : public testing::Test {
+public:
+    void TestPeriodicEvents();
+
+private:
+    void Run(bool useWheel);
+};
+
+void TimerBenchmark::Run(bool useWheel) {
+    const size_t eventCnt = 100000;
+    const auto interval = chrono::seconds(1);
+    const auto duration = chrono::seconds(5);
+
+    BOOL_FLAG(enable_timer_wheel) = useWheel;
+    atomic_int64_t execCnt = 0;
+    atomic_int64_t totalLagUs = 0;
+    {
+        Timer timer;
+        timer.Init();
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < eventCnt; ++i) {
+            // spread the first exec time of events over the interval
+            auto execTime = start + interval * i / eventCnt;
+            timer.PushEvent(make_unique<PeriodicTimerEventMock>(timer, execTime, interval, execCnt, totalLagUs));
+        }
+        chrono::duration<double> pushElapsed = chrono::steady_clock::now() - start;
+        this_thread::sleep_for(duration);
+        timer.Stop();
+
+        cout << (useWheel ? "timing wheel" : "priority queue") << ": push " << eventCnt
+             << " events elapsed: " << pushElapsed.count() << " seconds, executed: " << execCnt.load()
+             << ", avg dispatch lag: " << (execCnt.load() == 0 ? 0 : totalLagUs.load() / execCnt.load()) << " us"
+             << endl;
+        timer.Clear();
+    }
+    BOOL_FLAG(enable_timer_wheel) = false;
+}
+
+void TimerBenchmark::TestPeriodicEvents() {
+    Run(false);
+    Run(true);
+}
+
+UNIT_TEST_CASE(TimerBenchmark, TestPeriodicEvents)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -12,11 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
 #include <vector>
 
 #include "common/timer/Timer.h"
 #include "unittest/Unittest.h"
 
+DECLARE_FLAG_BOOL(enable_timer_wheel);
+DECLARE_FLAG_INT32(timer_dispatch_thread_count);
+
 using namespace std;
 
 namespace logtail {
@@ -30,9 +34,23 @@ struct TimerEventMock : public TimerEvent {
     bool mIsValid = false;
 };
 
+struct CountingTimerEventMock : public TimerEvent {
+    CountingTimerEventMock(const chrono::steady_clock::time_point& execTime, atomic_int& cnt)
+        : TimerEvent(execTime), mCnt(cnt) {}
+
+    bool IsValid() const override { return true; }
+    bool Execute() override {
+        ++mCnt;
+        return true;
+    }
+
+    atomic_int& mCnt;
+};
+
 class TimerUnittest : public ::testing::Test {
 public:
     void TestPushEvent();
+    void TestWheelMode();
     void TestPeriodicEvent();
     void TestGetTimeStamp();
 
@@ -57,7 +75,39 @@ void TimerUnittest::TestPushEvent() {
     timer.mQueue.pop();
 }
 
+void TimerUnittest::TestWheelMode() {
+    for (int32_t threadCnt : {1, 4}) {
+        BOOL_FLAG(enable_timer_wheel) = true;
+        INT32_FLAG(timer_dispatch_thread_count) = threadCnt;
+        atomic_int cnt = 0;
+        {
+            Timer timer;
+            APSARA_TEST_TRUE(timer.mUseWheel);
+            timer.Init();
+            auto now = chrono::steady_clock::now();
+            timer.PushEvent(make_unique<CountingTimerEventMock>(now + chrono::milliseconds(200), cnt));
+            for (int i = 0; i < 100; ++i) {
+                timer.PushEvent(make_unique<CountingTimerEventMock>(now + chrono::milliseconds(50), cnt));
+            }
+            // event earlier than the current earliest one should wake up the ticker
+            timer.PushEvent(make_unique<CountingTimerEventMock>(now, cnt));
+            this_thread::sleep_for(chrono::milliseconds(20));
+            APSARA_TEST_EQUAL(1, cnt.load());
+            this_thread::sleep_for(chrono::milliseconds(100));
+            APSARA_TEST_EQUAL(101, cnt.load());
+            this_thread::sleep_for(chrono::milliseconds(200));
+            APSARA_TEST_EQUAL(102, cnt.load());
+            APSARA_TEST_TRUE(timer.mQueue.empty());
+            APSARA_TEST_TRUE(timer.mWheel.Empty());
+            timer.Stop();
+        }
+    }
+    BOOL_FLAG(enable_timer_wheel) = false;
+    INT32_FLAG(timer_dispatch_thread_count) = 1;
+}
+
 UNIT_TEST_CASE(TimerUnittest, TestPushEvent)
+UNIT_TEST_CASE(TimerUnittest, TestWheelMode)
 
 } // namespace logtail
 
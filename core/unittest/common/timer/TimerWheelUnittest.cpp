@@ -0,0 +1,169 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>
+
+#include "common/timer/TimerWheel.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+struct TimerWheelEventMock : public TimerEvent {
+    TimerWheelEventMock(const chrono::steady_clock::time_point& execTime) : TimerEvent(execTime) {}
+
+    bool IsValid() const override { return true; }
+    bool Execute() override { return true; }
+};
+
+class TimerWheelUnittest : public ::testing::Test {
+public:
+    void TestAdvance();
+    void TestBatchExpire();
+    void TestCascade();
+    void TestOverflow();
+    void TestEventAlreadyDue();
+    void TestNextExpireTime();
+    void TestClear();
+
+protected:
+    void SetUp() override { mStart = chrono::steady_clock::now(); }
+
+    chrono::steady_clock::time_point mStart;
+};
+
+void TimerWheelUnittest::TestAdvance() {
+    TimerWheel wheel(mStart, chrono::milliseconds(1));
+    wheel.Add(make_unique<TimerWheelEventMock>(mStart + chrono::milliseconds(20)));
+    wheel.Add(make_unique<TimerWheelEventMock>(mStart + chrono::milliseconds(10)));
+    wheel.Add(make_unique<TimerWheelEventMock>(mStart + chrono::milliseconds(30)));
+    APSARA_TEST_EQUAL(3U, wheel.Size());
+
+    vector<unique_ptr<TimerEvent>> expired;
+    wheel.Advance(mStart + chrono::milliseconds(9), expired);
+    APSARA_TEST_TRUE(expired.empty());
+
+    wheel.Advance(mStart + chrono::milliseconds(10), expired);
+    APSARA_TEST_EQUAL(1U, expired.size());
+    APSARA_TEST_EQUAL(mStart + chrono::milliseconds(10), expired[0]->GetExecTime());
+    expired.clear();
+
+    wheel.Advance(mStart + chrono::milliseconds(30), expired);
+    APSARA_TEST_EQUAL(2U, expired.size());
+    APSARA_TEST_EQUAL(mStart + chrono::milliseconds(20), expired[0]->GetExecTime());
+    APSARA_TEST_EQUAL(mStart + chrono::milliseconds(30), expired[1]->GetExecTime());
+    APSARA_TEST_TRUE(wheel.Empty());
+}
+
+void TimerWheelUnittest::TestBatchExpire() {
+    TimerWheel wheel(mStart, chrono::milliseconds(1));
+    for (size_t i = 0; i < 1000; ++i) {
+        wheel.Add(make_unique<TimerWheelEventMock>(mStart + chrono::milliseconds(100)));
+    }
+    vector<unique_ptr<TimerEvent>> expired;
+    wheel.Advance(mStart + chrono::milliseconds(100), expired);
+    APSARA_TEST_EQUAL(1000U, expired.size());
+    APSARA_TEST_TRUE(wheel.Empty());
+}
+
+void TimerWheelUnittest::TestCascade() {
+    TimerWheel wheel(mStart, chrono::milliseconds(1));
+    // one event per level
+    vector<chrono::milliseconds> delays
+        = {chrono::milliseconds(5), chrono::milliseconds(100), chrono::milliseconds(5000), chrono::minutes(10)};
+    for (const auto& delay : delays) {
+        wheel.Add(make_unique<TimerWheelEventMock>(mStart + delay));
+    }
+    APSARA_TEST_EQUAL(1U, wheel.mLevelSizes[0]);
+    APSARA_TEST_EQUAL(1U, wheel.mLevelSizes[1]);
+    APSARA_TEST_EQUAL(1U, wheel.mLevelSizes[2]);
+    APSARA_TEST_EQUAL(1U, wheel.mLevelSizes[3]);
+
+    vector<unique_ptr<TimerEvent>> expired;
+    for (const auto& delay : delays) {
+        wheel.Advance(mStart + delay - chrono::milliseconds(1), expired);
+        APSARA_TEST_TRUE(expired.empty());
+        wheel.Advance(mStart + delay, expired);
+        APSARA_TEST_EQUAL(1U, expired.size());
+        APSARA_TEST_EQUAL(mStart + delay, expired[0]->GetExecTime());
+        expired.clear();
+    }
+    APSARA_TEST_TRUE(wheel.Empty());
+}
+
+void TimerWheelUnittest::TestOverflow() {
+    TimerWheel wheel(mStart, chrono::milliseconds(1));
+    wheel.Add(make_unique<TimerWheelEventMock>(mStart + chrono::hours(10)));
+    APSARA_TEST_EQUAL(1U, wheel.mLevelSizes[TimerWheel::kLevelCnt]);
+
+    vector<unique_ptr<TimerEvent>> expired;
+    wheel.Advance(mStart + chrono::hours(10) - chrono::milliseconds(1), expired);
+    APSARA_TEST_TRUE(expired.empty());
+    wheel.Advance(mStart + chrono::hours(10), expired);
+    APSARA_TEST_EQUAL(1U, expired.size());
+}
+
+void TimerWheelUnittest::TestEventAlreadyDue() {
+    TimerWheel wheel(mStart, chrono::milliseconds(1));
+    vector<unique_ptr<TimerEvent>> expired;
+    wheel.Advance(mStart + chrono::seconds(1), expired);
+    wheel.Add(make_unique<TimerWheelEventMock>(mStart));
+    APSARA_TEST_EQUAL(mStart + chrono::seconds(1), wheel.NextExpireTime().value());
+    wheel.Advance(mStart + chrono::seconds(1), expired);
+    APSARA_TEST_EQUAL(1U, expired.size());
+}
+
+void TimerWheelUnittest::TestNextExpireTime() {
+    TimerWheel wheel(mStart, chrono::milliseconds(1));
+    APSARA_TEST_FALSE(wheel.NextExpireTime().has_value());
+
+    // exec time is rounded up to the tick
+    wheel.Add(make_unique<TimerWheelEventMock>(mStart + chrono::microseconds(10500)));
+    APSARA_TEST_EQUAL(mStart + chrono::milliseconds(11), wheel.NextExpireTime().value());
+
+    // for events at higher levels, next expire time is no later than the exec time
+    TimerWheel farWheel(mStart, chrono::milliseconds(1));
+    farWheel.Add(make_unique<TimerWheelEventMock>(mStart + chrono::seconds(3)));
+    APSARA_TEST_TRUE(farWheel.NextExpireTime().value() <= mStart + chrono::seconds(3));
+    vector<unique_ptr<TimerEvent>> expired;
+    while (expired.empty()) {
+        farWheel.Advance(farWheel.NextExpireTime().value(), expired);
+    }
+    APSARA_TEST_EQUAL(mStart + chrono::seconds(3), expired[0]->GetExecTime());
+}
+
+void TimerWheelUnittest::TestClear() {
+    TimerWheel wheel(mStart, chrono::milliseconds(1));
+    wheel.Add(make_unique<TimerWheelEventMock>(mStart + chrono::milliseconds(10)));
+    wheel.Add(make_unique<TimerWheelEventMock>(mStart + chrono::hours(10)));
+    wheel.Clear();
+    APSARA_TEST_TRUE(wheel.Empty());
+    APSARA_TEST_FALSE(wheel.NextExpireTime().has_value());
+    vector<unique_ptr<TimerEvent>> expired;
+    wheel.Advance(mStart + chrono::hours(11), expired);
+    APSARA_TEST_TRUE(expired.empty());
+}
+
+UNIT_TEST_CASE(TimerWheelUnittest, TestAdvance)
+UNIT_TEST_CASE(TimerWheelUnittest, TestBatchExpire)
+UNIT_TEST_CASE(TimerWheelUnittest, TestCascade)
+UNIT_TEST_CASE(TimerWheelUnittest, TestOverflow)
+UNIT_TEST_CASE(TimerWheelUnittest, TestEventAlreadyDue)
+UNIT_TEST_CASE(TimerWheelUnittest, TestNextExpireTime)
+UNIT_TEST_CASE(TimerWheelUnittest, TestClear)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -0,0 +1,158 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "common/compression/LZ4Compressor.h"
+#include "common/compression/ZstdCompressor.h"
+#include "protobuf/sls/LogGroupSerializer.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+// Compares serializing a log group as a whole and compressing it afterwards, as the sls flusher did, with compressing
+// the serialized data chunk by chunk while serializing. Compression ratio and throughput of raw data are reported.
+class CompressionBenchmark : public ::testing::Test {
+public:
+    void TestLZ4();
+    void TestZstd();
+    void TestZstdStream();
+
+protected:
+    static void SetUpTestCase() {
+        const vector<string> methods = {"GET", "POST", "PUT", "DELETE"};
+        const vector<string> statuses = {"200", "200", "200", "304", "404", "500"};
+        for (size_t i = 0; i < kLogCnt; ++i) {
+            vector<pair<string, string>> contents;
+            contents.emplace_back("remote_addr", "10.0." + to_string(i % 256) + "." + to_string(i * 7 % 256));
+            contents.emplace_back("method", methods[i % methods.size()]);
+            contents.emplace_back("url",
+                                  "/api/v1/users/" + to_string(i * 31 % 10000) + "/orders?page=" + to_string(i % 50));
+            contents.emplace_back("status", statuses[i % statuses.size()]);
+            contents.emplace_back("body_bytes_sent", to_string(i * 131 % 100000));
+            contents.emplace_back("request_time", "0.0" + to_string(i % 1000));
+            contents.emplace_back("user_agent",
+                                  "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/"
+                                      + to_string(100 + i % 20) + ".0.0.0 Safari/537.36");
+            sLogs.emplace_back(std::move(contents));
+        }
+    }
+
+    // the serializer keeps its buffer between groups, as the thread_local one in the sls serializer does
+    static void Serialize(LogGroupSerializer& serializer) {
+        size_t logGroupSZ = 0;
+        vector<size_t> logSZ(sLogs.size());
+        for (size_t i = 0; i < sLogs.size(); ++i) {
+            size_t contentSZ = 0;
+            for (const auto& kv : sLogs[i]) {
+                contentSZ += GetLogContentSize(kv.first.size(), kv.second.size());
+            }
+            logGroupSZ += GetLogSize(contentSZ, false, logSZ[i]);
+        }
+        logGroupSZ += GetStringSize(kTopic.size());
+        serializer.Prepare(logGroupSZ);
+        for (size_t i = 0; i < sLogs.size(); ++i) {
+            serializer.StartToAddLog(logSZ[i]);
+            serializer.AddLogTime(1700000000 + i);
+            for (const auto& kv : sLogs[i]) {
+                serializer.AddLogContent(kv.first, kv.second);
+            }
+        }
+        serializer.AddTopic(kTopic);
+    }
+
+    static size_t GetSerializedSize() {
+        LogGroupSerializer serializer;
+        Serialize(serializer);
+        return serializer.GetResult().size();
+    }
+
+    static void RunOneShot(Compressor& compressor, const string& name) {
+        LogGroupSerializer serializer;
+        string output, errorMsg;
+        size_t rawSize = 0, compressedSize = 0;
+        auto start = chrono::steady_clock::now();
+        for (size_t round = 0; round < kRoundCnt; ++round) {
+            Serialize(serializer);
+            // the serialized data used to be moved out of the serializer
+            string serializedData = std::move(serializer.GetResult());
+            APSARA_TEST_TRUE(compressor.DoCompress(serializedData, output, errorMsg));
+            rawSize += serializedData.size();
+            compressedSize += output.size();
+        }
+        Report(name, rawSize, compressedSize, chrono::steady_clock::now() - start);
+    }
+
+    static void Report(const string& name, size_t rawSize, size_t compressedSize, chrono::nanoseconds cost) {
+        auto ms = chrono::duration_cast<chrono::milliseconds>(cost).count();
+        cout << "[" << name << "] raw: " << rawSize / kRoundCnt << " bytes\tratio: "
+             << static_cast<double>(rawSize) / compressedSize << "\tthroughput: "
+             << rawSize / 1024.0 / 1024.0 / (static_cast<double>(cost.count()) / 1e9) << " MB/s\tcost: " << ms << "ms"
+             << endl;
+    }
+
+    static constexpr size_t kLogCnt = 4096;
+    static constexpr size_t kRoundCnt = 200;
+    static constexpr size_t kChunkSize = 128 * 1024;
+    static const string kTopic;
+
+    static vector<vector<pair<string, string>>> sLogs;
+};
+
+const string CompressionBenchmark::kTopic = "benchmark";
+vector<vector<pair<string, string>>> CompressionBenchmark::sLogs;
+
+void CompressionBenchmark::TestLZ4() {
+    LZ4Compressor compressor(CompressType::LZ4);
+    RunOneShot(compressor, "lz4");
+}
+
+void CompressionBenchmark::TestZstd() {
+    ZstdCompressor compressor(CompressType::ZSTD);
+    RunOneShot(compressor, "zstd");
+}
+
+void CompressionBenchmark::TestZstdStream() {
+    ZstdCompressor compressor(CompressType::ZSTD);
+    LogGroupSerializer serializer;
+    string output, errorMsg;
+    serializer.SetChunkSink(
+        [&compressor, &errorMsg](StringView chunk) { return compressor.AppendToStream(chunk, errorMsg); },
+        kChunkSize);
+    size_t serializedSize = GetSerializedSize();
+    size_t rawSize = 0, compressedSize = 0;
+    auto start = chrono::steady_clock::now();
+    for (size_t round = 0; round < kRoundCnt; ++round) {
+        APSARA_TEST_TRUE(compressor.BeginStream(serializedSize, errorMsg));
+        Serialize(serializer);
+        APSARA_TEST_TRUE(serializer.Flush());
+        APSARA_TEST_TRUE(compressor.EndStream(output, errorMsg));
+        rawSize += serializedSize;
+        compressedSize += output.size();
+    }
+    Report("zstd stream", rawSize, compressedSize, chrono::steady_clock::now() - start);
+}
+
+UNIT_TEST_CASE(CompressionBenchmark, TestLZ4);
+UNIT_TEST_CASE(CompressionBenchmark, TestZstd);
+UNIT_TEST_CASE(CompressionBenchmark, TestZstdStream);
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -12,6 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <random>
+
+#include "zstd/zstd.h"
+
 #include "common/compression/ZstdCompressor.h"
 #include "unittest/Unittest.h"
 
@@ -22,6 +26,7 @@ namespace logtail {
 class ZstdCompressorUnittest : public ::testing::Test {
 public:
     void TestCompress();
+    void TestCompressStream();
 };
 
 void ZstdCompressorUnittest::TestCompress() {
@@ -36,7 +41,72 @@ void ZstdCompressorUnittest::TestCompress() {
     APSARA_TEST_EQUAL(input, decompressed);
 }
 
+void ZstdCompressorUnittest::TestCompressStream() {
+    ZstdCompressor compressor(CompressType::ZSTD);
+    APSARA_TEST_TRUE(compressor.IsStreamingSupported());
+    string input;
+    for (int i = 0; i < 100000; ++i) {
+        input += "hello world " + to_string(i) + "\n";
+    }
+    string errorMsg;
+    {
+        string output;
+        APSARA_TEST_TRUE(compressor.BeginStream(input.size(), errorMsg));
+        for (size_t pos = 0; pos < input.size(); pos += 10000) {
+            APSARA_TEST_TRUE(compressor.AppendToStream(StringView(input).substr(pos, 10000), errorMsg));
+        }
+        APSARA_TEST_TRUE(compressor.EndStream(output, errorMsg));
+        // content size is recorded, as in the output of DoCompress
+        APSARA_TEST_EQUAL(input.size(), ZSTD_getFrameContentSize(output.data(), output.size()));
+        string decompressed;
+        decompressed.resize(input.size());
+        APSARA_TEST_TRUE(compressor.UnCompress(output, decompressed, errorMsg));
+        APSARA_TEST_EQUAL(input, decompressed);
+        APSARA_TEST_TRUE(output.size() < input.size() / 4);
+        APSARA_TEST_EQUAL(output.size(), output.capacity());
+    }
+    {
+        // a stream abandoned before is dropped by the next one
+        APSARA_TEST_TRUE(compressor.BeginStream(input.size(), errorMsg));
+        APSARA_TEST_TRUE(compressor.AppendToStream(StringView(input).substr(0, 100), errorMsg));
+        string output;
+        APSARA_TEST_TRUE(compressor.BeginStream(5, errorMsg));
+        APSARA_TEST_TRUE(compressor.AppendToStream("hello", errorMsg));
+        APSARA_TEST_TRUE(compressor.EndStream(output, errorMsg));
+        string decompressed;
+        decompressed.resize(5);
+        APSARA_TEST_TRUE(compressor.UnCompress(output, decompressed, errorMsg));
+        APSARA_TEST_EQUAL("hello", decompressed);
+    }
+    {
+        // incompressible data, for which the output buffer grows several times
+        mt19937 rng(0);
+        string random(1024 * 1024, '\0');
+        for (auto& c : random) {
+            c = static_cast<char>(rng());
+        }
+        string output;
+        APSARA_TEST_TRUE(compressor.BeginStream(random.size(), errorMsg));
+        for (size_t pos = 0; pos < random.size(); pos += 100000) {
+            APSARA_TEST_TRUE(compressor.AppendToStream(StringView(random).substr(pos, 100000), errorMsg));
+        }
+        APSARA_TEST_TRUE(compressor.EndStream(output, errorMsg));
+        string decompressed;
+        decompressed.resize(random.size());
+        APSARA_TEST_TRUE(compressor.UnCompress(output, decompressed, errorMsg));
+        APSARA_TEST_EQUAL(random, decompressed);
+    }
+    {
+        // input size mismatch
+        string output;
+        APSARA_TEST_TRUE(compressor.BeginStream(10, errorMsg));
+        APSARA_TEST_TRUE(compressor.AppendToStream("hello", errorMsg));
+        APSARA_TEST_FALSE(compressor.EndStream(output, errorMsg));
+    }
+}
+
 UNIT_TEST_CASE(ZstdCompressorUnittest, TestCompress)
+UNIT_TEST_CASE(ZstdCompressorUnittest, TestCompressStream)
 
 } // namespace logtail
 
@@ -0,0 +1,159 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <boost/regex.hpp>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "container_manager/ContainerManager.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+// Compares checking all containers for every config, as done on each container event before, with checking only the
+// containers changed since the last check, on a node with many configs and containers.
+class ContainerManagerBenchmark : public ::testing::Test {
+public:
+    void TestCheckAllContainers();
+    void TestCheckChangedContainers();
+
+protected:
+    struct Config {
+        ContainerFilters mFilters;
+        set<string> mFullList;
+        unordered_map<string, shared_ptr<RawContainerInfo>> mMatchList;
+        uint64_t mVersion = 0;
+    };
+
+    void SetUp() override {
+        for (size_t i = 0; i < kContainerCnt; ++i) {
+            mContainerManager.mContainerMap["c" + to_string(i)] = MakeContainer(i, 0);
+        }
+        mContainerManager.resetContainerChanges();
+        for (size_t i = 0; i < kConfigCnt; ++i) {
+            Config config;
+            config.mFilters.mK8SFilter.mK8sLabelFilter.mIncludeFields.mFieldsRegMap["app"]
+                = make_shared<boost::regex>("^app-" + to_string(i % kAppCnt) + "$");
+            config.mFilters.mEnvFilter.mExcludeFields.mFieldsRegMap["SKIP_LOG"] = make_shared<boost::regex>("^true$");
+            ContainerDiff diff;
+            mContainerManager.computeMatchedContainersDiff(
+                config.mFullList, config.mMatchList, config.mFilters, false, diff);
+            Apply(config, diff);
+            config.mVersion = mContainerManager.mContainerVersion;
+            mConfigs.push_back(std::move(config));
+        }
+    }
+
+    static shared_ptr<RawContainerInfo> MakeContainer(size_t idx, size_t generation) {
+        auto info = make_shared<RawContainerInfo>();
+        info->mID = "c" + to_string(idx);
+        info->mStatus = "running";
+        info->mLogPath = "/var/lib/docker/containers/" + info->mID + "/" + to_string(generation) + ".log";
+        info->mK8sInfo.mNamespace = "default";
+        info->mK8sInfo.mPod = "pod-" + to_string(idx);
+        info->mK8sInfo.mContainerName = "main";
+        info->mK8sInfo.mLabels["app"] = "app-" + to_string(idx % kAppCnt);
+        info->mEnv["HOSTNAME"] = info->mK8sInfo.mPod;
+        return info;
+    }
+
+    static void Apply(Config& config, const ContainerDiff& diff) {
+        for (const auto& info : diff.mAdded) {
+            config.mMatchList[info->mID] = info;
+        }
+        for (const auto& info : diff.mModified) {
+            config.mMatchList[info->mID] = info;
+        }
+        for (const auto& id : diff.mRemoved) {
+            config.mMatchList.erase(id);
+        }
+    }
+
+    // a few containers are recreated per round, as a rolling update does
+    void ChangeContainers(size_t round) {
+        for (size_t i = 0; i < kChangedCntPerRound; ++i) {
+            size_t idx = (round * kChangedCntPerRound + i) % kContainerCnt;
+            mContainerManager.mContainerMap["c" + to_string(idx)] = MakeContainer(idx, round + 1);
+            mContainerManager.recordContainerChange("c" + to_string(idx));
+        }
+    }
+
+    static constexpr size_t kConfigCnt = 300;
+    static constexpr size_t kContainerCnt = 200;
+    static constexpr size_t kAppCnt = 50;
+    static constexpr size_t kChangedCntPerRound = 2;
+    static constexpr size_t kRoundCnt = 100;
+
+    ContainerManager mContainerManager;
+    vector<Config> mConfigs;
+};
+
+void ContainerManagerBenchmark::TestCheckAllContainers() {
+    size_t modifiedCnt = 0;
+    auto start = chrono::steady_clock::now();
+    for (size_t round = 0; round < kRoundCnt; ++round) {
+        ChangeContainers(round);
+        for (auto& config : mConfigs) {
+            ContainerDiff diff;
+            mContainerManager.computeMatchedContainersDiff(
+                config.mFullList, config.mMatchList, config.mFilters, false, diff);
+            modifiedCnt += diff.mModified.size();
+            Apply(config, diff);
+        }
+    }
+    auto cost = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+    APSARA_TEST_EQUAL(kRoundCnt * kChangedCntPerRound * kConfigCnt / kAppCnt, modifiedCnt);
+    cout << "[check all containers] configs: " << kConfigCnt << "\tcontainers: " << kContainerCnt
+         << "\trounds: " << kRoundCnt << "\tcost: " << cost << "ms" << endl;
+}
+
+void ContainerManagerBenchmark::TestCheckChangedContainers() {
+    size_t modifiedCnt = 0;
+    auto start = chrono::steady_clock::now();
+    for (size_t round = 0; round < kRoundCnt; ++round) {
+        ChangeContainers(round);
+        for (auto& config : mConfigs) {
+            set<string> changedContainerIDs;
+            for (const auto& change : mContainerManager.mContainerChanges) {
+                if (change.first > config.mVersion) {
+                    changedContainerIDs.insert(change.second);
+                }
+            }
+            ContainerDiff diff;
+            mContainerManager.computeChangedContainersDiff(
+                config.mFullList, config.mMatchList, config.mFilters, false, changedContainerIDs, diff);
+            config.mVersion = mContainerManager.mContainerVersion;
+            modifiedCnt += diff.mModified.size();
+            Apply(config, diff);
+        }
+    }
+    auto cost = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+    APSARA_TEST_EQUAL(kRoundCnt * kChangedCntPerRound * kConfigCnt / kAppCnt, modifiedCnt);
+    cout << "[check changed containers] configs: " << kConfigCnt << "\tcontainers: " << kContainerCnt
+         << "\trounds: " << kRoundCnt << "\tcost: " << cost << "ms" << endl;
+}
+
+UNIT_TEST_CASE(ContainerManagerBenchmark, TestCheckAllContainers)
+UNIT_TEST_CASE(ContainerManagerBenchmark, TestCheckChangedContainers)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
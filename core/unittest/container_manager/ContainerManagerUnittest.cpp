@@ -40,6 +40,7 @@ namespace logtail {
 class ContainerManagerUnittest : public testing::Test {
 public:
     void TestcomputeMatchedContainersDiff() const;
+    void TestcomputeChangedContainersDiff() const;
     void TestrefreshAllContainersSnapshot() const;
     void TestincrementallyUpdateContainersSnapshot() const;
     void TestSaveLoadContainerInfo() const;
@@ -404,6 +405,111 @@ void ContainerManagerUnittest::TestcomputeMatchedContainersDiff() const {
     }
 }
 
+void ContainerManagerUnittest::TestcomputeChangedContainersDiff() const {
+    auto makeContainer = [](const std::string& id, const std::string& app, const std::string& status) {
+        auto info = std::make_shared<RawContainerInfo>();
+        info->mID = id;
+        info->mLogPath = "/var/lib/docker/containers/" + id + "/logs";
+        info->mStatus = status;
+        if (!app.empty()) {
+            info->mK8sInfo.mLabels["app"] = app;
+        }
+        return info;
+    };
+    auto sortedIDs = [](const std::vector<std::shared_ptr<RawContainerInfo>>& infos) {
+        std::vector<std::string> ids;
+        for (const auto& info : infos) {
+            ids.push_back(info->mID);
+        }
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    };
+
+    ContainerManager containerManager;
+    ContainerFilters filters;
+    filters.mK8SFilter.mK8sLabelFilter.mIncludeFields.mFieldsRegMap["app"] = std::make_shared<boost::regex>("^web.*$");
+    for (bool isStdio : {false, true}) {
+        containerManager.mContainerMap.clear();
+        containerManager.resetContainerChanges();
+        containerManager.mContainerMap["c1"] = makeContainer("c1", "web", "running");
+        containerManager.mContainerMap["c2"] = makeContainer("c2", "db", "running");
+        containerManager.mContainerMap["c3"] = makeContainer("c3", "web-api", "exited");
+        containerManager.mContainerMap["c4"] = makeContainer("c4", "", "running");
+        containerManager.mContainerMap["c5"] = makeContainer("c5", "web", "running");
+
+        // initial full check of a config
+        std::set<std::string> fullList;
+        std::unordered_map<std::string, std::shared_ptr<RawContainerInfo>> matchList;
+        ContainerDiff diff;
+        containerManager.computeMatchedContainersDiff(fullList, matchList, filters, isStdio, diff);
+        for (const auto& info : diff.mAdded) {
+            matchList[info->mID] = info;
+        }
+        uint64_t configVersion = containerManager.mContainerVersion;
+
+        // containers added, modified, started and deleted since then
+        auto update = [&](const std::shared_ptr<RawContainerInfo>& info) {
+            containerManager.mContainerMap[info->mID] = info;
+            containerManager.recordContainerChange(info->mID);
+        };
+        update(makeContainer("c3", "web-api", "running"));
+        update(makeContainer("c6", "web-admin", "running"));
+        update(makeContainer("c7", "cache", "running"));
+        update(makeContainer("c8", "web", "created"));
+        auto c5 = makeContainer("c5", "web", "running");
+        c5->mLogPath = "/var/lib/docker/containers/c5/new-logs";
+        update(c5);
+        containerManager.mContainerMap.erase("c1");
+        containerManager.recordContainerChange("c1");
+        containerManager.mContainerMap.erase("c2");
+        containerManager.recordContainerChange("c2");
+
+        std::set<std::string> changedContainerIDs;
+        for (const auto& change : containerManager.mContainerChanges) {
+            if (change.first > configVersion) {
+                changedContainerIDs.insert(change.second);
+            }
+        }
+        APSARA_TEST_EQUAL(7U, changedContainerIDs.size());
+
+        std::set<std::string> fullList1 = fullList;
+        std::set<std::string> fullList2 = fullList;
+        ContainerDiff diff1;
+        ContainerDiff diff2;
+        containerManager.computeMatchedContainersDiff(fullList1, matchList, filters, isStdio, diff1);
+        containerManager.computeChangedContainersDiff(
+            fullList2, matchList, filters, isStdio, changedContainerIDs, diff2);
+        APSARA_TEST_EQUAL(fullList1, fullList2);
+        APSARA_TEST_EQUAL(sortedIDs(diff1.mAdded), sortedIDs(diff2.mAdded));
+        APSARA_TEST_EQUAL(sortedIDs(diff1.mModified), sortedIDs(diff2.mModified));
+        std::sort(diff1.mRemoved.begin(), diff1.mRemoved.end());
+        std::sort(diff2.mRemoved.begin(), diff2.mRemoved.end());
+        APSARA_TEST_EQUAL(diff1.mRemoved, diff2.mRemoved);
+        APSARA_TEST_EQUAL(std::vector<std::string>({"c1"}), diff2.mRemoved);
+        if (isStdio) {
+            // stopped containers are collected as well for stdio
+            APSARA_TEST_EQUAL(std::vector<std::string>({"c3", "c5"}), sortedIDs(diff2.mModified));
+            APSARA_TEST_EQUAL(std::vector<std::string>({"c6", "c8"}), sortedIDs(diff2.mAdded));
+        } else {
+            APSARA_TEST_EQUAL(std::vector<std::string>({"c5"}), sortedIDs(diff2.mModified));
+            APSARA_TEST_EQUAL(std::vector<std::string>({"c3", "c6"}), sortedIDs(diff2.mAdded));
+        }
+    }
+    {
+        // changes are dropped when too many, and configs checked before that have to check all containers
+        containerManager.resetContainerChanges();
+        uint64_t configVersion = containerManager.mContainerVersion;
+        APSARA_TEST_EQUAL(configVersion, containerManager.mContainerChangeBaseVersion);
+        for (size_t i = 0; i < ContainerManager::kMaxContainerChangeCnt + 1; ++i) {
+            containerManager.recordContainerChange("c" + std::to_string(i));
+        }
+        APSARA_TEST_EQUAL(ContainerManager::kMaxContainerChangeCnt, containerManager.mContainerChanges.size());
+        APSARA_TEST_TRUE(configVersion < containerManager.mContainerChangeBaseVersion);
+        APSARA_TEST_EQUAL(configVersion + ContainerManager::kMaxContainerChangeCnt + 1,
+                          containerManager.mContainerVersion);
+    }
+}
+
 void ContainerManagerUnittest::TestrefreshAllContainersSnapshot() const {
     {
         // test empty containers meta
@@ -1340,6 +1446,7 @@ void ContainerManagerUnittest::parseLabelFilters(const Json::Value& filtersJson,
 }
 
 UNIT_TEST_CASE(ContainerManagerUnittest, TestcomputeMatchedContainersDiff)
+UNIT_TEST_CASE(ContainerManagerUnittest, TestcomputeChangedContainersDiff)
 UNIT_TEST_CASE(ContainerManagerUnittest, TestrefreshAllContainersSnapshot)
 UNIT_TEST_CASE(ContainerManagerUnittest, TestincrementallyUpdateContainersSnapshot)
 UNIT_TEST_CASE(ContainerManagerUnittest, TestSaveLoadContainerInfo)
@@ -0,0 +1,177 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ebpf/type/NetworkObserverEvent.h"
+#include "ebpf/util/AggregateTree.h"
+#include "ebpf/util/ShardedAggregateTree.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+namespace ebpf {
+
+struct BenchmarkAppMetric {
+    explicit BenchmarkAppMetric(StringView spanName) : mSpanName(spanName) {}
+
+    StringView mSpanName;
+    uint64_t mCount = 0;
+    uint64_t mErrCount = 0;
+    uint64_t mSlowCount = 0;
+    uint64_t m2xxCount = 0;
+    uint64_t m4xxCount = 0;
+    uint64_t m5xxCount = 0;
+    double mSum = 0;
+};
+
+using BenchmarkTree = SIZETAggTreeWithSourceBuffer<BenchmarkAppMetric, HttpRecord*>;
+using BenchmarkShardedTree = SIZETShardedAggTreeWithSourceBuffer<BenchmarkAppMetric, HttpRecord*>;
+
+// Feeds synthetic http records, as the network observer does with records parsed from kernel events, into AggTree
+// and ShardedAggTree, and reports at the end of each round.
+class AggregatorBenchmark : public testing::Test {
+public:
+    void TestAggTree();
+    void TestShardedAggTree();
+
+protected:
+    static void SetUpTestCase() {
+        mt19937_64 rng(0);
+        for (size_t i = 0; i < kRecordCnt; ++i) {
+            auto record = make_unique<HttpRecord>(nullptr, nullptr);
+            record->SetPath("/api/v1/service-" + to_string(rng() % kPathCnt));
+            record->SetMethod("GET");
+            auto r = rng() % 100;
+            record->SetStatusCode(r < 90 ? 200 : (r < 97 ? 404 : 503));
+            record->SetStartTsNs(0);
+            record->SetEndTsNs(rng() % 1000000000);
+            auto app = rng() % kAppCnt;
+            size_t pathHash = hash<string>{}(record->GetPath());
+            sKeys.push_back({hash<size_t>{}(app), pathHash ^ (hash<int>{}(record->GetStatusCode() / 100) << 1)});
+            sRecords.emplace_back(std::move(record));
+        }
+    }
+
+    static void TearDownTestCase() {
+        sRecords.clear();
+        sKeys.clear();
+    }
+
+    static void AggregateFunc(unique_ptr<BenchmarkAppMetric>& base, HttpRecord* const& other) {
+        int statusCode = other->GetStatusCode();
+        if (statusCode >= 500) {
+            base->m5xxCount += 1;
+        } else if (statusCode >= 400) {
+            base->m4xxCount += 1;
+        } else {
+            base->m2xxCount += 1;
+        }
+        base->mCount++;
+        base->mErrCount += other->IsError();
+        base->mSlowCount += other->IsSlow();
+        base->mSum += other->GetLatencySeconds();
+    }
+
+    static unique_ptr<BenchmarkAppMetric> BuildFunc(HttpRecord* const& in, shared_ptr<SourceBuffer>& sourceBuffer) {
+        auto spanName = sourceBuffer->CopyString(in->GetConvSpanName());
+        return make_unique<BenchmarkAppMetric>(StringView(spanName.data, spanName.size));
+    }
+
+    static uint64_t Report(BenchmarkTree& tree) {
+        uint64_t cnt = 0;
+        for (auto& node : tree.GetNodesWithAggDepth(1)) {
+            tree.ForEach(node, [&](const BenchmarkAppMetric* data) { cnt += data->mCount; });
+        }
+        return cnt;
+    }
+
+    static constexpr size_t kRecordCnt = 1000000;
+    static constexpr size_t kAppCnt = 64;
+    static constexpr size_t kPathCnt = 256;
+    static constexpr size_t kRoundCnt = 5;
+
+    static vector<unique_ptr<HttpRecord>> sRecords;
+    static vector<array<size_t, 2>> sKeys;
+};
+
+vector<unique_ptr<HttpRecord>> AggregatorBenchmark::sRecords;
+vector<array<size_t, 2>> AggregatorBenchmark::sKeys;
+
+void AggregatorBenchmark::TestAggTree() {
+    BenchmarkTree tree(1000000, AggregateFunc, BuildFunc);
+    chrono::nanoseconds aggregateTime(0);
+    chrono::nanoseconds reportTime(0);
+    for (size_t round = 0; round < kRoundCnt; ++round) {
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < kRecordCnt; ++i) {
+            tree.Aggregate(sRecords[i].get(), sKeys[i]);
+        }
+        auto mid = chrono::steady_clock::now();
+        auto res = tree.GetAndReset();
+        APSARA_TEST_EQUAL(kRecordCnt, Report(res));
+        auto end = chrono::steady_clock::now();
+        aggregateTime += mid - start;
+        reportTime += end - mid;
+    }
+    cout << "[AggTree] records: " << kRecordCnt * kRoundCnt
+         << "\taggregate: " << chrono::duration_cast<chrono::milliseconds>(aggregateTime).count()
+         << "ms\treport: " << chrono::duration_cast<chrono::milliseconds>(reportTime).count() << "ms" << endl;
+}
+
+void AggregatorBenchmark::TestShardedAggTree() {
+    for (size_t threadCnt : {1, 2, 4, 8}) {
+        BenchmarkShardedTree tree(threadCnt * 4, 1000000, AggregateFunc, BuildFunc);
+        chrono::nanoseconds aggregateTime(0);
+        chrono::nanoseconds reportTime(0);
+        for (size_t round = 0; round < kRoundCnt; ++round) {
+            auto start = chrono::steady_clock::now();
+            vector<thread> threads;
+            for (size_t t = 0; t < threadCnt; ++t) {
+                threads.emplace_back([&tree, t, threadCnt]() {
+                    for (size_t i = t; i < kRecordCnt; i += threadCnt) {
+                        tree.Aggregate(sRecords[i].get(), sKeys[i]);
+                    }
+                });
+            }
+            for (auto& t : threads) {
+                t.join();
+            }
+            auto mid = chrono::steady_clock::now();
+            auto res = tree.GetAndReset();
+            APSARA_TEST_EQUAL(kRecordCnt, Report(res));
+            auto end = chrono::steady_clock::now();
+            aggregateTime += mid - start;
+            reportTime += end - mid;
+        }
+        cout << "[ShardedAggTree] threads: " << threadCnt << "\trecords: " << kRecordCnt * kRoundCnt
+             << "\taggregate: " << chrono::duration_cast<chrono::milliseconds>(aggregateTime).count()
+             << "ms\treport: " << chrono::duration_cast<chrono::milliseconds>(reportTime).count() << "ms" << endl;
+    }
+}
+
+UNIT_TEST_CASE(AggregatorBenchmark, TestAggTree)
+UNIT_TEST_CASE(AggregatorBenchmark, TestShardedAggTree)
+
+} // namespace ebpf
+} // namespace logtail
+
+UNIT_TEST_MAIN
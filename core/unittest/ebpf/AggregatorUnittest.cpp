@@ -19,11 +19,13 @@
 #include <chrono>
 #include <iostream>
 #include <random>
+#include <thread>
 
 #include "common/timer/Timer.h"
 #include "ebpf/type/FileEvent.h"
 #include "ebpf/type/NetworkEvent.h"
 #include "ebpf/util/AggregateTree.h"
+#include "ebpf/util/ShardedAggregateTree.h"
 #include "logger/Logger.h"
 #include "models/PipelineEventGroup.h"
 #include "unittest/Unittest.h"
@@ -52,6 +54,9 @@ public:
     void TestGetAndReset();
     void TestAggManager();
     void TestAggregator();
+    void TestShardedAggregator();
+    void TestShardedConcurrentAgg();
+    void TestShardedMaxNodes();
 
 protected:
     void SetUp() override {
@@ -246,9 +251,143 @@ void AggregatorUnittest::TestGetAndReset() {
     APSARA_TEST_EQUAL(GetSum(newTree), 5);
 }
 
+void AggregatorUnittest::TestShardedAggregator() {
+    SIZETShardedAggTree<FileEventGroup, std::shared_ptr<FileEvent>> shardedTree(
+        4,
+        4096,
+        [](std::unique_ptr<FileEventGroup>& base, const std::shared_ptr<FileEvent>& other) {
+            base->mInnerEvents.emplace_back(other);
+        },
+        [](const std::shared_ptr<FileEvent>& in, std::shared_ptr<SourceBuffer>& sourceBuffer) {
+            return std::make_unique<FileEventGroup>(in->mPid, in->mKtime);
+        });
+
+    std::vector<std::shared_ptr<FileEvent>> events;
+    events.push_back(std::make_shared<FileEvent>(100, 100, KernelEventType::FILE_MMAP, 0, "path-0"));
+    events.push_back(std::make_shared<FileEvent>(100, 100, KernelEventType::FILE_PATH_TRUNCATE, 1, "path-0"));
+    events.push_back(std::make_shared<FileEvent>(100, 100, KernelEventType::FILE_PATH_TRUNCATE, 2, "path-1"));
+    events.push_back(std::make_shared<FileEvent>(1, 101, KernelEventType::FILE_MMAP, 3, "path-0"));
+    events.push_back(std::make_shared<FileEvent>(1, 101, KernelEventType::FILE_PATH_TRUNCATE, 4, "path-1"));
+    events.push_back(std::make_shared<FileEvent>(1, 101, KernelEventType::FILE_MMAP, 5, "path-2"));
+    events.push_back(std::make_shared<FileEvent>(1, 101, KernelEventType::FILE_MMAP, 6, "path-2"));
+    for (auto& evt : events) {
+        APSARA_TEST_TRUE(shardedTree.Aggregate(evt, GenerateAggKey(evt)));
+    }
+    // all nodes of the tree to be built are counted
+    APSARA_TEST_EQUAL(7UL, shardedTree.NodeCount());
+    APSARA_TEST_EQUAL(7UL, shardedTree.EventCount());
+
+    auto tree = shardedTree.GetAndReset();
+    APSARA_TEST_EQUAL(0UL, shardedTree.NodeCount());
+    APSARA_TEST_EQUAL(0UL, shardedTree.EventCount());
+    APSARA_TEST_EQUAL(7UL, tree.NodeCount());
+    APSARA_TEST_EQUAL(7UL, tree.EventCount());
+
+    auto nodes = tree.GetNodesWithAggDepth(1);
+    APSARA_TEST_EQUAL(2UL, nodes.size());
+    size_t groupCnt = 0;
+    size_t eventCnt = 0;
+    for (auto& node : nodes) {
+        auto pid = node->mChild.begin()->second->mData->mPid;
+        tree.ForEach(node, [&](const FileEventGroup* group) {
+            APSARA_TEST_EQUAL(group->mPid, pid);
+            ++groupCnt;
+            for (const auto& innerEvent : group->mInnerEvents) {
+                auto* fe = static_cast<FileEvent*>(innerEvent.get());
+                APSARA_TEST_EQUAL(fe->mPid, pid);
+                APSARA_TEST_EQUAL(fe->mPath, static_cast<FileEvent*>(group->mInnerEvents[0].get())->mPath);
+                ++eventCnt;
+            }
+        });
+    }
+    APSARA_TEST_EQUAL(5UL, groupCnt);
+    APSARA_TEST_EQUAL(7UL, eventCnt);
+
+    // shards can be reused after report
+    APSARA_TEST_TRUE(shardedTree.Aggregate(events[0], GenerateAggKey(events[0])));
+    APSARA_TEST_EQUAL(2UL, shardedTree.NodeCount());
+    shardedTree.Reset();
+    APSARA_TEST_EQUAL(0UL, shardedTree.NodeCount());
+    APSARA_TEST_EQUAL(0UL, shardedTree.GetAndReset().NodeCount());
+}
+
+void AggregatorUnittest::TestShardedConcurrentAgg() {
+    const size_t kThreadCnt = 4;
+    const size_t kLoop = 20000;
+    SIZETShardedAggTreeWithSourceBuffer<HT, size_t> shardedTree(
+        8,
+        4096,
+        [](std::unique_ptr<HT>& base, const size_t& other) { base->val++; },
+        [](const size_t& in, std::shared_ptr<SourceBuffer>& sourceBuffer) {
+            APSARA_TEST_TRUE(sourceBuffer != nullptr);
+            return std::make_unique<HT>(0);
+        });
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < kThreadCnt; ++i) {
+        threads.emplace_back([&shardedTree, i, kLoop]() {
+            for (size_t j = 0; j < kLoop; ++j) {
+                size_t n = i * kLoop + j;
+                shardedTree.Aggregate(n, std::array<size_t, 2>{n % 16, n % 64});
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    APSARA_TEST_EQUAL(80UL, shardedTree.NodeCount());
+    APSARA_TEST_EQUAL(kThreadCnt * kLoop, shardedTree.EventCount());
+
+    auto tree = shardedTree.GetAndReset();
+    auto nodes = tree.GetNodesWithAggDepth(1);
+    APSARA_TEST_EQUAL(16UL, nodes.size());
+    int sum = 0;
+    int dataCnt = 0;
+    for (auto& node : nodes) {
+        APSARA_TEST_TRUE(node->mSourceBuffer != nullptr);
+        APSARA_TEST_EQUAL(4UL, node->mChild.size());
+        for (auto& child : node->mChild) {
+            // data under the same level1 node share its sourcebuffer
+            APSARA_TEST_EQUAL(node->mSourceBuffer.get(), child.second->mSourceBuffer.get());
+        }
+        tree.ForEach(node, [&](const HT* ht) {
+            sum += ht->val;
+            ++dataCnt;
+        });
+    }
+    APSARA_TEST_EQUAL(static_cast<int>(kThreadCnt * kLoop), sum);
+    APSARA_TEST_EQUAL(64, dataCnt);
+    APSARA_TEST_EQUAL(80UL, tree.NodeCount());
+}
+
+void AggregatorUnittest::TestShardedMaxNodes() {
+    SIZETShardedAggTree<HT, size_t> shardedTree(
+        2,
+        3,
+        [](std::unique_ptr<HT>& base, const size_t& other) { base->val++; },
+        [](const size_t& in, std::shared_ptr<SourceBuffer>& sourceBuffer) { return std::make_unique<HT>(0); });
+    APSARA_TEST_TRUE(shardedTree.Aggregate(0, std::array<size_t, 2>{1, 1}));
+    APSARA_TEST_TRUE(shardedTree.Aggregate(0, std::array<size_t, 2>{1, 2}));
+    // both the level1 and the level2 node are needed
+    APSARA_TEST_FALSE(shardedTree.Aggregate(0, std::array<size_t, 2>{2, 1}));
+    // existing paths are still aggregated
+    APSARA_TEST_TRUE(shardedTree.Aggregate(0, std::array<size_t, 2>{1, 1}));
+    // so are new paths made of existing nodes only
+    APSARA_TEST_TRUE(shardedTree.Aggregate(0, std::array<size_t, 1>{1}));
+    APSARA_TEST_EQUAL(3UL, shardedTree.NodeCount());
+    APSARA_TEST_EQUAL(4UL, shardedTree.EventCount());
+    APSARA_TEST_EQUAL(3UL, shardedTree.GetAndReset().NodeCount());
+
+    shardedTree.GetAndReset();
+    APSARA_TEST_TRUE(shardedTree.Aggregate(0, std::array<size_t, 2>{2, 1}));
+}
+
 UNIT_TEST_CASE(AggregatorUnittest, TestBasicAgg);
 UNIT_TEST_CASE(AggregatorUnittest, TestGetAndReset);
 UNIT_TEST_CASE(AggregatorUnittest, TestAggregator);
+UNIT_TEST_CASE(AggregatorUnittest, TestShardedAggregator);
+UNIT_TEST_CASE(AggregatorUnittest, TestShardedConcurrentAgg);
+UNIT_TEST_CASE(AggregatorUnittest, TestShardedMaxNodes);
 
 
 } // namespace ebpf
@@ -0,0 +1,156 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "file_server/event_handler/FileReadWorkerPool.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class FileReadWorkerPoolUnittest : public ::testing::Test {
+public:
+    void TestRunInline();
+    void TestConcurrentReads();
+    void TestWaitOwner();
+    void TestCallbackWhileWaiting();
+
+protected:
+    void TearDown() override { mPool->Stop(); }
+
+    FileReadWorkerPool* mPool = FileReadWorkerPool::GetInstance();
+};
+
+void FileReadWorkerPoolUnittest::TestRunInline() {
+    APSARA_TEST_FALSE(mPool->IsRunning());
+    vector<int> steps;
+    mPool->Submit(
+        this, [&steps]() { steps.push_back(1); }, [&steps]() { steps.push_back(2); });
+    APSARA_TEST_EQUAL(vector<int>({1, 2}), steps);
+    APSARA_TEST_EQUAL(0U, mPool->GetPendingCnt());
+
+    // not started without threads
+    mPool->Start(0, nullptr);
+    APSARA_TEST_FALSE(mPool->IsRunning());
+}
+
+void FileReadWorkerPoolUnittest::TestConcurrentReads() {
+    const size_t threadCnt = 4;
+    mPool->Start(threadCnt, nullptr);
+    APSARA_TEST_TRUE(mPool->IsRunning());
+
+    // each read waits for all the others to start, which only succeeds if they are run concurrently
+    atomic_size_t startedCnt = 0;
+    atomic_size_t timeoutCnt = 0;
+    vector<int> owners(threadCnt);
+    vector<size_t> doneOrder;
+    vector<thread::id> doneThreads;
+    for (size_t i = 0; i < threadCnt; ++i) {
+        mPool->Submit(
+            &owners[i],
+            [&]() {
+                ++startedCnt;
+                auto deadline = chrono::steady_clock::now() + chrono::seconds(5);
+                while (startedCnt.load() < threadCnt) {
+                    if (chrono::steady_clock::now() > deadline) {
+                        ++timeoutCnt;
+                        return;
+                    }
+                    this_thread::sleep_for(chrono::milliseconds(1));
+                }
+            },
+            [&, i]() {
+                doneOrder.push_back(i);
+                doneThreads.push_back(this_thread::get_id());
+            });
+    }
+    APSARA_TEST_EQUAL(threadCnt, mPool->GetPendingCnt());
+    mPool->WaitAll();
+    APSARA_TEST_EQUAL(0U, mPool->GetPendingCnt());
+    APSARA_TEST_EQUAL(0U, timeoutCnt.load());
+    // completions are run by the waiting thread in the order of submission
+    APSARA_TEST_EQUAL(vector<size_t>({0, 1, 2, 3}), doneOrder);
+    for (const auto& id : doneThreads) {
+        APSARA_TEST_EQUAL(this_thread::get_id(), id);
+    }
+}
+
+void FileReadWorkerPoolUnittest::TestWaitOwner() {
+    mPool->Start(2, nullptr);
+    int owner1 = 0, owner2 = 0;
+    atomic_bool release = false;
+    vector<int> doneOwners;
+    mPool->Submit(
+        &owner1, []() {}, [&doneOwners]() { doneOwners.push_back(1); });
+    mPool->Submit(
+        &owner2,
+        [&release]() {
+            while (!release) {
+                this_thread::sleep_for(chrono::milliseconds(1));
+            }
+        },
+        [&doneOwners]() { doneOwners.push_back(2); });
+
+    // no read for the owner
+    mPool->Wait(this);
+    APSARA_TEST_EQUAL(2U, mPool->GetPendingCnt());
+
+    mPool->Wait(&owner1);
+    APSARA_TEST_EQUAL(vector<int>({1}), doneOwners);
+    APSARA_TEST_EQUAL(1U, mPool->GetPendingCnt());
+
+    release = true;
+    mPool->Wait(&owner2);
+    APSARA_TEST_EQUAL(vector<int>({1, 2}), doneOwners);
+    APSARA_TEST_EQUAL(0U, mPool->GetPendingCnt());
+}
+
+void FileReadWorkerPoolUnittest::TestCallbackWhileWaiting() {
+    size_t waitCnt = 0;
+    mPool->Start(1, [&waitCnt]() { ++waitCnt; });
+    bool done = false;
+    mPool->Submit(
+        this, []() { this_thread::sleep_for(chrono::milliseconds(100)); }, [&done]() { done = true; });
+    mPool->WaitAll();
+    APSARA_TEST_TRUE(done);
+    APSARA_TEST_TRUE(waitCnt > 0);
+
+    // completions submitting new reads are waited for as well
+    int owner = 0;
+    vector<int> steps;
+    mPool->Submit(
+        this,
+        []() {},
+        [&]() {
+            steps.push_back(1);
+            mPool->Submit(
+                &owner, []() {}, [&steps]() { steps.push_back(2); });
+        });
+    mPool->WaitAll();
+    APSARA_TEST_EQUAL(vector<int>({1, 2}), steps);
+}
+
+UNIT_TEST_CASE(FileReadWorkerPoolUnittest, TestRunInline)
+UNIT_TEST_CASE(FileReadWorkerPoolUnittest, TestConcurrentReads)
+UNIT_TEST_CASE(FileReadWorkerPoolUnittest, TestWaitOwner)
+UNIT_TEST_CASE(FileReadWorkerPoolUnittest, TestCallbackWhileWaiting)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
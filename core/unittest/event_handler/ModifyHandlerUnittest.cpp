@@ -34,6 +34,7 @@
 #include "file_server/FileServer.h"
 #include "file_server/event/Event.h"
 #include "file_server/event_handler/EventHandler.h"
+#include "file_server/event_handler/FileReadWorkerPool.h"
 #include "file_server/reader/LogFileReader.h"
 #include "unittest/Unittest.h"
 #include "unittest/UnittestHelper.h"
@@ -49,6 +50,7 @@ public:
     void TestHandleContainerStoppedEventWhenReadToEnd();
     void TestHandleContainerStoppedEventWhenNotReadToEnd();
     void TestHandleModifyEventWhenContainerStopped();
+    void TestHandleModifyEventWithReadWorkers();
     void TestRecoverReaderFromCheckpoint();
     void TestRecoverReaderFromCheckpointRotateLog();
     void TestRecoverReaderFromCheckpointContainer();
@@ -224,6 +226,7 @@ std::string ModifyHandlerUnittest::gLogName;
 UNIT_TEST_CASE(ModifyHandlerUnittest, TestHandleContainerStoppedEventWhenReadToEnd);
 UNIT_TEST_CASE(ModifyHandlerUnittest, TestHandleContainerStoppedEventWhenNotReadToEnd);
 UNIT_TEST_CASE(ModifyHandlerUnittest, TestHandleModifyEventWhenContainerStopped);
+UNIT_TEST_CASE(ModifyHandlerUnittest, TestHandleModifyEventWithReadWorkers);
 UNIT_TEST_CASE(ModifyHandlerUnittest, TestRecoverReaderFromCheckpoint);
 #ifndef _MSC_VER // Unnecessary on platforms without symbolic.
 UNIT_TEST_CASE(ModifyHandlerUnittest, TestRecoverReaderFromCheckpointRotateLog);
@@ -286,6 +289,26 @@ void ModifyHandlerUnittest::TestHandleModifyEventWhenContainerStopped() {
     APSARA_TEST_TRUE_FATAL(!mReaderPtr->mLogFileOp.IsOpen());
 }
 
+void ModifyHandlerUnittest::TestHandleModifyEventWithReadWorkers() {
+    LOG_INFO(sLogger, ("TestHandleModifyEventWithReadWorkers() begin", time(NULL)));
+    auto* pool = FileReadWorkerPool::GetInstance();
+    pool->Start(2, nullptr);
+    APSARA_TEST_TRUE_FATAL(mReaderPtr->mLogFileOp.IsOpen());
+
+    mReaderPtr->SetContainerStopped();
+    Event event(gRootDir, gLogName, EVENT_MODIFY, 0, 0, mReaderPtr->mDevInode.dev, mReaderPtr->mDevInode.inode);
+    event.SetContainerID("1");
+    mHandlerPtr->Handle(event);
+    // the file is read by the worker, and is only closed on completion
+    APSARA_TEST_EQUAL_FATAL(1U, pool->GetPendingCnt());
+    APSARA_TEST_TRUE_FATAL(mReaderPtr->mLogFileOp.IsOpen());
+
+    pool->WaitAll();
+    APSARA_TEST_TRUE_FATAL(mReaderPtr->IsReadToEnd());
+    APSARA_TEST_TRUE_FATAL(!mReaderPtr->mLogFileOp.IsOpen());
+    pool->Stop();
+}
+
 void ModifyHandlerUnittest::TestRecoverReaderFromCheckpoint() {
     LOG_INFO(sLogger, ("TestRecoverReaderFromCheckpoint() begin", time(NULL)));
     std::string basicLogName = "rotate.log";
@@ -0,0 +1,168 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "plugin/flusher/sls/DiskBufferSegment.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+// Compares the buffer files, which are opened for each record written or read, with segments, which are written in
+// batches and read through the index by several threads.
+class DiskBufferSegmentBenchmark : public ::testing::Test {
+public:
+    void TestBufferFile();
+    void TestSegment();
+    void TestSegmentWithDirectIO();
+
+protected:
+    void SetUp() override {
+        filesystem::remove_all(mDir);
+        filesystem::create_directories(mDir);
+        for (size_t i = 0; i < kBatchSize; ++i) {
+            mBatch.emplace_back(kRecordSize, static_cast<char>('a' + i % 26));
+        }
+    }
+
+    void TearDown() override { filesystem::remove_all(mDir); }
+
+    void RunSegment(const string& name, bool directIO);
+    static void Print(const string& name, int64_t writeCost, int64_t readCost);
+
+    static constexpr size_t kFileCnt = 8;
+    static constexpr size_t kBatchCnt = 200;
+    static constexpr size_t kBatchSize = 20;
+    static constexpr size_t kRecordSize = 16 * 1024;
+    static constexpr size_t kReadThreadCnt = 4;
+
+    const string mDir = "disk_buffer_segment_benchmark";
+    vector<string> mBatch;
+};
+
+void DiskBufferSegmentBenchmark::Print(const string& name, int64_t writeCost, int64_t readCost) {
+    auto bytes = kFileCnt * kBatchCnt * kBatchSize * kRecordSize;
+    cout << "[" << name << "] records: " << kFileCnt * kBatchCnt * kBatchSize << "\tbytes: " << bytes
+         << "\twrite cost: " << writeCost << "ms\twrite throughput: " << bytes / 1024 / max<int64_t>(writeCost, 1)
+         << " KB/ms\tread cost: " << readCost << "ms\tread throughput: " << bytes / 1024 / max<int64_t>(readCost, 1)
+         << " KB/ms" << endl;
+}
+
+void DiskBufferSegmentBenchmark::TestBufferFile() {
+    auto start = chrono::steady_clock::now();
+    for (size_t f = 0; f < kFileCnt; ++f) {
+        auto path = mDir + "/file_" + to_string(f);
+        for (size_t b = 0; b < kBatchCnt; ++b) {
+            for (const auto& record : mBatch) {
+                FILE* fout = fopen(path.c_str(), "ab");
+                uint32_t size = record.size();
+                fwrite(&size, 1, sizeof(size), fout);
+                fwrite(record.data(), 1, record.size(), fout);
+                fclose(fout);
+            }
+        }
+    }
+    auto writeCost = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    size_t readCnt = 0;
+    string record;
+    for (size_t f = 0; f < kFileCnt; ++f) {
+        auto path = mDir + "/file_" + to_string(f);
+        long pos = 0;
+        while (true) {
+            FILE* fin = fopen(path.c_str(), "rb");
+            fseek(fin, pos, SEEK_SET);
+            uint32_t size = 0;
+            if (fread(&size, 1, sizeof(size), fin) != sizeof(size)) {
+                fclose(fin);
+                break;
+            }
+            record.resize(size);
+            fread(&record[0], 1, size, fin);
+            pos = ftell(fin);
+            fclose(fin);
+            ++readCnt;
+        }
+    }
+    auto readCost = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+    APSARA_TEST_EQUAL(kFileCnt * kBatchCnt * kBatchSize, readCnt);
+    Print("buffer file", writeCost, readCost);
+}
+
+void DiskBufferSegmentBenchmark::RunSegment(const string& name, bool directIO) {
+    auto start = chrono::steady_clock::now();
+    for (size_t f = 0; f < kFileCnt; ++f) {
+        DiskBufferSegmentWriter writer;
+        APSARA_TEST_TRUE(writer.Open(mDir + "/segment_" + to_string(f), 64 * 1024 * 1024, 1, directIO));
+        for (size_t b = 0; b < kBatchCnt; ++b) {
+            APSARA_TEST_TRUE(writer.Append(mBatch));
+        }
+    }
+    auto writeCost = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    atomic_size_t nextIdx = 0;
+    atomic_size_t readCnt = 0;
+    vector<thread> threads;
+    for (size_t t = 0; t < kReadThreadCnt; ++t) {
+        threads.emplace_back([&]() {
+            size_t idx = 0;
+            string record;
+            while ((idx = nextIdx.fetch_add(1)) < kFileCnt) {
+                DiskBufferSegmentReader reader;
+                APSARA_TEST_TRUE(reader.Open(mDir + "/segment_" + to_string(idx)));
+                for (size_t i = 0; i < reader.GetRecordCnt(); ++i) {
+                    if (reader.Read(i, record)) {
+                        reader.MarkHandled(i);
+                        ++readCnt;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto readCost = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+    APSARA_TEST_EQUAL(kFileCnt * kBatchCnt * kBatchSize, readCnt.load());
+    Print(name, writeCost, readCost);
+}
+
+void DiskBufferSegmentBenchmark::TestSegment() {
+    RunSegment("segment", false);
+}
+
+void DiskBufferSegmentBenchmark::TestSegmentWithDirectIO() {
+    RunSegment("segment with direct I/O", true);
+}
+
+UNIT_TEST_CASE(DiskBufferSegmentBenchmark, TestBufferFile)
+#if defined(__linux__)
+UNIT_TEST_CASE(DiskBufferSegmentBenchmark, TestSegment)
+UNIT_TEST_CASE(DiskBufferSegmentBenchmark, TestSegmentWithDirectIO)
+#endif
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -0,0 +1,232 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "plugin/flusher/sls/DiskBufferSegment.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class DiskBufferSegmentUnittest : public ::testing::Test {
+public:
+    void TestWriteAndRead();
+    void TestMarkHandled();
+    void TestRecoverLostIndex();
+    void TestRecoverTruncatedIndex();
+    void TestTornRecord();
+    void TestCorruptedRecord();
+    void TestDirectIO();
+
+protected:
+    void SetUp() override {
+        filesystem::remove_all(mDir);
+        filesystem::create_directories(mDir);
+    }
+
+    void TearDown() override { filesystem::remove_all(mDir); }
+
+    // records of different sizes, so that both aligned and unaligned ones are covered
+    static vector<string> MakeRecords(size_t start, size_t cnt) {
+        vector<string> records;
+        for (size_t i = start; i < start + cnt; ++i) {
+            records.emplace_back(string(i * 37 % 1000 + 1, static_cast<char>('a' + i % 26)) + to_string(i));
+        }
+        return records;
+    }
+
+    void WriteSegment(const string& path, uint64_t capacity, bool directIO, size_t batchCnt) {
+        DiskBufferSegmentWriter writer;
+        APSARA_TEST_TRUE(writer.Open(path, capacity, 1, directIO));
+        for (size_t i = 0; i < batchCnt; ++i) {
+            APSARA_TEST_TRUE(writer.Append(MakeRecords(i * kBatchSize, kBatchSize)));
+        }
+        APSARA_TEST_EQUAL(batchCnt * kBatchSize, writer.GetRecordCnt());
+    }
+
+    void CheckRecords(DiskBufferSegmentReader& reader, size_t cnt) {
+        APSARA_TEST_EQUAL(cnt, reader.GetRecordCnt());
+        auto expected = MakeRecords(0, cnt);
+        string record;
+        for (size_t i = 0; i < cnt; ++i) {
+            APSARA_TEST_TRUE(reader.Read(i, record));
+            APSARA_TEST_EQUAL(expected[i], record);
+        }
+    }
+
+    static constexpr size_t kBatchSize = 10;
+
+    const string mDir = "disk_buffer_segment_test";
+    const string mPath = mDir + "/segment_1";
+};
+
+void DiskBufferSegmentUnittest::TestWriteAndRead() {
+    WriteSegment(mPath, 64 * 1024 * 1024, false, 3);
+    // preallocated as records arrive rather than to the whole capacity
+    APSARA_TEST_TRUE(filesystem::file_size(mPath) <= 1024 * 1024);
+
+    DiskBufferSegmentReader reader;
+    APSARA_TEST_TRUE(reader.Open(mPath));
+    APSARA_TEST_EQUAL(1, reader.GetKeyVersion());
+    APSARA_TEST_EQUAL(0U, reader.GetRecoveredCnt());
+    CheckRecords(reader, 3 * kBatchSize);
+    string record;
+    APSARA_TEST_FALSE(reader.Read(3 * kBatchSize, record));
+
+    // not a segment
+    {
+        ofstream fout(mDir + "/invalid");
+        fout << string(8192, 'x');
+    }
+    DiskBufferSegmentReader invalidReader;
+    APSARA_TEST_FALSE(invalidReader.Open(mDir + "/invalid"));
+    APSARA_TEST_FALSE(invalidReader.Open(mDir + "/not_exist"));
+
+    // created exclusively
+    DiskBufferSegmentWriter writer;
+    APSARA_TEST_FALSE(writer.Open(mPath, 0, 1, false));
+}
+
+void DiskBufferSegmentUnittest::TestMarkHandled() {
+    WriteSegment(mPath, 0, false, 2);
+    {
+        DiskBufferSegmentReader reader;
+        APSARA_TEST_TRUE(reader.Open(mPath));
+        for (size_t i = 0; i < reader.GetRecordCnt(); i += 2) {
+            reader.MarkHandled(i);
+        }
+        APSARA_TEST_FALSE(reader.AllHandled());
+    }
+    {
+        DiskBufferSegmentReader reader;
+        APSARA_TEST_TRUE(reader.Open(mPath));
+        for (size_t i = 0; i < reader.GetRecordCnt(); ++i) {
+            APSARA_TEST_EQUAL(i % 2 == 0, reader.IsHandled(i));
+            reader.MarkHandled(i);
+        }
+        APSARA_TEST_TRUE(reader.AllHandled());
+    }
+    DiskBufferSegmentReader::Remove(mPath);
+    APSARA_TEST_FALSE(filesystem::exists(mPath));
+    APSARA_TEST_FALSE(filesystem::exists(DiskBufferSegmentReader::GetIndexPath(mPath)));
+}
+
+void DiskBufferSegmentUnittest::TestRecoverLostIndex() {
+    WriteSegment(mPath, 1024 * 1024, false, 3);
+    filesystem::remove(DiskBufferSegmentReader::GetIndexPath(mPath));
+
+    {
+        DiskBufferSegmentReader reader;
+        APSARA_TEST_TRUE(reader.Open(mPath));
+        APSARA_TEST_EQUAL(3 * kBatchSize, reader.GetRecoveredCnt());
+        CheckRecords(reader, 3 * kBatchSize);
+        reader.MarkHandled(0);
+    }
+    // the recovered index is persisted
+    DiskBufferSegmentReader reader;
+    APSARA_TEST_TRUE(reader.Open(mPath));
+    APSARA_TEST_EQUAL(0U, reader.GetRecoveredCnt());
+    APSARA_TEST_TRUE(reader.IsHandled(0));
+    CheckRecords(reader, 3 * kBatchSize);
+}
+
+void DiskBufferSegmentUnittest::TestRecoverTruncatedIndex() {
+    WriteSegment(mPath, 0, false, 3);
+    auto indexPath = DiskBufferSegmentReader::GetIndexPath(mPath);
+    auto entrySize = filesystem::file_size(indexPath) / (3 * kBatchSize);
+    // crashed after the last batch is written to the data file, with a partially written index entry
+    filesystem::resize_file(indexPath, entrySize * (2 * kBatchSize) + entrySize / 2);
+
+    DiskBufferSegmentReader reader;
+    APSARA_TEST_TRUE(reader.Open(mPath));
+    APSARA_TEST_EQUAL(kBatchSize, reader.GetRecoveredCnt());
+    CheckRecords(reader, 3 * kBatchSize);
+    APSARA_TEST_EQUAL(entrySize * 3 * kBatchSize, filesystem::file_size(indexPath));
+}
+
+void DiskBufferSegmentUnittest::TestTornRecord() {
+    WriteSegment(mPath, 0, false, 2);
+    auto indexPath = DiskBufferSegmentReader::GetIndexPath(mPath);
+    auto entrySize = filesystem::file_size(indexPath) / (2 * kBatchSize);
+    // crashed while writing the last batch, with its tail not written and none of its entries
+    filesystem::resize_file(mPath, filesystem::file_size(mPath) - 100);
+    filesystem::resize_file(indexPath, entrySize * kBatchSize);
+
+    DiskBufferSegmentReader reader;
+    APSARA_TEST_TRUE(reader.Open(mPath));
+    APSARA_TEST_EQUAL(kBatchSize - 1, reader.GetRecoveredCnt());
+    CheckRecords(reader, 2 * kBatchSize - 1);
+}
+
+void DiskBufferSegmentUnittest::TestCorruptedRecord() {
+    WriteSegment(mPath, 0, false, 1);
+    auto records = MakeRecords(0, kBatchSize);
+    {
+        // flip the last byte of the last record
+        fstream file(mPath, ios::in | ios::out | ios::binary);
+        file.seekg(0, ios::end);
+        auto size = static_cast<size_t>(file.tellg());
+        auto padding = (8 - records.back().size() % 8) % 8;
+        file.seekp(size - padding - 1);
+        file.put('#');
+    }
+
+    DiskBufferSegmentReader reader;
+    APSARA_TEST_TRUE(reader.Open(mPath));
+    APSARA_TEST_EQUAL(kBatchSize, reader.GetRecordCnt());
+    string record;
+    APSARA_TEST_TRUE(reader.Read(kBatchSize - 2, record));
+    APSARA_TEST_FALSE(reader.Read(kBatchSize - 1, record));
+
+    // the corrupted record is not recovered either
+    reader.Close();
+    filesystem::remove(DiskBufferSegmentReader::GetIndexPath(mPath));
+    APSARA_TEST_TRUE(reader.Open(mPath));
+    APSARA_TEST_EQUAL(kBatchSize - 1, reader.GetRecordCnt());
+}
+
+void DiskBufferSegmentUnittest::TestDirectIO() {
+    // falls back to buffered writes on file systems without direct I/O
+    WriteSegment(mPath, 1024 * 1024, true, 3);
+    {
+        DiskBufferSegmentReader reader;
+        APSARA_TEST_TRUE(reader.Open(mPath));
+        CheckRecords(reader, 3 * kBatchSize);
+    }
+    // padding between batches is skipped on recovery
+    filesystem::remove(DiskBufferSegmentReader::GetIndexPath(mPath));
+    DiskBufferSegmentReader reader;
+    APSARA_TEST_TRUE(reader.Open(mPath));
+    APSARA_TEST_EQUAL(3 * kBatchSize, reader.GetRecoveredCnt());
+    CheckRecords(reader, 3 * kBatchSize);
+}
+
+#if defined(__linux__)
+UNIT_TEST_CASE(DiskBufferSegmentUnittest, TestWriteAndRead)
+UNIT_TEST_CASE(DiskBufferSegmentUnittest, TestMarkHandled)
+UNIT_TEST_CASE(DiskBufferSegmentUnittest, TestRecoverLostIndex)
+UNIT_TEST_CASE(DiskBufferSegmentUnittest, TestRecoverTruncatedIndex)
+UNIT_TEST_CASE(DiskBufferSegmentUnittest, TestTornRecord)
+UNIT_TEST_CASE(DiskBufferSegmentUnittest, TestCorruptedRecord)
+UNIT_TEST_CASE(DiskBufferSegmentUnittest, TestDirectIO)
+#endif
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
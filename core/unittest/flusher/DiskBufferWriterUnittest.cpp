@@ -0,0 +1,152 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <ctime>
+
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "app_config/AppConfig.h"
+#include "collection_pipeline/queue/SLSSenderQueueItem.h"
+#include "common/Flags.h"
+#include "common/StringTools.h"
+#include "plugin/flusher/sls/DiskBufferWriter.h"
+#include "plugin/flusher/sls/FlusherSLS.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_BOOL(enable_disk_buffer_segment);
+
+using namespace std;
+
+namespace logtail {
+
+class DiskBufferWriterUnittest : public ::testing::Test {
+public:
+    void TestSegmentWriteAndReplay();
+    void TestBufferFileCountLimit();
+
+protected:
+    void SetUp() override {
+        filesystem::remove_all(mDir);
+        filesystem::create_directories(mDir);
+        BOOL_FLAG(enable_disk_buffer_segment) = true;
+        mFlusher.mProject = "test_project";
+        mFlusher.mRegion = "test_region";
+        mFlusher.mEndpoint = "test_endpoint";
+    }
+
+    void TearDown() override {
+        BOOL_FLAG(enable_disk_buffer_segment) = false;
+        filesystem::remove_all(mDir);
+    }
+
+    // sends all buffered data found by the writer, and stops the writer after stopAfter records are sent
+    vector<string> Replay(size_t stopAfter) {
+        DiskBufferWriter writer;
+        writer.SetBufferFilePath(mDir);
+        vector<string> sent;
+        writer.mSendBufferFileDataHook = [&](const sls_logs::LogtailBufferMeta& meta, const string& data) {
+            APSARA_TEST_EQUAL("test_project", meta.project());
+            APSARA_TEST_EQUAL("test_logstore", meta.logstore());
+            sent.push_back(data);
+            if (sent.size() == stopAfter) {
+                lock_guard<mutex> lock(writer.mBufferSenderThreadRunningMux);
+                writer.mIsSendBufferThreadRunning = false;
+            }
+            SLSResponse response;
+            response.mStatusCode = 200;
+            return response;
+        };
+        vector<string> files, segments;
+        APSARA_TEST_TRUE(writer.LoadFileToSend(time(nullptr) + 1, files, segments));
+        APSARA_TEST_EQUAL(0U, files.size());
+        writer.SendBufferSegments(segments);
+        return sent;
+    }
+
+    const string mDir = "disk_buffer_writer_test";
+    FlusherSLS mFlusher;
+};
+
+void DiskBufferWriterUnittest::TestSegmentWriteAndReplay() {
+    vector<string> datas;
+    for (size_t i = 0; i < 5; ++i) {
+        datas.push_back("log group " + ToString(i));
+    }
+    {
+        DiskBufferWriter writer;
+        writer.SetBufferFilePath(mDir);
+        writer.mBufferWriterThreadRes = async(launch::async, &DiskBufferWriter::BufferWriterThread, &writer);
+        for (const auto& data : datas) {
+            SLSSenderQueueItem item(string(data), data.size(), &mFlusher, 0, "test_logstore");
+            APSARA_TEST_TRUE(writer.PushToDiskBuffer(&item, 3));
+        }
+        // stops once all items are written
+        writer.mIsFlush = true;
+        writer.mBufferWriterThreadRes.get();
+    }
+    size_t segmentCnt = 0;
+    for (const auto& entry : filesystem::directory_iterator(mDir)) {
+        if (entry.path().filename().string().find(GetSendBufferFileNamePrefix() + "segment_") == 0) {
+            ++segmentCnt;
+        }
+    }
+    // the data file and the index file
+    APSARA_TEST_EQUAL(2U, segmentCnt);
+
+    // stopped after 3 records are sent, which are marked handled
+    APSARA_TEST_EQUAL(vector<string>(datas.begin(), datas.begin() + 3), Replay(3));
+    APSARA_TEST_EQUAL(2U, static_cast<size_t>(distance(filesystem::directory_iterator(mDir), {})));
+
+    // only the records not handled are sent after restart, and the segment is removed then
+    APSARA_TEST_EQUAL(vector<string>(datas.begin() + 3, datas.end()), Replay(0));
+    APSARA_TEST_EQUAL(0U, static_cast<size_t>(distance(filesystem::directory_iterator(mDir), {})));
+}
+
+void DiskBufferWriterUnittest::TestBufferFileCountLimit() {
+    const string prefix = mDir + "/" + GetSendBufferFileNamePrefix();
+    for (const auto& name : {"1000", "3000", "segment_2000_0", "segment_2000_0.idx", "segment_4000_0",
+                             "segment_4000_0.idx", "segment_4000_1", "segment_4000_1.idx"}) {
+        ofstream(prefix + name) << "x";
+    }
+    auto numOfBufferFile = AppConfig::GetInstance()->mNumOfBufferFile;
+    AppConfig::GetInstance()->mNumOfBufferFile = 3;
+    {
+        DiskBufferWriter writer;
+        writer.SetBufferFilePath(mDir);
+        APSARA_TEST_TRUE(writer.CreateNewFile());
+    }
+    AppConfig::GetInstance()->mNumOfBufferFile = numOfBufferFile;
+    // files and segments count against the same limit, and the oldest of both are removed
+    APSARA_TEST_FALSE(filesystem::exists(prefix + "1000"));
+    APSARA_TEST_FALSE(filesystem::exists(prefix + "segment_2000_0"));
+    APSARA_TEST_FALSE(filesystem::exists(prefix + "segment_2000_0.idx"));
+    APSARA_TEST_TRUE(filesystem::exists(prefix + "3000"));
+    APSARA_TEST_TRUE(filesystem::exists(prefix + "segment_4000_0"));
+    APSARA_TEST_TRUE(filesystem::exists(prefix + "segment_4000_1"));
+}
+
+#if defined(__linux__)
+UNIT_TEST_CASE(DiskBufferWriterUnittest, TestSegmentWriteAndReplay)
+#endif
+UNIT_TEST_CASE(DiskBufferWriterUnittest, TestBufferFileCountLimit)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
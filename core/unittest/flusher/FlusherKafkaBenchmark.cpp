@@ -0,0 +1,154 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "collection_pipeline/CollectionPipelineContext.h"
+#include "common/memory/SourceBuffer.h"
+#include "models/PipelineEventGroup.h"
+#include "plugin/flusher/kafka/FlusherKafka.h"
+#include "plugin/flusher/kafka/KafkaConfig.h"
+#include "plugin/flusher/kafka/KafkaProducer.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+// A producer which completes all messages at once and only counts them, so that the cost of the flusher itself is
+// measured.
+class CountingKafkaProducer : public KafkaProducer {
+public:
+    bool Init(const KafkaConfig& config) override { return true; }
+
+    void ProduceAsync(const std::string& topic,
+                      std::string&& value,
+                      Callback callback,
+                      const std::string& key = std::string()) override {
+        ++mProduceCnt;
+        ++mMessageCnt;
+        mBytes += value.size();
+        callback(true, {ErrorType::SUCCESS, "", 0});
+    }
+
+    void ProduceBatchAsync(const std::string& topic, std::vector<Message>&& messages, BatchCallback callback) override {
+        ++mProduceCnt;
+        mMessageCnt += messages.size();
+        BatchResult result;
+        for (const auto& message : messages) {
+            mBytes += message.value.size();
+            ++result.successCnt;
+        }
+        callback(result);
+    }
+
+    bool Flush(int timeoutMs) override { return true; }
+    void Close() override {}
+
+    size_t mProduceCnt = 0;
+    size_t mMessageCnt = 0;
+    size_t mBytes = 0;
+};
+
+// Compares sending each group once received with accumulating groups in the batcher, for groups with few events as
+// produced by inputs with low traffic.
+class FlusherKafkaBenchmark : public ::testing::Test {
+public:
+    void TestSendWithoutBatch();
+    void TestSendWithBatch();
+
+protected:
+    void SetUp() override {
+        mContext.SetConfigName("flusher_kafka_benchmark");
+        mFlusher = make_unique<FlusherKafka>();
+        auto producer = make_unique<CountingKafkaProducer>();
+        mProducer = producer.get();
+        mFlusher->SetProducerForTest(std::move(producer));
+        mFlusher->SetContext(mContext);
+        mFlusher->CreateMetricsRecordRef(FlusherKafka::sName, "1");
+    }
+
+    void TearDown() override {
+        mFlusher->Stop(true);
+        mFlusher->CommitMetricsRecordRef();
+    }
+
+    void Run(const string& name, bool enableBatch);
+
+    static constexpr size_t kGroupCnt = 200000;
+    static constexpr size_t kEventCntPerGroup = 4;
+
+    CollectionPipelineContext mContext;
+    unique_ptr<FlusherKafka> mFlusher;
+    CountingKafkaProducer* mProducer = nullptr;
+};
+
+void FlusherKafkaBenchmark::Run(const string& name, bool enableBatch) {
+    Json::Value config;
+    config["Brokers"].append("test.mock.brokers");
+    config["Topic"] = "benchmark_topic";
+    config["PartitionerType"] = "hash";
+    config["HashKeys"].append("content.user");
+    if (enableBatch) {
+        config["Batch"]["TimeoutSecs"] = 3;
+    }
+    Json::Value optionalGoPipeline;
+    APSARA_TEST_TRUE(mFlusher->Init(config, optionalGoPipeline));
+    APSARA_TEST_TRUE(mFlusher->Start());
+
+    vector<PipelineEventGroup> groups;
+    groups.reserve(kGroupCnt);
+    for (size_t i = 0; i < kGroupCnt; ++i) {
+        groups.emplace_back(make_shared<SourceBuffer>());
+        auto& group = groups.back();
+        group.SetTag(string("__hostname__"), string("benchmark-host"));
+        for (size_t j = 0; j < kEventCntPerGroup; ++j) {
+            auto* event = group.AddLogEvent();
+            event->SetTimestamp(1735689600);
+            event->SetContent(string("user"), "user_" + to_string((i * kEventCntPerGroup + j) % 64));
+            event->SetContent(string("content"), string("GET /index.html HTTP/1.1 200 1024 curl/7.81.0"));
+        }
+    }
+
+    auto start = chrono::steady_clock::now();
+    for (auto& group : groups) {
+        mFlusher->Send(std::move(group));
+    }
+    mFlusher->FlushAll();
+    auto cost = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+
+    APSARA_TEST_EQUAL(kGroupCnt * kEventCntPerGroup, mProducer->mMessageCnt);
+    cout << "[" << name << "] events: " << mProducer->mMessageCnt << "\tproduce calls: " << mProducer->mProduceCnt
+         << "\tbytes: " << mProducer->mBytes << "\tcost: " << cost << "ms\tthroughput: "
+         << mProducer->mMessageCnt * 1000 / max<int64_t>(cost, 1) << " events/s" << endl;
+}
+
+void FlusherKafkaBenchmark::TestSendWithoutBatch() {
+    Run("without batch", false);
+}
+
+void FlusherKafkaBenchmark::TestSendWithBatch() {
+    Run("with batch", true);
+}
+
+UNIT_TEST_CASE(FlusherKafkaBenchmark, TestSendWithoutBatch)
+UNIT_TEST_CASE(FlusherKafkaBenchmark, TestSendWithBatch)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -19,10 +19,13 @@
 
 #include <cassert>
 
+#include <chrono>
 #include <functional>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "collection_pipeline/CollectionPipelineContext.h"
@@ -110,6 +113,9 @@ public:
     void TestInitWithKerberosFull();
     void TestInitWithCompression();
     void TestInitWithCompressionAndLevel();
+    void TestSendWithBatch();
+    void TestFlushWithBatch();
+    void TestSendWithBatch_Real();
 
 protected:
     void SetUp();
@@ -670,6 +676,132 @@ void FlusherKafkaUnittest::TestInitWithCompressionAndLevel() {
     APSARA_TEST_EQUAL(2, mFlusher->mKafkaConfig.CompressionLevel);
 }
 
+void FlusherKafkaUnittest::TestSendWithBatch() {
+    Json::Value optionalGoPipeline;
+    Json::Value config = CreateKafkaTestConfig("test_%{content.application}");
+    config["PartitionerType"] = "hash";
+    config["HashKeys"].append("content.user");
+    config["Batch"]["MinCnt"] = 4;
+    config["Batch"]["TimeoutSecs"] = 3;
+    APSARA_TEST_TRUE(mFlusher->Init(config, optionalGoPipeline));
+    APSARA_TEST_TRUE(mFlusher->mBatchEnabled);
+    APSARA_TEST_TRUE(mFlusher->Start());
+
+    auto addEvent = [](PipelineEventGroup& group, const string& app, const string& user) {
+        auto* event = group.AddLogEvent();
+        event->SetContent(StringView("application"), app);
+        event->SetContent(StringView("user"), user);
+    };
+    {
+        PipelineEventGroup group(std::make_shared<SourceBuffer>());
+        addEvent(group, "app1", "alice");
+        addEvent(group, "app2", "bob");
+        APSARA_TEST_TRUE(mFlusher->Send(std::move(group)));
+        APSARA_TEST_EQUAL(0U, mMockProducer->GetRequestCount());
+        APSARA_TEST_EQUAL(0, mFlusher->mSendCnt->GetValue());
+    }
+    {
+        PipelineEventGroup group(std::make_shared<SourceBuffer>());
+        addEvent(group, "app1", "carol");
+        addEvent(group, "app1", "alice");
+        mMockProducer->SetAutoComplete(false);
+        APSARA_TEST_TRUE(mFlusher->Send(std::move(group)));
+    }
+    // one batch per topic
+    APSARA_TEST_EQUAL(2U, mMockProducer->GetBatchCount());
+    const auto& requests = mMockProducer->GetRequests();
+    APSARA_TEST_EQUAL(4U, requests.size());
+    map<string, vector<string>> keysByTopic;
+    for (const auto& request : requests) {
+        keysByTopic[request.Topic].push_back(request.Key);
+    }
+    APSARA_TEST_EQUAL(2U, keysByTopic.size());
+    APSARA_TEST_EQUAL(vector<string>({"alice", "carol", "alice"}), keysByTopic["test_app1"]);
+    APSARA_TEST_EQUAL(vector<string>({"bob"}), keysByTopic["test_app2"]);
+    APSARA_TEST_EQUAL(4, mFlusher->mSendCnt->GetValue());
+
+    // delivery results are reported once per batch, and the batch of test_app2 has only one message
+    mMockProducer->CompleteLastRequest(false, {KafkaProducer::ErrorType::NETWORK_ERROR, "mock network error", 0});
+    APSARA_TEST_EQUAL(1, mFlusher->mSendDoneCnt->GetValue());
+    APSARA_TEST_EQUAL(1, mFlusher->mNetworkErrorCnt->GetValue());
+    mMockProducer->CompleteLastRequest();
+    APSARA_TEST_EQUAL(1, mFlusher->mSendDoneCnt->GetValue());
+    mMockProducer->CompleteAllRequests();
+    APSARA_TEST_EQUAL(4, mFlusher->mSendDoneCnt->GetValue());
+    APSARA_TEST_EQUAL(3, mFlusher->mSuccessCnt->GetValue());
+    APSARA_TEST_EQUAL(1, mFlusher->mNetworkErrorCnt->GetValue());
+}
+
+void FlusherKafkaUnittest::TestFlushWithBatch() {
+    Json::Value optionalGoPipeline;
+    Json::Value config = CreateKafkaTestConfig(mTopic);
+    config["Batch"]["MinCnt"] = 100;
+    config["Batch"]["TimeoutSecs"] = 3;
+    APSARA_TEST_TRUE(mFlusher->Init(config, optionalGoPipeline));
+    APSARA_TEST_TRUE(mFlusher->Start());
+
+    size_t key = 0;
+    {
+        PipelineEventGroup group(std::make_shared<SourceBuffer>());
+        group.SetTag(StringView("namespace"), StringView("default"));
+        group.AddLogEvent()->SetContent(StringView("key"), StringView("value1"));
+        group.AddLogEvent()->SetContent(StringView("key"), StringView("value2"));
+        key = group.GetTagsHash();
+        APSARA_TEST_TRUE(mFlusher->Send(std::move(group)));
+    }
+    {
+        PipelineEventGroup group(std::make_shared<SourceBuffer>());
+        group.AddLogEvent()->SetContent(StringView("key"), StringView("value3"));
+        APSARA_TEST_TRUE(mFlusher->Send(std::move(group)));
+    }
+    APSARA_TEST_EQUAL(0U, mMockProducer->GetRequestCount());
+
+    // flushed by timeout
+    APSARA_TEST_TRUE(mFlusher->Flush(key));
+    APSARA_TEST_EQUAL(1U, mMockProducer->GetBatchCount());
+    APSARA_TEST_EQUAL(2U, mMockProducer->GetRequestCount());
+    APSARA_TEST_FALSE(mMockProducer->IsFlushCalled());
+
+    APSARA_TEST_TRUE(mFlusher->FlushAll());
+    APSARA_TEST_EQUAL(2U, mMockProducer->GetBatchCount());
+    APSARA_TEST_EQUAL(3U, mMockProducer->GetRequestCount());
+    APSARA_TEST_TRUE(mMockProducer->IsFlushCalled());
+    APSARA_TEST_EQUAL(3, mFlusher->mSuccessCnt->GetValue());
+}
+
+void FlusherKafkaUnittest::TestSendWithBatch_Real() {
+    // messages are delivered to the mock cluster of librdkafka
+    mFlusher->SetProducerForTest(std::make_unique<KafkaProducer>());
+    mMockProducer = nullptr;
+
+    Json::Value optionalGoPipeline;
+    Json::Value config = CreateKafkaTestConfig("test_%{content.application}");
+    config["PartitionerType"] = "hash";
+    config["HashKeys"].append("content.user");
+    config["Batch"]["MinCnt"] = 100;
+    APSARA_TEST_TRUE(mFlusher->Init(config, optionalGoPipeline));
+    APSARA_TEST_TRUE(mFlusher->Start());
+
+    PipelineEventGroup group(std::make_shared<SourceBuffer>());
+    for (const auto& item : vector<pair<string, string>>{
+             {"app1", "alice"}, {"app2", "bob"}, {"app1", "carol"}, {"app1", "alice"}, {"app2", "dave"}}) {
+        auto* event = group.AddLogEvent();
+        event->SetContent(StringView("application"), item.first);
+        event->SetContent(StringView("user"), item.second);
+    }
+    APSARA_TEST_TRUE(mFlusher->Send(std::move(group)));
+    APSARA_TEST_EQUAL(0, mFlusher->mSendCnt->GetValue());
+
+    APSARA_TEST_TRUE(mFlusher->FlushAll());
+    APSARA_TEST_EQUAL(5, mFlusher->mSendCnt->GetValue());
+    for (size_t i = 0; i < 100 && mFlusher->mSendDoneCnt->GetValue() < 5; ++i) {
+        this_thread::sleep_for(chrono::milliseconds(100));
+    }
+    APSARA_TEST_EQUAL(5, mFlusher->mSendDoneCnt->GetValue());
+    APSARA_TEST_EQUAL(5, mFlusher->mSuccessCnt->GetValue());
+    APSARA_TEST_EQUAL(0, mFlusher->mOtherErrorCnt->GetValue());
+}
+
 UNIT_TEST_CASE(FlusherKafkaUnittest, TestInitSuccess)
 UNIT_TEST_CASE(FlusherKafkaUnittest, TestInitMissingBrokers)
 UNIT_TEST_CASE(FlusherKafkaUnittest, TestInitMissingTopic)
@@ -705,6 +837,9 @@ UNIT_TEST_CASE(FlusherKafkaUnittest, TestInitWithKerberosAndTLS)
 UNIT_TEST_CASE(FlusherKafkaUnittest, TestInitWithKerberosFull)
 UNIT_TEST_CASE(FlusherKafkaUnittest, TestInitWithCompression)
 UNIT_TEST_CASE(FlusherKafkaUnittest, TestInitWithCompressionAndLevel)
+UNIT_TEST_CASE(FlusherKafkaUnittest, TestSendWithBatch)
+UNIT_TEST_CASE(FlusherKafkaUnittest, TestFlushWithBatch)
+UNIT_TEST_CASE(FlusherKafkaUnittest, TestSendWithBatch_Real)
 
 } // namespace logtail
 
@@ -20,9 +20,13 @@
 #include <cassert>
 #include <librdkafka/rdkafka.h>
 
+#include <chrono>
 #include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "plugin/flusher/kafka/KafkaConfig.h"
@@ -56,6 +60,7 @@ public:
     void TestProduceAsyncWithoutInit_Real();
     void TestInitWithTLSMinimal_Real();
     void TestInitWithTLSFull_Real();
+    void TestProduceBatchAsync_Real();
     void TestCreateHeadersTemplate();
     void TestProduceAsyncWithHeadersAndKeys();
     void TestProduceAsyncWithHeadersAndNoKeys();
@@ -325,6 +330,60 @@ void KafkaProducerUnittest::TestInitWithTLSFull_Real() {
     APSARA_TEST_FALSE(p.Init(c));
 }
 
+void KafkaProducerUnittest::TestProduceBatchAsync_Real() {
+    KafkaConfig c;
+    c.Brokers = {"test.mock.brokers"};
+    c.Topic = "ut_topic";
+    c.Version = "2.6.0";
+    c.MaxMessageBytes = 1000;
+    c.CustomConfig["test.mock.num.brokers"] = "3";
+
+    KafkaProducer p;
+    APSARA_TEST_TRUE(p.Init(c));
+
+    std::mutex mux;
+    std::map<std::string, std::vector<KafkaProducer::BatchResult>> results;
+    auto produce = [&](const std::string& topic, size_t cnt, size_t oversizedCnt) {
+        std::vector<KafkaProducer::Message> messages;
+        for (size_t i = 0; i < cnt; ++i) {
+            messages.push_back({topic + "_" + std::to_string(i), "key_" + std::to_string(i % 2)});
+        }
+        for (size_t i = 0; i < oversizedCnt; ++i) {
+            messages.push_back({std::string(1024, 'x'), ""});
+        }
+        p.ProduceBatchAsync(topic, std::move(messages), [&, topic](const KafkaProducer::BatchResult& result) {
+            std::lock_guard<std::mutex> lock(mux);
+            results[topic].push_back(result);
+        });
+    };
+    produce("ut_topic_a", 3, 1);
+    produce("ut_topic_b", 2, 0);
+    APSARA_TEST_TRUE(p.Flush(10000));
+    for (size_t i = 0; i < 100; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(mux);
+            if (results.size() == 2) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    p.Close();
+
+    // each batch is reported once, with the delivery results of all of its messages
+    std::lock_guard<std::mutex> lock(mux);
+    APSARA_TEST_EQUAL(2U, results.size());
+    APSARA_TEST_EQUAL_FATAL(1U, results["ut_topic_a"].size());
+    const auto& resultA = results["ut_topic_a"][0];
+    APSARA_TEST_EQUAL(3U, resultA.successCnt);
+    APSARA_TEST_EQUAL(1U, resultA.FailCnt());
+    APSARA_TEST_EQUAL(1U, resultA.failCnts.at(KafkaProducer::ErrorType::PARAMS_ERROR));
+    APSARA_TEST_EQUAL((int)KafkaProducer::ErrorType::PARAMS_ERROR, (int)resultA.firstError.type);
+    APSARA_TEST_EQUAL_FATAL(1U, results["ut_topic_b"].size());
+    APSARA_TEST_EQUAL(2U, results["ut_topic_b"][0].successCnt);
+    APSARA_TEST_EQUAL(0U, results["ut_topic_b"][0].FailCnt());
+}
+
 void KafkaProducerUnittest::TestCreateHeadersTemplate() {
     KafkaProducer p;
     KafkaConfig c;
@@ -463,6 +522,7 @@ UNIT_TEST_CASE(KafkaProducerUnittest, TestInitWithInvalidPartitioner_Real)
 UNIT_TEST_CASE(KafkaProducerUnittest, TestProduceAsyncWithoutInit_Real)
 UNIT_TEST_CASE(KafkaProducerUnittest, TestInitWithTLSMinimal_Real)
 UNIT_TEST_CASE(KafkaProducerUnittest, TestInitWithTLSFull_Real)
+UNIT_TEST_CASE(KafkaProducerUnittest, TestProduceBatchAsync_Real)
 UNIT_TEST_CASE(KafkaProducerUnittest, TestCreateHeadersTemplate)
 UNIT_TEST_CASE(KafkaProducerUnittest, TestProduceAsyncWithHeadersAndKeys)
 UNIT_TEST_CASE(KafkaProducerUnittest, TestProduceAsyncWithHeadersAndNoKeys)
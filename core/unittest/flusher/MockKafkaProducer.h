@@ -69,6 +69,41 @@ public:
         }
     }
 
+    // messages are recorded as separate requests, and the callback is called once all of them are completed
+    void ProduceBatchAsync(const std::string& topic,
+                           std::vector<Message>&& messages,
+                           BatchCallback callback) override {
+        ++mBatchCnt;
+        if (messages.empty()) {
+            callback(BatchResult());
+            return;
+        }
+        struct BatchProgress {
+            BatchResult result;
+            size_t remainingCnt = 0;
+            BatchCallback callback;
+        };
+        auto progress = std::make_shared<BatchProgress>();
+        progress->remainingCnt = messages.size();
+        progress->callback = std::move(callback);
+        for (auto& message : messages) {
+            ProduceAsync(
+                topic,
+                std::move(message.value),
+                [progress](bool success, const KafkaProducer::ErrorInfo& errorInfo) {
+                    if (success) {
+                        ++progress->result.successCnt;
+                    } else {
+                        progress->result.AddFailure(errorInfo);
+                    }
+                    if (--progress->remainingCnt == 0) {
+                        progress->callback(progress->result);
+                    }
+                },
+                message.key);
+        }
+    }
+
     bool Flush(int timeoutMs) override {
         mFlushCalled = true;
 
@@ -123,6 +158,7 @@ public:
     const std::vector<ProduceRequest>& GetRequests() const { return mRequests; }
     const std::vector<ProduceRequest>& GetCompletedRequests() const { return mCompletedRequests; }
     size_t GetRequestCount() const { return mRequests.size() + mCompletedRequests.size(); }
+    size_t GetBatchCount() const { return mBatchCnt; }
 
 private:
     std::vector<std::pair<std::string, std::string>> mDefaultHeaders;
@@ -132,6 +168,7 @@ private:
     bool mInitSuccess = true;
     bool mFlushSuccess = true;
     bool mAutoComplete = true;
+    size_t mBatchCnt = 0;
 
     KafkaConfig mConfig;
     std::vector<ProduceRequest> mRequests;
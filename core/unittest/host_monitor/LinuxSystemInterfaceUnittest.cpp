@@ -34,6 +34,7 @@ public:
     void TestGetCPUInformationOnce() const;
     void TestGetProcessListInformationOnce() const;
     void TestGetProcessInformationOnce() const;
+    void TestGetProcessSnapshotOnce() const;
     void TestGetProcessListInformationOncePathDeleting() const;
     void TestGetProcessOpenFilesOnce() const;
     void TestGetProcessOpenFilesOncePermissionDenied() const;
@@ -152,6 +153,34 @@ void LinuxSystemInterfaceUnittest::TestGetProcessInformationOnce() const {
     APSARA_TEST_EQUAL_FATAL(171, processInfo.stat.rss);
 };
 
+void LinuxSystemInterfaceUnittest::TestGetProcessSnapshotOnce() const {
+    // not a process
+    ofstream ofs2("./2", std::ios::trunc);
+    ofs2.close();
+    // exited before its stat is read
+    bfs::create_directories("./3");
+
+    ProcessSnapshot snapshot;
+    APSARA_TEST_TRUE_FATAL(LinuxSystemInterface::GetInstance()->GetProcessSnapshotOnce(snapshot));
+    APSARA_TEST_EQUAL_FATAL(1, snapshot.processes.size());
+    APSARA_TEST_EQUAL_FATAL(nullptr, snapshot.Find(2));
+    APSARA_TEST_EQUAL_FATAL(nullptr, snapshot.Find(3));
+    auto process = snapshot.Find(1);
+    APSARA_TEST_NOT_EQUAL_FATAL(nullptr, process);
+
+    ProcessInformation processInfo;
+    LinuxSystemInterface::GetInstance()->GetProcessInformationOnce(1, processInfo);
+    APSARA_TEST_EQUAL(processInfo.stat.pid, process->stat.pid);
+    APSARA_TEST_EQUAL(processInfo.stat.name, process->stat.name);
+    APSARA_TEST_EQUAL(processInfo.stat.state, process->stat.state);
+    APSARA_TEST_EQUAL(processInfo.stat.minorFaults, process->stat.minorFaults);
+    APSARA_TEST_EQUAL(processInfo.stat.utimeTicks, process->stat.utimeTicks);
+    APSARA_TEST_EQUAL(processInfo.stat.rss, process->stat.rss);
+
+    bfs::remove("./2");
+    bfs::remove_all("./3");
+}
+
 void LinuxSystemInterfaceUnittest::TestGetProcessListInformationOncePathDeleting() const {
     std::string mTestDir = "./tmp";
     bfs::create_directories(mTestDir);
@@ -518,6 +547,7 @@ UNIT_TEST_CASE(LinuxSystemInterfaceUnittest, TestGetSystemInformationOnce);
 UNIT_TEST_CASE(LinuxSystemInterfaceUnittest, TestGetCPUInformationOnce);
 UNIT_TEST_CASE(LinuxSystemInterfaceUnittest, TestGetProcessListInformationOnce);
 UNIT_TEST_CASE(LinuxSystemInterfaceUnittest, TestGetProcessInformationOnce);
+UNIT_TEST_CASE(LinuxSystemInterfaceUnittest, TestGetProcessSnapshotOnce);
 UNIT_TEST_CASE(LinuxSystemInterfaceUnittest, TestGetProcessListInformationOncePathDeleting);
 UNIT_TEST_CASE(LinuxSystemInterfaceUnittest, TestGetProcessOpenFilesOnce);
 UNIT_TEST_CASE(LinuxSystemInterfaceUnittest, TestGetProcessOpenFilesOncePermissionDenied);
@@ -0,0 +1,120 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "common/Flags.h"
+#include "common/StringTools.h"
+#include "host_monitor/Constants.h"
+#include "host_monitor/LinuxSystemInterface.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_INT32(process_collect_silent_count);
+
+using namespace std;
+
+namespace logtail {
+
+// Compares reading stat of all processes one by one, as collectors did, with taking one snapshot, on a fake
+// /proc tree with as many processes as a busy host.
+class ProcessSnapshotBenchmark : public ::testing::Test {
+public:
+    void TestPerProcessRead();
+    void TestSnapshot();
+
+protected:
+    static void SetUpTestCase() {
+        sProcDir = filesystem::temp_directory_path() / ("process_snapshot_benchmark_" + to_string(getpid()));
+        filesystem::create_directories(sProcDir);
+        for (size_t pid = 1; pid <= kProcessCnt; ++pid) {
+            auto dir = sProcDir / to_string(pid);
+            filesystem::create_directories(dir);
+            ofstream stat(dir / "stat", ios::trunc);
+            stat << pid
+                 << " (ilogtail) S 1811 1811 1811 0 -1 1077936192 1378102 0 848 0 643169 334268 0 0 20 0 55 0 1304 "
+                    "1707982848 46314 18446744073709551615 4227072 53627809 140730946407792 0 0 0 65536 0 4281570 0 "
+                    "0 0 17 26 0 0 24 0 0 66246848 67456896 101158912 140730946416312 140730946416341 "
+                    "140730946416341 140730946416603 0";
+        }
+        // files in /proc which are not processes
+        ofstream(sProcDir / "stat") << "btime 1731142542\n";
+        ofstream(sProcDir / "meminfo") << "MemTotal:       31534908 kB\n";
+        PROCESS_DIR = sProcDir;
+        // the cost of reads only, without the sleeps between them
+        INT32_FLAG(process_collect_silent_count) = kProcessCnt;
+    }
+
+    static void TearDownTestCase() {
+        filesystem::remove_all(sProcDir);
+        PROCESS_DIR = "/proc";
+    }
+
+    static constexpr size_t kProcessCnt = 5000;
+    static constexpr size_t kRoundCnt = 20;
+
+    static filesystem::path sProcDir;
+};
+
+filesystem::path ProcessSnapshotBenchmark::sProcDir;
+
+void ProcessSnapshotBenchmark::TestPerProcessRead() {
+    auto* systemInterface = LinuxSystemInterface::GetInstance();
+    auto start = chrono::steady_clock::now();
+    for (size_t round = 0; round < kRoundCnt; ++round) {
+        // GetProcessListInformationOnce sleeps per entry in unit tests, so the listing is done here the same way
+        vector<pid_t> pids;
+        for (const auto& entry : filesystem::directory_iterator(PROCESS_DIR)) {
+            pid_t pid{};
+            auto name = entry.path().filename().string();
+            if (IsInt(name) && StringTo(name, pid)) {
+                pids.push_back(pid);
+            }
+        }
+        size_t cnt = 0;
+        for (auto pid : pids) {
+            ProcessInformation processInfo;
+            if (systemInterface->GetProcessInformationOnce(pid, processInfo)) {
+                ++cnt;
+            }
+        }
+        APSARA_TEST_EQUAL(kProcessCnt, cnt);
+    }
+    auto cost = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+    cout << "[per process read] processes: " << kProcessCnt << "\trounds: " << kRoundCnt << "\tcost: " << cost << "ms"
+         << endl;
+}
+
+void ProcessSnapshotBenchmark::TestSnapshot() {
+    auto* systemInterface = LinuxSystemInterface::GetInstance();
+    auto start = chrono::steady_clock::now();
+    for (size_t round = 0; round < kRoundCnt; ++round) {
+        ProcessSnapshot snapshot;
+        APSARA_TEST_TRUE(systemInterface->GetProcessSnapshotOnce(snapshot));
+        APSARA_TEST_EQUAL(kProcessCnt, snapshot.processes.size());
+    }
+    auto cost = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+    cout << "[snapshot] processes: " << kProcessCnt << "\trounds: " << kRoundCnt << "\tcost: " << cost << "ms" << endl;
+}
+
+UNIT_TEST_CASE(ProcessSnapshotBenchmark, TestPerProcessRead);
+UNIT_TEST_CASE(ProcessSnapshotBenchmark, TestSnapshot);
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -37,6 +37,7 @@ public:
     void TestSystemInterfaceCache() const;
     void TestSystemInterfaceCacheGC() const;
     void TestMemoizedCall() const;
+    void TestGetProcessSnapshot() const;
 };
 
 void SystemInterfaceUnittest::TestSystemInterfaceCache() const {
@@ -388,9 +389,32 @@ void SystemInterfaceUnittest::TestMemoizedCall() const {
     INT32_FLAG(system_interface_cache_max_cleanup_batch_size) = defaultMaxCleanupBatchSize;
 }
 
+void SystemInterfaceUnittest::TestGetProcessSnapshot() const {
+    MockSystemInterface mockSystemInterface;
+    // the scan of the fallback snapshot blocks in listing processes
+    mockSystemInterface.mBlockTime = 200;
+    mockSystemInterface.mMockCalledCount = 0;
+    auto now = time(nullptr);
+    shared_ptr<const ProcessSnapshot> snapshot1;
+    shared_ptr<const ProcessSnapshot> snapshot2;
+    auto future1 = async(launch::async, [&]() { return mockSystemInterface.GetProcessSnapshot(now, snapshot1); });
+    this_thread::sleep_for(chrono::milliseconds{50});
+    // the mutex is not held during the scan
+    APSARA_TEST_TRUE_FATAL(mockSystemInterface.mProcessSnapshotMutex.try_lock());
+    mockSystemInterface.mProcessSnapshotMutex.unlock();
+    // callers of the same tick wait for the snapshot being built instead of scanning again
+    auto future2 = async(launch::async, [&]() { return mockSystemInterface.GetProcessSnapshot(now, snapshot2); });
+    APSARA_TEST_TRUE(future1.get());
+    APSARA_TEST_TRUE(future2.get());
+    APSARA_TEST_EQUAL(1, mockSystemInterface.mMockCalledCount);
+    APSARA_TEST_NOT_EQUAL(nullptr, snapshot1);
+    APSARA_TEST_EQUAL(snapshot1, snapshot2);
+}
+
 UNIT_TEST_CASE(SystemInterfaceUnittest, TestSystemInterfaceCache);
 UNIT_TEST_CASE(SystemInterfaceUnittest, TestSystemInterfaceCacheGC);
 UNIT_TEST_CASE(SystemInterfaceUnittest, TestMemoizedCall);
+UNIT_TEST_CASE(SystemInterfaceUnittest, TestGetProcessSnapshot);
 
 } // namespace logtail
 
@@ -0,0 +1,122 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "constants/Constants.h"
+#include "models/PipelineEventGroup.h"
+#include "protobuf/sls/sls_logs.pb.h"
+#include "runner/ProcessorRunner.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class GoPipelineSerializeBenchmark : public ::testing::Test {
+public:
+    void TestSerializeThroughput();
+
+private:
+    static PipelineEventGroup makeGroup(size_t eventCnt, size_t fieldCnt, size_t valueSize);
+    // the way ProcessorRunner used to serialize event groups for Go pipelines
+    static string serializeByProtobuf(const PipelineEventGroup& group, const string& logstore);
+};
+
+PipelineEventGroup GoPipelineSerializeBenchmark::makeGroup(size_t eventCnt, size_t fieldCnt, size_t valueSize) {
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    group.SetTag(LOG_RESERVED_KEY_TOPIC, "topic");
+    group.SetTag(string("__hostname__"), string("host"));
+    string value(valueSize, 'v');
+    for (size_t i = 0; i < eventCnt; ++i) {
+        auto* e = group.AddLogEvent();
+        e->SetTimestamp(1700000000 + i, 123456789);
+        for (size_t j = 0; j < fieldCnt; ++j) {
+            e->SetContent("key_" + to_string(j), value);
+        }
+    }
+    return group;
+}
+
+string GoPipelineSerializeBenchmark::serializeByProtobuf(const PipelineEventGroup& group, const string& logstore) {
+    sls_logs::LogGroup logGroup;
+    for (const auto& e : group.GetEvents()) {
+        const auto& logEvent = e.Cast<LogEvent>();
+        auto log = logGroup.add_logs();
+        for (const auto& kv : logEvent) {
+            auto contPtr = log->add_contents();
+            contPtr->set_key(kv.first.to_string());
+            contPtr->set_value(kv.second.to_string());
+        }
+        log->set_time(logEvent.GetTimestamp());
+        if (logEvent.GetTimestampNanosecond()) {
+            log->set_time_ns(logEvent.GetTimestampNanosecond().value());
+        }
+    }
+    for (const auto& tag : group.GetTags()) {
+        if (tag.first == LOG_RESERVED_KEY_TOPIC) {
+            logGroup.set_topic(tag.second.to_string());
+        } else {
+            auto logTag = logGroup.add_logtags();
+            logTag->set_key(tag.first.to_string());
+            logTag->set_value(tag.second.to_string());
+        }
+    }
+    logGroup.set_category(logstore);
+    return logGroup.SerializeAsString();
+}
+
+void GoPipelineSerializeBenchmark::TestSerializeThroughput() {
+    const string logstore = "logstore";
+    const size_t rounds = 100;
+    for (size_t fieldCnt : {5, 20, 50}) {
+        for (size_t valueSize : {16, 256}) {
+            auto group = makeGroup(1000, fieldCnt, valueSize);
+
+            string expected = serializeByProtobuf(group, logstore);
+            string res, errorMsg;
+            APSARA_TEST_TRUE(ProcessorRunner::GetInstance()->Serialize(group, true, logstore, res, errorMsg));
+            sls_logs::LogGroup expectedPb, resPb;
+            APSARA_TEST_TRUE(expectedPb.ParseFromString(expected));
+            APSARA_TEST_TRUE(resPb.ParseFromString(res));
+            APSARA_TEST_EQUAL(expectedPb.DebugString(), resPb.DebugString());
+
+            auto start = chrono::steady_clock::now();
+            for (size_t i = 0; i < rounds; ++i) {
+                expected = serializeByProtobuf(group, logstore);
+            }
+            chrono::duration<double> protobufElapsed = chrono::steady_clock::now() - start;
+
+            start = chrono::steady_clock::now();
+            for (size_t i = 0; i < rounds; ++i) {
+                ProcessorRunner::GetInstance()->Serialize(group, true, logstore, res, errorMsg);
+            }
+            chrono::duration<double> directElapsed = chrono::steady_clock::now() - start;
+
+            double mb = static_cast<double>(res.size() * rounds) / 1024 / 1024;
+            cout << "fields: " << setw(2) << fieldCnt << "\tvalue size: " << setw(3) << valueSize
+                 << "\tprotobuf: " << fixed << setprecision(1) << mb / protobufElapsed.count() << " MB/s"
+                 << "\tdirect: " << mb / directElapsed.count() << " MB/s" << endl;
+        }
+    }
+}
+
+UNIT_TEST_CASE(GoPipelineSerializeBenchmark, TestSerializeThroughput)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
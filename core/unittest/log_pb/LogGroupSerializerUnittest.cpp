@@ -23,6 +23,7 @@ namespace logtail {
 class LogGroupSerializerUnittest : public ::testing::Test {
 public:
     void TestSerialize();
+    void TestSerializeCategory();
 };
 
 void LogGroupSerializerUnittest::TestSerialize() {
@@ -96,7 +97,32 @@ void LogGroupSerializerUnittest::TestSerialize() {
     APSARA_TEST_EQUAL("value_6", logGroupPb.logtags(1).value());
 }
 
+void LogGroupSerializerUnittest::TestSerializeCategory() {
+    size_t groupSZ = 0;
+    size_t logSZ = 0;
+    groupSZ += GetLogSize(GetLogContentSize(strlen("key_1"), strlen("value_1")), false, logSZ);
+    groupSZ += GetStringSize(strlen("logstore"));
+    groupSZ += GetStringSize(strlen("topic"));
+
+    LogGroupSerializer logGroup;
+    logGroup.Prepare(groupSZ);
+    logGroup.StartToAddLog(logSZ);
+    logGroup.AddLogTime(1234567890);
+    logGroup.AddLogContent("key_1", "value_1");
+    logGroup.AddCategory("logstore");
+    logGroup.AddTopic("topic");
+    APSARA_TEST_EQUAL(groupSZ, logGroup.GetResult().size());
+
+    sls_logs::LogGroup logGroupPb;
+    APSARA_TEST_TRUE(logGroupPb.ParseFromString(logGroup.GetResult()));
+    APSARA_TEST_EQUAL(1L, logGroupPb.logs_size());
+    APSARA_TEST_TRUE(logGroupPb.has_category());
+    APSARA_TEST_EQUAL("logstore", logGroupPb.category());
+    APSARA_TEST_EQUAL("topic", logGroupPb.topic());
+}
+
 UNIT_TEST_CASE(LogGroupSerializerUnittest, TestSerialize)
+UNIT_TEST_CASE(LogGroupSerializerUnittest, TestSerializeCategory)
 
 } // namespace logtail
 
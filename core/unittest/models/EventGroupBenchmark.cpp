@@ -14,6 +14,11 @@
 
 #include <cstdlib>
 
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/Flags.h"
 #include "common/JsonUtil.h"
 #include "common/TimeUtil.h"
 #include "models/LogEvent.h"
@@ -29,12 +34,17 @@ void* __wrap_memcpy(void* dest, const void* src, size_t n) {
 }
 #endif
 
+DECLARE_FLAG_INT32(log_event_content_index_threshold);
+DECLARE_FLAG_BOOL(enable_source_buffer_chunk_pool);
+
 namespace logtail {
 
 class EventGroupBenchmark {
 public:
     void TestEraseInLoop();
     void TestWriteIndexInLoop();
+    void TestContentAccessByFieldCount();
+    void TestGroupCreateDestroy();
 };
 
 void EraseInLoop(PipelineEventGroup& logGroup) {
@@ -102,12 +112,108 @@ void EventGroupBenchmark::TestWriteIndexInLoop() {
     printf("%s costs %lums\n", __func__, timeelapsed);
 }
 
+void EventGroupBenchmark::TestContentAccessByFieldCount() {
+    const int eventCnt = 10000;
+    int defaultThreshold = INT32_FLAG(log_event_content_index_threshold);
+    for (size_t fieldCnt : {4, 16, 64, 256}) {
+        std::vector<std::string> keys;
+        std::vector<std::string> values;
+        for (size_t i = 0; i < fieldCnt; ++i) {
+            keys.emplace_back("field_key_" + std::to_string(i));
+            values.emplace_back("field_value_" + std::to_string(i));
+        }
+        for (int threshold : {0, defaultThreshold}) {
+            INT32_FLAG(log_event_content_index_threshold) = threshold;
+            PipelineEventGroup group(std::make_shared<SourceBuffer>());
+            for (int i = 0; i < eventCnt; ++i) {
+                group.AddLogEvent();
+            }
+            // set every field, then overwrite every field, as parsers and desensitizers do
+            uint64_t starttime = GetCurrentTimeInMicroSeconds();
+            for (auto& e : group.MutableEvents()) {
+                auto& event = e.Cast<LogEvent>();
+                for (size_t i = 0; i < fieldCnt; ++i) {
+                    event.SetContentNoCopy(StringView(keys[i]), StringView(values[i]));
+                }
+                for (size_t i = 0; i < fieldCnt; ++i) {
+                    event.SetContentNoCopy(StringView(keys[i]), StringView(values[fieldCnt - 1 - i]));
+                }
+            }
+            uint64_t setElapsed = GetCurrentTimeInMicroSeconds() - starttime;
+
+            size_t found = 0;
+            starttime = GetCurrentTimeInMicroSeconds();
+            for (const auto& e : group.GetEvents()) {
+                const auto& event = e.Cast<LogEvent>();
+                for (size_t i = 0; i < fieldCnt; ++i) {
+                    found += event.GetContent(StringView(keys[i])).size();
+                }
+            }
+            uint64_t getElapsed = GetCurrentTimeInMicroSeconds() - starttime;
+            printf("%s fields: %zu\tindex threshold: %d\tset costs %.1fns/field\tget costs %.1fns/field\t(%zu)\n",
+                   __func__,
+                   fieldCnt,
+                   threshold,
+                   setElapsed * 1000.0 / (eventCnt * fieldCnt * 2),
+                   getElapsed * 1000.0 / (eventCnt * fieldCnt),
+                   found);
+        }
+    }
+    INT32_FLAG(log_event_content_index_threshold) = defaultThreshold;
+}
+
+void EventGroupBenchmark::TestGroupCreateDestroy() {
+    const int groupCnt = 200000;
+    const std::string content(200, 'a');
+    for (bool enablePool : {false, true}) {
+        BOOL_FLAG(enable_source_buffer_chunk_pool) = enablePool;
+        // groups are created by an input thread and destroyed by a flusher thread in production
+        for (bool crossThread : {false, true}) {
+            uint64_t starttime = GetCurrentTimeInMicroSeconds();
+            if (crossThread) {
+                std::vector<PipelineEventGroup> groups;
+                std::thread producer([&]() {
+                    for (int i = 0; i < groupCnt; ++i) {
+                        PipelineEventGroup group(std::make_shared<SourceBuffer>());
+                        // spill into a second chunk, as a typical file read does
+                        for (int j = 0; j < 30; ++j) {
+                            group.AddLogEvent()->SetContent(std::string("content"), content);
+                        }
+                        groups.emplace_back(std::move(group));
+                        if (groups.size() == 1000) {
+                            std::thread([g = std::move(groups)]() mutable { g.clear(); }).join();
+                            groups.clear();
+                        }
+                    }
+                });
+                producer.join();
+            } else {
+                for (int i = 0; i < groupCnt; ++i) {
+                    PipelineEventGroup group(std::make_shared<SourceBuffer>());
+                    for (int j = 0; j < 30; ++j) {
+                        group.AddLogEvent()->SetContent(std::string("content"), content);
+                    }
+                }
+            }
+            uint64_t timeelapsed = GetCurrentTimeInMicroSeconds() - starttime;
+            printf("%s chunk pool: %d\tcross thread: %d\tthroughput: %.0f groups/s\n",
+                   __func__,
+                   enablePool,
+                   crossThread,
+                   groupCnt * 1000000.0 / timeelapsed);
+        }
+    }
+    BOOL_FLAG(enable_source_buffer_chunk_pool) = true;
+}
+
 } // namespace logtail
 
 int main(int argc, char* argv[]) {
     logtail::EventGroupBenchmark benchmark;
     benchmark.TestEraseInLoop();
     benchmark.TestWriteIndexInLoop();
+    benchmark.TestContentAccessByFieldCount();
+    benchmark.TestGroupCreateDestroy();
     /* Result:
        TestEraseInLoop costs 453ms
        TestWriteIndexInLoop costs 22ms
@@ -19,6 +19,7 @@
 #include "unittest/Unittest.h"
 
 DECLARE_FLAG_INT32(default_log_event_capacity);
+DECLARE_FLAG_INT32(log_event_content_index_threshold);
 
 using namespace std;
 
@@ -31,6 +32,7 @@ public:
     void TestDelContent();
     void TestReadContentOp();
     void TestIterateContent();
+    void TestContentIndex();
     void TestMeta();
     void TestSize();
     void TestReset();
@@ -182,6 +184,54 @@ void LogEventUnittest::TestSize() {
     APSARA_TEST_EQUAL(basicSize, mLogEvent->DataSize());
 }
 
+void LogEventUnittest::TestContentIndex() {
+    size_t threshold = INT32_FLAG(log_event_content_index_threshold);
+    APSARA_TEST_TRUE(threshold > 0);
+    for (size_t i = 0; i + 1 < threshold; ++i) {
+        mLogEvent->SetContent("key" + to_string(i), "value" + to_string(i));
+    }
+    APSARA_TEST_TRUE(mLogEvent->mContentIndex.empty());
+    for (size_t i = threshold - 1; i < 100; ++i) {
+        mLogEvent->SetContent("key" + to_string(i), "value" + to_string(i));
+    }
+    APSARA_TEST_FALSE(mLogEvent->mContentIndex.empty());
+    APSARA_TEST_EQUAL(100U, mLogEvent->mContentIndexSize);
+
+    // overwrite, delete and re-add
+    mLogEvent->SetContent(string("key10"), string("new_value10"));
+    mLogEvent->DelContent(string("key20"));
+    mLogEvent->DelContent(string("key30"));
+    mLogEvent->SetContent(string("key30"), string("new_value30"));
+    APSARA_TEST_EQUAL(99U, mLogEvent->Size());
+    APSARA_TEST_EQUAL("new_value10", mLogEvent->GetContent("key10").to_string());
+    APSARA_TEST_FALSE(mLogEvent->HasContent("key20"));
+    APSARA_TEST_TRUE(mLogEvent->FindContent("key20") == mLogEvent->end());
+    APSARA_TEST_EQUAL("new_value30", mLogEvent->GetContent("key30").to_string());
+    APSARA_TEST_EQUAL("value99", mLogEvent->FindContent("key99")->second.to_string());
+
+    // original order is kept
+    vector<string> keys;
+    for (const auto& content : *mLogEvent) {
+        keys.emplace_back(content.first.to_string());
+    }
+    APSARA_TEST_EQUAL(99U, keys.size());
+    APSARA_TEST_EQUAL("key0", keys[0]);
+    APSARA_TEST_EQUAL("key10", keys[10]);
+    APSARA_TEST_EQUAL("key21", keys[20]);
+    APSARA_TEST_EQUAL("key30", keys[98]);
+
+    // duplicate keys appended, the latest one is visible
+    mLogEvent->AppendContentNoCopy(StringView("key50"), StringView("dup_value50"));
+    APSARA_TEST_EQUAL("dup_value50", mLogEvent->GetContent("key50").to_string());
+    mLogEvent->DelContent(string("key50"));
+    APSARA_TEST_EQUAL("value50", mLogEvent->GetContent("key50").to_string());
+
+    mLogEvent->Reset();
+    APSARA_TEST_TRUE(mLogEvent->mContentIndex.empty());
+    APSARA_TEST_EQUAL(0U, mLogEvent->mContentIndexSize);
+    APSARA_TEST_FALSE(mLogEvent->HasContent("key0"));
+}
+
 void LogEventUnittest::TestReset() {
     mLogEvent->SetTimestamp(12345678901);
     mLogEvent->SetContent(string("key1"), string("value1"));
@@ -240,6 +290,7 @@ UNIT_TEST_CASE(LogEventUnittest, TestSetContent)
 UNIT_TEST_CASE(LogEventUnittest, TestDelContent)
 UNIT_TEST_CASE(LogEventUnittest, TestReadContentOp)
 UNIT_TEST_CASE(LogEventUnittest, TestIterateContent)
+UNIT_TEST_CASE(LogEventUnittest, TestContentIndex)
 UNIT_TEST_CASE(LogEventUnittest, TestMeta)
 UNIT_TEST_CASE(LogEventUnittest, TestSize)
 UNIT_TEST_CASE(LogEventUnittest, TestReset)
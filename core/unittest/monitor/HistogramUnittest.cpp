@@ -0,0 +1,144 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "monitor/metric_models/MetricRecord.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class HistogramUnittest : public ::testing::Test {
+public:
+    void TestBucketIndex();
+    void TestQuantile();
+    void TestCollect();
+    void TestConcurrentObserve();
+    void TestCreateAfterCommitted();
+};
+
+void HistogramUnittest::TestBucketIndex() {
+    for (uint64_t us = 0; us < Histogram::kSubBucketCnt; ++us) {
+        APSARA_TEST_EQUAL(us, Histogram::GetBucketIndex(us));
+    }
+    // each value falls into the bucket whose bounds cover it, and buckets are contiguous
+    size_t lastIdx = 0;
+    for (uint64_t us = 1; us < (1ULL << 40); us = us * 3 / 2 + 1) {
+        auto idx = Histogram::GetBucketIndex(us);
+        APSARA_TEST_TRUE(idx >= lastIdx);
+        APSARA_TEST_TRUE(idx < Histogram::kBucketCnt);
+        if (idx + 1 < Histogram::kBucketCnt) {
+            APSARA_TEST_TRUE(Histogram::GetBucketLowerBound(idx) <= us);
+            APSARA_TEST_TRUE(us < Histogram::GetBucketLowerBound(idx + 1));
+        }
+        lastIdx = idx;
+    }
+    for (size_t idx = 0; idx + 1 < Histogram::kBucketCnt; ++idx) {
+        APSARA_TEST_EQUAL(idx, Histogram::GetBucketIndex(Histogram::GetBucketLowerBound(idx)));
+        APSARA_TEST_EQUAL(idx, Histogram::GetBucketIndex(Histogram::GetBucketLowerBound(idx + 1) - 1));
+    }
+    // too large values fall into the last bucket
+    APSARA_TEST_EQUAL(Histogram::kBucketCnt - 1, Histogram::GetBucketIndex(UINT64_MAX));
+}
+
+void HistogramUnittest::TestQuantile() {
+    Histogram histogram("test");
+    APSARA_TEST_EQUAL(0.0, Histogram::GetQuantile(histogram.GetBuckets(), 0.99));
+
+    for (int i = 1; i <= 10000; ++i) {
+        histogram.Observe(chrono::microseconds(i * 100));
+    }
+    auto buckets = histogram.GetBuckets();
+    for (double q : {0.5, 0.9, 0.99}) {
+        double expected = q * 10000 * 100 / 1000;
+        double res = Histogram::GetQuantile(buckets, q);
+        APSARA_TEST_TRUE(res >= expected * 0.875);
+        APSARA_TEST_TRUE(res <= expected * 1.125);
+    }
+    APSARA_TEST_TRUE(Histogram::GetQuantile(buckets, 1.0) >= 1000);
+    APSARA_TEST_EQUAL(10000ULL * 10001 / 2 * 100, histogram.GetSum());
+    APSARA_TEST_EQUAL(1000000U, histogram.GetMax());
+
+    // negative values are taken as 0
+    Histogram negative("negative");
+    negative.Observe(chrono::nanoseconds(-1));
+    APSARA_TEST_EQUAL(1U, negative.GetBuckets()[0]);
+}
+
+void HistogramUnittest::TestCollect() {
+    Histogram histogram("test");
+    histogram.Observe(chrono::milliseconds(5));
+    histogram.Observe(chrono::microseconds(5001));
+    unique_ptr<Histogram> collected(histogram.Collect());
+    APSARA_TEST_EQUAL("test", collected->GetName());
+    APSARA_TEST_EQUAL(2U, collected->GetBuckets()[Histogram::GetBucketIndex(5000)]);
+    APSARA_TEST_EQUAL(10001U, collected->GetSum());
+    APSARA_TEST_EQUAL(5001U, collected->GetMax());
+    for (auto cnt : histogram.GetBuckets()) {
+        APSARA_TEST_EQUAL(0U, cnt);
+    }
+    APSARA_TEST_EQUAL(0U, histogram.GetSum());
+    APSARA_TEST_EQUAL(0U, histogram.GetMax());
+}
+
+void HistogramUnittest::TestConcurrentObserve() {
+    MetricsRecord record(MetricCategory::METRIC_CATEGORY_RUNNER, make_shared<MetricLabels>());
+    HistogramPtr histogram = record.CreateHistogram("test");
+    APSARA_TEST_EQUAL(1U, record.GetHistograms().size());
+
+    const size_t threadCnt = 4;
+    const size_t cnt = 100000;
+    vector<thread> threads;
+    for (size_t t = 0; t < threadCnt; ++t) {
+        threads.emplace_back([&histogram, t]() {
+            for (size_t i = 0; i < cnt; ++i) {
+                OBSERVE_HISTOGRAM(histogram, chrono::microseconds(t * 1000 + i % 1000));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    unique_ptr<MetricsRecord> collected(record.Collect());
+    uint64_t total = 0;
+    for (auto cnt : collected->GetHistograms()[0]->GetBuckets()) {
+        total += cnt;
+    }
+    APSARA_TEST_EQUAL(threadCnt * cnt, total);
+    APSARA_TEST_EQUAL((threadCnt - 1) * 1000 + 999, collected->GetHistograms()[0]->GetMax());
+}
+
+void HistogramUnittest::TestCreateAfterCommitted() {
+    MetricsRecord record(MetricCategory::METRIC_CATEGORY_RUNNER, make_shared<MetricLabels>());
+    record.MarkCommitted();
+    HistogramPtr histogram = record.CreateHistogram("test");
+    APSARA_TEST_EQUAL(nullptr, histogram);
+    // no-op on null
+    OBSERVE_HISTOGRAM(histogram, chrono::milliseconds(1));
+}
+
+UNIT_TEST_CASE(HistogramUnittest, TestBucketIndex)
+UNIT_TEST_CASE(HistogramUnittest, TestQuantile)
+UNIT_TEST_CASE(HistogramUnittest, TestCollect)
+UNIT_TEST_CASE(HistogramUnittest, TestConcurrentObserve)
+UNIT_TEST_CASE(HistogramUnittest, TestCreateAfterCommitted)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
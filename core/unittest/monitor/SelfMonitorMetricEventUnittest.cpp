@@ -31,6 +31,7 @@ public:
     void TestMerge();
     void TestSendInterval();
     void TestGlobalMetrics();
+    void TestHistogram();
 
 private:
     std::shared_ptr<SourceBuffer> mSourceBuffer;
@@ -43,6 +44,7 @@ APSARA_UNIT_TEST_CASE(SelfMonitorMetricEventUnittest, TestCreateFromGoMetricMap,
 APSARA_UNIT_TEST_CASE(SelfMonitorMetricEventUnittest, TestMerge, 2);
 APSARA_UNIT_TEST_CASE(SelfMonitorMetricEventUnittest, TestSendInterval, 3);
 APSARA_UNIT_TEST_CASE(SelfMonitorMetricEventUnittest, TestGlobalMetrics, 4);
+APSARA_UNIT_TEST_CASE(SelfMonitorMetricEventUnittest, TestHistogram, 5);
 
 void SelfMonitorMetricEventUnittest::TestCreateFromMetricEvent() {
     std::vector<std::pair<std::string, std::string>> labels;
@@ -256,6 +258,67 @@ void SelfMonitorMetricEventUnittest::TestGlobalMetrics() {
     }
 }
 
+void SelfMonitorMetricEventUnittest::TestHistogram() {
+    MetricsRecord* runnerMetric
+        = new MetricsRecord(MetricCategory::METRIC_CATEGORY_RUNNER,
+                            std::make_shared<MetricLabels>(MetricLabels{{"runner_name", "processor_runner"}}),
+                            std::make_shared<DynamicMetricLabels>());
+    HistogramPtr processTimeMs = runnerMetric->CreateHistogram("process_time_ms");
+    for (int i = 1; i <= 100; ++i) {
+        OBSERVE_HISTOGRAM(processTimeMs, std::chrono::milliseconds(i));
+    }
+    std::unique_ptr<MetricsRecord> collected(runnerMetric->Collect());
+    SelfMonitorMetricEvent event1(collected.get());
+    APSARA_TEST_EQUAL(1U, event1.mHistograms.size());
+
+    for (int i = 1; i <= 100; ++i) {
+        OBSERVE_HISTOGRAM(processTimeMs, std::chrono::milliseconds(i));
+    }
+    collected.reset(runnerMetric->Collect());
+    SelfMonitorMetricEvent event2(collected.get());
+    event1.Merge(event2);
+
+    mSourceBuffer.reset(new SourceBuffer);
+    mEventGroup.reset(new PipelineEventGroup(mSourceBuffer));
+    mMetricEvent = mEventGroup->CreateMetricEvent();
+    event1.ReadAsMetricEvent(mMetricEvent.get());
+    const auto* values = mMetricEvent->GetValue<UntypedMultiDoubleValues>();
+    UntypedMultiDoubleValue value;
+    APSARA_TEST_TRUE(values->GetValue("process_time_ms_count", value));
+    APSARA_TEST_EQUAL(UntypedValueMetricType::MetricTypeCounter, value.MetricType);
+    APSARA_TEST_EQUAL(200.0, value.Value);
+    // quantiles are within the relative error of the buckets
+    APSARA_TEST_TRUE(values->GetValue("process_time_ms_p50", value));
+    APSARA_TEST_EQUAL(UntypedValueMetricType::MetricTypeGauge, value.MetricType);
+    APSARA_TEST_TRUE(value.Value >= 50 * 0.875 && value.Value <= 50 * 1.125);
+    APSARA_TEST_TRUE(values->GetValue("process_time_ms_p90", value));
+    APSARA_TEST_TRUE(value.Value >= 90 * 0.875 && value.Value <= 90 * 1.125);
+    APSARA_TEST_TRUE(values->GetValue("process_time_ms_p99", value));
+    APSARA_TEST_TRUE(value.Value >= 99 * 0.875 && value.Value <= 99 * 1.125);
+    // sum is exact as well, in milliseconds
+    APSARA_TEST_TRUE(values->GetValue("process_time_ms_sum", value));
+    APSARA_TEST_EQUAL(UntypedValueMetricType::MetricTypeCounter, value.MetricType);
+    APSARA_TEST_EQUAL(2 * 5050.0, value.Value);
+    // max is exact rather than the bound of its bucket
+    APSARA_TEST_TRUE(values->GetValue("process_time_ms_max", value));
+    APSARA_TEST_EQUAL(100.0, value.Value);
+
+    // reset after read
+    mMetricEvent = mEventGroup->CreateMetricEvent();
+    event1.ReadAsMetricEvent(mMetricEvent.get());
+    values = mMetricEvent->GetValue<UntypedMultiDoubleValues>();
+    APSARA_TEST_TRUE(values->GetValue("process_time_ms_count", value));
+    APSARA_TEST_EQUAL(0.0, value.Value);
+    APSARA_TEST_TRUE(values->GetValue("process_time_ms_p99", value));
+    APSARA_TEST_EQUAL(0.0, value.Value);
+    APSARA_TEST_TRUE(values->GetValue("process_time_ms_sum", value));
+    APSARA_TEST_EQUAL(0.0, value.Value);
+    APSARA_TEST_TRUE(values->GetValue("process_time_ms_max", value));
+    APSARA_TEST_EQUAL(0.0, value.Value);
+
+    delete runnerMetric;
+}
+
 } // namespace logtail
 
 int main(int argc, char** argv) {
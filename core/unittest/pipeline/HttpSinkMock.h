@@ -94,6 +94,7 @@ private:
     HttpSinkMock() = default;
     ~HttpSinkMock() = default;
 
+    std::future<void> mThreadRes;
     std::atomic_bool mIsFlush = false;
     mutable std::mutex mMutex;
     std::vector<SenderQueueItem> mRequests;
@@ -215,7 +215,7 @@ private:
         {
             auto manager = ProcessQueueManager::GetInstance();
             manager->CreateOrUpdateCountBoundedQueue(key, 0, CollectionPipelineContext{});
-            lock_guard<mutex> lock(manager->mQueueMux);
+            lock_guard<shared_mutex> lock(manager->mQueueMux);
             auto iter = manager->mQueues.find(key);
             APSARA_TEST_NOT_EQUAL(iter, manager->mQueues.end());
             static_cast<CountBoundedProcessQueue*>((*iter->second.first).get())->mValidToPush = true;
@@ -0,0 +1,93 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <iostream>
+
+#include "collection_pipeline/plugin/instance/ProcessorInstance.h"
+#include "plugin/processor/ProcessorDesensitizeNative.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class ProcessorDesensitizeNativeBenchmark : public ::testing::Test {
+public:
+    void SetUp() override { mContext.SetConfigName("project##config_0"); }
+
+    void TestHitRatio();
+
+private:
+    CollectionPipelineContext mContext;
+};
+
+void ProcessorDesensitizeNativeBenchmark::TestHitRatio() {
+    const size_t valueCnt = 10000;
+    const size_t roundCnt = 10;
+
+    Json::Value config;
+    config["SourceKey"] = "content";
+    config["Method"] = "const";
+    config["ReplacingString"] = "********";
+    config["ContentPatternBeforeReplacedString"] = "pwd=";
+    config["ReplacedContentPattern"] = "[^,]+";
+    config["ReplacingAll"] = true;
+    ProcessorDesensitizeNative& processor = *(new ProcessorDesensitizeNative);
+    ProcessorInstance processorInstance(&processor, PluginInstance::PluginMeta{"1"});
+    APSARA_TEST_TRUE_FATAL(processorInstance.Init(config, mContext));
+
+    const string missed = "2025-01-01 12:00:00.000 [INFO] [main] request handled, user=admin, cost=12ms, "
+                          "uri=/api/v1/users?page=1&size=20, status=200, client=10.0.0.1";
+    const string hit = "2025-01-01 12:00:00.000 [INFO] [main] user login, user=admin, pwd=123456abc, "
+                       "uri=/api/v1/login, status=200, client=10.0.0.1";
+    for (size_t hitPercent : {0, 1, 10, 50, 100}) {
+        vector<string> values;
+        for (size_t i = 0; i < valueCnt; ++i) {
+            values.push_back(i % 100 < hitPercent ? hit : missed);
+        }
+
+        // the way values were processed before pre-filtering: copy and replace every value
+        size_t changed = 0;
+        auto start = chrono::steady_clock::now();
+        for (size_t round = 0; round < roundCnt; ++round) {
+            for (const auto& value : values) {
+                string res = value;
+                changed += processor.CastOneSensitiveWord(processor.mRules[0], &res);
+            }
+        }
+        chrono::duration<double> regexElapsed = chrono::steady_clock::now() - start;
+
+        size_t prefilteredChanged = 0;
+        start = chrono::steady_clock::now();
+        for (size_t round = 0; round < roundCnt; ++round) {
+            for (const auto& value : values) {
+                string res;
+                prefilteredChanged += processor.CastSensitiveWords(value, res);
+            }
+        }
+        chrono::duration<double> prefilteredElapsed = chrono::steady_clock::now() - start;
+
+        APSARA_TEST_EQUAL(changed, prefilteredChanged);
+        cout << "hit ratio: " << hitPercent << "%, values: " << valueCnt * roundCnt
+             << ", regex elapsed: " << regexElapsed.count()
+             << " seconds, prefiltered elapsed: " << prefilteredElapsed.count() << " seconds" << endl;
+    }
+}
+
+UNIT_TEST_CASE(ProcessorDesensitizeNativeBenchmark, TestHitRatio)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
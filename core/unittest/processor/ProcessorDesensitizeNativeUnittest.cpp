@@ -34,6 +34,8 @@ public:
     void TestCastSensWordMulti();
     void TestMultipleLines();
     void TestMultipleLinesWithProcessorMergeMultilineLogNative();
+    void TestMultipleRules();
+    void TestRuleSetMatchError();
 
     CollectionPipelineContext mContext;
 };
@@ -54,6 +56,10 @@ UNIT_TEST_CASE(ProcessorDesensitizeNativeUnittest, TestMultipleLines);
 
 UNIT_TEST_CASE(ProcessorDesensitizeNativeUnittest, TestMultipleLinesWithProcessorMergeMultilineLogNative);
 
+UNIT_TEST_CASE(ProcessorDesensitizeNativeUnittest, TestMultipleRules);
+
+UNIT_TEST_CASE(ProcessorDesensitizeNativeUnittest, TestRuleSetMatchError);
+
 PluginInstance::PluginMeta getPluginMeta() {
     PluginInstance::PluginMeta pluginMeta{"1"};
     return pluginMeta;
@@ -1522,6 +1528,81 @@ void ProcessorDesensitizeNativeUnittest::TestCastSensWordMulti() {
         APSARA_TEST_STREQ_FATAL(CompactJson(expectJson).c_str(), CompactJson(outJson).c_str());
     }
 }
+void ProcessorDesensitizeNativeUnittest::TestMultipleRules() {
+    Json::Value config = GetCastSensWordConfig("cast1", "const", "***", "pwd=", "[^,]+", true);
+    Json::Value rule;
+    rule["ContentPatternBeforeReplacedString"] = "token:\\s*";
+    rule["ReplacedContentPattern"] = "\\w+";
+    rule["ReplacingString"] = "###";
+    config["Rules"].append(rule);
+    rule.clear();
+    rule["ContentPatternBeforeReplacedString"] = "(?i)card_no=";
+    rule["ReplacedContentPattern"] = "\\d+";
+    config["Rules"].append(rule);
+
+    ProcessorDesensitizeNative& processor = *(new ProcessorDesensitizeNative);
+    ProcessorInstance processorInstance(&processor, getPluginMeta());
+    APSARA_TEST_TRUE_FATAL(processorInstance.Init(config, mContext));
+    APSARA_TEST_EQUAL(3U, processor.mRules.size());
+    APSARA_TEST_TRUE(processor.mRuleSet != nullptr);
+    APSARA_TEST_EQUAL("pwd=", processor.mRules[0].mRequiredLiteral);
+    APSARA_TEST_EQUAL("token:", processor.mRules[1].mRequiredLiteral);
+    APSARA_TEST_EQUAL("", processor.mRules[2].mRequiredLiteral);
+
+    std::vector<std::pair<std::string, std::string>> cases = {
+        {"nothing sensitive", ""},
+        {"pwd is not here, token neither", ""},
+        {"pwd=123,token: abc,CARD_NO=42", "pwd=***,token: ###,CARD_NO=***"},
+        {"token:abc pwd=1", "token:### pwd=***"},
+        {"card_no=1,card_no=2", "card_no=***,card_no=***"},
+    };
+    for (const auto& item : cases) {
+        std::string res;
+        if (item.second.empty()) {
+            APSARA_TEST_FALSE(processor.CastSensitiveWords(item.first, res));
+        } else {
+            APSARA_TEST_TRUE(processor.CastSensitiveWords(item.first, res));
+            APSARA_TEST_EQUAL(item.second, res);
+        }
+    }
+
+    // invalid rules
+    config["Rules"] = "pwd=";
+    ProcessorDesensitizeNative& invalidProcessor = *(new ProcessorDesensitizeNative);
+    ProcessorInstance invalidProcessorInstance(&invalidProcessor, getPluginMeta());
+    APSARA_TEST_FALSE(invalidProcessorInstance.Init(config, mContext));
+    config["Rules"] = Json::Value(Json::arrayValue);
+    rule.clear();
+    rule["ContentPatternBeforeReplacedString"] = "pwd=";
+    rule["ReplacedContentPattern"] = "[";
+    config["Rules"].append(rule);
+    ProcessorDesensitizeNative& invalidRegexProcessor = *(new ProcessorDesensitizeNative);
+    ProcessorInstance invalidRegexProcessorInstance(&invalidRegexProcessor, getPluginMeta());
+    APSARA_TEST_FALSE(invalidRegexProcessorInstance.Init(config, mContext));
+}
+
+void ProcessorDesensitizeNativeUnittest::TestRuleSetMatchError() {
+    Json::Value config = GetCastSensWordConfig("cast1", "const", "***", "pwd=", "[^,]+", true);
+    Json::Value rule;
+    rule["ContentPatternBeforeReplacedString"] = "token:\\s*";
+    rule["ReplacedContentPattern"] = "\\w+";
+    config["Rules"].append(rule);
+
+    ProcessorDesensitizeNative& processor = *(new ProcessorDesensitizeNative);
+    ProcessorInstance processorInstance(&processor, getPluginMeta());
+    APSARA_TEST_TRUE_FATAL(processorInstance.Init(config, mContext));
+    APSARA_TEST_TRUE_FATAL(processor.mRuleSet != nullptr);
+
+    // the candidate rules are applied one by one if the rule set fails to match, e.g. when the DFA runs out of memory
+    processor.mRuleSetMatchErrorForTest = true;
+
+    std::string res;
+    APSARA_TEST_TRUE(processor.CastSensitiveWords("pwd=123,token: abc", res));
+    APSARA_TEST_EQUAL("pwd=***,token: ***", res);
+    // required literals are found, but none of the rules matches
+    APSARA_TEST_FALSE(processor.CastSensitiveWords("pwd=,token: ", res));
+}
+
 } // namespace logtail
 
 UNIT_TEST_MAIN
@@ -0,0 +1,112 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <iostream>
+
+#include "collection_pipeline/plugin/instance/ProcessorInstance.h"
+#include "plugin/processor/ProcessorFilterNative.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class ProcessorFilterNativeBenchmark : public ::testing::Test {
+public:
+    void SetUp() override { mContext.SetConfigName("project##config_0"); }
+
+    void TestConditionExp();
+
+private:
+    // (rule_0 or rule_1 or ... or rule_n-1), rules are spread over 8 keys
+    static Json::Value BuildExpression(size_t ruleCnt);
+
+    CollectionPipelineContext mContext;
+};
+
+Json::Value ProcessorFilterNativeBenchmark::BuildExpression(size_t ruleCnt) {
+    static const vector<string> sTemplates
+        = {"GET /api/v%d/.*", ".*error_%d.*", "\\d+ms_%d", "user_%d@[a-z]+\\.com", "[A-Z]{3}-%d-\\w+"};
+    Json::Value root;
+    for (size_t i = 0; i < ruleCnt; ++i) {
+        char exp[64];
+        snprintf(exp, sizeof(exp), sTemplates[i % sTemplates.size()].c_str(), static_cast<int>(i));
+        Json::Value rule;
+        rule["type"] = "regex";
+        rule["key"] = "key" + to_string(i % 8);
+        rule["exp"] = exp;
+        if (i == 0) {
+            root = rule;
+        } else {
+            Json::Value node;
+            node["operator"] = "or";
+            node["operands"].append(root);
+            node["operands"].append(rule);
+            root = node;
+        }
+    }
+    return root;
+}
+
+void ProcessorFilterNativeBenchmark::TestConditionExp() {
+    const size_t eventCnt = 10000;
+    const size_t roundCnt = 10;
+
+    PipelineEventGroup eventGroup(make_shared<SourceBuffer>());
+    for (size_t i = 0; i < eventCnt; ++i) {
+        auto event = eventGroup.AddLogEvent();
+        for (size_t k = 0; k < 8; ++k) {
+            // mostly unmatched, which is the worst case since all rules have to be checked
+            event->SetContent("key" + to_string(k),
+                              i % 10 == 0 ? "GET /api/v0/index.html" : "POST /api/v1/index.html took 100ms");
+        }
+    }
+
+    for (size_t ruleCnt : {1, 4, 16, 64}) {
+        Json::Value config;
+        config["ConditionExp"] = BuildExpression(ruleCnt);
+        ProcessorFilterNative& processor = *(new ProcessorFilterNative);
+        ProcessorInstance processorInstance(&processor, PluginInstance::PluginMeta{"1"});
+        APSARA_TEST_TRUE_FATAL(processorInstance.Init(config, mContext));
+        APSARA_TEST_TRUE_FATAL(processor.mCompiledFilter != nullptr);
+
+        size_t treeMatched = 0, compiledMatched = 0;
+        auto start = chrono::steady_clock::now();
+        for (size_t round = 0; round < roundCnt; ++round) {
+            for (auto& event : eventGroup.MutableEvents()) {
+                treeMatched += processor.FilterExpressionRoot(event.Cast<LogEvent>(), processor.mConditionExp);
+            }
+        }
+        chrono::duration<double> treeElapsed = chrono::steady_clock::now() - start;
+
+        start = chrono::steady_clock::now();
+        for (size_t round = 0; round < roundCnt; ++round) {
+            for (auto& event : eventGroup.MutableEvents()) {
+                compiledMatched += processor.FilterCompiled(event.Cast<LogEvent>());
+            }
+        }
+        chrono::duration<double> compiledElapsed = chrono::steady_clock::now() - start;
+
+        APSARA_TEST_EQUAL(treeMatched, compiledMatched);
+        cout << "rules: " << ruleCnt << ", events: " << eventCnt * roundCnt << ", tree elapsed: " << treeElapsed.count()
+             << " seconds, compiled elapsed: " << compiledElapsed.count() << " seconds" << endl;
+    }
+}
+
+UNIT_TEST_CASE(ProcessorFilterNativeBenchmark, TestConditionExp)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
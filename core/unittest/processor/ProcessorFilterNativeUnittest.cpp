@@ -31,6 +31,7 @@ public:
     void TestLogFilterRule();
     void TestBaseFilter();
     void TestFilterNoneUtf8();
+    void TestCompiledFilter();
 
     CollectionPipelineContext mContext;
 };
@@ -40,6 +41,7 @@ UNIT_TEST_CASE(ProcessorFilterNativeUnittest, OnFailedInit)
 UNIT_TEST_CASE(ProcessorFilterNativeUnittest, TestLogFilterRule)
 UNIT_TEST_CASE(ProcessorFilterNativeUnittest, TestBaseFilter)
 UNIT_TEST_CASE(ProcessorFilterNativeUnittest, TestFilterNoneUtf8)
+UNIT_TEST_CASE(ProcessorFilterNativeUnittest, TestCompiledFilter)
 
 PluginInstance::PluginMeta getPluginMeta() {
     PluginInstance::PluginMeta pluginMeta{"1"};
@@ -753,6 +755,105 @@ void ProcessorFilterNativeUnittest::TestBaseFilter() {
     }
 }
 
+void ProcessorFilterNativeUnittest::TestCompiledFilter() {
+    // (key1 ~ "abc.*" or key1 ~ "(x)\1" or key1 ~ "\d+ms") and not key2 ~ "\s*debug\s*"
+    const char* jsonStr = R"({
+        "operator": "and",
+        "operands": [
+            {
+                "operator": "or",
+                "operands": [
+                    {
+                        "operator": "or",
+                        "operands": [
+                            {"type": "regex", "key": "key1", "exp": "abc.*"},
+                            {"type": "regex", "key": "key1", "exp": "(x)\\1"}
+                        ]
+                    },
+                    {"type": "regex", "key": "key1", "exp": "\\d+ms"}
+                ]
+            },
+            {
+                "operator": "not",
+                "operands": [
+                    {"type": "regex", "key": "key2", "exp": "\\s*debug\\s*"}
+                ]
+            }
+        ]
+    })";
+    Json::Value config;
+    string errorMsg;
+    APSARA_TEST_TRUE_FATAL(ParseJsonTable(jsonStr, config["ConditionExp"], errorMsg));
+    ProcessorFilterNative& processor = *(new ProcessorFilterNative);
+    ProcessorInstance processorInstance(&processor, getPluginMeta());
+    APSARA_TEST_TRUE_FATAL(processorInstance.Init(config, mContext));
+    APSARA_TEST_TRUE_FATAL(processor.mCompiledFilter != nullptr);
+    APSARA_TEST_EQUAL(4U, processor.mCompiledFilter->GetPatternCnt());
+    APSARA_TEST_EQUAL(2U, processor.mCompiledFilter->GetKeyCnt());
+    // backreference is left to boost
+    APSARA_TEST_EQUAL(3U, processor.mCompiledFilter->GetRE2PatternCnt());
+
+    vector<pair<vector<pair<string, string>>, bool>> cases = {
+        {{{"key1", "abcdef"}}, true},
+        {{{"key1", "abcdef"}, {"key2", "info"}}, true},
+        {{{"key1", "abcdef"}, {"key2", " debug\v"}}, false},
+        {{{"key1", "xx"}, {"key2", "info"}}, true},
+        {{{"key1", "xy"}, {"key2", "info"}}, false},
+        {{{"key1", "100ms"}}, true},
+        {{{"key1", "ab"}}, false},
+        {{{"key2", "info"}}, false},
+    };
+    PipelineEventGroup eventGroup(make_shared<SourceBuffer>());
+    for (const auto& item : cases) {
+        auto event = eventGroup.AddLogEvent();
+        for (const auto& content : item.first) {
+            event->SetContent(content.first, content.second);
+        }
+        APSARA_TEST_EQUAL(item.second, processor.FilterCompiled(*event));
+        APSARA_TEST_EQUAL(item.second, processor.FilterExpressionRoot(*event, processor.mConditionExp));
+    }
+
+    // patterns are matched one by one if the set fails to match, e.g. when the DFA runs out of memory
+    size_t setCnt = 0;
+    for (const auto& key : processor.mCompiledFilter->mKeys) {
+        setCnt += key.mSet != nullptr;
+    }
+    APSARA_TEST_TRUE(setCnt > 0);
+    processor.mCompiledFilter->mSetMatchErrorForTest = true;
+    for (const auto& item : cases) {
+        auto event = eventGroup.AddLogEvent();
+        for (const auto& content : item.first) {
+            event->SetContent(content.first, content.second);
+        }
+        APSARA_TEST_EQUAL(item.second, processor.FilterCompiled(*event));
+    }
+
+    // rule mode
+    config.clear();
+    config["FilterKey"].append("key1");
+    config["FilterKey"].append("key2");
+    config["FilterRegex"].append("abc.*");
+    config["FilterRegex"].append("[^d]+");
+    ProcessorFilterNative& ruleProcessor = *(new ProcessorFilterNative);
+    ProcessorInstance ruleProcessorInstance(&ruleProcessor, getPluginMeta());
+    APSARA_TEST_TRUE_FATAL(ruleProcessorInstance.Init(config, mContext));
+    APSARA_TEST_TRUE_FATAL(ruleProcessor.mCompiledFilter != nullptr);
+    cases = {
+        {{{"key1", "abc"}, {"key2", "info"}}, true},
+        {{{"key1", "abc"}, {"key2", "debug"}}, false},
+        {{{"key1", "xbc"}, {"key2", "info"}}, false},
+        {{{"key1", "abc"}}, false},
+    };
+    for (const auto& item : cases) {
+        auto event = eventGroup.AddLogEvent();
+        for (const auto& content : item.first) {
+            event->SetContent(content.first, content.second);
+        }
+        APSARA_TEST_EQUAL(item.second, ruleProcessor.FilterCompiled(*event));
+        APSARA_TEST_EQUAL(item.second, ruleProcessor.FilterFilterRule(*event, ruleProcessor.mFilterRule.get()));
+    }
+}
+
 static const char UTF8_BYTE_PREFIX = 0x80;
 static const char UTF8_BYTE_MASK = 0xc0;
 
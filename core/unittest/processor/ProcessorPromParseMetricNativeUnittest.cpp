@@ -34,6 +34,7 @@ public:
 
     void TestInit();
     void TestProcess();
+    void TestProcessParsedEvents();
 
     CollectionPipelineContext mContext;
 };
@@ -129,8 +130,32 @@ void ProcessorParsePrometheusMetricUnittest::TestProcess() {
                       eventGroup.GetEvents().at(0).Cast<MetricEvent>().GetTimestamp());
 }
 
+void ProcessorParsePrometheusMetricUnittest::TestProcessParsedEvents() {
+    Json::Value config;
+    string errorMsg;
+    APSARA_TEST_TRUE(ParseJsonTable(R"({"job_name": "test_job"})", config, errorMsg));
+    ProcessorPromParseMetricNative processor;
+    processor.SetContext(mContext);
+    APSARA_TEST_TRUE(processor.Init(config));
+
+    // events parsed by the scraper are kept as they are, along with raw ones
+    PipelineEventGroup eventGroup(std::make_shared<SourceBuffer>());
+    auto* metricEvent = eventGroup.AddMetricEvent();
+    metricEvent->SetName("test_metric1");
+    metricEvent->SetValue<UntypedSingleValue>(1.0);
+    eventGroup.AddRawEvent()->SetContent(string("test_metric2 2.0"));
+    eventGroup.SetMetadata(EventGroupMetaKey::PROMETHEUS_SCRAPE_TIMESTAMP_MILLISEC, string("1715829785083"));
+
+    processor.Process(eventGroup);
+    APSARA_TEST_EQUAL((size_t)2, eventGroup.GetEvents().size());
+    APSARA_TEST_EQUAL("test_metric1", eventGroup.GetEvents().at(0).Cast<MetricEvent>().GetName());
+    APSARA_TEST_EQUAL(1.0, eventGroup.GetEvents().at(0).Cast<MetricEvent>().GetValue<UntypedSingleValue>()->mValue);
+    APSARA_TEST_EQUAL("test_metric2", eventGroup.GetEvents().at(1).Cast<MetricEvent>().GetName());
+}
+
 UNIT_TEST_CASE(ProcessorParsePrometheusMetricUnittest, TestInit)
 UNIT_TEST_CASE(ProcessorParsePrometheusMetricUnittest, TestProcess)
+UNIT_TEST_CASE(ProcessorParsePrometheusMetricUnittest, TestProcessParsedEvents)
 
 } // namespace logtail
 
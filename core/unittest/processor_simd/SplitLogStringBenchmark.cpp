@@ -0,0 +1,147 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "collection_pipeline/plugin/instance/ProcessorInstance.h"
+#include "common/CharSearch.h"
+#include "constants/Constants.h"
+#include "models/LogEvent.h"
+#include "plugin/processor/inner/ProcessorSplitLogStringNative.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+// 512KB, the same as LogFileReader::BUFFER_SIZE
+static constexpr size_t kBufferSize = 1024 * 512;
+
+class SplitLogStringBenchmark : public ::testing::Test {
+public:
+    void TestSplitThroughput();
+    void TestReverseScanThroughput();
+
+protected:
+    void SetUp() override { mContext.SetConfigName("project##config_0"); }
+    void TearDown() override { SetCharSearchImpl(mDefaultImpl); }
+
+private:
+    static string makeBuffer(size_t avgLineLen);
+    double runSplit(const string& buffer, size_t rounds, size_t& lineCnt);
+    static double runReverseScan(const string& buffer, size_t rounds, size_t& lineCnt);
+
+    CollectionPipelineContext mContext;
+    CharSearchImpl mDefaultImpl = GetCharSearchImpl();
+};
+
+string SplitLogStringBenchmark::makeBuffer(size_t avgLineLen) {
+    mt19937 generator(42);
+    uniform_int_distribution<size_t> lenDist(avgLineLen / 2, avgLineLen * 3 / 2);
+    uniform_int_distribution<int> charDist('a', 'z');
+    string buffer;
+    buffer.reserve(kBufferSize);
+    while (buffer.size() < kBufferSize) {
+        size_t len = min(lenDist(generator), kBufferSize - buffer.size() - 1);
+        for (size_t i = 0; i < len; ++i) {
+            buffer.push_back(static_cast<char>(charDist(generator)));
+        }
+        buffer.push_back('\n');
+    }
+    return buffer;
+}
+
+double SplitLogStringBenchmark::runSplit(const string& buffer, size_t rounds, size_t& lineCnt) {
+    ProcessorSplitLogStringNative processor;
+    processor.SetContext(mContext);
+    processor.Init(Json::Value());
+
+    chrono::nanoseconds elapsed(0);
+    for (size_t i = 0; i < rounds; ++i) {
+        PipelineEventGroup eventGroup(make_shared<SourceBuffer>());
+        StringBuffer content = eventGroup.GetSourceBuffer()->CopyString(buffer);
+        auto* event = eventGroup.AddLogEvent();
+        event->SetContentNoCopy(DEFAULT_CONTENT_KEY, StringView(content.data, content.size));
+        event->SetPosition(0, content.size);
+
+        auto start = chrono::steady_clock::now();
+        processor.Process(eventGroup);
+        elapsed += chrono::steady_clock::now() - start;
+        lineCnt = eventGroup.GetEvents().size();
+    }
+    return static_cast<double>(buffer.size() * rounds) / elapsed.count();
+}
+
+double SplitLogStringBenchmark::runReverseScan(const string& buffer, size_t rounds, size_t& lineCnt) {
+    chrono::nanoseconds elapsed(0);
+    for (size_t i = 0; i < rounds; ++i) {
+        // same access pattern as RawTextParser::GetLastLine when rolling back a whole buffer line by line
+        auto start = chrono::steady_clock::now();
+        size_t end = buffer.size() - 1;
+        lineCnt = 0;
+        while (true) {
+            size_t pos = FindLastChar(buffer.data(), end, '\n');
+            ++lineCnt;
+            if (pos == end) {
+                break;
+            }
+            end = pos;
+        }
+        elapsed += chrono::steady_clock::now() - start;
+    }
+    return static_cast<double>(buffer.size() * rounds) / elapsed.count();
+}
+
+void SplitLogStringBenchmark::TestSplitThroughput() {
+    for (size_t avgLineLen : {64, 256, 1024, 4096}) {
+        string buffer = makeBuffer(avgLineLen);
+        for (auto impl : {CharSearchImpl::SCALAR, CharSearchImpl::SSE2, CharSearchImpl::AVX2}) {
+            if (!SetCharSearchImpl(impl)) {
+                continue;
+            }
+            size_t lineCnt = 0;
+            double gbps = runSplit(buffer, 200, lineCnt);
+            cout << "split avg line len: " << setw(5) << avgLineLen << "\timpl: " << setw(7)
+                 << GetCharSearchImplName() << "\tlines: " << lineCnt << "\tthroughput: " << fixed
+                 << setprecision(3) << gbps << " GB/s" << endl;
+        }
+    }
+}
+
+void SplitLogStringBenchmark::TestReverseScanThroughput() {
+    for (size_t avgLineLen : {64, 256, 1024, 4096}) {
+        string buffer = makeBuffer(avgLineLen);
+        for (auto impl : {CharSearchImpl::SCALAR, CharSearchImpl::SSE2, CharSearchImpl::AVX2}) {
+            if (!SetCharSearchImpl(impl)) {
+                continue;
+            }
+            size_t lineCnt = 0;
+            double gbps = runReverseScan(buffer, 200, lineCnt);
+            cout << "reverse scan avg line len: " << setw(5) << avgLineLen << "\timpl: " << setw(7)
+                 << GetCharSearchImplName() << "\tlines: " << lineCnt << "\tthroughput: " << fixed
+                 << setprecision(3) << gbps << " GB/s" << endl;
+        }
+    }
+}
+
+UNIT_TEST_CASE(SplitLogStringBenchmark, TestSplitThroughput)
+UNIT_TEST_CASE(SplitLogStringBenchmark, TestReverseScanThroughput)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -0,0 +1,111 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "common/StringTools.h"
+#include "prometheus/labels/ProtobufParser.h"
+#include "prometheus/labels/TextParser.h"
+#include "unittest/Unittest.h"
+#include "unittest/prometheus/ProtobufWriter.h"
+
+using namespace std;
+
+namespace logtail {
+
+// Parses the same samples of a node exporter like target, i.e. counters with a few labels and classic histograms, from
+// the text exposition and from the protobuf exposition.
+class ProtobufParserBenchmark : public testing::Test {
+public:
+    void TestParseText();
+    void TestParseProtobuf();
+
+protected:
+    void SetUp() override {
+        for (size_t cpu = 0; cpu < 32; ++cpu) {
+            ProtobufWriter family;
+            family.Bytes(1, "node_cpu_seconds_total").Varint(3, 0);
+            for (const auto* mode : {"idle", "iowait", "irq", "nice", "softirq", "steal", "system", "user"}) {
+                double value = 1234567.89 + cpu;
+                mText += "node_cpu_seconds_total{cpu=\"" + ToString(cpu) + "\",mode=\"" + mode + "\"} "
+                    + ToString(value) + "\n";
+                family.Message(4,
+                               ProtobufWriter()
+                                   .Message(1, ProtobufWriter::Label("cpu", ToString(cpu)))
+                                   .Message(1, ProtobufWriter::Label("mode", mode))
+                                   .Message(3, ProtobufWriter().Double(1, value)));
+            }
+            mProtobuf += family.Delimited();
+        }
+        for (size_t handler = 0; handler < 32; ++handler) {
+            auto labels = "handler=\"/api/v1/h" + ToString(handler) + "\"";
+            ProtobufWriter histogram;
+            histogram.Varint(1, 1000).Double(2, 123.5);
+            for (double bound : {0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0}) {
+                mText += "http_request_duration_seconds_bucket{" + labels + ",le=\"" + ToString(bound) + "\"} 1000\n";
+                histogram.Message(3, ProtobufWriter().Varint(1, 1000).Double(2, bound));
+            }
+            mText += "http_request_duration_seconds_bucket{" + labels + ",le=\"+Inf\"} 1000\n";
+            mText += "http_request_duration_seconds_sum{" + labels + "} 123.5\n";
+            mText += "http_request_duration_seconds_count{" + labels + "} 1000\n";
+            mProtobuf += ProtobufWriter()
+                             .Bytes(1, "http_request_duration_seconds")
+                             .Varint(3, 4)
+                             .Message(4,
+                                      ProtobufWriter()
+                                          .Message(1, ProtobufWriter::Label("handler", "/api/v1/h" + ToString(handler)))
+                                          .Message(7, histogram))
+                             .Delimited();
+        }
+    }
+
+    template <typename F>
+    void Run(const string& name, size_t bodySize, F&& parse);
+
+    static constexpr size_t kRoundCnt = 1000;
+
+    string mText;
+    string mProtobuf;
+};
+
+template <typename F>
+void ProtobufParserBenchmark::Run(const string& name, size_t bodySize, F&& parse) {
+    size_t eventCnt = 0;
+    auto start = chrono::steady_clock::now();
+    for (size_t round = 0; round < kRoundCnt; ++round) {
+        eventCnt += parse().GetEvents().size();
+    }
+    auto cost = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+    cout << "[" << name << "] body size: " << bodySize << "\tevents: " << eventCnt / kRoundCnt
+         << "\tcost per event: " << cost.count() / eventCnt << "ns" << endl;
+}
+
+void ProtobufParserBenchmark::TestParseText() {
+    TextParser parser;
+    Run("text", mText.size(), [&]() { return parser.Parse(mText, 0, 0); });
+}
+
+void ProtobufParserBenchmark::TestParseProtobuf() {
+    ProtobufParser parser;
+    Run("protobuf", mProtobuf.size(), [&]() { return parser.Parse(mProtobuf, 0, 0); });
+}
+
+UNIT_TEST_CASE(ProtobufParserBenchmark, TestParseText)
+UNIT_TEST_CASE(ProtobufParserBenchmark, TestParseProtobuf)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -0,0 +1,385 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "models/MetricEvent.h"
+#include "models/PipelineEventGroup.h"
+#include "prometheus/labels/ProtobufParser.h"
+#include "unittest/Unittest.h"
+#include "unittest/prometheus/ProtobufWriter.h"
+
+using namespace std;
+
+namespace logtail {
+
+class ProtobufParserUnittest : public testing::Test {
+public:
+    void TestParseCounterAndGauge();
+    void TestHonorTimestamps();
+    void TestParseSummary();
+    void TestParseHistogram();
+    void TestParseNativeHistogram();
+    void TestFormatBound();
+    void TestReadLengthPrefix();
+    void TestParseFailure();
+
+private:
+    static void CheckBuckets(const PipelineEventGroup& eGroup,
+                             size_t begin,
+                             const string& name,
+                             const vector<pair<string, double>>& buckets);
+};
+
+void ProtobufParserUnittest::CheckBuckets(const PipelineEventGroup& eGroup,
+                                          size_t begin,
+                                          const string& name,
+                                          const vector<pair<string, double>>& buckets) {
+    const auto& events = eGroup.GetEvents();
+    APSARA_TEST_TRUE(events.size() >= begin + buckets.size());
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        const auto& e = events[begin + i].Cast<MetricEvent>();
+        APSARA_TEST_EQUAL(name, e.GetName());
+        APSARA_TEST_EQUAL(buckets[i].first, e.GetTag("le"));
+        APSARA_TEST_EQUAL(buckets[i].second, e.GetValue<UntypedSingleValue>()->mValue);
+    }
+}
+
+void ProtobufParserUnittest::TestParseCounterAndGauge() {
+    string body = ProtobufWriter()
+                      .Bytes(1, "http_requests_total")
+                      .Bytes(2, "The total number of HTTP requests.")
+                      .Varint(3, 0)
+                      .Message(4,
+                               ProtobufWriter()
+                                   .Message(1, ProtobufWriter::Label("method", "post"))
+                                   .Message(1, ProtobufWriter::Label("code", "200"))
+                                   .Message(3, ProtobufWriter().Double(1, 1027))
+                                   .Varint(6, 1395066363000))
+                      .Message(4,
+                               ProtobufWriter()
+                                   .Message(1, ProtobufWriter::Label("method", "post"))
+                                   .Message(1, ProtobufWriter::Label("code", "400"))
+                                   .Message(3, ProtobufWriter().Double(1, 3)))
+                      .Delimited();
+    // fields of a family may come in any order
+    body += ProtobufWriter()
+                .Message(4, ProtobufWriter().Message(2, ProtobufWriter().Double(1, -1.5)))
+                .Varint(3, 1)
+                .Bytes(1, "temperature")
+                .Delimited();
+
+    ProtobufParser parser;
+    auto eGroup = parser.Parse(body, 1715829785, 123);
+    // the events refer to the source buffer only
+    body.assign(body.size(), 'x');
+
+    const auto& events = eGroup.GetEvents();
+    APSARA_TEST_EQUAL(3UL, events.size());
+
+    const auto& e0 = events[0].Cast<MetricEvent>();
+    APSARA_TEST_EQUAL("http_requests_total", e0.GetName());
+    APSARA_TEST_EQUAL(2U, e0.TagsSize());
+    APSARA_TEST_EQUAL("post", e0.GetTag("method"));
+    APSARA_TEST_EQUAL("200", e0.GetTag("code"));
+    APSARA_TEST_EQUAL(1027.0, e0.GetValue<UntypedSingleValue>()->mValue);
+    APSARA_TEST_EQUAL(1395066363, e0.GetTimestamp());
+    APSARA_TEST_EQUAL(0U, e0.GetTimestampNanosecond().value());
+
+    const auto& e1 = events[1].Cast<MetricEvent>();
+    APSARA_TEST_EQUAL("http_requests_total", e1.GetName());
+    APSARA_TEST_EQUAL("400", e1.GetTag("code"));
+    APSARA_TEST_EQUAL(3.0, e1.GetValue<UntypedSingleValue>()->mValue);
+    APSARA_TEST_EQUAL(1715829785, e1.GetTimestamp());
+    APSARA_TEST_EQUAL(123U, e1.GetTimestampNanosecond().value());
+
+    const auto& e2 = events[2].Cast<MetricEvent>();
+    APSARA_TEST_EQUAL("temperature", e2.GetName());
+    APSARA_TEST_EQUAL(0U, e2.TagsSize());
+    APSARA_TEST_EQUAL(-1.5, e2.GetValue<UntypedSingleValue>()->mValue);
+}
+
+void ProtobufParserUnittest::TestHonorTimestamps() {
+    string body = ProtobufWriter()
+                      .Bytes(1, "go_goroutines")
+                      .Varint(3, 1)
+                      .Message(4, ProtobufWriter().Message(2, ProtobufWriter().Double(1, 7)).Varint(6, 1715829785083))
+                      .Delimited();
+    {
+        ProtobufParser parser(true);
+        auto eGroup = parser.Parse(body, 0, 0);
+        const auto& e = eGroup.GetEvents()[0].Cast<MetricEvent>();
+        APSARA_TEST_EQUAL(1715829785, e.GetTimestamp());
+        APSARA_TEST_EQUAL(83000000U, e.GetTimestampNanosecond().value());
+    }
+    {
+        ProtobufParser parser(false);
+        auto eGroup = parser.Parse(body, 1715829786, 0);
+        const auto& e = eGroup.GetEvents()[0].Cast<MetricEvent>();
+        APSARA_TEST_EQUAL(1715829786, e.GetTimestamp());
+        APSARA_TEST_EQUAL(0U, e.GetTimestampNanosecond().value());
+    }
+}
+
+void ProtobufParserUnittest::TestParseSummary() {
+    string body = ProtobufWriter()
+                      .Bytes(1, "rpc_duration_seconds")
+                      .Varint(3, 2)
+                      .Message(4,
+                               ProtobufWriter()
+                                   .Message(1, ProtobufWriter::Label("service", "a"))
+                                   .Message(4,
+                                            ProtobufWriter()
+                                                .Varint(1, 2693)
+                                                .Double(2, 1.7560473e+07)
+                                                .Message(3, ProtobufWriter().Double(1, 0.01).Double(2, 3102))
+                                                .Message(3, ProtobufWriter().Double(1, 0.5).Double(2, 4773))))
+                      .Delimited();
+
+    ProtobufParser parser;
+    auto eGroup = parser.Parse(body, 0, 0);
+    const auto& events = eGroup.GetEvents();
+    APSARA_TEST_EQUAL(4UL, events.size());
+
+    const auto& e0 = events[0].Cast<MetricEvent>();
+    APSARA_TEST_EQUAL("rpc_duration_seconds", e0.GetName());
+    APSARA_TEST_EQUAL("a", e0.GetTag("service"));
+    APSARA_TEST_EQUAL("0.01", e0.GetTag("quantile"));
+    APSARA_TEST_EQUAL(3102.0, e0.GetValue<UntypedSingleValue>()->mValue);
+
+    const auto& e1 = events[1].Cast<MetricEvent>();
+    APSARA_TEST_EQUAL("0.5", e1.GetTag("quantile"));
+    APSARA_TEST_EQUAL(4773.0, e1.GetValue<UntypedSingleValue>()->mValue);
+
+    const auto& e2 = events[2].Cast<MetricEvent>();
+    APSARA_TEST_EQUAL("rpc_duration_seconds_sum", e2.GetName());
+    APSARA_TEST_EQUAL("a", e2.GetTag("service"));
+    APSARA_TEST_FALSE(e2.HasTag("quantile"));
+    APSARA_TEST_EQUAL(1.7560473e+07, e2.GetValue<UntypedSingleValue>()->mValue);
+
+    const auto& e3 = events[3].Cast<MetricEvent>();
+    APSARA_TEST_EQUAL("rpc_duration_seconds_count", e3.GetName());
+    APSARA_TEST_EQUAL(2693.0, e3.GetValue<UntypedSingleValue>()->mValue);
+}
+
+void ProtobufParserUnittest::TestParseHistogram() {
+    auto bucket = [](uint64_t count, double upperBound) {
+        return ProtobufWriter().Varint(1, count).Double(2, upperBound);
+    };
+    string body = ProtobufWriter()
+                      .Bytes(1, "http_request_duration_seconds")
+                      .Varint(3, 4)
+                      .Message(4,
+                               ProtobufWriter().Message(7,
+                                                        ProtobufWriter()
+                                                            .Varint(1, 144320)
+                                                            .Double(2, 53423)
+                                                            .Message(3, bucket(24054, 0.05))
+                                                            .Message(3, bucket(33444, 0.1))
+                                                            .Message(3, bucket(129389, 1e6))))
+                      // the +Inf bucket is not added twice
+                      .Message(4,
+                               ProtobufWriter().Message(
+                                   7,
+                                   ProtobufWriter().Varint(1, 2).Double(2, 1).Message(
+                                       3, bucket(2, numeric_limits<double>::infinity()))))
+                      .Delimited();
+
+    ProtobufParser parser;
+    auto eGroup = parser.Parse(body, 0, 0);
+    const auto& events = eGroup.GetEvents();
+    APSARA_TEST_EQUAL(9UL, events.size());
+    CheckBuckets(eGroup,
+                 0,
+                 "http_request_duration_seconds_bucket",
+                 {{"0.05", 24054}, {"0.1", 33444}, {"1e+06", 129389}, {"+Inf", 144320}});
+    APSARA_TEST_EQUAL("http_request_duration_seconds_sum", events[4].Cast<MetricEvent>().GetName());
+    APSARA_TEST_EQUAL(53423.0, events[4].Cast<MetricEvent>().GetValue<UntypedSingleValue>()->mValue);
+    APSARA_TEST_EQUAL("http_request_duration_seconds_count", events[5].Cast<MetricEvent>().GetName());
+    APSARA_TEST_EQUAL(144320.0, events[5].Cast<MetricEvent>().GetValue<UntypedSingleValue>()->mValue);
+    CheckBuckets(eGroup, 6, "http_request_duration_seconds_bucket", {{"+Inf", 2}});
+    // the names are copied once per family
+    APSARA_TEST_EQUAL(events[0].Cast<MetricEvent>().GetName().data(),
+                      events[6].Cast<MetricEvent>().GetName().data());
+}
+
+void ProtobufParserUnittest::TestParseNativeHistogram() {
+    ProtobufParser parser;
+    {
+        // schema 0, i.e. buckets bounded by powers of 2, with a zero bucket and negative buckets
+        string body = ProtobufWriter()
+                          .Bytes(1, "native")
+                          .Varint(3, 4)
+                          .Message(4,
+                                   ProtobufWriter().Message(
+                                       7,
+                                       ProtobufWriter()
+                                           .Varint(1, 8)
+                                           .Double(2, 10)
+                                           .SInt(5, 0)
+                                           .Double(6, 0.001)
+                                           .Varint(7, 2)
+                                           .Message(9, ProtobufWriter().SInt(1, 0).Varint(2, 1))
+                                           .PackedSInts(10, {3})
+                                           .Message(12, ProtobufWriter().SInt(1, 0).Varint(2, 2))
+                                           .PackedSInts(13, {1, 1})))
+                          .Delimited();
+        auto eGroup = parser.Parse(body, 0, 0);
+        APSARA_TEST_EQUAL(7UL, eGroup.GetEvents().size());
+        CheckBuckets(eGroup, 0, "native_bucket", {{"-0.5", 3}, {"0.001", 5}, {"1", 6}, {"2", 8}, {"+Inf", 8}});
+    }
+    {
+        // schema 3 with spans apart, and deltas not packed
+        string body = ProtobufWriter()
+                          .Bytes(1, "native")
+                          .Varint(3, 4)
+                          .Message(4,
+                                   ProtobufWriter().Message(7,
+                                                            ProtobufWriter()
+                                                                .Varint(1, 6)
+                                                                .Double(2, 10)
+                                                                .SInt(5, 3)
+                                                                .Message(12, ProtobufWriter().SInt(1, -1).Varint(2, 2))
+                                                                .Message(12, ProtobufWriter().SInt(1, 2).Varint(2, 1))
+                                                                .SInt(13, 1)
+                                                                .SInt(13, 2)
+                                                                .SInt(13, -1)))
+                          .Delimited();
+        auto eGroup = parser.Parse(body, 0, 0);
+        APSARA_TEST_EQUAL(6UL, eGroup.GetEvents().size());
+        CheckBuckets(eGroup,
+                     0,
+                     "native_bucket",
+                     {{"0.9170040432046712", 1}, {"1", 4}, {"1.2968395546510096", 6}, {"+Inf", 6}});
+    }
+    {
+        // spans covering more buckets than given
+        string body = ProtobufWriter()
+                          .Bytes(1, "native")
+                          .Varint(3, 4)
+                          .Message(4,
+                                   ProtobufWriter().Message(7,
+                                                            ProtobufWriter()
+                                                                .Varint(1, 1)
+                                                                .Message(12, ProtobufWriter().SInt(1, 0).Varint(2, 2))
+                                                                .PackedSInts(13, {1})))
+                          .Delimited();
+        auto eGroup = parser.Parse(body, 0, 0);
+        APSARA_TEST_EQUAL(0UL, eGroup.GetEvents().size());
+    }
+}
+
+void ProtobufParserUnittest::TestFormatBound() {
+    ProtobufParser parser;
+    PipelineEventGroup eGroup(make_shared<SourceBuffer>());
+    auto format = [&](double value) { return parser.FormatBound(eGroup, value).to_string(); };
+    // the same as strconv.FormatFloat(value, 'g', -1, 64) in Go
+    APSARA_TEST_EQUAL("0.001", format(0.001));
+    APSARA_TEST_EQUAL("0.0001", format(0.0001));
+    APSARA_TEST_EQUAL("1e-05", format(1e-5));
+    APSARA_TEST_EQUAL("1", format(1));
+    APSARA_TEST_EQUAL("2.5", format(2.5));
+    APSARA_TEST_EQUAL("-0.5", format(-0.5));
+    APSARA_TEST_EQUAL("100000", format(100000));
+    APSARA_TEST_EQUAL("1e+06", format(1e6));
+    APSARA_TEST_EQUAL("1.234567e+06", format(1234567));
+    APSARA_TEST_EQUAL("100", format(100));
+    APSARA_TEST_EQUAL("0.30000000000000004", format(0.1 + 0.2));
+    APSARA_TEST_EQUAL("1.7976931348623157e+308", format(numeric_limits<double>::max()));
+    APSARA_TEST_EQUAL("+Inf", format(numeric_limits<double>::infinity()));
+    APSARA_TEST_EQUAL("-Inf", format(-numeric_limits<double>::infinity()));
+    APSARA_TEST_EQUAL(14UL, parser.mFormattedBounds.size());
+    // formatted once for each family
+    APSARA_TEST_EQUAL(parser.FormatBound(eGroup, 0.001).data(), parser.FormatBound(eGroup, 0.001).data());
+}
+
+void ProtobufParserUnittest::TestReadLengthPrefix() {
+    size_t prefixSize = 0;
+    uint64_t messageSize = 0;
+    APSARA_TEST_TRUE(ProtobufParser::ReadLengthPrefix(StringView("\x05", 1), prefixSize, messageSize));
+    APSARA_TEST_EQUAL(1UL, prefixSize);
+    APSARA_TEST_EQUAL(5UL, messageSize);
+    APSARA_TEST_TRUE(ProtobufParser::ReadLengthPrefix(StringView("\xac\x02xx", 4), prefixSize, messageSize));
+    APSARA_TEST_EQUAL(2UL, prefixSize);
+    APSARA_TEST_EQUAL(300UL, messageSize);
+    // incomplete
+    APSARA_TEST_FALSE(ProtobufParser::ReadLengthPrefix(StringView("\xac", 1), prefixSize, messageSize));
+    APSARA_TEST_FALSE(ProtobufParser::ReadLengthPrefix(StringView(), prefixSize, messageSize));
+    // malformed
+    string malformed(10, '\xff');
+    APSARA_TEST_TRUE(ProtobufParser::ReadLengthPrefix(malformed, prefixSize, messageSize));
+    APSARA_TEST_EQUAL(numeric_limits<uint64_t>::max(), messageSize);
+}
+
+void ProtobufParserUnittest::TestParseFailure() {
+    string family1 = ProtobufWriter()
+                         .Bytes(1, "a")
+                         .Varint(3, 1)
+                         .Message(4, ProtobufWriter().Message(2, ProtobufWriter().Double(1, 1)))
+                         .Delimited();
+    string family2 = ProtobufWriter()
+                         .Bytes(1, "b")
+                         .Varint(3, 1)
+                         .Message(4, ProtobufWriter().Message(2, ProtobufWriter().Double(1, 2)))
+                         .Delimited();
+    ProtobufParser parser;
+    // truncated
+    APSARA_TEST_EQUAL(1UL, parser.Parse(family1 + family2.substr(0, family2.size() - 1), 0, 0).GetEvents().size());
+    // without name
+    string noName = ProtobufWriter()
+                        .Varint(3, 1)
+                        .Message(4, ProtobufWriter().Message(2, ProtobufWriter().Double(1, 1)))
+                        .Delimited();
+    APSARA_TEST_EQUAL(0UL, parser.Parse(noName + family1, 0, 0).GetEvents().size());
+    // unknown type
+    string unknownType = ProtobufWriter().Bytes(1, "c").Varint(3, 9).Message(4, ProtobufWriter()).Delimited();
+    APSARA_TEST_EQUAL(1UL, parser.Parse(family1 + unknownType + family2, 0, 0).GetEvents().size());
+    // a string where a double is expected
+    string badValue = ProtobufWriter()
+                          .Bytes(1, "d")
+                          .Varint(3, 1)
+                          .Message(4, ProtobufWriter().Message(2, ProtobufWriter().Bytes(1, "1")))
+                          .Delimited();
+    APSARA_TEST_EQUAL(0UL, parser.Parse(badValue, 0, 0).GetEvents().size());
+    // unknown fields are skipped
+    string unknownFields = ProtobufWriter()
+                               .Bytes(1, "e")
+                               .Varint(3, 1)
+                               .Double(15, 1)
+                               .Message(4, ProtobufWriter().Message(2, ProtobufWriter().Double(1, 1)).Varint(15, 1))
+                               .Delimited();
+    APSARA_TEST_EQUAL(1UL, parser.Parse(unknownFields, 0, 0).GetEvents().size());
+    // random bytes
+    string garbage;
+    for (size_t i = 0; i < 256; ++i) {
+        garbage.push_back(static_cast<char>(i * 37 + 11));
+    }
+    parser.Parse(garbage, 0, 0);
+}
+
+UNIT_TEST_CASE(ProtobufParserUnittest, TestParseCounterAndGauge)
+UNIT_TEST_CASE(ProtobufParserUnittest, TestHonorTimestamps)
+UNIT_TEST_CASE(ProtobufParserUnittest, TestParseSummary)
+UNIT_TEST_CASE(ProtobufParserUnittest, TestParseHistogram)
+UNIT_TEST_CASE(ProtobufParserUnittest, TestParseNativeHistogram)
+UNIT_TEST_CASE(ProtobufParserUnittest, TestFormatBound)
+UNIT_TEST_CASE(ProtobufParserUnittest, TestReadLengthPrefix)
+UNIT_TEST_CASE(ProtobufParserUnittest, TestParseFailure)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
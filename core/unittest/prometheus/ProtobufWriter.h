@@ -0,0 +1,81 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+namespace logtail {
+
+// A minimal protobuf encoder to build io.prometheus.client.MetricFamily messages in tests.
+class ProtobufWriter {
+public:
+    ProtobufWriter& Varint(uint32_t field, uint64_t value) {
+        WriteTag(field, 0);
+        WriteVarint(value);
+        return *this;
+    }
+    ProtobufWriter& SInt(uint32_t field, int64_t value) { return Varint(field, ZigZag(value)); }
+    ProtobufWriter& Double(uint32_t field, double value) {
+        WriteTag(field, 1);
+        mData.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        return *this;
+    }
+    ProtobufWriter& Bytes(uint32_t field, const std::string& value) {
+        WriteTag(field, 2);
+        WriteVarint(value.size());
+        mData += value;
+        return *this;
+    }
+    ProtobufWriter& Message(uint32_t field, const ProtobufWriter& message) { return Bytes(field, message.mData); }
+    ProtobufWriter& PackedSInts(uint32_t field, const std::vector<int64_t>& values) {
+        ProtobufWriter packed;
+        for (auto value : values) {
+            packed.WriteVarint(ZigZag(value));
+        }
+        return Bytes(field, packed.mData);
+    }
+
+    // the message prefixed by its length, as in the exposition
+    std::string Delimited() const {
+        ProtobufWriter res;
+        res.WriteVarint(mData.size());
+        return res.mData + mData;
+    }
+
+    static ProtobufWriter Label(const std::string& name, const std::string& value) {
+        return ProtobufWriter().Bytes(1, name).Bytes(2, value);
+    }
+
+    std::string mData;
+
+private:
+    static uint64_t ZigZag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+    void WriteTag(uint32_t field, uint32_t wireType) { WriteVarint((field << 3) | wireType); }
+    void WriteVarint(uint64_t value) {
+        for (; value >= 0x80; value >>= 7) {
+            mData.push_back(static_cast<char>(value | 0x80));
+        }
+        mData.push_back(static_cast<char>(value));
+    }
+};
+
+} // namespace logtail
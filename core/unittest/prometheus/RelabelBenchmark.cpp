@@ -0,0 +1,159 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "common/JsonUtil.h"
+#include "common/StringTools.h"
+#include "models/PipelineEventGroup.h"
+#include "prometheus/labels/Relabel.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+// Relabels the series of a node exporter like target with typical metric relabel configs, through Labels as before,
+// and with the compiled relabel configs. Labelmap is left out, since Labels over an event cannot add labels while
+// ranging over them.
+class RelabelBenchmark : public testing::Test {
+public:
+    void TestRelabelWithLabels();
+    void TestRelabelCompiled();
+
+protected:
+    void SetUp() override {
+        string configStr = R"JSON(
+            [
+                {
+                    "action": "drop",
+                    "regex": "go_.*|node_softnet_.*|node_scrape_collector_duration_seconds",
+                    "source_labels": ["__name__"]
+                },
+                {
+                    "action": "keep",
+                    "regex": "node_cpu_.*|node_filesystem_.*|node_network_.*|node_load1",
+                    "source_labels": ["__name__"]
+                },
+                {
+                    "action": "replace",
+                    "regex": "(.*):(\\d+)",
+                    "replacement": "$1",
+                    "source_labels": ["instance"],
+                    "target_label": "host"
+                },
+                {
+                    "action": "replace",
+                    "regex": "/dev/(vd[a-z])(\\d*)",
+                    "replacement": "${1}_$2",
+                    "source_labels": ["device", "fstype"],
+                    "separator": "@",
+                    "target_label": "disk"
+                },
+                {
+                    "action": "labeldrop",
+                    "regex": "__meta_.*|fstype"
+                }
+            ]
+        )JSON";
+        string errorMsg;
+        Json::Value config;
+        APSARA_TEST_TRUE(ParseJsonTable(configStr, config, errorMsg));
+        APSARA_TEST_TRUE(mConfigList.Init(config));
+    }
+
+    static void AddEvents(PipelineEventGroup& eGroup);
+    template <typename F>
+    void Run(const string& name, F&& relabel);
+
+    static constexpr size_t kRoundCnt = 200;
+
+    RelabelConfigList mConfigList;
+};
+
+void RelabelBenchmark::AddEvents(PipelineEventGroup& eGroup) {
+    auto add = [&eGroup](const string& name, const vector<pair<string, string>>& tags) {
+        auto* e = eGroup.AddMetricEvent();
+        e->SetName(name);
+        e->SetTag(string("instance"), string("192.168.0.1:9100"));
+        e->SetTag(string("job"), string("node-exporter"));
+        e->SetTag(string("__meta_kubernetes_pod_label_app"), string("node-exporter"));
+        e->SetTag(string("__meta_kubernetes_pod_node_name"), string("cn-hangzhou.192.168.0.1"));
+        for (const auto& [k, v] : tags) {
+            e->SetTag(k, v);
+        }
+    };
+    for (size_t cpu = 0; cpu < 32; ++cpu) {
+        for (const auto* mode : {"idle", "iowait", "irq", "nice", "softirq", "steal", "system", "user"}) {
+            add("node_cpu_seconds_total", {{"cpu", ToString(cpu)}, {"mode", mode}});
+        }
+        add("node_softnet_processed_total", {{"cpu", ToString(cpu)}});
+    }
+    for (size_t fs = 0; fs < 20; ++fs) {
+        for (const auto* name : {"node_filesystem_avail_bytes", "node_filesystem_size_bytes"}) {
+            add(name, {{"device", "/dev/vdb" + ToString(fs)}, {"fstype", "ext4"}, {"mountpoint", "/var/lib"}});
+        }
+    }
+    for (size_t dev = 0; dev < 16; ++dev) {
+        add("node_network_receive_bytes_total", {{"device", "veth" + ToString(dev)}});
+    }
+    for (size_t i = 0; i < 50; ++i) {
+        add("go_memstats_item" + ToString(i), {});
+        add("node_memory_Item" + ToString(i) + "_bytes", {});
+    }
+    add("node_load1", {});
+}
+
+template <typename F>
+void RelabelBenchmark::Run(const string& name, F&& relabel) {
+    size_t eventCnt = 0;
+    size_t keptCnt = 0;
+    chrono::nanoseconds cost(0);
+    for (size_t round = 0; round < kRoundCnt; ++round) {
+        PipelineEventGroup eGroup(make_shared<SourceBuffer>());
+        AddEvents(eGroup);
+        auto start = chrono::steady_clock::now();
+        for (auto& e : eGroup.MutableEvents()) {
+            if (relabel(e.Cast<MetricEvent>())) {
+                ++keptCnt;
+            }
+        }
+        cost += chrono::steady_clock::now() - start;
+        eventCnt += eGroup.GetEvents().size();
+    }
+    cout << "[" << name << "] events: " << eventCnt << "\tkept: " << keptCnt
+         << "\tcost per event: " << cost.count() / eventCnt << "ns" << endl;
+}
+
+void RelabelBenchmark::TestRelabelWithLabels() {
+    Run("labels", [this](MetricEvent& e) {
+        Labels labels;
+        labels.Reset(&e);
+        return mConfigList.Process(labels);
+    });
+}
+
+void RelabelBenchmark::TestRelabelCompiled() {
+    Run("compiled", [this](MetricEvent& e) { return mConfigList.Process(e); });
+}
+
+UNIT_TEST_CASE(RelabelBenchmark, TestRelabelWithLabels)
+UNIT_TEST_CASE(RelabelBenchmark, TestRelabelCompiled)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
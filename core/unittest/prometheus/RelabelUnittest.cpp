@@ -20,6 +20,8 @@
 #include <string>
 
 #include "common/JsonUtil.h"
+#include "models/PipelineEventGroup.h"
+#include "prometheus/labels/CompiledRelabel.h"
 #include "prometheus/labels/Relabel.h"
 #include "unittest/Unittest.h"
 
@@ -49,6 +51,8 @@ public:
     void TestLowerCase();
     void TestUpperCase();
     void TestMultiRelabel();
+    void TestCompileRelabelConfigs();
+    void TestCompiledRelabelMetricEvent();
 };
 
 
@@ -511,6 +515,131 @@ void RelabelConfigUnittest::TestMultiRelabel() {
     APSARA_TEST_TRUE(configList.Process(result));
 }
 
+void RelabelConfigUnittest::TestCompileRelabelConfigs() {
+    string configStr = R"JSON(
+        [
+            {"action": "keep", "source_labels": ["__name__"], "regex": "up|node_cpu_.*|a\\.b"},
+            {"action": "labeldrop", "regex": "(?i)ID"},
+            {"action": "drop", "source_labels": ["job"], "regex": "(\\w)\\1"},
+            {"action": "replace", "source_labels": ["instance"], "regex": "(.*):(\\d+)", "target_label": "host"},
+            {"action": "replace", "source_labels": ["instance"], "regex": "(.*)", "replacement": "\\n$1",
+                "target_label": "host"},
+            {"action": "labelmap", "regex": "__meta_(.*)", "replacement": "${1}_$$"},
+            {"action": "labelmap", "regex": "(.*)", "replacement": "$1(?1:x)"},
+            {"action": "hashmod", "source_labels": ["instance"], "target_label": "shard", "modulus": 2},
+            {"action": "replace", "source_labels": ["msg"], "regex": "^(b.*)$", "target_label": "line"},
+            {"action": "keep", "source_labels": ["msg"], "regex": "^(b.*)$"}
+        ]
+    )JSON";
+    Json::Value configJson;
+    string errorMsg;
+    APSARA_TEST_TRUE(ParseJsonTable(configStr, configJson, errorMsg));
+    RelabelConfigList configList;
+    APSARA_TEST_TRUE(configList.Init(configJson));
+
+    const auto& steps = configList.mCompiledRelabelConfigs->mSteps;
+    APSARA_TEST_EQUAL(10U, steps.size());
+    using MatchKind = CompiledRelabelConfigList::MatchKind;
+    // literals
+    APSARA_TEST_TRUE(steps[0].mMatchKind == MatchKind::LITERAL);
+    APSARA_TEST_EQUAL(unordered_set<string>({"up", "a.b"}), steps[0].mLiterals);
+    APSARA_TEST_EQUAL(vector<string>({"node_cpu_"}), steps[0].mLiteralPrefixes);
+    APSARA_TEST_TRUE(steps[1].mMatchKind == MatchKind::RE2);
+    // backreferences are not supported by RE2
+    APSARA_TEST_TRUE(steps[2].mMatchKind == MatchKind::BOOST);
+    APSARA_TEST_TRUE(steps[3].mMatchKind == MatchKind::RE2);
+    APSARA_TEST_EQUAL(3, steps[3].mGroupCnt);
+    // escapes in the replacement are left to boost
+    APSARA_TEST_FALSE(steps[4].mFormatCompiled);
+    APSARA_TEST_TRUE(steps[4].mMatchKind == MatchKind::BOOST);
+    APSARA_TEST_TRUE(steps[5].mFormatCompiled);
+    APSARA_TEST_EQUAL(2U, steps[5].mReplacementFormat.size());
+    APSARA_TEST_EQUAL(1, steps[5].mReplacementFormat[0].mGroup);
+    APSARA_TEST_EQUAL("_$", steps[5].mReplacementFormat[1].mLiteral);
+    // conditionals in the format_all mode
+    APSARA_TEST_FALSE(steps[6].mFormatCompiled);
+    APSARA_TEST_TRUE(steps[7].mMatchKind == MatchKind::BOOST);
+    // boost searches for ^ and $ at line boundaries as well, which makes no difference to a full match only
+    APSARA_TEST_TRUE(steps[8].mMatchKind == MatchKind::BOOST);
+    APSARA_TEST_TRUE(steps[9].mMatchKind == MatchKind::RE2);
+}
+
+void RelabelConfigUnittest::TestCompiledRelabelMetricEvent() {
+    vector<string> configStrs = {
+        R"JSON({"action": "keep", "source_labels": ["__name__"], "regex": "up|node_.*"})JSON",
+        R"JSON({"action": "drop", "source_labels": ["__name__", "mode"], "regex": "node_cpu.*;idle"})JSON",
+        R"JSON({"action": "keep", "source_labels": ["mode"], "regex": "(?i)IDLE|user"})JSON",
+        R"JSON({"action": "replace", "source_labels": ["instance"], "regex": "(.*):(\\d+)",
+            "target_label": "host"})JSON",
+        R"JSON({"action": "replace", "source_labels": ["instance"], "regex": ":(\\d+)", "target_label": "port_$1",
+            "replacement": "p${1}0$$"})JSON",
+        R"JSON({"action": "replace", "source_labels": ["mode", "cpu"], "separator": "/", "regex": "(.*)/(.*)",
+            "target_label": "mc", "replacement": "${2}_$1"})JSON",
+        R"JSON({"action": "replace", "source_labels": ["job"], "regex": "(a)|(b)", "target_label": "g",
+            "replacement": "[$1|$2]"})JSON",
+        R"JSON({"action": "replace", "source_labels": ["job"], "regex": "(x?)", "target_label": "job"})JSON",
+        R"JSON({"action": "replace", "source_labels": ["job"], "regex": "(\\w)\\1", "target_label": "dup"})JSON",
+        R"JSON({"action": "replace", "source_labels": ["__name__"], "regex": "node_(.*)", "target_label": "__name__",
+            "replacement": "n_$1"})JSON",
+        R"JSON({"action": "replace", "source_labels": ["msg"], "regex": "^(b.*)$", "target_label": "line"})JSON",
+        R"JSON({"action": "replace", "source_labels": ["msg"], "regex": "c$", "target_label": "end",
+            "replacement": "x"})JSON",
+        R"JSON({"action": "lowercase", "source_labels": ["mode"], "target_label": "mode"})JSON",
+        R"JSON({"action": "hashmod", "source_labels": ["instance"], "target_label": "shard", "modulus": 7})JSON",
+        R"JSON({"action": "labelmap", "regex": "__meta_(.*)", "replacement": "m_$1"})JSON",
+        R"JSON({"action": "labelmap", "regex": "(a*)", "replacement": "y$1"})JSON",
+        R"JSON({"action": "labeldrop", "regex": "__meta_.*|cpu"})JSON",
+        R"JSON({"action": "labelkeep", "regex": "__name__|job|instance|m.*"})JSON",
+        R"JSON({"action": "dropequal", "source_labels": ["cpu"], "target_label": "mode"})JSON",
+        R"JSON({"action": "dropmetric", "match_list": ["up"]})JSON",
+    };
+    vector<vector<pair<string, string>>> labelSets = {
+        {{"__name__", "node_cpu_seconds_total"}, {"cpu", "0"}, {"mode", "idle"}, {"job", "aa"}, {"instance", "h:9100"}},
+        {{"__name__", "up"}, {"job", "a.b"}, {"instance", "a.b"}, {"__meta_pod", "p1"}, {"__meta_ns", "n"}},
+        {{"__name__", "node_load1"}, {"job", "b"}, {"mode", "USER"}, {"cpu", "USER"}, {"aa", "1"}},
+        // ^ and $ also match at the line feeds
+        {{"__name__", "node_log"}, {"msg", "a\nbc\nd"}, {"instance", "h:1"}},
+    };
+    // each config alone, and all of them in turn from each one on
+    for (size_t i = 0; i < configStrs.size(); ++i) {
+        for (size_t end : {i + 1, configStrs.size()}) {
+            Json::Value configJson(Json::arrayValue);
+            for (size_t j = i; j < end; ++j) {
+                Json::Value config;
+                string errorMsg;
+                APSARA_TEST_TRUE(ParseJsonTable(configStrs[j], config, errorMsg));
+                configJson.append(config);
+            }
+            RelabelConfigList configList;
+            APSARA_TEST_TRUE(configList.Init(configJson));
+            for (const auto& labelSet : labelSets) {
+                Labels labels;
+                PipelineEventGroup eGroup(make_shared<SourceBuffer>());
+                auto* e = eGroup.AddMetricEvent();
+                e->SetName(labelSet[0].second);
+                labels.Set(labelSet[0].first, labelSet[0].second);
+                for (size_t j = 1; j < labelSet.size(); ++j) {
+                    e->SetTag(labelSet[j].first, labelSet[j].second);
+                    labels.Set(labelSet[j].first, labelSet[j].second);
+                }
+
+                bool expected = configList.Process(labels);
+                APSARA_TEST_EQUAL(expected, configList.Process(*e));
+                if (!expected) {
+                    continue;
+                }
+                map<string, string> tags;
+                for (auto tag = e->TagsBegin(); tag != e->TagsEnd(); ++tag) {
+                    tags[tag->first.to_string()] = tag->second.to_string();
+                }
+                map<string, string> expectedTags;
+                labels.Range([&expectedTags](const string& k, const string& v) { expectedTags[k] = v; });
+                APSARA_TEST_EQUAL(expectedTags, tags);
+            }
+        }
+    }
+}
+
 UNIT_TEST_CASE(ActionConverterUnittest, TestStringToAction)
 UNIT_TEST_CASE(ActionConverterUnittest, TestActionToString)
 
@@ -528,6 +657,8 @@ UNIT_TEST_CASE(RelabelConfigUnittest, TestKeepEqual)
 UNIT_TEST_CASE(RelabelConfigUnittest, TestLowerCase)
 UNIT_TEST_CASE(RelabelConfigUnittest, TestUpperCase)
 UNIT_TEST_CASE(RelabelConfigUnittest, TestMultiRelabel)
+UNIT_TEST_CASE(RelabelConfigUnittest, TestCompileRelabelConfigs)
+UNIT_TEST_CASE(RelabelConfigUnittest, TestCompiledRelabelMetricEvent)
 
 } // namespace logtail
 
@@ -352,10 +352,33 @@ void ScrapeConfigUnittest::TestScrapeProtocols() {
     APSARA_TEST_TRUE(ParseJsonTable(configStr, config, errorMsg));
     scrapeConfig.mRequestHeaders.clear();
     APSARA_TEST_TRUE(scrapeConfig.Init(config));
-    APSARA_TEST_EQUAL("application/openmetrics-text;version=1.0.0;q=0.4,"
+    APSARA_TEST_EQUAL("application/vnd.google.protobuf;proto=io.prometheus.client.MetricFamily;"
+                      "encoding=delimited;q=0.5,"
+                      "application/openmetrics-text;version=1.0.0;q=0.4,"
                       "text/plain;version=0.0.4;q=0.3,application/openmetrics-text;version=0.0.1;q=0.2,*/*;q=0.1",
                       scrapeConfig.mRequestHeaders["Accept"]);
 
+    // native histograms, preferring protobuf by default
+    configStr = R"JSON({
+            "job_name": "test_job",
+            "scrape_interval": "30s",
+            "scrape_timeout": "30s",
+            "metrics_path": "/metrics",
+            "scheme": "http",
+            "scrape_native_histograms": true
+        })JSON";
+    APSARA_TEST_TRUE(ParseJsonTable(configStr, config, errorMsg));
+    scrapeConfig.mRequestHeaders.clear();
+    APSARA_TEST_TRUE(scrapeConfig.Init(config));
+    APSARA_TEST_TRUE(scrapeConfig.mScrapeNativeHistograms);
+    APSARA_TEST_EQUAL("application/vnd.google.protobuf;proto=io.prometheus.client.MetricFamily;"
+                      "encoding=delimited;q=0.5,"
+                      "text/plain;version=0.0.4;q=0.4,"
+                      "application/openmetrics-text;version=0.0.1;q=0.3,"
+                      "application/openmetrics-text;version=1.0.0;q=0.2,"
+                      "*/*;q=0.1",
+                      scrapeConfig.mRequestHeaders["Accept"]);
+
     // only prometheus0.0.4 protocols
     configStr = R"JSON({
             "job_name": "test_job",
@@ -0,0 +1,225 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/Flags.h"
+#include "common/JsonUtil.h"
+#include "common/StringTools.h"
+#include "models/EventPool.h"
+#include "plugin/processor/inner/ProcessorPromRelabelMetricNative.h"
+#include "prometheus/Constants.h"
+#include "prometheus/component/SeriesCache.h"
+#include "prometheus/component/StreamScraper.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+DECLARE_FLAG_INT64(prom_stream_bytes_size);
+
+namespace logtail::prom {
+
+// Scrapes a node exporter like payload repeatedly, where only the values change between scrapes, and compares parsing
+// every series and relabeling it afterwards, as the relabel processor does, with the series cache.
+class SeriesCacheBenchmark : public ::testing::Test {
+public:
+    void TestWithoutSeriesCache();
+    void TestWithSeriesCache();
+
+protected:
+    void SetUp() override {
+        INT64_FLAG(prom_stream_bytes_size) = 1024 * 1024;
+        for (size_t i = 0; i < kScrapeCnt; ++i) {
+            mBodies.emplace_back(GenerateBody(i));
+        }
+        mScrapeConfig = make_shared<ScrapeConfig>();
+        mScrapeConfig->mJobName = "node-exporter";
+        string configStr = R"JSON(
+            [
+                {
+                    "action": "drop",
+                    "regex": "go_.*|node_softnet_.*",
+                    "source_labels": ["__name__"]
+                },
+                {
+                    "action": "labeldrop",
+                    "regex": "fstype"
+                }
+            ]
+        )JSON";
+        string errorMsg;
+        Json::Value config;
+        APSARA_TEST_TRUE(ParseJsonTable(configStr, config, errorMsg));
+        APSARA_TEST_TRUE(mScrapeConfig->mMetricRelabelConfigs.Init(config));
+        mScrapeConfig->mExternalLabels = {{"cluster", "benchmark"}};
+
+        mLabels.Set("job", "node-exporter");
+        mLabels.Set("instance", "192.168.0.1:9100");
+        mLabels.Set("node", "cn-hangzhou.192.168.0.1");
+        mLabels.Set(prometheus::ADDRESS_LABEL_NAME, "192.168.0.1:9100");
+    }
+
+    static string GenerateBody(size_t scrapeIdx);
+    void Run(const string& name, const shared_ptr<SeriesCache>& seriesCache);
+
+    static constexpr size_t kScrapeCnt = 100;
+    static constexpr size_t kChunkSize = 16 * 1024;
+
+    vector<string> mBodies;
+    shared_ptr<ScrapeConfig> mScrapeConfig;
+    Labels mLabels;
+    EventPool mEventPool{true};
+};
+
+string SeriesCacheBenchmark::GenerateBody(size_t scrapeIdx) {
+    string body;
+    auto value = [scrapeIdx](size_t seed) { return ToString(seed * 1000.5 + scrapeIdx * 7.25); };
+    auto family = [&body](const string& name, const string& type) {
+        body += "# HELP " + name + " " + name + " from the node exporter.\n";
+        body += "# TYPE " + name + " " + type + "\n";
+    };
+
+    family("node_cpu_seconds_total", "counter");
+    for (size_t cpu = 0; cpu < 32; ++cpu) {
+        for (const auto* mode : {"idle", "iowait", "irq", "nice", "softirq", "steal", "system", "user"}) {
+            body += "node_cpu_seconds_total{cpu=\"" + ToString(cpu) + "\",mode=\"" + mode + "\"} "
+                + value(cpu) + "\n";
+        }
+    }
+    for (const auto* name : {"node_filesystem_avail_bytes",
+                             "node_filesystem_device_error",
+                             "node_filesystem_files",
+                             "node_filesystem_files_free",
+                             "node_filesystem_free_bytes",
+                             "node_filesystem_readonly",
+                             "node_filesystem_size_bytes"}) {
+        family(name, "gauge");
+        for (size_t fs = 0; fs < 20; ++fs) {
+            body += string(name) + "{device=\"/dev/vdb" + ToString(fs) + "\",fstype=\"ext4\",mountpoint=\"/var/lib/"
+                + "kubelet/pods/3f1a8c7e-5b2d-4e6f-9a0b-" + ToString(100000 + fs) + "/volumes\"} " + value(fs) + "\n";
+        }
+    }
+    for (const auto* dir : {"receive", "transmit"}) {
+        for (const auto* item : {"bytes", "compressed", "drop", "errs", "fifo", "packets"}) {
+            auto name = string("node_network_") + dir + "_" + item + "_total";
+            family(name, "counter");
+            for (size_t dev = 0; dev < 16; ++dev) {
+                body += name + "{device=\"veth" + ToString(dev * 7919) + "\"} " + value(dev) + "\n";
+            }
+        }
+    }
+    for (const auto* item : {"io_time_seconds",
+                             "read_bytes",
+                             "read_time_seconds",
+                             "reads_completed",
+                             "write_time_seconds",
+                             "writes_completed",
+                             "written_bytes"}) {
+        auto name = string("node_disk_") + item + "_total";
+        family(name, "counter");
+        for (size_t disk = 0; disk < 8; ++disk) {
+            body += name + "{device=\"vd" + string(1, 'a' + disk) + "\"} " + value(disk) + "\n";
+        }
+    }
+    for (size_t i = 0; i < 50; ++i) {
+        auto name = "node_memory_Item" + ToString(i) + "_bytes";
+        family(name, "gauge");
+        body += name + " " + value(i) + "\n";
+    }
+    for (const auto* item : {"dropped", "processed", "times_squeezed"}) {
+        auto name = string("node_softnet_") + item + "_total";
+        family(name, "counter");
+        for (size_t cpu = 0; cpu < 32; ++cpu) {
+            body += name + "{cpu=\"" + ToString(cpu) + "\"} " + value(cpu) + "\n";
+        }
+    }
+    family("go_gc_duration_seconds", "summary");
+    for (const auto* quantile : {"0", "0.25", "0.5", "0.75", "1"}) {
+        body += string("go_gc_duration_seconds{quantile=\"") + quantile + "\"} " + value(1) + "\n";
+    }
+    family("node_uname_info", "gauge");
+    body += "node_uname_info{domainname=\"(none)\",machine=\"x86_64\",nodename=\"iZbp1\",release=\"5.10.134-16.al8."
+            "x86_64\",sysname=\"Linux\",version=\"#1 SMP Thu Dec 7 14:11:24 CST 2023\"} 1\n";
+    return body;
+}
+
+void SeriesCacheBenchmark::Run(const string& name, const shared_ptr<SeriesCache>& seriesCache) {
+    size_t eventCnt = 0;
+    size_t bytes = 0;
+    auto scrapeTime = chrono::system_clock::now();
+    auto start = chrono::steady_clock::now();
+    for (const auto& body : mBodies) {
+        StreamScraper scraper(mLabels, 0, 0, "id", &mEventPool, scrapeTime);
+        scraper.EnableStreamParse(true);
+        if (seriesCache) {
+            scraper.EnableSeriesCache(seriesCache, mScrapeConfig);
+        }
+        // the response is received in chunks
+        for (size_t pos = 0; pos < body.size(); pos += kChunkSize) {
+            auto len = min(kChunkSize, body.size() - pos);
+            StreamScraper::MetricWriteCallback(const_cast<char*>(body.data() + pos), 1, len, &scraper);
+        }
+        scraper.FlushCache();
+        scraper.SendMetrics();
+        if (seriesCache) {
+            seriesCache->OnScrapeDone();
+        }
+        for (auto& item : scraper.mItem) {
+            auto& eGroup = item->mEventGroup;
+            if (!eGroup.HasMetadata(EventGroupMetaKey::PROMETHEUS_METRIC_RELABELED)) {
+                // what the relabel processor does
+                auto targetTags = eGroup.GetTags();
+                auto& events = eGroup.MutableEvents();
+                size_t wIdx = 0;
+                for (size_t rIdx = 0; rIdx < events.size(); ++rIdx) {
+                    if (ProcessorPromRelabelMetricNative::RelabelMetricEvent(
+                            events[rIdx].Cast<MetricEvent>(), targetTags, *mScrapeConfig)) {
+                        if (wIdx != rIdx) {
+                            events[wIdx] = std::move(events[rIdx]);
+                        }
+                        ++wIdx;
+                    }
+                }
+                events.resize(wIdx);
+            }
+            eventCnt += eGroup.GetEvents().size();
+        }
+        bytes += body.size();
+    }
+    auto cost = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+    cout << "[" << name << "] scrapes: " << kScrapeCnt << "\tbytes per scrape: " << bytes / kScrapeCnt
+         << "\tevents per scrape: " << eventCnt / kScrapeCnt << "\tcost per scrape: " << cost / kScrapeCnt << "us"
+         << endl;
+}
+
+void SeriesCacheBenchmark::TestWithoutSeriesCache() {
+    Run("without series cache", nullptr);
+}
+
+void SeriesCacheBenchmark::TestWithSeriesCache() {
+    auto seriesCache = make_shared<SeriesCache>(200000, 2);
+    Run("with series cache", seriesCache);
+    cout << "cached series: " << seriesCache->Size() << endl;
+}
+
+UNIT_TEST_CASE(SeriesCacheBenchmark, TestWithoutSeriesCache)
+UNIT_TEST_CASE(SeriesCacheBenchmark, TestWithSeriesCache)
+
+} // namespace logtail::prom
+
+UNIT_TEST_MAIN
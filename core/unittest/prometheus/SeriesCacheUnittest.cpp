@@ -0,0 +1,154 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+
+#include "common/StringTools.h"
+#include "models/MetricEvent.h"
+#include "models/PipelineEventGroup.h"
+#include "prometheus/component/SeriesCache.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail::prom {
+
+class SeriesCacheUnittest : public ::testing::Test {
+public:
+    void TestGetAndAdd();
+    void TestEvict();
+    void TestCompact();
+    void TestMaxSeries();
+
+protected:
+    MetricEvent* CreateEvent(const string& name, const string& value) {
+        auto* e = mEventGroup.AddMetricEvent();
+        e->SetName(name);
+        e->SetTag(string("k1"), value);
+        e->SetTag(string("job"), string("test_job"));
+        return e;
+    }
+
+    PipelineEventGroup mEventGroup = PipelineEventGroup(make_shared<SourceBuffer>());
+};
+
+void SeriesCacheUnittest::TestGetAndAdd() {
+    SeriesCache cache(100, 1);
+    string text1 = R"(test_metric{k1="v1"})";
+    string text2 = R"(test_metric{k1="v2"})";
+    APSARA_TEST_EQUAL(nullptr, cache.Get(text1));
+
+    cache.Add(text1, CreateEvent("test_metric", "v1"));
+    cache.Add(text2, nullptr);
+    // the cache refers to neither the text nor the event added
+    text1.assign(text1.size(), 'x');
+    mEventGroup = PipelineEventGroup(make_shared<SourceBuffer>());
+
+    const auto* series = cache.Get(R"(test_metric{k1="v1"})");
+    APSARA_TEST_NOT_EQUAL(nullptr, series);
+    APSARA_TEST_FALSE(series->mDropped);
+    APSARA_TEST_EQUAL("test_metric", series->mName);
+    APSARA_TEST_EQUAL(2U, series->mTags.size());
+    APSARA_TEST_EQUAL("k1", series->mTags[0].first);
+    APSARA_TEST_EQUAL("v1", series->mTags[0].second);
+    APSARA_TEST_EQUAL("job", series->mTags[1].first);
+    APSARA_TEST_EQUAL("test_job", series->mTags[1].second);
+    APSARA_TEST_TRUE(cache.Get(text2)->mDropped);
+    APSARA_TEST_EQUAL(2U, cache.Size());
+
+    // strings are interned
+    cache.Add("other", CreateEvent("other", "test_job"));
+    const auto* other = cache.Get("other");
+    APSARA_TEST_EQUAL(series->mTags[0].first.data(), other->mTags[0].first.data());
+    APSARA_TEST_EQUAL(series->mTags[1].second.data(), other->mTags[0].second.data());
+
+    // the latest series wins on hash collision
+    auto hash = SeriesCache::Hash(text2);
+    cache.mSeries[hash].mText = "collided";
+    APSARA_TEST_EQUAL(nullptr, cache.Get(text2));
+    cache.Add(text2, CreateEvent("test_metric", "v2"));
+    APSARA_TEST_FALSE(cache.Get(text2)->mDropped);
+    APSARA_TEST_EQUAL(3U, cache.Size());
+}
+
+void SeriesCacheUnittest::TestEvict() {
+    SeriesCache cache(100, 2);
+    cache.Add("s1", CreateEvent("s1", "v1"));
+    cache.Add("s2", nullptr);
+    cache.OnScrapeDone();
+
+    cache.Get("s1");
+    cache.OnScrapeDone();
+    APSARA_TEST_EQUAL(2U, cache.Size());
+
+    // s2 is absent from 2 scrapes
+    cache.OnScrapeDone();
+    APSARA_TEST_EQUAL(1U, cache.Size());
+    APSARA_TEST_NOT_EQUAL(nullptr, cache.Get("s1"));
+    APSARA_TEST_EQUAL(nullptr, cache.Get("s2"));
+
+    cache.OnScrapeDone();
+    cache.OnScrapeDone();
+    cache.OnScrapeDone();
+    APSARA_TEST_EQUAL(0U, cache.Size());
+}
+
+void SeriesCacheUnittest::TestCompact() {
+    SeriesCache cache(100, 1);
+    for (int i = 0; i < 10; ++i) {
+        cache.Add("s" + ToString(i), CreateEvent("test_metric", "v" + ToString(i)));
+    }
+    auto oldSourceBuffer = cache.GetSourceBuffer();
+    cache.OnScrapeDone();
+    for (int i = 0; i < 6; ++i) {
+        cache.Get("s" + ToString(i));
+    }
+    // no more than half are evicted
+    cache.OnScrapeDone();
+    APSARA_TEST_EQUAL(oldSourceBuffer, cache.GetSourceBuffer());
+    APSARA_TEST_EQUAL(6U, cache.Size());
+
+    cache.Get("s0");
+    cache.OnScrapeDone();
+    APSARA_TEST_NOT_EQUAL(oldSourceBuffer, cache.GetSourceBuffer());
+    APSARA_TEST_EQUAL(0U, cache.mEvictedCnt);
+    APSARA_TEST_EQUAL(1U, cache.Size());
+    // the series is still intact after the old buffer is released
+    oldSourceBuffer.reset();
+    mEventGroup = PipelineEventGroup(make_shared<SourceBuffer>());
+    const auto* series = cache.Get("s0");
+    APSARA_TEST_NOT_EQUAL(nullptr, series);
+    APSARA_TEST_EQUAL("s0", series->mText);
+    APSARA_TEST_EQUAL("test_metric", series->mName);
+    APSARA_TEST_EQUAL("v0", series->mTags[0].second);
+}
+
+void SeriesCacheUnittest::TestMaxSeries() {
+    SeriesCache cache(2, 1);
+    cache.Add("s1", nullptr);
+    cache.Add("s2", nullptr);
+    cache.Add("s3", nullptr);
+    APSARA_TEST_EQUAL(2U, cache.Size());
+    APSARA_TEST_EQUAL(nullptr, cache.Get("s3"));
+}
+
+UNIT_TEST_CASE(SeriesCacheUnittest, TestGetAndAdd)
+UNIT_TEST_CASE(SeriesCacheUnittest, TestEvict)
+UNIT_TEST_CASE(SeriesCacheUnittest, TestCompact)
+UNIT_TEST_CASE(SeriesCacheUnittest, TestMaxSeries)
+
+} // namespace logtail::prom
+
+UNIT_TEST_MAIN
@@ -20,22 +20,33 @@
 
 #include "EventPool.h"
 #include "Flags.h"
+#include "common/JsonUtil.h"
+#include "common/http/Constant.h"
+#include "common/http/HttpResponse.h"
+#include "models/MetricEvent.h"
 #include "models/RawEvent.h"
 #include "prometheus/Constants.h"
+#include "prometheus/component/SeriesCache.h"
 #include "prometheus/component/StreamScraper.h"
 #include "prometheus/labels/Labels.h"
 #include "prometheus/schedulers/ScrapeConfig.h"
 #include "unittest/Unittest.h"
+#include "unittest/prometheus/ProtobufWriter.h"
 
 using namespace std;
 
 DECLARE_FLAG_INT64(prom_stream_bytes_size);
+DECLARE_FLAG_INT64(prom_max_protobuf_message_size);
 
 namespace logtail::prom {
 class StreamScraperUnittest : public testing::Test {
 public:
     void TestStreamMetricWriteCallback();
     void TestStreamSendMetric();
+    void TestStreamParse();
+    void TestStreamParseWithSeriesCache();
+    void TestStreamParseProtobuf();
+    void TestStreamParseProtobufHonorTimestamps();
 
 
 protected:
@@ -179,9 +190,261 @@ void StreamScraperUnittest::TestStreamSendMetric() {
     APSARA_TEST_EQUAL("go_memstats_alloc_bytes_total 1.5159292e+08", res1.GetEvents()[3].Cast<RawEvent>().GetContent());
 }
 
+void StreamScraperUnittest::TestStreamParse() {
+    EventPool eventPool{true};
+    INT64_FLAG(prom_stream_bytes_size) = 1024 * 1024;
+
+    Labels labels;
+    auto scrapeTime = std::chrono::system_clock::time_point(std::chrono::milliseconds(1715829785123));
+    auto streamScraper = make_shared<StreamScraper>(labels, 0, 0, "id", &eventPool, scrapeTime);
+    streamScraper->EnableStreamParse(true);
+
+    // lines split across callbacks, invalid samples and comments
+    string body1 = "# TYPE go_gc_duration_seconds summary\n"
+                   "go_gc_duration_seconds{quantile=\"0.25\"} 3.9357e-05\n"
+                   "go_gc_duration_seconds_sum 0.0348856";
+    string body2 = "31\n"
+                   "invalid{ 1\n"
+                   "go_info{version=\"go1.22.3\",os=\"linux\"} 1 1715829785083\n"
+                   "go_goroutines 7";
+    StreamScraper::MetricWriteCallback(body1.data(), (size_t)1, (size_t)body1.length(), streamScraper.get());
+    StreamScraper::MetricWriteCallback(body2.data(), (size_t)1, (size_t)body2.length(), streamScraper.get());
+    streamScraper->FlushCache();
+    // the parsed events do not refer to the response
+    body1.assign(body1.size(), 'x');
+    body2.assign(body2.size(), 'x');
+
+    const auto& events = streamScraper->mEventGroup.GetEvents();
+    APSARA_TEST_EQUAL(4UL, events.size());
+    APSARA_TEST_EQUAL(5UL, streamScraper->mScrapeSamplesScraped);
+
+    const auto& e0 = events[0].Cast<MetricEvent>();
+    APSARA_TEST_EQUAL("go_gc_duration_seconds", e0.GetName());
+    APSARA_TEST_EQUAL("go_gc_duration_seconds", e0.GetTag(prometheus::NAME));
+    APSARA_TEST_EQUAL("0.25", e0.GetTag("quantile"));
+    APSARA_TEST_EQUAL(3.9357e-05, e0.GetValue<UntypedSingleValue>()->mValue);
+    APSARA_TEST_EQUAL(1715829785, e0.GetTimestamp());
+    APSARA_TEST_EQUAL(123000000U, e0.GetTimestampNanosecond().value());
+
+    const auto& e1 = events[1].Cast<MetricEvent>();
+    APSARA_TEST_EQUAL("go_gc_duration_seconds_sum", e1.GetName());
+    APSARA_TEST_EQUAL(0.034885631, e1.GetValue<UntypedSingleValue>()->mValue);
+
+    const auto& e2 = events[2].Cast<MetricEvent>();
+    APSARA_TEST_EQUAL("go_info", e2.GetName());
+    APSARA_TEST_EQUAL("go1.22.3", e2.GetTag("version"));
+    APSARA_TEST_EQUAL("linux", e2.GetTag("os"));
+    APSARA_TEST_EQUAL(1715829785, e2.GetTimestamp());
+    APSARA_TEST_EQUAL(83000000U, e2.GetTimestampNanosecond().value());
+
+    const auto& e3 = events[3].Cast<MetricEvent>();
+    APSARA_TEST_EQUAL("go_goroutines", e3.GetName());
+    APSARA_TEST_EQUAL(7.0, e3.GetValue<UntypedSingleValue>()->mValue);
+}
+
+void StreamScraperUnittest::TestStreamParseWithSeriesCache() {
+    EventPool eventPool{true};
+    INT64_FLAG(prom_stream_bytes_size) = 1024 * 1024;
+
+    string configStr = R"JSON(
+        [
+            {
+                "action": "drop",
+                "regex": "go_info",
+                "source_labels": ["__name__"]
+            }
+        ]
+    )JSON";
+    string errorMsg;
+    Json::Value config;
+    APSARA_TEST_TRUE(ParseJsonTable(configStr, config, errorMsg));
+    APSARA_TEST_TRUE(mScrapeConfig->mMetricRelabelConfigs.Init(config));
+    mScrapeConfig->mExternalLabels = {{"cluster", "test_cluster"}};
+
+    Labels labels;
+    labels.Set("job", "test_job");
+    labels.Set(prometheus::ADDRESS_LABEL_NAME, "localhost:8080");
+    auto seriesCache = make_shared<SeriesCache>(100, 1);
+    auto scrapeTime = std::chrono::system_clock::time_point(std::chrono::milliseconds(1715829785123));
+
+    auto scrape = [&](string body) {
+        auto streamScraper = make_shared<StreamScraper>(labels, 0, 0, "id", &eventPool, scrapeTime);
+        streamScraper->EnableStreamParse(true);
+        streamScraper->EnableSeriesCache(seriesCache, mScrapeConfig);
+        StreamScraper::MetricWriteCallback(body.data(), (size_t)1, (size_t)body.length(), streamScraper.get());
+        streamScraper->FlushCache();
+        body.assign(body.size(), 'x');
+        APSARA_TEST_EQUAL(3UL, streamScraper->mScrapeSamplesScraped);
+        streamScraper->SendMetrics();
+        seriesCache->OnScrapeDone();
+        return std::move(streamScraper->mItem[0]->mEventGroup);
+    };
+
+    auto check = [&](PipelineEventGroup& eGroup, double gcValue, double goroutinesValue) {
+        APSARA_TEST_TRUE(eGroup.HasMetadata(EventGroupMetaKey::PROMETHEUS_METRIC_RELABELED));
+        APSARA_TEST_EQUAL(1U, eGroup.GetExtraSourceBuffers().count(seriesCache->GetSourceBuffer()));
+        const auto& events = eGroup.GetEvents();
+        // go_info is dropped
+        APSARA_TEST_EQUAL(2UL, events.size());
+
+        const auto& e0 = events[0].Cast<MetricEvent>();
+        APSARA_TEST_EQUAL("go_gc_duration_seconds", e0.GetName());
+        APSARA_TEST_EQUAL(3U, e0.TagsSize());
+        APSARA_TEST_EQUAL("0.25", e0.GetTag("quantile"));
+        APSARA_TEST_EQUAL("test_job", e0.GetTag("job"));
+        APSARA_TEST_EQUAL("test_cluster", e0.GetTag("cluster"));
+        APSARA_TEST_EQUAL(gcValue, e0.GetValue<UntypedSingleValue>()->mValue);
+        APSARA_TEST_EQUAL(1715829785, e0.GetTimestamp());
+
+        const auto& e1 = events[1].Cast<MetricEvent>();
+        APSARA_TEST_EQUAL("go_goroutines", e1.GetName());
+        APSARA_TEST_FALSE(e1.HasTag(prometheus::NAME));
+        APSARA_TEST_FALSE(e1.HasTag(prometheus::ADDRESS_LABEL_NAME));
+        APSARA_TEST_EQUAL(goroutinesValue, e1.GetValue<UntypedSingleValue>()->mValue);
+    };
+
+    auto eGroup1 = scrape("go_gc_duration_seconds{quantile=\"0.25\"} 3.9357e-05\n"
+                          "go_info{version=\"go1.22.3\"} 1\n"
+                          "go_goroutines 7\n");
+    check(eGroup1, 3.9357e-05, 7.0);
+    APSARA_TEST_EQUAL(3U, seriesCache->Size());
+
+    // series of the previous scrape are served by the cache with only the samples parsed
+    auto eGroup2 = scrape("go_gc_duration_seconds{quantile=\"0.25\"} 4.1114e-05\n"
+                          "go_info{version=\"go1.22.3\"} 1\n"
+                          "go_goroutines 8\n");
+    check(eGroup2, 4.1114e-05, 8.0);
+    const auto* series = seriesCache->Get("go_goroutines");
+    APSARA_TEST_NOT_EQUAL(nullptr, series);
+    APSARA_TEST_EQUAL(series->mName.data(), eGroup2.GetEvents()[1].Cast<MetricEvent>().GetName().data());
+}
+
+void StreamScraperUnittest::TestStreamParseProtobuf() {
+    EventPool eventPool{true};
+    INT64_FLAG(prom_stream_bytes_size) = 1024 * 1024;
+
+    string goroutines = ProtobufWriter()
+                            .Bytes(1, "go_goroutines")
+                            .Varint(3, 1)
+                            .Message(4, ProtobufWriter().Message(2, ProtobufWriter().Double(1, 7)))
+                            .Delimited();
+    string requests = ProtobufWriter()
+                          .Bytes(1, "http_requests_total")
+                          .Varint(3, 0)
+                          .Message(4,
+                                   ProtobufWriter()
+                                       .Message(1, ProtobufWriter::Label("code", "200"))
+                                       .Message(3, ProtobufWriter().Double(1, 1027)))
+                          .Message(4,
+                                   ProtobufWriter()
+                                       .Message(1, ProtobufWriter::Label("code", "400"))
+                                       .Message(3, ProtobufWriter().Double(1, 3)))
+                          .Delimited();
+    // long enough for a length prefix of 2 bytes
+    string help(200, 'h');
+    string latency = ProtobufWriter()
+                         .Bytes(1, "latency_seconds")
+                         .Bytes(2, help)
+                         .Varint(3, 4)
+                         .Message(4,
+                                  ProtobufWriter().Message(7,
+                                                           ProtobufWriter().Varint(1, 3).Double(2, 0.5).Message(
+                                                               3, ProtobufWriter().Varint(1, 2).Double(2, 0.1))))
+                         .Delimited();
+    string body = goroutines + requests + latency;
+
+    HttpResponse response;
+    response.AddHeader(CONTENT_TYPE,
+                       "application/vnd.google.protobuf; proto=io.prometheus.client.MetricFamily; encoding=delimited");
+    auto scrapeTime = std::chrono::system_clock::time_point(std::chrono::milliseconds(1715829785123));
+    auto streamScraper = make_shared<StreamScraper>(Labels(), 0, 0, "id", &eventPool, scrapeTime);
+    streamScraper->SetResponseHeader(response);
+
+    // messages and their length prefixes split across callbacks
+    for (size_t pos = 0; pos < body.size(); pos += 3) {
+        string chunk = body.substr(pos, 3);
+        StreamScraper::MetricWriteCallback(chunk.data(), (size_t)1, chunk.size(), streamScraper.get());
+        chunk.assign(chunk.size(), 'x');
+    }
+    streamScraper->FlushCache();
+    APSARA_TEST_EQUAL(body.size(), streamScraper->mRawSize);
+    APSARA_TEST_EQUAL(7UL, streamScraper->mScrapeSamplesScraped);
+
+    const auto& events = streamScraper->mEventGroup.GetEvents();
+    APSARA_TEST_EQUAL(7UL, events.size());
+    const auto& e0 = events[0].Cast<MetricEvent>();
+    APSARA_TEST_EQUAL("go_goroutines", e0.GetName());
+    APSARA_TEST_EQUAL("go_goroutines", e0.GetTag(prometheus::NAME));
+    APSARA_TEST_EQUAL(7.0, e0.GetValue<UntypedSingleValue>()->mValue);
+    APSARA_TEST_EQUAL(1715829785, e0.GetTimestamp());
+    APSARA_TEST_EQUAL(123000000U, e0.GetTimestampNanosecond().value());
+    const auto& e2 = events[2].Cast<MetricEvent>();
+    APSARA_TEST_EQUAL("http_requests_total", e2.GetName());
+    APSARA_TEST_EQUAL("400", e2.GetTag("code"));
+    APSARA_TEST_EQUAL(3.0, e2.GetValue<UntypedSingleValue>()->mValue);
+    const auto& e3 = events[3].Cast<MetricEvent>();
+    APSARA_TEST_EQUAL("latency_seconds_bucket", e3.GetName());
+    APSARA_TEST_EQUAL("latency_seconds_bucket", e3.GetTag(prometheus::NAME));
+    APSARA_TEST_EQUAL("0.1", e3.GetTag("le"));
+    APSARA_TEST_EQUAL("+Inf", events[4].Cast<MetricEvent>().GetTag("le"));
+    APSARA_TEST_EQUAL("latency_seconds_count", events[6].Cast<MetricEvent>().GetName());
+
+    // the incomplete message of a truncated body is dropped
+    streamScraper->Reset();
+    string truncated = goroutines + requests.substr(0, requests.size() - 1);
+    StreamScraper::MetricWriteCallback(truncated.data(), (size_t)1, truncated.size(), streamScraper.get());
+    streamScraper->FlushCache();
+    APSARA_TEST_EQUAL(1UL, streamScraper->mEventGroup.GetEvents().size());
+
+    // the rest of the body is dropped after an oversized message
+    streamScraper->Reset();
+    INT64_FLAG(prom_max_protobuf_message_size) = 128;
+    StreamScraper::MetricWriteCallback(body.data(), (size_t)1, body.size(), streamScraper.get());
+    streamScraper->FlushCache();
+    APSARA_TEST_EQUAL(3UL, streamScraper->mEventGroup.GetEvents().size());
+    INT64_FLAG(prom_max_protobuf_message_size) = 16 * 1024 * 1024;
+
+    // text bodies are still split into lines
+    streamScraper->Reset();
+    response.AddHeader(CONTENT_TYPE, "text/plain; version=0.0.4");
+    string text = "go_goroutines 7\n";
+    StreamScraper::MetricWriteCallback(text.data(), (size_t)1, text.size(), streamScraper.get());
+    APSARA_TEST_EQUAL(1UL, streamScraper->mEventGroup.GetEvents().size());
+    APSARA_TEST_EQUAL("go_goroutines 7", streamScraper->mEventGroup.GetEvents()[0].Cast<RawEvent>().GetContent());
+}
+
+void StreamScraperUnittest::TestStreamParseProtobufHonorTimestamps() {
+    EventPool eventPool{true};
+    string body = ProtobufWriter()
+                      .Bytes(1, "go_goroutines")
+                      .Varint(3, 1)
+                      .Message(4, ProtobufWriter().Message(2, ProtobufWriter().Double(1, 7)).Varint(6, 1715829785083))
+                      .Delimited();
+    HttpResponse response;
+    response.AddHeader(CONTENT_TYPE,
+                       "application/vnd.google.protobuf; proto=io.prometheus.client.MetricFamily; encoding=delimited");
+    auto scrapeTime = std::chrono::system_clock::time_point(std::chrono::milliseconds(1715829786123));
+    for (bool honorTimestamps : {true, false}) {
+        // stream parse is not enabled
+        auto streamScraper = make_shared<StreamScraper>(Labels(), 0, 0, "id", &eventPool, scrapeTime);
+        streamScraper->SetHonorTimestamps(honorTimestamps);
+        streamScraper->SetResponseHeader(response);
+        StreamScraper::MetricWriteCallback(body.data(), (size_t)1, body.size(), streamScraper.get());
+        streamScraper->FlushCache();
+        const auto& events = streamScraper->mEventGroup.GetEvents();
+        APSARA_TEST_EQUAL_FATAL(1UL, events.size());
+        const auto& e = events[0].Cast<MetricEvent>();
+        APSARA_TEST_EQUAL(honorTimestamps ? 1715829785 : 1715829786, e.GetTimestamp());
+        APSARA_TEST_EQUAL(honorTimestamps ? 83000000U : 123000000U, e.GetTimestampNanosecond().value());
+    }
+}
 
 UNIT_TEST_CASE(StreamScraperUnittest, TestStreamMetricWriteCallback)
 UNIT_TEST_CASE(StreamScraperUnittest, TestStreamSendMetric)
+UNIT_TEST_CASE(StreamScraperUnittest, TestStreamParse)
+UNIT_TEST_CASE(StreamScraperUnittest, TestStreamParseWithSeriesCache)
+UNIT_TEST_CASE(StreamScraperUnittest, TestStreamParseProtobuf)
+UNIT_TEST_CASE(StreamScraperUnittest, TestStreamParseProtobufHonorTimestamps)
 
 
 } // namespace logtail::prom
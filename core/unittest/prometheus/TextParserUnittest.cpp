@@ -40,6 +40,8 @@ public:
     void TestParseSuccess();
 
     void TestHonorTimestamps();
+
+    void TestGetSeriesAndParseSample();
 };
 
 void TextParserUnittest::TestParseMultipleLines() const {
@@ -388,6 +390,39 @@ void TextParserUnittest::TestParseUnicodeLabelValue() {
 
 UNIT_TEST_CASE(TextParserUnittest, TestParseUnicodeLabelValue)
 
+void TextParserUnittest::TestGetSeriesAndParseSample() {
+    TextParser parser;
+    APSARA_TEST_EQUAL("test_metric", parser.GetSeries("  test_metric 1.0").to_string());
+    APSARA_TEST_EQUAL(R"(test_metric{k1="v1", k2="v2" })",
+                      parser.GetSeries(R"(test_metric{k1="v1", k2="v2" } 1.0 1715829785083)").to_string());
+    // braces and escaped quotes in label values
+    APSARA_TEST_EQUAL(R"(test_metric {k1="}\"{", k2="\\"})",
+                      parser.GetSeries(R"(test_metric {k1="}\"{", k2="\\"} 1.0)").to_string());
+    APSARA_TEST_TRUE(parser.GetSeries("").empty());
+    APSARA_TEST_TRUE(parser.GetSeries("{k1=\"v1\"} 1.0").empty());
+    // bytes above 0x7f are not part of a metric name
+    APSARA_TEST_TRUE(parser.GetSeries("\xe6\x8c\x87\xe6\xa0\x87 1.0").empty());
+    APSARA_TEST_TRUE(parser.GetSeries("test_metric{k1=\"v1\" 1.0").empty());
+
+    auto eGroup = PipelineEventGroup(make_shared<SourceBuffer>());
+    string line = R"(test_metric{k1="v1"} 9.9410452992e+10 1715829785083 # exemplar)";
+    auto series = parser.GetSeries(line);
+    auto* metric = eGroup.AddMetricEvent();
+    APSARA_TEST_TRUE(parser.ParseSample(line, series.size(), *metric));
+    APSARA_TEST_TRUE(IsDoubleEqual(9.9410452992e+10, metric->GetValue<UntypedSingleValue>()->mValue));
+    APSARA_TEST_EQUAL(1715829785, metric->GetTimestamp());
+    APSARA_TEST_EQUAL(83000000U, metric->GetTimestampNanosecond().value());
+    // only the sample is parsed
+    APSARA_TEST_EQUAL(0U, metric->TagsSize());
+
+    line = "test_metric";
+    APSARA_TEST_FALSE(parser.ParseSample(line, parser.GetSeries(line).size(), *metric));
+    line = "test_metric 1.0abc";
+    APSARA_TEST_FALSE(parser.ParseSample(line, parser.GetSeries(line).size(), *metric));
+}
+
+UNIT_TEST_CASE(TextParserUnittest, TestGetSeriesAndParseSample)
+
 } // namespace logtail
 
 UNIT_TEST_MAIN
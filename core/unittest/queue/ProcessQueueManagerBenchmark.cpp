@@ -0,0 +1,121 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "collection_pipeline/queue/ProcessQueueManager.h"
+#include "collection_pipeline/queue/QueueKeyManager.h"
+#include "common/Flags.h"
+#include "models/PipelineEventGroup.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_INT32(process_thread_count);
+DECLARE_FLAG_BOOL(enable_process_queue_work_stealing);
+
+using namespace std;
+
+namespace logtail {
+
+static constexpr size_t kQueueCnt = 64;
+static constexpr size_t kProducerCnt = 4;
+static constexpr size_t kItemCntPerQueue = 2000;
+
+class ProcessQueueManagerBenchmark : public ::testing::Test {
+public:
+    void TestPopContention();
+
+protected:
+    void TearDown() override {
+        INT32_FLAG(process_thread_count) = 1;
+        BOOL_FLAG(enable_process_queue_work_stealing) = false;
+    }
+
+private:
+    static double run(size_t threadCnt, bool workStealing);
+};
+
+double ProcessQueueManagerBenchmark::run(size_t threadCnt, bool workStealing) {
+    INT32_FLAG(process_thread_count) = threadCnt;
+    BOOL_FLAG(enable_process_queue_work_stealing) = workStealing;
+
+    auto manager = ProcessQueueManager::GetInstance();
+    vector<QueueKey> keys;
+    for (size_t i = 0; i < kQueueCnt; ++i) {
+        CollectionPipelineContext ctx;
+        string configName = "benchmark_config_" + to_string(i);
+        ctx.SetConfigName(configName);
+        keys.push_back(QueueKeyManager::GetInstance()->GetKey(configName));
+        manager->CreateOrUpdateCircularQueue(keys.back(), i % (ProcessQueueManager::sMaxPriority + 1), 1, ctx);
+        manager->EnablePop(configName);
+    }
+
+    const size_t total = kQueueCnt * kItemCntPerQueue;
+    atomic_size_t poppedCnt = 0;
+    vector<thread> threads;
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < kProducerCnt; ++i) {
+        threads.emplace_back([&, i]() {
+            for (size_t j = 0; j < kItemCntPerQueue; ++j) {
+                for (size_t k = i; k < kQueueCnt; k += kProducerCnt) {
+                    // empty event group, so that circular queue never discards
+                    PipelineEventGroup g(make_shared<SourceBuffer>());
+                    manager->PushQueue(keys[k], make_unique<ProcessQueueItem>(std::move(g), j));
+                }
+            }
+        });
+    }
+    for (size_t i = 0; i < threadCnt; ++i) {
+        threads.emplace_back([&, i]() {
+            unique_ptr<ProcessQueueItem> item;
+            string configName;
+            while (poppedCnt.load(memory_order_relaxed) < total) {
+                if (manager->PopItem(i, item, configName)) {
+                    poppedCnt.fetch_add(1, memory_order_relaxed);
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    auto elapsed = chrono::duration_cast<chrono::duration<double>>(chrono::steady_clock::now() - start).count();
+
+    for (const auto& key : keys) {
+        manager->DeleteQueue(key);
+    }
+    return total / elapsed / 1000000;
+}
+
+void ProcessQueueManagerBenchmark::TestPopContention() {
+    for (size_t threadCnt : {1, 2, 4, 8, 16, 32, 64}) {
+        for (bool workStealing : {false, true}) {
+            double mops = run(threadCnt, workStealing);
+            cout << "process threads: " << setw(2) << threadCnt << "\tmode: " << setw(13)
+                 << (workStealing ? "work stealing" : "round robin") << "\tthroughput: " << fixed << setprecision(3)
+                 << mops << " M items/s" << endl;
+        }
+    }
+}
+
+UNIT_TEST_CASE(ProcessQueueManagerBenchmark, TestPopContention)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -12,16 +12,24 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
+#include <future>
+#include <map>
 #include <memory>
+#include <thread>
 
 #include "collection_pipeline/CollectionPipelineManager.h"
 #include "collection_pipeline/queue/ExactlyOnceQueueManager.h"
 #include "collection_pipeline/queue/ProcessQueueManager.h"
 #include "collection_pipeline/queue/QueueKeyManager.h"
 #include "collection_pipeline/queue/QueueParam.h"
+#include "common/Flags.h"
 #include "models/PipelineEventGroup.h"
 #include "unittest/Unittest.h"
 
+DECLARE_FLAG_INT32(process_thread_count);
+DECLARE_FLAG_BOOL(enable_process_queue_work_stealing);
+
 using namespace std;
 
 namespace logtail {
@@ -34,6 +42,9 @@ public:
     void TestSetQueueUpstreamAndDownStream();
     void TestPushQueue();
     void TestPopItem();
+    void TestPopItemWithWorkStealing();
+    void TestConcurrentPopItemWithWorkStealing();
+    void TestPopItems();
     void TestIsAllQueueEmpty();
     void OnPipelineUpdate();
 
@@ -41,6 +52,8 @@ protected:
     static void SetUpTestCase() { sProcessQueueManager = ProcessQueueManager::GetInstance(); }
 
     void TearDown() override {
+        INT32_FLAG(process_thread_count) = 1;
+        BOOL_FLAG(enable_process_queue_work_stealing) = false;
         QueueKeyManager::GetInstance()->Clear();
         sProcessQueueManager->Clear();
         ExactlyOnceQueueManager::GetInstance()->Clear();
@@ -50,9 +63,9 @@ private:
     static ProcessQueueManager* sProcessQueueManager;
     static CollectionPipelineContext sCtx;
 
-    unique_ptr<ProcessQueueItem> GenerateItem() {
+    unique_ptr<ProcessQueueItem> GenerateItem(size_t index = 0) {
         PipelineEventGroup g(make_shared<SourceBuffer>());
-        return make_unique<ProcessQueueItem>(std::move(g), 0);
+        return make_unique<ProcessQueueItem>(std::move(g), index);
     }
 };
 
@@ -323,6 +336,217 @@ void ProcessQueueManagerUnittest::TestPopItem() {
     APSARA_TEST_TRUE(sProcessQueueManager->mCurrentQueueIndex.second == sProcessQueueManager->mQueues[key1].first);
 }
 
+void ProcessQueueManagerUnittest::TestPopItemWithWorkStealing() {
+    INT32_FLAG(process_thread_count) = 2;
+    BOOL_FLAG(enable_process_queue_work_stealing) = true;
+
+    unique_ptr<ProcessQueueItem> item;
+    string configName;
+    CollectionPipelineContext ctx;
+
+    ctx.SetConfigName("test_config_1");
+    QueueKey key1 = QueueKeyManager::GetInstance()->GetKey("test_config_1");
+    sProcessQueueManager->CreateOrUpdateCountBoundedQueue(key1, 0, ctx);
+    sProcessQueueManager->EnablePop("test_config_1");
+    // queues of priority 1: test_config_2 and test_config_4 are owned by thread 0, test_config_3 by thread 1
+    ctx.SetConfigName("test_config_2");
+    QueueKey key2 = QueueKeyManager::GetInstance()->GetKey("test_config_2");
+    sProcessQueueManager->CreateOrUpdateCountBoundedQueue(key2, 1, ctx);
+    sProcessQueueManager->EnablePop("test_config_2");
+    ctx.SetConfigName("test_config_3");
+    QueueKey key3 = QueueKeyManager::GetInstance()->GetKey("test_config_3");
+    sProcessQueueManager->CreateOrUpdateCountBoundedQueue(key3, 1, ctx);
+    sProcessQueueManager->EnablePop("test_config_3");
+    ctx.SetConfigName("test_config_4");
+    QueueKey key4 = QueueKeyManager::GetInstance()->GetKey("test_config_4");
+    sProcessQueueManager->CreateOrUpdateCountBoundedQueue(key4, 1, ctx);
+    sProcessQueueManager->EnablePop("test_config_4");
+    ctx.SetConfigName("test_config_5");
+    ExactlyOnceQueueManager::GetInstance()->CreateOrUpdateQueue(5, 0, ctx, vector<RangeCheckpointPtr>(5));
+    ExactlyOnceQueueManager::GetInstance()->EnablePopProcessQueue("test_config_5");
+
+    APSARA_TEST_EQUAL(1U, sProcessQueueManager->mPriorityQueueSnapshot[0].size());
+    APSARA_TEST_EQUAL(3U, sProcessQueueManager->mPriorityQueueSnapshot[1].size());
+
+    // the item comes from the queue owned by the thread
+    sProcessQueueManager->PushQueue(key2, GenerateItem());
+    sProcessQueueManager->PushQueue(key3, GenerateItem());
+    APSARA_TEST_TRUE(sProcessQueueManager->PopItem(1, item, configName));
+    APSARA_TEST_EQUAL("test_config_3", configName);
+
+    // the item is stolen from the queue owned by other thread
+    APSARA_TEST_TRUE(sProcessQueueManager->PopItem(1, item, configName));
+    APSARA_TEST_EQUAL("test_config_2", configName);
+
+    // higher priority comes first, even if the queue is owned by other thread
+    sProcessQueueManager->PushQueue(key1, GenerateItem());
+    sProcessQueueManager->PushQueue(key3, GenerateItem());
+    APSARA_TEST_TRUE(sProcessQueueManager->PopItem(1, item, configName));
+    APSARA_TEST_EQUAL("test_config_1", configName);
+    APSARA_TEST_TRUE(sProcessQueueManager->PopItem(1, item, configName));
+    APSARA_TEST_EQUAL("test_config_3", configName);
+
+    // the queue owned by other thread is skipped if claimed
+    sProcessQueueManager->PushQueue(key2, GenerateItem());
+    {
+        promise<void> claimed;
+        promise<void> released;
+        thread other([&]() {
+            lock_guard<mutex> claim((*sProcessQueueManager->mQueues[key2].first)->GetClaimMux());
+            claimed.set_value();
+            released.get_future().wait();
+        });
+        claimed.get_future().wait();
+        APSARA_TEST_FALSE(sProcessQueueManager->PopItem(1, item, configName));
+        APSARA_TEST_FALSE(sProcessQueueManager->mValidToPop);
+        released.set_value();
+        other.join();
+    }
+    // while the queue owned by the thread is waited for
+    {
+        promise<void> claimed;
+        thread other([&]() {
+            lock_guard<mutex> claim((*sProcessQueueManager->mQueues[key2].first)->GetClaimMux());
+            claimed.set_value();
+            this_thread::sleep_for(chrono::milliseconds(100));
+        });
+        claimed.get_future().wait();
+        APSARA_TEST_TRUE(sProcessQueueManager->PopItem(0, item, configName));
+        APSARA_TEST_EQUAL("test_config_2", configName);
+        other.join();
+    }
+
+    // exactly once queue can only be popped by the assigned thread
+    sProcessQueueManager->PushQueue(5, GenerateItem());
+    APSARA_TEST_FALSE(sProcessQueueManager->PopItem(0, item, configName));
+    APSARA_TEST_TRUE(sProcessQueueManager->PopItem(1, item, configName));
+    APSARA_TEST_EQUAL("test_config_5", configName);
+
+    // snapshot follows queue priority update and deletion
+    ctx.SetConfigName("test_config_4");
+    sProcessQueueManager->CreateOrUpdateCountBoundedQueue(key4, 0, ctx);
+    APSARA_TEST_EQUAL(2U, sProcessQueueManager->mPriorityQueueSnapshot[0].size());
+    APSARA_TEST_EQUAL(2U, sProcessQueueManager->mPriorityQueueSnapshot[1].size());
+    sProcessQueueManager->DeleteQueue(key2);
+    APSARA_TEST_EQUAL(1U, sProcessQueueManager->mPriorityQueueSnapshot[1].size());
+    APSARA_TEST_EQUAL(sProcessQueueManager->mQueues[key3].first->get(),
+                      sProcessQueueManager->mPriorityQueueSnapshot[1][0]);
+}
+
+void ProcessQueueManagerUnittest::TestConcurrentPopItemWithWorkStealing() {
+    const size_t threadCnt = 8;
+    const size_t queueCnt = 5;
+    const size_t itemCnt = 1000;
+    INT32_FLAG(process_thread_count) = threadCnt;
+    BOOL_FLAG(enable_process_queue_work_stealing) = true;
+
+    CollectionPipelineContext ctx;
+    vector<QueueKey> keys;
+    for (size_t i = 0; i < queueCnt; ++i) {
+        string configName = "test_config_" + to_string(i);
+        ctx.SetConfigName(configName);
+        keys.push_back(QueueKeyManager::GetInstance()->GetKey(configName));
+        sProcessQueueManager->CreateOrUpdateCircularQueue(keys.back(), i % 2, itemCnt, ctx);
+        sProcessQueueManager->EnablePop(configName);
+    }
+
+    // each thread must see the items of one config in the order they are pushed
+    atomic_size_t poppedCnt = 0;
+    atomic_bool outOfOrder = false;
+    vector<thread> threads;
+    for (size_t i = 0; i < threadCnt; ++i) {
+        threads.emplace_back([&, i]() {
+            map<string, size_t> lastIndex;
+            unique_ptr<ProcessQueueItem> item;
+            string configName;
+            while (poppedCnt.load() < queueCnt * itemCnt) {
+                if (!sProcessQueueManager->PopItem(i, item, configName)) {
+                    this_thread::yield();
+                    continue;
+                }
+                auto it = lastIndex.find(configName);
+                if (it != lastIndex.end() && it->second >= item->mInputIndex) {
+                    outOfOrder = true;
+                }
+                lastIndex[configName] = item->mInputIndex;
+                ++poppedCnt;
+            }
+        });
+    }
+    for (size_t i = 0; i < itemCnt; ++i) {
+        for (const auto& key : keys) {
+            APSARA_TEST_EQUAL(QueueStatus::OK, sProcessQueueManager->PushQueue(key, GenerateItem(i)));
+        }
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    APSARA_TEST_EQUAL(queueCnt * itemCnt, poppedCnt.load());
+    APSARA_TEST_FALSE(outOfOrder.load());
+    APSARA_TEST_TRUE(sProcessQueueManager->IsAllQueueEmpty());
+}
+
+void ProcessQueueManagerUnittest::TestPopItems() {
+    vector<unique_ptr<ProcessQueueItem>> items;
+    string configName;
+    CollectionPipelineContext ctx;
+
+    ctx.SetConfigName("test_config_1");
+    QueueKey key1 = QueueKeyManager::GetInstance()->GetKey("test_config_1");
+    sProcessQueueManager->CreateOrUpdateCountBoundedQueue(key1, 1, ctx);
+    sProcessQueueManager->EnablePop("test_config_1");
+    ctx.SetConfigName("test_config_2");
+    QueueKey key2 = QueueKeyManager::GetInstance()->GetKey("test_config_2");
+    sProcessQueueManager->CreateOrUpdateCountBoundedQueue(key2, 1, ctx);
+    sProcessQueueManager->EnablePop("test_config_2");
+    ctx.SetConfigName("test_config_3");
+    ExactlyOnceQueueManager::GetInstance()->CreateOrUpdateQueue(3, 0, ctx, vector<RangeCheckpointPtr>(5));
+    ExactlyOnceQueueManager::GetInstance()->EnablePopProcessQueue("test_config_3");
+
+    for (bool workStealing : {false, true}) {
+        BOOL_FLAG(enable_process_queue_work_stealing) = workStealing;
+        for (size_t i = 0; i < 4; ++i) {
+            sProcessQueueManager->PushQueue(key1, GenerateItem(i));
+        }
+
+        // items are popped from one queue at a time, in the order they are pushed
+        APSARA_TEST_TRUE(sProcessQueueManager->PopItems(0, items, configName, 3));
+        APSARA_TEST_EQUAL("test_config_1", configName);
+        APSARA_TEST_EQUAL(3U, items.size());
+        for (size_t i = 0; i < items.size(); ++i) {
+            APSARA_TEST_EQUAL(i, items[i]->mInputIndex);
+        }
+
+        // the batch stops when the queue becomes empty
+        APSARA_TEST_TRUE(sProcessQueueManager->PopItems(0, items, configName, 3));
+        APSARA_TEST_EQUAL("test_config_1", configName);
+        APSARA_TEST_EQUAL(1U, items.size());
+        APSARA_TEST_EQUAL(3U, items[0]->mInputIndex);
+
+        // the batch stops when its data size reaches the limit
+        sProcessQueueManager->PushQueue(key1, GenerateItem());
+        sProcessQueueManager->PushQueue(key1, GenerateItem());
+        APSARA_TEST_TRUE(sProcessQueueManager->PopItems(0, items, configName, 3, 1));
+        APSARA_TEST_EQUAL(1U, items.size());
+        APSARA_TEST_TRUE(sProcessQueueManager->PopItems(0, items, configName, 3, 1));
+        APSARA_TEST_EQUAL(1U, items.size());
+
+        sProcessQueueManager->PushQueue(key2, GenerateItem());
+        APSARA_TEST_TRUE(sProcessQueueManager->PopItems(0, items, configName, 3));
+        APSARA_TEST_EQUAL("test_config_2", configName);
+        APSARA_TEST_EQUAL(1U, items.size());
+
+        // items of exactly once queue are never batched
+        sProcessQueueManager->PushQueue(3, GenerateItem());
+        APSARA_TEST_TRUE(sProcessQueueManager->PopItems(0, items, configName, 3));
+        APSARA_TEST_EQUAL("test_config_3", configName);
+        APSARA_TEST_EQUAL(1U, items.size());
+
+        APSARA_TEST_FALSE(sProcessQueueManager->PopItems(0, items, configName, 3));
+        APSARA_TEST_TRUE(items.empty());
+    }
+}
+
 void ProcessQueueManagerUnittest::TestIsAllQueueEmpty() {
     CollectionPipelineContext ctx;
     ctx.SetConfigName("test_config_1");
@@ -448,6 +672,9 @@ UNIT_TEST_CASE(ProcessQueueManagerUnittest, TestDeleteQueue)
 UNIT_TEST_CASE(ProcessQueueManagerUnittest, TestSetQueueUpstreamAndDownStream)
 UNIT_TEST_CASE(ProcessQueueManagerUnittest, TestPushQueue)
 UNIT_TEST_CASE(ProcessQueueManagerUnittest, TestPopItem)
+UNIT_TEST_CASE(ProcessQueueManagerUnittest, TestPopItemWithWorkStealing)
+UNIT_TEST_CASE(ProcessQueueManagerUnittest, TestConcurrentPopItemWithWorkStealing)
+UNIT_TEST_CASE(ProcessQueueManagerUnittest, TestPopItems)
 UNIT_TEST_CASE(ProcessQueueManagerUnittest, TestIsAllQueueEmpty)
 UNIT_TEST_CASE(ProcessQueueManagerUnittest, OnPipelineUpdate)
 
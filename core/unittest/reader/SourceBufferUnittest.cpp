@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <fstream>
+#include <thread>
 
 #include "json/json.h"
 
@@ -20,6 +21,9 @@
 #include "unittest/Unittest.h"
 
 DECLARE_FLAG_INT32(force_release_deleted_file_fd_timeout);
+DECLARE_FLAG_BOOL(enable_source_buffer_chunk_pool);
+DECLARE_FLAG_INT64(source_buffer_chunk_pool_max_bytes_per_thread);
+DECLARE_FLAG_INT64(source_buffer_chunk_pool_max_bytes);
 
 namespace logtail {
 
@@ -28,6 +32,10 @@ public:
     void SetUp() override {}
     void TearDown() override {}
     void TestBufferAllocatorAllocate();
+    void TestChunkPoolRecycle();
+    void TestChunkPoolCrossThreadRelease();
+    void TestChunkPoolTotalLimit();
+    void TestChunkPoolDisabled();
 };
 
 void SourceBufferUnittest::TestBufferAllocatorAllocate() {
@@ -61,7 +69,107 @@ void SourceBufferUnittest::TestBufferAllocatorAllocate() {
     APSARA_TEST_EQUAL('c', static_cast<char*>(alloc3)[0]);
 }
 
+void SourceBufferUnittest::TestChunkPoolRecycle() {
+    const auto& pool = ChunkPool::GetThreadPool();
+    APSARA_TEST_NOT_EQUAL(nullptr, pool.get());
+    pool->Clear();
+    uint64_t hitBefore = pool->mHitTotal->GetValue();
+
+    uint8_t* firstChunk = nullptr;
+    {
+        BufferAllocator allocator;
+        firstChunk = allocator.mAllocatedChunks[0];
+        allocator.Allocate(4000);
+        // a new 8KB chunk
+        allocator.Allocate(1000);
+        // unexpectedly large allocation is not pooled
+        allocator.Allocate(100000);
+        APSARA_TEST_EQUAL(3U, allocator.mAllocatedChunks.size());
+        APSARA_TEST_EQUAL(0U, pool->GetRetainedBytes());
+
+        allocator.Reset();
+        APSARA_TEST_EQUAL(8192U, pool->GetRetainedBytes());
+    }
+    APSARA_TEST_EQUAL(8192U + 4096U, pool->GetRetainedBytes());
+
+    {
+        BufferAllocator allocator;
+        APSARA_TEST_EQUAL(firstChunk, allocator.mAllocatedChunks[0]);
+        APSARA_TEST_EQUAL(hitBefore + 1, pool->mHitTotal->GetValue());
+        APSARA_TEST_EQUAL(8192U, pool->GetRetainedBytes());
+    }
+    APSARA_TEST_EQUAL(8192U + 4096U, pool->GetRetainedBytes());
+
+    // chunks exceeding the retention limit are freed directly
+    int64_t maxBytes = INT64_FLAG(source_buffer_chunk_pool_max_bytes_per_thread);
+    INT64_FLAG(source_buffer_chunk_pool_max_bytes_per_thread) = 8192U + 4096U;
+    { BufferAllocator allocator; }
+    {
+        BufferAllocator allocator;
+        BufferAllocator allocator2;
+    }
+    APSARA_TEST_EQUAL(8192U + 4096U, pool->GetRetainedBytes());
+    INT64_FLAG(source_buffer_chunk_pool_max_bytes_per_thread) = maxBytes;
+
+    pool->Clear();
+    APSARA_TEST_EQUAL(0U, pool->GetRetainedBytes());
+}
+
+void SourceBufferUnittest::TestChunkPoolCrossThreadRelease() {
+    ChunkPool::GetThreadPool()->Clear();
+    std::shared_ptr<ChunkPool> threadPool;
+    std::unique_ptr<BufferAllocator> allocator;
+    std::thread t([&]() {
+        threadPool = ChunkPool::GetThreadPool();
+        allocator = std::make_unique<BufferAllocator>();
+    });
+    t.join();
+    APSARA_TEST_NOT_EQUAL(ChunkPool::GetThreadPool().get(), threadPool.get());
+
+    // the pool outlives its thread, and the chunk goes back to it rather than the pool of current thread
+    allocator.reset();
+    APSARA_TEST_EQUAL(4096U, threadPool->GetRetainedBytes());
+    APSARA_TEST_EQUAL(0U, ChunkPool::GetThreadPool()->GetRetainedBytes());
+}
+
+void SourceBufferUnittest::TestChunkPoolTotalLimit() {
+    ChunkPool::GetThreadPool()->Clear();
+    size_t totalBefore = ChunkPool::GetTotalRetainedBytes();
+    int64_t maxBytes = INT64_FLAG(source_buffer_chunk_pool_max_bytes);
+    INT64_FLAG(source_buffer_chunk_pool_max_bytes) = totalBefore + 4096;
+
+    std::shared_ptr<ChunkPool> threadPool;
+    std::thread t([&]() {
+        threadPool = ChunkPool::GetThreadPool();
+        { BufferAllocator allocator; }
+    });
+    t.join();
+    APSARA_TEST_EQUAL(4096U, threadPool->GetRetainedBytes());
+    APSARA_TEST_EQUAL(totalBefore + 4096, ChunkPool::GetTotalRetainedBytes());
+    // the pool of current thread is far from its own limit, but all pools have reached the total limit
+    { BufferAllocator allocator; }
+    APSARA_TEST_EQUAL(0U, ChunkPool::GetThreadPool()->GetRetainedBytes());
+
+    threadPool->Clear();
+    APSARA_TEST_EQUAL(totalBefore, ChunkPool::GetTotalRetainedBytes());
+    INT64_FLAG(source_buffer_chunk_pool_max_bytes) = maxBytes;
+}
+
+void SourceBufferUnittest::TestChunkPoolDisabled() {
+    BOOL_FLAG(enable_source_buffer_chunk_pool) = false;
+    {
+        BufferAllocator allocator;
+        APSARA_TEST_EQUAL(nullptr, allocator.mChunkPool.get());
+        allocator.Allocate(5000);
+    }
+    BOOL_FLAG(enable_source_buffer_chunk_pool) = true;
+}
+
 UNIT_TEST_CASE(SourceBufferUnittest, TestBufferAllocatorAllocate);
+UNIT_TEST_CASE(SourceBufferUnittest, TestChunkPoolRecycle);
+UNIT_TEST_CASE(SourceBufferUnittest, TestChunkPoolCrossThreadRelease);
+UNIT_TEST_CASE(SourceBufferUnittest, TestChunkPoolTotalLimit);
+UNIT_TEST_CASE(SourceBufferUnittest, TestChunkPoolDisabled);
 
 } // namespace logtail
 
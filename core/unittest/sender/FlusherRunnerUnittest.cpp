@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <thread>
+
 #include "collection_pipeline/plugin/PluginRegistry.h"
 #include "collection_pipeline/queue/SenderQueueManager.h"
 #include "runner/FlusherRunner.h"
@@ -21,6 +23,7 @@
 #include "unittest/plugin/PluginMock.h"
 
 DECLARE_FLAG_INT32(discard_send_fail_interval);
+DECLARE_FLAG_INT32(flusher_runner_sending_slot_wait_timeout_ms);
 
 using namespace std;
 
@@ -30,6 +33,8 @@ class FlusherRunnerUnittest : public ::testing::Test {
 public:
     void TestDispatch();
     void TestPushToHttpSink();
+    void TestWaitForSendingSlot();
+    void TestDispatchDelay();
 
 protected:
     static void SetUpTestCase() { AppConfig::GetInstance()->mSendRequestGlobalConcurrency = 10; }
@@ -142,8 +147,74 @@ void FlusherRunnerUnittest::TestPushToHttpSink() {
     }
 }
 
+void FlusherRunnerUnittest::TestWaitForSendingSlot() {
+    auto runner = FlusherRunner::GetInstance();
+    // a long timeout ensures that the waiter can only be woken up by the finished request
+    INT32_FLAG(flusher_runner_sending_slot_wait_timeout_ms) = 60000;
+    runner->mHttpSendingCnt = AppConfig::GetInstance()->GetSendRequestGlobalConcurrency();
+
+    auto before = chrono::steady_clock::now();
+    thread sink([runner]() {
+        this_thread::sleep_for(chrono::milliseconds(100));
+        runner->DecreaseHttpSendingCnt();
+    });
+    runner->WaitForSendingSlot();
+    auto elapsed = chrono::steady_clock::now() - before;
+    sink.join();
+
+    APSARA_TEST_EQUAL(AppConfig::GetInstance()->GetSendRequestGlobalConcurrency() - 1, runner->GetSendingBufferCount());
+    APSARA_TEST_TRUE(elapsed >= chrono::milliseconds(100));
+    APSARA_TEST_TRUE(elapsed < chrono::seconds(10));
+
+    // no wait when there is free slot
+    before = chrono::steady_clock::now();
+    runner->WaitForSendingSlot();
+    APSARA_TEST_TRUE(chrono::steady_clock::now() - before < chrono::milliseconds(100));
+
+    runner->mHttpSendingCnt = 0;
+    INT32_FLAG(flusher_runner_sending_slot_wait_timeout_ms) = 100;
+}
+
+void FlusherRunnerUnittest::TestDispatchDelay() {
+    auto flusher = make_unique<FlusherHttpMock>();
+    Json::Value tmp;
+    CollectionPipelineContext ctx;
+    flusher->SetContext(ctx);
+    flusher->CreateMetricsRecordRef("name", "1");
+    flusher->Init(Json::Value(), tmp);
+    flusher->CommitMetricsRecordRef();
+
+    auto runner = FlusherRunner::GetInstance();
+    auto histogram = make_shared<Histogram>("dispatch_delay_ms");
+    runner->mDispatchDelayMs = histogram;
+    {
+        auto item = make_unique<SenderQueueItem>("content", 10, flusher.get(), flusher->GetQueueKey());
+        auto realItem = item.get();
+        flusher->PushToQueue(std::move(item));
+        realItem->mFirstEnqueTime = chrono::system_clock::now() - chrono::milliseconds(20);
+        runner->Dispatch(realItem);
+    }
+    {
+        // retried items are excluded
+        auto item = make_unique<SenderQueueItem>("content", 10, flusher.get(), flusher->GetQueueKey());
+        auto realItem = item.get();
+        flusher->PushToQueue(std::move(item));
+        realItem->mTryCnt = 2;
+        runner->Dispatch(realItem);
+    }
+    uint64_t cnt = 0;
+    for (auto bucket : histogram->GetBuckets()) {
+        cnt += bucket;
+    }
+    APSARA_TEST_EQUAL(1U, cnt);
+    APSARA_TEST_TRUE(histogram->GetMax() >= 20000);
+    runner->mDispatchDelayMs.reset();
+}
+
 UNIT_TEST_CASE(FlusherRunnerUnittest, TestDispatch)
 UNIT_TEST_CASE(FlusherRunnerUnittest, TestPushToHttpSink)
+UNIT_TEST_CASE(FlusherRunnerUnittest, TestWaitForSendingSlot)
+UNIT_TEST_CASE(FlusherRunnerUnittest, TestDispatchDelay)
 
 } // namespace logtail
 
@@ -0,0 +1,117 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "collection_pipeline/queue/SenderQueueManager.h"
+#include "common/StringTools.h"
+#include "common/http/Constant.h"
+#include "runner/sink/http/HttpSink.h"
+#include "unittest/Unittest.h"
+#include "unittest/plugin/PluginMock.h"
+#include "unittest/sender/LocalHttpServer.h"
+
+DECLARE_FLAG_INT32(http_sink_thread_count);
+
+using namespace std;
+
+namespace logtail {
+
+// Measures the throughput of HttpSink with different numbers of workers against a local server.
+class HttpSinkBenchmark : public ::testing::Test {
+public:
+    void TestThroughput();
+};
+
+void HttpSinkBenchmark::TestThroughput() {
+    LocalHttpServer server;
+    APSARA_TEST_TRUE_FATAL(server.Start());
+
+    auto flusher = make_unique<FlusherHttpMock>();
+    Json::Value tmp;
+    CollectionPipelineContext ctx;
+    flusher->SetContext(ctx);
+    flusher->CreateMetricsRecordRef("name", "1");
+    flusher->Init(Json::Value(), tmp);
+    flusher->CommitMetricsRecordRef();
+    SenderQueueItem item("content", 10, flusher.get(), flusher->GetQueueKey());
+
+    // all of 127.0.0.0/8 reaches the server, so requests can be spread over several hosts
+    vector<string> hosts;
+    for (size_t i = 1; i <= 8; ++i) {
+        hosts.emplace_back("127.0.0." + ToString(i));
+    }
+    const string body(512, 'a');
+    const size_t kRequestCnt = 10000;
+    // requests on the fly are bounded, as flusher runner does with the global send concurrency
+    const size_t kMaxSendingCnt = 256;
+    for (int32_t workerCnt : {1, 2, 4}) {
+        INT32_FLAG(http_sink_thread_count) = workerCnt;
+        HttpSink sink;
+        APSARA_TEST_TRUE(sink.Init());
+
+        auto getDoneCnt = [&sink]() {
+            size_t cnt = 0;
+            for (auto& worker : sink.mWorkers) {
+                cnt += worker->mOutSuccessfulItemsTotal->GetValue() + worker->mOutFailedItemsTotal->GetValue();
+            }
+            return cnt;
+        };
+        auto start = chrono::steady_clock::now();
+        size_t sentCnt = 0;
+        while (sentCnt < kRequestCnt) {
+            if (sentCnt - getDoneCnt() >= kMaxSendingCnt) {
+                this_thread::sleep_for(chrono::microseconds(100));
+                continue;
+            }
+            sink.AddRequest(make_unique<HttpSinkRequest>(HTTP_POST,
+                                                         false,
+                                                         hosts[sentCnt % hosts.size()],
+                                                         server.GetPort(),
+                                                         "/",
+                                                         "",
+                                                         map<string, string>(),
+                                                         body,
+                                                         &item));
+            ++sentCnt;
+        }
+        while (getDoneCnt() < kRequestCnt && chrono::steady_clock::now() - start < chrono::seconds(60)) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        auto cost = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+        sink.Stop();
+
+        size_t successCnt = 0;
+        for (auto& worker : sink.mWorkers) {
+            successCnt += worker->mOutSuccessfulItemsTotal->GetValue();
+        }
+        APSARA_TEST_EQUAL(kRequestCnt, successCnt);
+        cout << "[http sink] workers: " << workerCnt << "\trequests: " << kRequestCnt << "\tcost: " << cost
+             << "ms\tthroughput: " << kRequestCnt * 1000 / max<int64_t>(cost, 1) << "/s" << endl;
+    }
+    server.Stop();
+    INT32_FLAG(http_sink_thread_count) = 1;
+    SenderQueueManager::GetInstance()->Clear();
+}
+
+UNIT_TEST_CASE(HttpSinkBenchmark, TestThroughput)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
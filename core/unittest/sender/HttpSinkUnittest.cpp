@@ -0,0 +1,160 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "collection_pipeline/queue/SenderQueueManager.h"
+#include "common/StringTools.h"
+#include "common/http/Constant.h"
+#include "runner/sink/http/HttpSink.h"
+#include "unittest/Unittest.h"
+#include "unittest/plugin/PluginMock.h"
+#include "unittest/sender/LocalHttpServer.h"
+
+DECLARE_FLAG_INT32(http_sink_thread_count);
+
+using namespace std;
+
+namespace logtail {
+
+class HttpSinkUnittest : public ::testing::Test {
+public:
+    void TestAddRequestWithoutWorkers();
+    void TestAddRequestShardedByHost();
+    void TestSendWithLocalServer();
+
+private:
+    unique_ptr<HttpSinkRequest>
+    GenerateRequest(const string& host, int32_t port = 80, SenderQueueItem* item = nullptr, string body = "body") {
+        return make_unique<HttpSinkRequest>(
+            HTTP_POST, false, host, port, "/", "", map<string, string>(), body, item);
+    }
+};
+
+void HttpSinkUnittest::TestAddRequestWithoutWorkers() {
+    HttpSink sink;
+    APSARA_TEST_TRUE(sink.AddRequest(GenerateRequest("host_a")));
+    APSARA_TEST_EQUAL(1U, sink.mQueue.Size());
+}
+
+void HttpSinkUnittest::TestAddRequestShardedByHost() {
+    HttpSink sink;
+    const size_t workerCnt = 4;
+    for (size_t i = 0; i < workerCnt; ++i) {
+        sink.mWorkers.emplace_back(make_unique<HttpSink::Worker>(i));
+    }
+
+    vector<string> hosts;
+    for (size_t i = 0; i < 32; ++i) {
+        hosts.emplace_back("host_" + ToString(i));
+    }
+    // each host is always served by the same worker, so that its connections can be reused
+    vector<size_t> expectedSize(workerCnt, 0);
+    for (size_t round = 0; round < 3; ++round) {
+        for (const auto& host : hosts) {
+            size_t idx = sink.GetWorkerIndex(host);
+            APSARA_TEST_TRUE(idx < workerCnt);
+            APSARA_TEST_TRUE(sink.AddRequest(GenerateRequest(host)));
+            ++expectedSize[idx];
+        }
+    }
+    size_t usedWorkerCnt = 0;
+    for (size_t i = 0; i < workerCnt; ++i) {
+        APSARA_TEST_EQUAL(expectedSize[i], sink.mWorkers[i]->mQueue.Size());
+        if (expectedSize[i] > 0) {
+            ++usedWorkerCnt;
+        }
+        unique_ptr<HttpSinkRequest> request;
+        while (sink.mWorkers[i]->mQueue.TryPop(request)) {
+            APSARA_TEST_EQUAL(i, sink.GetWorkerIndex(request->mHost));
+        }
+    }
+    APSARA_TEST_TRUE(usedWorkerCnt > 1);
+    APSARA_TEST_TRUE(sink.mQueue.Empty());
+}
+
+void HttpSinkUnittest::TestSendWithLocalServer() {
+    LocalHttpServer server;
+    APSARA_TEST_TRUE_FATAL(server.Start());
+
+    auto flusher = make_unique<FlusherHttpMock>();
+    Json::Value tmp;
+    CollectionPipelineContext ctx;
+    flusher->SetContext(ctx);
+    flusher->CreateMetricsRecordRef("name", "1");
+    flusher->Init(Json::Value(), tmp);
+    flusher->CommitMetricsRecordRef();
+    SenderQueueItem item("content", 10, flusher.get(), flusher->GetQueueKey());
+
+    // all of 127.0.0.0/8 reaches the server, so requests can be spread over several hosts
+    vector<string> hosts;
+    for (size_t i = 1; i <= 8; ++i) {
+        hosts.emplace_back("127.0.0." + ToString(i));
+    }
+    const size_t kRequestCnt = 200;
+    const size_t kPreInitRequestCnt = 10;
+    const int32_t kWorkerCnt = 4;
+    INT32_FLAG(http_sink_thread_count) = kWorkerCnt;
+    {
+        HttpSink sink;
+        vector<size_t> expectedCnts(kWorkerCnt, 0);
+        // requests added before Init are handed over to workers
+        for (size_t i = 0; i < kPreInitRequestCnt; ++i) {
+            APSARA_TEST_TRUE(sink.AddRequest(GenerateRequest(hosts[i % hosts.size()], server.GetPort(), &item)));
+        }
+        APSARA_TEST_TRUE(sink.Init());
+        APSARA_TEST_EQUAL(static_cast<size_t>(kWorkerCnt), sink.mWorkers.size());
+        APSARA_TEST_TRUE(sink.mQueue.Empty());
+        for (size_t i = kPreInitRequestCnt; i < kRequestCnt; ++i) {
+            APSARA_TEST_TRUE(sink.AddRequest(GenerateRequest(hosts[i % hosts.size()], server.GetPort(), &item)));
+        }
+        for (size_t i = 0; i < kRequestCnt; ++i) {
+            ++expectedCnts[sink.GetWorkerIndex(hosts[i % hosts.size()])];
+        }
+
+        auto getDoneCnt = [&sink]() {
+            size_t cnt = 0;
+            for (auto& worker : sink.mWorkers) {
+                cnt += worker->mOutSuccessfulItemsTotal->GetValue() + worker->mOutFailedItemsTotal->GetValue();
+            }
+            return cnt;
+        };
+        auto start = chrono::steady_clock::now();
+        while (getDoneCnt() < kRequestCnt && chrono::steady_clock::now() - start < chrono::seconds(30)) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        sink.Stop();
+
+        // every request succeeds, and is sent by the worker its host is sharded to
+        for (int32_t i = 0; i < kWorkerCnt; ++i) {
+            APSARA_TEST_EQUAL(expectedCnts[i], sink.mWorkers[i]->mOutSuccessfulItemsTotal->GetValue());
+            APSARA_TEST_EQUAL(0U, sink.mWorkers[i]->mOutFailedItemsTotal->GetValue());
+        }
+    }
+    server.Stop();
+    INT32_FLAG(http_sink_thread_count) = 1;
+    SenderQueueManager::GetInstance()->Clear();
+}
+
+UNIT_TEST_CASE(HttpSinkUnittest, TestAddRequestWithoutWorkers)
+UNIT_TEST_CASE(HttpSinkUnittest, TestAddRequestShardedByHost)
+UNIT_TEST_CASE(HttpSinkUnittest, TestSendWithLocalServer)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -0,0 +1,118 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace logtail {
+
+// A minimal http server on all local addresses, which answers each request with an empty 200 response at once. Each
+// connection is served by its own thread, so that the server is not the bottleneck.
+class LocalHttpServer {
+public:
+    bool Start() {
+        mListenFd = socket(AF_INET, SOCK_STREAM, 0);
+        if (mListenFd < 0) {
+            return false;
+        }
+        int on = 1;
+        setsockopt(mListenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        socklen_t len = sizeof(addr);
+        if (bind(mListenFd, reinterpret_cast<sockaddr*>(&addr), len) != 0 || listen(mListenFd, 1024) != 0
+            || getsockname(mListenFd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+            close(mListenFd);
+            return false;
+        }
+        mPort = ntohs(addr.sin_port);
+        mAcceptThread = std::thread([this]() { Accept(); });
+        return true;
+    }
+
+    void Stop() {
+        shutdown(mListenFd, SHUT_RDWR);
+        mAcceptThread.join();
+        close(mListenFd);
+        std::lock_guard<std::mutex> lock(mMux);
+        for (auto fd : mConnFds) {
+            shutdown(fd, SHUT_RDWR);
+        }
+        for (auto& t : mConnThreads) {
+            t.join();
+        }
+    }
+
+    int32_t GetPort() const { return mPort; }
+
+private:
+    void Accept() {
+        while (true) {
+            int fd = accept(mListenFd, nullptr, nullptr);
+            if (fd < 0) {
+                break;
+            }
+            std::lock_guard<std::mutex> lock(mMux);
+            mConnFds.push_back(fd);
+            mConnThreads.emplace_back([fd]() { Serve(fd); });
+        }
+    }
+
+    static void Serve(int fd) {
+        static const std::string kResponse = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n";
+        static const std::string kContentLength = "Content-Length:";
+        std::string buffer;
+        char tmp[64 * 1024];
+        while (true) {
+            auto headerEnd = buffer.find("\r\n\r\n");
+            if (headerEnd != std::string::npos) {
+                size_t bodySize = 0;
+                auto pos = buffer.find(kContentLength);
+                if (pos != std::string::npos && pos < headerEnd) {
+                    bodySize = std::stoul(buffer.substr(pos + kContentLength.size(), headerEnd - pos));
+                }
+                if (buffer.size() >= headerEnd + 4 + bodySize) {
+                    buffer.erase(0, headerEnd + 4 + bodySize);
+                    send(fd, kResponse.data(), kResponse.size(), MSG_NOSIGNAL);
+                    continue;
+                }
+            }
+            auto n = recv(fd, tmp, sizeof(tmp), 0);
+            if (n <= 0) {
+                break;
+            }
+            buffer.append(tmp, n);
+        }
+        close(fd);
+    }
+
+    int mListenFd = -1;
+    int32_t mPort = 0;
+    std::thread mAcceptThread;
+    std::mutex mMux;
+    std::vector<int> mConnFds;
+    std::vector<std::thread> mConnThreads;
+};
+
+} // namespace logtail
@@ -16,6 +16,8 @@
 
 #include "collection_pipeline/serializer/SLSSerializer.h"
 #include "common/JsonUtil.h"
+#include "common/compression/LZ4Compressor.h"
+#include "common/compression/ZstdCompressor.h"
 #include "plugin/flusher/sls/FlusherSLS.h"
 #include "unittest/Unittest.h"
 
@@ -34,6 +36,7 @@ class SLSSerializerUnittest : public ::testing::Test {
 public:
     void TestSerializeEventGroup();
     void TestSerializeEventGroupList();
+    void TestSerializeAndCompressEventGroup();
     void TestSerializeSpanLinksToString();
     void TestSerializeSpanEventsToString();
     void TestSerializeSpanAttributesToString();
@@ -68,6 +71,7 @@ private:
     BatchedEvents
     CreateBatchedRawEvents(bool enableNanosecond, bool withEmptyContent = false, bool withNonEmptyContent = true);
     BatchedEvents CreateBatchedSpanEvents();
+    BatchedEvents CreateLargeBatchedLogEvents(size_t cnt);
 
     static unique_ptr<FlusherSLS> sFlusher;
 
@@ -769,6 +773,103 @@ void SLSSerializerUnittest::TestSerializeEventGroupList() {
 }
 
 
+// streams of this compressor always fail, as if the size of data differs from the size the stream is begun with
+class StreamFailingCompressor : public ZstdCompressor {
+public:
+    StreamFailingCompressor() : ZstdCompressor(CompressType::ZSTD) {}
+
+private:
+    bool CompressChunk(StringView chunk, string& errorMsg) override {
+        errorMsg = "Src size is incorrect";
+        return false;
+    }
+};
+
+class FailingCompressor : public StreamFailingCompressor {
+private:
+    bool Compress(const string& input, string& output, string& errorMsg) override {
+        errorMsg = "compress failed";
+        return false;
+    }
+};
+
+void SLSSerializerUnittest::TestSerializeAndCompressEventGroup() {
+    SLSEventGroupSerializer serializer(sFlusher.get());
+    string errorMsg;
+    bool compressFailed = false;
+    vector<unique_ptr<Compressor>> compressors;
+    compressors.emplace_back(make_unique<LZ4Compressor>(CompressType::LZ4));
+    compressors.emplace_back(make_unique<ZstdCompressor>(CompressType::ZSTD));
+    // the group is compressed as a whole once the stream fails
+    compressors.emplace_back(make_unique<StreamFailingCompressor>());
+    vector<function<BatchedEvents()>> creators;
+    // the large group is compressed in several chunks when streaming
+    creators.emplace_back([this]() { return CreateLargeBatchedLogEvents(1); });
+    creators.emplace_back([this]() { return CreateLargeBatchedLogEvents(5000); });
+    creators.emplace_back([this]() { return CreateBatchedMetricEvents(false, 0, false, false); });
+    creators.emplace_back(
+        [this]() { return CreateBatchedMultiValueMetricEvents(false, 0, false, false, false, false); });
+    creators.emplace_back([this]() { return CreateBatchedSpanEvents(); });
+    creators.emplace_back([this]() { return CreateBatchedRawEvents(false); });
+    for (auto& compressor : compressors) {
+        for (auto& creator : creators) {
+            string expectedData;
+            APSARA_TEST_TRUE(serializer.DoSerialize(creator(), expectedData, errorMsg));
+            string output;
+            size_t rawSize = 0;
+            APSARA_TEST_TRUE(
+                serializer.DoSerializeAndCompress(creator(), *compressor, output, rawSize, errorMsg, compressFailed));
+            APSARA_TEST_FALSE(compressFailed);
+            APSARA_TEST_EQUAL(expectedData.size(), rawSize);
+            string decompressed;
+            decompressed.resize(rawSize);
+            APSARA_TEST_TRUE(compressor->UnCompress(output, decompressed, errorMsg));
+            APSARA_TEST_EQUAL(expectedData, decompressed);
+        }
+    }
+    {
+        // serialization failure
+        ZstdCompressor compressor(CompressType::ZSTD);
+        INT32_FLAG(max_send_log_group_size) = 10;
+        string output;
+        size_t rawSize = 0;
+        APSARA_TEST_FALSE(serializer.DoSerializeAndCompress(
+            CreateLargeBatchedLogEvents(1), compressor, output, rawSize, errorMsg, compressFailed));
+        APSARA_TEST_FALSE(compressFailed);
+        INT32_FLAG(max_send_log_group_size) = 10 * 1024 * 1024;
+    }
+    {
+        // compression failure
+        FailingCompressor compressor;
+        string output;
+        size_t rawSize = 0;
+        APSARA_TEST_FALSE(serializer.DoSerializeAndCompress(
+            CreateLargeBatchedLogEvents(1), compressor, output, rawSize, errorMsg, compressFailed));
+        APSARA_TEST_TRUE(compressFailed);
+        APSARA_TEST_EQUAL("compress failed", errorMsg);
+    }
+}
+
+BatchedEvents SLSSerializerUnittest::CreateLargeBatchedLogEvents(size_t cnt) {
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    group.SetTag(LOG_RESERVED_KEY_TOPIC, "topic");
+    group.SetTag(LOG_RESERVED_KEY_SOURCE, "source");
+    group.SetTag(LOG_RESERVED_KEY_PACKAGE_ID, "pack_id");
+    group.SetTag(string("tag_key"), string("tag_value"));
+    for (size_t i = 0; i < cnt; ++i) {
+        LogEvent* e = group.AddLogEvent();
+        e->SetContent(string("key"), "value_" + to_string(i) + string(200, 'a' + i % 26));
+        e->SetContent(string("level"), string("INFO"));
+        e->SetTimestamp(1234567890 + i);
+    }
+    BatchedEvents batch(std::move(group.MutableEvents()),
+                        std::move(group.GetSizedTags()),
+                        std::move(group.GetSourceBuffer()),
+                        group.GetMetadata(EventGroupMetaKey::SOURCE_ID),
+                        std::move(group.GetExactlyOnceCheckpoint()));
+    return batch;
+}
+
 BatchedEvents
 SLSSerializerUnittest::CreateBatchedLogEvents(bool enableNanosecond, bool withEmptyContent, bool withNonEmptyContent) {
     PipelineEventGroup group(make_shared<SourceBuffer>());
@@ -1189,6 +1290,7 @@ void SLSSerializerUnittest::TestSerializeSpanAttributesToString() {
 
 UNIT_TEST_CASE(SLSSerializerUnittest, TestSerializeEventGroup)
 UNIT_TEST_CASE(SLSSerializerUnittest, TestSerializeEventGroupList)
+UNIT_TEST_CASE(SLSSerializerUnittest, TestSerializeAndCompressEventGroup)
 UNIT_TEST_CASE(SLSSerializerUnittest, TestSerializeSpanLinksToString)
 UNIT_TEST_CASE(SLSSerializerUnittest, TestSerializeSpanEventsToString)
 UNIT_TEST_CASE(SLSSerializerUnittest, TestSerializeSpanAttributesToString)